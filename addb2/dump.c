@@ -1174,6 +1174,13 @@ struct m0_addb2__id_intrp ids[] = {
 	  .ii_spec   = &beop_state_counter },
 	{ M0_AVI_BE_TX_TO_GROUP,  "tx-to-gr", { &dec, &dec, &dec },
 	  { "tx_id", "gr_id", "inout" } },
+	{ M0_AVI_BE_RECOVERY,     "be-recovery", { &dec, &dec, &duration,
+						   &dec },
+	  { "records", "bytes", "time", "mbps" } },
+	{ M0_AVI_BE_GROUP_CTL,    "be-group-ctl", { &duration, &duration,
+						    &duration, &dec,
+						    &duration },
+	  { "arrival", "log", "sync", "tx_nr", "delay" } },
 	{ M0_AVI_NET_BUF,         "net-buf",         { &ptr, &dec, &_clock,
 						       &duration, &dec, &dec },
 	  { "buf", "qtype", "time", "duration", "status", "len" } },
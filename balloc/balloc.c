@@ -30,13 +30,16 @@
 #include <sys/time.h>
 
 #include "dtm/dtm.h"	  /* m0_dtx */
-#include "be/tx_bulk.h"   /* m0_be_tx_bulk */
 #include "be/op.h"        /* m0_be_op_active */
 #include "lib/misc.h"	  /* M0_SET0 */
 #include "lib/errno.h"
 #include "lib/arith.h"	  /* min_check, m0_is_po2 */
 #include "lib/memory.h"
 #include "lib/locality.h" /* m0_locality0_get */
+#include "lib/thread_pool.h" /* m0_parallel_pool */
+#include "lib/atomic.h"   /* m0_atomic64 */
+#include "lib/time.h"     /* m0_nanosleep */
+#include "lib/finject.h"  /* M0_FI_ENABLED */
 #include "balloc.h"
 #include "motr/magic.h"
 
@@ -138,14 +141,6 @@ static m0_bcount_t group_spare_fragments_get(struct m0_balloc_group_info *grp)
 {
 	return grp->bgi_spare.bzp_fragments;
 }
-static struct m0_list *group_normal_ext(struct m0_balloc_group_info *grp)
-{
-	return &grp->bgi_normal.bzp_extents;
-}
-static struct m0_list *group_spare_ext(struct m0_balloc_group_info *grp)
-{
-	return &grp->bgi_spare.bzp_extents;
-}
 static void balloc_zone_init(struct m0_balloc_zone_param *zone, uint64_t type,
 			     m0_bcount_t start, m0_bcount_t size,
 			     m0_bcount_t freeblocks, m0_bcount_t fragments,
@@ -155,6 +150,10 @@ static uint64_t ext_range_locate(struct m0_ext *ip_ext,
 static bool is_spare(uint64_t alloc_flags);
 static bool is_normal(uint64_t alloc_flags);
 static bool is_any(uint64_t alloc_flag);
+static void lext_add(struct m0_balloc_zone_param *zp, struct m0_lext *le);
+static struct m0_lext *lext_first(struct m0_balloc_zone_param *zp,
+				  enum m0_lext_index idx);
+static struct m0_lext *lext_next(struct m0_lext *le, enum m0_lext_index idx);
 
 
 static void balloc_debug_dump_extent(const char *tag, struct m0_ext *ex)
@@ -200,11 +199,11 @@ if (ENABLE_BALLOC_DUMP) {
 
 	M0_LOG(M0_DEBUG, "free extents@%p:%s for grp=%04llx:",
 		grp, (char*) tag, (unsigned long long) grp->bgi_groupno);
-	m0_list_for_each_entry(&grp->bgi_normal.bzp_extents, ex,
-			       struct m0_lext, le_link)
+	for (ex = lext_first(&grp->bgi_normal, M0_LEXT_BY_START); ex != NULL;
+	     ex = lext_next(ex, M0_LEXT_BY_START))
 		M0_LOG(M0_DEBUG, "normal: "EXT_F, EXT_P(&ex->le_ext));
-	m0_list_for_each_entry(&grp->bgi_spare.bzp_extents, ex,
-			       struct m0_lext, le_link)
+	for (ex = lext_first(&grp->bgi_spare, M0_LEXT_BY_START); ex != NULL;
+	     ex = lext_next(ex, M0_LEXT_BY_START))
 		M0_LOG(M0_DEBUG, "spare: "EXT_F, EXT_P(&ex->le_ext));
 }
 }
@@ -268,13 +267,155 @@ static struct m0_mutex *bgi_mutex(struct m0_balloc_group_info *grp)
 	return &grp->bgi_mutex.bm_u.mutex;
 }
 
-static void lext_del(struct m0_lext *le)
+/** Returns the extent linked into index @idx by @link, NULL for NULL @link. */
+static struct m0_lext *lext_of(const struct m0_avl_link *link,
+			       enum m0_lext_index idx)
+{
+	return link == NULL ? NULL :
+		container_of(link - idx, struct m0_lext, le_link[0]);
+}
+
+static int lext_cmp(const struct m0_ext *e0, const struct m0_ext *e1,
+		    enum m0_lext_index idx)
+{
+	return (idx == M0_LEXT_BY_LEN ?
+		M0_3WAY(m0_ext_length(e0), m0_ext_length(e1)) : 0) ?:
+		M0_3WAY(e0->e_start, e1->e_start);
+}
+
+/** Returns the first extent of @zp in @idx order or NULL. */
+static struct m0_lext *lext_first(struct m0_balloc_zone_param *zp,
+				  enum m0_lext_index idx)
+{
+	return lext_of(m0_avl_first(&zp->bzp_extents[idx]), idx);
+}
+
+/** Returns the extent following @le in @idx order or NULL. */
+static struct m0_lext *lext_next(struct m0_lext *le, enum m0_lext_index idx)
+{
+	return lext_of(m0_avl_next(&le->le_link[idx]), idx);
+}
+
+/** Returns the length of the longest free extent of @zp. */
+static m0_bcount_t lext_maxchunk(struct m0_balloc_zone_param *zp)
+{
+	struct m0_avl  *avl = &zp->bzp_extents[M0_LEXT_BY_LEN];
+	struct m0_lext *le  = lext_of(m0_avl_last(avl), M0_LEXT_BY_LEN);
+
+	return le == NULL ? 0 : m0_ext_length(&le->le_ext);
+}
+
+/**
+ * Finds the last extent ordered before @key (@floor) and the first extent
+ * which is not ordered before @key (@ceil) in O(log(bzp_fragments)).
+ */
+static void lext_lookup(struct m0_balloc_zone_param *zp,
+			enum m0_lext_index idx, const struct m0_ext *key,
+			struct m0_lext **floor, struct m0_lext **ceil)
+{
+	struct m0_avl_link *link = zp->bzp_extents[idx].a_root;
+
+	*floor = NULL;
+	*ceil  = NULL;
+	while (link != NULL) {
+		if (lext_cmp(&lext_of(link, idx)->le_ext, key, idx) < 0) {
+			*floor = lext_of(link, idx);
+			link   = link->al_child[1];
+		} else {
+			*ceil  = lext_of(link, idx);
+			link   = link->al_child[0];
+		}
+	}
+}
+
+static void lext_tree_add(struct m0_balloc_zone_param *zp,
+			  enum m0_lext_index idx, struct m0_lext *le)
+{
+	struct m0_avl_link *parent = NULL;
+	struct m0_avl_link *link;
+	int                 dir = 0;
+
+	for (link = zp->bzp_extents[idx].a_root; link != NULL;
+	     link = link->al_child[dir]) {
+		parent = link;
+		dir    = lext_cmp(&lext_of(link, idx)->le_ext,
+				  &le->le_ext, idx) < 0;
+	}
+	m0_avl_insert(&zp->bzp_extents[idx], &le->le_link[idx], parent, dir);
+}
+
+static void lext_tree_del(struct m0_balloc_zone_param *zp,
+			  enum m0_lext_index idx, struct m0_lext *le)
+{
+	m0_avl_delete(&zp->bzp_extents[idx], &le->le_link[idx]);
+}
+
+static void lext_add(struct m0_balloc_zone_param *zp, struct m0_lext *le)
 {
-	m0_list_del(&le->le_link);
+	lext_tree_add(zp, M0_LEXT_BY_START, le);
+	lext_tree_add(zp, M0_LEXT_BY_LEN, le);
+}
+
+static void lext_del(struct m0_balloc_zone_param *zp, struct m0_lext *le)
+{
+	lext_tree_del(zp, M0_LEXT_BY_START, le);
+	lext_tree_del(zp, M0_LEXT_BY_LEN, le);
 	if (le->le_is_alloc)
 		m0_free(le);
 }
 
+/**
+ * Changes boundaries of a free extent of @zp.
+ *
+ * Free extents never overlap, so the position of the extent in the
+ * M0_LEXT_BY_START order is kept, only the length index is updated.
+ */
+static void lext_resize(struct m0_balloc_zone_param *zp, struct m0_ext *ext,
+			m0_bindex_t start, m0_bindex_t end)
+{
+	struct m0_lext *le = container_of(ext, struct m0_lext, le_ext);
+
+	lext_tree_del(zp, M0_LEXT_BY_LEN, le);
+	ext->e_start = start;
+	ext->e_end   = end;
+	lext_tree_add(zp, M0_LEXT_BY_LEN, le);
+}
+
+/**
+ * Checks that both indices of @zp are balanced AVL trees holding the same
+ * bzp_fragments extents in the index order, and that free extents do not
+ * overlap.
+ */
+static bool lext_invariant(struct m0_balloc_zone_param *zp)
+{
+	struct m0_lext     *le;
+	struct m0_lext     *prev;
+	m0_bcount_t         nr;
+	enum m0_lext_index  idx;
+
+	for (idx = 0; idx < M0_LEXT_INDEX_NR; ++idx) {
+		if (!m0_avl_invariant(&zp->bzp_extents[idx]))
+			return false;
+		prev = NULL;
+		nr   = 0;
+		for (le = lext_first(zp, idx); le != NULL;
+		     le = lext_next(le, idx)) {
+			if (prev != NULL &&
+			    (!_0C(lext_cmp(&prev->le_ext, &le->le_ext,
+					   idx) < 0) ||
+			     !_0C(ergo(idx == M0_LEXT_BY_START,
+				       prev->le_ext.e_end <=
+				       le->le_ext.e_start))))
+				return false;
+			prev = le;
+			++nr;
+		}
+		if (!_0C(nr == zp->bzp_fragments))
+			return false;
+	}
+	return true;
+}
+
 static struct m0_lext* lext_create(struct m0_ext *ex)
 {
 	struct m0_lext *le;
@@ -292,17 +433,16 @@ static struct m0_lext* lext_create(struct m0_ext *ex)
 static void extents_release(struct m0_balloc_group_info *grp,
 			    enum m0_balloc_allocation_flag zone_type)
 {
-	struct m0_list_link         *l;
 	struct m0_lext              *le;
 	struct m0_balloc_zone_param *zp;
 	m0_bcount_t                  frags = 0;
 
 	zp = is_spare(zone_type) ? &grp->bgi_spare : &grp->bgi_normal;
-	while ((l = m0_list_first(&zp->bzp_extents)) != NULL) {
-		le = m0_list_entry(l, struct m0_lext, le_link);
-		lext_del(le);
+	while ((le = lext_first(zp, M0_LEXT_BY_START)) != NULL) {
+		lext_del(zp, le);
 		++frags;
 	}
+	M0_ASSERT(m0_avl_is_empty(&zp->bzp_extents[M0_LEXT_BY_LEN]));
 	M0_LOG(M0_DEBUG, "zone_type = %d, grp=%p grpno=%" PRIu64 " list_frags=%d"
 	       "bzp_frags=%d", (int)zone_type, grp, grp->bgi_groupno,
 	       (int)frags, (int)zp->bzp_fragments);
@@ -402,32 +542,184 @@ static int balloc_group_info_init(struct m0_balloc_group_info *gi,
 static void balloc_group_info_fini(struct m0_balloc_group_info *gi)
 {
 	m0_mutex_fini(bgi_mutex(gi));
-	m0_list_fini(&gi->bgi_normal.bzp_extents);
-	m0_list_fini(&gi->bgi_spare.bzp_extents);
+	M0_ASSERT(lext_first(&gi->bgi_normal, M0_LEXT_BY_START) == NULL);
+	M0_ASSERT(lext_first(&gi->bgi_spare, M0_LEXT_BY_START) == NULL);
+}
+
+static int balloc_group_info_load_one(void *job)
+{
+	struct m0_balloc_group_info *gi = job;
+
+	if (M0_FI_ENABLED("fail"))
+		return M0_ERR(-EIO);
+	return balloc_group_info_init(gi, gi->bgi_balloc);
+}
+
+/** Processes jobs queued to @pool and returns the error of the first one. */
+static int balloc_pool_run(struct m0_parallel_pool *pool,
+			   int (*process)(void *grp))
+{
+	void *grp;
+	int   rc;
+
+	m0_parallel_pool_start(pool, process);
+	rc = m0_parallel_pool_wait(pool);
+	if (rc != 0)
+		(void)m0_parallel_pool_rc_next(pool, &grp, &rc);
+	return rc;
+}
+
+/**
+ * Applies @process to all groups, M0_BALLOC_LOAD_JOBS_NR groups at a time,
+ * in the order of group numbers starting from @start.
+ * Stops after the first batch in which @process failed.
+ */
+static int balloc_groups_parallel(struct m0_balloc *bal,
+				  struct m0_parallel_pool *pool,
+				  m0_bindex_t start,
+				  int (*process)(void *grp))
+{
+	m0_bcount_t  nr = bal->cb_sb.bsb_groupcount;
+	m0_bcount_t  i;
+	void        *grp;
+	int          rc = 0;
+
+	for (i = 0; i < nr && rc == 0; ++i) {
+		grp = m0_balloc_gn2info(bal, (start + i) % nr);
+		if (m0_parallel_pool_job_add(pool, grp) == -EFBIG)
+			rc = balloc_pool_run(pool, process) ?:
+			     m0_parallel_pool_job_add(pool, grp);
+	}
+	return rc ?: balloc_pool_run(pool, process);
 }
 
 static int balloc_group_info_load(struct m0_balloc *bal)
 {
+	struct m0_parallel_pool      pool = {};
 	struct m0_balloc_group_info *gi;
 	m0_bcount_t                  i;
-	int                          rc = 0;
+	int                          rc;
 
 	M0_LOG(M0_INFO, "Loading group info...");
 	for (i = 0; i < bal->cb_sb.bsb_groupcount; ++i) {
 		gi = &bal->cb_group_info[i];
 		gi->bgi_groupno = i;
-		rc = balloc_group_info_init(gi, bal);
-		if (rc != 0)
-			break;
+		gi->bgi_balloc  = bal;
+	}
+	rc = m0_parallel_pool_init(&pool, M0_BALLOC_LOAD_THREADS_NR,
+				   M0_BALLOC_LOAD_JOBS_NR);
+	if (rc != 0)
+		return M0_ERR(rc);
+	/* TODO verify the super_block info based on the group info */
+	rc = balloc_groups_parallel(bal, &pool, 0, &balloc_group_info_load_one);
+	m0_parallel_pool_terminate_wait(&pool);
+	m0_parallel_pool_fini(&pool);
 
-		/* TODO verify the super_block info based on the group info */
+	for (i = 0; rc != 0 && i < bal->cb_sb.bsb_groupcount; ++i) {
+		gi = &bal->cb_group_info[i];
+		if (gi->bgi_state & M0_BALLOC_GROUP_INFO_INIT)
+			balloc_group_info_fini(gi);
 	}
-	while (rc != 0 && i > 0) {
-		balloc_group_info_fini(&bal->cb_group_info[--i]);
+	return M0_RC(rc);
+}
+
+/**
+ * Background loader of free extents.
+ *
+ * Extents are loaded lazily by the allocator, so the first allocations after
+ * mount would pay for reading the free extents of every group they scan.
+ * The loader warms the groups in the order the allocator visits them,
+ * starting from the group of m0_balloc::cb_last.
+ *
+ * Groups are only taken with trylock, so the loader never waits for the
+ * allocator. The allocator can wait for the loader: the scan of the groups
+ * skips busy groups, but goal allocation, reservation and free take the
+ * group lock with m0_balloc_lock_group() and wait while the loader reads the
+ * extents of that group. The wait is not longer than loading the extents
+ * themselves would take.
+ */
+struct m0_balloc_prefetch {
+	struct m0_parallel_pool bp_pool;
+	struct m0_thread        bp_thread;
+	/** Set by balloc_prefetch_stop(). */
+	struct m0_atomic64      bp_stop;
+};
+
+static int balloc_prefetch_one(void *job)
+{
+	struct m0_balloc_group_info *grp = job;
+	struct m0_balloc            *bal = grp->bgi_balloc;
+	int                          rc = 0;
+
+	/* UT uses it to get the jobs which run after the stop. */
+	if (M0_FI_ENABLED("wait_stop")) {
+		while (m0_atomic64_get(&bal->cb_prefetch->bp_stop) == 0)
+			m0_nanosleep(M0_TIME_ONE_MSEC, NULL);
 	}
+	if (m0_atomic64_get(&bal->cb_prefetch->bp_stop) != 0)
+		return -ECANCELED;
+	if (m0_balloc_trylock_group(grp) != 0)
+		return 0;
+	if (group_freeblocks_get(grp) + group_spare_freeblocks_get(grp) > 0)
+		rc = m0_balloc_load_extents(bal, grp);
+	m0_balloc_unlock_group(grp);
+	return rc;
+}
+
+static void balloc_prefetch_thread(struct m0_balloc *bal)
+{
+	int rc;
+
+	rc = balloc_groups_parallel(bal, &bal->cb_prefetch->bp_pool,
+				    balloc_bn2gn(bal->cb_last, bal),
+				    &balloc_prefetch_one);
+	if (rc != 0 && rc != -ECANCELED)
+		M0_LOG(M0_WARN, "Free extents prefetch failed: rc=%d", rc);
+}
+
+static int balloc_prefetch_start(struct m0_balloc *bal)
+{
+	struct m0_balloc_prefetch *bp;
+	int                        rc;
+
+	M0_PRE(bal->cb_prefetch == NULL);
+
+	M0_ALLOC_PTR(bp);
+	if (bp == NULL)
+		return M0_ERR(-ENOMEM);
+	m0_atomic64_set(&bp->bp_stop, 0);
+	rc = m0_parallel_pool_init(&bp->bp_pool, M0_BALLOC_LOAD_THREADS_NR,
+				   M0_BALLOC_LOAD_JOBS_NR);
+	if (rc == 0) {
+		bal->cb_prefetch = bp;
+		rc = M0_THREAD_INIT(&bp->bp_thread, struct m0_balloc *, NULL,
+				    &balloc_prefetch_thread, bal,
+				    "balloc_prefetch");
+		if (rc != 0) {
+			bal->cb_prefetch = NULL;
+			m0_parallel_pool_terminate_wait(&bp->bp_pool);
+			m0_parallel_pool_fini(&bp->bp_pool);
+		}
+	}
+	if (rc != 0)
+		m0_free(bp);
 	return M0_RC(rc);
 }
 
+static void balloc_prefetch_stop(struct m0_balloc *bal)
+{
+	struct m0_balloc_prefetch *bp = bal->cb_prefetch;
+
+	if (bp == NULL)
+		return;
+	m0_atomic64_set(&bp->bp_stop, 1);
+	m0_thread_join(&bp->bp_thread);
+	m0_thread_fini(&bp->bp_thread);
+	m0_parallel_pool_terminate_wait(&bp->bp_pool);
+	m0_parallel_pool_fini(&bp->bp_pool);
+	m0_free0(&bal->cb_prefetch);
+}
+
 /**
    finalization of the balloc environment.
  */
@@ -438,6 +730,7 @@ static void balloc_fini_internal(struct m0_balloc *bal)
 
 	M0_ENTRY();
 
+	balloc_prefetch_stop(bal);
 	if (bal->cb_group_info != NULL) {
 		for (i = 0 ; i < bal->cb_sb.bsb_groupcount; i++) {
 			gi = &bal->cb_group_info[i];
@@ -469,10 +762,12 @@ static int ge_tree_cmp(const void *k0, const void *k1)
 }
 
 static const struct m0_be_btree_kv_ops ge_btree_ops = {
-	.ko_type    = M0_BBT_BALLOC_GROUP_EXTENTS,
-	.ko_ksize   = ge_tree_kv_size,
-	.ko_vsize   = ge_tree_kv_size,
-	.ko_compare = ge_tree_cmp
+	.ko_type         = M0_BBT_BALLOC_GROUP_EXTENTS,
+	.ko_ksize        = ge_tree_kv_size,
+	.ko_vsize        = ge_tree_kv_size,
+	.ko_compare      = ge_tree_cmp,
+	.ko_inline_ksize = sizeof(m0_bindex_t),
+	.ko_flags        = M0_BKF_U64
 };
 
 static m0_bcount_t gd_tree_key_size(const void *k)
@@ -621,156 +916,94 @@ static int balloc_sb_write(struct m0_balloc            *bal,
 	return M0_RC(rc);
 }
 
-struct balloc_group_write_cfg {
-	struct m0_balloc *bgc_bal;
-	m0_bcount_t       bgc_i;
+/**
+ * Source of the initial records of a group extents or group descriptors tree
+ * for m0_be_btree_bulk_load(). Records of both trees are generated in the
+ * increasing order of group numbers, which is also their key order.
+ */
+struct balloc_format_src {
+	struct m0_be_btree_bulk_src  bfs_src;
+	struct m0_balloc            *bfs_bal;
+	/** Index of the next record. */
+	m0_bcount_t                  bfs_i;
+	struct m0_ext                bfs_ext;
+	struct m0_balloc_group_desc  bfs_gd;
 };
 
-struct balloc_groups_write_cfg {
-	struct balloc_group_write_cfg *bgs_bgc;
-	struct m0_balloc              *bgs_bal;
-	m0_bcount_t                    bgs_max;
-	int                            bgs_rc;
-	struct m0_mutex                bgs_lock;
+enum {
+#ifdef __SPARE_SPACE__
+	/** Free extents per group: the non-spare and the spare one. */
+	BALLOC_FORMAT_EXT_NR = 2
+#else
+	BALLOC_FORMAT_EXT_NR = 1
+#endif
 };
 
-static void
-balloc_group_write_credit(struct m0_balloc               *bal,
-                          struct m0_be_tx_bulk           *tb,
-                          struct balloc_groups_write_cfg *bgs,
-                          struct m0_be_tx_credit         *credit)
+static int balloc_format_ext_next(struct m0_be_btree_bulk_src *src,
+				  struct m0_buf               *key,
+				  struct m0_buf               *val)
 {
-	m0_be_btree_insert_credit(&bal->cb_db_group_extents, 2,
-		M0_MEMBER_SIZE(struct m0_ext, e_start),
-		M0_MEMBER_SIZE(struct m0_ext, e_end), credit);
-	m0_be_btree_insert_credit(&bal->cb_db_group_desc, 2,
-		M0_MEMBER_SIZE(struct m0_balloc_group_desc, bgd_groupno),
-		sizeof(struct m0_balloc_group_desc), credit);
-}
-
-static void balloc_group_work_put(struct m0_balloc               *bal,
-                                  struct m0_be_tx_bulk           *tb,
-                                  struct balloc_groups_write_cfg *bgs)
-{
-	struct balloc_group_write_cfg *bgc;
-	struct m0_be_tx_credit         credit;
-	m0_bcount_t                    i;
-	bool                           put_successful;
-	int                            rc;
-
-	for (i = 0; i < bgs->bgs_max; ++i) {
-		m0_mutex_lock(&bgs->bgs_lock);
-		rc = bgs->bgs_rc;
-		m0_mutex_unlock(&bgs->bgs_lock);
-		if (rc != 0)
-			break;
-		bgc  = &bgs->bgs_bgc[i];
-		*bgc = (struct balloc_group_write_cfg){
-			.bgc_bal = bgs->bgs_bal,
-			.bgc_i   = i,
-		};
-		credit = M0_BE_TX_CREDIT(0, 0);
-		balloc_group_write_credit(bal, tb, bgs, &credit);
-		M0_BE_OP_SYNC(op, put_successful =
-			      m0_be_tx_bulk_put(tb, &op, &credit, 0, 0, bgc));
-		if (!put_successful)
-			break;
-	}
-	m0_be_tx_bulk_end(tb);
-}
-
-static void balloc_group_write_do(struct m0_be_tx_bulk *tb,
-                                  struct m0_be_tx      *tx,
-                                  struct m0_be_op      *op,
-                                  void                 *datum,
-                                  void                 *user,
-                                  uint64_t              worker_index,
-                                  uint64_t              partition)
-{
-	struct balloc_groups_write_cfg *bgs = datum;
-	struct balloc_group_write_cfg  *bgc = user;
-	struct m0_balloc               *bal = bgc->bgc_bal;
-	struct m0_balloc_group_desc     gd;
-	struct m0_balloc_super_block   *sb = &bal->cb_sb;
-	struct m0_ext                   ext;
-	struct m0_buf                   key;
-	struct m0_buf                   val;
-	m0_bcount_t                     i = bgc->bgc_i;
-	m0_bcount_t                     spare_size;
-	int                             rc;
-
-	m0_be_op_active(op);
+	struct balloc_format_src     *bfs = container_of(src,
+					      struct balloc_format_src, bfs_src);
+	struct m0_balloc_super_block *sb  = &bfs->bfs_bal->cb_sb;
+	struct m0_ext                *ext = &bfs->bfs_ext;
+	m0_bcount_t                   i   = bfs->bfs_i / BALLOC_FORMAT_EXT_NR;
+	m0_bcount_t                   spare_size;
 
-	M0_LOG(M0_DEBUG, "creating group_extents for group %llu",
-	       (unsigned long long)i);
+	if (i == sb->bsb_groupcount)
+		return -ENOENT;
 	spare_size = m0_stob_ad_spares_calc(sb->bsb_groupsize);
-	/* Insert non-spare extents. */
-	ext.e_start = i << sb->bsb_gsbits;
-	ext.e_end = ext.e_start + sb->bsb_groupsize - spare_size;
-	m0_ext_init(&ext);
-	balloc_debug_dump_extent("create...", &ext);
-
-	key = (struct m0_buf)M0_BUF_INIT_PTR(&ext.e_end);
-	val = (struct m0_buf)M0_BUF_INIT_PTR(&ext.e_start);
-	rc = btree_insert_sync(&bal->cb_db_group_extents, tx, &key, &val);
-	if (rc != 0) {
-		M0_LOG(M0_ERROR, "insert extent failed: group=%llu "
-				 "rc=%d", (unsigned long long)i, rc);
-		goto out;
-	}
+	/* Non-spare extent. */
+	ext->e_start = i << sb->bsb_gsbits;
+	ext->e_end = ext->e_start + sb->bsb_groupsize - spare_size;
 #ifdef __SPARE_SPACE__
-	/* Insert extents reserved for spare. */
-	ext.e_start = (i << sb->bsb_gsbits) + sb->bsb_groupsize -
-		spare_size;
-	ext.e_end = ext.e_start + spare_size;
-	key = (struct m0_buf)M0_BUF_INIT_PTR(&ext.e_end);
-	val = (struct m0_buf)M0_BUF_INIT_PTR(&ext.e_start);
-	rc = btree_insert_sync(&bal->cb_db_group_extents, tx, &key, &val);
-	if (rc != 0) {
-		M0_LOG(M0_ERROR, "insert extent failed for spares: group=%llu "
-				 "rc=%d", (unsigned long long)i, rc);
-		goto out;
+	if (bfs->bfs_i % BALLOC_FORMAT_EXT_NR == 1) {
+		/* Extent reserved for spare. */
+		ext->e_start = ext->e_end;
+		ext->e_end = ext->e_start + spare_size;
 	}
 #endif
+	m0_ext_init(ext);
+	balloc_debug_dump_extent("create...", ext);
+	++bfs->bfs_i;
+	*key = (struct m0_buf)M0_BUF_INIT_PTR(&ext->e_end);
+	*val = (struct m0_buf)M0_BUF_INIT_PTR(&ext->e_start);
+	return 0;
+}
+
+static int balloc_format_gd_next(struct m0_be_btree_bulk_src *src,
+				 struct m0_buf               *key,
+				 struct m0_buf               *val)
+{
+	struct balloc_format_src     *bfs = container_of(src,
+					      struct balloc_format_src, bfs_src);
+	struct m0_balloc_super_block *sb  = &bfs->bfs_bal->cb_sb;
+	struct m0_balloc_group_desc  *gd  = &bfs->bfs_gd;
+	m0_bcount_t                   i   = bfs->bfs_i;
+	m0_bcount_t                   spare_size;
+
+	if (i == sb->bsb_groupcount)
+		return -ENOENT;
 	M0_LOG(M0_DEBUG, "creating group_desc for group %llu",
 	       (unsigned long long)i);
-	gd.bgd_groupno = i;
+	spare_size = m0_stob_ad_spares_calc(sb->bsb_groupsize);
+	M0_SET0(gd);
+	gd->bgd_groupno = i;
 #ifdef __SPARE_SPACE__
-	gd.bgd_spare_freeblocks = sb->bsb_sparesize;
-	gd.bgd_sparestart = (i << sb->bsb_gsbits) + sb->bsb_groupsize -
+	gd->bgd_spare_freeblocks = sb->bsb_sparesize;
+	gd->bgd_sparestart = (i << sb->bsb_gsbits) + sb->bsb_groupsize -
 				sb->bsb_sparesize;
-	gd.bgd_spare_frags = 1;
-	gd.bgd_spare_maxchunk = sb->bsb_sparesize;
+	gd->bgd_spare_frags = 1;
+	gd->bgd_spare_maxchunk = sb->bsb_sparesize;
 #endif
-	gd.bgd_freeblocks = sb->bsb_groupsize - spare_size;
-	gd.bgd_maxchunk   = sb->bsb_groupsize - spare_size;
-	gd.bgd_fragments  = 1;
-	m0_balloc_group_desc_init(&gd);
-	key = (struct m0_buf)M0_BUF_INIT_PTR(&gd.bgd_groupno);
-	val = (struct m0_buf)M0_BUF_INIT_PTR(&gd);
-
-	rc = btree_insert_sync(&bal->cb_db_group_desc, tx, &key, &val);
-	if (rc != 0) {
-		M0_LOG(M0_ERROR, "insert gd failed: group=%llu rc=%d",
-			(unsigned long long)i, rc);
-	}
-out:
-	if (rc != 0) {
-		m0_mutex_lock(&bgs->bgs_lock);
-		bgs->bgs_rc = rc;
-		m0_mutex_unlock(&bgs->bgs_lock);
-	}
-	m0_be_op_done(op);
-}
-
-static void balloc_group_write_done(struct m0_be_tx_bulk *tb,
-                                    void                 *datum,
-                                    void                 *user,
-                                    uint64_t              worker_index,
-                                    uint64_t              partition)
-{
-	M0_LOG(M0_DEBUG, "tb=%p datum=%p user=%p worker_index=%" PRIu64 " "
-	       "partition=%"PRIu64, tb, datum, user, worker_index, partition);
+	gd->bgd_freeblocks = sb->bsb_groupsize - spare_size;
+	gd->bgd_maxchunk   = sb->bsb_groupsize - spare_size;
+	gd->bgd_fragments  = 1;
+	m0_balloc_group_desc_init(gd);
+	++bfs->bfs_i;
+	*key = (struct m0_buf)M0_BUF_INIT_PTR(&gd->bgd_groupno);
+	*val = (struct m0_buf)M0_BUF_INIT_PTR(gd);
+	return 0;
 }
 
 static void balloc_zone_init(struct m0_balloc_zone_param *zone, uint64_t type,
@@ -784,16 +1017,23 @@ static void balloc_zone_init(struct m0_balloc_zone_param *zone, uint64_t type,
 	zone->bzp_freeblocks = freeblocks;
 	zone->bzp_fragments = fragments;
 	zone->bzp_maxchunk = maxchunk;
-	m0_list_init(&zone->bzp_extents);
+	m0_avl_init(&zone->bzp_extents[M0_LEXT_BY_START]);
+	m0_avl_init(&zone->bzp_extents[M0_LEXT_BY_LEN]);
 }
 
 static int balloc_groups_write(struct m0_balloc *bal)
 {
-	struct balloc_groups_write_cfg  bgs;
-	struct m0_balloc_super_block   *sb = &bal->cb_sb;
-	struct m0_be_tx_bulk_cfg        tb_cfg;
-	struct m0_be_tx_bulk            tb = {};
-	int                             rc;
+	struct m0_balloc_super_block *sb  = &bal->cb_sb;
+	struct m0_be_domain          *dom = bal->cb_be_seg->bs_domain;
+	struct balloc_format_src      ext = {
+		.bfs_src = { .bbs_next = &balloc_format_ext_next },
+		.bfs_bal = bal
+	};
+	struct balloc_format_src      gd  = {
+		.bfs_src = { .bbs_next = &balloc_format_gd_next },
+		.bfs_bal = bal
+	};
+	int                           rc;
 
 	M0_ENTRY();
 
@@ -801,46 +1041,14 @@ static int balloc_groups_write(struct m0_balloc *bal)
 	if (bal->cb_group_info == NULL) {
 		return M0_ERR(-ENOMEM);
 	}
-	bgs = (struct balloc_groups_write_cfg) {
-		.bgs_bal     = bal,
-		.bgs_max     = sb->bsb_groupcount,
-		.bgs_rc      = 0,
-	};
-	M0_ALLOC_ARR(bgs.bgs_bgc, bgs.bgs_max);
-	if (bgs.bgs_bgc == NULL) {
-		m0_free0(&bal->cb_group_info);
-		return M0_ERR(-ENOMEM);
-	}
-	m0_mutex_init(&bgs.bgs_lock);
-	tb_cfg = (struct m0_be_tx_bulk_cfg){
-		.tbc_q_cfg                 = {
-			.bqc_q_size_max       = 0x100,
-			.bqc_producers_nr_max = 1,
-		},
-		.tbc_workers_nr            = 0x40,
-		.tbc_partitions_nr         = 1,
-		.tbc_work_items_per_tx_max = 1,
-		.tbc_dom                   = bal->cb_be_seg->bs_domain,
-		.tbc_datum                 = &bgs,
-		.tbc_do                    = &balloc_group_write_do,
-		.tbc_done                  = &balloc_group_write_done,
-	};
-
-	rc = m0_be_tx_bulk_init(&tb, &tb_cfg);
-	if (rc == 0) {
-		M0_BE_OP_SYNC(op, ({
-			m0_be_tx_bulk_run(&tb, &op);
-			balloc_group_work_put(bal, &tb, &bgs);
-		}));
-		rc = m0_be_tx_bulk_status(&tb);
-		m0_be_tx_bulk_fini(&tb);
-	}
-	m0_mutex_fini(&bgs.bgs_lock);
-	m0_free(bgs.bgs_bgc);
-	if (bgs.bgs_rc != 0)
-		rc = bgs.bgs_rc;
-
-	rc = rc ?: balloc_group_info_load(bal);
+	/*
+	 * Both trees are empty and their records are generated in key order,
+	 * so they are built bottom-up, with full nodes and without splits.
+	 */
+	rc = m0_be_btree_bulk_load(&bal->cb_db_group_extents, dom,
+				   &ext.bfs_src) ?:
+	     m0_be_btree_bulk_load(&bal->cb_db_group_desc, dom, &gd.bfs_src) ?:
+	     balloc_group_info_load(bal);
 	if (rc != 0) {
 		/* balloc_fini_internal() checks whether this pointer is NULL */
 		m0_free0(&bal->cb_group_info);
@@ -963,6 +1171,7 @@ static int balloc_init_internal(struct m0_balloc *bal,
 
 	bal->cb_be_seg = seg;
 	bal->cb_group_info = NULL;
+	bal->cb_prefetch = NULL;
 	m0_mutex_init(&bal->cb_sb_mutex.bm_u.mutex);
 
 	m0_be_btree_init(&bal->cb_db_group_desc, seg, &gd_btree_ops);
@@ -998,6 +1207,9 @@ static int balloc_init_internal(struct m0_balloc *bal,
 			m0_free0(&bal->cb_group_info);
 	}
 	rc = rc ?: sb_mount(bal, grp);
+	/* Without prefetch the first allocations only load extents slower. */
+	if (rc == 0)
+		(void)balloc_prefetch_start(bal);
 out:
 	if (rc != 0)
 		balloc_fini_internal(bal);
@@ -1233,10 +1445,9 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 		ex->le_ext.e_start = *(m0_bindex_t*)val.b_addr;
 		m0_ext_init(&ex->le_ext);
 		if (m0_ext_is_partof(&normal_range, &ex->le_ext))
-			m0_list_add_tail(group_normal_ext(grp),
-					 &ex->le_link);
+			lext_add(&grp->bgi_normal, ex);
 		else if (m0_ext_is_partof(&spare_range, &ex->le_ext)) {
-			m0_list_add_tail(group_spare_ext(grp), &ex->le_link);
+			lext_add(&grp->bgi_spare, ex);
 		}
 		else {
 			M0_LOG(M0_ERROR, "Invalid extent");
@@ -1333,12 +1544,12 @@ M0_INTERNAL int m0_balloc_load_extents(struct m0_balloc *cb,
 			break;
 		m0_ext_init(&ex->le_ext);
 		if (m0_ext_is_partof(&normal_range, &ex->le_ext)) {
-			m0_list_add_tail(group_normal_ext(grp), &ex->le_link);
+			lext_add(&grp->bgi_normal, ex);
 			++normal_frags;
 			zone_params_update(grp, &ex->le_ext,
 					   M0_BALLOC_NORMAL_ZONE);
 		} else if (m0_ext_is_partof(&spare_range, &ex->le_ext)) {
-			m0_list_add_tail(group_spare_ext(grp), &ex->le_link);
+			lext_add(&grp->bgi_spare, ex);
 			++spare_frags;
 			zone_params_update(grp, &ex->le_ext,
 					   M0_BALLOC_SPARE_ZONE);
@@ -1405,9 +1616,12 @@ static int balloc_find_extent_buddy(struct balloc_allocation_context *bac,
 {
 	int                          found = 0;
 	m0_bcount_t                  flen;
-	m0_bcount_t start;
+	m0_bindex_t                  start;
+	m0_bindex_t                  zstart;
+	struct m0_ext                key;
 	struct m0_ext               *frag;
 	struct m0_lext              *le;
+	struct m0_lext              *floor;
 	struct m0_ext                min = {
 					.e_start = 0,
 					.e_end = 0xffffffff,
@@ -1423,39 +1637,37 @@ static int balloc_find_extent_buddy(struct balloc_allocation_context *bac,
 	M0_LOG(M0_DEBUG, "start=%" PRIu64 " len=%"PRIu64,
 	       zp->bzp_range.e_start, len);
 
-	start = zp->bzp_range.e_start;
-	m0_list_for_each_entry(&zp->bzp_extents, le, struct m0_lext, le_link) {
+	zstart = zp->bzp_range.e_start;
+	start  = zstart;
+	/*
+	 * Buddies start at len-aligned offsets from the zone start. The first
+	 * fragment starting at or after the next such offset is found by a
+	 * lower-bound lookup in the start index, skipping the fragments in
+	 * between. The shortest of the first M0_BALLOC_BUDDY_LOOKUP_MAX
+	 * buddies is used.
+	 */
+	while (start < zp->bzp_range.e_end) {
+		key = M0_EXT(start, start + len);
+		lext_lookup(zp, M0_LEXT_BY_START, &key, &floor, &le);
+		if (le == NULL)
+			break;
 		frag = &le->le_ext;
 		flen = m0_ext_length(frag);
 		M0_LOG(M0_DEBUG, "frag="EXT_F, EXT_P(frag));
-repeat:
-		/*
-		{
-			char msg[128];
-			sprintf(msg, "buddy[s=%llu:0x%08llx, l=%u:0x%08x]",
-			(unsigned long long)start,
-			(unsigned long long)start,
-			(int)len, (int)len);
-			(void)msg;
-			balloc_debug_dump_extent(msg, frag);
-			}
-		*/
-		if (frag->e_start == start && flen >= len) {
+		if (frag->e_start > start) {
+			/* The first aligned offset not before the fragment. */
+			start = zstart + (frag->e_start - zstart + len - 1) /
+				len * len;
+			continue;
+		}
+		if (flen >= len) {
 			++found;
 			if (flen < m0_ext_length(&min))
 				min = *frag;
 			if (flen == len || found > M0_BALLOC_BUDDY_LOOKUP_MAX)
 				break;
 		}
-		if (frag->e_start > start) {
-			do {
-				start += len;
-			} while (frag->e_start > start);
-			if (start >= zp->bzp_range.e_end)
-				break;
-			/* we changed the 'start'. let's restart searching. */
-			goto repeat;
-		}
+		start += len;
 	}
 
 	if (found > 0)
@@ -1538,21 +1750,22 @@ static bool is_extent_free(struct m0_balloc_group_info *grp,
 			   const struct m0_ext *tgt, uint64_t alloc_type,
 			   struct m0_ext **current)
 {
+	struct m0_lext              *floor;
+	struct m0_lext              *ceil;
 	struct m0_lext              *le;
 	struct m0_balloc_zone_param *zp;
-	m0_bcount_t                  frags = 0;
 
 	M0_ENTRY();
 
 	zp = is_spare(alloc_type) ? &grp->bgi_spare : &grp->bgi_normal;
 
-	m0_list_for_each_entry(&zp->bzp_extents, le, struct m0_lext, le_link) {
-		*current = &le->le_ext;
-		if (m0_ext_is_partof(*current, tgt))
-			break;
-		++frags;
-	}
-	return frags < zp->bzp_fragments;
+	lext_lookup(zp, M0_LEXT_BY_START, tgt, &floor, &ceil);
+	le = ceil != NULL && ceil->le_ext.e_start == tgt->e_start ?
+		ceil : floor;
+	if (le == NULL)
+		return false;
+	*current = &le->le_ext;
+	return m0_ext_is_partof(*current, tgt);
 }
 
 static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
@@ -1564,10 +1777,8 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 	struct m0_buf                key;
 	struct m0_buf                val;
 	struct m0_lext              *le;
-	struct m0_lext              *lcur;
 	struct m0_balloc_zone_param *zp;
 	int                          rc = 0;
-	m0_bcount_t                  maxchunk;
 
 	M0_ENTRY();
 	M0_PRE(m0_mutex_is_locked(bgi_mutex(grp)));
@@ -1579,25 +1790,9 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 	balloc_debug_dump_extent("target=", tgt);
 
 	zp = is_spare(alloc_type) ? &grp->bgi_spare : &grp->bgi_normal;
-	maxchunk = zp->bzp_maxchunk;
 
 	balloc_debug_dump_extent("current=", cur);
 
-	if (m0_ext_length(cur) == zp->bzp_maxchunk) {
-		/* find next to max sized chunk */
-		maxchunk = 0;
-		m0_list_for_each_entry(&zp->bzp_extents, le,
-				       struct m0_lext, le_link) {
-			if (&le->le_ext == cur)
-				continue;
-			maxchunk = max_check(maxchunk,
-					     m0_ext_length(&le->le_ext));
-		}
-	}
-
-	M0_LOG(M0_DEBUG, "bzp_maxchunk=0x%" PRIx64 " next_maxchunk=0x%"PRIx64,
-	       zp->bzp_maxchunk, maxchunk);
-
 	if (cur->e_end == tgt->e_end) {
 		key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 
@@ -1610,20 +1805,19 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 			/* |   cur free   |     allocated      | */
 			/* |      |  tgt  |                    | */
 			/* +------+-------+--------------------+ */
-			cur->e_end = tgt->e_start;
+			lext_resize(zp, cur, cur->e_start, tgt->e_start);
 			key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 			val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
 			rc = btree_insert_sync(db, tx, &key, &val);
 			if (rc != 0)
 				return M0_RC(rc);
-			maxchunk = max_check(maxchunk, m0_ext_length(cur));
 		} else {
 			/* +-------------+---------------------+ */
 			/* |   cur free  |      allocated      | */
 			/* |     tgt     |                     | */
 			/* +-------------+---------------------+ */
 			le = container_of(cur, struct m0_lext, le_ext);
-			lext_del(le);
+			lext_del(zp, le);
 			zp->bzp_fragments--;
 		}
 	} else {
@@ -1633,7 +1827,7 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 		/* |              cur free             | */
 		/* |     tgt    |                      | */
 		/* +------------+----------------------+ */
-		cur->e_start = tgt->e_end;
+		lext_resize(zp, cur, tgt->e_end, cur->e_end);
 
 		key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 		val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
@@ -1641,8 +1835,6 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 		if (rc != 0)
 			return M0_RC(rc);
 
-		maxchunk = max_check(maxchunk, m0_ext_length(cur));
-
 		if (new.e_start < tgt->e_start) {
 			/* +-----------------------------------+ */
 			/* |              cur free             | */
@@ -1659,14 +1851,14 @@ static int balloc_alloc_db_update(struct m0_balloc *motr, struct m0_be_tx *tx,
 				m0_free(le);
 				return M0_RC(rc);
 			}
-			lcur = container_of(cur, struct m0_lext, le_ext);
-			m0_list_add_before(&lcur->le_link, &le->le_link);
+			lext_add(zp, le);
 			zp->bzp_fragments++;
-			maxchunk = max_check(maxchunk, m0_ext_length(&new));
 		}
 	}
-	zp->bzp_maxchunk = maxchunk;
+	zp->bzp_maxchunk = lext_maxchunk(zp);
+	M0_LOG(M0_DEBUG, "bzp_maxchunk=0x%" PRIx64, zp->bzp_maxchunk);
 	zp->bzp_freeblocks -= m0_ext_length(tgt);
+	M0_ASSERT_EX(lext_invariant(zp));
 
 	grp->bgi_state |= M0_BALLOC_GROUP_INFO_DIRTY;
 
@@ -1697,12 +1889,12 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 	struct m0_ext               *cur = NULL;
 	struct m0_ext               *pre = NULL;
 	struct m0_lext              *le;
-	struct m0_lext              *lcur;
+	struct m0_lext              *floor;
+	struct m0_lext              *ceil;
 	struct m0_balloc_zone_param *zp;
-	m0_bcount_t                  frags = 0;
 	m0_bcount_t                  maxchunk;
 	int                          rc = 0;
-	int                          found = 0;
+	int                          found;
 
 	M0_ENTRY();
 	M0_PRE(m0_mutex_is_locked(bgi_mutex(grp)));
@@ -1711,16 +1903,12 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 
 	zp = is_spare(alloc_flag) ? &grp->bgi_spare : &grp->bgi_normal;
 	maxchunk = zp->bzp_maxchunk;
-	m0_list_for_each_entry(&zp->bzp_extents, le, struct m0_lext, le_link) {
-		cur = &le->le_ext;
-
-		if (cur->e_start >= tgt->e_start) {
-			found = 1;
-			break;
-		}
-		pre = cur;
-		++frags;
-	}
+	/* cur is the first fragment starting not before tgt, if found */
+	lext_lookup(zp, M0_LEXT_BY_START, tgt, &floor, &ceil);
+	if (floor != NULL)
+		pre = &floor->le_ext;
+	found = ceil != NULL;
+	cur = found ? &ceil->le_ext : pre;
 	balloc_debug_dump_extent("prev=", pre);
 	balloc_debug_dump_extent("current=", cur);
 
@@ -1743,10 +1931,8 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 		return M0_RC(-EINVAL);
 	}
 
-	lcur = container_of(cur, struct m0_lext, le_ext);
-
 	if (!found) {
-		if (frags == 0) {
+		if (cur == NULL) {
 			/*       No free fragments at all:       */
 			/* +-----------------------------------+ */
 			/* |              allocated            | */
@@ -1762,7 +1948,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				m0_free(le);
 				return M0_RC(rc);
 			}
-			m0_list_add(&zp->bzp_extents, &le->le_link);
+			lext_add(zp, le);
 			++zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 		} else {
@@ -1783,7 +1969,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 					m0_free(le);
 					return M0_RC(rc);
 				}
-				m0_list_add_after(&lcur->le_link, &le->le_link);
+				lext_add(zp, le);
 				++zp->bzp_fragments;
 				maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 			} else {
@@ -1796,7 +1982,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				rc = btree_delete_sync(db, tx, &key);
 				if (rc != 0)
 					return M0_RC(rc);
-				cur->e_end = tgt->e_end;
+				lext_resize(zp, cur, cur->e_start, tgt->e_end);
 				val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
 				rc = btree_insert_sync(db, tx, &key, &val);
 				if (rc != 0)
@@ -1822,7 +2008,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				m0_free(le);
 				return M0_RC(rc);
 			}
-			m0_list_add_before(&lcur->le_link, &le->le_link);
+			lext_add(zp, le);
 			++zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 		} else {
@@ -1832,7 +2018,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			/* |     |   tgt   |                   | */
 			/* +-----+---------+-------------------+ */
 			M0_ASSERT(tgt->e_end == cur->e_start);
-			cur->e_start = tgt->e_start;
+			lext_resize(zp, cur, tgt->e_start, cur->e_end);
 			key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 			val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
 			rc = btree_update_sync(db, tx, &key, &val);
@@ -1853,14 +2039,14 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			rc = btree_delete_sync(db, tx, &key);
 			if (rc != 0)
 				return M0_RC(rc);
-			cur->e_start = pre->e_start;
+			lext_resize(zp, cur, pre->e_start, cur->e_end);
 			key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 			val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
 			rc = btree_update_sync(db, tx, &key, &val);
 			if (rc != 0)
 				return M0_RC(rc);
 			le = container_of(pre, struct m0_lext, le_ext);
-			lext_del(le);
+			lext_del(zp, le);
 			--zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(cur));
 		} else if (pre->e_end == tgt->e_start) {
@@ -1873,7 +2059,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			rc = btree_delete_sync(db, tx, &key);
 			if (rc != 0)
 				return M0_RC(rc);
-			pre->e_end = tgt->e_end;
+			lext_resize(zp, pre, pre->e_start, tgt->e_end);
 			val = (struct m0_buf)M0_BUF_INIT_PTR(&pre->e_start);
 			rc = btree_insert_sync(db, tx, &key, &val);
 			if (rc != 0)
@@ -1885,7 +2071,7 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 			/* |  pre  |       <--|    cur free    | */
 			/* |          |  tgt  |                | */
 			/* +----------+-------+----------------+ */
-			cur->e_start = tgt->e_start;
+			lext_resize(zp, cur, tgt->e_start, cur->e_end);
 			key = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_end);
 			val = (struct m0_buf)M0_BUF_INIT_PTR(&cur->e_start);
 			rc = btree_update_sync(db, tx, &key, &val);
@@ -1908,13 +2094,14 @@ static int balloc_free_db_update(struct m0_balloc *motr,
 				m0_free(le);
 				return M0_RC(rc);
 			}
-			m0_list_add_before(&lcur->le_link, &le->le_link);
+			lext_add(zp, le);
 			++zp->bzp_fragments;
 			maxchunk = max_check(maxchunk, m0_ext_length(tgt));
 		}
 	}
 	zp->bzp_maxchunk = maxchunk;
 	zp->bzp_freeblocks += m0_ext_length(tgt);
+	M0_ASSERT_EX(lext_invariant(zp));
 
 	grp->bgi_state |= M0_BALLOC_GROUP_INFO_DIRTY;
 
@@ -2235,22 +2422,21 @@ static int balloc_wild_scan_group(struct balloc_allocation_context *bac,
 				  struct m0_balloc_group_info *grp,
 				  enum m0_balloc_allocation_flag alloc_flag)
 {
-	struct m0_list  *list;
-	m0_bcount_t	 free;
-	struct m0_ext	*ex;
-	struct m0_lext	*le;
-	int		 rc;
-	int              end_of_group = 0;
+	struct m0_balloc_zone_param *zp;
+	m0_bcount_t		     free;
+	struct m0_ext		    *ex;
+	struct m0_lext		    *le;
+	int			     rc;
+	int			     end_of_group = 0;
 	M0_ENTRY();
 
 #ifdef __SPARE_SPACE__
 	free = is_spare(bac->bac_flags) ? group_spare_freeblocks_get(grp) :
 		group_freeblocks_get(grp);
-	list = is_spare(alloc_flag) ? &grp->bgi_spare.bzp_extents :
-		 &grp->bgi_normal.bzp_extents;
+	zp = is_spare(alloc_flag) ? &grp->bgi_spare : &grp->bgi_normal;
 #else
 	free = group_freeblocks_get(grp);
-	list = &grp->bgi_normal.bzp_extents;
+	zp = &grp->bgi_normal;
 #endif
 
 	/**
@@ -2281,7 +2467,13 @@ static int balloc_wild_scan_group(struct balloc_allocation_context *bac,
 		(unsigned long long)grp->bgi_groupno,
 		(unsigned long long)free);
 
-	m0_list_for_each_entry(list, le, struct m0_lext, le_link) {
+	/*
+	 * Fragments are measured in the order of their start, so that
+	 * balloc_check_limits() settles on the best of the first
+	 * M0_BALLOC_DEFAULT_MIN_TO_SCAN candidates, closest to the group start.
+	 */
+	for (le = lext_first(zp, M0_LEXT_BY_START); le != NULL;
+	     le = lext_next(le, M0_LEXT_BY_START)) {
 		ex = &le->le_ext;
 		if (m0_ext_length(ex) > free) {
 			M0_LOG(M0_WARN, "corrupt group=%llu "
@@ -2317,8 +2509,9 @@ static int balloc_try_best_found(struct balloc_allocation_context *bac,
 							     group);
 	struct m0_ext		    *ex;
 	struct m0_ext		    *cur = NULL;
+	struct m0_lext		    *floor;
 	struct m0_lext		    *le;
-	struct m0_list              *list;
+	struct m0_balloc_zone_param *zp;
 	int			     rc = -ENOENT;
 
 	M0_ENTRY();
@@ -2337,18 +2530,14 @@ static int balloc_try_best_found(struct balloc_allocation_context *bac,
 		goto out;
 
 	rc = -ENOENT;
-	list = is_spare(alloc_flag) ? group_spare_ext(grp) :
-		 group_normal_ext(grp);
-	m0_list_for_each_entry(list, le, struct m0_lext, le_link) {
-		ex = &le->le_ext;
-		if (m0_ext_equal(ex, best)) {
-			rc = balloc_use_best_found(bac,
-						   zone_start_get(grp,
-								  alloc_flag));
-			break;
-		} else if (ex->e_start > best->e_start)
-			goto out;
-	}
+	zp = is_spare(alloc_flag) ? &grp->bgi_spare : &grp->bgi_normal;
+	lext_lookup(zp, M0_LEXT_BY_START, best, &floor, &le);
+	if (le == NULL)
+		goto out;
+	ex = &le->le_ext;
+	if (!m0_ext_equal(ex, best))
+		goto out;
+	rc = balloc_use_best_found(bac, zone_start_get(grp, alloc_flag));
 
 	/* update db according to the allocation result */
 	if (rc == 0 && bac->bac_status == M0_BALLOC_AC_FOUND) {
@@ -25,6 +25,7 @@
 #ifndef __MOTR_BALLOC_BALLOC_H__
 #define __MOTR_BALLOC_BALLOC_H__
 
+#include "lib/avl.h"
 #include "lib/ext.h"
 #include "lib/types.h"
 #include "lib/list.h"
@@ -128,23 +129,41 @@ enum m0_balloc_allocation_flag {
 	M0_BALLOC_NORMAL_ZONE             = 1 << 13,
 };
 
+/** Orderings of the in-memory free extents of a zone. */
+enum m0_lext_index {
+	/** By extent start. Used to find the extent containing a block. */
+	M0_LEXT_BY_START,
+	/** By extent length, then by start. Used for best-fit lookups. */
+	M0_LEXT_BY_LEN,
+	M0_LEXT_INDEX_NR
+};
+
 struct m0_balloc_zone_param {
 	enum m0_balloc_allocation_flag  bzp_type;
 	struct m0_ext                   bzp_range;
 	m0_bcount_t                     bzp_freeblocks;
 	m0_bcount_t                     bzp_fragments;
 	m0_bcount_t                     bzp_maxchunk;
-	struct m0_list                  bzp_extents;
+	/**
+	 * Trees of free extents, indexed by m0_lext_index. Both trees hold
+	 * the same extents, so lookup by position and best-fit lookup by
+	 * length take O(log(bzp_fragments)).
+	 */
+	struct m0_avl                   bzp_extents[M0_LEXT_INDEX_NR];
 };
 
-/** Linked extents */
+/** Indexed free extent */
 struct m0_lext {
 	/** Is allocated separately from bgi_extents array? */
 	bool                le_is_alloc;
-	struct m0_list_link le_link;
+	/** Linkage to m0_balloc_zone_param::bzp_extents[], by index. */
+	struct m0_avl_link  le_link[M0_LEXT_INDEX_NR];
 	struct m0_ext       le_ext;
 };
 
+struct m0_balloc;
+struct m0_balloc_prefetch;
+
 /**
    In-memory data structure for group
  */
@@ -153,6 +172,8 @@ struct m0_balloc_group_info {
 	uint64_t                     bgi_state;
 	/** group number */
 	m0_bindex_t                  bgi_groupno;
+	/** balloc this group belongs to */
+	struct m0_balloc            *bgi_balloc;
 	struct m0_balloc_zone_param  bgi_normal;
 	struct m0_balloc_zone_param  bgi_spare;
 	/** Array of group extents */
@@ -211,6 +232,10 @@ enum m0_balloc_super_block_version {
 
 enum {
 	M0_BALLOC_BUDDY_LOOKUP_MAX = 10,
+	/** Threads loading group descriptors and free extents in parallel. */
+	M0_BALLOC_LOAD_THREADS_NR  = 8,
+	/** Groups queued to the loading threads at once. */
+	M0_BALLOC_LOAD_JOBS_NR     = 64,
 };
 
 /**
@@ -249,6 +274,8 @@ struct m0_balloc {
 	/** super block lock */
 	struct m0_be_mutex           cb_sb_mutex;
 	struct m0_be_seg            *cb_be_seg;
+	/** background loader of free extents, NULL when it is not running */
+	struct m0_balloc_prefetch   *cb_prefetch;
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 
 enum m0_balloc_format_version {
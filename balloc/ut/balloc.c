@@ -33,6 +33,8 @@
 #include "lib/memory.h"
 #include "lib/thread.h"
 #include "lib/getopts.h"
+#include "lib/atomic.h"   /* m0_atomic64 */
+#include "lib/finject.h" /* m0_fi_enable_off_n_on_m */
 #include "dtm/dtm.h"      /* m0_dtx */
 #include "motr/magic.h"
 #include "ut/ut.h"
@@ -88,6 +90,19 @@ bool balloc_ut_invariant(struct m0_balloc *motr_balloc,
 		prev_free_blocks;
 }
 
+/* Both indices of the zone hold the same single extent. */
+static bool zone_is_single(struct m0_balloc_zone_param *zp)
+{
+	struct m0_avl *start = &zp->bzp_extents[M0_LEXT_BY_START];
+	struct m0_avl *len   = &zp->bzp_extents[M0_LEXT_BY_LEN];
+
+	return zp->bzp_fragments == 1 &&
+	       container_of(start->a_root, struct m0_lext,
+			    le_link[M0_LEXT_BY_START]) ==
+	       container_of(len->a_root, struct m0_lext,
+			    le_link[M0_LEXT_BY_LEN]);
+}
+
 /**
  * Verifies balloc operations.
  *
@@ -251,6 +266,11 @@ int test_balloc_ut_ops(struct m0_be_ut_backend *ut_be, struct m0_be_seg *seg,
 			M0_UT_ASSERT(grp->bgi_normal.bzp_freeblocks ==
 				     motr_balloc->cb_sb.bsb_groupsize -
 				     spare_size);
+			/* everything is freed: one fragment in both indices */
+			M0_UT_ASSERT(grp->bgi_normal.bzp_fragments == 1);
+			M0_UT_ASSERT(grp->bgi_normal.bzp_maxchunk ==
+				     grp->bgi_normal.bzp_freeblocks);
+			M0_UT_ASSERT(zone_is_single(&grp->bgi_normal));
 			m0_balloc_release_extents(grp);
 			m0_balloc_unlock_group(grp);
 		}
@@ -299,6 +319,96 @@ void test_reserve_extent()
 	m0_be_ut_backend_fini(&ut_be);
 }
 
+static int balloc_ut_init(struct m0_balloc *bal, struct m0_be_seg *seg)
+{
+	return bal->cb_ballroom.ab_ops->bo_init(&bal->cb_ballroom, seg,
+			BALLOC_DEF_BLOCK_SHIFT, BALLOC_DEF_CONTAINER_SIZE,
+			BALLOC_DEF_BLOCKS_PER_GROUP,
+			m0_stob_ad_spares_calc(BALLOC_DEF_BLOCKS_PER_GROUP));
+}
+
+/* Formats a balloc on a new segment, the balloc is not initialised. */
+static void balloc_ut_format(struct m0_be_ut_backend *ut_be,
+			     struct m0_be_ut_seg     *ut_seg,
+			     struct m0_balloc       **bal)
+{
+	struct m0_sm_group *grp;
+	int                 rc;
+
+	M0_SET0(ut_be);
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(ut_seg, ut_be, 1ULL << 24);
+	grp = m0_be_ut_backend_sm_group_lookup(ut_be);
+	rc = m0_balloc_create(0, ut_seg->bus_seg, grp, bal,
+			      &M0_FID_INIT(0, 1));
+	M0_UT_ASSERT(rc == 0);
+	rc = balloc_ut_init(*bal, ut_seg->bus_seg);
+	M0_UT_ASSERT(rc == 0);
+	(*bal)->cb_ballroom.ab_ops->bo_fini(&(*bal)->cb_ballroom);
+}
+
+void test_load_fail()
+{
+	struct m0_be_ut_backend  ut_be;
+	struct m0_be_ut_seg      ut_seg;
+	struct m0_balloc        *bal;
+	int                      rc;
+
+	balloc_ut_format(&ut_be, &ut_seg, &bal);
+	M0_UT_ASSERT(bal->cb_sb.bsb_groupcount > M0_BALLOC_LOAD_JOBS_NR);
+	/* fail a group of the second batch */
+	m0_fi_enable_off_n_on_m("balloc_group_info_load_one", "fail",
+				M0_BALLOC_LOAD_JOBS_NR + 1, 1);
+	rc = balloc_ut_init(bal, ut_seg.bus_seg);
+	m0_fi_disable("balloc_group_info_load_one", "fail");
+	M0_UT_ASSERT(rc == -EIO);
+	M0_UT_ASSERT(bal->cb_group_info == NULL);
+	M0_UT_ASSERT(bal->cb_prefetch == NULL);
+
+	rc = balloc_ut_init(bal, ut_seg.bus_seg);
+	M0_UT_ASSERT(rc == 0);
+	bal->cb_ballroom.ab_ops->bo_fini(&bal->cb_ballroom);
+
+	m0_be_ut_seg_fini(&ut_seg);
+	m0_be_ut_backend_fini(&ut_be);
+}
+
+static bool balloc_ut_prefetch_count(void *data)
+{
+	m0_atomic64_inc(data);
+	return true;
+}
+
+void test_prefetch_cancel()
+{
+	struct m0_be_ut_backend  ut_be;
+	struct m0_be_ut_seg      ut_seg;
+	struct m0_balloc        *bal;
+	struct m0_atomic64       jobs;
+	m0_bcount_t              i;
+	int                      rc;
+
+	balloc_ut_format(&ut_be, &ut_seg, &bal);
+	M0_UT_ASSERT(bal->cb_sb.bsb_groupcount > M0_BALLOC_LOAD_JOBS_NR);
+	/* prefetch jobs wait for the stop before doing anything */
+	m0_atomic64_set(&jobs, 0);
+	m0_fi_enable_func("balloc_prefetch_one", "wait_stop",
+			  &balloc_ut_prefetch_count, &jobs);
+	rc = balloc_ut_init(bal, ut_seg.bus_seg);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(bal->cb_prefetch != NULL);
+	for (i = 0; i < bal->cb_sb.bsb_groupcount; ++i)
+		M0_UT_ASSERT(bal->cb_group_info[i].bgi_extents == NULL);
+	bal->cb_ballroom.ab_ops->bo_fini(&bal->cb_ballroom);
+	m0_fi_disable("balloc_prefetch_one", "wait_stop");
+	M0_UT_ASSERT(bal->cb_prefetch == NULL);
+	/* only the first batch ran, all its jobs were cancelled */
+	M0_UT_ASSERT(m0_atomic64_get(&jobs) == M0_BALLOC_LOAD_JOBS_NR);
+
+	m0_be_ut_seg_fini(&ut_seg);
+	m0_be_ut_backend_fini(&ut_be);
+}
+
 struct m0_ut_suite balloc_ut = {
         .ts_name  = "balloc-ut",
 	.ts_init = NULL,
@@ -306,6 +416,8 @@ struct m0_ut_suite balloc_ut = {
         .ts_tests = {
 		{ "balloc", test_balloc},
 		{ "reserve blocks for extmap", test_reserve_extent},
+		{ "group load failure", test_load_fail},
+		{ "prefetch cancel", test_prefetch_cancel},
 		{ NULL, NULL }
         }
 };
@@ -52,6 +52,14 @@ enum m0_avi_be_labels {
 	M0_AVI_BE_TX_ATTR_RA_PREP_TC_REG_SIZE,
 	M0_AVI_BE_TX_ATTR_RA_CAPT_TC_REG_NR,
 	M0_AVI_BE_TX_ATTR_RA_CAPT_TC_REG_SIZE,
+
+	/** Recovery: records, bytes, duration, MB/s. */
+	M0_AVI_BE_RECOVERY,
+	/**
+	 * Group controller decision: tx arrival interval, log write latency,
+	 * pd sync duration, transactions per group, group freeze timeout.
+	 */
+	M0_AVI_BE_GROUP_CTL,
 } M0_XCA_ENUM;
 
 /** @} end of be group */
@@ -31,6 +31,7 @@
 #include "lib/memory.h"         /* m0_addr_is_aligned */
 #include "lib/errno.h"          /* ENOSPC */
 #include "lib/misc.h"           /* memset, M0_BITS, m0_forall */
+#include "lib/locality.h"       /* m0_locality_here */
 #include "motr/magic.h"
 #include "be/domain.h"          /* m0_be_domain */
 
@@ -83,6 +84,21 @@
  * - they are calls to m0_be_alloc_aligned() and m0_be_free_aligned with
  *   M0_BE_ALLOC_SHIFT_MIN alignment shift.
  *
+ * Magazines
+ * - small allocations (up to M0_BE_ALLOC_MAG_STEP * M0_BE_ALLOC_MAG_CLASS_NR
+ *   bytes, M0_BE_ALLOC_SHIFT_MIN alignment shift, M0_BAP_NORMAL zone) are
+ *   rounded up to a multiple of M0_BE_ALLOC_MAG_STEP and served from
+ *   a magazine (m0_be_alloc_mag) of the current locality;
+ * - chunks in magazines are used chunks from the point of view of the rest of
+ *   the allocator. They are not in m0_be_fl and are never merged;
+ * - when a magazine is empty it is refilled with M0_BE_ALLOC_MAG_BATCH chunks
+ *   under the allocator lock;
+ * - a freed chunk which size is equal to a size class goes to the magazine of
+ *   the current locality if the magazine is not full;
+ * - magazines are stored in the allocator header and are updated in the same
+ *   transactions as the chunks, so nothing is lost on a crash;
+ * - magazines are drained in m0_be_allocator_destroy().
+ *
  * Allocator space invariants:
  * - Each byte of allocator space belongs to a chunk. There is one exception -
  *   if there is no space for chunk with at least 1 byte of user data from
@@ -167,10 +183,15 @@
  * - allocator credit includes 2 * size requested for alignment shift greater
  *   than M0_BE_ALLOC_SHIFT_MIN;
  * - it is not truly O(1) allocator; see m0_be_fl documentation for explanation;
- * - there is one big allocator lock that protects all allocations/deallocation.
+ * - there is one big allocator lock that protects all allocations/deallocation
+ *   which are not served by magazines;
+ * - chunks kept in magazines are accounted as used in m0_be_allocator_stats.
  *
  * Locks
- * Allocator lock (m0_mutex) is used to protect all allocator data.
+ * Allocator lock (m0_mutex) is used to protect all allocator data except
+ * magazines. Each set of magazines is protected by its own lock,
+ * m0_be_allocator::ba_mag_lock[]. Allocator lock is taken under magazine lock
+ * during refill and destroy.
  *
  * Space reservation for DIX recovery
  * ----------------------------------
@@ -716,6 +737,204 @@ static bool be_alloc_chunk_trymerge(struct m0_be_allocator *a,
 	return chunks_were_merged;
 }
 
+static void be_alloc_chunk_free(struct m0_be_allocator *a,
+				struct m0_be_tx *tx,
+				struct be_alloc_chunk *c)
+{
+	enum m0_be_alloc_zone_type  ztype = c->bac_zone;
+	struct be_alloc_chunk      *prev;
+	struct be_alloc_chunk      *next;
+	bool		            chunks_were_merged;
+
+	M0_PRE(m0_mutex_is_locked(&a->ba_lock));
+	M0_PRE(be_alloc_chunk_invariant(a, c));
+	M0_PRE(!c->bac_free);
+
+	be_alloc_chunk_mark_free(a, ztype, tx, c);
+	/* update stats before c->bac_size gets modified due to merge */
+	be_allocator_stats_update(&a->ba_h[ztype]->bah_stats,
+			c->bac_size, false, false);
+	prev = be_alloc_chunk_prev(a, ztype, c);
+	next = be_alloc_chunk_next(a, ztype, c);
+	chunks_were_merged = be_alloc_chunk_trymerge(a, ztype, tx,
+			prev, c);
+	if (chunks_were_merged)
+		c = prev;
+	be_alloc_chunk_trymerge(a, ztype, tx, c, next);
+	be_allocator_stats_capture(a, ztype, tx);
+
+	M0_POST(c->bac_free);
+	M0_POST(c->bac_size > 0);
+	M0_POST(be_alloc_chunk_invariant(a, c));
+}
+
+static bool be_alloc_mag_is_cached(m0_bcount_t size, unsigned shift,
+				   uint64_t zonemask)
+{
+	return shift == M0_BE_ALLOC_SHIFT_MIN &&
+	       zonemask == M0_BITS(M0_BAP_NORMAL) &&
+	       size <= M0_BE_ALLOC_MAG_STEP * M0_BE_ALLOC_MAG_CLASS_NR;
+}
+
+/** Size class of an allocation of the given size. */
+static unsigned be_alloc_mag_class(m0_bcount_t size)
+{
+	return size == 0 ? 0 : (size - 1) / M0_BE_ALLOC_MAG_STEP;
+}
+
+static m0_bcount_t be_alloc_mag_class_size(unsigned cls)
+{
+	M0_PRE(cls < M0_BE_ALLOC_MAG_CLASS_NR);
+	return (cls + 1) * M0_BE_ALLOC_MAG_STEP;
+}
+
+/** Set of magazines to be used by the current thread. */
+static unsigned be_alloc_mag_set(void)
+{
+	return m0_locality_here()->lo_idx % M0_BE_ALLOC_MAG_LOC_NR;
+}
+
+static struct m0_be_alloc_mag *be_alloc_mag(struct m0_be_allocator *a,
+					    unsigned set, unsigned cls)
+{
+	M0_PRE(set < M0_BE_ALLOC_MAG_LOC_NR);
+	M0_PRE(cls < M0_BE_ALLOC_MAG_CLASS_NR);
+	return &a->ba_h[M0_BAP_NORMAL]->bah_mag[set * M0_BE_ALLOC_MAG_CLASS_NR +
+						 cls];
+}
+
+static void be_alloc_mag_capture(struct m0_be_allocator *a,
+				 struct m0_be_tx *tx,
+				 struct m0_be_alloc_mag *mag)
+{
+	if (tx != NULL)
+		M0_BE_TX_CAPTURE_PTR(a->ba_seg, tx, mag);
+}
+
+/**
+ * Moves up to M0_BE_ALLOC_MAG_BATCH chunks of the size class of the magazine
+ * from M0_BAP_NORMAL zone to the magazine. The caller captures the magazine.
+ */
+static void be_alloc_mag_refill(struct m0_be_allocator *a,
+				struct m0_be_tx *tx,
+				struct m0_be_alloc_mag *mag,
+				m0_bcount_t size)
+{
+	struct m0_be_allocator_header *h = a->ba_h[M0_BAP_NORMAL];
+	struct be_alloc_chunk         *c;
+	int                            i;
+
+	M0_PRE(mag->bam_nr == 0);
+
+	m0_mutex_lock(&a->ba_lock);
+	M0_PRE_EX(m0_be_allocator__invariant(a));
+	for (i = 0; i < M0_BE_ALLOC_MAG_BATCH; ++i) {
+		c = m0_be_fl_pick(&h->bah_fl, size);
+		if (c == NULL)
+			break;
+		c = be_alloc_chunk_trysplit(a, M0_BAP_NORMAL, tx, c, size,
+					    M0_BE_ALLOC_SHIFT_MIN);
+		M0_ASSERT(c != NULL);
+		be_allocator_stats_update(&h->bah_stats, c->bac_size,
+					  true, false);
+		mag->bam_chunk[mag->bam_nr++] = (uint64_t)c;
+	}
+	if (mag->bam_nr > 0)
+		be_allocator_stats_capture(a, M0_BAP_NORMAL, tx);
+	M0_POST_EX(m0_be_allocator__invariant(a));
+	m0_mutex_unlock(&a->ba_lock);
+}
+
+/**
+ * Takes a chunk for an allocation of the given size from the magazine of the
+ * current locality, refilling the magazine if it is empty.
+ *
+ * Returns NULL if there is no space in the zone for the size class.
+ */
+static struct be_alloc_chunk *be_alloc_mag_get(struct m0_be_allocator *a,
+					       struct m0_be_tx *tx,
+					       m0_bcount_t size)
+{
+	struct m0_be_alloc_mag *mag;
+	struct be_alloc_chunk  *c = NULL;
+	unsigned                set = be_alloc_mag_set();
+	unsigned                cls = be_alloc_mag_class(size);
+
+	mag = be_alloc_mag(a, set, cls);
+	m0_mutex_lock(&a->ba_mag_lock[set]);
+	if (mag->bam_nr == 0) {
+		m0_atomic64_inc(&a->ba_mag_miss);
+		be_alloc_mag_refill(a, tx, mag, be_alloc_mag_class_size(cls));
+	} else {
+		m0_atomic64_inc(&a->ba_mag_hit);
+	}
+	if (mag->bam_nr > 0) {
+		c = (struct be_alloc_chunk *)mag->bam_chunk[--mag->bam_nr];
+		be_alloc_mag_capture(a, tx, mag);
+	}
+	m0_mutex_unlock(&a->ba_mag_lock[set]);
+
+	M0_POST(ergo(c != NULL, !c->bac_free && c->bac_size >= size &&
+				c->bac_zone == M0_BAP_NORMAL));
+	return c;
+}
+
+/**
+ * Puts a used chunk to the magazine of the current locality.
+ *
+ * Returns false if the chunk is not cached or the magazine is full. The chunk
+ * should be freed in the usual way in this case.
+ */
+static bool be_alloc_mag_put(struct m0_be_allocator *a,
+			     struct m0_be_tx *tx,
+			     struct be_alloc_chunk *c)
+{
+	struct m0_be_alloc_mag *mag;
+	unsigned                set;
+	bool                    put;
+
+	M0_PRE(!c->bac_free);
+
+	if (c->bac_zone != M0_BAP_NORMAL || c->bac_size == 0 ||
+	    c->bac_size % M0_BE_ALLOC_MAG_STEP != 0 ||
+	    c->bac_size > M0_BE_ALLOC_MAG_STEP * M0_BE_ALLOC_MAG_CLASS_NR)
+		return false;
+
+	set = be_alloc_mag_set();
+	mag = be_alloc_mag(a, set, be_alloc_mag_class(c->bac_size));
+	m0_mutex_lock(&a->ba_mag_lock[set]);
+	put = mag->bam_nr < M0_BE_ALLOC_MAG_SIZE;
+	if (put) {
+		mag->bam_chunk[mag->bam_nr++] = (uint64_t)c;
+		be_alloc_mag_capture(a, tx, mag);
+	}
+	m0_mutex_unlock(&a->ba_mag_lock[set]);
+	return put;
+}
+
+/** Returns all cached chunks to M0_BAP_NORMAL zone. */
+static void be_alloc_mag_drain(struct m0_be_allocator *a,
+			       struct m0_be_tx *tx)
+{
+	struct m0_be_alloc_mag *mag;
+	int                     i;
+	int                     j;
+
+	M0_PRE(m0_mutex_is_locked(&a->ba_lock));
+
+	for (i = 0; i < M0_BE_ALLOC_MAG_NR; ++i) {
+		mag = &a->ba_h[M0_BAP_NORMAL]->bah_mag[i];
+		if (mag->bam_nr == 0)
+			continue;
+		for (j = 0; j < mag->bam_nr; ++j) {
+			be_alloc_chunk_free(a, tx, (struct be_alloc_chunk *)
+					    mag->bam_chunk[j]);
+		}
+		mag->bam_nr = 0;
+		be_alloc_mag_capture(a, tx, mag);
+	}
+}
+
 M0_INTERNAL int m0_be_allocator_init(struct m0_be_allocator *a,
 				     struct m0_be_seg *seg)
 {
@@ -730,6 +949,11 @@ M0_INTERNAL int m0_be_allocator_init(struct m0_be_allocator *a,
 	/* See comment in m0_be_btree_init(). */
 	M0_SET0(&a->ba_lock);
 	m0_mutex_init(&a->ba_lock);
+	M0_SET_ARR0(a->ba_mag_lock);
+	for (i = 0; i < ARRAY_SIZE(a->ba_mag_lock); ++i)
+		m0_mutex_init(&a->ba_mag_lock[i]);
+	m0_atomic64_set(&a->ba_mag_hit, 0);
+	m0_atomic64_set(&a->ba_mag_miss, 0);
 
 	a->ba_seg = seg;
 	seg_hdr = (struct m0_be_seg_hdr *)seg->bs_addr;
@@ -750,6 +974,8 @@ M0_INTERNAL void m0_be_allocator_fini(struct m0_be_allocator *a)
 
 	for (i = 0; i < M0_BAP_NR; ++i)
 		be_allocator_stats_print(&a->ba_h[i]->bah_stats);
+	for (i = 0; i < ARRAY_SIZE(a->ba_mag_lock); ++i)
+		m0_mutex_fini(&a->ba_mag_lock[i]);
 	m0_mutex_fini(&a->ba_lock);
 
 	M0_LEAVE();
@@ -788,6 +1014,10 @@ static int be_allocator_header_create(struct m0_be_allocator     *a,
 	m0_be_fl_create(&h->bah_fl, tx, a->ba_seg);
 	be_allocator_stats_init(&h->bah_stats, h);
 	be_allocator_stats_capture(a, ztype, tx);
+	M0_SET_ARR0(h->bah_mag);
+	if (tx != NULL)
+		M0_BE_TX_CAPTURE_ARR(a->ba_seg, tx, h->bah_mag,
+				     ARRAY_SIZE(h->bah_mag));
 
 	/* init main chunk */
 	if (size != 0) {
@@ -883,17 +1113,23 @@ M0_INTERNAL int m0_be_allocator_create(struct m0_be_allocator *a,
 M0_INTERNAL void m0_be_allocator_destroy(struct m0_be_allocator *a,
 					 struct m0_be_tx *tx)
 {
+	int i;
 	int z;
 
 	M0_ENTRY("a=%p tx=%p", a, tx);
 
+	for (i = 0; i < ARRAY_SIZE(a->ba_mag_lock); ++i)
+		m0_mutex_lock(&a->ba_mag_lock[i]);
 	m0_mutex_lock(&a->ba_lock);
 	M0_PRE_EX(m0_be_allocator__invariant(a));
 
+	be_alloc_mag_drain(a, tx);
 	for (z = 0; z < M0_BAP_NR; ++z)
 		be_allocator_header_destroy(a, z, tx);
 
 	m0_mutex_unlock(&a->ba_lock);
+	for (i = 0; i < ARRAY_SIZE(a->ba_mag_lock); ++i)
+		m0_mutex_unlock(&a->ba_mag_lock[i]);
 	M0_LEAVE();
 }
 
@@ -924,6 +1160,8 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 	struct m0_be_tx_credit         cred_free_flag;
 	struct m0_be_tx_credit         cred_chunk_size;
 	struct m0_be_tx_credit         stats_credit;
+	struct m0_be_tx_credit         cred_free = {};
+	struct m0_be_tx_credit         cred_mag;
 	struct m0_be_tx_credit         tmp;
 	struct be_alloc_chunk          chunk;
 
@@ -931,6 +1169,7 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 	cred_free_flag  = M0_BE_TX_CREDIT_PTR(&chunk.bac_free);
 	cred_chunk_size = M0_BE_TX_CREDIT_PTR(&chunk.bac_size);
 	stats_credit    = M0_BE_TX_CREDIT_PTR(&h->bah_stats);
+	cred_mag        = M0_BE_TX_CREDIT_TYPE(struct m0_be_alloc_mag);
 
 	m0_be_tx_credit_add(&cred_allocator,
 			    &M0_BE_TX_CREDIT_PTR(&h->bah_size));
@@ -974,6 +1213,10 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 	m0_be_tx_credit_add(&cred_mark_free, &cred_free_flag);
 	m0_be_fl_credit(&h->bah_fl, M0_BFL_ADD, &cred_mark_free);
 
+	m0_be_tx_credit_add(&cred_free, &cred_mark_free);
+	m0_be_tx_credit_mac(&cred_free, &chunk_trymerge_credit, 2);
+	m0_be_tx_credit_add(&cred_free, &stats_credit);
+
 	switch (optype) {
 		case M0_BAO_CREATE:
 			tmp = M0_BE_TX_CREDIT(0, 0);
@@ -982,6 +1225,8 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 			m0_be_tx_credit_add(&tmp, &chunk_add_after_credit);
 			m0_be_tx_credit_add(&tmp, &cred_allocator);
 			m0_be_tx_credit_add(&tmp, &stats_credit);
+			m0_be_tx_credit_add(&tmp,
+					    &M0_BE_TX_CREDIT_PTR(&h->bah_mag));
 			m0_be_tx_credit_mac(accum, &tmp, M0_BAP_NR);
 			break;
 		case M0_BAO_DESTROY:
@@ -990,20 +1235,33 @@ M0_INTERNAL void m0_be_allocator_credit(struct m0_be_allocator *a,
 			m0_be_tx_credit_add(&tmp, &chunk_del_fini_credit);
 			m0_be_tx_credit_mac(&tmp, &cred_list_destroy, 2);
 			m0_be_tx_credit_mac(accum, &tmp, M0_BAP_NR);
+			/* drain magazines */
+			m0_be_tx_credit_mac(accum, &cred_free,
+					    M0_BE_ALLOC_MAG_NR *
+					    M0_BE_ALLOC_MAG_SIZE);
+			m0_be_tx_credit_mac(accum, &cred_mag,
+					    M0_BE_ALLOC_MAG_NR);
 			break;
 		case M0_BAO_ALLOC_ALIGNED:
 			m0_be_tx_credit_add(accum, &cred_split);
 			m0_be_tx_credit_add(accum, &mem_zero_credit);
 			m0_be_tx_credit_add(accum, &stats_credit);
+			/* zonemask is unknown here, assume M0_BAP_NORMAL */
+			if (be_alloc_mag_is_cached(size, shift,
+						   M0_BITS(M0_BAP_NORMAL))) {
+				/* magazine refill */
+				m0_be_tx_credit_mac(accum, &cred_split,
+						    M0_BE_ALLOC_MAG_BATCH - 1);
+				m0_be_tx_credit_add(accum, &cred_mag);
+			}
 			break;
 		case M0_BAO_ALLOC:
 			m0_be_allocator_credit(a, M0_BAO_ALLOC_ALIGNED, size,
 					       M0_BE_ALLOC_SHIFT_MIN, accum);
 			break;
 		case M0_BAO_FREE_ALIGNED:
-			m0_be_tx_credit_add(accum, &cred_mark_free);
-			m0_be_tx_credit_mac(accum, &chunk_trymerge_credit, 2);
-			m0_be_tx_credit_add(accum, &stats_credit);
+			m0_be_tx_credit_add(accum, &cred_free);
+			m0_be_tx_credit_add(accum, &cred_mag);
 			break;
 		case M0_BAO_FREE:
 			m0_be_allocator_credit(a, M0_BAO_FREE_ALIGNED, size,
@@ -1036,6 +1294,22 @@ M0_INTERNAL void m0_be_alloc_aligned(struct m0_be_allocator *a,
 
 	m0_be_op_active(op);
 
+	if (be_alloc_mag_is_cached(size, shift, zonemask)) {
+		c = be_alloc_mag_get(a, tx, size);
+		if (c != NULL) {
+			memset(&c->bac_mem, 0, size);
+			m0_be_tx_capture(tx, &M0_BE_REG(a->ba_seg, size,
+							&c->bac_mem));
+			*ptr = &c->bac_mem;
+			M0_LOG(M0_DEBUG, "allocator=%p size=%"PRIu64" c=%p "
+			       "c->bac_size=%"PRIu64" ptr=%p (magazine)",
+			       a, size, c, c->bac_size, *ptr);
+			m0_be_op_done(op);
+			return;
+		}
+		/* no space for the size class, try the exact size */
+	}
+
 	m0_mutex_lock(&a->ba_lock);
 	M0_PRE_EX(m0_be_allocator__invariant(a));
 
@@ -1103,11 +1377,7 @@ M0_INTERNAL void m0_be_free_aligned(struct m0_be_allocator *a,
 				    struct m0_be_op *op,
 				    void *ptr)
 {
-	enum m0_be_alloc_zone_type  ztype;
-	struct be_alloc_chunk      *c;
-	struct be_alloc_chunk      *prev;
-	struct be_alloc_chunk      *next;
-	bool		            chunks_were_merged;
+	struct be_alloc_chunk *c;
 
 	M0_PRE(ptr != NULL);
 	M0_PRE(m0_reduce(z, M0_BAP_NR, 0,
@@ -1115,32 +1385,18 @@ M0_INTERNAL void m0_be_free_aligned(struct m0_be_allocator *a,
 
 	m0_be_op_active(op);
 
-	m0_mutex_lock(&a->ba_lock);
-	M0_PRE_EX(m0_be_allocator__invariant(a));
-
 	c = be_alloc_chunk_addr(ptr);
-	M0_PRE(be_alloc_chunk_invariant(a, c));
-	M0_PRE(!c->bac_free);
-	ztype = c->bac_zone;
 	M0_LOG(M0_DEBUG, "allocator=%p c=%p c->bac_size=%" PRIu64 " zone=%d "
 			"data=%p", a, c, c->bac_size, c->bac_zone, &c->bac_mem);
-	/* algorithm starts here */
-	be_alloc_chunk_mark_free(a, ztype, tx, c);
-	/* update stats before c->bac_size gets modified due to merge */
-	be_allocator_stats_update(&a->ba_h[ztype]->bah_stats,
-			c->bac_size, false, false);
-	prev = be_alloc_chunk_prev(a, ztype, c);
-	next = be_alloc_chunk_next(a, ztype, c);
-	chunks_were_merged = be_alloc_chunk_trymerge(a, ztype, tx,
-			prev, c);
-	if (chunks_were_merged)
-		c = prev;
-	be_alloc_chunk_trymerge(a, ztype, tx, c, next);
-	be_allocator_stats_capture(a, ztype, tx);
-	/* and ends here */
-	M0_POST(c->bac_free);
-	M0_POST(c->bac_size > 0);
-	M0_POST(be_alloc_chunk_invariant(a, c));
+	if (be_alloc_mag_put(a, tx, c)) {
+		m0_be_op_done(op);
+		return;
+	}
+
+	m0_mutex_lock(&a->ba_lock);
+	M0_PRE_EX(m0_be_allocator__invariant(a));
+
+	be_alloc_chunk_free(a, tx, c);
 
 	M0_POST_EX(m0_be_allocator__invariant(a));
 	m0_mutex_unlock(&a->ba_lock);
@@ -1165,6 +1421,13 @@ M0_INTERNAL void m0_be_alloc_stats(struct m0_be_allocator *a,
 	m0_mutex_unlock(&a->ba_lock);
 }
 
+M0_INTERNAL void m0_be_alloc_mag_stats(struct m0_be_allocator *a,
+				       struct m0_be_allocator_mag_stats *out)
+{
+	out->bms_hit  = m0_atomic64_get(&a->ba_mag_hit);
+	out->bms_miss = m0_atomic64_get(&a->ba_mag_miss);
+}
+
 M0_INTERNAL void m0_be_alloc_stats_credit(struct m0_be_allocator *a,
                                           struct m0_be_tx_credit *accum)
 {
@@ -26,6 +26,7 @@
 
 #include "lib/types.h"  /* m0_bcount_t */
 #include "lib/mutex.h"
+#include "lib/atomic.h" /* m0_atomic64 */
 
 struct m0_be_op;
 struct m0_be_seg;
@@ -47,6 +48,25 @@ enum {
 	M0_BE_ALLOC_SHIFT_MIN  = 3,
 };
 
+enum {
+	/**
+	 * Number of sets of magazines. Locality i uses set
+	 * i % M0_BE_ALLOC_MAG_LOC_NR.
+	 */
+	M0_BE_ALLOC_MAG_LOC_NR   = 8,
+	/** Size classes cached in magazines are multiples of this. */
+	M0_BE_ALLOC_MAG_STEP     = 64,
+	/** Number of size classes, the largest cached size is 512 bytes. */
+	M0_BE_ALLOC_MAG_CLASS_NR = 8,
+	/** Number of chunks a magazine can hold. */
+	M0_BE_ALLOC_MAG_SIZE     = 8,
+	/** Number of chunks taken from the zone when a magazine is empty. */
+	M0_BE_ALLOC_MAG_BATCH    = 4,
+	/** Total number of magazines in an allocator header. */
+	M0_BE_ALLOC_MAG_NR       = M0_BE_ALLOC_MAG_LOC_NR *
+				   M0_BE_ALLOC_MAG_CLASS_NR,
+};
+
 struct m0_be_allocator_call_stat {
 	unsigned long bcs_nr;
 	m0_bcount_t   bcs_size;
@@ -126,6 +146,17 @@ struct m0_be_allocator_stats {
 	unsigned long                     bas_print_index;
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 
+/**
+ * Magazine statistics. They are not persistent and are counted from
+ * m0_be_allocator_init().
+ */
+struct m0_be_allocator_mag_stats {
+	/** Allocations served from a magazine. */
+	uint64_t bms_hit;
+	/** Allocations of cached sizes which found their magazine empty. */
+	uint64_t bms_miss;
+};
+
 struct m0_be_allocator_header;
 
 /** @brief Allocator */
@@ -143,6 +174,13 @@ struct m0_be_allocator {
 	struct m0_mutex		       ba_lock;
 	/** Internal allocator data. It is stored inside the segment. */
 	struct m0_be_allocator_header *ba_h[M0_BAP_NR];
+	/**
+	 * Locks of magazine sets, m0_be_allocator_header::bah_mag. Allocator
+	 * lock can be taken under these locks, but not vice versa.
+	 */
+	struct m0_mutex		       ba_mag_lock[M0_BE_ALLOC_MAG_LOC_NR];
+	struct m0_atomic64	       ba_mag_hit;
+	struct m0_atomic64	       ba_mag_miss;
 };
 
 /**
@@ -299,14 +337,19 @@ M0_INTERNAL void m0_be_free(struct m0_be_allocator *a,
 			    struct m0_be_op *op,
 			    void *ptr);
 /**
- * Return allocator statistics.
+ * Return allocator statistics of M0_BAP_NORMAL zone.
+ *
+ * Chunks held in magazines are accounted as used.
  *
- * @note Not implemented yet.
  * @see m0_be_allocator_stats.
  */
 M0_INTERNAL void m0_be_alloc_stats(struct m0_be_allocator *a,
 				   struct m0_be_allocator_stats *out);
 
+/** Return magazine statistics, @see m0_be_allocator_mag_stats. */
+M0_INTERNAL void m0_be_alloc_mag_stats(struct m0_be_allocator *a,
+				       struct m0_be_allocator_mag_stats *out);
+
 M0_INTERNAL void m0_be_alloc_stats_credit(struct m0_be_allocator *a,
                                           struct m0_be_tx_credit *accum);
 M0_INTERNAL void m0_be_alloc_stats_capture(struct m0_be_allocator *a,
@@ -94,6 +94,21 @@ struct m0_be_alloc_zone {
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 
 
+/**
+ * @brief Magazine: chunks of a single size class kept aside for a locality.
+ *
+ * Chunks in a magazine are marked used and are not in free lists, so they are
+ * handed out and taken back under m0_be_allocator::ba_mag_lock only, without
+ * the allocator lock. Magazines are persistent and are updated in the same
+ * transactions as the chunks, so cached chunks survive restarts.
+ */
+struct m0_be_alloc_mag {
+	/** Number of chunks in the magazine. */
+	uint64_t bam_nr;
+	/** Addresses of the chunks (struct be_alloc_chunk). */
+	uint64_t bam_chunk[M0_BE_ALLOC_MAG_SIZE];
+} M0_XCA_RECORD M0_XCA_DOMAIN(be);
+
 /**
  * @brief Allocator header.
  *
@@ -109,6 +124,11 @@ struct m0_be_allocator_header {
 	struct m0_be_allocator_stats  bah_stats;	/**< XXX not used now */
 	m0_bcount_t                   bah_size;		/**< memory size */
 	void			     *bah_addr;		/**< memory address */
+	/**
+	 * Magazines, M0_BE_ALLOC_MAG_CLASS_NR per set. Used in M0_BAP_NORMAL
+	 * zone only.
+	 */
+	struct m0_be_alloc_mag        bah_mag[M0_BE_ALLOC_MAG_NR];
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 
 /** @} end of be group */
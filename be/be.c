@@ -133,7 +133,7 @@
  *     we don't;
  *   - (-) fix t_fdmi_*;
  * - m0_be_reg_area, m0_be_reg_map, m0_be_reg_d_tree
- *   - (-) m0_be_reg_d_tree implementation using a tree structure;
+ *   - (+) m0_be_reg_d_tree implementation using a tree structure;
  *   - (-) optimisation for memset()-like captures;
  * - m0_be_reg_area_merger
  *   - (-) non-copying implementation;
@@ -32,11 +32,17 @@
 #include "lib/errno.h"
 #include "lib/finject.h"       /* M0_FI_ENABLED() */
 #include "lib/misc.h"          /* offsetof */
+#include "lib/hash.h"          /* m0_hash */
+#include "lib/rwlock.h"        /* m0_rwlock */
+#include "lib/memory.h"        /* m0_alloc */
 #include "be/alloc.h"
 #include "be/btree.h"
 #include "be/btree_internal.h" /* m0_be_bnode */
 #include "be/seg.h"
 #include "be/tx.h"             /* m0_be_tx_capture */
+#ifndef __KERNEL__
+#include "be/tx_bulk.h"        /* m0_be_tx_bulk */
+#endif
 
 /* btree constants */
 enum {
@@ -54,6 +60,8 @@ struct btree_node_pos {
 	unsigned int        bnp_index;
 };
 
+struct btree_latch_path;
+
 M0_INTERNAL const struct m0_fid_type m0_btree_fid_type = {
 	.ft_id   = 'b',
 	.ft_name = "btree fid",
@@ -63,7 +71,8 @@ static struct m0_be_op__btree *op_tree(struct m0_be_op *op);
 static struct m0_rwlock *btree_rwlock(struct m0_be_btree *tree);
 
 static struct be_btree_key_val *be_btree_search(struct m0_be_btree *btree,
-						void *key);
+						void *key,
+						struct btree_latch_path *path);
 
 static void btree_root_set(struct m0_be_btree *btree,
 			   struct m0_be_bnode *new_root)
@@ -183,7 +192,291 @@ static inline int key_eq(const struct m0_be_btree *btree,
 {
 	return be_btree_compare(btree, key0, key1) ==  0;
 }
+
+/* ------------------------------------------------------------------
+ * Node format
+ * ------------------------------------------------------------------ */
+
+/**
+ * Returns the size of the key slots in a M0_BE_BNODE_FORMAT_VERSION_2 node
+ * or 0 for a version 1 node.
+ */
+static m0_bcount_t node_ksize(const struct m0_be_bnode *node)
+{
+	struct m0_format_tag tag;
+
+	m0_format_header_unpack(&tag, &node->bt_header);
+	return tag.ot_version == M0_BE_BNODE_FORMAT_VERSION_2 ?
+		node->bt_ksize : 0;
+}
+
+/** Size of the node memory for key slots of @ksize bytes. */
+static m0_bcount_t node_size(m0_bcount_t ksize)
+{
+	return sizeof(struct m0_be_bnode) +
+		(ksize == 0 ? 0 :
+		 KV_NR * ksize + sizeof(struct m0_format_footer));
+}
+
+/** Size of key slots in new nodes of @btree, 0 for version 1 trees. */
+static m0_bcount_t btree_ksize(const struct m0_be_btree *btree)
+{
+	struct m0_format_tag tag;
+
+	m0_format_header_unpack(&tag, &btree->bb_header);
+	return tag.ot_version == M0_BE_BTREE_FORMAT_VERSION_2 ?
+		m0_align(btree->bb_ops->ko_inline_ksize, sizeof(void *)) : 0;
+}
+
+/**
+ * Upper estimate of btree_ksize() for credit calculations, which can be done
+ * before the tree is created.
+ */
+static m0_bcount_t btree_ksize_max(const struct m0_be_btree *btree)
+{
+	return btree->bb_ops == NULL ? 0 :
+		m0_align(btree->bb_ops->ko_inline_ksize, sizeof(void *));
+}
+
+static struct m0_format_footer *node_footer(const struct m0_be_bnode *node)
+{
+	struct m0_format_tag tag;
+
+	m0_format_header_unpack(&tag, &node->bt_header);
+	return (void *)node + tag.ot_footer_offset;
+}
+
+/**
+ * Returns the i-th key of the node. The key is in the node itself for
+ * version 2 nodes.
+ */
+static void *node_key(const struct m0_be_bnode *node, unsigned int i)
+{
+	m0_bcount_t ksize = node_ksize(node);
+
+	return ksize == 0 ? node->bt_kv_arr[i].btree_key :
+		(void *)(node + 1) + i * ksize;
+}
+
+/** Sets i-th key-value of the @node to @kv. */
+static void node_kv_set(struct m0_be_bnode            *node,
+			unsigned int                   i,
+			const struct be_btree_key_val *kv)
+{
+	m0_bcount_t ksize = node_ksize(node);
+
+	node->bt_kv_arr[i] = *kv;
+	if (ksize != 0)
+		memcpy(node_key(node, i), kv->btree_key, ksize);
+}
+
+/** Copies @si-th key-value of @src to @di-th key-value of @dst. */
+static void node_kv_copy(struct m0_be_bnode       *dst,
+			 unsigned int              di,
+			 const struct m0_be_bnode *src,
+			 unsigned int              si)
+{
+	m0_bcount_t ksize = node_ksize(dst);
+
+	M0_PRE(node_ksize(src) == ksize);
+	dst->bt_kv_arr[di] = src->bt_kv_arr[si];
+	if (ksize != 0)
+		memmove(node_key(dst, di), node_key(src, si), ksize);
+}
+
+static void node_kv_swap(struct m0_be_bnode *n0, unsigned int i0,
+			 struct m0_be_bnode *n1, unsigned int i1)
+{
+	m0_bcount_t ksize = node_ksize(n0);
+	char        tmp[BTREE_INLINE_KEY_MAX];
+
+	M0_PRE(node_ksize(n1) == ksize);
+	M0_SWAP(n0->bt_kv_arr[i0], n1->bt_kv_arr[i1]);
+	if (ksize != 0) {
+		memcpy(tmp, node_key(n0, i0), ksize);
+		memcpy(node_key(n0, i0), node_key(n1, i1), ksize);
+		memcpy(node_key(n1, i1), tmp, ksize);
+	}
+}
+
+/* ------------------------------------------------------------------
+ * Node search
+ * ------------------------------------------------------------------ */
+
+/**
+ * Branch-free lower bound search over @nr sorted uint64_t keys.
+ *
+ * Halves the range on each step without a conditional jump, so that the
+ * search does not suffer from branch mispredictions.
+ */
+static unsigned int u64_lower_bound(const uint64_t *keys, unsigned int nr,
+				    uint64_t key)
+{
+	const uint64_t *base = keys;
+	unsigned int    half;
+
+	if (nr == 0)
+		return 0;
+	while (nr > 1) {
+		half = nr / 2;
+		base += (base[half] < key) * half;
+		nr -= half;
+	}
+	return base - keys + (*base < key);
+}
+
+static inline unsigned int u128_lt(const uint64_t *k, uint64_t hi, uint64_t lo)
+{
+	return (k[0] < hi) | ((k[0] == hi) & (k[1] < lo));
+}
+
+/** The same as u64_lower_bound() for pairs of uint64_t. */
+static unsigned int u128_lower_bound(const uint64_t *keys, unsigned int nr,
+				     uint64_t hi, uint64_t lo)
+{
+	const uint64_t *base = keys;
+	unsigned int    half;
+
+	if (nr == 0)
+		return 0;
+	while (nr > 1) {
+		half = nr / 2;
+		base += u128_lt(base + 2 * half, hi, lo) * 2 * half;
+		nr -= half;
+	}
+	return (base - keys) / 2 + u128_lt(base, hi, lo);
+}
+
+/**
+ * Returns the index of the first key in @node which is not less than @key.
+ *
+ * Inline keys of trees with m0_be_btree_kv_ops::ko_flags set are searched
+ * directly, other keys are compared with ko_compare() one by one.
+ */
+static unsigned int node_search(const struct m0_be_btree *btree,
+				const struct m0_be_bnode *node,
+				const void               *key)
+{
+	uint64_t     flags = btree->bb_ops->ko_flags;
+	unsigned int nr = node->bt_num_active_key;
+	unsigned int i;
+	uint64_t     k[2];
+
+	if (flags != 0 && node_ksize(node) != 0) {
+		memcpy(k, key, btree->bb_ops->ko_inline_ksize);
+		if (flags & M0_BKF_U64)
+			return u64_lower_bound(node_key(node, 0), nr, k[0]);
+		if (flags & M0_BKF_U128)
+			return u128_lower_bound(node_key(node, 0), nr,
+						k[0], k[1]);
+	}
+	for (i = 0; i < nr && key_gt(btree, key, node_key(node, i)); ++i)
+		;
+	return i;
+}
+
+/** Returns true iff i-th key of @node equals to @key. */
+static bool node_key_eq(const struct m0_be_btree *btree,
+			const struct m0_be_bnode *node,
+			unsigned int              i,
+			const void               *key)
+{
+	return i < node->bt_num_active_key &&
+		(btree->bb_ops->ko_flags != 0 && node_ksize(node) != 0 ?
+		 memcmp(node_key(node, i), key,
+			btree->bb_ops->ko_inline_ksize) == 0 :
+		 key_eq(btree, key, node_key(node, i)));
+}
 
+/* ------------------------------------------------------------------
+ * Node latching
+ * ------------------------------------------------------------------ */
+
+/**
+ * Node latches.
+ *
+ * m0_be_btree::bb_lock is taken in shared mode by lookups, cursors and plain
+ * inserts, which then synchronise on per-node latches: readers latch nodes in
+ * read mode on their way from the root down, inserters use latch coupling in
+ * write mode, releasing the parent as soon as the child is known not to need
+ * a split. Everything that frees nodes, moves the root or holds an anchor for
+ * update takes bb_lock exclusively and does not latch at all.
+ *
+ * Nodes live in segment memory and have no room for volatile state, so latches
+ * are kept in a static table indexed by the node level and a hash of the node
+ * address. Node levels do not change while bb_lock is held in shared mode.
+ * Latches are always acquired from the root towards leaves and a thread holds
+ * at most one latch per level, so sharing of a latch by several nodes of the
+ * same level can produce false contention, but never a deadlock.
+ */
+enum {
+	BTREE_LATCH_NR = 128,
+};
+
+static struct m0_rwlock btree_latches[BTREE_HEIGHT_MAX + 1][BTREE_LATCH_NR];
+
+/** Nodes read-latched by a reader, one per level. */
+struct btree_latch_path {
+	int                 blp_nr;
+	struct m0_be_bnode *blp_node[BTREE_HEIGHT_MAX + 1];
+};
+
+static struct m0_rwlock *node_latch(const struct m0_be_bnode *node)
+{
+	M0_PRE(node->bt_level <= BTREE_HEIGHT_MAX);
+	return &btree_latches[node->bt_level]
+			     [m0_hash((uint64_t)node) % BTREE_LATCH_NR];
+}
+
+static void node_wlatch(const struct m0_be_bnode *node)
+{
+	m0_rwlock_write_lock(node_latch(node));
+}
+
+static void node_wunlatch(const struct m0_be_bnode *node)
+{
+	m0_rwlock_write_unlock(node_latch(node));
+}
+
+static void path_rlatch(struct btree_latch_path *path, struct m0_be_bnode *node)
+{
+	M0_PRE(path->blp_nr < ARRAY_SIZE(path->blp_node));
+	M0_PRE(ergo(path->blp_nr > 0,
+		    path->blp_node[path->blp_nr - 1]->bt_level >
+		    node->bt_level));
+	m0_rwlock_read_lock(node_latch(node));
+	path->blp_node[path->blp_nr++] = node;
+}
+
+static void path_runlatch(struct btree_latch_path *path)
+{
+	while (path->blp_nr > 0)
+		m0_rwlock_read_unlock(node_latch(path->blp_node[--path->blp_nr]));
+}
+
+M0_INTERNAL int m0_be_btree_mod_init(void)
+{
+	int i;
+	int j;
+
+	for (i = 0; i < ARRAY_SIZE(btree_latches); ++i) {
+		for (j = 0; j < ARRAY_SIZE(btree_latches[i]); ++j)
+			m0_rwlock_init(&btree_latches[i][j]);
+	}
+	return 0;
+}
+
+M0_INTERNAL void m0_be_btree_mod_fini(void)
+{
+	int i;
+	int j;
+
+	for (i = 0; i < ARRAY_SIZE(btree_latches); ++i) {
+		for (j = 0; j < ARRAY_SIZE(btree_latches[i]); ++j)
+			m0_rwlock_fini(&btree_latches[i][j]);
+	}
+}
+
 /* ------------------------------------------------------------------
  * Btree internals implementation
  * ------------------------------------------------------------------ */
@@ -206,7 +499,8 @@ static void btree_pair_release(struct m0_be_btree *btree,
 
 static struct btree_node_pos be_btree_get_btree_node(
 					struct m0_be_btree_cursor *it,
-					const void *key, bool slant);
+					const void *key, bool slant,
+					struct btree_latch_path *path);
 
 static void be_btree_delete_key_from_node(struct m0_be_btree *tree,
 					  struct m0_be_tx *tx,
@@ -251,6 +545,17 @@ static bool btree_backlink_invariant(const struct m0_be_btree_backlink *h,
 		_0C(h->bli_gen == seg->bs_gen);
 }
 
+/**
+ * True iff backlinks @a and @b belong to trees of the same type in the same
+ * segment generation. Nodes of such trees can be moved between them, see
+ * btree_range_move().
+ */
+static bool btree_backlink_is_compatible(const struct m0_be_btree_backlink *a,
+					 const struct m0_be_btree_backlink *b)
+{
+	return a->bli_type == b->bli_type && a->bli_gen == b->bli_gen;
+}
+
 /**
  * Btree node invariant implementation:
  * - assuming that the tree is completely in memory.
@@ -270,6 +575,7 @@ static bool btree_node_invariant(const struct m0_be_btree *btree,
 		_0C(node->bt_level <= BTREE_HEIGHT_MAX) &&
 		_0C(memcmp(&node->bt_backlink, &btree->bb_backlink,
 			   sizeof node->bt_backlink) == 0) &&
+		_0C(node_ksize(node) == btree_ksize(btree)) &&
 		/* Expected occupancy. */
 		_0C(ergo(root, 0 <= node->bt_num_active_key &&
 			 node->bt_num_active_key <= KV_NR)) &&
@@ -284,6 +590,12 @@ static bool btree_node_invariant(const struct m0_be_btree *btree,
 			      m0_be_seg_contains(btree->bb_seg,
 						 node->bt_kv_arr[i].
 						 btree_val))) &&
+		/* Inline keys match the keys of key-value pairs. */
+		_0C(ergo(node_ksize(node) != 0,
+			 m0_forall(i, node->bt_num_active_key,
+				   memcmp(node_key(node, i),
+					  node->bt_kv_arr[i].btree_key,
+					  node_ksize(node)) == 0))) &&
 		_0C(ergo(!node->bt_isleaf,
 			 m0_forall(i, node->bt_num_active_key + 1,
 				   node->bt_child_arr[i] != NULL &&
@@ -293,8 +605,8 @@ static bool btree_node_invariant(const struct m0_be_btree *btree,
 		/* Keys are in order. */
 		_0C(ergo(node->bt_num_active_key > 1,
 			 m0_forall(i, node->bt_num_active_key - 1,
-				   key_gt(btree, node->bt_kv_arr[i+1].btree_key,
-					  node->bt_kv_arr[i].btree_key))));
+				   key_gt(btree, node_key(node, i + 1),
+					  node_key(node, i)))));
 }
 
 /* ------------------------------------------------------------------
@@ -311,13 +623,13 @@ static bool btree_node_subtree_invariant(const struct m0_be_btree *btree,
 	/* Kids are in order. */
 	return	_0C(ergo(node->bt_num_active_key > 0 && !node->bt_isleaf,
 			 m0_forall(i, node->bt_num_active_key,
-				   key_gt(btree, node->bt_kv_arr[i].btree_key,
-					  node->bt_child_arr[i]->
-					  bt_kv_arr[node->bt_child_arr[i]->
-					  bt_num_active_key - 1].btree_key) &&
-				   key_lt(btree, node->bt_kv_arr[i].btree_key,
-					  node->bt_child_arr[i+1]->
-					  bt_kv_arr[0].btree_key)) &&
+				   key_gt(btree, node_key(node, i),
+					  node_key(node->bt_child_arr[i],
+						   node->bt_child_arr[i]->
+						   bt_num_active_key - 1)) &&
+				   key_lt(btree, node_key(node, i),
+					  node_key(node->bt_child_arr[i+1],
+						   0))) &&
 		         m0_forall(i, node->bt_num_active_key + 1,
 				   btree_node_invariant(btree,
 							node->bt_child_arr[i],
@@ -353,9 +665,13 @@ static void btree_node_update(struct m0_be_bnode       *node,
 		mem_update(btree, tx, node->bt_child_arr,
 			   sizeof(*node->bt_child_arr) *
 			   (node->bt_num_active_key + 1));
+		if (node_ksize(node) != 0)
+			mem_update(btree, tx, node_key(node, 0),
+				   node_ksize(node) * node->bt_num_active_key);
 	}
 
-	mem_update(btree, tx, &node->bt_footer, sizeof(node->bt_footer));
+	mem_update(btree, tx, node_footer(node),
+		   sizeof(struct m0_format_footer));
 }
 
 static void btree_node_keyval_update(struct m0_be_bnode       *node,
@@ -366,7 +682,10 @@ static void btree_node_keyval_update(struct m0_be_bnode       *node,
 	m0_format_footer_update(node);
 	mem_update(btree, tx, &node->bt_kv_arr[index],
 			   sizeof node->bt_kv_arr[index]);
-	mem_update(btree, tx, &node->bt_footer, sizeof node->bt_footer);
+	if (node_ksize(node) != 0)
+		mem_update(btree, tx, node_key(node, index), node_ksize(node));
+	mem_update(btree, tx, node_footer(node),
+		   sizeof(struct m0_format_footer));
 }
 
 /**
@@ -377,7 +696,9 @@ static void btree_create(struct m0_be_btree  *btree,
 			 const struct m0_fid *btree_fid)
 {
 	m0_format_header_pack(&btree->bb_header, &(struct m0_format_tag){
-		.ot_version = M0_BE_BTREE_FORMAT_VERSION,
+		.ot_version = btree->bb_ops->ko_inline_ksize == 0 ?
+			      M0_BE_BTREE_FORMAT_VERSION :
+			      M0_BE_BTREE_FORMAT_VERSION_2,
 		.ot_type    = M0_FORMAT_TYPE_BE_BTREE,
 		.ot_footer_offset = offsetof(struct m0_be_btree, bb_footer)
 	});
@@ -414,25 +735,29 @@ static struct m0_be_bnode *
 be_btree_node_alloc(const struct m0_be_btree *btree, struct m0_be_tx *tx)
 {
 	struct m0_be_bnode *node;
+	m0_bcount_t         ksize = btree_ksize(btree);
 
 	/*  Allocate memory for the node */
-	node = (struct m0_be_bnode *)mem_alloc(btree, tx,
-					       sizeof(struct m0_be_bnode),
+	node = (struct m0_be_bnode *)mem_alloc(btree, tx, node_size(ksize),
 					       M0_BITS(M0_BAP_NORMAL));
 	M0_ASSERT(node != NULL);	/* @todo: analyse return code */
 
 	m0_format_header_pack(&node->bt_header, &(struct m0_format_tag){
-		.ot_version = M0_BE_BNODE_FORMAT_VERSION,
+		.ot_version = ksize == 0 ? M0_BE_BNODE_FORMAT_VERSION :
+					   M0_BE_BNODE_FORMAT_VERSION_2,
 		.ot_type    = M0_FORMAT_TYPE_BE_BNODE,
-		.ot_footer_offset = offsetof(struct m0_be_bnode, bt_footer)
+		.ot_footer_offset = ksize == 0 ?
+			offsetof(struct m0_be_bnode, bt_footer) :
+			node_size(ksize) - sizeof(struct m0_format_footer)
 	});
 
 	be_btree_set_node_params(node, 0, 0, true);
 	node->bt_next = NULL;
 	node->bt_backlink = btree->bb_backlink;
+	node->bt_ksize = ksize;
 
 	m0_format_footer_update(node);
-	mem_update(btree, tx, node, sizeof *node);
+	mem_update(btree, tx, node, node_size(ksize));
 
 	return node;
 }
@@ -475,7 +800,7 @@ static void be_btree_split_child(struct m0_be_btree *btree,
 	/* Copy the latter half keys from the current child to the new child */
 	i = 0;
 	while (i < new_child->bt_num_active_key) {
-		new_child->bt_kv_arr[i] = child->bt_kv_arr[i + BTREE_FAN_OUT];
+		node_kv_copy(new_child, i, child, i + BTREE_FAN_OUT);
 		i++;
 	}
 
@@ -500,12 +825,12 @@ static void be_btree_split_child(struct m0_be_btree *btree,
 	/* In the parent node's arr, make space for the new child */
 	for (i = parent->bt_num_active_key + 1; i > index + 1; i--) {
 		parent->bt_child_arr[i] = parent->bt_child_arr[i - 1];
-		parent->bt_kv_arr[i - 1] = parent->bt_kv_arr[i - 2];
+		node_kv_copy(parent, i - 1, parent, i - 2);
 	}
 
 	/*  Update parent */
 	parent->bt_child_arr[index + 1] = new_child;
-	parent->bt_kv_arr[index] = child->bt_kv_arr[BTREE_FAN_OUT - 1];
+	node_kv_copy(parent, index, child, BTREE_FAN_OUT - 1);
 	parent->bt_num_active_key++;
 
 	/* re-calculate checksum after all fields has been updated */
@@ -532,30 +857,25 @@ static void be_btree_insert_into_nonfull(struct m0_be_btree      *btree,
 					 struct be_btree_key_val *kv)
 {
 	void *key = kv->btree_key;
-	int i = node->bt_num_active_key - 1;
+	int   i;
+	int   j;
 
 	while (!node->bt_isleaf)
 	{
-		while (i >= 0 &&
-		       key_lt(btree, key, node->bt_kv_arr[i].btree_key))
-			i--;
-		i++;
+		i = node_search(btree, node, key);
 
 		if (node->bt_child_arr[i]->bt_num_active_key == KV_NR) {
 			be_btree_split_child(btree, tx, node, i);
-			if (key_gt(btree, key, node->bt_kv_arr[i].btree_key))
+			if (key_gt(btree, key, node_key(node, i)))
 				i++;
 		}
 		node = node->bt_child_arr[i];
-		i = node->bt_num_active_key - 1;
 	}
 
-	while (i >= 0 &&
-	       key_lt(btree, key, node->bt_kv_arr[i].btree_key)) {
-		node->bt_kv_arr[i + 1] = node->bt_kv_arr[i];
-		i--;
-	}
-	node->bt_kv_arr[i + 1] = *kv;
+	i = node_search(btree, node, key);
+	for (j = node->bt_num_active_key; j > i; --j)
+		node_kv_copy(node, j, node, j - 1);
+	node_kv_set(node, i, kv);
 	node->bt_num_active_key++;
 
 	m0_format_footer_update(node);
@@ -581,7 +901,7 @@ static void be_btree_insert_newkey(struct m0_be_btree      *btree,
 	M0_PRE(btree_invariant(btree));
 	M0_PRE(btree_node_invariant(btree, btree->bb_root, true));
 	M0_PRE_EX(btree_node_subtree_invariant(btree, btree->bb_root));
-	M0_PRE_EX(be_btree_search(btree, kv->btree_key) == NULL);
+	M0_PRE_EX(be_btree_search(btree, kv->btree_key, NULL) == NULL);
 
 	old_root = btree->bb_root;
 	if (old_root->bt_num_active_key != KV_NR) {
@@ -657,8 +977,8 @@ static void be_btree_shift_key_vals(struct m0_be_bnode *dest,
 	unsigned int i = start_index;
 	while (i < stop_index)
 	{
-		dest->bt_kv_arr[i + key_dest_offset] =
-					src->bt_kv_arr[i + key_src_offset];
+		node_kv_copy(dest, i + key_dest_offset,
+			     src, i + key_src_offset);
 		dest->bt_child_arr[i + child_dest_offset ] =
 				src->bt_child_arr[i + child_src_offset];
 		++i;
@@ -693,7 +1013,7 @@ be_btree_merge_siblings(struct m0_be_tx    *tx,
 	node1 = parent->bt_child_arr[idx];
 	node2 = parent->bt_child_arr[idx + 1];
 
-	node1->bt_kv_arr[node1->bt_num_active_key++] = parent->bt_kv_arr[idx];
+	node_kv_copy(node1, node1->bt_num_active_key++, parent, idx);
 
 	M0_ASSERT(node1->bt_num_active_key + node2->bt_num_active_key <= KV_NR);
 
@@ -742,17 +1062,16 @@ static void be_btree_move_parent_key_to_right_child(struct m0_be_bnode *parent,
 	unsigned int i = rch->bt_num_active_key;
 
 	while (i > 0) {
-		rch->bt_kv_arr[i] = rch->bt_kv_arr[i - 1];
+		node_kv_copy(rch, i, rch, i - 1);
 		rch->bt_child_arr[i + 1] = rch->bt_child_arr[i];
 		--i;
 	}
 	rch->bt_child_arr[1] = rch->bt_child_arr[0];
-	rch->bt_kv_arr[0] = parent->bt_kv_arr[idx];
+	node_kv_copy(rch, 0, parent, idx);
 	rch->bt_child_arr[0] =
 			lch->bt_child_arr[lch->bt_num_active_key];
 	lch->bt_child_arr[lch->bt_num_active_key] = NULL;
-	parent->bt_kv_arr[idx] =
-			lch->bt_kv_arr[lch->bt_num_active_key-1];
+	node_kv_copy(parent, idx, lch, lch->bt_num_active_key - 1);
 	lch->bt_num_active_key--;
 	rch->bt_num_active_key++;
 }
@@ -764,15 +1083,14 @@ static void be_btree_move_parent_key_to_left_child(struct m0_be_bnode *parent,
 {
 	unsigned int i;
 
-	lch->bt_kv_arr[lch->bt_num_active_key] =
-					parent->bt_kv_arr[idx];
+	node_kv_copy(lch, lch->bt_num_active_key, parent, idx);
 	lch->bt_child_arr[lch->bt_num_active_key + 1] =
 					rch->bt_child_arr[0];
 	lch->bt_num_active_key++;
-	parent->bt_kv_arr[idx] = rch->bt_kv_arr[0];
+	node_kv_copy(parent, idx, rch, 0);
 	i = 0;
 	while (i < rch->bt_num_active_key - 1) {
-		rch->bt_kv_arr[i] = rch->bt_kv_arr[i + 1];
+		node_kv_copy(rch, i, rch, i + 1);
 		rch->bt_child_arr[i] = rch->bt_child_arr[i + 1];
 		++i;
 	}
@@ -849,7 +1167,7 @@ void be_btree_delete_key_from_node(struct m0_be_btree	 *tree,
 		btree_pair_release(tree, tx, &bnode->bt_kv_arr[idx]);
 
 		while (idx < bnode->bt_num_active_key - 1) {
-			bnode->bt_kv_arr[idx] = bnode->bt_kv_arr[idx+1];
+			node_kv_copy(bnode, idx, bnode, idx + 1);
 			++idx;
 		}
 		/*
@@ -863,6 +1181,11 @@ void be_btree_delete_key_from_node(struct m0_be_btree	 *tree,
 				   &bnode->bt_kv_arr[bnode_pos->bnp_index],
 				   sizeof
 				   bnode->bt_kv_arr[bnode_pos->bnp_index]);
+			if (node_ksize(bnode) != 0)
+				mem_update(tree, tx,
+					   node_key(bnode,
+						    bnode_pos->bnp_index),
+					   node_ksize(bnode));
 		}
 
 		bnode->bt_num_active_key--;
@@ -889,8 +1212,7 @@ static void btree_node_child_delete(struct m0_be_btree    *btree,
 	M0_LOG(M0_DEBUG, "swap%s with n=%p i=%d", left ? "L" : "R",
 						  child->bnp_node,
 						  child->bnp_index);
-	M0_SWAP(child->bnp_node->bt_kv_arr[child->bnp_index],
-		node->bt_kv_arr[index]);
+	node_kv_swap(child->bnp_node, child->bnp_index, node, index);
 	/*
 	 * Update checksum for parent, for child it will be updated
 	 * in delete_key_from_node().
@@ -939,17 +1261,12 @@ static int be_btree_delete_key(struct m0_be_btree *tree,
 
 			/*  Retrieve index of the key equal to or greater than*/
 			/*  key being searched */
-			iter = 0;
-			while (iter < bnode->bt_num_active_key &&
-			       key_gt(tree, key,
-				      bnode->bt_kv_arr[iter].btree_key))
-				iter++;
+			iter = node_search(tree, bnode, key);
 
 			idx = iter;
 
 			/* check if key is found */
-			if (iter < bnode->bt_num_active_key &&
-			    key_eq(tree, key, bnode->bt_kv_arr[iter].btree_key))
+			if (node_key_eq(tree, bnode, iter, key))
 				break;
 
 			/* Reached leaf node, nothing left to search */
@@ -1096,10 +1413,13 @@ static struct m0_be_bnode *node_pop(struct m0_be_btree_cursor *it, int *idx)
 *   @param key pointer to key which is used to search node.
 *   @param slant bool to decide searching needs to be on leaf node.
 *                if true, search leaf node, else search in non-leaf node
+*   @param path if not NULL, visited nodes are read-latched and recorded
+*               here. The caller releases them with path_runlatch().
 *   @return struct btree_node_pos.
 */
 struct btree_node_pos
-be_btree_get_btree_node(struct m0_be_btree_cursor *it, const void *key, bool slant)
+be_btree_get_btree_node(struct m0_be_btree_cursor *it, const void *key,
+			bool slant, struct btree_latch_path *path)
 {
 	int 			 idx;
 	struct m0_be_btree 	*tree = it->bc_tree;
@@ -1109,17 +1429,14 @@ be_btree_get_btree_node(struct m0_be_btree_cursor *it, const void *key, bool sla
 	it->bc_stack_pos = 0;
 
 	while (true) {
+		if (path != NULL)
+			path_rlatch(path, bnode);
 		/*  Retrieve index of the key equal to or greater than */
 		/*  the key being searched */
-		idx = 0;
-		while (idx < bnode->bt_num_active_key &&
-		       key_gt(tree, key, bnode->bt_kv_arr[idx].btree_key)) {
-			idx++;
-		}
+		idx = node_search(tree, bnode, key);
 
 		/*  If key is found, copy key-value pair */
-		if (idx < bnode->bt_num_active_key &&
-		    key_eq(tree, key, bnode->bt_kv_arr[idx].btree_key)) {
+		if (node_key_eq(tree, bnode, idx, key)) {
 			bnode_pos.bnp_node = bnode;
 			bnode_pos.bnp_index = idx;
 			break;
@@ -1242,6 +1559,8 @@ static void btree_truncate(struct m0_be_btree *btree, struct m0_be_tx *tx,
 			 */
 			break;
 		}
+		M0_ASSERT(btree_backlink_is_compatible(&node->bt_backlink,
+						       &btree->bb_backlink));
 		btree_node_free(node, btree, tx);
 		if (parent != NULL) {
 			/*
@@ -1270,9 +1589,18 @@ static void btree_truncate(struct m0_be_btree *btree, struct m0_be_tx *tx,
 			    parent->bt_num_active_key == 0) {
 				/*
 				 * Cleared the root, but still have 1
-				 * child. Move the root.
+				 * child. Move the root. The child can come
+				 * from another tree, see
+				 * m0_be_btree_delete_range().
 				 */
-				btree_root_set(btree, parent->bt_child_arr[0]);
+				node = parent->bt_child_arr[0];
+				M0_ASSERT(btree_backlink_is_compatible(
+						  &node->bt_backlink,
+						  &btree->bb_backlink));
+				node->bt_backlink = btree->bb_backlink;
+				m0_format_footer_update(node);
+				btree_node_update(node, btree, tx);
+				btree_root_set(btree, node);
 				mem_update(btree, tx, btree,
 					   sizeof(struct m0_be_btree));
 				btree_node_free(parent, btree, tx);
@@ -1293,14 +1621,15 @@ static void btree_truncate(struct m0_be_btree *btree, struct m0_be_tx *tx,
  * @return      key-value pair
  */
 static struct be_btree_key_val *be_btree_search(struct m0_be_btree *btree,
-						void *key)
+						void *key,
+						struct btree_latch_path *path)
 {
 	struct m0_be_btree_cursor btree_cursor;
 	struct btree_node_pos	  node_pos;
 	struct be_btree_key_val   *key_val = NULL;
 
 	btree_cursor.bc_tree = btree;
-	node_pos = be_btree_get_btree_node(&btree_cursor, key, false);
+	node_pos = be_btree_get_btree_node(&btree_cursor, key, false, path);
 
 	if (node_pos.bnp_node)
 		key_val = &node_pos.bnp_node->bt_kv_arr[node_pos.bnp_index];
@@ -1318,13 +1647,19 @@ static struct be_btree_key_val *be_btree_search(struct m0_be_btree *btree,
 */
 static void *be_btree_get_max_key(struct m0_be_btree *tree)
 {
-	struct btree_node_pos node;
+	struct btree_latch_path  path = {};
+	struct m0_be_bnode      *node = tree->bb_root;
+	void                    *key = NULL;
 
-	be_btree_get_max_key_pos(tree->bb_root, &node);
-	if (node.bnp_node->bt_num_active_key == 0)
-		return NULL;
-	else
-		return node.bnp_node->bt_kv_arr[node.bnp_index].btree_key;
+	path_rlatch(&path, node);
+	while (!node->bt_isleaf) {
+		node = node->bt_child_arr[node->bt_num_active_key];
+		path_rlatch(&path, node);
+	}
+	if (node->bt_num_active_key > 0)
+		key = node->bt_kv_arr[node->bt_num_active_key - 1].btree_key;
+	path_runlatch(&path);
+	return key;
 }
 
 /**
@@ -1337,13 +1672,19 @@ static void *be_btree_get_max_key(struct m0_be_btree *tree)
 */
 static void *be_btree_get_min_key(struct m0_be_btree *tree)
 {
-	struct btree_node_pos node;
+	struct btree_latch_path  path = {};
+	struct m0_be_bnode      *node = tree->bb_root;
+	void                    *key = NULL;
 
-	be_btree_get_min_key_pos(tree->bb_root, &node);
-	if (node.bnp_node->bt_num_active_key == 0)
-		return NULL;
-	else
-		return node.bnp_node->bt_kv_arr[0].btree_key;
+	path_rlatch(&path, node);
+	while (!node->bt_isleaf) {
+		node = node->bt_child_arr[0];
+		path_rlatch(&path, node);
+	}
+	if (node->bt_num_active_key > 0)
+		key = node->bt_kv_arr[0].btree_key;
+	path_runlatch(&path);
+	return key;
 }
 
 static void btree_pair_release(struct m0_be_btree *btree, struct m0_be_tx *tx,
@@ -1352,6 +1693,150 @@ static void btree_pair_release(struct m0_be_btree *btree, struct m0_be_tx *tx,
 	mem_free(btree, tx, kv->btree_key);
 }
 
+/**
+ * Allocates a key-value pair for @key and fills it with @key and @val.
+ *
+ * If @val is NULL, value placeholder of @vsz bytes is returned in @anchor.
+ */
+static void btree_kv_new(struct m0_be_btree        *tree,
+			 struct m0_be_tx           *tx,
+			 const struct m0_buf       *key,
+			 const struct m0_buf       *val,
+			 struct m0_be_btree_anchor *anchor,
+			 m0_bcount_t                vsz,
+			 uint64_t                   zonemask,
+			 struct be_btree_key_val   *kv)
+{
+	m0_bcount_t ksz;
+
+	M0_PRE(ergo(btree_ksize(tree) != 0,
+		    key->b_nob == tree->bb_ops->ko_inline_ksize));
+	/* Avoid CPU alignment overhead on values. */
+	ksz = m0_align(key->b_nob, sizeof(void*));
+	kv->btree_key = mem_alloc(tree, tx, ksz + vsz, zonemask);
+	kv->btree_val = kv->btree_key + ksz;
+	memcpy(kv->btree_key, key->b_addr, key->b_nob);
+	memset(kv->btree_key + key->b_nob, 0, ksz - key->b_nob);
+	if (val != NULL) {
+		memcpy(kv->btree_val, val->b_addr, vsz);
+		mem_update(tree, tx, kv->btree_key, ksz + vsz);
+	} else {
+		mem_update(tree, tx, kv->btree_key, ksz);
+		anchor->ba_value.b_addr = kv->btree_val;
+	}
+}
+
+/**
+ * Finds the leaf where @key has to be inserted, with bb_lock held in shared
+ * mode.
+ *
+ * Descends from the root with latch coupling, splitting full children on the
+ * way down as be_btree_insert_into_nonfull() does. On success the leaf is
+ * returned in @pos write-latched, with the index to insert at.
+ *
+ * @retval -EEXIST the key is already in the tree.
+ * @retval -EAGAIN the root is full: a new root is needed, which requires
+ *                 bb_lock to be held exclusively.
+ */
+static int be_btree_insert_pos_latched(struct m0_be_btree    *btree,
+				       struct m0_be_tx       *tx,
+				       const void            *key,
+				       struct btree_node_pos *pos)
+{
+	struct m0_be_bnode *node = btree->bb_root;
+	struct m0_be_bnode *child;
+	unsigned int        i;
+	int                 cmp;
+
+	node_wlatch(node);
+	if (node->bt_num_active_key == KV_NR) {
+		node_wunlatch(node);
+		return -EAGAIN;
+	}
+	while (true) {
+		i = node_search(btree, node, key);
+		if (node_key_eq(btree, node, i, key)) {
+			node_wunlatch(node);
+			return -EEXIST;
+		}
+		if (node->bt_isleaf)
+			break;
+
+		child = node->bt_child_arr[i];
+		node_wlatch(child);
+		if (child->bt_num_active_key == KV_NR) {
+			be_btree_split_child(btree, tx, node, i);
+			cmp = be_btree_compare(btree, key, node_key(node, i));
+			if (cmp == 0) {
+				node_wunlatch(child);
+				node_wunlatch(node);
+				return -EEXIST;
+			}
+			/*
+			 * The new sibling is reachable only through the
+			 * latched parent, so nobody can have latched it.
+			 */
+			if (cmp > 0) {
+				node_wunlatch(child);
+				child = node->bt_child_arr[i + 1];
+				node_wlatch(child);
+			}
+		}
+		node_wunlatch(node);
+		node = child;
+	}
+	pos->bnp_node  = node;
+	pos->bnp_index = i;
+	return 0;
+}
+
+static void be_btree_leaf_insert(struct m0_be_btree      *btree,
+				 struct m0_be_tx         *tx,
+				 struct btree_node_pos   *pos,
+				 struct be_btree_key_val *kv)
+{
+	struct m0_be_bnode *node = pos->bnp_node;
+	unsigned int        i;
+
+	M0_PRE(node->bt_isleaf && node->bt_num_active_key < KV_NR);
+
+	for (i = node->bt_num_active_key; i > pos->bnp_index; --i)
+		node_kv_copy(node, i, node, i - 1);
+	node_kv_set(node, pos->bnp_index, kv);
+	node->bt_num_active_key++;
+
+	m0_format_footer_update(node);
+	btree_node_update(node, btree, tx);
+}
+
+/**
+ * Inserts @key and @val with bb_lock held in shared mode, so that inserts
+ * into different parts of the tree proceed concurrently.
+ *
+ * @retval -EAGAIN the insert has to be retried with bb_lock held exclusively.
+ */
+static int btree_insert_shared(struct m0_be_btree  *tree,
+			       struct m0_be_tx     *tx,
+			       const struct m0_buf *key,
+			       const struct m0_buf *val,
+			       uint64_t             zonemask)
+{
+	struct btree_node_pos   pos;
+	struct be_btree_key_val new_kv;
+	int                     rc;
+
+	m0_rwlock_read_lock(btree_rwlock(tree));
+	rc = be_btree_insert_pos_latched(tree, tx, key->b_addr, &pos);
+	if (rc == 0) {
+		btree_kv_new(tree, tx, key, val, NULL, val->b_nob,
+			     zonemask, &new_kv);
+		be_btree_leaf_insert(tree, tx, &pos, &new_kv);
+		node_wunlatch(pos.bnp_node);
+	}
+	m0_rwlock_read_unlock(btree_rwlock(tree));
+	return rc;
+}
+
 /**
  * Inserts or updates value by key
  * @param tree The btree
@@ -1371,11 +1856,11 @@ static void btree_save(struct m0_be_btree        *tree,
 		       enum btree_save_optype     optype,
 		       uint64_t                   zonemask)
 {
-	m0_bcount_t        ksz;
 	m0_bcount_t        vsz;
 	struct be_btree_key_val   new_kv;
 	struct be_btree_key_val  *cur_kv;
 	bool               val_overflow = false;
+	int                rc;
 
 	M0_ENTRY("tree=%p", tree);
 
@@ -1398,6 +1883,35 @@ static void btree_save(struct m0_be_btree        *tree,
 		      M0_BBO_UPDATE : M0_BBO_INSERT, NULL);
 
 	m0_be_op_active(op);
+	op_tree(op)->t_rc = 0;
+
+	if (M0_FI_ENABLED("already_exists")) {
+		m0_rwlock_write_lock(btree_rwlock(tree));
+		if (anchor != NULL) {
+			anchor->ba_tree = tree;
+			anchor->ba_write = true;
+			anchor->ba_value.b_addr = NULL;
+		}
+		goto fi_exist;
+	}
+
+	/*
+	 * Plain inserts go through the shared path. Anchored inserts hand out
+	 * the value before it is filled, so they keep the tree exclusively
+	 * locked until m0_be_btree_release().
+	 */
+	if (optype == BTREE_SAVE_INSERT && anchor == NULL &&
+	    !M0_FI_ENABLED("exclusive_insert")) {
+		rc = btree_insert_shared(tree, tx, key, val, zonemask);
+		if (rc != -EAGAIN) {
+			op_tree(op)->t_rc = rc;
+			if (rc == -EEXIST)
+				M0_LOG(M0_NOTICE, "the key entry at %p already"
+				       " exist", key->b_addr);
+			goto out;
+		}
+	}
+
 	m0_rwlock_write_lock(btree_rwlock(tree));
 	if (anchor != NULL) {
 		anchor->ba_tree = tree;
@@ -1407,11 +1921,7 @@ static void btree_save(struct m0_be_btree        *tree,
 	} else
 		vsz = val->b_nob;
 
-	if (M0_FI_ENABLED("already_exists"))
-		goto fi_exist;
-
-	op_tree(op)->t_rc = 0;
-	cur_kv = be_btree_search(tree, key->b_addr);
+	cur_kv = be_btree_search(tree, key->b_addr, NULL);
 	if ((cur_kv == NULL && optype != BTREE_SAVE_UPDATE) ||
 	    (cur_kv != NULL && optype == BTREE_SAVE_UPDATE) ||
 	    optype == BTREE_SAVE_OVERWRITE) {
@@ -1447,23 +1957,8 @@ static void btree_save(struct m0_be_btree        *tree,
 
 		if (op_tree(op)->t_rc == 0 &&
 		    (cur_kv == NULL || val_overflow)) {
-			/* Avoid CPU alignment overhead on values. */
-			ksz = m0_align(key->b_nob, sizeof(void*));
-			new_kv.btree_key =
-				      mem_alloc(tree, tx, ksz + vsz, zonemask);
-			new_kv.btree_val = new_kv.btree_key + ksz;
-			memcpy(new_kv.btree_key, key->b_addr, key->b_nob);
-			memset(new_kv.btree_key + key->b_nob, 0,
-							ksz - key->b_nob);
-			if (val != NULL) {
-				memcpy(new_kv.btree_val, val->b_addr, vsz);
-				mem_update(tree, tx,
-						new_kv.btree_key, ksz + vsz);
-			} else {
-				mem_update(tree, tx, new_kv.btree_key, ksz);
-				anchor->ba_value.b_addr = new_kv.btree_val;
-			}
-
+			btree_kv_new(tree, tx, key, val, anchor, vsz,
+				     zonemask, &new_kv);
 			be_btree_insert_newkey(tree, tx, &new_kv);
 		}
 	} else {
@@ -1475,6 +1970,7 @@ fi_exist:
 
 	if (anchor == NULL)
 		m0_rwlock_write_unlock(btree_rwlock(tree));
+out:
 	m0_be_op_done(op);
 	M0_LEAVE("tree=%p", tree);
 }
@@ -1490,6 +1986,11 @@ M0_INTERNAL void m0_be_btree_init(struct m0_be_btree *tree,
 {
 	M0_ENTRY("tree=%p seg=%p", tree, seg);
 	M0_PRE(ops != NULL);
+	M0_PRE(ops->ko_inline_ksize <= BTREE_INLINE_KEY_MAX);
+	M0_PRE(ergo(ops->ko_flags & M0_BKF_U64,
+		    ops->ko_inline_ksize == sizeof(uint64_t)));
+	M0_PRE(ergo(ops->ko_flags & M0_BKF_U128,
+		    ops->ko_inline_ksize == 2 * sizeof(uint64_t)));
 
 	m0_rwlock_init(btree_rwlock(tree));
 	tree->bb_ops = ops;
@@ -1590,17 +2091,19 @@ M0_INTERNAL void m0_be_btree_truncate(struct m0_be_btree *tree,
 static void btree_node_alloc_credit(const struct m0_be_btree     *tree,
 					  struct m0_be_tx_credit *accum)
 {
-	btree_mem_alloc_credit(tree, sizeof(struct m0_be_bnode), accum);
+	btree_mem_alloc_credit(tree, node_size(btree_ksize_max(tree)), accum);
 }
 
-static void btree_node_update_credit(struct m0_be_tx_credit *accum,
-				     m0_bcount_t nr)
+static void btree_node_update_credit(const struct m0_be_btree *tree,
+				     struct m0_be_tx_credit   *accum,
+				     m0_bcount_t               nr)
 {
 	struct m0_be_tx_credit cred = {};
 
 	/* struct m0_be_bnode update x2 */
 	m0_be_tx_credit_mac(&cred,
-			    &M0_BE_TX_CREDIT_TYPE(struct m0_be_bnode), 2);
+			    &M0_BE_TX_CREDIT(1,
+				     node_size(btree_ksize_max(tree))), 2);
 
 	m0_be_tx_credit_mac(accum, &cred, nr);
 }
@@ -1608,10 +2111,10 @@ static void btree_node_update_credit(struct m0_be_tx_credit *accum,
 static void btree_node_free_credit(const struct m0_be_btree     *tree,
 					 struct m0_be_tx_credit *accum)
 {
-	btree_mem_free_credit(tree, sizeof(struct m0_be_bnode), accum);
+	btree_mem_free_credit(tree, node_size(btree_ksize_max(tree)), accum);
 	m0_be_tx_credit_add(accum,
 			    &M0_BE_TX_CREDIT_TYPE(uint64_t));
-	btree_node_update_credit(accum, 1); /* for parent */
+	btree_node_update_credit(tree, accum, 1); /* for parent */
 }
 
 /* XXX */
@@ -1630,7 +2133,7 @@ static void btree_rebalance_credit(const struct m0_be_btree *tree,
 	struct m0_be_tx_credit cred = {};
 
 	btree_node_alloc_credit(tree, &cred);
-	btree_node_update_credit(&cred, 1);
+	btree_node_update_credit(tree, &cred, 1);
 	btree_credit(tree, &cred);
 
 	m0_be_tx_credit_add(accum, &cred);
@@ -1658,6 +2161,10 @@ static void kv_delete_credit(const struct m0_be_btree *tree,
 			      accum);
 	m0_be_tx_credit_add(accum,
 			    &M0_BE_TX_CREDIT_TYPE(struct be_btree_key_val));
+	/* and its inline key */
+	if (btree_ksize_max(tree) != 0)
+		m0_be_tx_credit_add(accum,
+				    &M0_BE_TX_CREDIT(1, btree_ksize_max(tree)));
 	/* capture parent csum in case values swapped during delete */
 	m0_be_tx_credit_add(accum,
 			    &M0_BE_TX_CREDIT(1,
@@ -1668,7 +2175,7 @@ static void btree_node_split_child_credit(const struct m0_be_btree *tree,
 					  struct m0_be_tx_credit   *accum)
 {
 	btree_node_alloc_credit(tree, accum);
-	btree_node_update_credit(accum, 3);
+	btree_node_update_credit(tree, accum, 3);
 }
 
 static void insert_credit(const struct m0_be_btree *tree,
@@ -1689,7 +2196,7 @@ static void insert_credit(const struct m0_be_btree *tree,
 	/* for be_btree_insert_into_nonfull() */
 	btree_node_split_child_credit(tree, &cred);
 	m0_be_tx_credit_mul(&cred, height);
-	btree_node_update_credit(&cred, 1);
+	btree_node_update_credit(tree, &cred, 1);
 
 	/* for be_btree_insert_newkey() */
 	btree_node_alloc_credit(tree, &cred);
@@ -1710,7 +2217,7 @@ static void delete_credit(const struct m0_be_btree *tree,
 	struct m0_be_tx_credit cred = {};
 
 	kv_delete_credit(tree, ksize, vsize, &cred);
-	btree_node_update_credit(&cred, 1);
+	btree_node_update_credit(tree, &cred, 1);
 	btree_node_free_credit(tree, &cred);
 	btree_rebalance_credit(tree, &cred);
 	m0_be_tx_credit_mac(accum, &cred, nr);
@@ -1747,6 +2254,31 @@ M0_INTERNAL void m0_be_btree_delete_credit(const struct m0_be_btree     *tree,
 	M0_BE_CREDIT_INC(nr, M0_BE_CU_BTREE_DELETE, accum);
 }
 
+M0_INTERNAL void m0_be_btree_delete_range_credit(const struct m0_be_btree *tree,
+						 m0_bcount_t               ksize,
+						 m0_bcount_t               vsize,
+						 struct m0_be_tx_credit   *accum)
+{
+	struct m0_be_tx_credit cred = {};
+	struct m0_be_tx_credit level = {};
+
+	/* Deletion of the single key of a small range. */
+	delete_credit(tree, 1, ksize, vsize, &cred);
+	/* The cut: @dst root or its replacement, the cut node, the root. */
+	btree_node_update_credit(tree, &cred, 3);
+	btree_node_free_credit(tree, &cred);
+	kv_delete_credit(tree, ksize, vsize, &cred);
+	m0_be_tx_credit_mac(&cred,
+			    &M0_BE_TX_CREDIT_TYPE(struct m0_be_btree), 2);
+	/* Merge or redistribution on each level. */
+	btree_node_update_credit(tree, &level, 3);
+	btree_node_free_credit(tree, &level);
+	m0_be_tx_credit_mac(&cred, &level, BTREE_HEIGHT_MAX);
+
+	m0_be_tx_credit_add(accum, &cred);
+	M0_BE_CREDIT_INC(1, M0_BE_CU_BTREE_DELETE, accum);
+}
+
 M0_INTERNAL void m0_be_btree_update_credit(const struct m0_be_btree     *tree,
 						 m0_bcount_t             nr,
 						 m0_bcount_t             vsize,
@@ -1787,7 +2319,7 @@ M0_INTERNAL void m0_be_btree_create_credit(const struct m0_be_btree     *tree,
 	struct m0_be_tx_credit cred = {};
 
 	btree_node_alloc_credit(tree, &cred);
-	btree_node_update_credit(&cred, 1);
+	btree_node_update_credit(tree, &cred, 1);
 	m0_be_tx_credit_mac(accum, &cred, nr);
 }
 
@@ -1982,6 +2514,296 @@ M0_INTERNAL void m0_be_btree_delete(struct m0_be_btree *tree,
 	M0_LEAVE("tree=%p", tree);
 }
 
+/**
+ * Where m0_be_btree_delete_range() cuts the tree.
+ *
+ * Keys [rc_lo, rc_hi) of rc_node are in the range. rc_path[] holds the
+ * ancestors of rc_node from the root down and rc_idx[] the index of the child
+ * taken in each of them.
+ */
+struct btree_range_cut {
+	struct m0_be_bnode *rc_path[BTREE_HEIGHT_MAX + 1];
+	unsigned int        rc_idx[BTREE_HEIGHT_MAX + 1];
+	unsigned int        rc_depth;
+	struct m0_be_bnode *rc_node;
+	unsigned int        rc_lo;
+	unsigned int        rc_hi;
+	/** Some key in the range, if no node has two keys in it. */
+	void               *rc_single;
+};
+
+/**
+ * Looks for a node under @node with at least two keys in [@lo, @hi). NULL @lo
+ * and @hi stand for the open bounds.
+ *
+ * Only the nodes on the border of the range are visited, that is at most two
+ * per level.
+ */
+static bool btree_range_find(const struct m0_be_btree *tree,
+			     struct m0_be_bnode       *node,
+			     const void               *lo,
+			     const void               *hi,
+			     struct btree_range_cut   *cut,
+			     unsigned int              depth)
+{
+	unsigned int i = lo == NULL ? 0 : node_search(tree, node, lo);
+	unsigned int j = hi == NULL ? node->bt_num_active_key :
+				      node_search(tree, node, hi);
+
+	M0_ASSERT(depth < ARRAY_SIZE(cut->rc_path));
+	if (j >= i + 2) {
+		cut->rc_node  = node;
+		cut->rc_depth = depth;
+		cut->rc_lo    = i;
+		cut->rc_hi    = j;
+		return true;
+	}
+	if (j == i + 1 && cut->rc_single == NULL)
+		cut->rc_single = node->bt_kv_arr[i].btree_key;
+	if (node->bt_isleaf)
+		return false;
+	cut->rc_path[depth] = node;
+	cut->rc_idx[depth]  = i;
+	/*
+	 * If the i-th key is in the range, the range continues into both
+	 * children around it, each bounded on one side only.
+	 */
+	if (btree_range_find(tree, node->bt_child_arr[i], lo,
+			     j == i ? hi : NULL, cut, depth + 1))
+		return true;
+	if (j == i)
+		return false;
+	cut->rc_path[depth] = node;
+	cut->rc_idx[depth]  = i + 1;
+	return btree_range_find(tree, node->bt_child_arr[i + 1], NULL, hi,
+				cut, depth + 1);
+}
+
+/** Number of records in the subtree of @node. */
+static m0_bcount_t btree_subtree_nr(const struct m0_be_bnode *node)
+{
+	m0_bcount_t  nr = node->bt_num_active_key;
+	unsigned int i;
+
+	if (!node->bt_isleaf) {
+		for (i = 0; i <= node->bt_num_active_key; ++i)
+			nr += btree_subtree_nr(node->bt_child_arr[i]);
+	}
+	return nr;
+}
+
+/**
+ * Moves keys [rc_lo, rc_hi) of the cut node to the empty tree @dst together
+ * with the subtrees between them and returns the number of records moved.
+ *
+ * The subtrees are re-parented as they are, without copying. In a non-leaf
+ * node the first key of the range stays in place to separate the children
+ * around the cut and the last one is released, as @dst root has one key less
+ * than the children it gets.
+ *
+ * Only @dst root gets the backlink of @dst: rewriting every moved node would
+ * make the work proportional to the size of the range. The other moved nodes
+ * keep the backlink of @tree, which remains valid for @dst:
+ *
+ *     - both trees have the same type and are in the same segment, so the
+ *       backlinks differ only in the tree cookie and fid
+ *       (btree_backlink_is_compatible(), checked by the caller);
+ *
+ *     - @dst is only truncated and destroyed. btree_truncate() checks
+ *       nothing but compatibility of the nodes it frees, and rewrites the
+ *       backlink of a node that becomes the root, so that the root
+ *       invariants of m0_be_btree_destroy() hold. The backlink cookie of
+ *       @tree, which can be gone by then, is never dereferenced for @dst.
+ */
+static m0_bcount_t btree_range_move(struct m0_be_btree     *tree,
+				    struct m0_be_btree     *dst,
+				    struct m0_be_tx        *tx,
+				    struct btree_range_cut *cut)
+{
+	struct m0_be_bnode *node = cut->rc_node;
+	struct m0_be_bnode *root = dst->bb_root;
+	unsigned int        i    = cut->rc_lo;
+	unsigned int        j    = cut->rc_hi;
+	unsigned int        gone;
+	unsigned int        k;
+	m0_bcount_t         nr;
+
+	if (node->bt_isleaf) {
+		gone = j - i;
+		for (k = 0; k < gone; ++k)
+			node_kv_copy(root, k, node, i + k);
+		root->bt_num_active_key = gone;
+		m0_format_footer_update(root);
+		btree_node_update(root, dst, tx);
+		nr = gone;
+	} else {
+		gone = j - i - 1;
+		nr = gone;
+		for (k = i + 1; k < j; ++k)
+			nr += btree_subtree_nr(node->bt_child_arr[k]);
+		if (gone == 1) {
+			/* A single subtree becomes @dst itself. */
+			btree_node_free(root, dst, tx);
+			root = node->bt_child_arr[i + 1];
+			M0_ASSERT(btree_backlink_is_compatible(
+					  &root->bt_backlink,
+					  &dst->bb_backlink));
+			root->bt_backlink = dst->bb_backlink;
+			btree_root_set(dst, root);
+			mem_update(dst, tx, dst, sizeof(struct m0_be_btree));
+		} else {
+			be_btree_set_node_params(root, gone - 1,
+						 node->bt_level, false);
+			for (k = 0; k < gone - 1; ++k)
+				node_kv_copy(root, k, node, i + 1 + k);
+			for (k = 0; k < gone; ++k)
+				root->bt_child_arr[k] =
+					node->bt_child_arr[i + 1 + k];
+		}
+		m0_format_footer_update(root);
+		btree_node_update(root, dst, tx);
+		btree_pair_release(tree, tx, &node->bt_kv_arr[j - 1]);
+		/* Children of node shift with the keys on their left. */
+		node->bt_child_arr[i + 1] = node->bt_child_arr[j];
+	}
+	for (k = j; k < node->bt_num_active_key; ++k) {
+		node_kv_copy(node, k - gone, node, k);
+		node->bt_child_arr[k + 1 - gone] = node->bt_child_arr[k + 1];
+	}
+	node->bt_num_active_key -= gone;
+	m0_format_footer_update(node);
+	btree_node_update(node, tree, tx);
+	return nr;
+}
+
+/**
+ * Restores the occupancy of the nodes on the path to the cut node, bottom up.
+ *
+ * An underflowing node is merged with a sibling, which moves the underflow to
+ * the parent, or takes keys from the sibling if they do not fit in one node,
+ * which ends the rebalancing.
+ */
+static void btree_range_rebalance(struct m0_be_btree     *tree,
+				  struct m0_be_tx        *tx,
+				  struct btree_range_cut *cut)
+{
+	struct m0_be_bnode *node  = cut->rc_node;
+	unsigned int        depth = cut->rc_depth;
+	struct m0_be_bnode *parent;
+	struct m0_be_bnode *lch;
+	struct m0_be_bnode *rch;
+	unsigned int        s;
+
+	while (depth > 0 && node->bt_num_active_key < BTREE_FAN_OUT - 1) {
+		parent = cut->rc_path[--depth];
+		s = cut->rc_idx[depth];
+		if (s == parent->bt_num_active_key)
+			--s;
+		lch = parent->bt_child_arr[s];
+		rch = parent->bt_child_arr[s + 1];
+		if (lch->bt_num_active_key + rch->bt_num_active_key < KV_NR) {
+			if (be_btree_merge_siblings(tx, tree, parent, s) ==
+			    tree->bb_root)
+				break;
+			node = parent;
+			continue;
+		}
+		while (lch->bt_num_active_key < BTREE_FAN_OUT - 1)
+			be_btree_move_parent_key_to_left_child(parent,
+							       lch, rch, s);
+		while (rch->bt_num_active_key < BTREE_FAN_OUT - 1)
+			be_btree_move_parent_key_to_right_child(parent,
+								lch, rch, s);
+		m0_format_footer_update(lch);
+		m0_format_footer_update(rch);
+		m0_format_footer_update(parent);
+		btree_node_update(parent, tree, tx);
+		btree_node_update(lch, tree, tx);
+		btree_node_update(rch, tree, tx);
+		break;
+	}
+}
+
+/**
+ * Removes the records of [@lo, @hi) in a single cut, see
+ * m0_be_btree_delete_range().
+ */
+static int btree_range_delete(struct m0_be_btree *tree,
+			      struct m0_be_btree *dst,
+			      struct m0_be_tx    *tx,
+			      const void         *lo,
+			      const void         *hi,
+			      m0_bcount_t        *nr)
+{
+	struct btree_range_cut cut = {};
+	struct m0_buf          key;
+	int                    rc;
+
+	*nr = 0;
+	if (lo != NULL && hi != NULL && !key_lt(tree, lo, hi))
+		return 0;
+	if (btree_range_find(tree, tree->bb_root, lo, hi, &cut, 0)) {
+		*nr = btree_range_move(tree, dst, tx, &cut);
+		btree_range_rebalance(tree, tx, &cut);
+		return 0;
+	}
+	if (cut.rc_single == NULL)
+		return 0;
+	/*
+	 * No node has two keys in the range, so the range is small. Delete its
+	 * key one at a time. be_btree_delete_key() frees the key it is given,
+	 * keep a copy to navigate with.
+	 */
+	rc = m0_buf_copy(&key, &M0_BUF_INIT(be_btree_ksize(tree, cut.rc_single),
+					    cut.rc_single));
+	if (rc != 0)
+		return M0_ERR(rc);
+	rc = be_btree_delete_key(tree, tx, tree->bb_root, key.b_addr);
+	M0_ASSERT(rc == 0);
+	m0_buf_free(&key);
+	*nr = 1;
+	return 0;
+}
+
+M0_INTERNAL void m0_be_btree_delete_range(struct m0_be_btree  *tree,
+					  struct m0_be_tx     *tx,
+					  struct m0_be_op     *op,
+					  const struct m0_buf *lo,
+					  const struct m0_buf *hi,
+					  struct m0_be_btree  *dst,
+					  m0_bcount_t         *nr)
+{
+	M0_ENTRY("tree=%p dst=%p", tree, dst);
+	M0_PRE(tree->bb_root != NULL && tree->bb_ops != NULL);
+	M0_PRE(dst->bb_root != NULL && dst->bb_ops == tree->bb_ops);
+	M0_PRE(dst->bb_seg == tree->bb_seg);
+	M0_PRE(btree_backlink_is_compatible(&dst->bb_backlink,
+					    &tree->bb_backlink));
+	M0_PRE(m0_be_btree_is_empty(dst));
+	M0_PRE(btree_ksize(dst) == btree_ksize(tree));
+	M0_PRE(nr != NULL);
+
+	M0_BE_CREDIT_DEC(M0_BE_CU_BTREE_DELETE, tx);
+
+	btree_op_fill(op, tree, tx, M0_BBO_DELETE, NULL);
+
+	m0_be_op_active(op);
+	m0_rwlock_write_lock(btree_rwlock(tree));
+	M0_PRE_EX(btree_node_subtree_invariant(tree, tree->bb_root));
+
+	op_tree(op)->t_rc = btree_range_delete(tree, dst, tx,
+					       lo == NULL ? NULL : lo->b_addr,
+					       hi == NULL ? NULL : hi->b_addr,
+					       nr);
+
+	M0_POST(btree_invariant(tree));
+	M0_POST(btree_node_invariant(tree, tree->bb_root, true));
+	M0_POST_EX(btree_node_subtree_invariant(tree, tree->bb_root));
+	m0_rwlock_write_unlock(btree_rwlock(tree));
+	m0_be_op_done(op);
+	M0_LEAVE("tree=%p nr=%"PRIu64, tree, *nr);
+}
+
 static void be_btree_lookup(struct m0_be_btree *tree,
 			    struct m0_be_op *op,
 			    const struct m0_buf *key_in,
@@ -1989,6 +2811,7 @@ static void be_btree_lookup(struct m0_be_btree *tree,
 			    struct m0_buf *value)
 {
 	struct m0_be_btree_cursor  it;
+	struct btree_latch_path    path = {};
 	struct btree_node_pos      kp;
 	struct be_btree_key_val   *kv;
 	m0_bcount_t                ksize;
@@ -2005,7 +2828,7 @@ static void be_btree_lookup(struct m0_be_btree *tree,
 
 	it.bc_tree = tree;
 	kp = be_btree_get_btree_node(&it, key_in->b_addr,
-			    /* slant: */ key_out == NULL ? false : true);
+			    /* slant: */ key_out == NULL ? false : true, &path);
 	if (kp.bnp_node) {
 		kv = &kp.bnp_node->bt_kv_arr[kp.bnp_index];
 
@@ -2025,6 +2848,7 @@ static void be_btree_lookup(struct m0_be_btree *tree,
 	} else
 		op_tree(op)->t_rc = -ENOENT;
 
+	path_runlatch(&path);
 	m0_rwlock_read_unlock(btree_rwlock(tree));
 	m0_be_op_done(op);
 	M0_LEAVE("rc=%d", op_tree(op)->t_rc);
@@ -2087,6 +2911,576 @@ M0_INTERNAL void m0_be_btree_minkey(struct m0_be_btree *tree,
 	m0_rwlock_read_unlock(btree_rwlock(tree));
 	m0_be_op_done(op);
 }
+
+/* ------------------------------------------------------------------
+ * Btree batch interfaces implementation
+ * ------------------------------------------------------------------ */
+
+/**
+ * Read-latched path from the root to the node where the previous key of a
+ * batch was found, together with the exclusive upper bound of the key range
+ * covered by each node on the path (NULL meaning no bound).
+ */
+struct btree_batch_path {
+	struct btree_latch_path  bbp_latch;
+	const void              *bbp_bound[BTREE_HEIGHT_MAX + 1];
+};
+
+/**
+ * Looks @key up, starting from the deepest node on @path whose key range
+ * contains it. Keys have to come in non-decreasing order, so that only upper
+ * bounds have to be checked.
+ */
+static struct be_btree_key_val *
+btree_batch_search(struct m0_be_btree      *tree,
+		   struct btree_batch_path *bp,
+		   const void              *key)
+{
+	struct btree_latch_path *path = &bp->bbp_latch;
+	struct m0_be_bnode      *node;
+	const void              *bound;
+	unsigned int             i;
+
+	while (path->blp_nr > 1 && bp->bbp_bound[path->blp_nr - 1] != NULL &&
+	       !key_lt(tree, key, bp->bbp_bound[path->blp_nr - 1])) {
+		node = path->blp_node[--path->blp_nr];
+		m0_rwlock_read_unlock(node_latch(node));
+	}
+	if (path->blp_nr == 0) {
+		path_rlatch(path, tree->bb_root);
+		bp->bbp_bound[0] = NULL;
+	}
+	node = path->blp_node[path->blp_nr - 1];
+	while (true) {
+		i = node_search(tree, node, key);
+		if (node_key_eq(tree, node, i, key))
+			return &node->bt_kv_arr[i];
+		if (node->bt_isleaf)
+			return NULL;
+		bound = i < node->bt_num_active_key ? node_key(node, i) :
+			bp->bbp_bound[path->blp_nr - 1];
+		node = node->bt_child_arr[i];
+		path_rlatch(path, node);
+		bp->bbp_bound[path->blp_nr - 1] = bound;
+	}
+}
+
+M0_INTERNAL void m0_be_btree_lookup_batch(struct m0_be_btree  *tree,
+					  struct m0_be_op     *op,
+					  uint32_t             nr,
+					  const struct m0_buf *keys,
+					  struct m0_buf       *vals,
+					  int                 *rcs)
+{
+	struct btree_batch_path  bp = {};
+	struct be_btree_key_val *kv;
+	m0_bcount_t              vsize;
+	uint32_t                 i;
+
+	M0_ENTRY("tree=%p nr=%u", tree, nr);
+	M0_PRE(tree->bb_root != NULL && tree->bb_ops != NULL);
+
+	btree_op_fill(op, tree, NULL, M0_BBO_LOOKUP, NULL);
+
+	m0_be_op_active(op);
+	m0_rwlock_read_lock(btree_rwlock(tree));
+
+	for (i = 0; i < nr; ++i) {
+		M0_ASSERT(ergo(i > 0, !key_lt(tree, keys[i].b_addr,
+					      keys[i - 1].b_addr)));
+		kv = btree_batch_search(tree, &bp, keys[i].b_addr);
+		if (kv != NULL) {
+			vsize = be_btree_vsize(tree, kv->btree_val);
+			if (vals[i].b_addr == NULL) {
+				vals[i] = M0_BUF_INIT(vsize, kv->btree_val);
+			} else {
+				if (vsize < vals[i].b_nob)
+					vals[i].b_nob = vsize;
+				memcpy(vals[i].b_addr, kv->btree_val,
+				       vals[i].b_nob);
+			}
+			rcs[i] = 0;
+		} else
+			rcs[i] = -ENOENT;
+	}
+	op_tree(op)->t_rc = 0;
+
+	path_runlatch(&bp.bbp_latch);
+	m0_rwlock_read_unlock(btree_rwlock(tree));
+	m0_be_op_done(op);
+	M0_LEAVE();
+}
+
+/**
+ * Finds the leaf @key has to be inserted to and the exclusive upper bound of
+ * its key range in @bound. Returns -EEXIST if the key is in the tree.
+ */
+static int btree_batch_leaf_find(struct m0_be_btree    *tree,
+				 const void            *key,
+				 struct btree_node_pos *pos,
+				 const void           **bound)
+{
+	struct m0_be_bnode *node = tree->bb_root;
+	unsigned int        i;
+
+	*bound = NULL;
+	while (true) {
+		i = node_search(tree, node, key);
+		if (node_key_eq(tree, node, i, key))
+			return -EEXIST;
+		if (node->bt_isleaf)
+			break;
+		/* Key blobs do not move when nodes are split. */
+		if (i < node->bt_num_active_key)
+			*bound = node->bt_kv_arr[i].btree_key;
+		node = node->bt_child_arr[i];
+	}
+	pos->bnp_node  = node;
+	pos->bnp_index = i;
+	return 0;
+}
+
+M0_INTERNAL void m0_be_btree_insert_batch(struct m0_be_btree  *tree,
+					  struct m0_be_tx     *tx,
+					  struct m0_be_op     *op,
+					  uint32_t             nr,
+					  const struct m0_buf *keys,
+					  const struct m0_buf *vals,
+					  int                 *rcs)
+{
+	struct be_btree_key_val  new_kv;
+	struct btree_node_pos    pos;
+	struct m0_be_bnode      *leaf  = NULL;
+	const void              *bound = NULL;
+	uint32_t                 i;
+	int                      rc;
+
+	M0_ENTRY("tree=%p nr=%u", tree, nr);
+	M0_PRE(tree->bb_root != NULL && tree->bb_ops != NULL);
+
+	btree_op_fill(op, tree, tx, M0_BBO_INSERT, NULL);
+
+	m0_be_op_active(op);
+	m0_rwlock_write_lock(btree_rwlock(tree));
+
+	for (i = 0; i < nr; ++i) {
+		M0_PRE(keys[i].b_nob == be_btree_ksize(tree, keys[i].b_addr));
+		M0_PRE(vals[i].b_nob == be_btree_vsize(tree, vals[i].b_addr));
+		M0_ASSERT(ergo(i > 0, !key_lt(tree, keys[i].b_addr,
+					      keys[i - 1].b_addr)));
+		M0_BE_CREDIT_DEC(M0_BE_CU_BTREE_INSERT, tx);
+		/*
+		 * Keys are sorted, so the next one usually goes to the leaf
+		 * the previous one went to, which is only known to cover it
+		 * from below: check the upper bound.
+		 */
+		if (leaf == NULL ||
+		    (bound != NULL && !key_lt(tree, keys[i].b_addr, bound))) {
+			rc = btree_batch_leaf_find(tree, keys[i].b_addr,
+						   &pos, &bound);
+			leaf = rc == 0 ? pos.bnp_node : NULL;
+		} else {
+			pos.bnp_node  = leaf;
+			pos.bnp_index = node_search(tree, leaf, keys[i].b_addr);
+			rc = node_key_eq(tree, leaf, pos.bnp_index,
+					 keys[i].b_addr) ? -EEXIST : 0;
+		}
+		if (rc == 0) {
+			btree_kv_new(tree, tx, &keys[i], &vals[i], NULL,
+				     vals[i].b_nob, M0_BITS(M0_BAP_NORMAL),
+				     &new_kv);
+			if (leaf->bt_num_active_key < KV_NR) {
+				be_btree_leaf_insert(tree, tx, &pos, &new_kv);
+			} else {
+				/* Splits change the leaf, look it up again. */
+				be_btree_insert_newkey(tree, tx, &new_kv);
+				leaf = NULL;
+			}
+		} else if (rc == -EEXIST)
+			M0_LOG(M0_NOTICE, "the key entry at %p already exist",
+			       keys[i].b_addr);
+		rcs[i] = rc;
+	}
+	op_tree(op)->t_rc = 0;
+
+	m0_rwlock_write_unlock(btree_rwlock(tree));
+	m0_be_op_done(op);
+	M0_LEAVE();
+}
+
+/* ------------------------------------------------------------------
+ * Btree bulk load implementation
+ * ------------------------------------------------------------------ */
+
+#ifndef __KERNEL__
+
+enum {
+	/** Maximal number of pairs in a unit of m0_be_tx_bulk work. */
+	BTREE_BULK_CHUNK_NR   = KV_NR,
+	/** Number of chunks (i.e., about leaves) per transaction. */
+	BTREE_BULK_TX_CHUNKS  = 16,
+	BTREE_BULK_QUEUE_SIZE = 0x20,
+};
+
+/** State of a bulk load, shared by work items. */
+struct btree_bulk {
+	struct m0_be_btree *bk_tree;
+	/** Number of levels built so far. */
+	int                 bk_height;
+	/** The rightmost node of each level, the only one being filled. */
+	struct m0_be_bnode *bk_open[BTREE_HEIGHT_MAX];
+	int                 bk_rc;
+};
+
+/** Unit of m0_be_tx_bulk work: consecutive pairs copied from the source. */
+struct btree_bulk_chunk {
+	int           bc_nr;
+	/** This is the last chunk: finish the tree after it. */
+	bool          bc_last;
+	struct m0_buf bc_key[BTREE_BULK_CHUNK_NR];
+	struct m0_buf bc_val[BTREE_BULK_CHUNK_NR];
+};
+
+/**
+ * Captures the whole @node: unlike btree_node_update() this covers the first
+ * child of an internal node that has no keys yet.
+ */
+static void btree_bulk_node_update(struct m0_be_btree *tree,
+				   struct m0_be_tx    *tx,
+				   struct m0_be_bnode *node)
+{
+	m0_format_footer_update(node);
+	mem_update(tree, tx, node, node_size(node_ksize(node)));
+}
+
+/**
+ * Appends separator @kv with the right subtree @right to the rightmost node
+ * at @level, starting a new node (and, if needed, a new level) when it is
+ * full.
+ */
+static int btree_bulk_push(struct btree_bulk       *bk,
+			   struct m0_be_tx         *tx,
+			   int                      level,
+			   struct be_btree_key_val *kv,
+			   struct m0_be_bnode      *right)
+{
+	struct m0_be_btree *tree = bk->bk_tree;
+	struct m0_be_bnode *node;
+	int                 rc;
+
+	if (level == bk->bk_height) {
+		if (level == BTREE_HEIGHT_MAX)
+			return M0_ERR(-E2BIG);
+		node = be_btree_node_alloc(tree, tx);
+		be_btree_set_node_params(node, 0, level, false);
+		node->bt_child_arr[0] = bk->bk_open[level - 1];
+		bk->bk_open[level] = node;
+		bk->bk_height++;
+		/* Keep everything reachable from the root. */
+		btree_root_set(tree, node);
+		mem_update(tree, tx, tree, sizeof(struct m0_be_btree));
+	}
+	node = bk->bk_open[level];
+	if (node->bt_num_active_key < KV_NR) {
+		node_kv_set(node, node->bt_num_active_key, kv);
+		node->bt_child_arr[++node->bt_num_active_key] = right;
+		return 0;
+	}
+	node = be_btree_node_alloc(tree, tx);
+	be_btree_set_node_params(node, 0, level, false);
+	node->bt_child_arr[0] = right;
+	rc = btree_bulk_push(bk, tx, level + 1, kv, node);
+	if (rc == 0) {
+		btree_bulk_node_update(tree, tx, bk->bk_open[level]);
+		bk->bk_open[level] = node;
+	}
+	return M0_RC(rc);
+}
+
+static int btree_bulk_add(struct btree_bulk       *bk,
+			  struct m0_be_tx         *tx,
+			  struct be_btree_key_val *kv)
+{
+	struct m0_be_btree *tree = bk->bk_tree;
+	struct m0_be_bnode *leaf = bk->bk_open[0];
+	struct m0_be_bnode *next;
+	int                 rc;
+
+	M0_PRE(ergo(leaf->bt_num_active_key > 0,
+		    key_gt(tree, kv->btree_key,
+			   node_key(leaf, leaf->bt_num_active_key - 1))));
+
+	if (leaf->bt_num_active_key < KV_NR) {
+		node_kv_set(leaf, leaf->bt_num_active_key++, kv);
+		return 0;
+	}
+	/* The leaf is full: @kv separates it from the next one. */
+	next = be_btree_node_alloc(tree, tx);
+	rc = btree_bulk_push(bk, tx, 1, kv, next);
+	if (rc == 0) {
+		btree_bulk_node_update(tree, tx, leaf);
+		bk->bk_open[0] = next;
+	}
+	return M0_RC(rc);
+}
+
+/**
+ * Moves @nr keys (with children) from the left sibling of @node, which is the
+ * last child of @parent, through the parent separator.
+ */
+static void btree_bulk_rotate(struct m0_be_bnode *parent,
+			      struct m0_be_bnode *node,
+			      int                 nr)
+{
+	int                 idx  = parent->bt_num_active_key;
+	struct m0_be_bnode *left = parent->bt_child_arr[idx - 1];
+	int                 lnr  = left->bt_num_active_key;
+	int                 i;
+
+	M0_PRE(parent->bt_child_arr[idx] == node);
+	M0_PRE(nr > 0 && lnr >= nr + BTREE_FAN_OUT - 1);
+
+	for (i = node->bt_num_active_key - 1; i >= 0; --i)
+		node_kv_copy(node, i + nr, node, i);
+	if (!node->bt_isleaf) {
+		for (i = node->bt_num_active_key; i >= 0; --i)
+			node->bt_child_arr[i + nr] = node->bt_child_arr[i];
+		for (i = 0; i < nr; ++i)
+			node->bt_child_arr[i] =
+				left->bt_child_arr[lnr - nr + 1 + i];
+	}
+	for (i = 0; i < nr - 1; ++i)
+		node_kv_copy(node, i, left, lnr - nr + 1 + i);
+	node_kv_copy(node, nr - 1, parent, idx - 1);
+	node_kv_copy(parent, idx - 1, left, lnr - nr);
+	left->bt_num_active_key -= nr;
+	node->bt_num_active_key += nr;
+}
+
+/** Brings the right edge of the tree to the expected node occupancy. */
+static void btree_bulk_finish(struct btree_bulk *bk, struct m0_be_tx *tx)
+{
+	struct m0_be_btree *tree = bk->bk_tree;
+	struct m0_be_bnode *parent;
+	struct m0_be_bnode *node;
+	int                 level;
+
+	/*
+	 * Go top-down: once a node is filled up, its rightmost child has a
+	 * full left sibling under the same parent.
+	 */
+	for (level = bk->bk_height - 2; level >= 0; --level) {
+		parent = bk->bk_open[level + 1];
+		node   = bk->bk_open[level];
+		if (node->bt_num_active_key < BTREE_FAN_OUT - 1) {
+			btree_bulk_rotate(parent, node, BTREE_FAN_OUT - 1 -
+					  node->bt_num_active_key);
+			btree_bulk_node_update(tree, tx,
+				parent->bt_child_arr[
+					parent->bt_num_active_key - 1]);
+		}
+		btree_bulk_node_update(tree, tx, parent);
+	}
+	btree_bulk_node_update(tree, tx, bk->bk_open[0]);
+
+	M0_POST(btree_invariant(tree));
+	M0_POST(btree_node_invariant(tree, tree->bb_root, true));
+	M0_POST_EX(btree_node_subtree_invariant(tree, tree->bb_root));
+}
+
+static void btree_bulk_chunk_free(struct btree_bulk_chunk *chunk)
+{
+	int i;
+
+	/* Key and value of a pair share one allocation. */
+	for (i = 0; i < chunk->bc_nr; ++i)
+		m0_free(chunk->bc_key[i].b_addr);
+	m0_free(chunk);
+}
+
+static void btree_bulk_do(struct m0_be_tx_bulk *tb,
+			  struct m0_be_tx      *tx,
+			  struct m0_be_op      *op,
+			  void                 *datum,
+			  void                 *user,
+			  uint64_t              worker_index,
+			  uint64_t              partition)
+{
+	struct btree_bulk       *bk    = datum;
+	struct btree_bulk_chunk *chunk = user;
+	struct be_btree_key_val  kv;
+	int                      level;
+	int                      rc = bk->bk_rc;
+	int                      i;
+
+	m0_be_op_active(op);
+	for (i = 0; i < chunk->bc_nr && rc == 0; ++i) {
+		btree_kv_new(bk->bk_tree, tx, &chunk->bc_key[i],
+			     &chunk->bc_val[i], NULL, chunk->bc_val[i].b_nob,
+			     M0_BITS(M0_BAP_NORMAL), &kv);
+		rc = btree_bulk_add(bk, tx, &kv);
+		if (rc != 0)
+			btree_pair_release(bk->bk_tree, tx, &kv);
+	}
+	if (rc == 0 && chunk->bc_last)
+		btree_bulk_finish(bk, tx);
+	else
+		for (level = 0; level < bk->bk_height; ++level)
+			btree_bulk_node_update(bk->bk_tree, tx,
+					       bk->bk_open[level]);
+	bk->bk_rc = rc;
+	btree_bulk_chunk_free(chunk);
+	m0_be_op_done(op);
+}
+
+static void btree_bulk_done(struct m0_be_tx_bulk *tb,
+			    void                 *datum,
+			    void                 *user,
+			    uint64_t              worker_index,
+			    uint64_t              partition)
+{
+}
+
+static void btree_bulk_credit(const struct m0_be_btree *tree,
+			      struct btree_bulk_chunk  *chunk,
+			      struct m0_be_tx_credit   *accum)
+{
+	struct m0_be_tx_credit cred = {};
+	int                    i;
+
+	for (i = 0; i < chunk->bc_nr; ++i)
+		kv_insert_credit(tree, chunk->bc_key[i].b_nob,
+				 chunk->bc_val[i].b_nob, accum);
+	/* New node and updates of the old and the new one on each level. */
+	btree_node_alloc_credit(tree, &cred);
+	btree_node_update_credit(tree, &cred, 2);
+	m0_be_tx_credit_mac(accum, &cred, BTREE_HEIGHT_MAX);
+	/* New root. */
+	m0_be_tx_credit_add(accum,
+			    &M0_BE_TX_CREDIT_TYPE(struct m0_be_btree));
+	/* Rebalancing touches three nodes per level. */
+	if (chunk->bc_last)
+		btree_node_update_credit(tree, accum, 3 * BTREE_HEIGHT_MAX);
+}
+
+/** Copies the next pairs from @src into a new chunk. */
+static int btree_bulk_chunk_get(struct m0_be_btree_bulk_src  *src,
+				struct btree_bulk_chunk     **out)
+{
+	struct btree_bulk_chunk *chunk;
+	struct m0_buf            key;
+	struct m0_buf            val;
+	char                    *buf;
+	int                      rc = 0;
+
+	M0_ALLOC_PTR(chunk);
+	if (chunk == NULL)
+		return M0_ERR(-ENOMEM);
+	while (chunk->bc_nr < BTREE_BULK_CHUNK_NR) {
+		rc = src->bbs_next(src, &key, &val);
+		if (rc != 0)
+			break;
+		buf = m0_alloc(key.b_nob + val.b_nob);
+		if (buf == NULL) {
+			rc = M0_ERR(-ENOMEM);
+			break;
+		}
+		memcpy(buf, key.b_addr, key.b_nob);
+		memcpy(buf + key.b_nob, val.b_addr, val.b_nob);
+		chunk->bc_key[chunk->bc_nr] = M0_BUF_INIT(key.b_nob, buf);
+		chunk->bc_val[chunk->bc_nr] = M0_BUF_INIT(val.b_nob,
+							  buf + key.b_nob);
+		chunk->bc_nr++;
+	}
+	if (rc == -ENOENT) {
+		chunk->bc_last = true;
+		rc = 0;
+	}
+	if (rc != 0) {
+		btree_bulk_chunk_free(chunk);
+		return M0_ERR(rc);
+	}
+	*out = chunk;
+	return 0;
+}
+
+static int btree_bulk_produce(struct m0_be_btree_bulk_src *src,
+			      struct m0_be_tx_bulk        *tb,
+			      struct btree_bulk           *bk)
+{
+	struct btree_bulk_chunk *chunk;
+	struct m0_be_tx_credit   cred;
+	bool                     last;
+	bool                     put;
+	int                      rc;
+
+	do {
+		rc = btree_bulk_chunk_get(src, &chunk);
+		if (rc != 0)
+			break;
+		last = chunk->bc_last;
+		cred = M0_BE_TX_CREDIT(0, 0);
+		btree_bulk_credit(bk->bk_tree, chunk, &cred);
+		M0_BE_OP_SYNC(op, put = m0_be_tx_bulk_put(tb, &op, &cred,
+							  0, 0, chunk));
+		if (!put) {
+			/* m0_be_tx_bulk_status() tells what has happened. */
+			btree_bulk_chunk_free(chunk);
+			break;
+		}
+	} while (!last);
+	m0_be_tx_bulk_end(tb);
+	return M0_RC(rc);
+}
+
+M0_INTERNAL int m0_be_btree_bulk_load(struct m0_be_btree          *tree,
+				      struct m0_be_domain         *dom,
+				      struct m0_be_btree_bulk_src *src)
+{
+	struct m0_be_tx_bulk_cfg tb_cfg;
+	struct m0_be_tx_bulk     tb = {};
+	struct btree_bulk        bk = {
+		.bk_tree   = tree,
+		.bk_height = 1,
+	};
+	int                      rc;
+
+	M0_ENTRY("tree=%p", tree);
+	M0_PRE(tree->bb_root != NULL && tree->bb_root->bt_isleaf &&
+	       tree->bb_root->bt_num_active_key == 0);
+	M0_PRE(btree_invariant(tree));
+
+	bk.bk_open[0] = tree->bb_root;
+	/* A single worker applies chunks in the source order. */
+	tb_cfg = (struct m0_be_tx_bulk_cfg){
+		.tbc_q_cfg                 = {
+			.bqc_q_size_max       = BTREE_BULK_QUEUE_SIZE,
+			.bqc_producers_nr_max = 1,
+		},
+		.tbc_workers_nr            = 1,
+		.tbc_partitions_nr         = 1,
+		.tbc_work_items_per_tx_max = BTREE_BULK_TX_CHUNKS,
+		.tbc_dom                   = dom,
+		.tbc_datum                 = &bk,
+		.tbc_do                    = &btree_bulk_do,
+		.tbc_done                  = &btree_bulk_done,
+	};
+	m0_rwlock_write_lock(btree_rwlock(tree));
+	rc = m0_be_tx_bulk_init(&tb, &tb_cfg);
+	if (rc == 0) {
+		M0_BE_OP_SYNC(op, ({
+			m0_be_tx_bulk_run(&tb, &op);
+			rc = btree_bulk_produce(src, &tb, &bk);
+		}));
+		rc = rc ?: m0_be_tx_bulk_status(&tb) ?: bk.bk_rc;
+		m0_be_tx_bulk_fini(&tb);
+	}
+	m0_rwlock_write_unlock(btree_rwlock(tree));
+	return M0_RC(rc);
+}
+
+#endif /* __KERNEL__ */
+
 
 /* ------------------------------------------------------------------
  * Btree external inplace interfaces implementation
@@ -2111,7 +3505,7 @@ M0_INTERNAL void m0_be_btree_update_inplace(struct m0_be_btree        *tree,
 
 	anchor->ba_write = true;
 	anchor->ba_tree  = tree;
-	kv = be_btree_search(tree, key->b_addr);
+	kv = be_btree_search(tree, key->b_addr, NULL);
 	if (kv != NULL) {
 		M0_ASSERT(anchor->ba_value.b_nob <=
 			  be_btree_vsize(tree, kv->btree_val));
@@ -2155,6 +3549,7 @@ M0_INTERNAL void m0_be_btree_lookup_inplace(struct m0_be_btree        *tree,
 					    struct m0_be_btree_anchor *anchor)
 {
 	struct be_btree_key_val  *kv;
+	struct btree_latch_path   path = {};
 
 	M0_ENTRY("tree=%p", tree);
 	M0_PRE(tree->bb_root != NULL && tree->bb_ops != NULL);
@@ -2166,12 +3561,17 @@ M0_INTERNAL void m0_be_btree_lookup_inplace(struct m0_be_btree        *tree,
 
 	anchor->ba_tree = tree;
 	anchor->ba_write = false;
-	kv = be_btree_search(tree, key->b_addr);
+	/*
+	 * Values are never moved by concurrent inserts, so holding bb_lock in
+	 * shared mode is enough to keep the value until m0_be_btree_release().
+	 */
+	kv = be_btree_search(tree, key->b_addr, &path);
 	if (kv == NULL)
 		op_tree(op)->t_rc = -ENOENT;
 	else
 		m0_buf_init(&anchor->ba_value, kv->btree_val,
 			    be_btree_vsize(tree, kv->btree_val));
+	path_runlatch(&path);
 
 	m0_be_op_done(op);
 	M0_LEAVE();
@@ -2296,6 +3696,7 @@ M0_INTERNAL void m0_be_btree_cursor_get(struct m0_be_btree_cursor *cur,
 					const struct m0_buf *key, bool slant)
 {
 	struct btree_node_pos     last;
+	struct btree_latch_path   path = {};
 	struct be_btree_key_val   *kv;
 	struct m0_be_op    *op   = &cur->bc_op;
 	struct m0_be_btree *tree = cur->bc_tree;
@@ -2305,7 +3706,7 @@ M0_INTERNAL void m0_be_btree_cursor_get(struct m0_be_btree_cursor *cur,
 	m0_be_op_active(op);
 	m0_rwlock_read_lock(btree_rwlock(tree));
 
-	last = be_btree_get_btree_node(cur, key->b_addr, slant);
+	last = be_btree_get_btree_node(cur, key->b_addr, slant, &path);
 
 	if (last.bnp_node == NULL) {
 		M0_SET0(&op_tree(op)->t_out_val);
@@ -2324,6 +3725,7 @@ M0_INTERNAL void m0_be_btree_cursor_get(struct m0_be_btree_cursor *cur,
 		op_tree(op)->t_rc = 0;
 	}
 
+	path_runlatch(&path);
 	m0_rwlock_read_unlock(btree_rwlock(tree));
 	m0_be_op_done(op);
 }
@@ -2358,6 +3760,7 @@ M0_INTERNAL int m0_be_btree_cursor_last_sync(struct m0_be_btree_cursor *cur)
 M0_INTERNAL void m0_be_btree_cursor_next(struct m0_be_btree_cursor *cur)
 {
 	struct be_btree_key_val   *kv;
+	struct btree_latch_path    path = {};
 	struct m0_be_op    *op   = &cur->bc_op;
 	struct m0_be_btree *tree = cur->bc_tree;
 	struct m0_be_bnode *node;
@@ -2375,13 +3778,20 @@ M0_INTERNAL void m0_be_btree_cursor_next(struct m0_be_btree_cursor *cur)
 
 	/* cursor move */
 	++cur->bc_pos;
+	path_rlatch(&path, node);
 	if (node->bt_isleaf) {
-		while (node && cur->bc_pos >= node->bt_num_active_key)
+		while (node && cur->bc_pos >= node->bt_num_active_key) {
+			/* Never latch a parent while holding a child. */
+			path_runlatch(&path);
 			node = node_pop(cur, &cur->bc_pos);
+			if (node != NULL)
+				path_rlatch(&path, node);
+		}
 	} else {
 		for (;;) {
 			node_push(cur, node, cur->bc_pos);
 			node = node->bt_child_arr[cur->bc_pos];
+			path_rlatch(&path, node);
 			cur->bc_pos = 0;
 			if (node->bt_isleaf)
 				break;
@@ -2404,6 +3814,7 @@ M0_INTERNAL void m0_be_btree_cursor_next(struct m0_be_btree_cursor *cur)
 	m0_buf_init(&op_tree(op)->t_out_key, kv->btree_key,
 		    be_btree_ksize(tree, kv->btree_key));
 out:
+	path_runlatch(&path);
 	m0_rwlock_read_unlock(btree_rwlock(tree));
 	m0_be_op_done(op);
 }
@@ -2411,6 +3822,7 @@ out:
 M0_INTERNAL void m0_be_btree_cursor_prev(struct m0_be_btree_cursor *cur)
 {
 	struct be_btree_key_val   *kv;
+	struct btree_latch_path    path = {};
 	struct m0_be_op    *op   = &cur->bc_op;
 	struct m0_be_btree *tree = cur->bc_tree;
 	struct m0_be_bnode *node;
@@ -2423,16 +3835,21 @@ M0_INTERNAL void m0_be_btree_cursor_prev(struct m0_be_btree_cursor *cur)
 	node = cur->bc_node;
 
 	/* cursor move */
+	path_rlatch(&path, node);
 	if (node->bt_isleaf) {
 		--cur->bc_pos;
 		while (node && cur->bc_pos < 0) {
+			path_runlatch(&path);
 			node = node_pop(cur, &cur->bc_pos);
+			if (node != NULL)
+				path_rlatch(&path, node);
 			--cur->bc_pos;
 		}
 	} else {
 		for (;;) {
 			node_push(cur, node, cur->bc_pos);
 			node = node->bt_child_arr[cur->bc_pos];
+			path_rlatch(&path, node);
 			if (node->bt_isleaf) {
 				cur->bc_pos = node->bt_num_active_key - 1;
 				break;
@@ -2457,6 +3874,7 @@ M0_INTERNAL void m0_be_btree_cursor_prev(struct m0_be_btree_cursor *cur)
 	m0_buf_init(&op_tree(op)->t_out_key, kv->btree_key,
 		    be_btree_ksize(tree, kv->btree_key));
 out:
+	path_runlatch(&path);
 	m0_rwlock_read_unlock(btree_rwlock(tree));
 	m0_be_op_done(op);
 }
@@ -70,7 +70,15 @@ struct m0_be_btree {
 	/*
 	 * volatile-only fields
 	 */
-	/** The lock to acquire when performing operations on the tree. */
+	/**
+	 * The lock to acquire when performing operations on the tree.
+	 *
+	 * Lookups, cursor operations and plain inserts take it in shared
+	 * mode and synchronise with each other through per-node latches
+	 * (see "Node latching" in be/btree.c). Operations that restructure
+	 * the tree (deletes, root splits, truncate, destroy) and in-place
+	 * updates take it exclusively.
+	 */
 	struct m0_be_rwlock              bb_lock;
 	/** The segment where we are stored. */
 	struct m0_be_seg                *bb_seg;
@@ -80,12 +88,19 @@ struct m0_be_btree {
 
 enum m0_be_btree_format_version {
 	M0_BE_BTREE_FORMAT_VERSION_1 = 1,
+	/**
+	 * Tree which nodes keep fixed-size keys inline, see
+	 * m0_be_btree_kv_ops::ko_inline_ksize.
+	 */
+	M0_BE_BTREE_FORMAT_VERSION_2,
 
 	/* future versions, uncomment and update M0_BE_BTREE_FORMAT_VERSION */
-	/*M0_BE_BTREE_FORMAT_VERSION_2,*/
 	/*M0_BE_BTREE_FORMAT_VERSION_3,*/
 
-	/** Current version, should point to the latest version present */
+	/**
+	 * Version of trees without inline keys. Version 2 is selected per tree
+	 * type by m0_be_btree_kv_ops::ko_inline_ksize.
+	 */
 	M0_BE_BTREE_FORMAT_VERSION = M0_BE_BTREE_FORMAT_VERSION_1
 };
 
@@ -111,6 +126,38 @@ struct m0_be_btree_kv_ops {
 	 * XXX RENAMEME? s/ko_compare/ko_key_cmp/
 	 */
 	int         (*ko_compare)(const void *key0, const void *key1);
+	/**
+	 * Size of keys, if all keys of the tree have the same size not larger
+	 * than BTREE_INLINE_KEY_MAX, 0 otherwise.
+	 *
+	 * Trees created with non-zero ko_inline_ksize have
+	 * M0_BE_BTREE_FORMAT_VERSION_2 format: their nodes keep copies of the
+	 * keys, so that node search does not dereference a pointer per key.
+	 * Existing trees keep the format they were created with.
+	 */
+	m0_bcount_t   ko_inline_ksize;
+	/**
+	 * Bit-mask of m0_be_btree_kv_flags, describing key ordering, which
+	 * allows node search to compare inline keys without ko_compare()
+	 * calls.
+	 */
+	uint64_t      ko_flags;
+};
+
+/** Flags of m0_be_btree_kv_ops::ko_flags. */
+enum m0_be_btree_kv_flags {
+	/**
+	 * Keys are uint64_t numbers in native byte order, ko_compare()
+	 * compares them numerically. Requires
+	 * ko_inline_ksize == sizeof(uint64_t).
+	 */
+	M0_BKF_U64  = 1 << 0,
+	/**
+	 * Keys are pairs of uint64_t numbers, compared as struct m0_uint128 or
+	 * struct m0_fid are: the first number, then the second one. Requires
+	 * ko_inline_ksize == 2 * sizeof(uint64_t).
+	 */
+	M0_BKF_U128 = 1 << 1,
 };
 
 /** Stored in m0_be_btree_backlink::bl_type */
@@ -139,10 +186,10 @@ enum m0_be_btree_type {
 enum m0_be_btree_op {
 	M0_BBO_CREATE,	    /**< Used for m0_be_btree_create() */
 	M0_BBO_DESTROY,     /**< .. m0_be_btree_destroy() */
-	M0_BBO_INSERT,      /**< .. m0_be_btree_{,inplace_}insert() */
-	M0_BBO_DELETE,      /**< .. m0_be_btree_{,inplace_}delete() */
+	M0_BBO_INSERT,      /**< .. m0_be_btree_{,inplace_}insert{,_batch}() */
+	M0_BBO_DELETE,      /**< .. m0_be_btree_{,inplace_}delete{,_range}() */
 	M0_BBO_UPDATE,      /**< .. m0_be_btree_{,inplace_}update() */
-	M0_BBO_LOOKUP,      /**< .. m0_be_btree_lookup() */
+	M0_BBO_LOOKUP,      /**< .. m0_be_btree_lookup{,_batch}() */
 	M0_BBO_MAXKEY,      /**< .. m0_be_btree_maxkey() */
 	M0_BBO_MINKEY,      /**< .. m0_be_btree_minkey() */
 	M0_BBO_CURSOR_GET,  /**< .. m0_be_btree_cursor_get() */
@@ -153,6 +200,10 @@ enum m0_be_btree_op {
 /** Btree fid type */
 M0_EXTERN const struct m0_fid_type m0_btree_fid_type;
 
+/** Initialises btree module (node latches). */
+M0_INTERNAL int  m0_be_btree_mod_init(void);
+M0_INTERNAL void m0_be_btree_mod_fini(void);
+
 
 /* ------------------------------------------------------------------
  * Btree construction
@@ -290,6 +341,21 @@ M0_INTERNAL void m0_be_btree_insert_credit2(const struct m0_be_btree *tree,
 					    m0_bcount_t vsize,
 					    struct m0_be_tx_credit *accum);
 
+/**
+ * Calculates the credit of a single m0_be_btree_delete_range() call over the
+ * @tree. The credit does not depend on the number of records in the range.
+ *
+ * The credit also covers the destruction of the empty @dst tree the call
+ * leaves behind if the range is empty.
+ *
+ * @param ksize  Key data size.
+ * @param vsize  Value data size.
+ */
+M0_INTERNAL void m0_be_btree_delete_range_credit(const struct m0_be_btree *tree,
+						 m0_bcount_t ksize,
+						 m0_bcount_t vsize,
+						 struct m0_be_tx_credit *accum);
+
 /**
  * Calculates how many internal resources of tx_engine, described by
  * m0_be_tx_credit, is needed to perform the delete operation over the @tree.
@@ -404,6 +470,39 @@ M0_INTERNAL void m0_be_btree_delete(struct m0_be_btree *tree,
 				    struct m0_be_op *op,
 				    const struct m0_buf *key);
 
+/**
+ * Removes entries with keys in [@lo, @hi) from btree by cutting whole
+ * subtrees out of it. Operation is asynchronous.
+ *
+ * NULL @lo and @hi stand for the open lower and upper bounds respectively.
+ *
+ * A call makes a single cut: it finds the node closest to the root that has
+ * at least two keys in the range and moves the subtrees between them to @dst,
+ * then rebalances the path to that node. The work done and the transaction
+ * credit, see m0_be_btree_delete_range_credit(), are bounded by the tree
+ * height, not by the number of entries removed.
+ *
+ * @dst is an empty tree, created with the same ops in the same segment. After
+ * the call it holds the removed entries and has to be disposed of by the
+ * caller with m0_be_btree_truncate() and m0_be_btree_destroy(), possibly in
+ * the background. Its nodes, except for the root, keep the backlink of @tree,
+ * so @dst can only be truncated or destroyed.
+ *
+ * The number of removed entries is returned in @nr. @nr is 0 iff there are no
+ * entries in the range, so a range is removed completely by repeating the
+ * call, in a new transaction and with a new @dst, until @nr is 0. Unlike
+ * m0_be_btree_truncate(), @tree stays usable between the calls.
+ *
+ * @see m0_be_btree_delete()
+ */
+M0_INTERNAL void m0_be_btree_delete_range(struct m0_be_btree  *tree,
+					  struct m0_be_tx     *tx,
+					  struct m0_be_op     *op,
+					  const struct m0_buf *lo,
+					  const struct m0_buf *hi,
+					  struct m0_be_btree  *dst,
+					  m0_bcount_t         *nr);
+
 /**
  * Looks up for a @dest_value by the given @key in btree.
  * The result is copied into provided @dest_value buffer.
@@ -447,6 +546,88 @@ M0_INTERNAL void m0_be_btree_maxkey(struct m0_be_btree *tree,
 M0_INTERNAL void m0_be_btree_minkey(struct m0_be_btree *tree,
 				    struct m0_be_op *op,
 				    struct m0_buf *out);
+
+/**
+ * Looks up @nr @keys at once, copying found values into @vals as
+ * m0_be_btree_lookup() does and setting @rcs[i] to 0 or -ENOENT.
+ *
+ * If @vals[i].b_addr is NULL, @vals[i] is set to the value in the tree
+ * instead, as m0_be_btree_lookup_inplace() does. The tree lock is not held
+ * on return, so the caller has to keep the record from being modified while
+ * it uses the value.
+ *
+ * Keys must be sorted in non-decreasing order. The tree lock is taken once
+ * per batch and each descent starts from the deepest node on the path to the
+ * previous key that covers the next one, so keys close to each other share
+ * the walk from the root.
+ *
+ * @op->bo_u.u_btree.t_rc is set to 0.
+ */
+M0_INTERNAL void m0_be_btree_lookup_batch(struct m0_be_btree  *tree,
+					  struct m0_be_op     *op,
+					  uint32_t             nr,
+					  const struct m0_buf *keys,
+					  struct m0_buf       *vals,
+					  int                 *rcs);
+
+/**
+ * Inserts @nr pairs of @keys and @vals, setting @rcs[i] to 0 or -EEXIST.
+ *
+ * Keys must be sorted in non-decreasing order. The tree is locked once per
+ * batch and consecutive keys going to the same leaf are inserted without a
+ * descent from the root.
+ *
+ * Credits have to be calculated by m0_be_btree_insert_credit() for @nr
+ * records. @op->bo_u.u_btree.t_rc is set to 0.
+ */
+M0_INTERNAL void m0_be_btree_insert_batch(struct m0_be_btree  *tree,
+					  struct m0_be_tx     *tx,
+					  struct m0_be_op     *op,
+					  uint32_t             nr,
+					  const struct m0_buf *keys,
+					  const struct m0_buf *vals,
+					  int                 *rcs);
+
+/* ------------------------------------------------------------------
+ * Btree bulk load
+ * ------------------------------------------------------------------ */
+
+#ifndef __KERNEL__
+struct m0_be_domain;
+
+/** Source of sorted key-value pairs for m0_be_btree_bulk_load(). */
+struct m0_be_btree_bulk_src {
+	/**
+	 * Returns the next pair in @key and @val, -ENOENT after the last pair
+	 * or another negative error code.
+	 *
+	 * Keys have to be returned in strictly increasing order. Memory @key
+	 * and @val point to has to stay valid only until the next call.
+	 */
+	int (*bbs_next)(struct m0_be_btree_bulk_src *src,
+			struct m0_buf               *key,
+			struct m0_buf               *val);
+};
+
+/**
+ * Populates empty @tree with all pairs returned by @src.
+ *
+ * The tree is built bottom-up: pairs are appended to the rightmost leaf and
+ * separators to the rightmost nodes of upper levels, so that nodes are filled
+ * completely and no splits happen. Only the rightmost node of each level is
+ * rebalanced at the end. Work is done in transactions of @dom, opened by
+ * m0_be_tx_bulk, each covering several leaves.
+ *
+ * The tree must not be accessed by other users until the function returns.
+ * On failure the tree keeps the pairs loaded so far, but nodes on its right
+ * edge can be underfilled, so that it can only be truncated or destroyed.
+ *
+ * @note Not available in the kernel: m0_be_tx_bulk is user space only.
+ */
+M0_INTERNAL int m0_be_btree_bulk_load(struct m0_be_btree          *tree,
+				      struct m0_be_domain         *dom,
+				      struct m0_be_btree_bulk_src *src);
+#endif /* __KERNEL__ */
 
 /* ------------------------------------------------------------------
  * Btree in-place manipulation
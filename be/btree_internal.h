@@ -38,6 +38,8 @@
 /* btree constants */
 enum {
 	KV_NR = 2 * BTREE_FAN_OUT - 1,
+	/** Maximal size of a key kept inline in version 2 nodes. */
+	BTREE_INLINE_KEY_MAX = 64,
 };
 
 struct be_btree_key_val  {
@@ -53,21 +55,47 @@ struct m0_be_bnode {
 	unsigned int                 bt_num_active_key;/* Count of active keys */
 	unsigned int                 bt_level;   /* Level of node in B-Tree */
 	bool                         bt_isleaf;  /* Is this Leaf node? */
-	char                         bt_pad[7];  /* Used to padd */
+	char                         bt_pad[3];  /* Used to padd */
+	uint32_t                     bt_ksize;   /* Inline key slot size (v2) */
 	struct be_btree_key_val      bt_kv_arr[KV_NR]; /* Array of key-vals */
 	struct m0_be_bnode          *bt_child_arr[KV_NR + 1]; /* childnode array */
 	struct m0_format_footer      bt_footer;  /* Footer of node */
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 M0_BASSERT(sizeof(bool) == 1);
 
+/*
+ * Version 2 nodes (M0_BE_BNODE_FORMAT_VERSION_2) are used by trees created
+ * with M0_BE_BTREE_FORMAT_VERSION_2, i.e., by trees which kv_ops define
+ * m0_be_btree_kv_ops::ko_inline_ksize. Such a node is followed by KV_NR
+ * key slots of bt_ksize bytes each and by a footer:
+ *
+ * @verbatim
+ * +--------------------+---------+---------+-----+----------------+--------+
+ * | struct m0_be_bnode | key[0]  | key[1]  | ... | key[KV_NR - 1] | footer |
+ * +--------------------+---------+---------+-----+----------------+--------+
+ * @endverbatim
+ *
+ * Key slot i holds a copy of the key bt_kv_arr[i].btree_key points to, so
+ * that node search compares keys within the node instead of dereferencing a
+ * pointer per key. The slot is only a search cache: keys are still allocated
+ * together with their values, so key pointers handed out by the tree stay
+ * valid while slots move between and within nodes. bt_footer is not used in
+ * version 2 nodes: node header points to the trailing footer, which covers
+ * the key slots too.
+ */
+
 enum m0_be_bnode_format_version {
 	M0_BE_BNODE_FORMAT_VERSION_1 = 1,
+	/** Node with inline key slots, see above. */
+	M0_BE_BNODE_FORMAT_VERSION_2,
 
 	/* future versions, uncomment and update M0_BE_BNODE_FORMAT_VERSION */
-	/*M0_BE_BNODE_FORMAT_VERSION_2,*/
 	/*M0_BE_BNODE_FORMAT_VERSION_3,*/
 
-	/** Current version, should point to the latest version present */
+	/**
+	 * Version of nodes without inline keys. Version 2 nodes are created
+	 * only for trees which ask for them.
+	 */
 	M0_BE_BNODE_FORMAT_VERSION = M0_BE_BNODE_FORMAT_VERSION_1
 };
 
@@ -238,6 +238,16 @@ static int be_domain_seg_open(struct m0_be_domain *dom,
 		m0_be_seg_init(seg, stob, dom, M0_BE_SEG_FAKE_ID);
 		m0_stob_put(stob);
 		rc = m0_be_seg_open(seg);
+		if (rc == 0 &&
+		    dom->bd_cfg.bc_seg_paging.bspc_resident_max != 0) {
+			rc = m0_be_seg_paging_start(seg,
+						    &dom->bd_cfg.bc_seg_paging);
+			if (rc != 0) {
+				M0_LOG(M0_WARN, "can't start segment paging, "
+				       "seg=%p rc=%d", seg, rc);
+				rc = 0;
+			}
+		}
 		if (rc == 0) {
 			(void)m0_be_allocator_init(m0_be_seg_allocator(seg),
 						   seg);
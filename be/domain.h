@@ -101,6 +101,11 @@ struct m0_be_domain_cfg {
 	 * The sum of all array elements should be 100.
 	 */
 	uint32_t                     bc_zone_pcnt[M0_BAP_NR];
+	/**
+	 * Paging configuration for every segment of the domain.
+	 * Segments are not paged out if bspc_resident_max is 0.
+	 */
+	struct m0_be_seg_paging_cfg  bc_seg_paging;
 
 	/*
 	 * Next fields are for mkfs mode only.
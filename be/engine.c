@@ -29,6 +29,10 @@
 #include "lib/errno.h"          /* ENOMEM */
 #include "lib/misc.h"           /* m0_forall */
 #include "lib/time.h"           /* m0_time_now */
+#include "addb2/addb2.h"        /* M0_ADDB2_ADD */
+
+#include "be/addb2.h"           /* M0_AVI_BE_GROUP_CTL */
+#include "be/pd.h"              /* m0_be_pd_sync_cost */
 
 #include "be/tx_service.h"      /* m0_be_tx_service_init */
 #include "be/tx_group.h"        /* m0_be_tx_group */
@@ -156,7 +160,10 @@ M0_INTERNAL int m0_be_engine_init(struct m0_be_engine     *en,
 		  (etx_tlist_init(&en->eng_txs[i]), true));
 
 	m0_semaphore_init(&en->eng_recovery_wait_sem, 0);
-	en->eng_recovery_finished = false;
+	en->eng_recovery_finished    = false;
+	en->eng_recovery_seq_next    = 0;
+	en->eng_recovery_seq_reapply = 0;
+	en->eng_ctl = (struct m0_be_engine_ctl){ .bect_tx_nr = 1 };
 
 	M0_POST(m0_be_engine__invariant(en));
 	return M0_RC(0);
@@ -417,6 +424,73 @@ static void be_engine_group_tryclose(struct m0_be_engine   *en,
 	}
 }
 
+enum {
+	/** Weight of a new sample in the group controller averages is 1/8. */
+	BE_ENGINE_CTL_EWMA_SHIFT = 3,
+};
+
+static void be_engine_ctl_sample(m0_time_t *avg, m0_time_t sample)
+{
+	*avg = *avg == 0 ? sample :
+	       *avg - (*avg >> BE_ENGINE_CTL_EWMA_SHIFT) +
+	       (sample >> BE_ENGINE_CTL_EWMA_SHIFT);
+}
+
+/** Is called when a transaction is added to a group. */
+static void be_engine_ctl_arrival(struct m0_be_engine *en)
+{
+	struct m0_be_engine_ctl *ctl = &en->eng_ctl;
+	m0_time_t                now = m0_time_now();
+
+	M0_PRE(be_engine_is_locked(en));
+
+	if (ctl->bect_arrival_last != 0) {
+		be_engine_ctl_sample(&ctl->bect_arrival,
+			min_check(now - ctl->bect_arrival_last,
+				  en->eng_cfg->bec_group_freeze_timeout_max));
+	}
+	ctl->bect_arrival_last = now;
+}
+
+/**
+ * Chooses number of transactions per group and group freeze timeout.
+ *
+ * @see m0_be_engine_ctl
+ */
+static void be_engine_ctl_update(struct m0_be_engine *en)
+{
+	struct m0_be_engine_ctl *ctl   = &en->eng_ctl;
+	struct m0_be_engine_cfg *cfg   = en->eng_cfg;
+	m0_time_t                t_min = cfg->bec_group_freeze_timeout_min;
+	m0_time_t                sync;
+	m0_time_t                cost;
+	m0_time_t                arrival;
+	uint64_t                 tx_nr;
+
+	M0_PRE(be_engine_is_locked(en));
+
+	sync    = cfg->bec_pd == NULL ? 0 : m0_be_pd_sync_cost(cfg->bec_pd);
+	cost    = max_check(ctl->bect_log_latency, sync);
+	arrival = max_check(ctl->bect_arrival, (m0_time_t)1);
+	tx_nr   = min_check(max_check(cost / arrival, (uint64_t)1),
+			    (uint64_t)cfg->bec_group_cfg.tgc_tx_nr_max);
+
+	ctl->bect_tx_nr = tx_nr;
+	ctl->bect_delay = tx_nr == 1 ? t_min :
+		min_check(max_check(arrival * tx_nr, t_min),
+			  cfg->bec_group_freeze_timeout_limit);
+	M0_ADDB2_ADD(M0_AVI_BE_GROUP_CTL, ctl->bect_arrival,
+		     ctl->bect_log_latency, sync, tx_nr, ctl->bect_delay);
+}
+
+M0_INTERNAL void m0_be_engine__group_logged(struct m0_be_engine *en,
+					    m0_time_t            latency)
+{
+	be_engine_lock(en);
+	be_engine_ctl_sample(&en->eng_ctl.bect_log_latency, latency);
+	be_engine_unlock(en);
+}
+
 static void be_engine_group_timeout_arm(struct m0_be_engine   *en,
                                         struct m0_be_tx_group *gr)
 {
@@ -432,10 +506,17 @@ static void be_engine_group_timeout_arm(struct m0_be_engine   *en,
 
 	grouping_q_length = etx_tlist_length(&en->eng_txs[M0_BTS_GROUPING]);
 	M0_ASSERT(grouping_q_length > 0);
-	tx_per_group_max = en->eng_cfg->bec_group_cfg.tgc_tx_nr_max;
-	grouping_q_length = min_check(grouping_q_length, tx_per_group_max);
-	delay = t_min + (t_max - t_min) * grouping_q_length / tx_per_group_max;
-	delay = min_check(delay, en->eng_cfg->bec_group_freeze_timeout_limit);
+	if (en->eng_cfg->bec_group_adaptive) {
+		delay = en->eng_ctl.bect_delay;
+	} else {
+		tx_per_group_max = en->eng_cfg->bec_group_cfg.tgc_tx_nr_max;
+		grouping_q_length = min_check(grouping_q_length,
+					      tx_per_group_max);
+		delay = t_min + (t_max - t_min) * grouping_q_length /
+			tx_per_group_max;
+		delay = min_check(delay,
+				  en->eng_cfg->bec_group_freeze_timeout_limit);
+	}
 	gr->tg_close_deadline = m0_time_now() + delay;
 	gr->tg_close_timer_arm.sa_cb = &be_engine_group_timer_arm;
 	m0_sm_ast_post(sm_grp, &gr->tg_close_timer_arm);
@@ -453,6 +534,7 @@ static int be_engine_tx_trygroup(struct m0_be_engine *en,
 				 struct m0_be_tx     *tx)
 {
 	struct m0_be_tx_group *gr;
+	bool                   adaptive = en->eng_cfg->bec_group_adaptive;
 	int                    rc = -EBUSY;
 
 	M0_PRE(be_engine_is_locked(en));
@@ -477,9 +559,16 @@ static int be_engine_tx_trygroup(struct m0_be_engine *en,
 			if (rc == 0)
 				m0_be_tx__group_assign(tx, gr);
 		}
+		if (rc == 0 && adaptive) {
+			be_engine_ctl_arrival(en);
+			if (m0_be_tx_group_tx_nr(gr) == 1)
+				be_engine_ctl_update(en);
+		}
 		if (rc == -EXFULL ||
 		    m0_be_tx__is_fast(tx) ||
-		    m0_be_tx__is_exclusive(tx)) {
+		    m0_be_tx__is_exclusive(tx) ||
+		    (rc == 0 && adaptive &&
+		     m0_be_tx_group_tx_nr(gr) >= en->eng_ctl.bect_tx_nr)) {
 			be_engine_group_freeze(en, gr);
 		} else if (rc == 0 && m0_be_tx_group_tx_nr(gr) == 1) {
 			be_engine_group_timeout_arm(en, gr);
@@ -510,6 +599,7 @@ static void be_engine_recovery_finish(struct m0_be_engine *en)
 	M0_PRE(be_engine_is_locked(en));
 
 	en->eng_recovery_finished = true;
+	m0_be_log_recovery_finished(&en->eng_log);
 	m0_semaphore_up(&en->eng_recovery_wait_sem);
 }
 
@@ -526,6 +616,7 @@ static void be_engine_try_recovery(struct m0_be_engine *en)
 		if (gr == NULL)
 			break;
 		m0_be_tx_group_recovery_prepare(gr, &en->eng_log);
+		gr->tg_recovery_seq = en->eng_recovery_seq_next++;
 		be_engine_group_freeze(en, gr);
 		be_engine_group_tryclose(en, gr);
 		group_recovery_started = true;
@@ -751,6 +842,41 @@ M0_INTERNAL void m0_be_engine__tx_group_ready(struct m0_be_engine   *en,
 	M0_LEAVE();
 }
 
+M0_INTERNAL bool
+m0_be_engine__recovery_reapply_may(struct m0_be_engine   *en,
+				   struct m0_be_tx_group *gr)
+{
+	bool result;
+
+	be_engine_lock(en);
+	M0_PRE(m0_be_tx_group_is_recovering(gr));
+	M0_PRE(gr->tg_recovery_seq >= en->eng_recovery_seq_reapply);
+	result = gr->tg_recovery_seq == en->eng_recovery_seq_reapply;
+	be_engine_unlock(en);
+	return result;
+}
+
+M0_INTERNAL void m0_be_engine__recovery_placed(struct m0_be_engine   *en,
+					       struct m0_be_tx_group *gr)
+{
+	size_t i;
+
+	M0_ENTRY("en=%p gr=%p seq=%"PRIu64, en, gr, gr->tg_recovery_seq);
+	be_engine_lock(en);
+	M0_PRE(gr->tg_recovery_seq == en->eng_recovery_seq_reapply);
+	++en->eng_recovery_seq_reapply;
+	for (i = 0; i < en->eng_group_nr; ++i) {
+		gr = &en->eng_group[i];
+		if (m0_be_tx_group_is_recovering(gr) &&
+		    gr->tg_recovery_seq == en->eng_recovery_seq_reapply) {
+			m0_be_tx_group_fom_reapply(&gr->tg_fom);
+			break;
+		}
+	}
+	be_engine_unlock(en);
+	M0_LEAVE();
+}
+
 static void be_engine_group_stop_nr(struct m0_be_engine *en, size_t nr)
 {
 	size_t i;
@@ -793,6 +919,7 @@ M0_INTERNAL int m0_be_engine_start(struct m0_be_engine *en)
 {
 	m0_time_t recovery_time = 0;
 	int       rc = 0;
+	size_t    recovery_group_nr;
 	size_t    i;
 
 	M0_ENTRY();
@@ -800,19 +927,25 @@ M0_INTERNAL int m0_be_engine_start(struct m0_be_engine *en)
 	M0_PRE(be_engine_invariant(en));
 
 	/*
-	 * Run BE recovery having only one group.
-	 * This prevents having m0_be_tx_group_reapply() called in wrong order,
-	 * i.e. not in the same order as corresponding log records in the log.
-	 * See EOS-7888 and linked tickets for an example of what happens if
-	 * the order of m0_be_tx_group_reapply() is wrong.
-	 *
-	 * An alternative solution would be to enforce the right order for
-	 * m0_be_tx_group_reapply(), but with group rewrite this solution
-	 * wouldn't be needed anymore. One group for recovery is just easier.
+	 * Run BE recovery having bec_recovery_group_nr groups.
+	 * m0_be_tx_group_reapply() has to be called in the same order as
+	 * corresponding log records are in the log. See EOS-7888 and linked
+	 * tickets for an example of what happens if the order of
+	 * m0_be_tx_group_reapply() is wrong. The order is enforced using
+	 * m0_be_tx_group::tg_recovery_seq, see
+	 * m0_be_engine__recovery_reapply_may().
 	 */
-	rc = be_engine_group_start(en, 0);
-	if (rc != 0)
-		return M0_ERR(rc);
+	recovery_group_nr = min_check(max_check(en->eng_cfg->
+						bec_recovery_group_nr, 1UL),
+				      en->eng_group_nr);
+	for (i = 0; i < recovery_group_nr; ++i) {
+		rc = be_engine_group_start(en, i);
+		if (rc != 0) {
+			be_engine_group_stop_nr(en, i);
+			be_engine_unlock(en);
+			return M0_ERR(rc);
+		}
+	}
 
 	recovery_time = m0_time_now();
 	be_engine_try_recovery(en);
@@ -833,7 +966,7 @@ M0_INTERNAL int m0_be_engine_start(struct m0_be_engine *en)
 		/* XXX workaround END */
 	}
 	be_engine_lock(en);
-	for (i = 1; i < en->eng_group_nr; ++i) {
+	for (i = recovery_group_nr; i < en->eng_group_nr; ++i) {
 		rc = be_engine_group_start(en, i);
 		if (rc != 0)
 			break;
@@ -80,10 +80,26 @@ struct m0_be_engine_cfg {
 	m0_time_t		   bec_group_freeze_timeout_min;
 	m0_time_t		   bec_group_freeze_timeout_max;
 	m0_time_t                  bec_group_freeze_timeout_limit;
+	/**
+	 * Group freeze timeout and number of transactions per group are chosen
+	 * by the group controller instead of the formula in
+	 * be_engine_group_timeout_arm(). The timeout stays within
+	 * [bec_group_freeze_timeout_min, bec_group_freeze_timeout_limit] and
+	 * the number of transactions doesn't exceed tgc_tx_nr_max.
+	 *
+	 * @see m0_be_engine_ctl
+	 */
+	bool                       bec_group_adaptive;
 	/** Request handler for group foms and engine timeouts */
 	struct m0_reqh		  *bec_reqh;
 	/** Wait in m0_be_engine_start() until recovery is finished. */
 	bool			   bec_wait_for_recovery;
+	/**
+	 * Number of groups used for recovery. Log records are read and decoded
+	 * by the groups concurrently and re-applied in the log order. 0 means
+	 * 1, values greater than bec_group_nr mean bec_group_nr.
+	 */
+	size_t			   bec_recovery_group_nr;
 	/** BE domain the engine belongs to. */
 	struct m0_be_domain	  *bec_domain;
 	struct m0_be_log_discard  *bec_log_discard;
@@ -94,6 +110,43 @@ struct m0_be_engine_cfg {
 	struct m0_mutex           *bec_lock;
 };
 
+/**
+ * Group controller.
+ *
+ * The controller observes:
+ * - average interval between transactions added to groups;
+ * - average latency of log record writes;
+ * - duration of the last m0_be_pd_sync().
+ *
+ * The larger of the latencies is the cost of making a group persistent. The
+ * controller expects that transactions arriving while the previous group is
+ * being written can be made persistent at the same cost, so it waits for
+ * them: number of transactions per group is the cost divided by the arrival
+ * interval and the freeze timeout is the time needed for them to arrive. At
+ * low load it gives 1 transaction per group, i.e. the group is frozen as
+ * soon as the first transaction is added to it and no latency is added. At
+ * high load groups get larger and fewer log writes are done.
+ *
+ * All averages are exponentially weighted moving averages. Arrival intervals
+ * longer than bec_group_freeze_timeout_max are counted as
+ * bec_group_freeze_timeout_max, so that the controller recovers quickly after
+ * an idle period.
+ *
+ * Decisions are posted to addb2 as M0_AVI_BE_GROUP_CTL records.
+ */
+struct m0_be_engine_ctl {
+	/** Average interval between transactions. */
+	m0_time_t bect_arrival;
+	/** Time when the last transaction was added to a group. */
+	m0_time_t bect_arrival_last;
+	/** Average log record write latency. */
+	m0_time_t bect_log_latency;
+	/** Current number of transactions per group. */
+	uint64_t  bect_tx_nr;
+	/** Current group freeze timeout. */
+	m0_time_t bect_delay;
+};
+
 struct m0_be_engine {
 	struct m0_be_engine_cfg   *eng_cfg;
 	/**
@@ -118,6 +171,12 @@ struct m0_be_engine {
 	struct m0_be_domain       *eng_domain;
 	struct m0_semaphore        eng_recovery_wait_sem;
 	bool                       eng_recovery_finished;
+	/** m0_be_tx_group::tg_recovery_seq for the next recovering group. */
+	uint64_t                   eng_recovery_seq_next;
+	/** m0_be_tx_group::tg_recovery_seq of the group allowed to re-apply. */
+	uint64_t                   eng_recovery_seq_reapply;
+	/** Is used iff m0_be_engine_cfg::bec_group_adaptive is set. */
+	struct m0_be_engine_ctl    eng_ctl;
 };
 
 M0_INTERNAL bool m0_be_engine__invariant(struct m0_be_engine *en);
@@ -153,6 +212,17 @@ M0_INTERNAL void m0_be_engine__tx_group_ready(struct m0_be_engine   *en,
 M0_INTERNAL void m0_be_engine__tx_group_discard(struct m0_be_engine   *en,
 						struct m0_be_tx_group *gr);
 
+/** @see m0_be_tx_group_reapply_may() */
+M0_INTERNAL bool
+m0_be_engine__recovery_reapply_may(struct m0_be_engine   *en,
+				   struct m0_be_tx_group *gr);
+/** @see m0_be_tx_group_recovery_placed() */
+M0_INTERNAL void m0_be_engine__recovery_placed(struct m0_be_engine   *en,
+					       struct m0_be_tx_group *gr);
+/** @see m0_be_tx_group_logged() */
+M0_INTERNAL void m0_be_engine__group_logged(struct m0_be_engine *en,
+					    m0_time_t            latency);
+
 M0_INTERNAL void m0_be_engine_got_log_space_cb(struct m0_be_log *log);
 M0_INTERNAL void m0_be_engine_full_log_cb(struct m0_be_log *log);
 
@@ -262,15 +262,23 @@ struct m0_be_fmt_log_record_header {
 	m0_bindex_t                            lrh_prev_pos;
 	m0_bindex_t                            lrh_prev_size;
 	uint64_t                               lrh_io_nr_max;
+	/** CRC32C of the log record buffers. */
+	uint32_t                               lrh_crc;
+	/** Generation of the log which has written the record. */
+	uint64_t                               lrh_gen;
+	/** Generation of the previous log record. */
+	uint64_t                               lrh_prev_gen;
 	struct m0_be_fmt_log_record_header_io_size lrh_io_size;
 } M0_XCA_RECORD M0_XCA_DOMAIN(be);
 
 #define BFLRH_F "(pos=%" PRIu64 " size=%" PRIu64 " discarded=%" PRIu64 " " \
 		"prev_pos=%" PRIu64 " prev_size=%" PRIu64 \
-		" io_nr_max=%" PRIu64 ")"
+		" io_nr_max=%" PRIu64 " crc=%" PRIx32 \
+		" gen=%" PRIu64 " prev_gen=%" PRIu64 ")"
 #define BFLRH_P(h) (h)->lrh_pos, (h)->lrh_size, (h)->lrh_discarded, \
 		   (h)->lrh_prev_pos, (h)->lrh_prev_size,           \
-		   (h)->lrh_io_nr_max
+		   (h)->lrh_io_nr_max, (h)->lrh_crc,                \
+		   (h)->lrh_gen, (h)->lrh_prev_gen
 
 /**
  * Format decode function config. Used to check decoded values against various
@@ -638,6 +638,16 @@ M0_INTERNAL bool m0_be_io_sync_is_enabled(struct m0_be_io *bio)
 	return bio->bio_sync;
 }
 
+M0_INTERNAL void m0_be_io_barrier_enable(struct m0_be_io *bio)
+{
+	bio->bio_barrier = true;
+}
+
+M0_INTERNAL bool m0_be_io_barrier_is_enabled(struct m0_be_io *bio)
+{
+	return bio->bio_barrier;
+}
+
 M0_INTERNAL enum m0_stob_io_opcode m0_be_io_opcode(struct m0_be_io *io)
 {
 	return io->bio_opcode;
@@ -659,6 +669,7 @@ M0_INTERNAL void m0_be_io_reset(struct m0_be_io *bio)
 	bio->bio_used    = M0_BE_IO_CREDIT(0, 0, 0);
 	bio->bio_stob_nr = 0;
 	bio->bio_sync    = false;
+	bio->bio_barrier = false;
 }
 
 M0_INTERNAL void m0_be_io_sort(struct m0_be_io *bio)
@@ -108,6 +108,8 @@ struct m0_be_io {
 	struct m0_be_op        *bio_op;
 	/** @see m0_be_io_sync_enable */
 	bool                    bio_sync;
+	/** @see m0_be_io_barrier_enable */
+	bool                    bio_barrier;
 	enum m0_stob_io_opcode  bio_opcode;
 	struct m0_sm_ast        bio_ast;
 
@@ -121,6 +123,10 @@ struct m0_be_io {
 	/** The op passed to m0_be_io_sched_add() */
 	struct m0_be_op        *bio_sched_op_user;
 	struct m0_ext           bio_ext;
+	/** The I/O is launched by the scheduler */
+	bool                    bio_sched_launched;
+	/** The I/O is finished but it is not reported to the user yet */
+	bool                    bio_sched_done;
 };
 
 M0_INTERNAL int m0_be_io_init(struct m0_be_io *bio);
@@ -168,6 +174,13 @@ M0_INTERNAL m0_bcount_t m0_be_io_size(struct m0_be_io *bio);
 M0_INTERNAL void m0_be_io_sync_enable(struct m0_be_io *bio);
 M0_INTERNAL bool m0_be_io_sync_is_enabled(struct m0_be_io *bio);
 
+/**
+ * m0_be_io_sched doesn't launch the I/O until all I/Os before it are finished
+ * and doesn't launch I/Os after it until the I/O is finished.
+ */
+M0_INTERNAL void m0_be_io_barrier_enable(struct m0_be_io *bio);
+M0_INTERNAL bool m0_be_io_barrier_is_enabled(struct m0_be_io *bio);
+
 M0_INTERNAL enum m0_stob_io_opcode m0_be_io_opcode(struct m0_be_io *io);
 
 M0_INTERNAL void m0_be_io_configure(struct m0_be_io        *bio,
@@ -33,6 +33,7 @@
 #include "be/io_sched.h"
 
 #include "lib/ext.h"            /* m0_ext */
+#include "lib/arith.h"          /* max_check */
 
 #include "be/op.h"              /* m0_be_op */
 #include "be/io.h"              /* m0_be_io_launch */
@@ -55,8 +56,11 @@ M0_INTERNAL int m0_be_io_sched_init(struct m0_be_io_sched     *sched,
 		sched->bis_cfg = *cfg;
 	m0_mutex_init(&sched->bis_lock);
 	sched_io_tlist_init(&sched->bis_ios);
-	sched->bis_io_in_progress = false;
-	sched->bis_pos = sched->bis_cfg.bisc_pos_start;
+	sched->bis_io_nr      = 0;
+	sched->bis_barrier    = false;
+	sched->bis_reporting  = false;
+	sched->bis_pos        = sched->bis_cfg.bisc_pos_start;
+	sched->bis_pos_launch = sched->bis_cfg.bisc_pos_start;
 
 	return 0;
 }
@@ -82,46 +86,70 @@ M0_INTERNAL bool m0_be_io_sched_is_locked(struct m0_be_io_sched *sched)
 	return m0_mutex_is_locked(&sched->bis_lock);
 }
 
+static uint32_t be_io_sched_io_nr_max(const struct m0_be_io_sched *sched)
+{
+	return max_check(sched->bis_cfg.bisc_io_nr_max, 1U);
+}
+
+static bool be_io_sched_io_is_barrier(struct m0_be_io *io)
+{
+	return m0_ext_is_empty(&io->bio_ext) || m0_be_io_barrier_is_enabled(io);
+}
+
 static bool be_io_sched_invariant(struct m0_be_io_sched *sched)
 {
-	return m0_tl_forall(sched_io, io, &sched->bis_ios,
+	return _0C(sched->bis_io_nr <= be_io_sched_io_nr_max(sched)) &&
+	       _0C(sched->bis_pos <= sched->bis_pos_launch) &&
+	       m0_tl_forall(sched_io, io, &sched->bis_ios,
 		    sched_io_tlist_next(&sched->bis_ios, io) == NULL ||
 		    io->bio_ext.e_end <=
 		    sched_io_tlist_next(&sched->bis_ios, io)->bio_ext.e_start);
 }
 
+/*
+ * Launched I/Os are always at the head of the queue: they are launched in the
+ * queue order and removed from the queue in the same order. The first
+ * I/O which is not launched is launched if it starts at bis_pos_launch, if
+ * there is a free slot and if barriers allow it, and so on.
+ */
 static void be_io_sched_launch_next(struct m0_be_io_sched *sched)
 {
 	struct m0_be_io *io;
+	bool             barrier;
 
 	M0_PRE(m0_be_io_sched_is_locked(sched));
 
-	if (!sched->bis_io_in_progress) {
-		io = sched_io_tlist_head(&sched->bis_ios);
-		M0_ASSERT(ergo(io != NULL,
-			       sched->bis_pos <= io->bio_ext.e_start));
-		if (io != NULL) {
-			M0_LOG(M0_DEBUG, "bis_pos=%" PRIu64 " "
-			       "io->bio_ext.e_start=%"PRIu64,
-			       sched->bis_pos, io->bio_ext.e_start);
-		}
-		if (io != NULL && io->bio_ext.e_start == sched->bis_pos) {
-			sched->bis_io_in_progress = true;
-			M0_LOG(M0_DEBUG, "sched=%p io=%p pos=%"PRId64,
-			       sched, io, sched->bis_pos);
-			m0_be_op_active(io->bio_sched_op_user);
-			m0_be_io_launch(io, &io->bio_sched_op);
-		}
+	io = sched_io_tlist_head(&sched->bis_ios);
+	while (io != NULL && io->bio_sched_launched)
+		io = sched_io_tlist_next(&sched->bis_ios, io);
+	for (; io != NULL; io = sched_io_tlist_next(&sched->bis_ios, io)) {
+		M0_ASSERT(sched->bis_pos_launch <= io->bio_ext.e_start);
+		M0_LOG(M0_DEBUG, "bis_pos_launch=%" PRIu64 " "
+		       "io->bio_ext.e_start=%"PRIu64" bis_io_nr=%"PRIu32,
+		       sched->bis_pos_launch, io->bio_ext.e_start,
+		       sched->bis_io_nr);
+		barrier = be_io_sched_io_is_barrier(io);
+		if (sched->bis_barrier ||
+		    sched->bis_io_nr >= be_io_sched_io_nr_max(sched) ||
+		    io->bio_ext.e_start != sched->bis_pos_launch ||
+		    (barrier && sched->bis_io_nr > 0))
+			break;
+		io->bio_sched_launched = true;
+		++sched->bis_io_nr;
+		sched->bis_barrier    = barrier;
+		sched->bis_pos_launch = io->bio_ext.e_end;
+		M0_LOG(M0_DEBUG, "sched=%p io=%p pos=%"PRId64,
+		       sched, io, io->bio_ext.e_start);
+		m0_be_op_active(io->bio_sched_op_user);
+		m0_be_io_launch(io, &io->bio_sched_op);
 	}
 }
 
-static void be_io_sched_launch_next_locked(struct m0_be_io_sched *sched)
-{
-	m0_be_io_sched_lock(sched);
-	be_io_sched_launch_next(sched);
-	m0_be_io_sched_unlock(sched);
-}
-
+/*
+ * I/Os may be finished in any order if more than one I/O is in flight.
+ * They are reported to the users in the queue order by one thread at a time,
+ * so bis_pos is advanced only past the contiguous finished I/Os.
+ */
 static void be_io_sched_cb(struct m0_be_op *op, void *param)
 {
 	struct m0_be_io       *io    = param;
@@ -129,17 +157,29 @@ static void be_io_sched_cb(struct m0_be_op *op, void *param)
 
 	M0_LOG(M0_DEBUG, "sched=%p io=%p", sched, io);
 
-	M0_PRE(io->bio_ext.e_start == sched->bis_pos);
-
 	m0_be_io_sched_lock(sched);
-	sched_io_tlink_del_fini(io);
+	M0_PRE(io->bio_sched_launched && !io->bio_sched_done);
+	M0_PRE(sched->bis_io_nr > 0);
 	m0_be_op_fini(&io->bio_sched_op);
-	sched->bis_io_in_progress = false;
-	sched->bis_pos = io->bio_ext.e_end;
+	io->bio_sched_done = true;
+	--sched->bis_io_nr;
+	if (be_io_sched_io_is_barrier(io))
+		sched->bis_barrier = false;
+	if (!sched->bis_reporting) {
+		sched->bis_reporting = true;
+		while ((io = sched_io_tlist_head(&sched->bis_ios)) != NULL &&
+		       io->bio_sched_done) {
+			M0_ASSERT(io->bio_ext.e_start == sched->bis_pos);
+			sched_io_tlink_del_fini(io);
+			sched->bis_pos = io->bio_ext.e_end;
+			m0_be_io_sched_unlock(sched);
+			m0_be_op_done(io->bio_sched_op_user);
+			m0_be_io_sched_lock(sched);
+		}
+		sched->bis_reporting = false;
+	}
+	be_io_sched_launch_next(sched);
 	m0_be_io_sched_unlock(sched);
-
-	m0_be_op_done(io->bio_sched_op_user);
-	be_io_sched_launch_next_locked(sched);
 }
 
 static void be_io_sched_insert(struct m0_be_io_sched *sched,
@@ -188,7 +228,9 @@ M0_INTERNAL void m0_be_io_sched_add(struct m0_be_io_sched *sched,
 	M0_PRE(equi(!m0_be_io_is_empty(io) && m0_be_io_opcode(io) == SIO_READ,
 		    ext == NULL));
 
-	io->bio_sched = sched;
+	io->bio_sched          = sched;
+	io->bio_sched_launched = false;
+	io->bio_sched_done     = false;
 	if (!m0_be_io_is_empty(io) && m0_be_io_opcode(io) == SIO_READ) {
 		io_last = sched_io_tlist_tail(&sched->bis_ios);
 		io->bio_ext.e_start = io_last == NULL ? sched->bis_pos :
@@ -196,6 +238,7 @@ M0_INTERNAL void m0_be_io_sched_add(struct m0_be_io_sched *sched,
 		io->bio_ext.e_end = io->bio_ext.e_start;
 		m0_ext_init(&io->bio_ext);
 	} else {
+		M0_PRE(sched->bis_pos_launch <= ext->e_start);
 		io->bio_ext = *ext;
 	}
 	be_io_sched_insert(sched, io);
@@ -42,6 +42,11 @@ struct m0_ext;
 struct m0_be_io_sched_cfg {
 	/** start position for m0_be_io_sched::bis_pos */
 	m0_bcount_t bisc_pos_start;
+	/**
+	 * Maximum number of write I/Os launched at the same time.
+	 * 0 and 1 mean that I/Os are launched one by one.
+	 */
+	uint32_t    bisc_io_nr_max;
 };
 
 /*
@@ -56,6 +61,15 @@ struct m0_be_io_sched_cfg {
  *   - I/Os are launched in the m0_ext increasing order, without gaps. If there
  *     is no such I/O in the queue at the scheduler's current position then I/O
  *     after the gap is not launched until another I/O is added to fill the gap;
+ *   - up to m0_be_io_sched_cfg::bisc_io_nr_max I/Os are in flight at the same
+ *     time. They may be finished by the storage in any order;
+ *   - the op passed to m0_be_io_sched_add() is done in the m0_ext increasing
+ *     order: an I/O is reported as finished only when all I/Os before it are
+ *     finished. m0_be_io_sched::bis_pos is advanced in the same way, so it
+ *     never gets past an I/O which is not on disk yet;
+ *   - an I/O with m0_be_io_barrier_enable() is launched only when all I/Os
+ *     before it are finished, and I/Os after it are not launched until it is
+ *     finished;
  * - read I/O:
  *   - doesn't have m0_ext assigned (subject to change);
  *   - is launched after the last write I/O (at the time the read I/O is added
@@ -66,9 +80,16 @@ struct m0_be_io_sched {
 	/** list of m0_be_io-s under scheduler's control */
 	struct m0_tl              bis_ios;
 	struct m0_mutex           bis_lock;
-	bool                      bis_io_in_progress;
-	/** position for the next I/O */
+	/** number of launched and not finished I/Os */
+	uint32_t                  bis_io_nr;
+	/** a barrier I/O is in flight */
+	bool                      bis_barrier;
+	/** some thread reports finished I/Os to the users */
+	bool                      bis_reporting;
+	/** position for the next I/O to be reported as finished */
 	m0_bcount_t               bis_pos;
+	/** position for the next I/O to be launched */
+	m0_bcount_t               bis_pos_launch;
 };
 
 M0_INTERNAL int m0_be_io_sched_init(struct m0_be_io_sched     *sched,
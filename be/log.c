@@ -29,10 +29,13 @@
 #include "be/ha.h"              /* m0_be_io_err_send */
 
 #include "lib/arith.h"          /* m0_align */
+#include "lib/crc32c.h"         /* m0_crc32c */
 #include "lib/errno.h"          /* ENOENT */
+#include "lib/finject.h"        /* M0_FI_ENABLED */
 #include "lib/memory.h"
 #include "lib/tlist.h"
 #include "lib/ext.h"            /* M0_EXT */
+#include "lib/time.h"           /* m0_time_now */
 #include "motr/magic.h"
 #include "module/instance.h"    /* m0_get */
 
@@ -84,6 +87,7 @@ static int be_log_level_enter(struct m0_module *module)
 		log->lg_free             = 0;
 		log->lg_prev_record      = 0;
 		log->lg_prev_record_size = 0;
+		log->lg_prev_record_gen  = 0;
 		log->lg_unplaced_exists  = false;
 		m0_mutex_init(&log->lg_record_state_lock);
 		record_tlist_init(&log->lg_records);
@@ -134,7 +138,10 @@ static int be_log_level_enter(struct m0_module *module)
 			log->lg_discarded        = rvr->brec_discarded;
 			log->lg_prev_record      = rvr->brec_last_record_pos;
 			log->lg_prev_record_size = rvr->brec_last_record_size;
+			log->lg_prev_record_gen  = rvr->brec_last_record_gen;
 		}
+		log->lg_gen  = max_check(m0_time_now(),
+					 log->lg_prev_record_gen + 1);
 		log->lg_free = m0_be_log_store_buf_size(&log->lg_store) -
 			       (log->lg_current - log->lg_discarded);
 		M0_LOG(M0_DEBUG, "log="BL_F, BL_P(log));
@@ -172,7 +179,9 @@ static void be_log_level_leave(struct m0_module *module)
 		m0_be_fmt_log_header_fini(&log->lg_header);
 		break;
 	case M0_BE_LOG_LEVEL_HEADER:
-		if (!log->lg_destroy_mode) {
+		/* UT uses "no_header_write" to emulate a crash */
+		if (!log->lg_destroy_mode &&
+		    !M0_FI_ENABLED("no_header_write")) {
 			be_log_header_update(log);
 			rc = be_log_header_write(log, &log->lg_header);
 			M0_ASSERT_INFO(rc == 0, "rc=%d", rc); /* XXX */
@@ -319,6 +328,13 @@ static void be_log_header_io(struct m0_be_log             *log,
 		 * log_sched can't finish I/O when it's locked.
 		 */
 		m0_be_op_set_add(op, io_op);
+		/*
+		 * Log records after the header may overwrite the record the
+		 * old header points to, so they are not written concurrently
+		 * with the header.
+		 */
+		if (io_type == M0_BE_LOG_STORE_IO_WRITE)
+			m0_be_io_barrier_enable(m0_be_log_io_be_io(lio));
 		m0_be_log_sched_add(&log->lg_sched, lio, io_op);
 		lio = m0_be_log_store_rbuf_io_next(&log->lg_store, io_type,
 						   &io_op, &iter);
@@ -735,8 +751,10 @@ m0_be_log_record_io_prepare(struct m0_be_log_record *record,
 		if (size_reserved != size)
 			log->lg_got_space_cb(log);
 
-		/* log record header */
-		lio    = record->lgr_io[0];
+		/*
+		 * log record header. It's encoded in
+		 * be_log_record_header_encode() when buffers are filled.
+		 */
 		header = &record->lgr_header;
 		for (i = 0; i < record->lgr_io_nr; ++i) {
 			m0_be_fmt_log_record_header_io_size_add(header,
@@ -747,10 +765,9 @@ m0_be_log_record_io_prepare(struct m0_be_log_record *record,
 		header->lrh_discarded = record->lgr_last_discarded;
 		header->lrh_prev_pos  = record->lgr_prev_pos;
 		header->lrh_prev_size = record->lgr_prev_size;
-		size_fmt = m0_be_fmt_log_record_header_size(header);
-		bvec     = M0_BUFVEC_INIT_BUF(&lio->lio_buf.b_addr, &size_fmt);
-		m0_bufvec_cursor_init(&cur, &bvec);
-		m0_be_fmt_log_record_header_encode(header, &cur);
+		header->lrh_gen       = log->lg_gen;
+		header->lrh_prev_gen  = log->lg_prev_record_gen;
+		log->lg_prev_record_gen = log->lg_gen;
 
 		/* log record footer */
 		lio    = record->lgr_io[record->lgr_io_nr - 1];
@@ -792,6 +809,33 @@ m0_be_log_record_io_prepare(struct m0_be_log_record *record,
 	M0_LEAVE("record="BLR_F" log="BL_F, BLR_P(record), BL_P(log));
 }
 
+/** Calculates checksum of the record buffers and encodes record header. */
+static void be_log_record_header_encode(struct m0_be_log_record *record)
+{
+	struct m0_be_fmt_log_record_header *header = &record->lgr_header;
+	struct m0_bufvec_cursor             cur;
+	struct m0_bufvec                    bvec;
+	struct m0_be_log_io                *lio;
+	m0_bcount_t                         size_fmt;
+	uint32_t                            crc = 0;
+	int                                 i;
+
+	for (i = 0; i < record->lgr_io_nr; ++i) {
+		lio = record->lgr_io[i];
+		crc = m0_crc32c(crc, lio->lio_buf_addr, lio->lio_buf_size);
+	}
+	/* Simulates a record whose buffers are partially written. */
+	if (M0_FI_ENABLED("torn_record"))
+		crc = ~crc;
+	header->lrh_crc = crc;
+
+	lio      = record->lgr_io[0];
+	size_fmt = m0_be_fmt_log_record_header_size(header);
+	bvec     = M0_BUFVEC_INIT_BUF(&lio->lio_buf.b_addr, &size_fmt);
+	m0_bufvec_cursor_init(&cur, &bvec);
+	m0_be_fmt_log_record_header_encode(header, &cur);
+}
+
 M0_INTERNAL void m0_be_log_record_io_launch(struct m0_be_log_record *record,
 					    struct m0_be_op         *op)
 {
@@ -799,6 +843,9 @@ M0_INTERNAL void m0_be_log_record_io_launch(struct m0_be_log_record *record,
 	struct m0_be_op   op2 = {};
 	int               i;
 
+	if (m0_be_io_opcode(&record->lgr_io[0]->lio_be_io) == SIO_WRITE)
+		be_log_record_header_encode(record);
+
 	record->lgr_state = LGR_SCHEDULED;
 	m0_be_log_sched_lock(&log->lg_sched);
 	m0_be_op_set_add(op, &record->lgr_record_op);
@@ -1081,14 +1128,56 @@ static void be_log_record_header_copy(struct m0_be_fmt_log_record_header *dest,
 	dest->lrh_discarded = src->lrh_discarded;
 	dest->lrh_prev_pos  = src->lrh_prev_pos;
 	dest->lrh_prev_size = src->lrh_prev_size;
+	dest->lrh_crc       = src->lrh_crc;
+	dest->lrh_gen       = src->lrh_gen;
+	dest->lrh_prev_gen  = src->lrh_prev_gen;
 	for (i = 0; i < src->lrh_io_size.lrhs_nr; ++i)
 		dest->lrh_io_size.lrhs_size[i] = src->lrh_io_size.lrhs_size[i];
 	dest->lrh_io_size.lrhs_nr = src->lrh_io_size.lrhs_nr;
 }
 
+/**
+ * Checks CRC32C of the record buffers. data is the whole record, as it's
+ * stored in the log.
+ */
+static bool be_log_record_crc_check(struct m0_be_fmt_log_record_header *header,
+				    struct m0_be_log                   *log,
+				    const char                         *data)
+{
+	struct m0_be_fmt_log_record_header_io_size *io_size;
+	m0_bcount_t hsize     = be_log_record_header_size();
+	m0_bcount_t fsize     = be_log_record_footer_size();
+	uint64_t    alignment = 1ULL << m0_be_log_bshift(log);
+	m0_bcount_t offset    = 0;
+	m0_bcount_t part;
+	uint32_t    crc       = 0;
+	uint32_t    i;
+
+	io_size = &header->lrh_io_size;
+	for (i = 0; i < io_size->lrhs_nr; ++i) {
+		part  = io_size->lrhs_size[i];
+		part += i == 0 ? hsize : 0;
+		part += i == io_size->lrhs_nr - 1 ? fsize : 0;
+		if (part < io_size->lrhs_size[i] ||
+		    m0_align(part, alignment) > header->lrh_size - offset)
+			return false;
+		crc = m0_crc32c(crc, data + offset + (i == 0 ? hsize : 0),
+				io_size->lrhs_size[i]);
+		offset += m0_align(part, alignment);
+	}
+	return crc == header->lrh_crc;
+}
+
+/**
+ * Reads log record header and footer at the given position.
+ *
+ * If verify is set then the whole record is read and CRC32C of its buffers is
+ * checked, -ENOENT is returned if it doesn't match.
+ */
 static int be_log_record_iter_read(struct m0_be_log             *log,
 				   struct m0_be_log_record_iter *iter,
-				   m0_bindex_t                   pos)
+				   m0_bindex_t                   pos,
+				   bool                          verify)
 {
 	struct m0_be_fmt_log_record_footer *footer;
 	struct m0_be_fmt_log_record_header *header;
@@ -1096,8 +1185,11 @@ static int be_log_record_iter_read(struct m0_be_log             *log,
 	struct m0_bufvec                    bvec;
 	m0_bcount_t                         size_fmt;
 	m0_bcount_t                         size;
+	m0_bcount_t                         hsize;
+	m0_bcount_t                         done;
 	uint32_t                            bshift = m0_be_log_bshift(log);
 	uint64_t                            align  = 1ULL << bshift;
+	char                               *hdata;
 	char                               *data;
 	void                               *addr_fmt;
 	int                                 rc;
@@ -1105,45 +1197,69 @@ static int be_log_record_iter_read(struct m0_be_log             *log,
 	M0_PRE(m0_is_aligned(pos, align));
 
 	size_fmt = be_log_record_header_size();
-	size     = m0_align(size_fmt + (pos & (align - 1)), align);
-	data     = m0_alloc_aligned(size, bshift);
-	if (data == NULL)
+	hsize    = m0_align(size_fmt, align);
+	hdata    = m0_alloc_aligned(hsize, bshift);
+	if (hdata == NULL)
 		return -ENOMEM;
-	addr_fmt = data + (pos & (align - 1));
+	addr_fmt = hdata;
 	bvec     = M0_BUFVEC_INIT_BUF(&addr_fmt, &size_fmt);
 	m0_bufvec_cursor_init(&cur, &bvec);
-	pos &= ~((m0_bindex_t)align - 1);
-	rc   = be_log_read_plain(log, pos, size, data);
+	rc   = be_log_read_plain(log, pos, hsize, hdata);
 	rc   = rc ?: m0_be_fmt_log_record_header_decode(&header, &cur,
 						M0_BE_FMT_DECODE_CFG_DEFAULT);
 	if (rc == -EPROTO)
 		rc = -ENOENT;
-
-	m0_free_aligned(data, size, bshift);
-	if (rc != 0)
+	if (rc != 0) {
+		m0_free_aligned(hdata, hsize, bshift);
 		return rc;
+	}
 
 	rc = m0_be_fmt_log_record_header__invariant(header, log) ? 0 : -ENOENT;
+	if (rc == 0 && verify &&
+	    (header->lrh_size < hsize ||
+	     header->lrh_size > m0_be_log_store_buf_size(&log->lg_store)))
+		rc = -ENOENT;
 	if (rc == 0) {
+		/*
+		 * Footer is at the end of the record. If the checksum needs to
+		 * be checked, the whole record is needed: the block with the
+		 * header is already in memory and only the rest of the record
+		 * is read.
+		 */
 		size_fmt = be_log_record_footer_size();
-		size     = m0_align(size_fmt, align);
+		size     = verify ? header->lrh_size : m0_align(size_fmt, align);
+		done     = verify ? hsize : 0;
 		data     = m0_alloc_aligned(size, bshift);
+		if (data == NULL) {
+			m0_be_fmt_log_record_header_decoded_free(header);
+			m0_free_aligned(hdata, hsize, bshift);
+			return M0_ERR(-ENOMEM);
+		}
+		memcpy(data, hdata, done);
 		addr_fmt = data + size - size_fmt;
 		bvec     = M0_BUFVEC_INIT_BUF(&addr_fmt, &size_fmt);
 		m0_bufvec_cursor_init(&cur, &bvec);
-		rc = be_log_read_plain(log, pos + header->lrh_size - size,
-				       size, data);
+		rc = size == done ? 0 :
+			be_log_read_plain(log, pos + header->lrh_size - size +
+					  done, size - done, data + done);
 		rc = rc ?: m0_be_fmt_log_record_footer_decode(&footer, &cur,
 					      M0_BE_FMT_DECODE_CFG_DEFAULT);
 		if (rc == 0) {
 			rc = header->lrh_pos == footer->lrf_pos ? 0 : -ENOENT;
 			m0_be_fmt_log_record_footer_decoded_free(footer);
 		}
+		if (rc == 0 && verify &&
+		    !be_log_record_crc_check(header, log, data)) {
+			M0_LOG(M0_WARN, "checksum mismatch: header="BFLRH_F,
+			       BFLRH_P(header));
+			rc = -ENOENT;
+		}
 		m0_free_aligned(data, size, bshift);
 		if (rc == 0)
 			be_log_record_header_copy(&iter->lri_header, header);
 	}
 	m0_be_fmt_log_record_header_decoded_free(header);
+	m0_free_aligned(hdata, hsize, bshift);
 
 	return rc;
 }
@@ -1172,7 +1288,7 @@ M0_INTERNAL int m0_be_log_record_initial(struct m0_be_log             *log,
 	int         rc;
 
 	rc = (pos == 0 && size == 0) ? -ENOENT : 0;
-	rc = rc ?: be_log_record_iter_read(log, curr, pos);
+	rc = rc ?: be_log_record_iter_read(log, curr, pos, true);
 	if (rc == 0 && curr->lri_header.lrh_size != size)
 		rc = -EBADF;
 	/*
@@ -1193,8 +1309,10 @@ M0_INTERNAL int m0_be_log_record_next(struct m0_be_log                   *log,
 				      struct m0_be_log_record_iter       *next)
 {
 	int rc = be_log_record_iter_read(log, next, curr->lri_header.lrh_pos +
-						    curr->lri_header.lrh_size);
-	if (rc == 0 && curr->lri_header.lrh_pos >= next->lri_header.lrh_pos)
+					 curr->lri_header.lrh_size, true);
+	if (rc == 0 &&
+	    (curr->lri_header.lrh_pos >= next->lri_header.lrh_pos ||
+	     curr->lri_header.lrh_gen != next->lri_header.lrh_prev_gen))
 		rc = -ENOENT;
 	return rc;
 }
@@ -1204,7 +1322,7 @@ M0_INTERNAL int m0_be_log_record_prev(struct m0_be_log                   *log,
 				      struct m0_be_log_record_iter       *prev)
 {
 	int rc = be_log_record_iter_read(log, prev,
-					 curr->lri_header.lrh_prev_pos);
+					 curr->lri_header.lrh_prev_pos, false);
 	if (rc == 0 && curr->lri_header.lrh_pos <= prev->lri_header.lrh_pos)
 		rc = -ENOENT;
 	return rc;
@@ -1230,6 +1348,19 @@ m0_be_log_recovery_discarded(struct m0_be_log *log)
 	return log->lg_recovery.brec_discarded;
 }
 
+M0_INTERNAL void m0_be_log_recovery_reapply(struct m0_be_log      *log,
+					    struct m0_be_reg_area *ra)
+{
+	M0_PRE(!log->lg_create_mode);
+	m0_be_recovery_reapply(&log->lg_recovery, ra);
+}
+
+M0_INTERNAL void m0_be_log_recovery_finished(struct m0_be_log *log)
+{
+	if (!log->lg_create_mode)
+		m0_be_recovery_finished(&log->lg_recovery);
+}
+
 M0_INTERNAL bool m0_be_log_contains_stob(struct m0_be_log        *log,
                                          const struct m0_stob_id *stob_id)
 {
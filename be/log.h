@@ -81,6 +81,15 @@
  * A valid log record is record that fully resides on backing store and is not
  * corrupted.
  *
+ * Header contains CRC32C of the buffers (paddings, header and footer are not
+ * covered). It's calculated in m0_be_log_record_io_launch(), when the buffers
+ * are filled, and it's checked when the log is scanned forward from the record
+ * pointed by log header (m0_be_log_record_initial(), m0_be_log_record_next()).
+ * A record that was partially written before a crash has matching header and
+ * footer but wrong checksum, so the forward scan stops at the last valid
+ * record without decoding records' content. Records before the one pointed
+ * by log header are known to be valid and their checksum is not checked.
+ *
  * Log record structure can be reused after reset.
  *
  * <b>Reservation</b>
@@ -224,6 +233,7 @@ struct m0_be_io;
 struct m0_be_log_io;
 struct m0_be_log_record_iter;
 struct m0_be_tx_group;
+struct m0_be_reg_area;
 
 struct m0_be_log;
 struct m0_be_log_record;
@@ -291,6 +301,18 @@ struct m0_be_log {
 	/** Position of the last allocated record */
 	m0_bindex_t              lg_prev_record;
 	m0_bcount_t              lg_prev_record_size;
+	/** Generation of the last allocated record */
+	uint64_t                 lg_prev_record_gen;
+	/**
+	 * Generation of the log. It's different for every log open and it's
+	 * written to every log record (m0_be_fmt_log_record_header::lrh_gen).
+	 * Log record is valid only if its lrh_prev_gen matches lrh_gen of the
+	 * previous log record. Records from the log which has been opened
+	 * before are not taken as valid after a crash this way: such records
+	 * may be written after records which are lost, because
+	 * m0_be_log_sched may have several writes in flight.
+	 */
+	uint64_t                 lg_gen;
 	/**
 	 * Indicates that there is a finalised/reset but not discarded log
 	 * record. Log keeps pointer to such record with the least lsn.
@@ -536,6 +558,11 @@ m0_be_log_recovery_record_get(struct m0_be_log             *log,
 			      struct m0_be_log_record_iter *iter);
 M0_INTERNAL m0_bindex_t
 m0_be_log_recovery_discarded(struct m0_be_log *log);
+/** @see m0_be_recovery_reapply() */
+M0_INTERNAL void m0_be_log_recovery_reapply(struct m0_be_log      *log,
+					    struct m0_be_reg_area *ra);
+/** @see m0_be_recovery_finished() */
+M0_INTERNAL void m0_be_log_recovery_finished(struct m0_be_log *log);
 
 M0_INTERNAL bool m0_be_log_contains_stob(struct m0_be_log        *log,
                                          const struct m0_stob_id *stob_id);
@@ -209,6 +209,7 @@ static void be_pd_sync_run(struct m0_sm_group *grp, struct m0_sm_ast *ast)
 	       "prev=%" PRId64 " rc=%d",
 	       pd->bpd_sync_runtime, pd->bpd_sync_delay, pd->bpd_sync_prev, rc);
 	pd->bpd_sync_prev        = now;
+	pd->bpd_sync_cost        = pd->bpd_sync_runtime;
 	pd->bpd_sync_in_progress = false;
 	m0_be_op_done(pd->bpd_sync_op);
 }
@@ -242,6 +243,11 @@ M0_INTERNAL void m0_be_pd_sync(struct m0_be_pd  *pd,
 	m0_sm_ast_post(m0_locality0_get()->lo_grp, &pd->bpd_sync_ast);
 }
 
+M0_INTERNAL m0_time_t m0_be_pd_sync_cost(const struct m0_be_pd *pd)
+{
+	return pd->bpd_sync_cost;
+}
+
 #undef M0_TRACE_SUBSYSTEM
 
 /** @} end of be group */
@@ -71,6 +71,8 @@ struct m0_be_pd {
 	m0_time_t              bpd_sync_delay;
 	m0_time_t              bpd_sync_runtime;
 	m0_time_t              bpd_sync_prev;
+	/** Duration of the last completed sync. @see m0_be_pd_sync_cost() */
+	m0_time_t              bpd_sync_cost;
 	struct m0_be_io        bpd_sync_io;
 	bool                   bpd_sync_in_progress;
 	char                   bpd_sync_read_to[2];
@@ -104,6 +106,12 @@ M0_INTERNAL void m0_be_pd_sync(struct m0_be_pd  *pd,
                                int               nr,
                                struct m0_be_op  *op);
 
+/**
+ * Returns duration of the last completed m0_be_pd_sync() or 0 if there was
+ * none. It can be called without any locks, the value is only a hint.
+ */
+M0_INTERNAL m0_time_t m0_be_pd_sync_cost(const struct m0_be_pd *pd);
+
 /** @} end of be group */
 #endif /* __MOTR_BE_PD_H__ */
 
@@ -28,8 +28,12 @@
 #include "lib/arith.h"          /* max_check */
 #include "lib/errno.h"          /* -ENOSYS */
 #include "lib/memory.h"
+#include "lib/thread.h"         /* m0_thread */
+#include "addb2/addb2.h"        /* M0_ADDB2_ADD */
+#include "be/addb2.h"           /* M0_AVI_BE_RECOVERY */
 #include "be/fmt.h"
 #include "be/log.h"
+#include "be/tx_regmap.h"       /* m0_be_reg_area */
 #include "motr/magic.h"         /* M0_BE_RECOVERY_MAGIC */
 
 /**
@@ -140,8 +144,31 @@
  *
  * <b>Iterative interface for looking over groups that need to be re-applied</b>
  * Recovery provides interface for pick next group for re-applying.
+ *
+ * <b>Parallel recovery</b>
+ * Engine may use several tx groups for recovery
+ * (m0_be_engine_cfg::bec_recovery_group_nr). Each group reads its log record
+ * asynchronously, so the next log records are read and decoded while the
+ * current one is re-applied and placed. Groups re-apply log records strictly
+ * in the log order: a group waits in TGS_REAPPLY phase until the group with
+ * the previous log record is placed.
+ *
+ * Regions of a single log record don't overlap. m0_be_recovery_reapply()
+ * splits the address range of the regions into equal parts and copies each
+ * part on its own thread (m0_be_recovery_cfg::brc_reapply_thread_nr).
+ *
+ * m0_be_recovery_finished() posts recovery throughput to addb2 when recovery
+ * is finished.
  */
 
+struct be_recovery_worker {
+	struct m0_thread       brw_thread;
+	struct m0_be_recovery *brw_rvr;
+	/** Index of the part of the address range handled by the worker. */
+	unsigned               brw_idx;
+	struct m0_semaphore    brw_start;
+};
+
 M0_TL_DESCR_DEFINE(log_record_iter, "m0_be_log_record_iter list in recovery",
 		   static, struct m0_be_log_record_iter, lri_linkage, lri_magic,
 		   M0_BE_RECOVERY_MAGIC, M0_BE_RECOVERY_HEAD_MAGIC);
@@ -150,17 +177,123 @@ M0_TL_DEFINE(log_record_iter, static, struct m0_be_log_record_iter);
 M0_INTERNAL void m0_be_recovery_init(struct m0_be_recovery     *rvr,
                                      struct m0_be_recovery_cfg *cfg)
 {
-	rvr->brec_cfg = *cfg;
+	rvr->brec_cfg         = *cfg;
+	rvr->brec_record_nr   = 0;
+	rvr->brec_record_size = 0;
+	rvr->brec_workers     = NULL;
+	rvr->brec_worker_nr   = 0;
+	rvr->brec_stopping    = false;
 	m0_mutex_init(&rvr->brec_lock);
+	m0_mutex_init(&rvr->brec_reapply_lock);
+	m0_semaphore_init(&rvr->brec_reapply_done, 0);
 	log_record_iter_tlist_init(&rvr->brec_iters);
 }
 
+static void be_recovery_workers_stop(struct m0_be_recovery *rvr);
+
 M0_INTERNAL void m0_be_recovery_fini(struct m0_be_recovery *rvr)
 {
+	be_recovery_workers_stop(rvr);
+	m0_semaphore_fini(&rvr->brec_reapply_done);
+	m0_mutex_fini(&rvr->brec_reapply_lock);
 	m0_mutex_fini(&rvr->brec_lock);
 	log_record_iter_tlist_fini(&rvr->brec_iters);
 }
 
+/** Copies regions which start in the idx-th of nr parts of the range. */
+static void be_recovery_reapply_part(struct m0_be_recovery *rvr,
+				     unsigned idx, unsigned nr)
+{
+	struct m0_be_reg_d *rd;
+	uintptr_t           step;
+	uintptr_t           lo;
+	uintptr_t           hi;
+	uintptr_t           addr;
+
+	step = (rvr->brec_reapply_hi - rvr->brec_reapply_lo + nr - 1) / nr;
+	lo   = rvr->brec_reapply_lo + step * idx;
+	hi   = idx == nr - 1 ? rvr->brec_reapply_hi : lo + step;
+	/* regions in reg_area are sorted by address */
+	M0_BE_REG_AREA_FORALL(rvr->brec_reapply_ra, rd) {
+		addr = (uintptr_t)rd->rd_reg.br_addr;
+		if (addr >= hi)
+			break;
+		if (addr >= lo)
+			memcpy(rd->rd_reg.br_addr, rd->rd_buf,
+			       rd->rd_reg.br_size);
+	}
+}
+
+static void be_recovery_worker_thread(struct be_recovery_worker *w)
+{
+	struct m0_be_recovery *rvr = w->brw_rvr;
+
+	while (true) {
+		m0_semaphore_down(&w->brw_start);
+		if (rvr->brec_stopping)
+			break;
+		be_recovery_reapply_part(rvr, w->brw_idx,
+					 rvr->brec_worker_nr + 1);
+		m0_semaphore_up(&rvr->brec_reapply_done);
+	}
+}
+
+/*
+ * Starts brc_reapply_thread_nr - 1 workers. The thread which calls
+ * m0_be_recovery_reapply() handles part 0 of the range itself. Failure to
+ * start workers is not fatal: regions are re-applied by fewer threads.
+ */
+static void be_recovery_workers_start(struct m0_be_recovery *rvr)
+{
+	struct be_recovery_worker *w;
+	unsigned                   nr = rvr->brec_cfg.brc_reapply_thread_nr;
+	unsigned                   i;
+	int                        rc;
+
+	if (nr <= 1)
+		return;
+	M0_ALLOC_ARR(rvr->brec_workers, nr - 1);
+	if (rvr->brec_workers == NULL) {
+		M0_LOG(M0_WARN, "cannot allocate recovery workers");
+		return;
+	}
+	for (i = 0; i < nr - 1; ++i) {
+		w = &rvr->brec_workers[i];
+		w->brw_rvr = rvr;
+		w->brw_idx = i + 1;
+		m0_semaphore_init(&w->brw_start, 0);
+		rc = M0_THREAD_INIT(&w->brw_thread, struct be_recovery_worker *,
+				    NULL, &be_recovery_worker_thread, w,
+				    "be_rvr%u", i);
+		if (rc != 0) {
+			M0_LOG(M0_WARN, "rc=%d", rc);
+			m0_semaphore_fini(&w->brw_start);
+			break;
+		}
+	}
+	rvr->brec_worker_nr = i;
+	M0_LOG(M0_DEBUG, "recovery workers: %u", rvr->brec_worker_nr);
+}
+
+static void be_recovery_workers_stop(struct m0_be_recovery *rvr)
+{
+	struct be_recovery_worker *w;
+	unsigned                   i;
+
+	rvr->brec_stopping = true;
+	for (i = 0; i < rvr->brec_worker_nr; ++i)
+		m0_semaphore_up(&rvr->brec_workers[i].brw_start);
+	for (i = 0; i < rvr->brec_worker_nr; ++i) {
+		w = &rvr->brec_workers[i];
+		m0_thread_join(&w->brw_thread);
+		m0_thread_fini(&w->brw_thread);
+		m0_semaphore_fini(&w->brw_start);
+	}
+	m0_free(rvr->brec_workers);
+	rvr->brec_workers   = NULL;
+	rvr->brec_worker_nr = 0;
+}
+
 static int be_recovery_log_record_iter_new(struct m0_be_log_record_iter **iter)
 {
 	int rc;
@@ -190,6 +323,7 @@ M0_INTERNAL int m0_be_recovery_run(struct m0_be_recovery *rvr)
 	m0_bindex_t                   last_discarded;
 	m0_bindex_t                   log_discarded;
 	m0_bindex_t                   next_pos = M0_BINDEX_MAX;
+	uint64_t                      last_gen;
 	int                           rc;
 
 	M0_ENTRY("rvr = %p, log = %p", rvr, log);
@@ -213,6 +347,8 @@ M0_INTERNAL int m0_be_recovery_run(struct m0_be_recovery *rvr)
 		rc = rc ?: m0_be_log_record_next(log, prev, iter);
 	}
 	be_recovery_log_record_iter_destroy(iter);
+	/* the next log record is going to be written after the last one */
+	last_gen = prev == NULL ? 0 : prev->lri_header.lrh_gen;
 	if (!M0_IN(rc, (0, -ENOENT))){
 		M0_LOG(M0_ERROR, "Error: rc=%d", rc);
 		goto err;
@@ -260,9 +396,11 @@ M0_INTERNAL int m0_be_recovery_run(struct m0_be_recovery *rvr)
 	}
 
 	iter = log_record_iter_tlist_tail(&rvr->brec_iters);
+	be_recovery_workers_start(rvr);
 
 	rvr->brec_last_record_pos  = iter->lri_header.lrh_pos;
 	rvr->brec_last_record_size = iter->lri_header.lrh_size;
+	rvr->brec_last_record_gen  = last_gen;
 	rvr->brec_current          = rvr->brec_last_record_pos +
 				     rvr->brec_last_record_size;
 	rvr->brec_discarded        = prev->lri_header.lrh_pos;
@@ -289,6 +427,7 @@ empty:
 	rc = 0;
 	rvr->brec_last_record_pos  = log_hdr.flh_group_lsn;
 	rvr->brec_last_record_size = log_hdr.flh_group_size;
+	rvr->brec_last_record_gen  = last_gen;
 	rvr->brec_current          = log_discarded;
 	rvr->brec_discarded        = log_discarded;
 	M0_LOG(M0_DEBUG, "Empty Logs : last_record_pos=%"PRIu64
@@ -326,8 +465,11 @@ m0_be_recovery_log_record_get(struct m0_be_recovery        *rvr,
 
 	m0_mutex_lock(&rvr->brec_lock);
 	next = log_record_iter_tlist_pop(&rvr->brec_iters);
-	m0_mutex_unlock(&rvr->brec_lock);
 	M0_ASSERT(next != NULL);
+	if (rvr->brec_record_nr++ == 0)
+		rvr->brec_start = m0_time_now();
+	rvr->brec_record_size += next->lri_header.lrh_size;
+	m0_mutex_unlock(&rvr->brec_lock);
 	m0_be_log_record_iter_copy(iter, next);
 	log_record_iter_tlink_fini(next);
 	be_recovery_log_record_iter_destroy(next);
@@ -337,6 +479,59 @@ m0_be_recovery_log_record_get(struct m0_be_recovery        *rvr,
 	       iter->lri_header.lrh_discarded);
 }
 
+M0_INTERNAL void m0_be_recovery_reapply(struct m0_be_recovery *rvr,
+					struct m0_be_reg_area *ra)
+{
+	struct m0_be_reg_d *rd;
+	m0_bcount_t         size = 0;
+	uintptr_t           lo = UINTPTR_MAX;
+	uintptr_t           hi = 0;
+	unsigned            nr;
+	unsigned            i;
+
+	M0_BE_REG_AREA_FORALL(ra, rd) {
+		lo = min_check(lo, (uintptr_t)rd->rd_reg.br_addr);
+		hi = max_check(hi, (uintptr_t)rd->rd_reg.br_addr +
+				   (uintptr_t)rd->rd_reg.br_size);
+		size += rd->rd_reg.br_size;
+	}
+	if (size == 0)
+		return;
+
+	m0_mutex_lock(&rvr->brec_reapply_lock);
+	rvr->brec_reapply_ra = ra;
+	rvr->brec_reapply_lo = lo;
+	rvr->brec_reapply_hi = hi;
+	nr = size < M0_BE_RECOVERY_REAPPLY_PARALLEL_MIN ?
+	     0 : rvr->brec_worker_nr;
+	for (i = 0; i < nr; ++i)
+		m0_semaphore_up(&rvr->brec_workers[i].brw_start);
+	be_recovery_reapply_part(rvr, 0, nr == 0 ? 1 : nr + 1);
+	for (i = 0; i < nr; ++i)
+		m0_semaphore_down(&rvr->brec_reapply_done);
+	rvr->brec_reapply_ra = NULL;
+	m0_mutex_unlock(&rvr->brec_reapply_lock);
+}
+
+M0_INTERNAL void m0_be_recovery_finished(struct m0_be_recovery *rvr)
+{
+	m0_time_t duration;
+	uint64_t  mbps;
+
+	be_recovery_workers_stop(rvr);
+	if (rvr->brec_record_nr == 0)
+		return;
+	duration = m0_time_now() - rvr->brec_start;
+	mbps = duration == 0 ? 0 :
+	       (rvr->brec_record_size >> 10) * M0_TIME_ONE_SECOND /
+	       duration >> 10;
+	M0_LOG(M0_INFO, "BE recovery: records=%"PRIu64" bytes=%"PRIu64
+	       " time=%"PRIu64" MB/s=%"PRIu64, rvr->brec_record_nr,
+	       rvr->brec_record_size, duration, mbps);
+	M0_ADDB2_ADD(M0_AVI_BE_RECOVERY, rvr->brec_record_nr,
+		     rvr->brec_record_size, duration, mbps);
+}
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
@@ -27,6 +27,8 @@
 
 #include "lib/tlist.h"          /* m0_tl */
 #include "lib/mutex.h"          /* m0_mutex */
+#include "lib/semaphore.h"      /* m0_semaphore */
+#include "lib/time.h"           /* m0_time_t */
 #include "lib/types.h"          /* bool */
 
 /**
@@ -41,6 +43,9 @@
  *   - Log scanning procedures including all valid log records, last written
  *     log record, pointer to the last discarded log record;
  *   - Interface for pick next log record in order which needs to be re-applied;
+ *   - Re-applying of regions of a log record, optionally on several threads
+ *     (m0_be_recovery_reapply());
+ *   - Recovery throughput report (m0_be_recovery_finished()).
  *
  * @section recovery-fspec-usecases Recipes
  *
@@ -55,19 +60,58 @@
 
 struct m0_be_log;
 struct m0_be_log_record_iter;
+struct m0_be_reg_area;
+struct be_recovery_worker;
+
+enum {
+	/**
+	 * Log records with less than this number of bytes in regions are
+	 * re-applied by the calling thread only.
+	 */
+	M0_BE_RECOVERY_REAPPLY_PARALLEL_MIN = 1 << 16,
+};
 
 struct m0_be_recovery_cfg {
 	struct m0_be_log *brc_log;
+	/**
+	 * Number of threads re-applying regions of a log record. Regions are
+	 * partitioned by address range between the threads. 0 and 1 mean that
+	 * regions are re-applied by the caller of m0_be_recovery_reapply().
+	 */
+	unsigned          brc_reapply_thread_nr;
 };
 
 struct m0_be_recovery {
-	struct m0_be_recovery_cfg brec_cfg;
-	struct m0_mutex           brec_lock;
-	struct m0_tl              brec_iters;
-	m0_bindex_t               brec_last_record_pos;
-	m0_bcount_t               brec_last_record_size;
-	m0_bindex_t               brec_current;
-	m0_bindex_t               brec_discarded;
+	struct m0_be_recovery_cfg  brec_cfg;
+	struct m0_mutex            brec_lock;
+	struct m0_tl               brec_iters;
+	m0_bindex_t                brec_last_record_pos;
+	m0_bcount_t                brec_last_record_size;
+	/** m0_be_fmt_log_record_header::lrh_gen of the last log record */
+	uint64_t                   brec_last_record_gen;
+	m0_bindex_t                brec_current;
+	m0_bindex_t                brec_discarded;
+	/** Number of log records given out by m0_be_recovery_log_record_get */
+	uint64_t                   brec_record_nr;
+	/** Total size of the log records given out. */
+	m0_bcount_t                brec_record_size;
+	/** Time when the first log record was given out. */
+	m0_time_t                  brec_start;
+	/*
+	 * Parallel re-apply. Workers are started by m0_be_recovery_run() if
+	 * there are log records to re-apply and stopped in
+	 * m0_be_recovery_finished().
+	 */
+	struct be_recovery_worker *brec_workers;
+	unsigned                   brec_worker_nr;
+	/** Serialises m0_be_recovery_reapply() calls. */
+	struct m0_mutex            brec_reapply_lock;
+	struct m0_be_reg_area     *brec_reapply_ra;
+	/** Address range of regions being re-applied. */
+	uintptr_t                  brec_reapply_lo;
+	uintptr_t                  brec_reapply_hi;
+	struct m0_semaphore        brec_reapply_done;
+	bool                       brec_stopping;
 };
 
 M0_INTERNAL void m0_be_recovery_init(struct m0_be_recovery     *rvr,
@@ -93,6 +137,24 @@ M0_INTERNAL void
 m0_be_recovery_log_record_get(struct m0_be_recovery        *rvr,
 			      struct m0_be_log_record_iter *iter);
 
+/**
+ * Copies regions of the reg_area to their places in segments.
+ *
+ * Regions of a reg_area don't overlap, so they are copied concurrently by
+ * m0_be_recovery_cfg::brc_reapply_thread_nr threads. The function returns
+ * when all regions are copied. Log records have to be re-applied in the log
+ * order, this is ensured by the caller.
+ */
+M0_INTERNAL void m0_be_recovery_reapply(struct m0_be_recovery *rvr,
+					struct m0_be_reg_area *ra);
+
+/**
+ * Called when all log records are re-applied. Stops re-apply threads, logs and
+ * posts to addb2 (M0_AVI_BE_RECOVERY) the number and the size of log records
+ * re-applied and recovery throughput.
+ */
+M0_INTERNAL void m0_be_recovery_finished(struct m0_be_recovery *rvr);
+
 /** @} end of be group */
 
 #endif /* __MOTR_BE_RECOVERY_H__ */
@@ -30,8 +30,13 @@
 #include "lib/errno.h"        /* ENOMEM */
 #include "lib/time.h"         /* m0_time_now */
 #include "lib/atomic.h"       /* m0_atomic64 */
+#include "lib/arith.h"        /* min_check */
+#include "lib/thread.h"       /* M0_THREAD_INIT */
+#include "lib/semaphore.h"    /* m0_semaphore */
+#include "lib/mutex.h"        /* m0_mutex */
 
 #include "motr/version.h"     /* m0_build_info_get */
+#include "format/format.h"    /* m0_format_header_unpack */
 
 #include "stob/stob.h"        /* m0_stob, m0_stob_fd */
 
@@ -40,6 +45,9 @@
 
 #include <sys/mman.h>         /* mmap */
 #include <search.h>           /* twalk */
+#include <stdio.h>            /* fopen */
+#include <fcntl.h>            /* open */
+#include <unistd.h>           /* write */
 
 /**
  * @addtogroup be
@@ -321,10 +329,303 @@ static void be_seg_madvise(struct m0_be_seg *seg, m0_bcount_t dump_limit,
 
 }
 
+/**
+ * Segment pager.
+ *
+ * Segment is mapped with MAP_PRIVATE, so the kernel faults its pages in from
+ * the backing stob on first access. Pages which were never written are clean
+ * copies of the stob and may be dropped at any time. Written pages are
+ * private and are dropped only if the kernel can swap them out, so
+ * MADV_PAGEOUT never loses data which has not been placed yet.
+ *
+ * The pager scans the segment chunk by chunk, like a CLOCK hand. Resident
+ * pages of a chunk are counted with mincore(). Growth of the count since the
+ * previous scan means that the chunk was accessed (misses), so its age is
+ * reset. Chunks which were not faulted in during BE_SEG_PAGER_AGE_MAX scans
+ * are paged out while the resident set exceeds
+ * m0_be_seg_paging_cfg::bspc_resident_max.
+ *
+ * Accesses to fully resident chunks are invisible to mincore(), so a hot
+ * chunk may be paged out and faulted in again. This costs one extra fault
+ * per scan period for such a chunk.
+ *
+ * Hits are counted from the "Referenced" field of /proc/self/smaps for the
+ * segment mapping, which is the number of pages accessed since the
+ * referenced bits were last cleared through /proc/self/clear_refs. At the end
+ * of each sweep the pages referenced during the sweep minus the misses of the
+ * sweep are added to the hits, and the bits are cleared. Clearing is
+ * process-wide, so the kernel sees all process pages as not recently used
+ * once per sweep. If /proc/self/clear_refs cannot be written, hits are not
+ * counted.
+ */
+enum {
+	BE_SEG_PAGER_AGE_MAX = 2,
+};
+
+struct be_seg_pager_chunk {
+	/** Number of resident pages at the last scan. */
+	uint32_t spc_resident;
+	/** Number of scans since the chunk was faulted in last time. */
+	uint32_t spc_age;
+};
+
+struct be_seg_pager {
+	struct m0_be_seg              *sp_seg;
+	struct m0_be_seg_paging_cfg    sp_cfg;
+	/** Protects the chunks, the hand and the stats. */
+	struct m0_mutex                sp_lock;
+	struct m0_thread               sp_thread;
+	struct m0_semaphore            sp_stop;
+	struct be_seg_pager_chunk     *sp_chunk;
+	uint64_t                       sp_chunk_nr;
+	/** Index of the next chunk to scan. */
+	uint64_t                       sp_hand;
+	/** mincore() vector for one chunk. */
+	unsigned char                 *sp_vec;
+	int                            sp_page_size;
+	struct m0_be_seg_paging_stats  sp_stats;
+	/** /proc/self/clear_refs, -1 if hits are not counted. */
+	int                            sp_refs_fd;
+	/** Misses of the current sweep. */
+	uint64_t                       sp_sweep_miss;
+};
+
+static uint32_t be_seg_pager_resident(struct be_seg_pager *sp,
+				      void *addr, m0_bcount_t size)
+{
+	uint32_t nr = 0;
+	uint64_t i;
+	int      rc;
+
+	rc = mincore(addr, size, sp->sp_vec);
+	if (rc != 0) {
+		M0_LOG(M0_WARN, "mincore(%p, %"PRIu64") = %d errno=%d",
+		       addr, size, rc, errno);
+		return 0;
+	}
+	for (i = 0; i < size / sp->sp_page_size; ++i)
+		nr += sp->sp_vec[i] & 1;
+	return nr;
+}
+
+static void be_seg_pager_chunk_scan(struct be_seg_pager *sp, uint64_t idx)
+{
+	struct be_seg_pager_chunk *chunk = &sp->sp_chunk[idx];
+	struct m0_be_seg          *seg   = sp->sp_seg;
+	m0_bcount_t                size  = sp->sp_cfg.bspc_chunk_size;
+	m0_bcount_t                offset = idx * size;
+	void                      *addr  = seg->bs_addr + offset;
+	uint32_t                   nr;
+
+	M0_PRE(m0_mutex_is_locked(&sp->sp_lock));
+
+	size = min_check(size, seg->bs_size - offset);
+	nr = be_seg_pager_resident(sp, addr, size);
+	if (nr > chunk->spc_resident) {
+		sp->sp_stats.bsps_miss += nr - chunk->spc_resident;
+		sp->sp_sweep_miss      += nr - chunk->spc_resident;
+		chunk->spc_age = 0;
+	} else if (chunk->spc_age < BE_SEG_PAGER_AGE_MAX) {
+		++chunk->spc_age;
+	}
+	sp->sp_stats.bsps_resident += nr;
+	sp->sp_stats.bsps_resident -= chunk->spc_resident;
+#ifdef MADV_PAGEOUT
+	if (nr > 0 && chunk->spc_age == BE_SEG_PAGER_AGE_MAX &&
+	    sp->sp_stats.bsps_resident * sp->sp_page_size >
+	    sp->sp_cfg.bspc_resident_max &&
+	    madvise(addr, size, MADV_PAGEOUT) == 0) {
+		uint32_t left = be_seg_pager_resident(sp, addr, size);
+
+		if (left < nr) {
+			sp->sp_stats.bsps_evicted  += nr - left;
+			sp->sp_stats.bsps_resident -= nr - left;
+			nr = left;
+		}
+	}
+#endif
+	chunk->spc_resident = nr;
+}
+
+/** Clears referenced bits of the process pages. */
+static void be_seg_pager_refs_clear(struct be_seg_pager *sp)
+{
+	if (sp->sp_refs_fd >= 0 &&
+	    pwrite(sp->sp_refs_fd, "1", 1, 0) != 1) {
+		M0_LOG(M0_WARN, "clear_refs: errno=%d, hits are not counted",
+		       errno);
+		close(sp->sp_refs_fd);
+		sp->sp_refs_fd = -1;
+	}
+}
+
+/**
+ * Returns the number of referenced pages of the segment mapping, summed over
+ * all its VMAs in /proc/self/smaps.
+ */
+static uint64_t be_seg_pager_referenced(struct be_seg_pager *sp)
+{
+	struct m0_be_seg *seg   = sp->sp_seg;
+	unsigned long     start = (unsigned long)seg->bs_addr;
+	unsigned long     end   = start + seg->bs_size;
+	unsigned long     lo;
+	unsigned long     hi;
+	unsigned long     kb;
+	uint64_t          nr    = 0;
+	bool              in    = false;
+	char              line[0x100];
+	FILE             *f;
+
+	f = fopen("/proc/self/smaps", "r");
+	if (f == NULL)
+		return 0;
+	while (fgets(line, sizeof line, f) != NULL) {
+		if (sscanf(line, "%lx-%lx ", &lo, &hi) == 2)
+			in = lo >= start && hi <= end;
+		else if (in && sscanf(line, "Referenced: %lu kB", &kb) == 1)
+			nr += kb * 1024 / sp->sp_page_size;
+	}
+	fclose(f);
+	return nr;
+}
+
+/** Accounts hits of the sweep which has just completed. */
+static void be_seg_pager_sweep_end(struct be_seg_pager *sp)
+{
+	uint64_t ref;
+
+	M0_PRE(m0_mutex_is_locked(&sp->sp_lock));
+
+	if (sp->sp_refs_fd >= 0) {
+		ref = be_seg_pager_referenced(sp);
+		if (ref > sp->sp_sweep_miss)
+			sp->sp_stats.bsps_hit += ref - sp->sp_sweep_miss;
+		be_seg_pager_refs_clear(sp);
+	}
+	sp->sp_sweep_miss = 0;
+}
+
+M0_INTERNAL void m0_be_seg_paging_scan(struct m0_be_seg *seg)
+{
+	struct be_seg_pager *sp = seg->bs_pager;
+	uint64_t             i;
+
+	M0_PRE(sp != NULL);
+
+	m0_mutex_lock(&sp->sp_lock);
+	for (i = 0; i < min_check(sp->sp_cfg.bspc_scan_nr, sp->sp_chunk_nr);
+	     ++i) {
+		be_seg_pager_chunk_scan(sp, sp->sp_hand);
+		sp->sp_hand = (sp->sp_hand + 1) % sp->sp_chunk_nr;
+		if (sp->sp_hand == 0)
+			be_seg_pager_sweep_end(sp);
+	}
+	m0_mutex_unlock(&sp->sp_lock);
+}
+
+M0_INTERNAL void m0_be_seg_paging_stats(struct m0_be_seg              *seg,
+					struct m0_be_seg_paging_stats *stats)
+{
+	struct be_seg_pager *sp = seg->bs_pager;
+
+	if (sp == NULL) {
+		*stats = (struct m0_be_seg_paging_stats){};
+		return;
+	}
+	m0_mutex_lock(&sp->sp_lock);
+	*stats = sp->sp_stats;
+	m0_mutex_unlock(&sp->sp_lock);
+}
+
+static void be_seg_pager_thread(struct be_seg_pager *sp)
+{
+	while (!m0_semaphore_timeddown(&sp->sp_stop, m0_time_from_now(0,
+						sp->sp_cfg.bspc_interval)))
+		m0_be_seg_paging_scan(sp->sp_seg);
+}
+
+static void be_seg_pager_free(struct be_seg_pager *sp)
+{
+	if (sp->sp_refs_fd >= 0)
+		close(sp->sp_refs_fd);
+	m0_semaphore_fini(&sp->sp_stop);
+	m0_mutex_fini(&sp->sp_lock);
+	m0_free(sp->sp_vec);
+	m0_free(sp->sp_chunk);
+	m0_free(sp);
+}
+
+M0_INTERNAL int m0_be_seg_paging_start(struct m0_be_seg                  *seg,
+				       const struct m0_be_seg_paging_cfg *cfg)
+{
+	struct be_seg_pager *sp;
+	int                  rc;
+
+	M0_ENTRY("seg=%p resident_max=%"PRIu64, seg, cfg->bspc_resident_max);
+	M0_PRE(seg->bs_state == M0_BSS_OPENED);
+	M0_PRE(seg->bs_pager == NULL);
+	M0_PRE(cfg->bspc_resident_max > 0);
+
+	M0_ALLOC_PTR(sp);
+	if (sp == NULL)
+		return M0_ERR(-ENOMEM);
+	sp->sp_seg       = seg;
+	sp->sp_cfg       = *cfg;
+	sp->sp_page_size = m0_pagesize_get();
+	sp->sp_refs_fd   = open("/proc/self/clear_refs", O_WRONLY);
+	if (sp->sp_refs_fd < 0)
+		M0_LOG(M0_NOTICE, "clear_refs: errno=%d, hits are not counted",
+		       errno);
+	be_seg_pager_refs_clear(sp);
+	if (sp->sp_cfg.bspc_chunk_size == 0)
+		sp->sp_cfg.bspc_chunk_size = M0_BE_SEG_PAGING_CHUNK_SIZE;
+	sp->sp_cfg.bspc_chunk_size = m0_align(sp->sp_cfg.bspc_chunk_size,
+					      sp->sp_page_size);
+	if (sp->sp_cfg.bspc_scan_nr == 0)
+		sp->sp_cfg.bspc_scan_nr = M0_BE_SEG_PAGING_SCAN_NR;
+	if (sp->sp_cfg.bspc_interval == 0)
+		sp->sp_cfg.bspc_interval = M0_BE_SEG_PAGING_INTERVAL_MS *
+					   M0_TIME_ONE_MSEC;
+	sp->sp_chunk_nr = (seg->bs_size + sp->sp_cfg.bspc_chunk_size - 1) /
+			  sp->sp_cfg.bspc_chunk_size;
+	m0_mutex_init(&sp->sp_lock);
+	m0_semaphore_init(&sp->sp_stop, 0);
+	M0_ALLOC_ARR(sp->sp_chunk, sp->sp_chunk_nr);
+	sp->sp_vec = m0_alloc(sp->sp_cfg.bspc_chunk_size / sp->sp_page_size);
+	if (sp->sp_chunk == NULL || sp->sp_vec == NULL) {
+		be_seg_pager_free(sp);
+		return M0_ERR(-ENOMEM);
+	}
+	seg->bs_pager = sp;
+	rc = M0_THREAD_INIT(&sp->sp_thread, struct be_seg_pager *, NULL,
+			    &be_seg_pager_thread, sp, "be_pager");
+	if (rc != 0) {
+		seg->bs_pager = NULL;
+		be_seg_pager_free(sp);
+	}
+	return M0_RC(rc);
+}
+
+static void be_seg_paging_stop(struct m0_be_seg *seg)
+{
+	struct be_seg_pager *sp = seg->bs_pager;
+
+	m0_semaphore_up(&sp->sp_stop);
+	m0_thread_join(&sp->sp_thread);
+	m0_thread_fini(&sp->sp_thread);
+	M0_LOG(M0_INFO, "seg=%p hit=%"PRIu64" miss=%"PRIu64" evicted=%"PRIu64
+	       " resident=%"PRIu64, seg, sp->sp_stats.bsps_hit,
+	       sp->sp_stats.bsps_miss, sp->sp_stats.bsps_evicted,
+	       sp->sp_stats.bsps_resident);
+	seg->bs_pager = NULL;
+	be_seg_pager_free(sp);
+}
+
 M0_INTERNAL int m0_be_seg_open(struct m0_be_seg *seg)
 {
 	const struct m0_be_seg_geom *g;
 	struct m0_be_seg_hdr        *hdr;
+	struct m0_format_tag         tag;
 	const char                  *runtime_be_version;
 	void                        *p;
 	int                          fd;
@@ -344,6 +645,16 @@ M0_INTERNAL int m0_be_seg_open(struct m0_be_seg *seg)
 		return M0_ERR(rc);
 	}
 
+	m0_format_header_unpack(&tag, &hdr->bh_header);
+	if (tag.ot_version != M0_BE_SEG_HDR_FORMAT_VERSION) {
+		rc = M0_ERR_INFO(-EPROTO, "BE segment header version mismatch:"
+				 " expected %u, stored on disk %u",
+				 M0_BE_SEG_HDR_FORMAT_VERSION,
+				 tag.ot_version);
+		m0_free(hdr);
+		return rc;
+	}
+
 	runtime_be_version = m0_build_info_get()->
 				bi_xcode_protocol_be_checksum;
 	if (strncmp(hdr->bh_be_version, runtime_be_version,
@@ -396,6 +707,8 @@ M0_INTERNAL void m0_be_seg_close(struct m0_be_seg *seg)
 	M0_ENTRY("seg=%p", seg);
 	M0_PRE(seg->bs_state == M0_BSS_OPENED);
 
+	if (seg->bs_pager != NULL)
+		be_seg_paging_stop(seg);
 	munmap(seg->bs_addr, seg->bs_size);
 	seg->bs_state = M0_BSS_CLOSED;
 	M0_LEAVE();
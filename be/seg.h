@@ -29,11 +29,13 @@
 
 #include "lib/tlist.h"          /* m0_tlink */
 #include "lib/types.h"          /* m0_bcount_t */
+#include "lib/time.h"           /* m0_time_t */
 
 struct m0_be_op;
 struct m0_be_reg_d;
 struct m0_stob;
 struct m0_stob_id;
+struct be_seg_pager;
 
 /**
  * @defgroup be Meta-data back-end
@@ -58,6 +60,48 @@ enum {
 	M0_BE_SEG_FAKE_ID = ~0,
 	/** Segments' addr, size, offset has to be aligned by this boundary */
 	M0_BE_SEG_PAGE_SIZE = 1ULL << 12,
+	/** Default m0_be_seg_paging_cfg::bspc_chunk_size. */
+	M0_BE_SEG_PAGING_CHUNK_SIZE = 1ULL << 20,
+	/** Default m0_be_seg_paging_cfg::bspc_scan_nr. */
+	M0_BE_SEG_PAGING_SCAN_NR = 0x100,
+	/** Default m0_be_seg_paging_cfg::bspc_interval, in milliseconds. */
+	M0_BE_SEG_PAGING_INTERVAL_MS = 100,
+};
+
+/**
+ * Segment paging configuration.
+ *
+ * Segment memory is mapped from the backing stob and is faulted in on first
+ * access. If bspc_resident_max is not 0, a pager thread bounds the resident
+ * set of the segment by paging out chunks which were not faulted in
+ * recently. Zero fields other than bspc_resident_max mean defaults.
+ *
+ * @see m0_be_seg_paging_start()
+ */
+struct m0_be_seg_paging_cfg {
+	/** Resident set limit of the segment in bytes. 0 disables paging. */
+	m0_bcount_t bspc_resident_max;
+	/** Unit of scanning and paging out, rounded up to the page size. */
+	m0_bcount_t bspc_chunk_size;
+	/** Number of chunks scanned at each pager tick. */
+	uint64_t    bspc_scan_nr;
+	/** Interval between pager ticks. */
+	m0_time_t   bspc_interval;
+};
+
+/** Segment paging statistics. All values are in pages. */
+struct m0_be_seg_paging_stats {
+	/**
+	 * Accesses to resident pages, counted at most once per page per sweep
+	 * of the pager.
+	 */
+	uint64_t bsps_hit;
+	/** Pages faulted in from the backing stob since the previous scan. */
+	uint64_t bsps_miss;
+	/** Pages paged out by the pager. */
+	uint64_t bsps_evicted;
+	/** Resident pages of the segment, as seen by the last scan. */
+	uint64_t bsps_resident;
 };
 
 #define M0_BE_SEG_PG_PRESENT       0x8000000000000000ULL
@@ -80,6 +124,8 @@ struct m0_be_seg {
 	 */
 	struct m0_be_allocator bs_allocator;
 	struct m0_be_domain   *bs_domain;
+	/** Segment pager, NULL if paging is not enabled. */
+	struct be_seg_pager   *bs_pager;
 	int                    bs_state;
 	uint64_t               bs_magic;
 	struct m0_tlink        bs_linkage;
@@ -122,6 +168,23 @@ M0_INTERNAL bool m0_be_seg__invariant(const struct m0_be_seg *seg);
 M0_INTERNAL int m0_be_seg_open(struct m0_be_seg *seg);
 M0_INTERNAL void m0_be_seg_close(struct m0_be_seg *seg);
 
+/**
+ * Starts the pager of an opened segment.
+ *
+ * The pager is stopped in m0_be_seg_close().
+ */
+M0_INTERNAL int m0_be_seg_paging_start(struct m0_be_seg                  *seg,
+				       const struct m0_be_seg_paging_cfg *cfg);
+/**
+ * Scans the next m0_be_seg_paging_cfg::bspc_scan_nr chunks of the segment
+ * and pages out cold chunks if the resident set limit is exceeded.
+ *
+ * It's called by the pager thread. UT may call it directly.
+ */
+M0_INTERNAL void m0_be_seg_paging_scan(struct m0_be_seg *seg);
+M0_INTERNAL void m0_be_seg_paging_stats(struct m0_be_seg              *seg,
+					struct m0_be_seg_paging_stats *stats);
+
 /** Creates the segment of specified size on the storage. */
 M0_INTERNAL int m0_be_seg_create(struct m0_be_seg *seg,
 				 m0_bcount_t size,
@@ -59,13 +59,14 @@ struct m0_be_seg_hdr {
 
 enum m0_be_seg_hdr_format_version {
 	M0_BE_SEG_HDR_FORMAT_VERSION_1 = 1,
+	/** m0_be_allocator_header::bah_mag is added. */
+	M0_BE_SEG_HDR_FORMAT_VERSION_2,
 
 	/* future versions, uncomment and update M0_BE_SEG_HDR_FORMAT_VERSION */
-	/*M0_BE_SEG_HDR_FORMAT_VERSION_2,*/
 	/*M0_BE_SEG_HDR_FORMAT_VERSION_3,*/
 
 	/** Current version, should point to the latest version present */
-	M0_BE_SEG_HDR_FORMAT_VERSION = M0_BE_SEG_HDR_FORMAT_VERSION_1
+	M0_BE_SEG_HDR_FORMAT_VERSION = M0_BE_SEG_HDR_FORMAT_VERSION_2
 };
 
 /** @} end of be group */
@@ -146,6 +146,11 @@ struct recops {
 	int (*ro_proc) (struct scanner *s, struct rectype *r, char *buf);
 	int (*ro_ver)  (struct scanner *s, struct rectype *r, char *buf);
 	int (*ro_check)(struct scanner *s, struct rectype *r, char *buf);
+	/**
+	 * Returns true for a tag of another record version, which ro_proc()
+	 * and ro_check() understand as well.
+	 */
+	bool (*ro_tag)(const struct rectype *r, const struct m0_format_tag *tag);
 };
 
 struct bstats {
@@ -1162,7 +1167,9 @@ static int recdo(struct scanner *s, const struct m0_format_tag *tag,
 	buf = alloca(size);
 	result = get(s, buf, size);
 	if (result == 0) {
-		if (memcmp(tag, &r->r_tag, sizeof *tag) == 0) {
+		if (memcmp(tag, &r->r_tag, sizeof *tag) == 0 ||
+		    (r->r_ops != NULL && r->r_ops->ro_tag != NULL &&
+		     r->r_ops->ro_tag(r, tag))) {
 			/**
 			 * Check generation identifier before format footer
 			 * verification. Only process the records whose
@@ -1299,6 +1306,14 @@ static int btree_check(struct scanner *s, struct rectype *r, char *buf)
 	return generation_id_verify(s, tree->bb_backlink.bli_gen);
 }
 
+/** Trees with inline keys differ in version only. */
+static bool btree_tag(const struct rectype *r, const struct m0_format_tag *tag)
+{
+	return tag->ot_version == M0_BE_BTREE_FORMAT_VERSION_2 &&
+		tag->ot_type == r->r_tag.ot_type &&
+		tag->ot_footer_offset == r->r_tag.ot_footer_offset;
+}
+
 static void *scanner_action(size_t len, enum action_opcode opc,
 			    const struct action_ops *ops)
 {
@@ -1348,13 +1363,40 @@ static int bnode(struct scanner *s, struct rectype *r, char *buf)
 	return 0;
 }
 
+/**
+ * Returns the size of inline key slots of a M0_BE_BNODE_FORMAT_VERSION_2 node
+ * with the given tag, 0 if the tag is not of such a node.
+ */
+static m0_bcount_t bnode_tag_ksize(const struct m0_format_tag *tag)
+{
+	m0_bcount_t slots = tag->ot_footer_offset - sizeof(struct m0_be_bnode);
+	m0_bcount_t ksize = slots / KV_NR;
+
+	return tag->ot_version == M0_BE_BNODE_FORMAT_VERSION_2 &&
+		tag->ot_type == M0_FORMAT_TYPE_BE_BNODE &&
+		tag->ot_footer_offset > sizeof(struct m0_be_bnode) &&
+		slots % KV_NR == 0 && ksize <= BTREE_INLINE_KEY_MAX &&
+		m0_is_aligned(ksize, sizeof(void *)) ? ksize : 0;
+}
+
+/** Nodes with inline keys, see be/btree_internal.h. */
+static bool bnode_tag(const struct rectype *r, const struct m0_format_tag *tag)
+{
+	return bnode_tag_ksize(tag) != 0;
+}
+
 static int bnode_check(struct scanner *s, struct rectype *r, char *buf)
 {
-	struct m0_be_bnode *node = (void *)buf;
-	int                 idx  = node->bt_backlink.bli_type;
+	struct m0_be_bnode  *node = (void *)buf;
+	int                  idx  = node->bt_backlink.bli_type;
+	struct m0_format_tag tag;
 
 	if (!IS_IN_ARRAY(idx, bt) || bt[idx].b_type == 0)
 		return -ENOENT;
+	m0_format_header_unpack(&tag, &node->bt_header);
+	if (tag.ot_version == M0_BE_BNODE_FORMAT_VERSION_2 &&
+	    node->bt_ksize != bnode_tag_ksize(&tag))
+		return -EPROTO;
 
 	return generation_id_verify(s, node->bt_backlink.bli_gen);
 }
@@ -2419,7 +2461,13 @@ static bool btree_node_post_is_valid(const struct m0_be_bnode *node,
 static bool btree_kv_is_valid(struct m0_be_bnode *node,
 			      int index, struct m0_buf *key)
 {
+	struct m0_format_tag tag;
+
 	M0_PRE(node != NULL);
+	m0_format_header_unpack(&tag, &node->bt_header);
+	/* Keys of version 2 nodes are in the nodes, not before values. */
+	if (tag.ot_version == M0_BE_BNODE_FORMAT_VERSION_2)
+		return key->b_nob <= node->bt_ksize;
 	return m0_align(key->b_nob, sizeof(void *)) ==
 		(uint64_t)node->bt_kv_arr[index].btree_val -
 		(uint64_t)node->bt_kv_arr[index].btree_key;
@@ -2892,12 +2940,14 @@ static bool isqempty(struct queue *q)
 }
 static const struct recops btreeops = {
 	.ro_proc  = &btree,
-	.ro_check = &btree_check
+	.ro_check = &btree_check,
+	.ro_tag   = &btree_tag
 };
 
 static const struct recops bnodeops = {
 	.ro_proc  = &bnode,
-	.ro_check = &bnode_check
+	.ro_check = &bnode_check,
+	.ro_tag   = &bnode_tag
 };
 
 static const struct recops seghdrops = {
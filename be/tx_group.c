@@ -216,6 +216,7 @@ M0_INTERNAL int m0_be_tx_group_init(struct m0_be_tx_group     *gr,
 		.gfc_log = gr_cfg->tgc_log,
 		.gfc_log_discard = gr_cfg->tgc_log_discard,
 		.gfc_pd = gr_cfg->tgc_pd,
+		.gfc_compress = gr_cfg->tgc_log_compress,
 	};
 	/* XXX temporary block begin */
 	gr->tg_size             = gr_cfg->tgc_size_max;
@@ -435,9 +436,17 @@ M0_INTERNAL void m0_be_tx_group_encode(struct m0_be_tx_group *gr)
 M0_INTERNAL void m0_be_tx_group_log_write(struct m0_be_tx_group *gr,
 					  struct m0_be_op       *op)
 {
+	gr->tg_log_write_start = m0_time_now();
 	m0_be_group_format_log_write(&gr->tg_od, op);
 }
 
+M0_INTERNAL void m0_be_tx_group_logged(struct m0_be_tx_group *gr)
+{
+	M0_PRE(!gr->tg_recovering);
+	m0_be_engine__group_logged(gr->tg_engine,
+				   m0_time_now() - gr->tg_log_write_start);
+}
+
 M0_INTERNAL void
 m0_be_tx_group__tx_state_post(struct m0_be_tx_group *gr,
 			      enum m0_be_tx_state    state,
@@ -613,6 +622,11 @@ m0_be_tx_group_reconstruct_tx_close(struct m0_be_tx_group *gr,
 	} m0_tl_endfor;
 }
 
+M0_INTERNAL bool m0_be_tx_group_reapply_may(struct m0_be_tx_group *gr)
+{
+	return m0_be_engine__recovery_reapply_may(gr->tg_engine, gr);
+}
+
 /*
  * It will perform actual I/O when paged implemented so op is added
  * to the function parameters list.
@@ -620,18 +634,18 @@ m0_be_tx_group_reconstruct_tx_close(struct m0_be_tx_group *gr,
 M0_INTERNAL int m0_be_tx_group_reapply(struct m0_be_tx_group *gr,
 				       struct m0_be_op       *op)
 {
-	struct m0_be_reg_d *rd;
-
 	m0_be_op_active(op);
-
-	M0_BE_REG_AREA_FORALL(&gr->tg_reg_area, rd) {
-		memcpy(rd->rd_reg.br_addr, rd->rd_buf, rd->rd_reg.br_size);
-	};
-
+	m0_be_log_recovery_reapply(gr->tg_log, &gr->tg_reg_area);
 	m0_be_op_done(op);
 	return 0;
 }
 
+M0_INTERNAL void m0_be_tx_group_recovery_placed(struct m0_be_tx_group *gr)
+{
+	M0_PRE(gr->tg_recovering);
+	m0_be_engine__recovery_placed(gr->tg_engine, gr);
+}
+
 M0_INTERNAL void m0_be_tx_group_discard(struct m0_be_log_discard      *ld,
                                         struct m0_be_log_discard_item *ldi)
 {
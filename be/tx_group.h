@@ -64,6 +64,8 @@ struct m0_be_tx_group_cfg {
 	 * Total size is calculated as sum of tx payload size.
 	 */
 	m0_bcount_t		       tgc_payload_max;
+	/** Compress log records. @see m0_be_group_format_cfg::gfc_compress */
+	bool			       tgc_log_compress;
 	/** domain contains tgc_engine. */
 	struct m0_be_domain	      *tgc_domain;
 	/** engine the group belongs to. */
@@ -134,6 +136,11 @@ struct m0_be_tx_group {
 	struct m0_be_tx_group_fom  tg_fom;
 	struct m0_be_reg_area      tg_reg_area;
 	bool                       tg_recovering;
+	/**
+	 * Position of the log record of a recovering group in the sequence of
+	 * log records being recovered. Is set by the engine.
+	 */
+	uint64_t                   tg_recovery_seq;
 	struct m0_be_reg_area_merger  tg_merger;
 	/**
 	 * Fields for BE engine
@@ -142,6 +149,8 @@ struct m0_be_tx_group {
 	struct m0_sm_ast           tg_close_timer_arm;
 	struct m0_sm_ast           tg_close_timer_disarm;
 	m0_time_t                  tg_close_deadline;
+	/** Time when the log record write is started. */
+	m0_time_t                  tg_log_write_start;
 	/** Group state. Is used and set by the engine. */
 	enum m0_be_tx_group_state  tg_state;
 };
@@ -213,6 +222,8 @@ M0_INTERNAL void m0_be_tx_group_encode(struct m0_be_tx_group *gr);
 
 M0_INTERNAL void m0_be_tx_group_log_write(struct m0_be_tx_group *gr,
 					  struct m0_be_op       *op);
+/** Notifies the engine that the log record of the group is written. */
+M0_INTERNAL void m0_be_tx_group_logged(struct m0_be_tx_group *gr);
 
 /* ------------------------------------------------------------------
  *                      Interfaces used by recovery.
@@ -231,8 +242,15 @@ M0_INTERNAL void m0_be_tx_group_reconstruct_tx_open(struct m0_be_tx_group *gr,
 M0_INTERNAL void
 m0_be_tx_group_reconstruct_tx_close(struct m0_be_tx_group *gr,
                                     struct m0_be_op       *op_gc);
+/**
+ * Returns true iff log records of all recovering groups which precede this one
+ * in the log are placed, so the group can re-apply its log record.
+ */
+M0_INTERNAL bool m0_be_tx_group_reapply_may(struct m0_be_tx_group *gr);
 M0_INTERNAL int m0_be_tx_group_reapply(struct m0_be_tx_group *gr,
 				       struct m0_be_op       *op);
+/** Notifies the engine that the log record of the group is placed. */
+M0_INTERNAL void m0_be_tx_group_recovery_placed(struct m0_be_tx_group *gr);
 
 /* ------------------------------------------------------------------
  *                      Interfaces used by domain.
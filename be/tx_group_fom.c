@@ -94,6 +94,10 @@ enum tx_group_fom_state {
 	TGS_RECONSTRUCT,        /* XXX rename it? */
 	TGS_TX_OPEN,            /* XXX rename it? */
 	TGS_TX_CLOSE,           /* XXX rename it? */
+	/**
+	 * Waits until log records preceding the one of the group are placed,
+	 * then re-applies the log record.
+	 */
 	TGS_REAPPLY,            /* XXX rename it? */
 	/** In-place (segment) stobio is in progress. */
 	TGS_PLACING,
@@ -202,11 +206,16 @@ static int tx_group_fom_tick(struct m0_fom *fom)
 		m0_fom_phase_set(fom, TGS_REAPPLY);
 		return M0_FSO_AGAIN;
 	case TGS_REAPPLY:
+		/* woken up by m0_be_tx_group_fom_reapply() */
+		if (!m0_be_tx_group_reapply_may(gr))
+			return M0_FSO_WAIT;
 		m0_be_op_reset(op);
 		rc = m0_be_tx_group_reapply(gr, op);
 		M0_ASSERT_INFO(rc == 0, "rc = %d", rc); /* XXX notify engine */
 		return m0_be_op_tick_ret(op, fom, TGS_PLACING);
 	case TGS_PLACING:
+		if (!m->tgf_recovery_mode)
+			m0_be_tx_group_logged(gr);
 		m0_be_tx_group__tx_state_post(gr, M0_BTS_LOGGED, false);
 		m0_be_op_reset(op);
 		m0_be_tx_group_seg_place_prepare(gr);
@@ -214,6 +223,8 @@ static int tx_group_fom_tick(struct m0_fom *fom)
 		return m0_be_op_tick_ret(op, fom, TGS_PLACED);
 	case TGS_PLACED:
 		m0_be_tx_group__tx_state_post(gr, M0_BTS_PLACED, true);
+		if (m->tgf_recovery_mode)
+			m0_be_tx_group_recovery_placed(gr);
 		m0_fom_phase_set(fom, TGS_STABILIZING);
 		return M0_FSO_AGAIN;
 	case TGS_STABILIZING:
@@ -317,6 +328,18 @@ static void be_tx_group_fom_stable(struct m0_sm_group *_, struct m0_sm_ast *ast)
 	M0_LEAVE();
 }
 
+static void be_tx_group_fom_reapply(struct m0_sm_group *_,
+				    struct m0_sm_ast   *ast)
+{
+	struct m0_be_tx_group_fom *m = M0_AMB(m, ast, tgf_ast_reapply);
+
+	M0_ENTRY();
+	/* the fom may be waiting for I/O in other phases */
+	if (m0_fom_phase(&m->tgf_gen) == TGS_REAPPLY)
+		be_tx_group_fom_iff_waiting_wakeup(&m->tgf_gen);
+	M0_LEAVE();
+}
+
 static void be_tx_group_fom_stop(struct m0_sm_group *gr, struct m0_sm_ast *ast)
 {
 	struct m0_be_tx_group_fom *m = M0_AMB(m, ast, tgf_ast_stop);
@@ -346,6 +369,7 @@ M0_INTERNAL void m0_be_tx_group_fom_init(struct m0_be_tx_group_fom *m,
 	m->tgf_ast_handle  = _AST(be_tx_group_fom_handle);
 	m->tgf_ast_stable  = _AST(be_tx_group_fom_stable);
 	m->tgf_ast_stop    = _AST(be_tx_group_fom_stop);
+	m->tgf_ast_reapply = _AST(be_tx_group_fom_reapply);
 #undef _AST
 
 	m0_semaphore_init(&m->tgf_start_sem, 0);
@@ -414,6 +438,11 @@ M0_INTERNAL void m0_be_tx_group_fom_stable(struct m0_be_tx_group_fom *gf)
 	be_tx_group_fom_ast_post(gf, &gf->tgf_ast_stable);
 }
 
+M0_INTERNAL void m0_be_tx_group_fom_reapply(struct m0_be_tx_group_fom *gf)
+{
+	be_tx_group_fom_ast_post(gf, &gf->tgf_ast_reapply);
+}
+
 M0_INTERNAL struct m0_sm_group *
 m0_be_tx_group_fom__sm_group(struct m0_be_tx_group_fom *m)
 {
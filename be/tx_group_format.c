@@ -34,6 +34,9 @@
 #include "lib/memory.h"      /* m0_alloc */
 #include "lib/misc.h"        /* M0_SET0 */
 #include "lib/errno.h"       /* ENOMEM */
+#include "lib/lz.h"          /* m0_lz_compress */
+#include "lib/finject.h"     /* M0_FI_ENABLED */
+#include "motr/magic.h"      /* M0_BE_GROUP_FORMAT_LZ_MAGIC */
 
 #include "module/instance.h" /* m0_get */
 
@@ -41,6 +44,19 @@
  * @addtogroup be
  *
  * @{
+ *
+ * * Compressed log records
+ * If m0_be_group_format_cfg::gfc_compress is set, the group is encoded into
+ * m0_be_group_format::gft_zbuf in m0_be_group_format_log_use() and compressed
+ * (lib/lz.h) into the GFT_GROUP_IO buffer of the log record. The record size,
+ * and therefore the log space used, is the compressed size. Unused part of the
+ * log space reserved for the group is returned to the log.
+ *
+ * Commit block of a compressed group has gcb_magic set to
+ * M0_BE_GROUP_FORMAT_LZ_MAGIC and gcb_size set to the uncompressed size.
+ * Uncompressed groups have zero commit block, so
+ * m0_be_group_format_decode() handles both kinds of records. The group is
+ * stored uncompressed if compression doesn't make it smaller.
  */
 
 #define gft_fmt_group_choose(gft) (gft->gft_fmt_group_decoded != NULL ? \
@@ -73,6 +89,9 @@ static int be_group_format_level_enter(struct m0_module *module)
 		gft->gft_log                = gft->gft_cfg.gfc_log;
 		gft->gft_fmt_group_decoded  = NULL;
 		gft->gft_fmt_cblock_decoded = NULL;
+		gft->gft_lz                 = NULL;
+		gft->gft_zbuf               = NULL;
+		gft->gft_zbuf_size          = 0;
 		return 0;
 	case M0_BE_GROUP_FORMAT_LEVEL_OP_INIT:
 		m0_be_op_init(&gft->gft_pd_io_get);
@@ -101,6 +120,21 @@ static int be_group_format_level_enter(struct m0_module *module)
 		return 0;
 	case M0_BE_GROUP_FORMAT_LEVEL_LOG_RECORD_ALLOCATE:
 		return m0_be_log_record_allocate(&gft->gft_log_record);
+	case M0_BE_GROUP_FORMAT_LEVEL_LZ_ALLOCATE:
+		if (!gft->gft_cfg.gfc_compress)
+			return 0;
+		size_group = m0_be_fmt_group_size_max(&gft->gft_cfg.gfc_fmt_cfg);
+		M0_ALLOC_PTR(gft->gft_lz);
+		gft->gft_zbuf = m0_alloc(size_group);
+		if (gft->gft_lz == NULL || gft->gft_zbuf == NULL) {
+			m0_free(gft->gft_zbuf);
+			m0_free(gft->gft_lz);
+			gft->gft_zbuf = NULL;
+			gft->gft_lz   = NULL;
+			return M0_ERR(-ENOMEM);
+		}
+		gft->gft_zbuf_size = size_group;
+		return 0;
 	case M0_BE_GROUP_FORMAT_LEVEL_ALLOCATED:
 		return 0;
 	default:
@@ -144,6 +178,14 @@ static void be_group_format_level_leave(struct m0_module *module)
 	case M0_BE_GROUP_FORMAT_LEVEL_LOG_RECORD_ALLOCATE:
 		m0_be_log_record_deallocate(&gft->gft_log_record);
 		break;
+	case M0_BE_GROUP_FORMAT_LEVEL_LZ_ALLOCATE:
+		/* gft_zbuf may be allocated in m0_be_group_format_decode() */
+		m0_free(gft->gft_zbuf);
+		m0_free(gft->gft_lz);
+		gft->gft_zbuf      = NULL;
+		gft->gft_zbuf_size = 0;
+		gft->gft_lz        = NULL;
+		break;
 	case M0_BE_GROUP_FORMAT_LEVEL_ALLOCATED:
 		if (gft->gft_fmt_group_decoded != NULL) {
 			m0_be_fmt_group_decoded_free(gft->gft_fmt_group_decoded);
@@ -164,6 +206,8 @@ M0_INTERNAL void m0_be_group_format_reset(struct m0_be_group_format *gft)
 {
 	m0_be_fmt_group_reset(&gft->gft_fmt_group);
 	m0_be_fmt_cblock_reset(&gft->gft_fmt_cblock);
+	M0_SET0(&gft->gft_fmt_cblock);
+	gft->gft_compressed = false;
 	m0_be_log_record_reset(&gft->gft_log_record);
 	if (gft->gft_pd_io != NULL) {
 		m0_be_pd_io_put(gft->gft_cfg.gfc_pd, gft->gft_pd_io);
@@ -238,6 +282,11 @@ static const struct m0_modlev be_group_format_levels[] = {
 		.ml_enter = be_group_format_level_enter,
 		.ml_leave = be_group_format_level_leave,
 	},
+	[M0_BE_GROUP_FORMAT_LEVEL_LZ_ALLOCATE] = {
+		.ml_name  = "M0_BE_GROUP_FORMAT_LEVEL_LZ_ALLOCATE",
+		.ml_enter = be_group_format_level_enter,
+		.ml_leave = be_group_format_level_leave,
+	},
 	[M0_BE_GROUP_FORMAT_LEVEL_ALLOCATED] = {
 		.ml_name  = "M0_BE_GROUP_FORMAT_LEVEL_ALLOCATED",
 		.ml_enter = be_group_format_level_enter,
@@ -330,11 +379,14 @@ M0_INTERNAL void m0_be_group_format_encode(struct m0_be_group_format *gft)
 	struct m0_bufvec        *bvec;
 	int                      rc;
 
-	bvec = m0_be_log_record_io_bufvec(&gft->gft_log_record, GFT_GROUP_IO);
-	m0_bufvec_cursor_init(&cur, bvec);
-	rc = m0_be_fmt_group_encode(&gft->gft_fmt_group, &cur);
-	M0_ASSERT_INFO(rc == 0, "due to preallocated buffers "
-		       "encode can't fail here: rc = %d", rc);
+	if (!gft->gft_compressed) {
+		bvec = m0_be_log_record_io_bufvec(&gft->gft_log_record,
+						  GFT_GROUP_IO);
+		m0_bufvec_cursor_init(&cur, bvec);
+		rc = m0_be_fmt_group_encode(&gft->gft_fmt_group, &cur);
+		M0_ASSERT_INFO(rc == 0, "due to preallocated buffers "
+			       "encode can't fail here: rc = %d", rc);
+	}
 	bvec = m0_be_log_record_io_bufvec(&gft->gft_log_record, GFT_GROUP_CB_IO);
 	m0_bufvec_cursor_init(&cur, bvec);
 	rc = m0_be_fmt_cblock_encode(&gft->gft_fmt_cblock, &cur);
@@ -342,25 +394,66 @@ M0_INTERNAL void m0_be_group_format_encode(struct m0_be_group_format *gft)
 		       "encode can't fail here: rc = %d", rc);
 }
 
+static int be_group_format_decompress(struct m0_be_group_format *gft,
+				      struct m0_bufvec          *bvec,
+				      m0_bcount_t                size)
+{
+	struct m0_buf buf;
+	m0_bcount_t   size_max;
+	int           rc;
+
+	M0_ENTRY("gft=%p size=%"PRIu64, gft, size);
+	M0_PRE(bvec->ov_vec.v_nr == 1);
+
+	/* one byte of compressed data expands to at most 255 bytes */
+	size_max = bvec->ov_vec.v_count[0] * 0xff;
+	if (size > size_max)
+		return M0_ERR_INFO(-EPROTO, "size=%"PRIu64" size_max=%"PRIu64,
+				   size, size_max);
+	if (size > gft->gft_zbuf_size) {
+		m0_free(gft->gft_zbuf);
+		gft->gft_zbuf      = m0_alloc(size);
+		gft->gft_zbuf_size = gft->gft_zbuf == NULL ? 0 : size;
+		if (gft->gft_zbuf == NULL)
+			return M0_ERR(-ENOMEM);
+	}
+	rc = m0_lz_decompress(bvec->ov_buf[0], bvec->ov_vec.v_count[0],
+			      gft->gft_zbuf, size, &buf.b_nob);
+	if (rc == 0 && buf.b_nob != size)
+		rc = M0_ERR(-EPROTO);
+	if (rc != 0)
+		return M0_ERR(rc);
+	buf.b_addr = gft->gft_zbuf;
+	rc = m0_be_fmt_group_decode_buf(&gft->gft_fmt_group_decoded, &buf,
+					M0_BE_FMT_DECODE_CFG_DEFAULT);
+	return M0_RC(rc);
+}
+
 M0_INTERNAL int m0_be_group_format_decode(struct m0_be_group_format *gft)
 {
 	struct m0_bufvec_cursor  cur;
 	struct m0_bufvec        *bvec;
 	int                      rc;
 
+	struct m0_be_fmt_cblock *cblock;
+
 	M0_PRE(gft->gft_fmt_group_decoded == NULL);
 	M0_PRE(gft->gft_fmt_cblock_decoded == NULL);
 
-	bvec = m0_be_log_record_io_bufvec(&gft->gft_log_record, GFT_GROUP_IO);
+	bvec = m0_be_log_record_io_bufvec(&gft->gft_log_record, GFT_GROUP_CB_IO);
 	m0_bufvec_cursor_init(&cur, bvec);
-	rc = m0_be_fmt_group_decode(&gft->gft_fmt_group_decoded, &cur,
-				    M0_BE_FMT_DECODE_CFG_DEFAULT);
+	rc = m0_be_fmt_cblock_decode(&gft->gft_fmt_cblock_decoded,
+				     &cur, M0_BE_FMT_DECODE_CFG_DEFAULT);
+	if (rc != 0)
+		return M0_RC(rc);
+	cblock = gft->gft_fmt_cblock_decoded;
 
-	bvec = m0_be_log_record_io_bufvec(&gft->gft_log_record, GFT_GROUP_CB_IO);
+	bvec = m0_be_log_record_io_bufvec(&gft->gft_log_record, GFT_GROUP_IO);
+	if (cblock->gcb_magic == M0_BE_GROUP_FORMAT_LZ_MAGIC)
+		return be_group_format_decompress(gft, bvec, cblock->gcb_size);
 	m0_bufvec_cursor_init(&cur, bvec);
-	rc = rc ?: m0_be_fmt_cblock_decode(&gft->gft_fmt_cblock_decoded,
-					   &cur, M0_BE_FMT_DECODE_CFG_DEFAULT);
-	return rc;
+	return m0_be_fmt_group_decode(&gft->gft_fmt_group_decoded, &cur,
+				      M0_BE_FMT_DECODE_CFG_DEFAULT);
 }
 
 M0_INTERNAL void m0_be_group_format_reg_log_add(struct m0_be_group_format *gft,
@@ -463,6 +556,40 @@ m0_be_group_format_log_discarded(const struct m0_be_group_format *gft)
 	return m0_be_log_record_discarded(&gft->gft_log_record);
 }
 
+/*
+ * Encodes the group into gft_zbuf and compresses it into the log record.
+ * Returns size of the group in the log record.
+ */
+static m0_bcount_t be_group_format_compress(struct m0_be_group_format *gft,
+					    m0_bcount_t                size)
+{
+	struct m0_be_log_record *record = &gft->gft_log_record;
+	struct m0_bufvec        *bvec;
+	struct m0_buf            buf;
+	m0_bcount_t              size_lz;
+	int                      rc;
+
+	M0_PRE(size <= gft->gft_zbuf_size);
+
+	buf = M0_BUF_INIT(size, gft->gft_zbuf);
+	rc = m0_be_fmt_group_encode_buf(&gft->gft_fmt_group, &buf);
+	M0_ASSERT_INFO(rc == 0, "due to preallocated buffers "
+		       "encode can't fail here: rc = %d", rc);
+	m0_be_log_record_io_size_set(record, GFT_GROUP_IO, size);
+	bvec = m0_be_log_record_io_bufvec(record, GFT_GROUP_IO);
+	M0_ASSERT(bvec->ov_vec.v_nr == 1);
+	size_lz = m0_lz_compress(gft->gft_lz, gft->gft_zbuf, size,
+				 bvec->ov_buf[0], size);
+	M0_LOG(M0_DEBUG, "gft=%p size=%"PRIu64" size_lz=%"PRIu64,
+	       gft, size, size_lz);
+	if (size_lz == 0 || size_lz >= size)
+		return size;
+	gft->gft_compressed = true;
+	gft->gft_fmt_cblock.gcb_magic = M0_BE_GROUP_FORMAT_LZ_MAGIC;
+	gft->gft_fmt_cblock.gcb_size  = size;
+	return size_lz;
+}
+
 M0_INTERNAL void
 m0_be_group_format_log_use(struct m0_be_group_format *gft,
 			   m0_bcount_t                size_reserved)
@@ -472,6 +599,8 @@ m0_be_group_format_log_use(struct m0_be_group_format *gft,
 	m0_bcount_t              size_cblock;
 
 	size_group  = m0_be_fmt_group_size(&gft->gft_fmt_group);
+	if (gft->gft_cfg.gfc_compress)
+		size_group = be_group_format_compress(gft, size_group);
 	size_cblock = m0_be_fmt_cblock_size(&gft->gft_fmt_cblock);
 
 	M0_LOG(M0_DEBUG, "size_reserved=%" PRId64 " size_group=%" PRId64 " "
@@ -576,6 +705,13 @@ M0_INTERNAL void m0_be_group_format_seg_place(struct m0_be_group_format *gft,
 	m0_be_op_callback_set(gft_op, &be_tx_group_format_seg_io_op_gc,
 	                      gft, M0_BOS_GC);
 	M0_LOG(M0_DEBUG, "seg_place ldi=%p", gft->gft_log_discard_item);
+	/*
+	 * Leaves the segments unmodified while keeping the I/O in the pd
+	 * scheduler order. UT uses it to get log records that can only be
+	 * applied by recovery.
+	 */
+	if (M0_FI_ENABLED("skip_seg_io"))
+		m0_be_io_reset(m0_be_pd_io_be_io(gft->gft_pd_io));
 	m0_be_pd_io_add(gft->gft_cfg.gfc_pd, gft->gft_pd_io, &gft->gft_ext,
 			gft_op);
 }
@@ -79,6 +79,7 @@
 
 struct m0_be_tx_group;
 struct m0_be_log;
+struct m0_lz_ctx;
 
 typedef void (*m0_be_group_format_reg_area_rebuild_t)
 	(struct m0_be_reg_area *ra,
@@ -96,6 +97,7 @@ enum {
 	M0_BE_GROUP_FORMAT_LEVEL_LOG_RECORD_ITER_INIT,
 	M0_BE_GROUP_FORMAT_LEVEL_INITED,
 	M0_BE_GROUP_FORMAT_LEVEL_LOG_RECORD_ALLOCATE,
+	M0_BE_GROUP_FORMAT_LEVEL_LZ_ALLOCATE,
 	M0_BE_GROUP_FORMAT_LEVEL_ALLOCATED,
 };
 
@@ -104,6 +106,15 @@ struct m0_be_group_format_cfg {
 	struct m0_be_log           *gfc_log;
 	struct m0_be_log_discard   *gfc_log_discard;
 	struct m0_be_pd            *gfc_pd;
+	/**
+	 * Compress group in the log record.
+	 *
+	 * Compressed and uncompressed log records are decoded regardless of
+	 * this field.
+	 *
+	 * @see m0_be_group_format_log_use()
+	 */
+	bool                        gfc_compress;
 };
 
 struct m0_be_group_format {
@@ -129,6 +140,16 @@ struct m0_be_group_format {
 	struct m0_be_op                gft_log_discard_get;
 	/** Workaround because m0_be_op_tick_ret() needs M0_BOS_ACTIVE state */
 	struct m0_be_op                gft_all_get;
+	/** Compressor state, allocated if gfc_compress is set. */
+	struct m0_lz_ctx              *gft_lz;
+	/**
+	 * Uncompressed group: the encoded group before compression or the
+	 * decompressed group before decoding.
+	 */
+	void                          *gft_zbuf;
+	m0_bcount_t                    gft_zbuf_size;
+	/** Group is compressed in gft_log_record. */
+	bool                           gft_compressed;
 };
 
 M0_INTERNAL int m0_be_group_format_init(struct m0_be_group_format     *gft,
@@ -196,10 +196,24 @@ static void be_reg_d_arr_first_subreg(struct m0_be_reg_d **rd_arr,
 	*size = arr[1] - arr[0];
 }
 
+static struct m0_be_rdt_node *be_rdt_node(const struct m0_be_reg_d *rd)
+{
+	return container_of(rd, struct m0_be_rdt_node, rdn_rd);
+}
+
+static struct m0_be_rdt_node *be_rdt_link2node(const struct m0_avl_link *link)
+{
+	return link == NULL ? NULL :
+		container_of(link, struct m0_be_rdt_node, rdn_link);
+}
+
 static bool be_rdt_contains(const struct m0_be_reg_d_tree *rdt,
 			    const struct m0_be_reg_d      *rd)
 {
-	return &rdt->brt_r[0] <= rd && rd < &rdt->brt_r[rdt->brt_size];
+	const struct m0_be_rdt_node *node = be_rdt_node(rd);
+
+	return &rdt->brt_nodes[0] <= node &&
+	       node < &rdt->brt_nodes[rdt->brt_size_max];
 }
 
 #define ARRAY_ALLOC_NZ(arr, nr) ((arr) = m0_alloc_nz((nr) * sizeof ((arr)[0])))
@@ -207,9 +221,13 @@ static bool be_rdt_contains(const struct m0_be_reg_d_tree *rdt,
 M0_INTERNAL int m0_be_rdt_init(struct m0_be_reg_d_tree *rdt, size_t size_max)
 {
 	rdt->brt_size_max = size_max;
-	ARRAY_ALLOC_NZ(rdt->brt_r, rdt->brt_size_max);
-	if (rdt->brt_r == NULL)
+	ARRAY_ALLOC_NZ(rdt->brt_nodes, rdt->brt_size_max);
+	if (rdt->brt_nodes == NULL)
 		return M0_ERR(-ENOMEM);
+	rdt->brt_size     = 0;
+	rdt->brt_nodes_nr = 0;
+	rdt->brt_free     = NULL;
+	m0_avl_init(&rdt->brt_tree);
 
 	M0_POST(m0_be_rdt__invariant(rdt));
 	return 0;
@@ -218,24 +236,49 @@ M0_INTERNAL int m0_be_rdt_init(struct m0_be_reg_d_tree *rdt, size_t size_max)
 M0_INTERNAL void m0_be_rdt_fini(struct m0_be_reg_d_tree *rdt)
 {
 	M0_PRE(m0_be_rdt__invariant(rdt));
-	m0_free(rdt->brt_r);
+	m0_free(rdt->brt_nodes);
+}
+
+/** In-order successor. Amortised time complexity is O(1). */
+static struct m0_be_rdt_node *be_rdt_succ(struct m0_be_rdt_node *node)
+{
+	return be_rdt_link2node(m0_avl_next(&node->rdn_link));
+}
+
+/** Time complexity is O(m0_be_rdt_size(rdt)) */
+static bool be_rdt_nodes_invariant(const struct m0_be_reg_d_tree *rdt)
+{
+	struct m0_be_rdt_node *node;
+	struct m0_be_rdt_node *next;
+	size_t                 nr = 0;
+
+	for (node = be_rdt_link2node(m0_avl_first(&rdt->brt_tree));
+	     node != NULL; node = next) {
+		next = be_rdt_succ(node);
+		if (!m0_be_reg_d__invariant(&node->rdn_rd) ||
+		    !m0_avl_link_invariant(&node->rdn_link) ||
+		    !_0C(ergo(next != NULL,
+			      node->rdn_rd.rd_reg.br_addr <
+			      next->rdn_rd.rd_reg.br_addr &&
+			      !be_reg_d_are_overlapping(&node->rdn_rd,
+							&next->rdn_rd))))
+			return false;
+		++nr;
+	}
+	return _0C(nr == rdt->brt_size);
 }
 
 M0_INTERNAL bool m0_be_rdt__invariant(const struct m0_be_reg_d_tree *rdt)
 {
 	return _0C(rdt != NULL) &&
-	       _0C(rdt->brt_r != NULL || rdt->brt_size == 0) &&
-	       _0C(rdt->brt_size <= rdt->brt_size_max) &&
-	       M0_CHECK_EX(m0_forall(i, rdt->brt_size,
-				     m0_be_reg_d__invariant(&rdt->brt_r[i]))) &&
-	       M0_CHECK_EX(m0_forall(i,
-				     rdt->brt_size == 0 ? 0 : rdt->brt_size - 1,
-				     _0C(rdt->brt_r[i].rd_reg.br_addr <
-					 rdt->brt_r[i + 1].rd_reg.br_addr))) &&
-	       M0_CHECK_EX(m0_forall(i,
-				     rdt->brt_size == 0 ? 0 : rdt->brt_size - 1,
-		     _0C(!be_reg_d_are_overlapping(&rdt->brt_r[i],
-						   &rdt->brt_r[i + 1]))));
+	       _0C(rdt->brt_nodes != NULL || rdt->brt_size_max == 0) &&
+	       _0C(rdt->brt_size <= rdt->brt_nodes_nr) &&
+	       _0C(rdt->brt_nodes_nr <= rdt->brt_size_max) &&
+	       _0C(equi(m0_avl_is_empty(&rdt->brt_tree),
+			rdt->brt_size == 0)) &&
+	       _0C(ergo(!m0_avl_is_empty(&rdt->brt_tree),
+			rdt->brt_tree.a_root->al_parent == NULL)) &&
+	       M0_CHECK_EX(be_rdt_nodes_invariant(rdt));
 }
 
 M0_INTERNAL size_t m0_be_rdt_size(const struct m0_be_reg_d_tree *rdt)
@@ -243,68 +286,46 @@ M0_INTERNAL size_t m0_be_rdt_size(const struct m0_be_reg_d_tree *rdt)
 	return rdt->brt_size;
 }
 
-/** Time complexity is O(1) */
-static bool be_rdt_check_i(const struct m0_be_reg_d_tree *rdt,
-			   void                          *addr,
-			   size_t                         index)
-{
-	struct m0_be_reg_d *r    = rdt->brt_r;
-	size_t              size = m0_be_rdt_size(rdt);
-
-	return  (size == 0 && index == 0) ||
-		(size != 0 &&
-		 ((index == size && !m0_be_reg_d_is_in(&r[size - 1], addr) &&
-		   addr > r[size - 1].rd_reg.br_addr) ||
-		  (index == 0 && (m0_be_reg_d_is_in(&r[0], addr) ||
-				  addr < r[0].rd_reg.br_addr)) ||
-		  (index < size && m0_be_reg_d_is_in(&r[index], addr)) ||
-		  (index < size && index > 0 &&
-		   !m0_be_reg_d_is_in(&r[index - 1], addr) &&
-		   addr < r[index].rd_reg.br_addr &&
-		   addr > r[index - 1].rd_reg.br_addr)));
-}
-
-/** Time complexity is O(log(m0_be_rdt_size(rdt) + 1)) */
-static size_t be_rdt_find_i(const struct m0_be_reg_d_tree *rdt, void *addr)
-{
-	size_t begin = 0;
-	size_t mid;
-	size_t end   = m0_be_rdt_size(rdt);
-	size_t res   = m0_be_rdt_size(rdt) + 1;
-	size_t size  = m0_be_rdt_size(rdt);
-
-	while (begin + 1 < end) {
-		mid = (begin + end) / 2;
-		M0_ASSERT_INFO(mid > begin && mid < end,
-			       "begin = %zu, mid = %zu, end = %zu",
-			       begin, mid, end);
-		if (rdt->brt_r[mid].rd_reg.br_addr < addr) {
-			begin = mid;
+/**
+ * Finds the last node which starts not after @addr and the first node which
+ * starts after @addr.
+ *
+ * Time complexity is O(log(m0_be_rdt_size(rdt) + 1))
+ */
+static void be_rdt_lookup(const struct m0_be_reg_d_tree  *rdt,
+			  void                           *addr,
+			  struct m0_be_rdt_node         **floor,
+			  struct m0_be_rdt_node         **ceil)
+{
+	struct m0_avl_link *link = rdt->brt_tree.a_root;
+
+	*floor = NULL;
+	*ceil  = NULL;
+	while (link != NULL) {
+		if (be_reg_d_fb(&be_rdt_link2node(link)->rdn_rd) <= addr) {
+			*floor = be_rdt_link2node(link);
+			link   = link->al_child[1];
 		} else {
-			end   = mid;
+			*ceil  = be_rdt_link2node(link);
+			link   = link->al_child[0];
 		}
 	}
-	res = be_rdt_check_i(rdt, addr, begin) ? begin : res;
-	res = be_rdt_check_i(rdt, addr, end)   ? end   : res;
-
-	M0_ASSERT_INFO(size == 0 || res <= size, "size = %zu, res = %zu",
-		       size, res);
-	M0_POST(m0_be_rdt__invariant(rdt));
-	M0_POST(be_rdt_check_i(rdt, addr, res));
-	return res;
 }
 
-
 M0_INTERNAL struct m0_be_reg_d *
 m0_be_rdt_find(const struct m0_be_reg_d_tree *rdt, void *addr)
 {
-	struct m0_be_reg_d *rd;
-	size_t		    i;
+	struct m0_be_rdt_node *floor;
+	struct m0_be_rdt_node *ceil;
+	struct m0_be_reg_d    *rd;
 
 	M0_PRE(m0_be_rdt__invariant(rdt));
 
-	i = be_rdt_find_i(rdt, addr);
-	rd = i == rdt->brt_size ? NULL : &rdt->brt_r[i];
+	be_rdt_lookup(rdt, addr, &floor, &ceil);
+	if (floor != NULL && m0_be_reg_d_is_in(&floor->rdn_rd, addr))
+		rd = &floor->rdn_rd;
+	else
+		rd = ceil == NULL ? NULL : &ceil->rdn_rd;
 
 	M0_POST(ergo(rd != NULL, be_rdt_contains(rdt, rd)));
 	return rd;
@@ -313,33 +334,45 @@ m0_be_rdt_find(const struct m0_be_reg_d_tree *rdt, void *addr)
 M0_INTERNAL struct m0_be_reg_d *
 m0_be_rdt_next(const struct m0_be_reg_d_tree *rdt, struct m0_be_reg_d *prev)
 {
-	struct m0_be_reg_d *rd;
+	struct m0_be_rdt_node *node;
 
 	M0_PRE(m0_be_rdt__invariant(rdt));
 	M0_PRE(prev != NULL);
 	M0_PRE(be_rdt_contains(rdt, prev));
 
-	rd = prev == &rdt->brt_r[rdt->brt_size - 1] ? NULL : ++prev;
+	node = be_rdt_succ(be_rdt_node(prev));
 
-	M0_POST(ergo(rd != NULL, be_rdt_contains(rdt, rd)));
-	return rd;
+	M0_POST(ergo(node != NULL, be_rdt_contains(rdt, &node->rdn_rd)));
+	return node == NULL ? NULL : &node->rdn_rd;
 }
 
 M0_INTERNAL void m0_be_rdt_ins(struct m0_be_reg_d_tree  *rdt,
 			       const struct m0_be_reg_d *rd)
 {
-	size_t index;
-	size_t i;
+	struct m0_avl_link    *parent = NULL;
+	struct m0_avl_link    *link;
+	struct m0_be_rdt_node *node;
+	int                    dir = 0;
 
 	M0_PRE(m0_be_rdt__invariant(rdt));
 	M0_PRE(m0_be_rdt_size(rdt) < rdt->brt_size_max);
 	M0_PRE(rd->rd_reg.br_size > 0);
 
-	index = be_rdt_find_i(rdt, be_reg_d_fb(rd));
+	for (link = rdt->brt_tree.a_root; link != NULL;
+	     link = link->al_child[dir]) {
+		parent = link;
+		dir    = be_reg_d_fb(&be_rdt_link2node(link)->rdn_rd) <
+			 be_reg_d_fb(rd);
+	}
+	if (rdt->brt_free != NULL) {
+		node          = be_rdt_link2node(rdt->brt_free);
+		rdt->brt_free = rdt->brt_free->al_parent;
+	} else {
+		node = &rdt->brt_nodes[rdt->brt_nodes_nr++];
+	}
+	node->rdn_rd = *rd;
+	m0_avl_insert(&rdt->brt_tree, &node->rdn_link, parent, dir);
 	++rdt->brt_size;
-	for (i = rdt->brt_size - 1; i > index; --i)
-		rdt->brt_r[i] = rdt->brt_r[i - 1];
-	rdt->brt_r[index] = *rd;
 
 	M0_POST(m0_be_rdt__invariant(rdt));
 }
@@ -347,28 +380,36 @@ M0_INTERNAL void m0_be_rdt_ins(struct m0_be_reg_d_tree  *rdt,
 M0_INTERNAL struct m0_be_reg_d *m0_be_rdt_del(struct m0_be_reg_d_tree  *rdt,
 					      const struct m0_be_reg_d *rd)
 {
-	size_t index;
-	size_t i;
+	struct m0_be_rdt_node *floor;
+	struct m0_be_rdt_node *ceil;
+	struct m0_be_rdt_node *node;
+	struct m0_be_rdt_node *next;
 
 	M0_PRE(m0_be_rdt__invariant(rdt));
 	M0_PRE(m0_be_rdt_size(rdt) > 0);
 
-	index = be_rdt_find_i(rdt, be_reg_d_fb(rd));
-	M0_ASSERT(m0_be_reg_eq(&rdt->brt_r[index].rd_reg, &rd->rd_reg));
-
-	for (i = index; i + 1 < rdt->brt_size; ++i)
-		rdt->brt_r[i] = rdt->brt_r[i + 1];
+	be_rdt_lookup(rdt, be_reg_d_fb(rd), &floor, &ceil);
+	node = floor;
+	M0_ASSERT(node != NULL && m0_be_reg_eq(&node->rdn_rd.rd_reg,
+					       &rd->rd_reg));
+	next = be_rdt_succ(node);
+	m0_avl_delete(&rdt->brt_tree, &node->rdn_link);
+	node->rdn_link.al_parent = rdt->brt_free;
+	rdt->brt_free            = &node->rdn_link;
 	--rdt->brt_size;
 
 	M0_POST(m0_be_rdt__invariant(rdt));
-	return index == m0_be_rdt_size(rdt) ? NULL : &rdt->brt_r[index];
+	return next == NULL ? NULL : &next->rdn_rd;
 }
 
 M0_INTERNAL void m0_be_rdt_reset(struct m0_be_reg_d_tree *rdt)
 {
 	M0_PRE(m0_be_rdt__invariant(rdt));
 
-	rdt->brt_size = 0;
+	rdt->brt_size     = 0;
+	rdt->brt_nodes_nr = 0;
+	rdt->brt_free     = NULL;
+	m0_avl_init(&rdt->brt_tree);
 
 	M0_POST(m0_be_rdt_size(rdt) == 0);
 	M0_POST(m0_be_rdt__invariant(rdt));
@@ -25,6 +25,7 @@
 #define __MOTR_BE_TX_REGMAP_H__
 
 #include "lib/time.h"           /* m0_time_t */
+#include "lib/avl.h"            /* m0_avl */
 
 #include "be/seg.h"             /* m0_be_reg */
 #include "be/tx_credit.h"       /* m0_be_tx_credit */
@@ -68,11 +69,31 @@ struct m0_be_reg_d {
 		{ .rd_reg = (reg), .rd_buf = (buf) }
 #define M0_BE_REG_D_CREDIT(rd) M0_BE_TX_CREDIT(1, (rd)->rd_reg.br_size)
 
-/** Regions tree. */
+/** Node of m0_be_reg_d_tree. */
+struct m0_be_rdt_node {
+	struct m0_be_reg_d     rdn_rd;
+	/** Linkage to m0_be_reg_d_tree::brt_tree. */
+	struct m0_avl_link     rdn_link;
+};
+
+/**
+ * Regions tree.
+ *
+ * AVL tree ordered by region start address. Nodes are taken from the array
+ * allocated in m0_be_rdt_init(): first from the list of nodes freed by
+ * m0_be_rdt_del() (linked through rdn_link.al_parent), then from the unused
+ * tail of the array.
+ */
 struct m0_be_reg_d_tree {
-	size_t              brt_size;
-	size_t              brt_size_max;
-	struct m0_be_reg_d *brt_r;
+	size_t                 brt_size;
+	size_t                 brt_size_max;
+	/** Array of brt_size_max nodes. */
+	struct m0_be_rdt_node *brt_nodes;
+	/** Number of brt_nodes elements ever used since the last reset. */
+	size_t                 brt_nodes_nr;
+	struct m0_avl          brt_tree;
+	/** List of free nodes. */
+	struct m0_avl_link    *brt_free;
 };
 
 struct m0_be_regmap_ops {
@@ -109,9 +130,11 @@ M0_INTERNAL bool m0_be_reg_d_is_in(const struct m0_be_reg_d *rd, void *ptr);
  *   functions;
  *
  * Region is from the tree iff it is returned by m0_be_rdt_find(),
- * m0_be_rdt_next(), m0_be_rdt_del().
- * @note Current implementation is based on array, so technically it is not
- * a tree. Optimizations should be made to make it a real tree.
+ * m0_be_rdt_next(), m0_be_rdt_del(). Such region stays at the same address
+ * until it is deleted from the tree.
+ *
+ * m0_be_rdt_find(), m0_be_rdt_ins() and m0_be_rdt_del() take
+ * O(log(m0_be_rdt_size())) time, m0_be_rdt_next() takes O(1) amortised time.
  */
 M0_INTERNAL int m0_be_rdt_init(struct m0_be_reg_d_tree *rdt, size_t size_max);
 /** Finalize m0_be_reg_d tree. Free all memory allocated */
@@ -237,6 +237,73 @@ M0_INTERNAL void m0_be_ut_alloc_info(void)
 	M0_SET0(&be_ut_alloc_backend);
 }
 
+M0_INTERNAL void m0_be_ut_alloc_mag(void)
+{
+	struct m0_be_allocator_stats      stats_before = {};
+	struct m0_be_allocator_stats      stats_after = {};
+	struct m0_be_allocator_mag_stats  mag = {};
+	struct m0_be_allocator           *a;
+	struct m0_be_ut_seg               ut_seg;
+	m0_bcount_t                       size;
+	void                             *ptrs[M0_BE_ALLOC_MAG_BATCH] = {};
+	uint64_t                          hit;
+	int                               i;
+
+	m0_be_ut_backend_init(&be_ut_alloc_backend);
+	m0_be_ut_seg_init(&ut_seg, &be_ut_alloc_backend, BE_UT_ALLOC_SEG_SIZE);
+	m0_be_ut_seg_allocator_init(&ut_seg, &be_ut_alloc_backend);
+	a = m0_be_seg_allocator(ut_seg.bus_seg);
+
+	size = M0_BE_ALLOC_MAG_STEP + 1;
+	m0_be_alloc_stats(a, &stats_before);
+	m0_be_alloc_mag_stats(a, &mag);
+	M0_UT_ASSERT(mag.bms_hit == 0);
+	M0_UT_ASSERT(mag.bms_miss == 0);
+	for (i = 0; i < ARRAY_SIZE(ptrs); ++i) {
+		M0_BE_UT_TRANSACT(&be_ut_alloc_backend, tx, cred,
+		  m0_be_allocator_credit(a, M0_BAO_ALLOC, size, 0, &cred),
+		  M0_BE_OP_SYNC(op, m0_be_alloc(a, tx, &op, &ptrs[i], size)));
+		M0_UT_ASSERT(ptrs[i] != NULL);
+		M0_UT_ASSERT(m0_addr_is_aligned(ptrs[i],
+						M0_BE_ALLOC_SHIFT_MIN));
+		/* the size is rounded up to the size class */
+		M0_UT_ASSERT(((struct be_alloc_chunk *)ptrs[i] - 1)->bac_size ==
+			     2 * M0_BE_ALLOC_MAG_STEP);
+	}
+	m0_be_alloc_stats(a, &stats_after);
+	m0_be_alloc_mag_stats(a, &mag);
+	M0_UT_ASSERT(mag.bms_miss > 0);
+	M0_UT_ASSERT(mag.bms_hit + mag.bms_miss ==
+		     ARRAY_SIZE(ptrs));
+
+	for (i = 0; i < ARRAY_SIZE(ptrs); ++i) {
+		M0_BE_UT_TRANSACT(&be_ut_alloc_backend, tx, cred,
+			  m0_be_allocator_credit(a, M0_BAO_FREE, 0, 0, &cred),
+			  M0_BE_OP_SYNC(op, m0_be_free(a, tx, &op, ptrs[i])));
+	}
+	/* freed chunks are kept in magazines */
+	m0_be_alloc_stats(a, &stats_before);
+	M0_UT_ASSERT(stats_before.bas_space_used ==
+		     stats_after.bas_space_used);
+	/* and the next allocation takes one of them */
+	hit = mag.bms_hit;
+	M0_BE_UT_TRANSACT(&be_ut_alloc_backend, tx, cred,
+		  m0_be_allocator_credit(a, M0_BAO_ALLOC, size, 0, &cred),
+		  M0_BE_OP_SYNC(op, m0_be_alloc(a, tx, &op, &ptrs[0], size)));
+	M0_UT_ASSERT(ptrs[0] != NULL);
+	m0_be_alloc_mag_stats(a, &mag);
+	M0_UT_ASSERT(mag.bms_hit == hit + 1);
+	M0_BE_UT_TRANSACT(&be_ut_alloc_backend, tx, cred,
+		  m0_be_allocator_credit(a, M0_BAO_FREE, 0, 0, &cred),
+		  M0_BE_OP_SYNC(op, m0_be_free(a, tx, &op, ptrs[0])));
+
+	/* magazines are drained here */
+	m0_be_ut_seg_allocator_fini(&ut_seg, &be_ut_alloc_backend);
+	m0_be_ut_seg_fini(&ut_seg);
+	m0_be_ut_backend_fini(&be_ut_alloc_backend);
+	M0_SET0(&be_ut_alloc_backend);
+}
+
 /* segment and memory allocation sizes to test */
 enum {
 	BE_UT_OOM_SEG_START     = 0x1900,
@@ -29,6 +29,10 @@
 #include "lib/misc.h"      /* M0_BITS, M0_IN */
 #include "lib/memory.h"    /* M0_ALLOC_PTR */
 #include "lib/errno.h"     /* ENOENT */
+#include "lib/thread.h"    /* m0_thread */
+#include "lib/time.h"      /* m0_time_now */
+#include "lib/finject.h"   /* m0_fi_enable */
+#include "lib/ub.h"        /* m0_ub_set */
 #include "be/ut/helper.h"
 #include "ut/ut.h"
 #ifndef __KERNEL__
@@ -881,6 +885,914 @@ static void check(struct m0_be_btree *tree)
 	m0_free(op);
 }
 
+enum {
+	BTREE_MT_THREADS_MAX = 8,
+	BTREE_MT_PER_THREAD  = BTREE_FAN_OUT * 8,
+	BTREE_MT_TX_OPS_NR   = 16,
+};
+
+struct btree_mt_thread {
+	struct m0_thread    bmt_thread;
+	struct m0_be_btree *bmt_tree;
+	int                 bmt_idx;
+};
+
+static void btree_mt_key(char *k, int idx, int i)
+{
+	sprintf(k, "%0*d", INSERT_KSIZE - 1, idx * BTREE_MT_PER_THREAD + i);
+}
+
+static void btree_mt_thread(struct btree_mt_thread *t)
+{
+	struct m0_be_tx_credit cred = {};
+	struct m0_be_tx        tx;
+	struct m0_be_op        op;
+	struct m0_buf          key;
+	struct m0_buf          val;
+	char                   k[INSERT_KSIZE];
+	char                   v[INSERT_VSIZE];
+	char                   e[INSERT_VSIZE];
+	int                    rc;
+	int                    i;
+	int                    j;
+
+	m0_buf_init(&key, k, INSERT_KSIZE);
+	m0_buf_init(&val, v, INSERT_VSIZE);
+	m0_be_btree_insert_credit2(t->bmt_tree, BTREE_MT_TX_OPS_NR,
+				   INSERT_KSIZE, INSERT_VSIZE, &cred);
+	for (i = 0; i < BTREE_MT_PER_THREAD; i += BTREE_MT_TX_OPS_NR) {
+		M0_SET0(&tx);
+		m0_be_ut_tx_init(&tx, ut_be);
+		m0_be_tx_prep(&tx, &cred);
+		rc = m0_be_tx_open_sync(&tx);
+		M0_UT_ASSERT(rc == 0);
+		for (j = i; j < i + BTREE_MT_TX_OPS_NR; ++j) {
+			btree_mt_key(k, t->bmt_idx, j);
+			sprintf(v, "%0*d", INSERT_VSIZE - 1, j);
+			M0_SET0(&op);
+			rc = M0_BE_OP_SYNC_RET_WITH(&op,
+				m0_be_btree_insert(t->bmt_tree, &tx, &op,
+						   &key, &val),
+				bo_u.u_btree.t_rc);
+			M0_UT_ASSERT(rc == 0);
+		}
+		m0_be_tx_close_sync(&tx);
+		m0_be_tx_fini(&tx);
+	}
+	for (i = 0; i < BTREE_MT_PER_THREAD; ++i) {
+		btree_mt_key(k, t->bmt_idx, i);
+		val = M0_BUF_INIT(INSERT_VSIZE, v);
+		M0_SET0(&op);
+		rc = M0_BE_OP_SYNC_RET_WITH(&op,
+			m0_be_btree_lookup(t->bmt_tree, &op, &key, &val),
+			bo_u.u_btree.t_rc);
+		sprintf(e, "%0*d", INSERT_VSIZE - 1, i);
+		M0_UT_ASSERT(rc == 0 && strcmp(v, e) == 0);
+	}
+	m0_be_ut_backend_thread_exit(ut_be);
+}
+
+static struct m0_be_btree *
+btree_create_with(const struct m0_be_btree_kv_ops *ops, int nr)
+{
+	struct m0_be_tx_credit  cred = {};
+	struct m0_be_btree     *tree;
+	struct m0_be_tx         tx;
+	struct m0_be_op         op = {};
+	int                     rc;
+
+	{
+		struct m0_be_btree t = { .bb_seg = seg };
+		m0_be_btree_create_credit(&t, 1, &cred);
+	}
+	M0_BE_ALLOC_CREDIT_PTR(tree, seg, &cred);
+	m0_be_ut_tx_init(&tx, ut_be);
+	m0_be_tx_prep(&tx, &cred);
+	rc = m0_be_tx_open_sync(&tx);
+	M0_UT_ASSERT(rc == 0);
+	M0_BE_ALLOC_PTR_SYNC(tree, seg, &tx);
+	m0_be_btree_init(tree, seg, ops);
+	M0_BE_OP_SYNC_WITH(&op, m0_be_btree_create(tree, &tx, &op,
+					   &M0_FID_TINIT('b', 1, nr)));
+	m0_be_tx_close_sync(&tx);
+	m0_be_tx_fini(&tx);
+	return tree;
+}
+
+static void btree_mt_run(int nr, bool exclusive)
+{
+	static struct btree_mt_thread threads[BTREE_MT_THREADS_MAX];
+	struct m0_be_btree           *tree;
+	m0_time_t                     start;
+	m0_time_t                     elapsed;
+	int                           i;
+	int                           rc;
+
+	tree = btree_create_with(&kv_ops, nr * 2 + !!exclusive);
+	if (exclusive)
+		m0_fi_enable("btree_save", "exclusive_insert");
+	start = m0_time_now();
+	for (i = 0; i < nr; ++i) {
+		threads[i] = (struct btree_mt_thread) {
+			.bmt_tree = tree,
+			.bmt_idx  = i,
+		};
+		rc = M0_THREAD_INIT(&threads[i].bmt_thread,
+				    struct btree_mt_thread *, NULL,
+				    &btree_mt_thread, &threads[i],
+				    "btree_mt%d", i);
+		M0_UT_ASSERT(rc == 0);
+	}
+	for (i = 0; i < nr; ++i) {
+		rc = m0_thread_join(&threads[i].bmt_thread);
+		M0_UT_ASSERT(rc == 0);
+		m0_thread_fini(&threads[i].bmt_thread);
+	}
+	elapsed = m0_time_sub(m0_time_now(), start);
+	if (exclusive)
+		m0_fi_disable("btree_save", "exclusive_insert");
+	M0_LOG(M0_INFO, "threads: %d, %s: %llu ops/sec", nr,
+	       exclusive ? "tree lock" : "node latches",
+	       (unsigned long long)(2ULL * nr * BTREE_MT_PER_THREAD *
+				    M0_TIME_ONE_SECOND / (elapsed ?: 1)));
+	/* Tree memory is reclaimed together with the segment. */
+	m0_be_btree_fini(tree);
+}
+
+/**
+ * Concurrent inserts of disjoint key ranges followed by lookups, with
+ * per-node latching and with the whole-tree lock ("exclusive_insert").
+ */
+void m0_be_ut_btree_concurrent(void)
+{
+	int nr;
+
+	M0_ALLOC_PTR(ut_be);
+	M0_UT_ASSERT(ut_be != NULL);
+	M0_ALLOC_PTR(ut_seg);
+	M0_UT_ASSERT(ut_seg != NULL);
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(ut_seg, ut_be, 1ULL << 26);
+	seg = ut_seg->bus_seg;
+
+	for (nr = 1; nr <= BTREE_MT_THREADS_MAX; nr *= 2) {
+		btree_mt_run(nr, false);
+		btree_mt_run(nr, true);
+	}
+
+	m0_be_ut_seg_fini(ut_seg);
+	m0_be_ut_backend_fini(ut_be);
+	m0_free(ut_seg);
+	m0_free(ut_be);
+}
+
+static int inline_cmp(const void *key0, const void *key1)
+{
+	return M0_3WAY(*(const uint64_t *)key0, *(const uint64_t *)key1);
+}
+
+static m0_bcount_t inline_kv_size(const void *kv)
+{
+	return sizeof(uint64_t);
+}
+
+static const struct m0_be_btree_kv_ops inline_kv_ops = {
+	.ko_type         = M0_BBT_UT_KV_OPS,
+	.ko_ksize        = inline_kv_size,
+	.ko_vsize        = inline_kv_size,
+	.ko_compare      = inline_cmp,
+	.ko_inline_ksize = sizeof(uint64_t)
+};
+
+/* The same as inline_kv_ops, searched without ko_compare() calls. */
+static const struct m0_be_btree_kv_ops inline_u64_kv_ops = {
+	.ko_type         = M0_BBT_UT_KV_OPS,
+	.ko_ksize        = inline_kv_size,
+	.ko_vsize        = inline_kv_size,
+	.ko_compare      = inline_cmp,
+	.ko_inline_ksize = sizeof(uint64_t),
+	.ko_flags        = M0_BKF_U64
+};
+
+static int inline_lookup(struct m0_be_btree *tree, uint64_t k)
+{
+	struct m0_be_op op = {};
+	uint64_t        v = 0;
+	struct m0_buf   key = M0_BUF_INIT_PTR(&k);
+	struct m0_buf   val = M0_BUF_INIT_PTR(&v);
+	int             rc;
+
+	rc = M0_BE_OP_SYNC_RET_WITH(&op,
+				    m0_be_btree_lookup(tree, &op, &key, &val),
+				    bo_u.u_btree.t_rc);
+	M0_UT_ASSERT(ergo(rc == 0, v == ~k));
+	return rc;
+}
+
+static void btree_inline_keys_test(const struct m0_be_btree_kv_ops *ops)
+{
+	static int                  keys[INSERT_COUNT];
+	struct m0_be_btree_cursor   cursor;
+	struct m0_be_btree         *tree;
+	struct m0_format_tag        tag;
+	struct m0_buf               key;
+	struct m0_buf               val;
+	uint64_t                    k;
+	uint64_t                    v;
+	uint64_t                    prev;
+	uint64_t                   *kp;
+	int                         rc;
+	int                         i;
+
+	M0_ALLOC_PTR(ut_be);
+	M0_UT_ASSERT(ut_be != NULL);
+	M0_ALLOC_PTR(ut_seg);
+	M0_UT_ASSERT(ut_seg != NULL);
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(ut_seg, ut_be, 1ULL << 24);
+	seg = ut_seg->bus_seg;
+
+	tree = btree_create_with(ops, 0);
+	m0_format_header_unpack(&tag, &tree->bb_header);
+	M0_UT_ASSERT(tag.ot_version == M0_BE_BTREE_FORMAT_VERSION_2);
+
+	for (i = 0; i < ARRAY_SIZE(keys); ++i)
+		keys[i] = i;
+	shuffle_array(keys, ARRAY_SIZE(keys));
+	m0_buf_init(&key, &k, sizeof k);
+	m0_buf_init(&val, &v, sizeof v);
+	for (i = 0; i < ARRAY_SIZE(keys); ++i) {
+		k = 2 * keys[i];
+		v = ~k;
+		rc = btree_insert(tree, &key, &val, ARRAY_SIZE(keys) - i - 1);
+		M0_UT_ASSERT(rc == 0);
+	}
+	m0_be_ut_seg_reload(ut_seg);
+	for (i = 0; i < ARRAY_SIZE(keys); ++i) {
+		M0_UT_ASSERT(inline_lookup(tree, 2 * i) == 0);
+		M0_UT_ASSERT(inline_lookup(tree, 2 * i + 1) == -ENOENT);
+	}
+
+	/* Delete every other key to make nodes rebalance and merge. */
+	for (i = 0; i < ARRAY_SIZE(keys); i += 2) {
+		k = 2 * keys[i];
+		rc = btree_delete(tree, &key, ARRAY_SIZE(keys) - i - 2);
+		M0_UT_ASSERT(rc == 0);
+	}
+	m0_be_ut_seg_reload(ut_seg);
+	for (i = 0; i < ARRAY_SIZE(keys); ++i)
+		M0_UT_ASSERT(inline_lookup(tree, 2 * keys[i]) ==
+			     (i % 2 == 0 ? -ENOENT : 0));
+
+	m0_be_btree_cursor_init(&cursor, tree);
+	k = 0;
+	rc = m0_be_btree_cursor_get_sync(&cursor, &key, true);
+	for (i = 0, prev = 0; rc == 0; ++i) {
+		m0_be_btree_cursor_kv_get(&cursor, &key, &val);
+		M0_UT_ASSERT(ergo(i > 0, *(uint64_t *)key.b_addr > prev));
+		prev = *(uint64_t *)key.b_addr;
+		rc = m0_be_btree_cursor_next_sync(&cursor);
+	}
+	M0_UT_ASSERT(rc == -ENOENT && i == ARRAY_SIZE(keys) / 2);
+
+	/*
+	 * A key returned by a cursor stays valid while other inserts move the
+	 * key slots around.
+	 */
+	m0_buf_init(&key, &k, sizeof k);
+	k = 0;
+	rc = m0_be_btree_cursor_get_sync(&cursor, &key, true);
+	M0_UT_ASSERT(rc == 0);
+	m0_be_btree_cursor_kv_get(&cursor, &key, &val);
+	kp = key.b_addr;
+	prev = *kp;
+	m0_be_btree_cursor_fini(&cursor);
+	m0_buf_init(&key, &k, sizeof k);
+	m0_buf_init(&val, &v, sizeof v);
+	for (i = 0; i < ARRAY_SIZE(keys) / 2; ++i) {
+		k = 2 * i + 1;
+		v = ~k;
+		rc = btree_insert(tree, &key, &val,
+				  ARRAY_SIZE(keys) / 2 - i - 1);
+		M0_UT_ASSERT(rc == 0);
+	}
+	M0_UT_ASSERT(*kp == prev);
+	M0_UT_ASSERT(inline_lookup(tree, prev) == 0);
+
+	/* Tree memory is reclaimed together with the segment. */
+	m0_be_btree_fini(tree);
+	m0_be_ut_seg_fini(ut_seg);
+	m0_be_ut_backend_fini(ut_be);
+	m0_free(ut_seg);
+	m0_free(ut_be);
+}
+
+/**
+ * Inserts, looks up and deletes keys in a tree with version 2 (inline key)
+ * nodes, checking that node checksums survive segment reload.
+ */
+void m0_be_ut_btree_inline_keys(void)
+{
+	btree_inline_keys_test(&inline_kv_ops);
+	btree_inline_keys_test(&inline_u64_kv_ops);
+}
+
+/* Version 1 nodes with the same keys as inline_kv_ops. */
+static const struct m0_be_btree_kv_ops u64_kv_ops = {
+	.ko_type    = M0_BBT_UT_KV_OPS,
+	.ko_ksize   = inline_kv_size,
+	.ko_vsize   = inline_kv_size,
+	.ko_compare = inline_cmp
+};
+
+enum {
+	BATCH_NR      = 200,
+	BATCH_BATCHES = 12,
+	BATCH_KEYS    = BATCH_NR * BATCH_BATCHES,
+};
+
+static void btree_batch_insert(struct m0_be_btree *tree,
+			       uint64_t *k, uint64_t *v, int *rcs, int nr)
+{
+	struct m0_be_tx_credit cred = {};
+	struct m0_buf          keys[BATCH_NR];
+	struct m0_buf          vals[BATCH_NR];
+	struct m0_be_tx        tx;
+	struct m0_be_op        op = {};
+	int                    rc;
+	int                    i;
+
+	for (i = 0; i < nr; ++i) {
+		keys[i] = M0_BUF_INIT_PTR(&k[i]);
+		vals[i] = M0_BUF_INIT_PTR(&v[i]);
+	}
+	m0_be_btree_insert_credit(tree, nr, sizeof *k, sizeof *v, &cred);
+	m0_be_ut_tx_init(&tx, ut_be);
+	m0_be_tx_prep(&tx, &cred);
+	rc = m0_be_tx_open_sync(&tx);
+	M0_UT_ASSERT(rc == 0);
+	M0_BE_OP_SYNC_WITH(&op, m0_be_btree_insert_batch(tree, &tx, &op, nr,
+							 keys, vals, rcs));
+	m0_be_tx_close_sync(&tx);
+	m0_be_tx_fini(&tx);
+}
+
+static void btree_batch_test(const struct m0_be_btree_kv_ops *ops)
+{
+	static uint64_t     k[BATCH_NR];
+	static uint64_t     v[BATCH_NR];
+	static int          rcs[BATCH_NR];
+	struct m0_buf       keys[BATCH_NR];
+	struct m0_buf       vals[BATCH_NR];
+	struct m0_be_btree *tree;
+	struct m0_be_op     op = {};
+	int                 b;
+	int                 nr;
+	int                 i;
+
+	tree = btree_create_with(ops, 0);
+	/*
+	 * Batch b inserts keys 2 * (b + i * BATCH_BATCHES), so that every
+	 * batch spreads over the whole tree and splits leaves under itself.
+	 */
+	for (b = 0; b < BATCH_BATCHES; ++b) {
+		for (i = 0; i < BATCH_NR; ++i) {
+			k[i] = 2 * (b + i * BATCH_BATCHES);
+			v[i] = ~k[i];
+		}
+		btree_batch_insert(tree, k, v, rcs, BATCH_NR);
+		M0_UT_ASSERT(m0_forall(j, BATCH_NR, rcs[j] == 0));
+	}
+	/* Even keys are there already. */
+	for (i = 0; i < BATCH_NR; ++i) {
+		k[i] = i;
+		v[i] = ~k[i];
+	}
+	btree_batch_insert(tree, k, v, rcs, BATCH_NR);
+	M0_UT_ASSERT(m0_forall(j, BATCH_NR, rcs[j] == (j % 2 ? 0 : -EEXIST)));
+	m0_be_ut_seg_reload(ut_seg);
+
+	for (b = 0; b < 2 * BATCH_KEYS + BATCH_NR; b += nr) {
+		nr = min_check(BATCH_NR, 2 * BATCH_KEYS + BATCH_NR - b);
+		for (i = 0; i < nr; ++i) {
+			k[i] = b + i;
+			keys[i] = M0_BUF_INIT_PTR(&k[i]);
+			vals[i] = M0_BUF_INIT_PTR(&v[i]);
+		}
+		M0_BE_OP_SYNC_WITH(&op, m0_be_btree_lookup_batch(tree, &op, nr,
+							keys, vals, rcs));
+		for (i = 0; i < nr; ++i) {
+			M0_UT_ASSERT(rcs[i] ==
+				     (k[i] < BATCH_NR ||
+				      (k[i] % 2 == 0 && k[i] < 2 * BATCH_KEYS) ?
+				      0 : -ENOENT));
+			M0_UT_ASSERT(ergo(rcs[i] == 0, v[i] == ~k[i]));
+		}
+	}
+	m0_be_btree_fini(tree);
+}
+
+/** Batched inserts and lookups in trees with both node formats. */
+void m0_be_ut_btree_batch(void)
+{
+	M0_ALLOC_PTR(ut_be);
+	M0_UT_ASSERT(ut_be != NULL);
+	M0_ALLOC_PTR(ut_seg);
+	M0_UT_ASSERT(ut_seg != NULL);
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(ut_seg, ut_be, 1ULL << 24);
+	seg = ut_seg->bus_seg;
+
+	btree_batch_test(&u64_kv_ops);
+	btree_batch_test(&inline_u64_kv_ops);
+
+	m0_be_ut_seg_fini(ut_seg);
+	m0_be_ut_backend_fini(ut_be);
+	m0_free(ut_seg);
+	m0_free(ut_be);
+}
+
+enum {
+	RANGE_KEYS = 3000,
+};
+
+/** Disposes of a tree with a cut out range, like CAS index GC does. */
+static void btree_range_dst_drop(struct m0_be_btree *dst, m0_bcount_t nr)
+{
+	struct m0_be_tx_credit cred = {};
+	struct m0_be_tx_credit rec  = {};
+	struct m0_be_tx        tx;
+	struct m0_be_op        op   = {};
+	m0_bcount_t            recs_nr;
+	int                    rc;
+
+	m0_be_btree_clear_credit(dst, &cred, &rec, &recs_nr);
+	M0_UT_ASSERT(ergo(nr > 1, recs_nr >= nr));
+	m0_be_tx_credit_mac(&cred, &rec, recs_nr);
+	m0_be_btree_destroy_credit(dst, &cred);
+	M0_BE_FREE_CREDIT_PTR(dst, seg, &cred);
+	m0_be_ut_tx_init(&tx, ut_be);
+	m0_be_tx_prep(&tx, &cred);
+	rc = m0_be_tx_open_sync(&tx);
+	M0_UT_ASSERT(rc == 0);
+	M0_BE_OP_SYNC_WITH(&op, m0_be_btree_truncate(dst, &tx, &op, recs_nr));
+	M0_UT_ASSERT(m0_be_btree_is_empty(dst));
+	M0_SET0(&op);
+	M0_BE_OP_SYNC_WITH(&op, m0_be_btree_destroy(dst, &tx, &op));
+	m0_be_btree_fini(dst);
+	M0_BE_FREE_PTR_SYNC(dst, seg, &tx);
+	m0_be_tx_close_sync(&tx);
+	m0_be_tx_fini(&tx);
+}
+
+/**
+ * Makes one cut of [lo, hi) in a transaction with the height-bounded credit
+ * and returns the number of removed records.
+ */
+static m0_bcount_t btree_range_delete(struct m0_be_btree *tree,
+				      const uint64_t *lo, const uint64_t *hi)
+{
+	struct m0_be_tx_credit cred = {};
+	struct m0_buf          lbuf = M0_BUF_INIT0;
+	struct m0_buf          hbuf = M0_BUF_INIT0;
+	struct m0_be_btree    *dst;
+	struct m0_be_tx        tx;
+	struct m0_be_op        op   = {};
+	m0_bcount_t            nr;
+	int                    rc;
+
+	if (lo != NULL)
+		lbuf = M0_BUF_INIT_PTR_CONST(lo);
+	if (hi != NULL)
+		hbuf = M0_BUF_INIT_PTR_CONST(hi);
+	dst = btree_create_with(tree->bb_ops, 1);
+	m0_be_btree_delete_range_credit(tree, sizeof *lo, sizeof *lo, &cred);
+	m0_be_ut_tx_init(&tx, ut_be);
+	m0_be_tx_prep(&tx, &cred);
+	rc = m0_be_tx_open_sync(&tx);
+	M0_UT_ASSERT(rc == 0);
+	M0_BE_OP_SYNC_WITH(&op, m0_be_btree_delete_range(tree, &tx, &op,
+					lo == NULL ? NULL : &lbuf,
+					hi == NULL ? NULL : &hbuf, dst, &nr));
+	M0_UT_ASSERT(op.bo_u.u_btree.t_rc == 0);
+	M0_UT_ASSERT((nr == 0) == m0_be_btree_is_empty(dst));
+	m0_be_tx_close_sync(&tx);
+	m0_be_tx_fini(&tx);
+	btree_range_dst_drop(dst, nr);
+	return nr;
+}
+
+/** Removes [lo, hi) completely, returns the number of calls it took. */
+static int btree_range_delete_all(struct m0_be_btree *tree,
+				  const uint64_t *lo, const uint64_t *hi,
+				  m0_bcount_t expected)
+{
+	m0_bcount_t nr;
+	m0_bcount_t total = 0;
+	int         calls = 0;
+
+	do {
+		nr = btree_range_delete(tree, lo, hi);
+		total += nr;
+		++calls;
+	} while (nr != 0);
+	M0_UT_ASSERT(total == expected);
+	return calls;
+}
+
+/** Checks that exactly the keys in [lo, hi) are missing from the tree. */
+static void btree_range_check(struct m0_be_btree *tree,
+			      uint64_t lo, uint64_t hi)
+{
+	static uint64_t k[BATCH_NR];
+	static uint64_t v[BATCH_NR];
+	static int      rcs[BATCH_NR];
+	struct m0_buf   keys[BATCH_NR];
+	struct m0_buf   vals[BATCH_NR];
+	struct m0_be_op op = {};
+	int             b;
+	int             i;
+
+	for (b = 0; b < RANGE_KEYS; b += BATCH_NR) {
+		for (i = 0; i < BATCH_NR; ++i) {
+			k[i] = b + i;
+			keys[i] = M0_BUF_INIT_PTR(&k[i]);
+			vals[i] = M0_BUF_INIT_PTR(&v[i]);
+		}
+		M0_BE_OP_SYNC_WITH(&op, m0_be_btree_lookup_batch(tree, &op,
+						BATCH_NR, keys, vals, rcs));
+		M0_UT_ASSERT(m0_forall(j, BATCH_NR,
+				       rcs[j] == (lo <= k[j] && k[j] < hi ?
+						  -ENOENT : 0)));
+	}
+}
+
+/** Returns the number of keys from [0, RANGE_KEYS) found in the tree. */
+static m0_bcount_t btree_range_present_nr(struct m0_be_btree *tree)
+{
+	static uint64_t k[BATCH_NR];
+	static uint64_t v[BATCH_NR];
+	static int      rcs[BATCH_NR];
+	struct m0_buf   keys[BATCH_NR];
+	struct m0_buf   vals[BATCH_NR];
+	struct m0_be_op op = {};
+	m0_bcount_t     nr = 0;
+	int             b;
+	int             i;
+
+	for (b = 0; b < RANGE_KEYS; b += BATCH_NR) {
+		for (i = 0; i < BATCH_NR; ++i) {
+			k[i] = b + i;
+			keys[i] = M0_BUF_INIT_PTR(&k[i]);
+			vals[i] = M0_BUF_INIT_PTR(&v[i]);
+		}
+		M0_BE_OP_SYNC_WITH(&op, m0_be_btree_lookup_batch(tree, &op,
+						BATCH_NR, keys, vals, rcs));
+		for (i = 0; i < BATCH_NR; ++i)
+			nr += rcs[i] == 0;
+	}
+	return nr;
+}
+
+static void btree_range_test(const struct m0_be_btree_kv_ops *ops)
+{
+	static uint64_t     k[BATCH_NR];
+	static uint64_t     v[BATCH_NR];
+	static int          rcs[BATCH_NR];
+	struct m0_be_btree *tree;
+	m0_bcount_t         nr;
+	uint64_t            lo;
+	uint64_t            hi;
+	int                 calls;
+	int                 b;
+	int                 i;
+
+	M0_CASSERT(RANGE_KEYS % BATCH_NR == 0);
+	tree = btree_create_with(ops, 0);
+	for (b = 0; b < RANGE_KEYS; b += BATCH_NR) {
+		for (i = 0; i < BATCH_NR; ++i) {
+			k[i] = b + i;
+			v[i] = ~k[i];
+		}
+		btree_batch_insert(tree, k, v, rcs, BATCH_NR);
+		M0_UT_ASSERT(m0_forall(j, BATCH_NR, rcs[j] == 0));
+	}
+	/*
+	 * A large range goes in whole subtrees: the number of calls depends
+	 * on the tree height and on the range edges, not on the range size.
+	 */
+	lo = RANGE_KEYS / 3;
+	hi = 2 * RANGE_KEYS / 3;
+	calls = btree_range_delete_all(tree, &lo, &hi, hi - lo);
+	M0_UT_ASSERT(calls <= 4 * BTREE_HEIGHT_MAX);
+	btree_range_check(tree, lo, hi);
+	nr = btree_range_delete(tree, &lo, &hi);
+	M0_UT_ASSERT(nr == 0);
+	/* Bounds, which are not in the tree, and open bounds. */
+	btree_range_delete_all(tree, NULL, &lo, lo);
+	m0_be_ut_seg_reload(ut_seg);
+	btree_range_delete_all(tree, &hi, NULL, RANGE_KEYS - hi);
+	btree_range_check(tree, 0, RANGE_KEYS);
+	M0_UT_ASSERT(m0_be_btree_is_empty(tree));
+	for (b = 0; b < RANGE_KEYS; b += BATCH_NR) {
+		for (i = 0; i < BATCH_NR; ++i) {
+			k[i] = b + i;
+			v[i] = ~k[i];
+		}
+		btree_batch_insert(tree, k, v, rcs, BATCH_NR);
+		M0_UT_ASSERT(m0_forall(j, BATCH_NR, rcs[j] == 0));
+	}
+	/* The tree is usable between the cuts. */
+	lo = 1;
+	hi = RANGE_KEYS - 1;
+	nr = btree_range_delete(tree, &lo, &hi);
+	M0_UT_ASSERT(nr > 0 && nr <= hi - lo);
+	M0_UT_ASSERT(btree_range_present_nr(tree) == RANGE_KEYS - nr);
+	btree_range_delete_all(tree, &lo, &hi, hi - lo - nr);
+	btree_range_check(tree, lo, hi);
+	m0_be_btree_fini(tree);
+}
+
+/** Deletion of key ranges by cutting subtrees. */
+void m0_be_ut_btree_delete_range(void)
+{
+	M0_ALLOC_PTR(ut_be);
+	M0_UT_ASSERT(ut_be != NULL);
+	M0_ALLOC_PTR(ut_seg);
+	M0_UT_ASSERT(ut_seg != NULL);
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(ut_seg, ut_be, 1ULL << 24);
+	seg = ut_seg->bus_seg;
+
+	btree_range_test(&u64_kv_ops);
+	btree_range_test(&inline_u64_kv_ops);
+
+	m0_be_ut_seg_fini(ut_seg);
+	m0_be_ut_backend_fini(ut_be);
+	m0_free(ut_seg);
+	m0_free(ut_be);
+}
+
+#ifndef __KERNEL__
+struct btree_bulk_ut_src {
+	struct m0_be_btree_bulk_src bus_src;
+	uint64_t                    bus_i;
+	uint64_t                    bus_nr;
+	uint64_t                    bus_k;
+	uint64_t                    bus_v;
+};
+
+static int btree_bulk_ut_next(struct m0_be_btree_bulk_src *src,
+			      struct m0_buf               *key,
+			      struct m0_buf               *val)
+{
+	struct btree_bulk_ut_src *s;
+
+	s = container_of(src, struct btree_bulk_ut_src, bus_src);
+	if (s->bus_i == s->bus_nr)
+		return -ENOENT;
+	s->bus_k = 2 * s->bus_i++;
+	s->bus_v = ~s->bus_k;
+	*key = M0_BUF_INIT_PTR(&s->bus_k);
+	*val = M0_BUF_INIT_PTR(&s->bus_v);
+	return 0;
+}
+
+static void btree_bulk_load_test(const struct m0_be_btree_kv_ops *ops,
+				 uint64_t nr)
+{
+	struct btree_bulk_ut_src  src = {
+		.bus_src = { .bbs_next = &btree_bulk_ut_next },
+		.bus_nr  = nr,
+	};
+	struct m0_be_btree_cursor cursor;
+	struct m0_be_btree       *tree;
+	struct m0_buf             key;
+	struct m0_buf             val;
+	uint64_t                  k;
+	uint64_t                  i;
+	int                       rc;
+
+	tree = btree_create_with(ops, 0);
+	rc = m0_be_btree_bulk_load(tree, &ut_be->but_dom, &src.bus_src);
+	M0_UT_ASSERT(rc == 0);
+	m0_be_ut_seg_reload(ut_seg);
+
+	for (i = 0; i < nr; ++i) {
+		M0_UT_ASSERT(inline_lookup(tree, 2 * i) == 0);
+		M0_UT_ASSERT(inline_lookup(tree, 2 * i + 1) == -ENOENT);
+	}
+	m0_be_btree_cursor_init(&cursor, tree);
+	k = 0;
+	m0_buf_init(&key, &k, sizeof k);
+	rc = m0_be_btree_cursor_get_sync(&cursor, &key, true);
+	for (i = 0; rc == 0; ++i) {
+		m0_be_btree_cursor_kv_get(&cursor, &key, &val);
+		M0_UT_ASSERT(*(uint64_t *)key.b_addr == 2 * i);
+		rc = m0_be_btree_cursor_next_sync(&cursor);
+	}
+	M0_UT_ASSERT(rc == -ENOENT && i == nr);
+	m0_be_btree_cursor_fini(&cursor);
+
+	/* The loaded tree is a regular one. */
+	k = 2 * nr + 2;
+	m0_buf_init(&key, &k, sizeof k);
+	m0_buf_init(&val, &i, sizeof i);
+	i = ~k;
+	rc = btree_insert(tree, &key, &val, 0);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(inline_lookup(tree, k) == 0);
+	m0_be_btree_fini(tree);
+}
+
+/**
+ * Bulk-loads trees of different heights and checks that their contents
+ * survive segment reload.
+ */
+void m0_be_ut_btree_bulk_load(void)
+{
+	static const uint64_t nr[] = { 0, 1, 255, 256, 383, 100000 };
+	int                   i;
+
+	M0_ALLOC_PTR(ut_be);
+	M0_UT_ASSERT(ut_be != NULL);
+	M0_ALLOC_PTR(ut_seg);
+	M0_UT_ASSERT(ut_seg != NULL);
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(ut_seg, ut_be, 1ULL << 26);
+	seg = ut_seg->bus_seg;
+
+	for (i = 0; i < ARRAY_SIZE(nr); ++i) {
+		btree_bulk_load_test(&u64_kv_ops, nr[i]);
+		btree_bulk_load_test(&inline_u64_kv_ops, nr[i]);
+	}
+
+	m0_be_ut_seg_fini(ut_seg);
+	m0_be_ut_backend_fini(ut_be);
+	m0_free(ut_seg);
+	m0_free(ut_be);
+}
+
+/* ------------------------------------------------------------------
+ * UB
+ * ------------------------------------------------------------------ */
+
+enum {
+	BTREE_UB_KEYS_NR   = 1 << 20,
+	BTREE_UB_TX_OPS_NR = 128,
+	BTREE_UB_ITER      = 1 << 20,
+	BTREE_UB_BATCH     = 256,
+};
+
+static struct m0_be_btree *ub_tree;
+
+static void btree_ub_fill(void)
+{
+	struct m0_be_tx_credit cred = {};
+	struct m0_be_tx        tx;
+	struct m0_be_op        op;
+	struct m0_buf          key;
+	struct m0_buf          val;
+	uint64_t               k;
+	uint64_t               v;
+	int                    rc;
+	int                    i;
+	int                    j;
+
+	m0_buf_init(&key, &k, sizeof k);
+	m0_buf_init(&val, &v, sizeof v);
+	for (i = 0; i < BTREE_UB_KEYS_NR; i += BTREE_UB_TX_OPS_NR) {
+		M0_SET0(&cred);
+		m0_be_btree_insert_credit2(ub_tree, BTREE_UB_TX_OPS_NR,
+					   sizeof k, sizeof v, &cred);
+		M0_SET0(&tx);
+		m0_be_ut_tx_init(&tx, ut_be);
+		m0_be_tx_prep(&tx, &cred);
+		rc = m0_be_tx_open_sync(&tx);
+		M0_UB_ASSERT(rc == 0);
+		for (j = i; j < i + BTREE_UB_TX_OPS_NR; ++j) {
+			k = 2 * j;
+			v = ~k;
+			M0_SET0(&op);
+			rc = M0_BE_OP_SYNC_RET_WITH(&op,
+				m0_be_btree_insert(ub_tree, &tx, &op,
+						   &key, &val),
+				bo_u.u_btree.t_rc);
+			M0_UB_ASSERT(rc == 0);
+		}
+		m0_be_tx_close_sync(&tx);
+		m0_be_tx_fini(&tx);
+	}
+}
+
+static int btree_ub_init(const char *opts M0_UNUSED)
+{
+	M0_ALLOC_PTR(ut_be);
+	M0_UB_ASSERT(ut_be != NULL);
+	M0_ALLOC_PTR(ut_seg);
+	M0_UB_ASSERT(ut_seg != NULL);
+	m0_be_ut_backend_init(ut_be);
+	m0_be_ut_seg_init(ut_seg, ut_be, 1ULL << 29);
+	seg = ut_seg->bus_seg;
+
+	ub_tree = btree_create_with(&inline_u64_kv_ops, 0);
+	btree_ub_fill();
+	return 0;
+}
+
+static void btree_ub_fini(void)
+{
+	m0_be_btree_fini(ub_tree);
+	m0_be_ut_seg_fini(ut_seg);
+	m0_be_ut_backend_fini(ut_be);
+	m0_free(ut_seg);
+	m0_free(ut_be);
+}
+
+/* Tree format is the same, only node search differs. */
+static void btree_ub_cmp_init(void)
+{
+	ub_tree->bb_ops = &inline_kv_ops;
+}
+
+static void btree_ub_u64_init(void)
+{
+	ub_tree->bb_ops = &inline_u64_kv_ops;
+}
+
+static void btree_ub_lookup(int i)
+{
+	uint64_t k = 2 * (i * 2654435761ULL % BTREE_UB_KEYS_NR);
+
+	M0_UB_ASSERT(inline_lookup(ub_tree, k) == 0);
+}
+
+static void btree_ub_lookup_miss(int i)
+{
+	uint64_t k = 2 * (i * 2654435761ULL % BTREE_UB_KEYS_NR) + 1;
+
+	M0_UB_ASSERT(inline_lookup(ub_tree, k) == -ENOENT);
+}
+
+/* Sorted keys spread over the whole tree, one batch per round. */
+static void btree_ub_lookup_batch(int i)
+{
+	static uint64_t k[BTREE_UB_BATCH];
+	static uint64_t v[BTREE_UB_BATCH];
+	static int      rcs[BTREE_UB_BATCH];
+	struct m0_buf   keys[BTREE_UB_BATCH];
+	struct m0_buf   vals[BTREE_UB_BATCH];
+	struct m0_be_op op = {};
+	uint64_t        stride = BTREE_UB_KEYS_NR / BTREE_UB_BATCH;
+	uint64_t        start = i * 2654435761ULL % stride;
+	int             j;
+
+	for (j = 0; j < BTREE_UB_BATCH; ++j) {
+		k[j] = 2 * (start + j * stride);
+		keys[j] = M0_BUF_INIT_PTR(&k[j]);
+		vals[j] = M0_BUF_INIT_PTR(&v[j]);
+	}
+	M0_BE_OP_SYNC_WITH(&op, m0_be_btree_lookup_batch(ub_tree, &op,
+							 BTREE_UB_BATCH,
+							 keys, vals, rcs));
+	M0_UB_ASSERT(m0_forall(n, BTREE_UB_BATCH, rcs[n] == 0));
+}
+
+struct m0_ub_set m0_be_btree_ub = {
+	.us_name = "be-btree-ub",
+	.us_init = btree_ub_init,
+	.us_fini = btree_ub_fini,
+	.us_run  = {
+		{ .ub_name  = "lookup-cmp",
+		  .ub_iter  = BTREE_UB_ITER,
+		  .ub_init  = btree_ub_cmp_init,
+		  .ub_round = btree_ub_lookup },
+
+		{ .ub_name  = "lookup-u64",
+		  .ub_iter  = BTREE_UB_ITER,
+		  .ub_init  = btree_ub_u64_init,
+		  .ub_round = btree_ub_lookup },
+
+		{ .ub_name  = "lookup-batch",
+		  .ub_iter  = BTREE_UB_ITER / BTREE_UB_BATCH,
+		  .ub_init  = btree_ub_u64_init,
+		  .ub_round = btree_ub_lookup_batch },
+
+		{ .ub_name  = "miss-cmp",
+		  .ub_iter  = BTREE_UB_ITER,
+		  .ub_init  = btree_ub_cmp_init,
+		  .ub_round = btree_ub_lookup_miss },
+
+		{ .ub_name  = "miss-u64",
+		  .ub_iter  = BTREE_UB_ITER,
+		  .ub_init  = btree_ub_u64_init,
+		  .ub_round = btree_ub_lookup_miss },
+
+		{ .ub_name = NULL }
+	}
+};
+#endif /* __KERNEL__ */
+
 #undef M0_TRACE_SUBSYSTEM
 
 /*
@@ -287,8 +287,10 @@ void m0_be_ut_backend_cfg_default(struct m0_be_domain_cfg *cfg)
 		.bec_group_freeze_timeout_min   =     1ULL * M0_TIME_ONE_MSEC,
 		.bec_group_freeze_timeout_max   =    50ULL * M0_TIME_ONE_MSEC,
 		.bec_group_freeze_timeout_limit = 60000ULL * M0_TIME_ONE_MSEC,
+		.bec_group_adaptive       = true,
 		.bec_reqh		  = reqh,
 		.bec_wait_for_recovery	  = true,
+		.bec_recovery_group_nr	  = 2,
 	    },
 		.bc_log = {
 			.lc_store_cfg = {
@@ -312,8 +314,12 @@ void m0_be_ut_backend_cfg_default(struct m0_be_domain_cfg *cfg)
 			},
 			.lc_sched_cfg = {
 				.lsch_io_sched_cfg = {
+					.bisc_io_nr_max = 4,
 				},
 			},
+			.lc_recovery_cfg = {
+				.brc_reapply_thread_nr = 4,
+			},
 			.lc_full_threshold = 20 * (1 << 20),
 			.lc_skip_recovery  = false,
 			/* other fields are filled by the domain */
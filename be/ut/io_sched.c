@@ -110,6 +110,8 @@ struct be_ut_io_sched_test {
 };
 
 static struct m0_be_io_sched  be_ut_io_sched_scheduler;
+/* end of the last m0_be_io which is reported as finished */
+static m0_bcount_t            be_ut_io_sched_pos_done;
 
 static void be_ut_io_sched_io_ready_add(struct be_ut_io_sched_test *test,
 					struct m0_be_io            *bio,
@@ -167,6 +169,9 @@ static void be_ut_io_sched_io_completion_cb(struct m0_be_op *op, void *param)
 		.sis_time = m0_time_now(),
 		.sis_io   = bio,
 	};
+	/* I/Os are reported as finished one by one in m0_ext order */
+	M0_UT_ASSERT(bio->bio_ext.e_start == be_ut_io_sched_pos_done);
+	be_ut_io_sched_pos_done = bio->bio_ext.e_end;
 	be_ut_io_sched_io_state_add(test, &io_state);
 	be_ut_io_sched_io_ready_add(test, bio, op);
 }
@@ -278,15 +283,16 @@ M0_UT_THREADS_DEFINE(be_ut_io_sched, &be_ut_io_sched_thread);
  * 3) Checks that all start and completion callbacks for m0_be_io was called
  * in the right order.
  *
- * @note Currently m0_be_io_sched executes m0_be_io one by one in the
- * order they are added to the scheduler queue.
+ * @note m0_be_io_sched launches up to io_nr_max m0_be_io at the same time,
+ * but completion callbacks are called in m0_ext order.
  */
-void m0_be_ut_io_sched(void)
+static void be_ut_io_sched_run(uint32_t io_nr_max)
 {
 	struct be_ut_io_sched_io_state *states;
 	struct be_ut_io_sched_test     *tests;
 	struct m0_be_io_sched_cfg       cfg = {
 		.bisc_pos_start = 0x1234,
+		.bisc_io_nr_max = io_nr_max,
 	};
 	struct m0_be_io_sched          *sched = &be_ut_io_sched_scheduler;
 	struct m0_atomic64              states_pos;
@@ -306,6 +312,7 @@ void m0_be_ut_io_sched(void)
 	M0_UT_ASSERT(stob != NULL);
 	m0_atomic64_set(&states_pos, 0);
 	m0_atomic64_set(&ext_index, cfg.bisc_pos_start);
+	be_ut_io_sched_pos_done = cfg.bisc_pos_start;
 	for (i = 0; i < BE_UT_IO_SCHED_THREAD_NR; ++i) {
 		tests[i] = (struct be_ut_io_sched_test){
 			.st_io_nr        = BE_UT_IO_SCHED_IO_NR,
@@ -334,6 +341,16 @@ void m0_be_ut_io_sched(void)
 	m0_free(tests);
 }
 
+void m0_be_ut_io_sched(void)
+{
+	be_ut_io_sched_run(1);
+}
+
+void m0_be_ut_io_sched_concurrent(void)
+{
+	be_ut_io_sched_run(8);
+}
+
 /** @} end of be group */
 #undef M0_TRACE_SUBSYSTEM
 
@@ -24,6 +24,7 @@
 #include "be/log.h"
 #include "lib/chan.h"
 #include "lib/errno.h"
+#include "lib/finject.h"        /* m0_fi_enable_once */
 #include "lib/memory.h"
 #include "stob/domain.h"
 #include "stob/stob.h"
@@ -446,12 +447,17 @@ void m0_be_ut_log_multi(void)
 	be_ut_log_multi_ut(BE_UT_LOG_THREAD_NR, false, 2, BE_UT_LOG_LIO_SIZE);
 }
 
-/** @see be_ut_recovery_iter_count() */
-static void be_ut_log_recover_and_discard(struct m0_be_log *log,
-                                          struct m0_mutex  *lock)
+/**
+ * Returns number of recovered records.
+ *
+ * @see be_ut_recovery_iter_count()
+ */
+static int be_ut_log_recover_and_discard(struct m0_be_log *log,
+                                         struct m0_mutex  *lock)
 {
 	struct m0_be_log_record_iter iter   = {};
 	struct m0_be_log_record      record = {};
+	int                          nr     = 0;
 	int                          rc;
 
 	m0_be_log_record_init(&record, log);
@@ -475,10 +481,12 @@ static void be_ut_log_recover_and_discard(struct m0_be_log *log,
 		m0_be_log_record_discard(log, record.lgr_size);
 		m0_mutex_unlock(lock);
 		m0_be_log_record_reset(&record);
+		++nr;
 	}
 	m0_be_log_record_iter_fini(&iter);
 	m0_be_log_record_deallocate(&record);
 	m0_be_log_record_fini(&record);
+	return nr;
 }
 
 /*
@@ -573,6 +581,51 @@ void m0_be_ut_log_unplaced(void)
 	m0_mutex_fini(&lock);
 }
 
+/*
+ * Checks that recovery stops at a record with wrong checksum, i.e. at a record
+ * that has valid header and footer but is partially written.
+ */
+void m0_be_ut_log_torn(void)
+{
+	struct m0_be_log        log  = {};
+	struct m0_mutex         lock = {};
+	struct m0_be_log_record records[4];
+	struct m0_be_op         ops[4];
+	m0_bindex_t             pos;
+	int                     nr;
+	int                     rc;
+	int                     i;
+
+	m0_mutex_init(&lock);
+	be_ut_log_init(&log, &lock);
+
+	memset(records, 0, sizeof(records));
+	memset(ops, 0, sizeof(ops));
+	for (i = 0; i < 4; ++i) {
+		if (i == 2)
+			m0_fi_enable_once("be_log_record_header_encode",
+					  "torn_record");
+		be_ut_log_record_init_write_one(&records[i], &log,
+						&lock, &ops[i]);
+	}
+	pos = records[0].lgr_position;
+	for (i = 0; i < 4; ++i) {
+		be_ut_log_record_wait_fini_one(&records[i], &lock,
+					       &ops[i], false);
+	}
+
+	m0_be_log_close(&log);
+	rc = be_ut_log_open(&log, &lock);
+	M0_UT_ASSERT(rc == 0);
+	be_ut_log_curr_pos_check(&log, pos);
+	/* The 3rd record is torn, it and the following ones are lost. */
+	nr = be_ut_log_recover_and_discard(&log, &lock);
+	M0_UT_ASSERT(nr == 2);
+
+	be_ut_log_fini(&log);
+	m0_mutex_fini(&lock);
+}
+
 void m0_be_ut_log_header(void)
 {
 	struct m0_be_fmt_log_header header  = {};
@@ -66,6 +66,7 @@ extern void m0_be_ut_fmt_group_size_max_rnd(void);
 
 extern void m0_be_ut_io(void);
 extern void m0_be_ut_io_sched(void);
+extern void m0_be_ut_io_sched_concurrent(void);
 
 extern void m0_be_ut_log_store_create_simple(void);
 extern void m0_be_ut_log_store_create_random(void);
@@ -83,6 +84,7 @@ extern void m0_be_ut_log_user(void);
 extern void m0_be_ut_log_api(void);
 extern void m0_be_ut_log_header(void);
 extern void m0_be_ut_log_unplaced(void);
+extern void m0_be_ut_log_torn(void);
 extern void m0_be_ut_log_multi(void);
 
 extern void m0_be_ut_recovery(void);
@@ -90,12 +92,15 @@ extern void m0_be_ut_recovery(void);
 extern void m0_be_ut_pd_usecase(void);
 
 extern void m0_be_ut_seg_open_close(void);
+extern void m0_be_ut_seg_version(void);
 extern void m0_be_ut_seg_io(void);
 extern void m0_be_ut_seg_multiple(void);
 extern void m0_be_ut_seg_large(void);
 extern void m0_be_ut_seg_large_multiple(void);
+extern void m0_be_ut_seg_paging(void);
 
 extern void m0_be_ut_group_format(void);
+extern void m0_be_ut_group_format_lz(void);
 
 extern void m0_be_ut_mkfs(void);
 extern void m0_be_ut_mkfs_multiseg(void);
@@ -107,12 +112,14 @@ extern void m0_be_ut_tx_empty(void);
 extern void m0_be_ut_tx_usecase_success(void);
 extern void m0_be_ut_tx_usecase_failure(void);
 extern void m0_be_ut_tx_capturing(void);
+extern void m0_be_ut_tx_log_compress(void);
 extern void m0_be_ut_tx_single(void);
 extern void m0_be_ut_tx_several(void);
 extern void m0_be_ut_tx_persistence(void);
 extern void m0_be_ut_tx_fast(void);
 extern void m0_be_ut_tx_concurrent(void);
 extern void m0_be_ut_tx_concurrent_excl(void);
+extern void m0_be_ut_tx_adaptive(void);
 extern void m0_be_ut_tx_force(void);
 extern void m0_be_ut_tx_gc(void);
 extern void m0_be_ut_tx_payload(void);
@@ -140,10 +147,16 @@ extern void m0_be_ut_alloc_concurrent(void);
 extern void m0_be_ut_alloc_oom(void);
 extern void m0_be_ut_alloc_info(void);
 extern void m0_be_ut_alloc_spare(void);
+extern void m0_be_ut_alloc_mag(void);
 
 extern void m0_be_ut_list(void);
 extern void m0_be_ut_btree_create_destroy(void);
 extern void m0_be_ut_btree_create_truncate(void);
+extern void m0_be_ut_btree_concurrent(void);
+extern void m0_be_ut_btree_inline_keys(void);
+extern void m0_be_ut_btree_batch(void);
+extern void m0_be_ut_btree_delete_range(void);
+extern void m0_be_ut_btree_bulk_load(void);
 extern void m0_be_ut_emap(void);
 extern void m0_be_ut_seg_dict(void);
 extern void m0_be_ut_seg0_test(void);
@@ -197,6 +210,7 @@ struct m0_ut_suite be_ut = {
 		{ "fmt-group_size_max_rnd",  m0_be_ut_fmt_group_size_max_rnd  },
 		{ "io-noop",                 m0_be_ut_io                      },
 		{ "io_sched",                m0_be_ut_io_sched                },
+		{ "io_sched-concurrent",     m0_be_ut_io_sched_concurrent     },
 		{ "log_store-create_simple", m0_be_ut_log_store_create_simple },
 		{ "log_store-create_random", m0_be_ut_log_store_create_random },
 		{ "log_store-io_window",     m0_be_ut_log_store_io_window     },
@@ -210,17 +224,21 @@ struct m0_ut_suite be_ut = {
 		{ "log-api",                 m0_be_ut_log_api                 },
 		{ "log-header",              m0_be_ut_log_header              },
 		{ "log-unplaced",            m0_be_ut_log_unplaced            },
+		{ "log-torn",                m0_be_ut_log_torn                },
 /* XXX this test writes and discards records in random order
 		{ "log-multi",               m0_be_ut_log_multi               },
 */
 		{ "recovery",                m0_be_ut_recovery                },
 		{ "pd-usecase",              m0_be_ut_pd_usecase              },
 		{ "seg-open",                m0_be_ut_seg_open_close          },
+		{ "seg-version",             m0_be_ut_seg_version             },
 		{ "seg-io",                  m0_be_ut_seg_io                  },
 		{ "seg-multiple",            m0_be_ut_seg_multiple            },
 		{ "seg-large",               m0_be_ut_seg_large               },
 		{ "seg-large-multiple",      m0_be_ut_seg_large_multiple      },
+		{ "seg-paging",              m0_be_ut_seg_paging              },
 		{ "group_format",            m0_be_ut_group_format            },
+		{ "group_format-lz",         m0_be_ut_group_format_lz         },
 		{ "mkfs",                    m0_be_ut_mkfs                    },
 		{ "mkfs-multiseg",           m0_be_ut_mkfs_multiseg           },
 		{ "domain",                  m0_be_ut_domain                  },
@@ -230,6 +248,7 @@ struct m0_ut_suite be_ut = {
 		{ "tx-usecase_success",      m0_be_ut_tx_usecase_success      },
 		{ "tx-usecase_failure",      m0_be_ut_tx_usecase_failure      },
 		{ "tx-capturing",            m0_be_ut_tx_capturing            },
+		{ "tx-log_compress",         m0_be_ut_tx_log_compress         },
 		{ "tx-gc",                   m0_be_ut_tx_gc                   },
 		{ "tx-single",               m0_be_ut_tx_single               },
 		{ "tx-several",              m0_be_ut_tx_several              },
@@ -239,6 +258,7 @@ struct m0_ut_suite be_ut = {
 		{ "tx-payload",              m0_be_ut_tx_payload              },
 		{ "tx-concurrent",           m0_be_ut_tx_concurrent           },
 		{ "tx-concurrent-excl",      m0_be_ut_tx_concurrent_excl      },
+		{ "tx-adaptive",             m0_be_ut_tx_adaptive             },
 		{ "tx_bulk-usecase",         m0_be_ut_tx_bulk_usecase         },
 		{ "tx_bulk-empty",           m0_be_ut_tx_bulk_empty           },
 		{ "tx_bulk-error_reg",       m0_be_ut_tx_bulk_error_reg       },
@@ -260,14 +280,20 @@ struct m0_ut_suite be_ut = {
 		{ "alloc-oom",               m0_be_ut_alloc_oom               },
 		{ "alloc-info",              m0_be_ut_alloc_info              },
 		{ "alloc-spare",             m0_be_ut_alloc_spare             },
+		{ "alloc-mag",               m0_be_ut_alloc_mag               },
 		{ "obj",                     m0_be_ut_obj_test                },
 		{ "actrec",                  m0_be_ut_actrec_test             },
 #endif /* __KERNEL__ */
 		{ "list",                    m0_be_ut_list                    },
 		{ "btree-create_destroy",    m0_be_ut_btree_create_destroy    },
 		{ "btree-create_truncate",   m0_be_ut_btree_create_truncate   },
+		{ "btree-concurrent",        m0_be_ut_btree_concurrent        },
+		{ "btree-inline_keys",       m0_be_ut_btree_inline_keys       },
+		{ "btree-batch",             m0_be_ut_btree_batch             },
+		{ "btree-delete_range",      m0_be_ut_btree_delete_range      },
 		{ "seg_dict",                m0_be_ut_seg_dict                },
 #ifndef __KERNEL__
+		{ "btree-bulk_load",         m0_be_ut_btree_bulk_load         },
 		{ "seg0",                    m0_be_ut_seg0_test               },
 #endif /* __KERNEL__ */
 		{ "emap",                    m0_be_ut_emap                    },
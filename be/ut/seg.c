@@ -31,10 +31,17 @@
 #include "lib/semaphore.h"      /* m0_semaphore */
 #include "lib/misc.h"           /* m0_forall */
 #include "lib/memory.h"         /* M0_ALLOC_PTR */
+#include "lib/errno.h"          /* EPROTO */
 
 #include "ut/ut.h"              /* M0_UT_ASSERT */
 #include "ut/stob.h"            /* m0_ut_stob_linux_get */
 #include "be/ut/helper.h"       /* m0_be_ut_seg_helper */
+#include "be/seg_internal.h"    /* m0_be_seg_hdr */
+#include "be/io.h"              /* m0_be_io_single */
+#include "format/format.h"      /* m0_format_header_pack */
+
+#include <sys/mman.h>           /* MADV_PAGEOUT */
+#include <unistd.h>             /* access */
 
 enum {
 	BE_UT_SEG_SIZE    = 0x20000,
@@ -52,6 +59,52 @@ M0_INTERNAL void m0_be_ut_seg_open_close(void)
 	m0_be_ut_seg_fini(&ut_seg);
 }
 
+static void be_ut_seg_hdr_version_set(struct m0_be_seg     *seg,
+				      struct m0_be_seg_hdr *hdr,
+				      uint16_t              version)
+{
+	int rc;
+
+	m0_format_header_pack(&hdr->bh_header, &(struct m0_format_tag){
+		.ot_version       = version,
+		.ot_type          = M0_FORMAT_TYPE_BE_SEG_HDR,
+		.ot_footer_offset = offsetof(struct m0_be_seg_hdr, bh_footer)
+	});
+	m0_format_footer_update(hdr);
+	rc = m0_be_io_single(seg->bs_stob, SIO_WRITE, hdr,
+			     M0_BE_SEG_HEADER_OFFSET, sizeof *hdr);
+	M0_UT_ASSERT(rc == 0);
+}
+
+/* A segment with a header of another format version is not opened. */
+M0_INTERNAL void m0_be_ut_seg_version(void)
+{
+	struct m0_be_ut_seg   ut_seg;
+	struct m0_be_seg_hdr *hdr;
+	struct m0_be_seg     *seg;
+	int                   rc;
+
+	m0_be_ut_seg_init(&ut_seg, NULL, BE_UT_SEG_SIZE);
+	seg = ut_seg.bus_seg;
+	m0_be_seg_close(seg);
+
+	hdr = m0_alloc(sizeof *hdr);
+	M0_UT_ASSERT(hdr != NULL);
+	rc = m0_be_io_single(seg->bs_stob, SIO_READ, hdr,
+			     M0_BE_SEG_HEADER_OFFSET, sizeof *hdr);
+	M0_UT_ASSERT(rc == 0);
+	be_ut_seg_hdr_version_set(seg, hdr, M0_BE_SEG_HDR_FORMAT_VERSION_1);
+	rc = m0_be_seg_open(seg);
+	M0_UT_ASSERT(rc == -EPROTO);
+	M0_UT_ASSERT(seg->bs_state == M0_BSS_CLOSED);
+
+	be_ut_seg_hdr_version_set(seg, hdr, M0_BE_SEG_HDR_FORMAT_VERSION);
+	m0_free(hdr);
+	rc = m0_be_seg_open(seg);
+	M0_UT_ASSERT(rc == 0);
+	m0_be_ut_seg_fini(&ut_seg);
+}
+
 static void be_ut_seg_rand_reg(struct m0_be_reg *reg,
 			       void *seg_addr,
 			       m0_bindex_t *offset,
@@ -422,6 +475,116 @@ void m0_be_ut_seg_large_multiple(void)
 	m0_ut_stob_put(stob, true);
 }
 
+enum {
+	BE_UT_SEG_PAGING_SIZE  = 1ULL << 24,
+	BE_UT_SEG_PAGING_CHUNK = 1ULL << 20,
+	BE_UT_SEG_PAGING_MAX   = 1ULL << 22,
+};
+
+/** Checks that the running kernel supports MADV_PAGEOUT. */
+static bool be_ut_seg_pageout_supported(void)
+{
+	bool  supported = false;
+#ifdef MADV_PAGEOUT
+	void *p;
+
+	p = mmap(NULL, m0_pagesize_get(), PROT_READ | PROT_WRITE,
+		 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	M0_UT_ASSERT(p != MAP_FAILED);
+	supported = madvise(p, m0_pagesize_get(), MADV_PAGEOUT) == 0;
+	munmap(p, m0_pagesize_get());
+#endif
+	return supported;
+}
+
+/**
+ * Fills a segment beyond the resident set limit and checks that cold chunks
+ * are paged out, that paged out data is faulted in intact and that accesses
+ * to resident pages are counted as hits.
+ */
+void m0_be_ut_seg_paging(void)
+{
+	struct m0_be_seg_paging_stats stats;
+	struct m0_be_seg_paging_stats prev;
+	struct m0_be_seg             *seg;
+	struct m0_stob               *stob;
+	m0_bindex_t                   i;
+	void                         *addr;
+	int                           rc;
+	int                           j;
+
+	M0_ALLOC_PTR(seg);
+	M0_UT_ASSERT(seg != NULL);
+	stob = m0_ut_stob_linux_get();
+	M0_UT_ASSERT(stob != NULL);
+	addr = m0_be_ut_seg_allocate_addr(BE_UT_SEG_PAGING_SIZE);
+	m0_be_seg_init(seg, stob, NULL, M0_BE_SEG_FAKE_ID);
+	rc = m0_be_seg_create(seg, BE_UT_SEG_PAGING_SIZE, addr);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_be_seg_open(seg);
+	M0_UT_ASSERT(rc == 0);
+	/* scans are done by the UT, the pager thread only waits */
+	rc = m0_be_seg_paging_start(seg, &(struct m0_be_seg_paging_cfg){
+		.bspc_resident_max = BE_UT_SEG_PAGING_MAX,
+		.bspc_chunk_size   = BE_UT_SEG_PAGING_CHUNK,
+		.bspc_scan_nr      = BE_UT_SEG_PAGING_SIZE /
+				     BE_UT_SEG_PAGING_CHUNK,
+		.bspc_interval     = M0_MKTIME(1000, 0),
+	});
+	M0_UT_ASSERT(rc == 0);
+
+	/* the first half is written, the second one is only read */
+	be_ut_seg_large_mem(seg, 1, BE_UT_SEG_PAGING_SIZE / 2, false);
+	for (i = BE_UT_SEG_PAGING_SIZE / 2; i < BE_UT_SEG_PAGING_SIZE;
+	     i += BE_UT_SEG_LARGE_STEP)
+		M0_UT_ASSERT(((volatile char *)seg->bs_addr)[i] == 0);
+	m0_be_seg_paging_scan(seg);
+	m0_be_seg_paging_stats(seg, &stats);
+	/* every page touched so far was faulted in */
+	M0_UT_ASSERT(stats.bsps_miss > 0);
+	M0_UT_ASSERT(stats.bsps_hit == 0);
+	M0_UT_ASSERT(stats.bsps_evicted == 0);
+	M0_UT_ASSERT(stats.bsps_resident * m0_pagesize_get() >
+		     BE_UT_SEG_PAGING_MAX);
+	/* chunks become cold after a few scans without faults */
+	for (j = 0; j < 4; ++j)
+		m0_be_seg_paging_scan(seg);
+	prev = stats;
+	m0_be_seg_paging_stats(seg, &stats);
+	/* the read-only half is clean and is paged out */
+	if (be_ut_seg_pageout_supported()) {
+		M0_UT_ASSERT(stats.bsps_evicted > 0);
+		M0_UT_ASSERT(stats.bsps_resident < prev.bsps_resident);
+	}
+	/* paged out pages are faulted in with the same data */
+	be_ut_seg_large_mem(seg, 1, BE_UT_SEG_PAGING_SIZE / 2, true);
+	for (i = BE_UT_SEG_PAGING_SIZE / 2; i < BE_UT_SEG_PAGING_SIZE;
+	     i += BE_UT_SEG_LARGE_STEP)
+		M0_UT_ASSERT(((char *)seg->bs_addr)[i] == 0);
+	m0_be_seg_paging_scan(seg);
+	prev = stats;
+	m0_be_seg_paging_stats(seg, &stats);
+	M0_UT_ASSERT(ergo(stats.bsps_evicted > 0,
+			  stats.bsps_miss > prev.bsps_miss));
+	/* the pages are resident now, accessing them again gives hits */
+	be_ut_seg_large_mem(seg, 1, BE_UT_SEG_PAGING_SIZE / 2, true);
+	m0_be_seg_paging_scan(seg);
+	prev = stats;
+	m0_be_seg_paging_stats(seg, &stats);
+	if (access("/proc/self/clear_refs", W_OK) == 0)
+		M0_UT_ASSERT(stats.bsps_hit > prev.bsps_hit);
+	M0_LOG(M0_DEBUG, "hit=%"PRIu64" miss=%"PRIu64" evicted=%"PRIu64
+	       " resident=%"PRIu64, stats.bsps_hit, stats.bsps_miss,
+	       stats.bsps_evicted, stats.bsps_resident);
+
+	m0_be_seg_close(seg);
+	rc = m0_be_seg_destroy(seg);
+	M0_UT_ASSERT(rc == 0);
+	m0_be_seg_fini(seg);
+	m0_ut_stob_put(stob, true);
+	m0_free(seg);
+}
+
 #undef M0_TRACE_SUBSYSTEM
 
 /*
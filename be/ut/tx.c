@@ -36,6 +36,7 @@
 #include "lib/arith.h"          /* m0_rnd64 */
 #include "lib/misc.h"           /* M0_BITS */
 #include "lib/memory.h"         /* M0_ALLOC_PTR */
+#include "lib/finject.h"        /* m0_fi_enable */
 
 #include "ut/ut.h"
 
@@ -697,18 +698,15 @@ static void be_ut_tx_thread(struct be_ut_tx_thread_state *state)
 	m0_be_ut_backend_thread_exit(state->tts_ut_be);
 }
 
-void m0_be_ut_tx_concurrent_helper(bool exclusive)
+static void be_ut_tx_concurrent_run(struct m0_be_ut_backend *ut_be,
+				    bool                     exclusive)
 {
 	static struct be_ut_tx_thread_state threads[BE_UT_TX_C_THREAD_NR];
-	struct m0_be_ut_backend             ut_be;
 	int                                 i;
 	int                                 rc;
 
-	M0_SET0(&ut_be);
-	m0_be_ut_backend_init(&ut_be);
-
 	for (i = 0; i < ARRAY_SIZE(threads); ++i) {
-		threads[i].tts_ut_be     = &ut_be;
+		threads[i].tts_ut_be     = ut_be;
 		threads[i].tts_exclusive = !exclusive ? false :
 			(i == ARRAY_SIZE(threads) / 2 ||
 			 i == ARRAY_SIZE(threads) / 4 ||
@@ -724,7 +722,15 @@ void m0_be_ut_tx_concurrent_helper(bool exclusive)
 		M0_UT_ASSERT(rc == 0);
 		m0_thread_fini(&threads[i].tts_thread);
 	}
+}
 
+void m0_be_ut_tx_concurrent_helper(bool exclusive)
+{
+	struct m0_be_ut_backend ut_be;
+
+	M0_SET0(&ut_be);
+	m0_be_ut_backend_init(&ut_be);
+	be_ut_tx_concurrent_run(&ut_be, exclusive);
 	m0_be_ut_backend_fini(&ut_be);
 }
 
@@ -738,6 +744,97 @@ void m0_be_ut_tx_concurrent_excl(void)
 	m0_be_ut_tx_concurrent_helper(true);
 }
 
+enum {
+	BE_UT_TX_ADAPTIVE_TX_NR    = 0x10,
+	BE_UT_TX_ADAPTIVE_SEG_SIZE = 0x10000,
+	BE_UT_TX_ADAPTIVE_TIMEOUT  = 100 * M0_TIME_ONE_MSEC,
+};
+
+/*
+ * Runs transactions one after another, each one waits until it's done.
+ * Returns the time it took.
+ */
+static m0_time_t be_ut_tx_adaptive_sequential(bool adaptive)
+{
+	struct m0_be_ut_backend  ut_be = {};
+	struct m0_be_domain_cfg  cfg;
+	struct m0_be_engine_cfg *en_cfg = &cfg.bc_engine;
+	struct m0_be_ut_seg      ut_seg;
+	struct m0_be_seg        *seg;
+	struct m0_be_tx          tx;
+	m0_time_t                start;
+	uint64_t                *ptr;
+	int                      i;
+	int                      rc;
+
+	m0_be_ut_backend_cfg_default(&cfg);
+	en_cfg->bec_group_adaptive           = adaptive;
+	en_cfg->bec_group_freeze_timeout_min = BE_UT_TX_ADAPTIVE_TIMEOUT;
+	en_cfg->bec_group_freeze_timeout_max = BE_UT_TX_ADAPTIVE_TIMEOUT;
+	rc = m0_be_ut_backend_init_cfg(&ut_be, &cfg, true);
+	M0_UT_ASSERT(rc == 0);
+	m0_be_ut_seg_init(&ut_seg, NULL, BE_UT_TX_ADAPTIVE_SEG_SIZE);
+	seg = ut_seg.bus_seg;
+	ptr = seg->bs_addr + m0_be_seg_reserved(seg);
+
+	start = m0_time_now();
+	for (i = 0; i < BE_UT_TX_ADAPTIVE_TX_NR; ++i) {
+		M0_SET0(&tx);
+		m0_be_ut_tx_init(&tx, &ut_be);
+		m0_be_tx_prep(&tx, &M0_BE_TX_CREDIT_TYPE(uint64_t));
+		rc = m0_be_tx_open_sync(&tx);
+		M0_UT_ASSERT(rc == 0);
+		*ptr = i;
+		m0_be_tx_capture(&tx, &M0_BE_REG_PTR(seg, ptr));
+		m0_be_tx_close_sync(&tx);
+		m0_be_tx_fini(&tx);
+	}
+	start = m0_time_sub(m0_time_now(), start);
+
+	m0_be_ut_seg_fini(&ut_seg);
+	m0_be_ut_backend_fini(&ut_be);
+	return start;
+}
+
+void m0_be_ut_tx_adaptive(void)
+{
+	struct m0_be_ut_backend  ut_be = {};
+	struct m0_be_domain_cfg  cfg;
+	struct m0_be_engine_cfg *en_cfg = &cfg.bc_engine;
+	struct m0_be_engine_ctl *ctl;
+	m0_time_t                t_static;
+	m0_time_t                t_adaptive;
+	int                      rc;
+
+	m0_be_ut_backend_cfg_default(&cfg);
+	en_cfg->bec_group_adaptive = true;
+	rc = m0_be_ut_backend_init_cfg(&ut_be, &cfg, true);
+	M0_UT_ASSERT(rc == 0);
+	be_ut_tx_concurrent_run(&ut_be, false);
+
+	ctl = &m0_be_domain_engine(&ut_be.but_dom)->eng_ctl;
+	M0_UT_ASSERT(ctl->bect_arrival > 0);
+	M0_UT_ASSERT(ctl->bect_log_latency > 0);
+	M0_UT_ASSERT(ctl->bect_tx_nr >= 1);
+	M0_UT_ASSERT(ctl->bect_tx_nr <= en_cfg->bec_group_cfg.tgc_tx_nr_max);
+	M0_UT_ASSERT(ctl->bect_delay >= en_cfg->bec_group_freeze_timeout_min);
+	M0_UT_ASSERT(ctl->bect_delay <=
+		     en_cfg->bec_group_freeze_timeout_limit);
+	m0_be_ut_backend_fini(&ut_be);
+
+	/*
+	 * With one transaction at a time a group never fills up. The static
+	 * policy waits the freeze timeout for every group. The controller sees
+	 * that no other transaction arrives while a group is written and
+	 * freezes groups at once.
+	 */
+	t_static   = be_ut_tx_adaptive_sequential(false);
+	t_adaptive = be_ut_tx_adaptive_sequential(true);
+	M0_UT_ASSERT(t_static >=
+		     BE_UT_TX_ADAPTIVE_TX_NR * BE_UT_TX_ADAPTIVE_TIMEOUT);
+	M0_UT_ASSERT(t_adaptive < t_static / 2);
+}
+
 enum {
 	BE_UT_TX_CAPTURING_SEG_SIZE = 0x10000,
 	BE_UT_TX_CAPTURING_TX_NR    = 0x10,
@@ -787,6 +884,87 @@ void m0_be_ut_tx_capturing(void)
 	m0_be_ut_backend_fini(&ut_be);
 }
 
+enum {
+	BE_UT_TX_LOG_COMPRESS_SEG_SIZE = 0x10000,
+	BE_UT_TX_LOG_COMPRESS_REG_SIZE = 0x2000,
+	BE_UT_TX_LOG_COMPRESS_PATTERN  = 0x5a,
+};
+
+/*
+ * Writes a tx with compressed log records, "crashes" before the segment and
+ * the log header are written and checks that recovery restores the data
+ * from the compressed record.
+ */
+void m0_be_ut_tx_log_compress(void)
+{
+	struct m0_be_ut_backend  ut_be = {};
+	struct m0_be_domain_cfg  cfg = {};
+	struct m0_be_domain     *dom = &ut_be.but_dom;
+	struct m0_be_allocator  *a;
+	struct m0_be_seg        *seg;
+	struct m0_be_tx          tx;
+	struct m0_be_reg         reg;
+	void                    *addr;
+	void                    *ptr = NULL;
+	char                    *buf;
+	m0_bcount_t              i;
+	int                      rc;
+
+	m0_be_ut_backend_cfg_default(&cfg);
+	cfg.bc_engine.bec_group_cfg.tgc_log_compress = true;
+	rc = m0_be_ut_backend_init_cfg(&ut_be, &cfg, true);
+	M0_UT_ASSERT(rc == 0);
+	m0_be_ut_backend_seg_add2(&ut_be, BE_UT_TX_LOG_COMPRESS_SEG_SIZE,
+				  true, NULL, &seg);
+	addr = seg->bs_addr;
+	a = m0_be_seg_allocator(seg);
+	M0_BE_UT_TRANSACT(&ut_be, atx, cred,
+		m0_be_allocator_credit(a, M0_BAO_ALLOC,
+				       BE_UT_TX_LOG_COMPRESS_REG_SIZE, 0, &cred),
+		M0_BE_OP_SYNC(op, m0_be_alloc(a, atx, &op, &ptr,
+					      BE_UT_TX_LOG_COMPRESS_REG_SIZE)));
+	M0_UT_ASSERT(ptr != NULL);
+	m0_be_ut_backend_fini(&ut_be);
+
+	M0_SET0(&ut_be);
+	rc = m0_be_ut_backend_init_cfg(&ut_be, &cfg, false);
+	M0_UT_ASSERT(rc == 0);
+	seg = m0_be_domain_seg(dom, addr);
+	M0_UT_ASSERT(seg != NULL);
+	reg = M0_BE_REG(seg, BE_UT_TX_LOG_COMPRESS_REG_SIZE, ptr);
+
+	m0_fi_enable("m0_be_group_format_seg_place", "skip_seg_io");
+	M0_SET0(&tx);
+	m0_be_ut_tx_init(&tx, &ut_be);
+	m0_be_tx_prep(&tx, &M0_BE_TX_CREDIT(1, reg.br_size));
+	rc = m0_be_tx_open_sync(&tx);
+	M0_UT_ASSERT(rc == 0);
+	memset(ptr, BE_UT_TX_LOG_COMPRESS_PATTERN, reg.br_size);
+	m0_be_tx_capture(&tx, &reg);
+	m0_be_tx_close_sync(&tx);
+	m0_be_tx_fini(&tx);
+
+	m0_fi_enable("be_log_level_leave", "no_header_write");
+	m0_be_ut_backend_fini(&ut_be);
+	m0_fi_disable("be_log_level_leave", "no_header_write");
+	m0_fi_disable("m0_be_group_format_seg_place", "skip_seg_io");
+
+	M0_SET0(&ut_be);
+	rc = m0_be_ut_backend_init_cfg(&ut_be, &cfg, false);
+	M0_UT_ASSERT(rc == 0);
+	seg = m0_be_domain_seg(dom, addr);
+	M0_UT_ASSERT(seg != NULL);
+	buf = ptr;
+	for (i = 0; i < BE_UT_TX_LOG_COMPRESS_REG_SIZE; ++i)
+		M0_UT_ASSERT(buf[i] == BE_UT_TX_LOG_COMPRESS_PATTERN);
+	a = m0_be_seg_allocator(seg);
+	M0_BE_UT_TRANSACT(&ut_be, atx, cred,
+		m0_be_allocator_credit(a, M0_BAO_FREE, 0, 0, &cred),
+		M0_BE_OP_SYNC(op, m0_be_free(a, atx, &op, ptr)));
+	m0_be_ut_backend_seg_del(&ut_be, seg);
+	m0_be_ut_backend_fini(&ut_be);
+}
+
 enum {
 	BE_UT_TX_GC_SEG_SIZE         = 0x10000,
 	BE_UT_TX_GC_TX_NR            = 0x100,
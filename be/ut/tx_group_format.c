@@ -91,6 +91,8 @@ static const char *be_ut_tgf_log_sdom_location   = "linuxstob:./log";
 static const char *be_ut_tgf_log_sdom_init_cfg   = "directio=true";
 static const char *be_ut_tgf_log_sdom_create_cfg = "";
 static bool        be_ut_tgf_do_discard;
+/* compress log records, region data is made compressible */
+static bool        be_ut_tgf_compress;
 
 static void be_ut_tgf_log_got_space_cb(struct m0_be_log *log)
 {
@@ -227,7 +229,9 @@ static void be_ut_tgf_buf_init(struct be_ut_tgf_ctx   *ctx,
 		reg->tgfr_seg_addr = addr;
 		addr               = (char *)addr + reg->tgfr_size;
 		ra_size_max       += reg->tgfr_size;
-		be_ut_tgf_rnd_fill(reg->tgfr_buf, reg->tgfr_size);
+		/* the rest of the buffer is zeroed by m0_alloc() */
+		be_ut_tgf_rnd_fill(reg->tgfr_buf, be_ut_tgf_compress ?
+				   reg->tgfr_size / 8 : reg->tgfr_size);
 	}
 	M0_UT_ASSERT((char*)addr - (char*)seg->bs_addr <= seg->bs_size);
 	ctx->tgfc_seg_addr = addr;
@@ -243,6 +247,7 @@ static void be_ut_tgf_buf_init(struct be_ut_tgf_ctx   *ctx,
 		.gfc_log         = &ctx->tgfc_log,
 		.gfc_log_discard = &ctx->tgfc_log_discard,
 		.gfc_pd          = &ctx->tgfc_pd,
+		.gfc_compress    = be_ut_tgf_compress,
 	};
 }
 
@@ -326,6 +331,7 @@ static void be_ut_tgf_group_write(struct be_ut_tgf_ctx   *ctx,
 	m0_mutex_lock(&ctx->tgfc_lock);
 	m0_be_group_format_log_use(gft, reserved_size);
 	m0_mutex_unlock(&ctx->tgfc_lock);
+	M0_UT_ASSERT(gft->gft_compressed == be_ut_tgf_compress);
 	m0_be_group_format_encode(gft);
 	rc = M0_BE_OP_SYNC_RET(op,
 			       m0_be_group_format_log_write(gft, &op),
@@ -583,9 +589,17 @@ static struct be_ut_tgf_group be_ut_tgf_groups[] = {
 
 void m0_be_ut_group_format(void)
 {
+	be_ut_tgf_compress = false;
 	be_ut_tgf_test(ARRAY_SIZE(be_ut_tgf_groups), be_ut_tgf_groups);
 }
 
+void m0_be_ut_group_format_lz(void)
+{
+	be_ut_tgf_compress = true;
+	be_ut_tgf_test(ARRAY_SIZE(be_ut_tgf_groups), be_ut_tgf_groups);
+	be_ut_tgf_compress = false;
+}
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
@@ -28,6 +28,8 @@
 #include "lib/arith.h"          /* m0_rnd64 */
 #include "lib/misc.h"           /* M0_SET0 */
 #include "lib/string.h"         /* memcpy */
+#include "lib/memory.h"         /* m0_alloc */
+#include "lib/ub.h"             /* m0_ub_set */
 
 #include "be/ut/helper.h"	/* m0_be_ut_seg */
 
@@ -1039,6 +1041,107 @@ void m0_be_ut_reg_area_merge(void)
 	m0_be_ut_seg_fini(&ut_seg);
 }
 
+enum {
+	/* number of regions captured in one round */
+	RA_UB_REG_NR   = 100000,
+	RA_UB_REG_SIZE = 8,
+	/* regions are not adjacent, so they are not merged */
+	RA_UB_REG_STEP = RA_UB_REG_SIZE * 2,
+	RA_UB_ITER     = 10,
+};
+
+static struct m0_be_reg_area ra_ub_area;
+static char                 *ra_ub_mem;
+
+static int ra_ub_init(const char *opts M0_UNUSED)
+{
+	int rc;
+
+	ra_ub_mem = m0_alloc(RA_UB_REG_NR * RA_UB_REG_STEP);
+	M0_UB_ASSERT(ra_ub_mem != NULL);
+	rc = m0_be_reg_area_init(&ra_ub_area,
+				 &M0_BE_TX_CREDIT(RA_UB_REG_NR,
+						  RA_UB_REG_NR * RA_UB_REG_SIZE),
+				 M0_BE_REG_AREA_DATA_COPY);
+	M0_UB_ASSERT(rc == 0);
+	return 0;
+}
+
+static void ra_ub_fini(void)
+{
+	m0_be_reg_area_fini(&ra_ub_area);
+	m0_free(ra_ub_mem);
+}
+
+/* Captures RA_UB_REG_NR regions, index2reg() gives the order. */
+static void ra_ub_capture(uint64_t (*index2reg)(uint64_t i))
+{
+	struct m0_be_reg_d rd;
+	uint64_t           i;
+
+	m0_be_reg_area_reset(&ra_ub_area);
+	for (i = 0; i < RA_UB_REG_NR; ++i) {
+		rd = M0_BE_REG_D(M0_BE_REG(NULL, RA_UB_REG_SIZE, ra_ub_mem +
+					   index2reg(i) * RA_UB_REG_STEP),
+				 NULL);
+		m0_be_reg_area_capture(&ra_ub_area, &rd);
+	}
+	M0_UB_ASSERT(m0_be_regmap_size(&ra_ub_area.bra_map) == RA_UB_REG_NR);
+}
+
+static uint64_t ra_ub_seq(uint64_t i)
+{
+	return i;
+}
+
+static uint64_t ra_ub_rev(uint64_t i)
+{
+	return RA_UB_REG_NR - 1 - i;
+}
+
+/* The multiplier is coprime with RA_UB_REG_NR, so it's a permutation. */
+static uint64_t ra_ub_rnd(uint64_t i)
+{
+	return i * 2654435761ULL % RA_UB_REG_NR;
+}
+
+static void ra_ub_capture_seq(int iter)
+{
+	ra_ub_capture(&ra_ub_seq);
+}
+
+static void ra_ub_capture_rev(int iter)
+{
+	ra_ub_capture(&ra_ub_rev);
+}
+
+static void ra_ub_capture_rnd(int iter)
+{
+	ra_ub_capture(&ra_ub_rnd);
+}
+
+/* Each round captures RA_UB_REG_NR regions in one m0_be_reg_area. */
+struct m0_ub_set m0_be_reg_area_ub = {
+	.us_name = "be-reg_area-ub",
+	.us_init = ra_ub_init,
+	.us_fini = ra_ub_fini,
+	.us_run  = {
+		{ .ub_name  = "capture-seq",
+		  .ub_iter  = RA_UB_ITER,
+		  .ub_round = ra_ub_capture_seq },
+
+		{ .ub_name  = "capture-rev",
+		  .ub_iter  = RA_UB_ITER,
+		  .ub_round = ra_ub_capture_rev },
+
+		{ .ub_name  = "capture-rnd",
+		  .ub_iter  = RA_UB_ITER,
+		  .ub_round = ra_ub_capture_rnd },
+
+		{ .ub_name = NULL }
+	}
+};
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
@@ -49,6 +49,7 @@ M0_INTERNAL struct m0_fop_type cas_get_fopt;
 M0_INTERNAL struct m0_fop_type cas_put_fopt;
 M0_INTERNAL struct m0_fop_type cas_del_fopt;
 M0_INTERNAL struct m0_fop_type cas_cur_fopt;
+M0_INTERNAL struct m0_fop_type cas_delr_fopt;
 M0_INTERNAL struct m0_fop_type cas_rep_fopt;
 M0_INTERNAL struct m0_fop_type cas_gc_fopt;
 struct m0_fop_type m0_fop_fsync_cas_fopt;
@@ -91,6 +92,15 @@ static int cas_fops_init(const struct m0_sm_conf           *sm_conf,
 			 .fom_ops   = fom_ops,
 			 .sm        = sm_conf,
 			 .svc_type  = svctype);
+	M0_FOP_TYPE_INIT(&cas_delr_fopt,
+			 .name      = "cas-delr",
+			 .opcode    = M0_CAS_DELR_FOP_OPCODE,
+			 .rpc_flags = M0_RPC_ITEM_TYPE_REQUEST |
+				      M0_RPC_ITEM_TYPE_MUTABO,
+			 .xt        = m0_cas_op_xc,
+			 .fom_ops   = fom_ops,
+			 .sm        = sm_conf,
+			 .svc_type  = svctype);
 	M0_FOP_TYPE_INIT(&cas_rep_fopt,
 			 .name      = "cas-rep",
 			 .opcode    = M0_CAS_REP_FOP_OPCODE,
@@ -119,6 +129,7 @@ static int cas_fops_init(const struct m0_sm_conf           *sm_conf,
 		m0_fop_type_addb2_instrument(&cas_put_fopt) ?:
 		m0_fop_type_addb2_instrument(&cas_del_fopt) ?:
 		m0_fop_type_addb2_instrument(&cas_cur_fopt) ?:
+		m0_fop_type_addb2_instrument(&cas_delr_fopt) ?:
 		m0_fop_type_addb2_instrument(&cas_gc_fopt)?:
 		m0_fop_type_addb2_instrument(&m0_fop_fsync_cas_fopt);
 }
@@ -126,6 +137,7 @@ static int cas_fops_init(const struct m0_sm_conf           *sm_conf,
 static void cas_fops_fini(void)
 {
 	m0_fop_type_addb2_deinstrument(&cas_gc_fopt);
+	m0_fop_type_addb2_deinstrument(&cas_delr_fopt);
 	m0_fop_type_addb2_deinstrument(&cas_cur_fopt);
 	m0_fop_type_addb2_deinstrument(&cas_del_fopt);
 	m0_fop_type_addb2_deinstrument(&cas_put_fopt);
@@ -133,6 +145,7 @@ static void cas_fops_fini(void)
 	m0_fop_type_addb2_deinstrument(&m0_fop_fsync_cas_fopt);
 	m0_fop_type_fini(&cas_gc_fopt);
 	m0_fop_type_fini(&cas_rep_fopt);
+	m0_fop_type_fini(&cas_delr_fopt);
 	m0_fop_type_fini(&cas_cur_fopt);
 	m0_fop_type_fini(&cas_del_fopt);
 	m0_fop_type_fini(&cas_put_fopt);
@@ -68,6 +68,7 @@
  * - @ref cas_put_fopt
  * - @ref cas_del_fopt
  * - @ref cas_cur_fopt
+ * - @ref cas_delr_fopt
  * - @ref cas_rep_fopt
  *
  * @see @ref cas_dfspec "Detailed Functional Specification"
@@ -356,6 +357,7 @@ enum m0_cas_opcode {
 	CO_DROP,
 	CO_MEM_PLACE,
 	CO_MEM_FREE,
+	CO_DELR,
 	CO_NR
 } M0_XCA_ENUM;
 
@@ -382,6 +384,10 @@ struct m0_cas_op {
 	 *
 	 * For CAS-GET, CAS-DEL and CAS-CUR this describes input keys.
 	 * For CAS-PUT this describes input keys and values.
+	 * For CAS-DELR this describes a single key range: the key is its
+	 * inclusive lower bound, the value (optional, empty for no bound) is
+	 * its exclusive upper bound and m0_cas_rec::cr_rc is the maximum number
+	 * of records to delete.
 	 *
 	 * Array should be non-empty.
 	 */
@@ -427,6 +433,10 @@ struct m0_cas_rep {
 	 * For CAS-PUT and, CAS-DEL this describes return codes.
 	 *
 	 * For CAS-CUR this describes next records.
+	 *
+	 * For CAS-DELR this describes the number of deleted records. The
+	 * service may delete less records than requested in order to fit into
+	 * a transaction, so the range is empty once zero is returned.
 	 */
 	struct m0_cas_recv      cgr_rep;
 
@@ -446,6 +456,7 @@ M0_EXTERN struct m0_fop_type cas_get_fopt;
 M0_EXTERN struct m0_fop_type cas_put_fopt;
 M0_EXTERN struct m0_fop_type cas_del_fopt;
 M0_EXTERN struct m0_fop_type cas_cur_fopt;
+M0_EXTERN struct m0_fop_type cas_delr_fopt;
 M0_EXTERN struct m0_fop_type cas_rep_fopt;
 M0_EXTERN struct m0_fop_type cas_gc_fopt;
 extern    struct m0_fop_type m0_fop_fsync_cas_fopt;
@@ -506,12 +506,12 @@ static int cas_rep__validate(const struct m0_fop_type *ftype,
 		}
 	} else {
 		M0_ASSERT(M0_IN(ftype, (&cas_get_fopt, &cas_put_fopt,
-					&cas_del_fopt)));
+					&cas_del_fopt, &cas_delr_fopt)));
 		/*
 		 * CAS service guarantees equal number of records in request and
-		 * response for GET,PUT, DEL operations.  Otherwise, it's not
-		 * possible to match requested records with the ones in reply,
-		 * because keys in reply are absent.
+		 * response for GET, PUT, DEL, DELR operations.  Otherwise, it's
+		 * not possible to match requested records with the ones in
+		 * reply, because keys in reply are absent.
 		 */
 		if (op->cg_rec.cr_nr != rep->cgr_rep.cr_nr)
 			return M0_ERR(-EPROTO);
@@ -1889,6 +1889,56 @@ M0_INTERNAL void m0_cas_del_rep(struct m0_cas_req       *req,
 	M0_LEAVE();
 }
 
+M0_INTERNAL int m0_cas_del_range(struct m0_cas_req   *req,
+				 struct m0_cas_id    *index,
+				 const struct m0_buf *lo,
+				 const struct m0_buf *hi,
+				 struct m0_dtx       *dtx,
+				 uint32_t             flags)
+{
+	struct m0_cas_op      *op;
+	enum m0_cas_req_state  next_state;
+	void                  *lo_addr = lo->b_addr;
+	m0_bcount_t            lo_nob  = lo->b_nob;
+	void                  *hi_addr = NULL;
+	m0_bcount_t            hi_nob  = 0;
+	struct m0_bufvec       lo_vec  = M0_BUFVEC_INIT_BUF(&lo_addr, &lo_nob);
+	struct m0_bufvec       hi_vec  = M0_BUFVEC_INIT_BUF(&hi_addr, &hi_nob);
+	int                    rc;
+
+	M0_ENTRY();
+	M0_PRE(m0_cas_req_is_locked(req));
+	M0_PRE(m0_cas_id_invariant(index));
+	M0_PRE((flags & ~(COF_DEL_LOCK | COF_SYNC_WAIT)) == 0);
+
+	if (hi != NULL) {
+		hi_addr = hi->b_addr;
+		hi_nob  = hi->b_nob;
+	}
+	rc = cas_req_prep(req, index, &lo_vec, hi_nob != 0 ? &hi_vec : NULL,
+			  1, flags, &op);
+	if (rc != 0)
+		return M0_ERR(rc);
+	rc = m0_dtx0_txd_copy(dtx, &op->cg_txd);
+	if (rc != 0)
+		return M0_ERR(rc);
+	rc = creq_fop_create_and_prepare(req, &cas_delr_fopt, op, &next_state);
+	if (rc == 0) {
+		cas_fop_send(req);
+		cas_req_state_set(req, next_state);
+	}
+	return M0_RC(rc);
+}
+
+M0_INTERNAL void m0_cas_del_range_rep(struct m0_cas_req       *req,
+				      struct m0_cas_rec_reply *rep)
+{
+	M0_ENTRY();
+	M0_PRE(req->ccr_ftype == &cas_delr_fopt);
+	cas_rep_copy(req, 0, rep);
+	M0_LEAVE();
+}
+
 M0_INTERNAL int  m0_cas_sm_conf_init(void)
 {
 	m0_sm_conf_init(&cas_req_sm_conf);
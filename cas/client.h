@@ -70,6 +70,7 @@ struct m0_rpc_session;
  * - m0_cas_get()
  * - m0_cas_next()
  * - m0_cas_del()
+ * - m0_cas_del_range()
  *
  * If one of the functions above returns non-zero return code, then further
  * request processing is impossible and the request should be finalised using
@@ -300,6 +301,7 @@ M0_INTERNAL int m0_cas_req_generic_rc(const struct m0_cas_req *req);
  * - m0_cas_put()
  * - m0_cas_get()
  * - m0_cas_del()
+ * - m0_cas_del_range()
  */
 M0_INTERNAL uint64_t m0_cas_req_nr(const struct m0_cas_req *req);
 
@@ -576,6 +578,39 @@ M0_INTERNAL void m0_cas_del_rep(struct m0_cas_req       *req,
 				uint64_t                 idx,
 				struct m0_cas_rec_reply *rep);
 
+/**
+ * Deletes records with keys in [lo, hi) from the index.
+ *
+ * NULL or empty 'hi' stands for no upper bound. Bounds buffers should be
+ * accessible until request is processed.
+ *
+ * CAS service removes a part of the range in one transaction of a fixed size,
+ * detaching whole B-tree subtrees, whose records are freed in the background.
+ * The request should be repeated until m0_cas_del_range_rep() reports zero
+ * deleted records, which means that the range is empty.
+ *
+ * 'Flags' argument is a bitmask of m0_cas_op_flags values. COF_DEL_LOCK and
+ * COF_SYNC_WAIT are the only possible flags.
+ *
+ * @pre m0_cas_req_is_locked(req)
+ * @see m0_cas_del_range_rep()
+ */
+M0_INTERNAL int m0_cas_del_range(struct m0_cas_req   *req,
+				 struct m0_cas_id    *index,
+				 const struct m0_buf *lo,
+				 const struct m0_buf *hi,
+				 struct m0_dtx       *dtx,
+				 uint32_t             flags);
+
+/**
+ * Gets execution result of m0_cas_del_range() request.
+ *
+ * Positive rep->crr_rc is the number of deleted records, 0 means that there
+ * are no records in the range, negative is an error.
+ */
+M0_INTERNAL void m0_cas_del_range_rep(struct m0_cas_req       *req,
+				      struct m0_cas_rec_reply *rep);
+
 M0_INTERNAL int  m0_cas_sm_conf_init(void);
 M0_INTERNAL void m0_cas_sm_conf_fini(void);
 
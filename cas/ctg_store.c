@@ -22,6 +22,8 @@
 
 #define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_CAS
 
+#include <stdlib.h>                  /* qsort */
+
 #include "lib/trace.h"
 #include "lib/memory.h"
 #include "lib/finject.h"
@@ -896,7 +898,7 @@ static void ctg_state_counter_sub(uint64_t *counter, uint64_t val)
 }
 
 static uint64_t ctg_state_update(struct m0_be_tx *tx, uint64_t size,
-				 bool is_inc)
+				 uint64_t nr, bool is_inc)
 {
 	uint64_t         *recs_nr  = &ctg_store.cs_state->cs_rec_nr;
 	uint64_t         *rec_size = &ctg_store.cs_state->cs_rec_size;
@@ -916,15 +918,15 @@ static uint64_t ctg_state_update(struct m0_be_tx *tx, uint64_t size,
 		 * Overflow is unlikely. If it happens, then calculation of DIX
 		 * repair/re-balance progress may be incorrect.
 		 */
-		ctg_state_counter_add(recs_nr, 1);
+		ctg_state_counter_add(recs_nr, nr);
 		/*
 		 * Overflow is possible, because total size is not decremented
 		 * on record deletion.
 		 */
 		ctg_state_counter_add(rec_size, size);
 	} else {
-		M0_ASSERT(*recs_nr != 0);
-		ctg_state_counter_sub(recs_nr, 1);
+		M0_ASSERT(*recs_nr >= nr);
+		ctg_state_counter_sub(recs_nr, nr);
 		ctg_state_counter_sub(rec_size, size);
 	}
 	m0_format_footer_update(ctg_store.cs_state);
@@ -939,12 +941,13 @@ static uint64_t ctg_state_update(struct m0_be_tx *tx, uint64_t size,
 
 M0_INTERNAL void m0_ctg_state_inc_update(struct m0_be_tx *tx, uint64_t size)
 {
-	(void)ctg_state_update(tx, size, true);
+	(void)ctg_state_update(tx, size, 1, true);
 }
 
-static void ctg_state_dec_update(struct m0_be_tx *tx, uint64_t size)
+static void ctg_state_dec_update(struct m0_be_tx *tx, uint64_t size,
+				 uint64_t nr)
 {
-	(void)ctg_state_update(tx, size, false);
+	(void)ctg_state_update(tx, size, nr, false);
 }
 
 /**
@@ -972,6 +975,42 @@ static bool ctg_is_ordinary(const struct m0_cas_ctg *ctg)
 			    m0_ctg_meta()));
 }
 
+/**
+ * Disposes of the catalogue with the records removed by CO_DELR. An empty
+ * catalogue is destroyed at once, otherwise it is put to the dead index, like
+ * a dropped index, for the index garbage collector to free its records.
+ */
+static int ctg_dead_range_put(struct m0_ctg_op *ctg_op, struct m0_be_tx *tx)
+{
+	struct m0_cas_ctg         *dead = ctg_op->co_dead;
+	struct m0_be_btree_anchor  anchor = {};
+	uint64_t                   key_data[(sizeof(struct generic_key) +
+					     sizeof(dead)) / sizeof(uint64_t)];
+	struct generic_key        *key = (struct generic_key *)key_data;
+	int                        rc;
+
+	if (m0_be_btree_is_empty(&dead->cc_tree)) {
+		ctg_destroy(dead, tx);
+		ctg_op->co_dead = NULL;
+		return M0_RC(0);
+	}
+	/* Dead index key is a pointer to a catalogue, see ctg_kbuf_get(). */
+	key->gk_length = sizeof(dead);
+	memcpy(key->gk_data, &dead, sizeof(dead));
+	anchor.ba_value.b_nob = sizeof(struct generic_value);
+	rc = M0_BE_OP_SYNC_RET(op,
+		m0_be_btree_insert_inplace(&m0_ctg_dead_index()->cc_tree, tx,
+					   &op,
+					   &M0_BUF_INIT(sizeof(key_data),
+							key_data),
+					   &anchor, M0_BITS(M0_BAP_NORMAL)),
+		bo_u.u_btree.t_rc);
+	m0_be_btree_release(tx, &anchor);
+	if (rc == 0)
+		ctg_op->co_dead = NULL;
+	return M0_RC(rc);
+}
+
 static bool ctg_op_cb(struct m0_clink *clink)
 {
 	struct m0_ctg_op  *ctg_op   = M0_AMB(ctg_op, clink, co_clink);
@@ -1007,7 +1046,7 @@ static bool ctg_op_cb(struct m0_clink *clink)
 			break;
 		case CTG_OP_COMBINE(CO_DEL, CT_BTREE):
 			if (ctg_is_ordinary(ctg_op->co_ctg))
-				ctg_state_dec_update(tx, 0);
+				ctg_state_dec_update(tx, 0, 1);
 			/* Fall through. */
 		case CTG_OP_COMBINE(CO_DEL, CT_META):
 		case CTG_OP_COMBINE(CO_PUT, CT_DEAD_INDEX):
@@ -1016,6 +1055,14 @@ static bool ctg_op_cb(struct m0_clink *clink)
 		case CTG_OP_COMBINE(CO_GC, CT_META):
 			m0_chan_broadcast_lock(ctg_chan);
 			break;
+		case CTG_OP_COMBINE(CO_DELR, CT_BTREE):
+			rc = ctg_dead_range_put(ctg_op, tx);
+			if (rc != 0 || ctg_op->co_cnt == 0)
+				break;
+			if (ctg_is_ordinary(ctg_op->co_ctg))
+				ctg_state_dec_update(tx, 0, ctg_op->co_cnt);
+			m0_chan_broadcast_lock(ctg_chan);
+			break;
 		case CTG_OP_COMBINE(CO_MIN, CT_BTREE):
 			rc = ctg_kbuf_unpack(&ctg_op->co_out_key);
 			break;
@@ -1194,6 +1241,13 @@ static int ctg_op_exec_normal(struct m0_ctg_op *ctg_op, int next_phase)
 	case CTG_OP_COMBINE(CO_DEL, CT_META):
 		m0_be_btree_delete(btree, tx, beop, key);
 		break;
+	case CTG_OP_COMBINE(CO_DELR, CT_BTREE):
+		m0_be_btree_delete_range(btree, tx, beop, key,
+					 ctg_op->co_key_hi.b_addr == NULL ?
+					 NULL : &ctg_op->co_key_hi,
+					 &ctg_op->co_dead->cc_tree,
+					 &ctg_op->co_cnt);
+		break;
 	case CTG_OP_COMBINE(CO_GC, CT_META):
 		m0_cas_gc_wait_async(beop);
 		break;
@@ -1579,6 +1633,171 @@ M0_INTERNAL void m0_ctg_lookup_result(struct m0_ctg_op *ctg_op,
 	*buf = ctg_op->co_out_val;
 }
 
+M0_INTERNAL bool m0_ctg_batch_is_possible(const struct m0_cas_ctg *ctg,
+					  int                      opcode,
+					  uint32_t                 flags)
+{
+	return ctg_is_ordinary(ctg) && (flags & COF_VERSIONED) == 0 &&
+		(opcode == CO_GET ||
+		 (opcode == CO_PUT &&
+		  (flags & (COF_OVERWRITE | COF_RESERVE)) == 0));
+}
+
+M0_INTERNAL int m0_ctg_batch_init(struct m0_ctg_batch *batch,
+				  struct m0_cas_ctg   *ctg,
+				  int                  opcode,
+				  uint32_t             nr)
+{
+	M0_ENTRY("ctg=%p opcode=%d nr=%u", ctg, opcode, nr);
+	M0_PRE(M0_IN(opcode, (CO_GET, CO_PUT)));
+	M0_PRE(nr > 0);
+
+	M0_SET0(batch);
+	M0_ALLOC_ARR(batch->cb_rec, nr);
+	M0_ALLOC_ARR(batch->cb_sorted, nr);
+	M0_ALLOC_ARR(batch->cb_keys, nr);
+	M0_ALLOC_ARR(batch->cb_vals, nr);
+	M0_ALLOC_ARR(batch->cb_rcs, nr);
+	if (batch->cb_rec == NULL || batch->cb_sorted == NULL ||
+	    batch->cb_keys == NULL || batch->cb_vals == NULL ||
+	    batch->cb_rcs == NULL) {
+		m0_ctg_batch_fini(batch);
+		return M0_ERR(-ENOMEM);
+	}
+	batch->cb_opcode = opcode;
+	batch->cb_ctg    = ctg;
+	batch->cb_nr     = nr;
+	return M0_RC(0);
+}
+
+M0_INTERNAL void m0_ctg_batch_add(struct m0_ctg_batch *batch,
+				  uint32_t             idx,
+				  const struct m0_buf *key,
+				  const struct m0_buf *val)
+{
+	struct m0_ctg_batch_rec *rec = &batch->cb_rec[idx];
+
+	M0_PRE(idx < batch->cb_nr);
+
+	rec->cbr_rc = ctg_kbuf_get(&rec->cbr_key, key, true);
+	if (rec->cbr_rc == 0 && batch->cb_opcode == CO_PUT) {
+		rec->cbr_rc = m0_buf_alloc(&rec->cbr_val,
+					   ctg_vbuf_packed_size(val));
+		if (rec->cbr_rc == 0)
+			ctg_vbuf_pack(&rec->cbr_val, val, &M0_CRV_INIT_NONE);
+	}
+}
+
+static int ctg_batch_rec_cmp(const void *a, const void *b)
+{
+	const struct m0_ctg_batch_rec *left  =
+		*(const struct m0_ctg_batch_rec **)a;
+	const struct m0_ctg_batch_rec *right =
+		*(const struct m0_ctg_batch_rec **)b;
+
+	/* Records are in request order in m0_ctg_batch::cb_rec[]. */
+	return ctg_cmp(left->cbr_key.b_addr, right->cbr_key.b_addr) ?:
+		M0_3WAY(left, right);
+}
+
+M0_INTERNAL void m0_ctg_batch_exec(struct m0_ctg_batch *batch,
+				   struct m0_fom       *fom)
+{
+	struct m0_be_tx         *tx    = &fom->fo_tx.tx_betx;
+	struct m0_be_btree      *btree = &batch->cb_ctg->cc_tree;
+	struct m0_ctg_batch_rec *rec;
+	uint32_t                 nr    = 0;
+	uint32_t                 i;
+
+	M0_ENTRY("batch=%p nr=%u", batch, batch->cb_nr);
+	M0_PRE(batch->cb_nr > 0);
+
+	/* Records failed in m0_ctg_batch_add() are not passed to the btree. */
+	for (i = 0; i < batch->cb_nr; i++) {
+		if (batch->cb_rec[i].cbr_rc == 0)
+			batch->cb_sorted[nr++] = &batch->cb_rec[i];
+	}
+	qsort(batch->cb_sorted, nr, sizeof batch->cb_sorted[0],
+	      &ctg_batch_rec_cmp);
+	for (i = 0; i < nr; i++) {
+		batch->cb_keys[i] = batch->cb_sorted[i]->cbr_key;
+		/* CO_GET values are M0_BUF_INIT0: look them up in place. */
+		batch->cb_vals[i] = batch->cb_sorted[i]->cbr_val;
+	}
+
+	if (batch->cb_opcode == CO_GET)
+		M0_BE_OP_SYNC(op, m0_be_btree_lookup_batch(btree, &op, nr,
+							   batch->cb_keys,
+							   batch->cb_vals,
+							   batch->cb_rcs));
+	else
+		M0_BE_OP_SYNC(op, m0_be_btree_insert_batch(btree, tx, &op, nr,
+							   batch->cb_keys,
+							   batch->cb_vals,
+							   batch->cb_rcs));
+
+	for (i = 0; i < nr; i++) {
+		rec = batch->cb_sorted[i];
+		rec->cbr_rc = batch->cb_rcs[i];
+		if (rec->cbr_rc != 0)
+			continue;
+		if (batch->cb_opcode == CO_GET) {
+			rec->cbr_val = batch->cb_vals[i];
+			rec->cbr_rc = ctg_vbuf_unpack(&rec->cbr_val, NULL);
+		} else
+			m0_ctg_state_inc_update(tx,
+				rec->cbr_key.b_nob - sizeof(struct generic_key) +
+				rec->cbr_val.b_nob -
+				sizeof(struct generic_value));
+	}
+	M0_LEAVE();
+}
+
+M0_INTERNAL int m0_ctg_batch_result(struct m0_ctg_op    *ctg_op,
+				    struct m0_ctg_batch *batch,
+				    uint32_t             idx,
+				    int                  next_phase)
+{
+	struct m0_ctg_batch_rec *rec = &batch->cb_rec[idx];
+
+	M0_PRE(ctg_op != NULL);
+	M0_PRE(ctg_op->co_beop.bo_sm.sm_state == M0_BOS_INIT);
+	M0_PRE(idx < batch->cb_nr);
+
+	ctg_op->co_ctg    = batch->cb_ctg;
+	ctg_op->co_ct     = CT_BTREE;
+	ctg_op->co_opcode = batch->cb_opcode;
+	ctg_op->co_rc     = rec->cbr_rc;
+	if (ctg_op->co_opcode == CO_GET && ctg_op->co_rc == 0)
+		ctg_op->co_out_val = rec->cbr_val;
+	if (ctg_op->co_opcode == CO_PUT &&
+	    ctg_op->co_flags & COF_CREATE &&
+	    ctg_op->co_rc == -EEXIST)
+		ctg_op->co_rc = 0;
+	/* See the comment in ctg_op_exec_versioned(). */
+	m0_be_op_active(&ctg_op->co_beop);
+	m0_be_op_done(&ctg_op->co_beop);
+	m0_fom_phase_set(ctg_op->co_fom, next_phase);
+	return M0_FSO_AGAIN;
+}
+
+M0_INTERNAL void m0_ctg_batch_fini(struct m0_ctg_batch *batch)
+{
+	uint32_t i;
+
+	for (i = 0; i < batch->cb_nr; i++) {
+		m0_buf_free(&batch->cb_rec[i].cbr_key);
+		if (batch->cb_opcode == CO_PUT)
+			m0_buf_free(&batch->cb_rec[i].cbr_val);
+	}
+	m0_free(batch->cb_rec);
+	m0_free(batch->cb_sorted);
+	m0_free(batch->cb_keys);
+	m0_free(batch->cb_vals);
+	m0_free(batch->cb_rcs);
+	M0_SET0(batch);
+}
+
 M0_INTERNAL void m0_ctg_op_get_ver(struct m0_ctg_op *ctg_op,
 				   struct m0_crv    *out)
 {
@@ -1617,6 +1836,49 @@ M0_INTERNAL int m0_ctg_truncate(struct m0_ctg_op    *ctg_op,
 	return ctg_exec(ctg_op, ctg, NULL, next_phase);
 }
 
+M0_INTERNAL int m0_ctg_delete_range(struct m0_ctg_op    *ctg_op,
+				    struct m0_cas_ctg   *ctg,
+				    const struct m0_buf *lo,
+				    const struct m0_buf *hi,
+				    int                  next_phase)
+{
+	struct m0_be_tx *tx = &ctg_op->co_fom->fo_tx.tx_betx;
+
+	M0_PRE(ctg_op != NULL);
+	M0_PRE(ctg != NULL);
+	M0_PRE(lo != NULL);
+	M0_PRE(hi != NULL);
+	M0_PRE(ctg_op->co_beop.bo_sm.sm_state == M0_BOS_INIT);
+
+	ctg_op->co_opcode = CO_DELR;
+	ctg_op->co_cnt = 0;
+	if (hi->b_nob != 0)
+		ctg_op->co_rc = ctg_kbuf_get(&ctg_op->co_key_hi, hi, true);
+	/*
+	 * The catalogue for the removed records. It is disposed of on
+	 * completion, see ctg_dead_range_put() and m0_ctg_op_fini().
+	 */
+	if (ctg_op->co_rc == 0)
+		ctg_op->co_rc = m0_ctg_create(cas_seg(tx->t_engine->eng_domain),
+					      tx, &ctg_op->co_dead,
+					      &ctg->cc_tree.bb_backlink.bli_fid);
+	if (ctg_op->co_rc != 0) {
+		m0_fom_phase_set(ctg_op->co_fom, next_phase);
+		return M0_FSO_AGAIN;
+	}
+
+	return ctg_exec(ctg_op, ctg, lo, next_phase);
+}
+
+M0_INTERNAL m0_bcount_t m0_ctg_delete_range_nr(struct m0_ctg_op *ctg_op)
+{
+	M0_PRE(ctg_op != NULL);
+	M0_PRE(ctg_op->co_opcode == CO_DELR);
+	M0_PRE(ctg_op->co_rc == 0);
+
+	return ctg_op->co_cnt;
+}
+
 M0_INTERNAL int m0_ctg_drop(struct m0_ctg_op    *ctg_op,
 			    struct m0_cas_ctg   *ctg,
 			    int                  next_phase)
@@ -1793,7 +2055,11 @@ M0_INTERNAL void m0_ctg_op_fini(struct m0_ctg_op *ctg_op)
 
 	m0_be_btree_release(&ctg_op->co_fom->fo_tx.tx_betx,
 			    &ctg_op->co_anchor);
+	/* CO_DELR failed or was not executed, nothing was removed. */
+	if (ctg_op->co_dead != NULL)
+		ctg_destroy(ctg_op->co_dead, &ctg_op->co_fom->fo_tx.tx_betx);
 	m0_buf_free(&ctg_op->co_key);
+	m0_buf_free(&ctg_op->co_key_hi);
 	m0_chan_fini_lock(&ctg_op->co_channel);
 	m0_mutex_fini(&ctg_op->co_channel_lock);
 	m0_clink_fini(&ctg_op->co_clink);
@@ -1884,6 +2150,29 @@ M0_INTERNAL void m0_ctg_drop_credit(struct m0_fom          *fom,
 	*limit = records_ok;
 }
 
+M0_INTERNAL void m0_ctg_delete_range_credit(struct m0_cas_ctg      *ctg,
+					    struct m0_be_tx_credit *accum)
+{
+	struct m0_be_btree *btree  = &ctg->cc_tree;
+	struct m0_be_btree *dbtree = &m0_ctg_dead_index()->cc_tree;
+	struct m0_be_seg   *seg    = cas_seg(btree->bb_seg->bs_domain);
+	struct m0_cas_ctg  *dead;
+
+	/*
+	 * Range deletion is not versioned, see ctg_op_is_versioned(). Deletion
+	 * credit does not depend on key and value sizes.
+	 */
+	m0_be_btree_delete_range_credit(btree, 0, 0, accum);
+	/* The catalogue for the removed records. */
+	m0_be_btree_create_credit(btree, 1, accum);
+	M0_BE_ALLOC_CREDIT_PTR(dead, seg, accum);
+	M0_BE_FREE_CREDIT_PTR(dead, seg, accum);
+	/* Its dead index record, see m0_ctg_mark_deleted_credit(). */
+	m0_be_btree_insert_credit2(dbtree, 1,
+				   sizeof(struct generic_key) + sizeof(dead),
+				   sizeof(struct generic_value), accum);
+}
+
 M0_INTERNAL void m0_ctg_dead_clean_credit(struct m0_be_tx_credit *accum)
 {
 	struct m0_cas_ctg  *ctg;
@@ -210,6 +210,10 @@ struct m0_ctg_op {
 	struct m0_buf             co_key;
 	/** Value buffer. */
 	struct m0_buf             co_val;
+	/** Upper bound key buffer of CO_DELR, see m0_ctg_delete_range(). */
+	struct m0_buf             co_key_hi;
+	/** Catalogue receiving the records removed by CO_DELR. */
+	struct m0_cas_ctg        *co_dead;
 	/** Key out buffer. */
 	struct m0_buf             co_out_key;
 	/** Value out buffer. */
@@ -227,7 +231,8 @@ struct m0_ctg_op {
 	int                       co_rc;
 	/**
 	 * Maximum number of records (limit) allowed to be deleted in CO_TRUNC
-	 * operation, see m0_ctg_truncate().
+	 * operation, see m0_ctg_truncate(). Number of records actually deleted
+	 * on completion of CO_DELR.
 	 */
 	m0_bcount_t               co_cnt;
 	/**
@@ -238,6 +243,45 @@ struct m0_ctg_op {
 	bool                      co_is_versioned;
 };
 
+/** Record of a batched catalogue operation, see m0_ctg_batch. */
+struct m0_ctg_batch_rec {
+	/** Key in on-disk format. */
+	struct m0_buf cbr_key;
+	/**
+	 * CO_PUT: value in on-disk format, owned by the batch.
+	 * CO_GET: value found, pointing to the record in the tree.
+	 */
+	struct m0_buf cbr_val;
+	/** Result of the operation on the record. */
+	int           cbr_rc;
+};
+
+/**
+ * Multi-record CO_GET or CO_PUT in an ordinary catalogue executed by a
+ * single m0_be_btree_lookup_batch() or m0_be_btree_insert_batch() call.
+ *
+ * Records are added in request order and passed to the btree sorted by key.
+ * Records with equal keys keep request order, so duplicate keys in CO_PUT get
+ * the same results as with per-record m0_ctg_insert() calls. Results are
+ * returned per record by m0_ctg_batch_result().
+ */
+struct m0_ctg_batch {
+	/** Operation code, CO_GET or CO_PUT. */
+	int                       cb_opcode;
+	/** Catalogue the records belong to. */
+	struct m0_cas_ctg        *cb_ctg;
+	/** Number of records, 0 if the batch is not initialised. */
+	uint32_t                  cb_nr;
+	/** Records in request order. */
+	struct m0_ctg_batch_rec  *cb_rec;
+	/** Records passed to the btree, sorted by key. */
+	struct m0_ctg_batch_rec **cb_sorted;
+	/** Keys, values and results of ->cb_sorted[] for the btree call. */
+	struct m0_buf            *cb_keys;
+	struct m0_buf            *cb_vals;
+	int                      *cb_rcs;
+};
+
 #define CTG_OP_COMBINE(opc, ct) (((uint64_t)(opc)) | ((ct) << 16))
 
 /**
@@ -469,6 +513,64 @@ M0_INTERNAL int m0_ctg_lookup(struct m0_ctg_op    *ctg_op,
 M0_INTERNAL void m0_ctg_lookup_result(struct m0_ctg_op *ctg_op,
 				      struct m0_buf    *buf);
 
+/**
+ * Checks whether a multi-record operation with the given opcode and flags can
+ * be executed as m0_ctg_batch in @ctg.
+ *
+ * Versioned operations, CO_PUT with COF_OVERWRITE or COF_RESERVE and
+ * operations in non-ordinary catalogues are executed per record.
+ */
+M0_INTERNAL bool m0_ctg_batch_is_possible(const struct m0_cas_ctg *ctg,
+					  int                      opcode,
+					  uint32_t                 flags);
+
+/**
+ * Initialises a batch of @nr records of @opcode in @ctg.
+ *
+ * @ret 0 or -ENOMEM.
+ */
+M0_INTERNAL int m0_ctg_batch_init(struct m0_ctg_batch *batch,
+				  struct m0_cas_ctg   *ctg,
+				  int                  opcode,
+				  uint32_t             nr);
+
+/**
+ * Sets @key and, for CO_PUT, @val of the record @idx. Both are copied.
+ *
+ * Allocation failures are the result of the record, other records of the
+ * batch are not affected.
+ */
+M0_INTERNAL void m0_ctg_batch_add(struct m0_ctg_batch *batch,
+				  uint32_t             idx,
+				  const struct m0_buf *key,
+				  const struct m0_buf *val);
+
+/**
+ * Executes all records of the batch in the transaction of @fom.
+ *
+ * For CO_PUT, credits have to be calculated by m0_ctg_insert_credit() for
+ * every record. For CO_GET, the values stay in the tree, so the caller has to
+ * hold the catalogue lock (m0_ctg_lock()) until it is done with the results.
+ */
+M0_INTERNAL void m0_ctg_batch_exec(struct m0_ctg_batch *batch,
+				   struct m0_fom       *fom);
+
+/**
+ * Completes @ctg_op with the result of the record @idx of an executed batch,
+ * as if the record were executed by m0_ctg_lookup() or m0_ctg_insert().
+ * m0_ctg_op_rc() and m0_ctg_lookup_result() can be used with @ctg_op after
+ * that.
+ *
+ * @ret M0_FSO_AGAIN.
+ */
+M0_INTERNAL int m0_ctg_batch_result(struct m0_ctg_op    *ctg_op,
+				    struct m0_ctg_batch *batch,
+				    uint32_t             idx,
+				    int                  next_phase);
+
+/** Finalises the batch. Can be called for a zeroed batch. */
+M0_INTERNAL void m0_ctg_batch_fini(struct m0_ctg_batch *batch);
+
 /**
  * Returns the version of the record the operation ctg_op worked on.
  */
@@ -504,6 +606,34 @@ M0_INTERNAL int m0_ctg_truncate(struct m0_ctg_op  *ctg_op,
 				m0_bcount_t        limit,
 				int                next_phase);
 
+/**
+ * Deletes records with keys in [lo, hi) from catalogue.
+ *
+ * Empty 'hi' stands for no upper bound. Whole subtrees of the catalogue B-tree
+ * are moved to a new catalogue, which is put to the dead index, so that index
+ * garbage collector frees the records in the background, see
+ * m0_be_btree_delete_range(). Transaction credits do not depend on the number
+ * of records, see m0_ctg_delete_range_credit().
+ *
+ * The number of deleted records is returned by m0_ctg_delete_range_nr(). It is
+ * zero iff there are no records in the range, the routine should be called
+ * with the same bounds in new transactions until it returns zero. Catalogue
+ * stays usable between the calls.
+ *
+ * @note Keys are copied before execution of operation, user does not need to
+ *       keep them since this function is called.
+ *
+ * @ret M0_FSO_AGAIN or M0_FSO_WAIT.
+ */
+M0_INTERNAL int m0_ctg_delete_range(struct m0_ctg_op    *ctg_op,
+				    struct m0_cas_ctg   *ctg,
+				    const struct m0_buf *lo,
+				    const struct m0_buf *hi,
+				    int                  next_phase);
+
+/** Returns the number of records deleted by m0_ctg_delete_range(). */
+M0_INTERNAL m0_bcount_t m0_ctg_delete_range_nr(struct m0_ctg_op *ctg_op);
+
 /**
  * Destroys B-tree associated with a catalogue. B-tree should be empty.
  */
@@ -662,6 +792,12 @@ M0_INTERNAL void m0_ctg_drop_credit(struct m0_fom          *fom,
 				    struct m0_cas_ctg      *ctg,
 				    m0_bcount_t            *limit);
 
+/**
+ * Calculates credits for a single m0_ctg_delete_range() call.
+ */
+M0_INTERNAL void m0_ctg_delete_range_credit(struct m0_cas_ctg      *ctg,
+					    struct m0_be_tx_credit *accum);
+
 M0_INTERNAL void m0_ctg_try_init(struct m0_cas_ctg *ctg);
 
 /**
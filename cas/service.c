@@ -356,6 +356,11 @@ struct cas_fom {
 	struct cas_kv            *cf_ikv;
 	/** ->cf_ikv array size. */
 	uint64_t                  cf_ikv_nr;
+	/**
+	 * Records of a multi-record GET or PUT executed at once, see
+	 * cas_batch_exec(). Zeroed if records are executed one by one.
+	 */
+	struct m0_ctg_batch       cf_batch;
 	/**
 	 * Catalogue identifiers decoded from incoming ->cr_rec[].cr_key buffers
 	 * in case of meta request. They are decoded once during request
@@ -432,6 +437,7 @@ M0_BASSERT(M0_CAS_PUT_FOP_OPCODE == CO_PUT + M0_CAS_GET_FOP_OPCODE);
 M0_BASSERT(M0_CAS_DEL_FOP_OPCODE == CO_DEL + M0_CAS_GET_FOP_OPCODE);
 M0_BASSERT(M0_CAS_CUR_FOP_OPCODE == CO_CUR + M0_CAS_GET_FOP_OPCODE);
 M0_BASSERT(M0_CAS_REP_FOP_OPCODE == CO_REP + M0_CAS_GET_FOP_OPCODE);
+M0_BASSERT(M0_CAS_DELR_FOP_OPCODE == CO_DELR + M0_CAS_GET_FOP_OPCODE);
 
 #define LAYOUT_IMASK_PTR(l) (&(l)->u.dl_desc.ld_imask)
 #define CID_IMASK_PTR(cid)  LAYOUT_IMASK_PTR(&(cid)->ci_layout)
@@ -503,6 +509,8 @@ static int  cas_incoming_kv_setup(struct cas_fom         *fom,
 
 static int cas_kv_load_done(struct cas_fom *fom, enum m0_cas_opcode  opc,
 			    const struct m0_cas_op *op, int phase);
+static void cas_batch_exec(struct cas_fom *fom, enum m0_cas_opcode opc,
+			   enum m0_cas_type ct, struct m0_cas_ctg *ctg);
 
 static int cas_ctg_crow_handle(struct cas_fom *fom,
 			       const struct m0_cas_id *cid);
@@ -883,6 +891,7 @@ static struct m0_rpc_at_buf *cas_out_complementary(enum m0_cas_opcode      opc,
 	case CO_PUT:
 	case CO_DEL:
 	case CO_GC:
+	case CO_DELR:
 		ret = NULL;
 		break;
 	case CO_GET:
@@ -1280,7 +1289,7 @@ static int cas_fom_tick(struct m0_fom *fom0)
 		}
 		if (phase == M0_FOPH_TXN_COMMIT) {
 			/* Piggyback some information about the transaction */
-			if (M0_IN(opc, (CO_PUT, CO_DEL)))
+			if (M0_IN(opc, (CO_PUT, CO_DEL, CO_DELR)))
 				m0_fom_mod_rep_fill(&rep->cgr_mod_rep, fom0);
 		}
 		if (phase == M0_FOPH_FAILURE) {
@@ -1437,7 +1446,8 @@ static int cas_fom_tick(struct m0_fom *fom0)
 			else {
 				addb2_add_kv_attrs(fom, STATS_KV_IN);
 				result = cas_kv_load_done(fom, opc, op,
-							  is_index_drop ?
+							  is_index_drop ||
+							  opc == CO_DELR ?
 							  CAS_DEAD_INDEX_LOCK :
 							  CAS_LOCK);
 			}
@@ -1545,6 +1555,8 @@ static int cas_fom_tick(struct m0_fom *fom0)
 			}
 			addb2_add_kv_attrs(fom, STATS_KV_OUT);
 		} else {
+			if (ipos == 0)
+				cas_batch_exec(fom, opc, ct, ctg);
 			do_ctidx = cas_ctidx_op_needed(fom, opc, ct, ipos);
 			result = cas_exec(fom, opc, ct, ctg, ipos,
 					  is_index_drop ?
@@ -1811,6 +1823,7 @@ static void cas_fom_fini(struct m0_fom *fom0)
 	m0_free(fom->cf_in_cids);
 	m0_free(fom->cf_moved_ctgs);
 	m0_free(fom->cf_ikv);
+	m0_ctg_batch_fini(&fom->cf_batch);
 	m0_long_lock_link_fini(&fom->cf_meta);
 	m0_long_lock_link_fini(&fom->cf_lock);
 	m0_long_lock_link_fini(&fom->cf_ctidx);
@@ -2015,6 +2028,10 @@ static bool cas_is_valid(struct cas_fom *fom, enum m0_cas_opcode opc,
 	case CO_REP:
 		result = !gotval == (((int64_t)rec->cr_rc) < 0 || meta);
 		break;
+	case CO_DELR:
+		/* Value is an optional upper bound. */
+		result = gotkey && !meta;
+		break;
 	case CO_GC:
 	case CO_MIN:
 	case CO_TRUNC:
@@ -2192,6 +2209,9 @@ static void cas_prep(struct cas_fom *fom, enum m0_cas_opcode opc,
 		} else
 			m0_ctg_delete_credit(ctg, knob, vnob, accum);
 		break;
+	case CTG_OP_COMBINE(CO_DELR, CT_BTREE):
+		m0_ctg_delete_range_credit(ctg, accum);
+		break;
 	}
 }
 
@@ -2211,7 +2231,7 @@ static int cas_kv_load_done(struct cas_fom *fom, enum m0_cas_opcode  opc,
 			    const struct m0_cas_op *op, int phase)
 
 {
-	if (opc == CO_DEL && (op->cg_flags & COF_DEL_LOCK)) {
+	if (M0_IN(opc, (CO_DEL, CO_DELR)) && (op->cg_flags & COF_DEL_LOCK)) {
 		/*
 		 * Repair or re-balance may be running, take the lock
 		 * to protect current component record/catalogue that is under
@@ -2227,6 +2247,36 @@ static int cas_kv_load_done(struct cas_fom *fom, enum m0_cas_opcode  opc,
 	return M0_RC(M0_FSO_AGAIN);
 }
 
+/**
+ * Executes all records of a multi-record GET or PUT in an ordinary catalogue
+ * with a single btree operation. The results are then picked up record by
+ * record in cas_exec(), so the rest of the state machine does not change.
+ *
+ * Credits are still calculated per record in cas_prep(), which is what
+ * m0_be_btree_insert_batch() needs. If the batch cannot be used, cas_exec()
+ * executes the records one by one.
+ */
+static void cas_batch_exec(struct cas_fom *fom, enum m0_cas_opcode opc,
+			   enum m0_cas_type ct, struct m0_cas_ctg *ctg)
+{
+	struct m0_fom       *fom0  = &fom->cf_fom;
+	struct m0_ctg_batch *batch = &fom->cf_batch;
+	struct m0_cas_op    *op    = cas_op(fom0);
+	struct m0_buf        kbuf;
+	struct m0_buf        vbuf;
+	uint64_t             i;
+
+	if (ct != CT_BTREE || op->cg_rec.cr_nr < 2 || batch->cb_nr != 0 ||
+	    !m0_ctg_batch_is_possible(ctg, opc, op->cg_flags) ||
+	    m0_ctg_batch_init(batch, ctg, opc, op->cg_rec.cr_nr) != 0)
+		return;
+	for (i = 0; i < op->cg_rec.cr_nr; i++) {
+		cas_incoming_kv(fom, i, &kbuf, &vbuf);
+		m0_ctg_batch_add(batch, i, &kbuf, &vbuf);
+	}
+	m0_ctg_batch_exec(batch, fom0);
+}
+
 static int cas_exec(struct cas_fom *fom, enum m0_cas_opcode opc,
 		    enum m0_cas_type ct, struct m0_cas_ctg *ctg,
 		    uint64_t rec_pos, int next)
@@ -2258,10 +2308,16 @@ static int cas_exec(struct cas_fom *fom, enum m0_cas_opcode opc,
 
 	switch (CTG_OP_COMBINE(opc, ct)) {
 	case CTG_OP_COMBINE(CO_GET, CT_BTREE):
-		ret = m0_ctg_lookup(ctg_op, ctg, &kbuf, next);
+		ret = fom->cf_batch.cb_nr != 0 ?
+			m0_ctg_batch_result(ctg_op, &fom->cf_batch, rec_pos,
+					    next) :
+			m0_ctg_lookup(ctg_op, ctg, &kbuf, next);
 		break;
 	case CTG_OP_COMBINE(CO_PUT, CT_BTREE):
-		ret = m0_ctg_insert(ctg_op, ctg, &kbuf, &vbuf, next);
+		ret = fom->cf_batch.cb_nr != 0 ?
+			m0_ctg_batch_result(ctg_op, &fom->cf_batch, rec_pos,
+					    next) :
+			m0_ctg_insert(ctg_op, ctg, &kbuf, &vbuf, next);
 		break;
 	case CTG_OP_COMBINE(CO_DEL, CT_BTREE):
 		ret = m0_ctg_lookup_delete(ctg_op, ctg, &kbuf, &lbuf, flags, next);
@@ -2277,6 +2333,9 @@ static int cas_exec(struct cas_fom *fom, enum m0_cas_opcode opc,
 			rec->cr_val.u.ab_buf = lbuf;
 		}
 		break;
+	case CTG_OP_COMBINE(CO_DELR, CT_BTREE):
+		ret = m0_ctg_delete_range(ctg_op, ctg, &kbuf, &vbuf, next);
+		break;
 	case CTG_OP_COMBINE(CO_DEL, CT_META):
 		/*
 		 * This is index drop. Move record from meta to dead_index.
@@ -2484,6 +2543,7 @@ static int cas_prep_send(struct cas_fom *fom, enum m0_cas_opcode opc,
 	case CTG_OP_COMBINE(CO_GET, CT_META):
 	case CTG_OP_COMBINE(CO_DEL, CT_META):
 	case CTG_OP_COMBINE(CO_DEL, CT_BTREE):
+	case CTG_OP_COMBINE(CO_DELR, CT_BTREE):
 	case CTG_OP_COMBINE(CO_PUT, CT_BTREE):
 	case CTG_OP_COMBINE(CO_PUT, CT_META):
 		/* Nothing to do: return code is all the user gets. */
@@ -2534,8 +2594,19 @@ static int cas_done(struct cas_fom *fom, struct m0_cas_op *op,
 			fom->cf_curpos = 0;
 			fom->cf_startkey_excluded = false;
 		}
-	} else
+	} else {
+		/*
+		 * CAS-DELR returns the number of deleted records, they are
+		 * freed by the index garbage collector.
+		 */
+		if (opc == CO_DELR && rc == 0 && ctg_rc == 0) {
+			rc = min64u(m0_ctg_delete_range_nr(&fom->cf_ctg_op),
+				    INT32_MAX);
+			if (rc > 0)
+				m0_cas_gc_start(fom->cf_fom.fo_service);
+		}
 		m0_ctg_op_fini(&fom->cf_ctg_op);
+	}
 
 	++fom->cf_ipos;
 	++fom->cf_opos;
@@ -38,6 +38,7 @@
 #include "reqh/reqh.h"
 #include "reqh/reqh_service.h"
 #include "be/ut/helper.h"                 /* m0_be_ut_backend */
+#include "be/btree.h"                     /* BTREE_HEIGHT_MAX */
 
 #include "cas/cas.h"
 #include "cas/cas_xc.h"
@@ -1228,6 +1229,61 @@ static void cur_N(void)
 	fini();
 }
 
+/**
+ * Repeats DELR request until the range is reported empty, returns the total
+ * number of deleted records.
+ */
+static uint64_t delete_range_all(uint64_t lo, uint64_t hi)
+{
+	uint64_t total = 0;
+	int      calls = 0;
+
+	do {
+		index_op(&cas_delr_fopt, &ifid, lo, hi);
+		M0_UT_ASSERT(rep.cgr_rc == 0);
+		M0_UT_ASSERT(rep.cgr_rep.cr_nr == 1);
+		M0_UT_ASSERT((int64_t)rep.cgr_rep.cr_rec[0].cr_rc >= 0);
+		total += rep.cgr_rep.cr_rec[0].cr_rc;
+		++calls;
+	} while (rep.cgr_rep.cr_rec[0].cr_rc != 0);
+	/* Subtrees are cut out, so the number of calls is small. */
+	M0_UT_ASSERT(calls <= 4 * BTREE_HEIGHT_MAX);
+	return total;
+}
+
+/**
+ * Test deletion of key ranges.
+ */
+static void delete_range(void)
+{
+	int i;
+
+	init();
+	meta_fid_submit(&cas_put_fopt, &ifid);
+	insert_odd(&ifid);
+	M0_UT_ASSERT(delete_range_all(CB(10), CB(20)) == 5);
+	/* Empty range is reported as 0 deleted records. */
+	index_op(&cas_delr_fopt, &ifid, CB(10), CB(20));
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	/* Range spanning many leaves. */
+	M0_UT_ASSERT(delete_range_all(CB(100), CB(1100)) == 500);
+	for (i = 1; i < INSERTS; ++i) {
+		index_op(&cas_get_fopt, &ifid, CB(i), NOVAL);
+		M0_UT_ASSERT(rep_check(0, (i & 1) && !(10 <= i && i < 20) &&
+				       !(100 <= i && i < 1100) ? 0 : -ENOENT,
+				       BUNSET, BANY));
+	}
+	/* The index is usable between the requests. */
+	index_op(&cas_put_fopt, &ifid, CB(11), 11 * 11);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	/* No upper bound. */
+	M0_UT_ASSERT(delete_range_all(CB(1), NOVAL) ==
+		     INSERTS / 2 - 5 - 500 + 1);
+	index_op(&cas_get_fopt, &ifid, CB(11), NOVAL);
+	M0_UT_ASSERT(rep_check(0, -ENOENT, BUNSET, BANY));
+	fini();
+}
+
 static struct m0_thread t[8];
 
 static void meta_mt_thread(int idx)
@@ -1579,6 +1635,40 @@ static void multi_lookup(void)
 	fini();
 }
 
+/**
+ * Multi-record PUT and GET with keys out of order and a repeated key: batched
+ * execution has to give the same results as executing records one by one.
+ */
+static void multi_unsorted(void)
+{
+	struct record recs[MULTI_INS];
+	const int     dup = MULTI_INS - 2;
+
+	init();
+	m0_forall(i, MULTI_INS, (recs[i].key = CB(MULTI_INS - i),
+				 recs[i].value = i, true));
+	recs[dup].key = recs[1].key;
+	meta_fid_submit(&cas_put_fopt, &ifid);
+	M0_UT_ASSERT(rep_check(0, 0, BUNSET, BUNSET));
+	M0_UT_ASSERT(rep.cgr_rc == 0);
+	/* The first record with the repeated key wins. */
+	multi_values_insert(recs, MULTI_INS);
+	M0_UT_ASSERT(rep.cgr_rc == 0);
+	M0_UT_ASSERT(rep.cgr_rep.cr_nr == MULTI_INS - 1);
+	M0_UT_ASSERT(m0_forall(i, MULTI_INS - 1,
+			       rep.cgr_rep.cr_rec[i].cr_rc ==
+			       (i == dup ? -EEXIST : 0)));
+	multi_values_lookup(recs, MULTI_INS);
+	M0_UT_ASSERT(rep.cgr_rc == 0);
+	M0_UT_ASSERT(rep.cgr_rep.cr_nr == MULTI_INS - 1);
+	M0_UT_ASSERT(m0_forall(i, MULTI_INS - 1,
+			       rep.cgr_rep.cr_rec[i].cr_rc == 0));
+	M0_UT_ASSERT(m0_forall(i, MULTI_INS - 1,
+			*(uint64_t *)repv[i].cr_val.u.ab_buf.b_addr ==
+			(i == dup ? 1 : i)));
+	fini();
+}
+
 static void multi_delete(void)
 {
 	struct record recs[MULTI_INS];
@@ -1993,6 +2083,7 @@ struct m0_ut_suite cas_service_ut = {
 		{ "lookup-N",                &lookup_N,              "Nikita" },
 		{ "lookup-restart",          &lookup_restart,        "Nikita" },
 		{ "cur-N",                   &cur_N,                 "Nikita" },
+		{ "delete-range",            &delete_range                    },
 		{ "meta-mt",                 &meta_mt,               "Nikita" },
 		{ "meta-insert-fail",        &meta_insert_fail,      "Leonid" },
 		{ "meta-lookup-fail",        &meta_lookup_fail,      "Leonid" },
@@ -2003,6 +2094,7 @@ struct m0_ut_suite cas_service_ut = {
 		{ "cur-fail",                &cur_fail,              "Egor"   },
 		{ "multi-insert",            &multi_insert,          "Leonid" },
 		{ "multi-lookup",            &multi_lookup,          "Leonid" },
+		{ "multi-unsorted",          &multi_unsorted                  },
 		{ "multi-delete",            &multi_delete,          "Leonid" },
 		{ "multi-insert-fail",       &multi_insert_fail,     "Leonid" },
 		{ "multi-lookup-fail",       &multi_lookup_fail,     "Leonid" },
@@ -618,6 +618,7 @@ M0_INTERNAL void m0_cm_cp_fom_init(struct m0_cm *cm, struct m0_cm_cp *cp,
 	service = &cm->cm_service;
 	m0_fom_init(&cp->c_fom, &cm->cm_type->ct_fomt, &cp_fom_ops, fop, r_fop,
 		    service->rs_reqh);
+	cp->c_fom.fo_prio = M0_FOM_PRIO_BG;
 }
 
 M0_TL_DECLARE(rpcbulk, M0_INTERNAL, struct m0_rpc_bulk_buf);
@@ -441,6 +441,7 @@ M0_INTERNAL void m0_cm_cp_pump_prepare(struct m0_cm *cm)
 	m0_cm_cp_pump_bob_init(cp_pump);
 	m0_fom_init(&cp_pump->p_fom, &cm->cm_type->ct_pump_fomt,
 		    &cm_cp_pump_fom_ops, NULL, NULL, cm->cm_service.rs_reqh);
+	cp_pump->p_fom.fo_prio = M0_FOM_PRIO_BG;
 }
 
 M0_INTERNAL void m0_cm_cp_pump_destroy(struct m0_cm *cm)
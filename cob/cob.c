@@ -603,10 +603,11 @@ static m0_bcount_t oi_ksize(const void *key)
 }
 
 static const struct m0_be_btree_kv_ops cob_oi_ops = {
-	.ko_type    = M0_BBT_COB_OBJECT_INDEX,
-	.ko_ksize   = oi_ksize,
-	.ko_vsize   = ns_ksize,
-	.ko_compare = oi_cmp
+	.ko_type         = M0_BBT_COB_OBJECT_INDEX,
+	.ko_ksize        = oi_ksize,
+	.ko_vsize        = ns_ksize,
+	.ko_compare      = oi_cmp,
+	.ko_inline_ksize = sizeof(struct m0_cob_oikey)
 };
 
 /**
@@ -1117,6 +1117,7 @@ static void dix_discovery_completed(struct m0_dix_req *req)
 	case DIX_PUT:
 	case DIX_DEL:
 	case DIX_NEXT:
+	case DIX_DEL_RANGE:
 		dix_rop(req);
 		break;
 	default:
@@ -1161,6 +1162,7 @@ void m0_dix_req_cancel(struct m0_dix_req *dreq)
 	case DIX_PUT:
 	case DIX_DEL:
 	case DIX_NEXT:
+	case DIX_DEL_RANGE:
 		rop = dreq->dr_rop;
 		if (rop == NULL)
 			return;
@@ -1393,12 +1395,24 @@ static void dix__rop(struct m0_dix_req *req, const struct m0_bufvec *keys,
 
 static void dix_rop(struct m0_dix_req *req)
 {
+	const struct m0_bufvec *keys = req->dr_keys;
+	struct m0_bufvec        lo;
+
 	M0_PRE(req->dr_indices_nr == 1);
 	M0_PRE(dix_unknown_layouts_nr(req) == 0);
 	M0_PRE(req->dr_keys != NULL);
 	M0_ENTRY();
 
-	dix__rop(req, req->dr_keys, NULL);
+	if (req->dr_type == DIX_DEL_RANGE) {
+		/*
+		 * Range is deleted by a single record operation sent to all
+		 * targets, the upper bound is taken from dr_keys on sending.
+		 */
+		lo = M0_BUFVEC_INIT_BUF(&keys->ov_buf[0],
+					&keys->ov_vec.v_count[0]);
+		keys = &lo;
+	}
+	dix__rop(req, keys, NULL);
 	M0_LEAVE();
 }
 
@@ -1439,6 +1453,14 @@ static void dix_item_rc_update(struct m0_dix_req  *req,
 				rep.crr_rc = 0;
 			rc = rep.crr_rc;
 			break;
+		case DIX_DEL_RANGE:
+			m0_cas_del_range_rep(creq, &rep);
+			rc = rep.crr_rc;
+			if (rc > 0) {
+				ditem->dxi_del_nr += rc;
+				rc = 0;
+			}
+			break;
 		default:
 			M0_IMPOSSIBLE("Incorrect type %u", rtype);
 		}
@@ -1629,7 +1651,16 @@ static void dix_rop_completed(struct m0_sm_group *grp, struct m0_sm_ast *ast)
 	(void)grp;
 	if (req->dr_type == DIX_NEXT)
 		m0_dix_next_result_prepare(req);
-	else {
+	else if (req->dr_type == DIX_DEL_RANGE) {
+		/*
+		 * Records from the range may reside in any component
+		 * catalogue, so every CAS request should succeed.
+		 */
+		m0_tl_for (cas_rop, &rop->dg_cas_reqs, cas_rop) {
+			dix_cas_rop_rc_update(cas_rop, 0);
+			m0_cas_req_fini(&cas_rop->crp_creq);
+		} m0_tl_endfor;
+	} else {
 		/*
 		 * Consider DIX request to be successful if there is at least
 		 * one successful CAS request.
@@ -1715,6 +1746,8 @@ static int dix_cas_rops_send(struct m0_dix_req *req)
 	struct m0_cas_id            cctg_id;
 	struct m0_reqh_service_ctx *cas_svc;
 	struct m0_dix_layout       *layout = &req->dr_indices[0].dd_layout;
+	struct m0_buf               lo;
+	struct m0_buf               hi;
 	int                         rc;
 	M0_ENTRY("req=%p", req);
 
@@ -1768,6 +1801,16 @@ static int dix_cas_rops_send(struct m0_dix_req *req)
 						 cas_rop->crp_flags |
 						 COF_SLANT);
 				break;
+			case DIX_DEL_RANGE:
+				lo = M0_BUF_INIT(
+					cas_rop->crp_keys.ov_vec.v_count[0],
+					cas_rop->crp_keys.ov_buf[0]);
+				hi = M0_BUF_INIT(
+					req->dr_keys->ov_vec.v_count[1],
+					req->dr_keys->ov_buf[1]);
+				rc = m0_cas_del_range(creq, &cctg_id, &lo, &hi,
+						      NULL, cas_rop->crp_flags);
+				break;
 			default:
 				M0_IMPOSSIBLE("Unknown req type %u",
 					      req->dr_type);
@@ -1810,7 +1853,7 @@ static int dix_cas_rops_send(struct m0_dix_req *req)
 static void dix_rop_tgt_iter_begin(const struct m0_dix_req *req,
 				   struct m0_dix_rec_op    *rec_op)
 {
-	if (req->dr_type == DIX_NEXT)
+	if (M0_IN(req->dr_type, (DIX_NEXT, DIX_DEL_RANGE)))
 		rec_op->dgp_next_tgt = 0;
 	else
 		m0_dix_layout_iter_reset(&rec_op->dgp_iter);
@@ -1822,13 +1865,14 @@ static uint32_t dix_rop_tgt_iter_max(struct m0_dix_req    *req,
 	struct m0_dix_layout_iter *iter = &rec_op->dgp_iter;
 	enum dix_req_type          type = req->dr_type;
 
-	M0_ASSERT(M0_IN(type, (DIX_GET, DIX_PUT, DIX_DEL, DIX_NEXT)));
-	if (type == DIX_NEXT)
+	M0_ASSERT(M0_IN(type, (DIX_GET, DIX_PUT, DIX_DEL, DIX_NEXT,
+			       DIX_DEL_RANGE)));
+	if (M0_IN(type, (DIX_NEXT, DIX_DEL_RANGE)))
 		/*
 		 * NEXT operation should be sent to all devices, because the
 		 * distribution of keys over devices is unknown. Therefore, all
 		 * component catalogues should be queried and returned records
-		 * should be merge-sorted.
+		 * should be merge-sorted. The same holds for DEL_RANGE.
 		 */
 		return m0_dix_liter_P(iter);
 	else
@@ -1845,7 +1889,7 @@ static void dix_rop_tgt_iter_next(const struct m0_dix_req *req,
 				  uint64_t                *target,
 				  bool                    *is_spare)
 {
-	if (req->dr_type != DIX_NEXT) {
+	if (!M0_IN(req->dr_type, (DIX_NEXT, DIX_DEL_RANGE))) {
 		*is_spare = m0_dix_liter_unit_classify(&rec_op->dgp_iter,
 				rec_op->dgp_iter.dit_unit) == M0_PUT_SPARE;
 		m0_dix_layout_iter_next(&rec_op->dgp_iter, target);
@@ -2014,6 +2058,7 @@ static void dix_rop_failed_unit_tgt(struct m0_dix_req    *req,
 					 M0_PNDS_SNS_REBALANCING)));
 	switch (req->dr_type) {
 	case DIX_NEXT:
+	case DIX_DEL_RANGE:
 		/* Do nothing. */
 		break;
 	case DIX_GET:
@@ -2432,6 +2477,38 @@ M0_INTERNAL int m0_dix_del(struct m0_dix_req      *req,
 	return M0_RC(0);
 }
 
+M0_INTERNAL int m0_dix_del_range(struct m0_dix_req      *req,
+				 const struct m0_dix    *index,
+				 const struct m0_bufvec *keys,
+				 uint32_t                flags)
+{
+	int rc;
+
+	M0_PRE(keys->ov_vec.v_nr == 2);
+	M0_PRE(keys->ov_vec.v_count[0] > 0);
+	/* Only sync_wait flag is allowed. */
+	M0_PRE((flags & ~(COF_SYNC_WAIT)) == 0);
+	rc = dix_req_indices_copy(req, index, 1);
+	if (rc != 0)
+		return M0_ERR(rc);
+	M0_ALLOC_ARR(req->dr_items, 1);
+	if (req->dr_items == NULL)
+		return M0_ERR(-ENOMEM);
+	req->dr_items_nr = 1;
+	req->dr_keys = keys;
+	req->dr_type = DIX_DEL_RANGE;
+	req->dr_flags = flags;
+	dix_discovery(req);
+	return M0_RC(0);
+}
+
+M0_INTERNAL uint64_t m0_dix_del_range_rep_nr(const struct m0_dix_req *req)
+{
+	M0_PRE(req->dr_type == DIX_DEL_RANGE);
+	M0_PRE(m0_dix_item_rc(req, 0) == 0);
+	return req->dr_items[0].dxi_del_nr;
+}
+
 M0_INTERNAL int m0_dix_next(struct m0_dix_req      *req,
 			    const struct m0_dix    *index,
 			    const struct m0_bufvec *start_keys,
@@ -182,7 +182,9 @@ enum dix_req_type {
 	/** Put given records in an index. */
 	DIX_PUT,
 	/** Delete records with the given keys from an index. */
-	DIX_DEL
+	DIX_DEL,
+	/** Delete records with keys in the given range from an index. */
+	DIX_DEL_RANGE
 } M0_XCA_ENUM;
 
 struct m0_dix_req {
@@ -209,7 +211,7 @@ struct m0_dix_req {
 	 * Array of indices to operate on. For index operations (DIX_CREATE,
 	 * DIX_DELETE, DIX_CCTGS_LOOKUP) it is an array of indices to be
 	 * created/deleted/looked up. For record operations (DIX_NEXT, DIX_GET,
-	 * DIX_PUT, DIX_DEL) it's a single index.
+	 * DIX_PUT, DIX_DEL, DIX_DEL_RANGE) it's a single index.
 	 */
 	struct m0_dix                *dr_indices;
 	/** Number of indices in dr_indices array. */
@@ -428,6 +430,38 @@ M0_INTERNAL int m0_dix_del(struct m0_dix_req      *req,
 			   struct m0_dtx          *dtx,
 			   uint32_t                flags);
 
+/**
+ * Deletes records with keys in [keys[0], keys[1]) from distributed index.
+ *
+ * The distribution of keys over component catalogues is unknown, so CAS DELR
+ * request is sent to every component catalogue, like for m0_dix_next(). Every
+ * CAS request removes a part of the range in a transaction of a fixed size,
+ * hence the request should be repeated until m0_dix_del_range_rep_nr() returns
+ * 0. Empty keys[1] stands for no upper bound.
+ *
+ * Request has the only item, which fails if any component catalogue fails.
+ *
+ *'Keys' buffer vector is managed by user and shall be accessible until the
+ * request completion.
+ *
+ * @pre keys->ov_vec.v_nr == 2
+ * @pre keys->ov_vec.v_count[0] > 0
+ * @pre (flags & ~(COF_SYNC_WAIT)) == 0
+ */
+M0_INTERNAL int m0_dix_del_range(struct m0_dix_req      *req,
+				 const struct m0_dix    *index,
+				 const struct m0_bufvec *keys,
+				 uint32_t                flags);
+
+/**
+ * Returns the number of records removed by m0_dix_del_range() from all
+ * component catalogues, replicas are counted separately. Zero means that the
+ * range is empty in every component catalogue.
+ *
+ * @pre m0_dix_item_rc(req, 0) == 0
+ */
+M0_INTERNAL uint64_t m0_dix_del_range_rep_nr(const struct m0_dix_req *req);
+
 /**
  * Gets next 'recs_nr[i]' records for each i-th key in 'start_keys'.
  *
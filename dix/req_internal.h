@@ -57,6 +57,11 @@ struct m0_dix_item {
 	 * delete is necessary for the index.
 	 */
 	bool          dxi_del_phase2;
+	/**
+	 * Applicable only for DIX_DEL_RANGE request. Number of records removed
+	 * from all component catalogues.
+	 */
+	uint64_t      dxi_del_nr;
 	int           dxi_rc;
 };
 
@@ -315,6 +315,7 @@ m0_fdmi__src_dock_fom_start(struct m0_fdmi_src_dock *src_dock,
 	pending_fops_tlist_init(&sd_fom->fsf_pending_fops);
 	sd_fom->fsf_has_records = false;
 	m0_fom_init(fom, &fdmi_sd_fom_type, &fdmi_sd_fom_ops, NULL, NULL, reqh);
+	fom->fo_prio = M0_FOM_PRIO_BG;
 	m0_fom_queue(fom);
 	sd_fom->fsf_last_checkpoint = m0_time_now();
 	src_dock->fsdc_started = true;
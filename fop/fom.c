@@ -130,6 +130,38 @@
  * Thread state transitions, associated lists and counters are protected by
  * the group mutex.
  *
+ * <b>Work stealing</b>
+ *
+ * When stealing is enabled (m0_fom_domain::fd_steal), a fom with
+ * m0_fom::fo_stealable set is not posted to its home locality by
+ * m0_fom_queue(). Instead it is pushed to the home locality steal queue
+ * (m0_fom_locality::fl_steal_in) without taking any lock, and the home handler
+ * is signalled. The fom is bound to a locality (admitted, see fom_admit())
+ * when a handler picks it up:
+ *
+ *     - the handler of the home locality admits one fom from its own steal
+ *       queue on every iteration of its loop, next to running the ASTs that
+ *       admit other foms, and drains the queue before going to sleep. A busy
+ *       locality thus keeps admitting new foms, while the rest of its
+ *       backlog stays available to thieves;
+ *
+ *     - a handler that found both its run-queue and its steal queue empty
+ *       tries the steal queues of other localities. It never blocks on a
+ *       victim: if the victim queue is being consumed, the victim is skipped.
+ *
+ * Otherwise stealable foms are admitted by an AST like the others. Foms left
+ * in the steal queues when stealing is disabled are admitted by their home
+ * handlers.
+ *
+ * Handlers keep the group lock while they sleep and while they execute
+ * foms, so the run-queue of a busy locality cannot be shared without making
+ * every fom transition pay for an additional lock. The steal queue only
+ * holds foms that were not admitted yet: nothing in them depends on the
+ * locality, and a thief admits the fom under its own group lock. When the
+ * steal queue of a locality grows beyond one fom (its handler is busy), the
+ * pushing thread additionally wakes a neighbouring handler, so that an idle
+ * locality notices the backlog.
+ *
  * @{
  */
 
@@ -233,7 +265,7 @@ M0_INTERNAL bool m0_fom_group_is_locked(const struct m0_fom *fom)
 
 static bool is_in_runq(const struct m0_fom *fom)
 {
-	return runq_tlist_contains(&fom->fo_loc->fl_runq, fom);
+	return runq_tlist_contains(&fom->fo_loc->fl_runq[fom->fo_prio], fom);
 }
 
 static bool is_in_wail(const struct m0_fom *fom)
@@ -268,14 +300,18 @@ M0_INTERNAL bool m0_locality_invariant(const struct m0_fom_locality *loc)
 	return
 		_0C(loc != NULL && loc->fl_dom != NULL) &&
 		_0C(m0_mutex_is_locked(&loc->fl_group.s_lock)) &&
-		_0C(M0_CHECK_EX(m0_tlist_invariant(&runq_tl, &loc->fl_runq))) &&
+		_0C(M0_CHECK_EX(m0_forall(p, M0_FOM_PRIO_NR,
+				m0_tlist_invariant(&runq_tl,
+						   &loc->fl_runq[p])))) &&
 		_0C(M0_CHECK_EX(m0_tlist_invariant(&wail_tl, &loc->fl_wail))) &&
 		_0C(m0_tl_forall(thr, t, &loc->fl_threads,
 			     t->lt_loc == loc && thread_invariant(t))) &&
 		_0C(ergo(loc->fl_handler != NULL,
 		     thr_tlist_contains(&loc->fl_threads, loc->fl_handler))) &&
-		_0C(M0_CHECK_EX(m0_tl_forall(runq, fom, &loc->fl_runq,
-					 fom->fo_loc == loc))) &&
+		_0C(M0_CHECK_EX(m0_forall(p, M0_FOM_PRIO_NR,
+				m0_tl_forall(runq, fom, &loc->fl_runq[p],
+					     fom->fo_loc == loc &&
+					     fom->fo_prio == p)))) &&
 		_0C(M0_CHECK_EX(m0_tl_forall(wail, fom, &loc->fl_wail,
 					 fom->fo_loc == loc)));
 }
@@ -313,6 +349,7 @@ M0_INTERNAL bool m0_fom_invariant(const struct m0_fom *fom)
 	return
 		_0C(fom != NULL) && _0C(fom->fo_loc != NULL) &&
 		_0C(fom->fo_type != NULL) && _0C(fom->fo_ops != NULL) &&
+		_0C(IS_IN_ARRAY(fom->fo_prio, fom->fo_loc->fl_runq)) &&
 
 		_0C(m0_fom_group_is_locked(fom)) &&
 
@@ -407,7 +444,7 @@ static bool fom_wait_time_is_out(const struct m0_fom_domain *dom,
 }
 
 /**
- * Enqueues fom into locality runq list and increments
+ * Enqueues fom into the locality runq list of its class and increments
  * number of items in runq, m0_fom_locality::fl_runq_nr.
  * This function is invoked when a new fom is submitted for
  * execution or a waiting fom is re-scheduled for processing.
@@ -421,9 +458,11 @@ static void fom_ready(struct m0_fom *fom)
 
 	fom_state_set(fom, M0_FOS_READY);
 	loc = fom->fo_loc;
-	empty = runq_tlist_is_empty(&loc->fl_runq);
-	runq_tlist_add_tail(&loc->fl_runq, fom);
+	empty = loc->fl_runq_nr == 0;
+	runq_tlist_add_tail(&loc->fl_runq[fom->fo_prio], fom);
 	M0_CNT_INC(loc->fl_runq_nr);
+	if (fom->fo_deadline != 0)
+		M0_CNT_INC(loc->fl_runq_dl_nr);
 	m0_addb2_hist_mod(&loc->fl_runq_counter, loc->fl_runq_nr);
 	if (empty)
 		m0_chan_signal(&loc->fl_runrun);
@@ -503,10 +542,11 @@ static void addb2_introduce(struct m0_fom *fom)
 	m0_addb2_pop(M0_AVI_FOM);
 }
 
-static void queueit(struct m0_sm_group *grp, struct m0_sm_ast *ast)
+/**
+ * Accounts a newly queued fom in its locality and puts it into the run-queue.
+ */
+static void fom_admit(struct m0_fom *fom)
 {
-	struct m0_fom *fom = container_of(ast, struct m0_fom, fo_cb.fc_ast);
-
 	M0_PRE(m0_fom_invariant(fom));
 	M0_PRE(m0_fom_phase(fom) == M0_FOM_PHASE_INIT);
 
@@ -516,6 +556,118 @@ static void queueit(struct m0_sm_group *grp, struct m0_sm_ast *ast)
 	fom_ready(fom);
 }
 
+static void queueit(struct m0_sm_group *grp, struct m0_sm_ast *ast)
+{
+	fom_admit(container_of(ast, struct m0_fom, fo_cb.fc_ast));
+}
+
+/**
+ * Pushes a stealable fom to the steal queue of its home locality.
+ *
+ * Can be called by any thread without locks.
+ */
+static void stealq_push(struct m0_fom_locality *loc, struct m0_fom *fom)
+{
+	struct m0_fom_domain *dom = loc->fl_dom;
+	size_t                nr  = dom->fd_localities_nr;
+	int64_t               queued;
+
+	M0_PRE(fom->fo_steal_next == NULL);
+
+	do {
+		fom->fo_steal_next = loc->fl_steal_in;
+	} while (!M0_ATOMIC64_CAS(&loc->fl_steal_in, fom->fo_steal_next, fom));
+	queued = m0_atomic64_add_return(&loc->fl_steal_nr, 1);
+	m0_clink_signal(&loc->fl_group.s_clink);
+	/*
+	 * The home handler has not picked up the previous fom yet. Knock on
+	 * a neighbour, rotating over the localities as the backlog grows.
+	 */
+	if (queued > 1 && dom->fd_steal && nr > 1)
+		m0_clink_signal(&dom->fd_localities[(loc->fl_idx + 1 +
+						     queued % (nr - 1)) %
+						    nr]->fl_group.s_clink);
+}
+
+/**
+ * Takes the oldest fom from the steal queue of a locality.
+ *
+ * When "wait" is false, returns NULL instead of waiting for another consumer
+ * of the same queue.
+ */
+static struct m0_fom *stealq_pop(struct m0_fom_locality *loc, bool wait)
+{
+	struct m0_fom *fom;
+	struct m0_fom *next;
+
+	if (m0_atomic64_get(&loc->fl_steal_nr) == 0)
+		return NULL;
+	if (wait)
+		m0_mutex_lock(&loc->fl_steal_lock);
+	else if (m0_mutex_trylock(&loc->fl_steal_lock) != 0)
+		return NULL;
+	if (loc->fl_steal_out == NULL) {
+		/*
+		 * Detach the whole list at once: unlike popping a single
+		 * element, this is not subject to the ABA problem. Reverse it
+		 * to restore the queueing order.
+		 */
+		do {
+			fom = loc->fl_steal_in;
+		} while (fom != NULL &&
+			 !M0_ATOMIC64_CAS(&loc->fl_steal_in, fom,
+					  (struct m0_fom *)NULL));
+		for (; fom != NULL; fom = next) {
+			next = fom->fo_steal_next;
+			fom->fo_steal_next = loc->fl_steal_out;
+			loc->fl_steal_out = fom;
+		}
+	}
+	fom = loc->fl_steal_out;
+	if (fom != NULL) {
+		loc->fl_steal_out = fom->fo_steal_next;
+		fom->fo_steal_next = NULL;
+		m0_atomic64_dec(&loc->fl_steal_nr);
+	}
+	m0_mutex_unlock(&loc->fl_steal_lock);
+	return fom;
+}
+
+/**
+ * Takes a fom from the steal queue of the locality or, if "steal" is true and
+ * stealing is enabled, of another locality and admits it into the locality
+ * run-queue.
+ *
+ * Returns true iff a fom was admitted.
+ */
+static bool fom_claim(struct m0_fom_locality *loc, bool steal)
+{
+	struct m0_fom_domain *dom = loc->fl_dom;
+	struct m0_fom        *fom;
+	size_t                nr  = dom->fd_localities_nr;
+	size_t                i;
+
+	M0_PRE(m0_locality_invariant(loc));
+
+	fom = stealq_pop(loc, true);
+	for (i = 1; fom == NULL && steal && dom->fd_steal && i < nr; ++i) {
+		fom = stealq_pop(dom->fd_localities[(loc->fl_idx + i) % nr],
+				 false);
+		if (fom != NULL) {
+			M0_CNT_INC(loc->fl_stolen);
+			M0_LOG(M0_DEBUG, "loc=%i stole fom=%p from loc=%i",
+			       loc->fl_idx, fom, fom->fo_loc->fl_idx);
+		}
+	}
+	if (fom != NULL) {
+		fom->fo_loc     = loc;
+		fom->fo_loc_idx = loc->fl_idx;
+		m0_fom_sm_init(fom);
+		fom_admit(fom);
+	}
+	return fom != NULL;
+}
+
 static void thr_addb2_enter(struct m0_loc_thread *thr,
 			    struct m0_fom_locality *loc)
 {
@@ -641,16 +793,23 @@ M0_INTERNAL void m0_fom_queue(struct m0_fom *fom)
 	M0_ASSERT(loc_idx < dom->fd_localities_nr);
 	fom->fo_loc = dom->fd_localities[loc_idx];
 	fom->fo_loc_idx = loc_idx;
-	m0_fom_sm_init(fom);
 	if ((fom->fo_service != NULL &&
 	    m0_reqh_service_state_get(fom->fo_service) == M0_RST_STOPPED) ||
 	    fom->fo_service == NULL) {
+		m0_fom_sm_init(fom);
 		m0_fom_phase_set(fom, M0_FOM_PHASE_FINISH);
 		m0_fom_fini(fom);
 		M0_LEAVE("Service is already stopped, fom:%p", fom);
 		return;
 	}
 	m0_atomic64_inc(&fom->fo_service->rs_fom_queued);
+	if (fom->fo_stealable && dom->fd_steal) {
+		/* State machines are initialised by fom_claim(). */
+		stealq_push(fom->fo_loc, fom);
+		M0_LEAVE();
+		return;
+	}
+	m0_fom_sm_init(fom);
 	fom->fo_cb.fc_ast.sa_cb = &queueit;
 	m0_sm_ast_post(&fom->fo_loc->fl_group, &fom->fo_cb.fc_ast);
 }
@@ -861,20 +1020,82 @@ static void fom_exec(struct m0_fom *fom)
 }
 
 /**
- * Dequeues a fom from runq list of the locality.
+ * Returns the ready fom with the earliest expired deadline, if any.
+ *
+ * Deadlines are rare, so the run-queues are only scanned when at least one
+ * fom with a deadline is there.
+ */
+static struct m0_fom *runq_late(struct m0_fom_locality *loc)
+{
+	struct m0_fom *late = NULL;
+	struct m0_fom *fom;
+	m0_time_t      now;
+	int            p;
+
+	if (loc->fl_runq_dl_nr == 0)
+		return NULL;
+	now = m0_time_now();
+	for (p = 0; p < M0_FOM_PRIO_NR; ++p) {
+		m0_tl_for(runq, &loc->fl_runq[p], fom) {
+			if (fom->fo_deadline != 0 && fom->fo_deadline <= now &&
+			    (late == NULL ||
+			     fom->fo_deadline < late->fo_deadline))
+				late = fom;
+		} m0_tl_endfor;
+	}
+	return late;
+}
+
+/**
+ * Selects the class to be served next: the highest non-empty one, unless
+ * a lower non-empty class was already passed over M0_FOM_PRIO_SHARE times.
+ *
+ * Returns M0_FOM_PRIO_NR when all run-queues are empty.
+ */
+static int runq_select(const struct m0_fom_locality *loc)
+{
+	int first = M0_FOM_PRIO_NR;
+	int p;
+
+	for (p = M0_FOM_PRIO_NR - 1; p >= 0; --p) {
+		if (runq_tlist_is_empty(&loc->fl_runq[p]))
+			continue;
+		if (loc->fl_runq_skipped[p] >= M0_FOM_PRIO_SHARE)
+			return p;
+		first = p;
+	}
+	return first;
+}
+
+/**
+ * Dequeues a fom from runq lists of the locality.
  *
  * @retval m0_fom if queue is not empty, NULL otherwise
  */
 static struct m0_fom *fom_dequeue(struct m0_fom_locality *loc)
 {
 	struct m0_fom *fom;
-
-	fom = runq_tlist_pop(&loc->fl_runq);
-	if (fom != NULL) {
-		M0_ASSERT(fom->fo_loc == loc);
-		M0_CNT_DEC(loc->fl_runq_nr);
-		m0_addb2_hist_mod(&loc->fl_runq_counter, loc->fl_runq_nr);
+	int            p;
+
+	fom = runq_late(loc);
+	if (fom == NULL) {
+		p = runq_select(loc);
+		if (p == M0_FOM_PRIO_NR)
+			return NULL;
+		fom = runq_tlist_head(&loc->fl_runq[p]);
+	}
+	M0_ASSERT(fom->fo_loc == loc);
+	runq_tlist_del(fom);
+	for (p = 0; p < M0_FOM_PRIO_NR; ++p) {
+		if (p == fom->fo_prio)
+			loc->fl_runq_skipped[p] = 0;
+		else if (!runq_tlist_is_empty(&loc->fl_runq[p]))
+			M0_CNT_INC(loc->fl_runq_skipped[p]);
 	}
+	if (fom->fo_deadline != 0)
+		M0_CNT_DEC(loc->fl_runq_dl_nr);
+	M0_CNT_DEC(loc->fl_runq_nr);
+	m0_addb2_hist_mod(&loc->fl_runq_counter, loc->fl_runq_nr);
 	return fom;
 }
 
@@ -940,9 +1161,13 @@ static void loc_handler_thread(struct m0_loc_thread *th)
 				 */
 				break;
 			M0_ADDB2_IN(M0_AVI_AST, m0_sm_asts_run(&loc->fl_group));
+			/* Admission of new foms does not wait for idleness. */
+			fom_claim(loc, false);
 			M0_ADDB2_IN(M0_AVI_CHORE,
 				    m0_locality_chores_run(&loc->fl_locality));
 			fom = fom_dequeue(loc);
+			if (fom == NULL && fom_claim(loc, true))
+				fom = fom_dequeue(loc);
 			if (fom != NULL) {
 				fom_addb2_push(fom);
 				fom_exec(fom);
@@ -1036,6 +1261,7 @@ static void loc_addb2_fini(struct m0_fom_locality *loc)
 static void loc_fini(struct m0_fom_locality *loc)
 {
 	struct m0_loc_thread *th;
+	int                   p;
 
 	loc->fl_shutdown = true;
 	m0_clink_signal(&loc->fl_group.s_clink);
@@ -1051,8 +1277,13 @@ static void loc_fini(struct m0_fom_locality *loc)
 	}
 	group_unlock(loc);
 
-	runq_tlist_fini(&loc->fl_runq);
+	for (p = 0; p < M0_FOM_PRIO_NR; ++p)
+		runq_tlist_fini(&loc->fl_runq[p]);
 	M0_ASSERT(loc->fl_runq_nr == 0);
+	M0_ASSERT(loc->fl_runq_dl_nr == 0);
+	M0_ASSERT(m0_atomic64_get(&loc->fl_steal_nr) == 0);
+	M0_ASSERT(loc->fl_steal_in == NULL && loc->fl_steal_out == NULL);
+	m0_mutex_fini(&loc->fl_steal_lock);
 	wail_tlist_fini(&loc->fl_wail);
 	M0_ASSERT(loc->fl_wail_nr == 0);
 	thr_tlist_fini(&loc->fl_threads);
@@ -1083,6 +1314,7 @@ static int loc_init(struct m0_fom_locality *loc, struct m0_fom_domain *dom,
 		    size_t idx)
 {
 	int                   res;
+	int                   p;
 	struct m0_addb2_mach *orig = m0_thread_tls()->tls_addb2_mach;
 
 	M0_PRE(loc != NULL);
@@ -1096,10 +1328,19 @@ static int loc_init(struct m0_fom_locality *loc, struct m0_fom_domain *dom,
 		goto err;
 	}
 
-	runq_tlist_init(&loc->fl_runq);
+	for (p = 0; p < M0_FOM_PRIO_NR; ++p) {
+		runq_tlist_init(&loc->fl_runq[p]);
+		loc->fl_runq_skipped[p] = 0;
+	}
 	loc->fl_runq_nr = 0;
+	loc->fl_runq_dl_nr = 0;
 	wail_tlist_init(&loc->fl_wail);
 	loc->fl_wail_nr = 0;
+	loc->fl_steal_in = NULL;
+	loc->fl_steal_out = NULL;
+	m0_mutex_init(&loc->fl_steal_lock);
+	m0_atomic64_set(&loc->fl_steal_nr, 0);
+	loc->fl_stolen = 0;
 	loc->fl_idx = idx;
 	m0_thread_tls()->tls_addb2_mach = loc->fl_addb2_mach;
 	m0_addb2_push(M0_AVI_NODE, M0_ADDB2_OBJ(&m0_node_uuid));
@@ -1180,9 +1421,11 @@ static void hung_foms_notify(struct m0_locality_chore *chore,
 	struct m0_fom_locality *floc = container_of(loc, struct m0_fom_locality,
 						    fl_locality);
 	const struct m0_fom_domain *dom = floc->fl_dom;
+	int                         i;
 
-	(void)m0_tl_forall(runq, fom, &floc->fl_runq,
-			   dom->fd_ops->fdo_time_is_out(dom, fom));
+	for (i = 0; i < M0_FOM_PRIO_NR; ++i)
+		(void)m0_tl_forall(runq, fom, &floc->fl_runq[i],
+				   dom->fd_ops->fdo_time_is_out(dom, fom));
 	(void)m0_tl_forall(wail, fom, &floc->fl_wail,
 			   dom->fd_ops->fdo_time_is_out(dom, fom));
 }
@@ -1274,6 +1517,7 @@ M0_INTERNAL void m0_fom_domain_fini(struct m0_fom_domain *dom)
 {
 	int i;
 
+	dom->fd_steal = false;
 	m0_locality_chore_fini(&dom->fd_hung_foms_chore);
 	if (dom->fd_localities != NULL) {
 		for (i = dom->fd_localities_nr - 1; i >= 0; --i) {
@@ -1290,6 +1534,13 @@ M0_INTERNAL void m0_fom_domain_fini(struct m0_fom_domain *dom)
 	m0_free(dom);
 }
 
+M0_INTERNAL void m0_fom_domain_steal_set(struct m0_fom_domain *dom, bool on)
+{
+	M0_PRE(m0_fom_domain_invariant(dom));
+	dom->fd_steal = on;
+	M0_LOG(M0_INFO, "fom work stealing %s", on ? "enabled" : "disabled");
+}
+
 static bool is_loc_locker_empty(struct m0_fom_locality *loc, uint32_t key)
 {
 	return m0_locality_lockers_is_empty(&loc->fl_locality, key);
@@ -1400,6 +1651,10 @@ void m0_fom_init(struct m0_fom *fom, const struct m0_fom_type *fom_type,
 	fom->fo_ops	    = ops;
 	fom->fo_transitions = 0;
 	fom->fo_local	    = false;
+	fom->fo_prio        = M0_FOM_PRIO_FG;
+	fom->fo_deadline    = 0;
+	fom->fo_stealable   = false;
+	fom->fo_steal_next  = NULL;
 	m0_fom_callback_init(&fom->fo_cb);
 	runq_tlink_init(fom);
 
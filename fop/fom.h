@@ -235,6 +235,32 @@ struct m0_loc_thread;
 
 #define FOM_PHASE_DEBUG (1)
 
+/**
+ * Scheduling classes of foms.
+ *
+ * Each locality keeps a run-queue per class. A handler serves the highest
+ * class with ready foms, except that a non-empty lower class is passed over
+ * at most M0_FOM_PRIO_SHARE times in a row and that a fom whose deadline
+ * (m0_fom::fo_deadline) has expired is served ahead of its class.
+ *
+ * @see m0_fom::fo_prio
+ */
+enum m0_fom_prio {
+	/** Requests with a client waiting for the reply. The default. */
+	M0_FOM_PRIO_FG,
+	/**
+	 * Background activity: repair and rebalance copy packets, index
+	 * garbage collection, FDMI record processing.
+	 */
+	M0_FOM_PRIO_BG,
+	M0_FOM_PRIO_NR,
+	/**
+	 * Maximal number of foms from higher classes executed in a row while
+	 * a lower class has ready foms.
+	 */
+	M0_FOM_PRIO_SHARE = 8
+};
+
 /**
  * A locality is a partition of computational resources dedicated to fom
  * execution on the node.
@@ -255,9 +281,17 @@ struct m0_loc_thread;
 struct m0_fom_locality {
 	struct m0_fom_domain          *fl_dom;
 
-	/** Run-queue */
-	struct m0_tl		       fl_runq;
+	/** Run-queues, one per enum m0_fom_prio class. */
+	struct m0_tl		       fl_runq[M0_FOM_PRIO_NR];
+	/** Total number of foms in the run-queues. */
 	size_t			       fl_runq_nr;
+	/**
+	 * How many times in a row a non-empty run-queue was passed over by
+	 * the handler.
+	 */
+	unsigned                       fl_runq_skipped[M0_FOM_PRIO_NR];
+	/** Number of foms with a deadline in the run-queues. */
+	size_t                         fl_runq_dl_nr;
 
 	/** Wait list */
 	struct m0_tl		       fl_wail;
@@ -302,6 +336,25 @@ struct m0_fom_locality {
 	struct m0_locality             fl_locality;
 	struct m0_sm_group_addb2       fl_grp_addb2;
 	struct m0_chan_addb2           fl_chan_addb2;
+	/**
+	 * Steal queue: stealable foms (m0_fom::fo_stealable) queued to this
+	 * locality, but not yet admitted into the run-queue of any locality.
+	 *
+	 * New foms are pushed to ->fl_steal_in without locking (see
+	 * m0_sm_ast_post() for the same technique). Consumers, which are the
+	 * handler of this locality and, in stealing mode, handlers of idle
+	 * localities, serialise on ->fl_steal_lock, move ->fl_steal_in to
+	 * ->fl_steal_out in FIFO order and take foms from there.
+	 *
+	 * @see m0_fom_domain::fd_steal
+	 */
+	struct m0_fom                 *fl_steal_in;
+	struct m0_fom                 *fl_steal_out;
+	struct m0_mutex                fl_steal_lock;
+	/** Number of foms in the steal queue. */
+	struct m0_atomic64             fl_steal_nr;
+	/** Number of foms this locality stole from other localities. */
+	uint64_t                       fl_stolen;
 	/** Something for memory, see set_mempolicy(2). */
 };
 
@@ -336,6 +389,15 @@ struct m0_fom_domain {
 	/** Long living foms detecting chore. */
 	struct m0_locality_chore        fd_hung_foms_chore;
 	struct m0_addb2_sys            *fd_addb2_sys;
+	/**
+	 * Work stealing mode. When set, m0_fom_queue() pushes stealable foms
+	 * to the steal queues of their home localities, and a locality handler
+	 * that has nothing to run takes them from the steal queues of other
+	 * localities. Otherwise stealable foms are queued as any other fom.
+	 *
+	 * @see m0_fom_domain_steal_set(), m0_fom_locality::fl_steal_in
+	 */
+	bool                            fd_steal;
 };
 
 /** Operations vector attached to a domain. */
@@ -406,6 +468,14 @@ M0_INTERNAL void m0_fom_domain_fini(struct m0_fom_domain *dom);
 M0_INTERNAL bool m0_fom_domain_is_idle(const struct m0_fom_domain *dom);
 M0_INTERNAL bool m0_fom_domain_is_idle_for(const struct m0_reqh_service *svc);
 
+/**
+ * Enables or disables work stealing between the localities of the domain.
+ *
+ * Stealing only affects foms with m0_fom::fo_stealable set. It is disabled
+ * by default.
+ */
+M0_INTERNAL void m0_fom_domain_steal_set(struct m0_fom_domain *dom, bool on);
+
 /**
  * This function iterates over m0_fom_domain members and checks
  * if they are intialised.
@@ -501,6 +571,30 @@ struct m0_fom {
 	 *  e.g., undo or redo during recovery.
 	 */
 	bool                      fo_local;
+	/**
+	 * Scheduling class. Set by the fom creator after m0_fom_init(), must
+	 * not be changed while the fom is in a run-queue.
+	 */
+	enum m0_fom_prio          fo_prio;
+	/**
+	 * Optional absolute deadline, 0 means none. When the deadline expires
+	 * while the fom waits in a run-queue, the fom is served before other
+	 * ready foms, regardless of its class.
+	 */
+	m0_time_t                 fo_deadline;
+	/**
+	 * Set by the fom creator before m0_fom_queue() when the fom has no
+	 * affinity to its home locality. When stealing is enabled
+	 * (m0_fom_domain::fd_steal), such a fom is bound to a locality only
+	 * when some locality handler is ready to execute it, and this
+	 * locality need not be the home one.
+	 *
+	 * Until the first m0_fom_ops::fo_tick() call, m0_fom::fo_loc of a
+	 * stealable fom can change and must not be used by other threads.
+	 */
+	bool                      fo_stealable;
+	/** Linkage in m0_fom_locality::fl_steal_in or ::fl_steal_out. */
+	struct m0_fom            *fo_steal_next;
 	/** Pointer to service instance. */
 	struct m0_reqh_service   *fo_service;
 	/**
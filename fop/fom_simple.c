@@ -72,7 +72,9 @@ M0_INTERNAL void m0_fom_simple_post(struct m0_fom_simple *simpleton,
 	simpleton->si_data = data;
 	simpleton->si_tick = tick;
 	simpleton->si_free = free;
-	if (locality == M0_FOM_SIMPLE_HERE)
+	if (locality == M0_FOM_SIMPLE_ANY)
+		simpleton->si_fom.fo_stealable = true;
+	if (M0_IN(locality, (M0_FOM_SIMPLE_HERE, M0_FOM_SIMPLE_ANY)))
 		locality = m0_locality_here()->lo_idx;
 	simpleton->si_locality = locality;
 	m0_fom_queue(&simpleton->si_fom);
@@ -134,7 +134,13 @@ enum {
 	 * Pass this as "locality" argument to m0_fom_simple_post() to bind the
 	 * fom to the current locality.
 	 */
-	M0_FOM_SIMPLE_HERE = 0xbedabedabedabeda
+	M0_FOM_SIMPLE_HERE = 0xbedabedabedabeda,
+	/**
+	 * Pass this as "locality" argument to m0_fom_simple_post() to queue
+	 * the fom to the current locality, allowing other localities to steal
+	 * it (m0_fom::fo_stealable).
+	 */
+	M0_FOM_SIMPLE_ANY  = 0xbedabedabedabedb
 };
 
 /**
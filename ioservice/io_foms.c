@@ -1172,6 +1172,13 @@ M0_INTERNAL int m0_io_fom_cob_rw_create(struct m0_fop *fop, struct m0_fom **out,
 	rwfop = io_rw_get(fop);
 	*out  = fom;
 	m0_fom_init(fom, &fop->f_type->ft_fom_type, &ops, fop, rep_fop, reqh);
+	/*
+	 * Nothing in an io fom depends on its locality: network buffers are
+	 * taken by transfer machine colour and the fid-based home locality only
+	 * spreads the load. Let an idle locality pick it up, if stealing is
+	 * enabled (m0_reqh_init_args::rhia_fom_steal).
+	 */
+	fom->fo_stealable = true;
 
 	fom_obj->fcrw_fom_start_time      = m0_time_now();
 	fom_obj->fcrw_stob                = NULL;
@@ -49,6 +49,10 @@
 #include "mdservice/fsync_fops.h"
 #include "module/instance.h"       /* m0_get */
 #include "ioservice/fid_convert.h" /* m0_fid_convert_gob2cob */
+#include "ioservice/storage_dev.h" /* m0_storage_devs_buffers_register */
+#include "motr/setup.h"            /* m0_cs_storage_devs_get */
+#include "stob/ioq.h"              /* M0_STOB_IOQ_URING_BUFS_MAX */
+#include <sys/uio.h>               /* iovec */
 
 M0_TL_DESCR_DEFINE(bufferpools, "rpc machines associated with reqh",
 		   M0_INTERNAL,
@@ -82,6 +86,7 @@ static void ios_stop(struct m0_reqh_service *service);
 
 static void buffer_pool_not_empty(struct m0_net_buffer_pool *bp);
 static void buffer_pool_low(struct m0_net_buffer_pool *bp);
+static void ios_buffers_register(struct m0_reqh_io_service *serv_obj);
 
 /**
  * I/O Service type operations.
@@ -278,9 +283,64 @@ M0_INTERNAL int m0_ios_create_buffer_pool(struct m0_reqh_service *service)
 	} m0_tl_endfor; /* rpc_machines */
 	m0_rwlock_read_unlock(&reqh->rh_rwlock);
 
+	if (rc == 0)
+		ios_buffers_register(serv_obj);
 	return M0_RC(rc);
 }
 
+/**
+ * Registers segments of the pre-allocated network buffers with the I/O queues
+ * of the storage, so that io_uring reads and writes them as fixed buffers.
+ * Bulk I/O moves data between these buffers and storage objects directly.
+ *
+ * Buffers provisioned later are not registered: they are read and written
+ * as ordinary buffers. A registration failure (e.g., RLIMIT_MEMLOCK is too
+ * low) is not fatal either.
+ */
+static void ios_buffers_register(struct m0_reqh_io_service *serv_obj)
+{
+	struct m0_storage_devs     *devs = m0_cs_storage_devs_get();
+	struct m0_rios_buffer_pool *bp;
+	struct m0_net_buffer       *nb;
+	struct iovec               *bufs;
+	unsigned                    nr = 0;
+	uint32_t                    i;
+	int                         rc;
+
+	M0_ALLOC_ARR(bufs, M0_STOB_IOQ_URING_BUFS_MAX);
+	if (bufs == NULL)
+		return;
+	m0_tl_for(bufferpools, &serv_obj->rios_buffer_pools, bp) {
+		m0_net_buffer_pool_lock(&bp->rios_bp);
+		m0_tl_for(m0_net_pool, &bp->rios_bp.nbp_lru, nb) {
+			for (i = 0; i < nb->nb_buffer.ov_vec.v_nr &&
+				    nr < M0_STOB_IOQ_URING_BUFS_MAX; ++i)
+				bufs[nr++] = (struct iovec) {
+					.iov_base = nb->nb_buffer.ov_buf[i],
+					.iov_len  =
+					    nb->nb_buffer.ov_vec.v_count[i]
+				};
+		} m0_tl_endfor;
+		m0_net_buffer_pool_unlock(&bp->rios_bp);
+	} m0_tl_endfor;
+
+	m0_storage_devs_lock(devs);
+	rc = m0_storage_devs_buffers_register(devs, bufs, nr);
+	m0_storage_devs_unlock(devs);
+	if (rc != 0)
+		M0_LOG(M0_WARN, "Buffers are not registered: rc=%d", rc);
+	m0_free(bufs);
+}
+
+static void ios_buffers_unregister(void)
+{
+	struct m0_storage_devs *devs = m0_cs_storage_devs_get();
+
+	m0_storage_devs_lock(devs);
+	m0_storage_devs_buffers_unregister(devs);
+	m0_storage_devs_unlock(devs);
+}
+
 /**
  * Delete instances of buffer pool.
  * It go through buffer pool list and delete the instance.
@@ -299,6 +359,7 @@ M0_INTERNAL void m0_ios_delete_buffer_pool(struct m0_reqh_service *service)
 	serv_obj = container_of(service, struct m0_reqh_io_service, rios_gen);
 	M0_ASSERT(m0_reqh_io_service_invariant(serv_obj));
 
+	ios_buffers_unregister();
 	m0_tl_for(bufferpools, &serv_obj->rios_buffer_pools, bp) {
 
 		M0_ASSERT(bp != NULL);
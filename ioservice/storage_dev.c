@@ -93,6 +93,8 @@ M0_INTERNAL int m0_storage_devs_init(struct m0_storage_devs   *devs,
 	devs->sds_be_seg         = be_seg;
 	devs->sds_back_domain    = bstore_dom;
 	devs->sds_locks_disabled = false;
+	devs->sds_bufs           = NULL;
+	devs->sds_bufs_nr        = 0;
 	storage_dev_tlist_init(&devs->sds_devices);
 	m0_mutex_init(&devs->sds_lock);
 	m0_clink_init(&devs->sds_conf_ready_async,
@@ -127,6 +129,7 @@ M0_INTERNAL void m0_storage_devs_fini(struct m0_storage_devs *devs)
 	} m0_tl_endfor;
 
 	storage_dev_tlist_fini(&devs->sds_devices);
+	m0_free(devs->sds_bufs);
 	m0_mutex_fini(&devs->sds_lock);
 	M0_LEAVE();
 }
@@ -142,6 +145,79 @@ M0_INTERNAL void m0_storage_devs_use_directio(struct m0_storage_devs *devs,
 	devs->sds_use_directio = directio;
 }
 
+M0_INTERNAL void m0_storage_devs_use_uring(struct m0_storage_devs *devs,
+					   bool                    uring,
+					   bool                    sqpoll)
+{
+	M0_PRE(storage_dev_tlist_is_empty(&devs->sds_devices));
+
+	devs->sds_use_uring    = uring;
+	devs->sds_uring_sqpoll = uring && sqpoll;
+}
+
+M0_INTERNAL void m0_storage_devs_ioq_size(struct m0_storage_devs *devs,
+					  uint32_t                nr_threads,
+					  uint32_t                ring_size)
+{
+	M0_PRE(storage_dev_tlist_is_empty(&devs->sds_devices));
+
+	devs->sds_ioq_threads   = nr_threads;
+	devs->sds_ioq_ring_size = ring_size;
+}
+
+M0_INTERNAL int m0_storage_devs_buffers_register(struct m0_storage_devs *devs,
+						 const struct iovec     *bufs,
+						 unsigned                nr)
+{
+	struct m0_storage_dev *dev;
+	int                    rc = 0;
+
+	M0_ENTRY("nr=%u", nr);
+	M0_PRE(storage_devs_is_locked(devs));
+	M0_PRE(nr <= M0_STOB_IOQ_URING_BUFS_MAX);
+	M0_PRE(devs->sds_bufs == NULL);
+
+	M0_ALLOC_ARR(devs->sds_bufs, nr);
+	if (devs->sds_bufs == NULL)
+		return M0_ERR(-ENOMEM);
+	memcpy(devs->sds_bufs, bufs, nr * sizeof bufs[0]);
+	devs->sds_bufs_nr = nr;
+	if (devs->sds_type == M0_STORAGE_DEV_TYPE_AD) {
+		rc = m0_stob_linux_domain_buffers_register(
+			devs->sds_back_domain, bufs, nr);
+	} else {
+		m0_tl_for(storage_dev, &devs->sds_devices, dev) {
+			rc = m0_stob_linux_domain_buffers_register(
+				dev->isd_domain, bufs, nr);
+			if (rc != 0)
+				break;
+		} m0_tl_endfor;
+	}
+	if (rc != 0)
+		m0_storage_devs_buffers_unregister(devs);
+	return M0_RC(rc);
+}
+
+M0_INTERNAL void
+m0_storage_devs_buffers_unregister(struct m0_storage_devs *devs)
+{
+	struct m0_storage_dev *dev;
+
+	M0_PRE(storage_devs_is_locked(devs));
+
+	if (devs->sds_bufs == NULL)
+		return;
+	if (devs->sds_type == M0_STORAGE_DEV_TYPE_AD)
+		m0_stob_linux_domain_buffers_unregister(devs->sds_back_domain);
+	else
+		m0_tl_for(storage_dev, &devs->sds_devices, dev) {
+			m0_stob_linux_domain_buffers_unregister(
+				dev->isd_domain);
+		} m0_tl_endfor;
+	m0_free0(&devs->sds_bufs);
+	devs->sds_bufs_nr = 0;
+}
+
 M0_INTERNAL void m0_storage_devs_locks_disable(struct m0_storage_devs *devs)
 {
 	M0_PRE(!storage_devs_is_locked(devs));
@@ -405,9 +481,19 @@ static int stob_domain_create_or_init(struct m0_storage_dev  *dev,
 			return len < 0 ? M0_ERR(len) : M0_ERR(-ENOMEM);
 		rc = snprintf(location, len + 1, "linuxstob:%s",
 			      dev->isd_filename);
-		cfg_init = devs->sds_use_directio ? "directio=true" :
-						    "directio=false";
 		M0_ASSERT_INFO(rc == len, "rc=%d", rc);
+		m0_stob_linux_init_cfg_make(&cfg_init,
+			&(struct m0_stob_linux_domain_cfg) {
+				.sldc_use_directio  = devs->sds_use_directio,
+				.sldc_use_uring     = devs->sds_use_uring,
+				.sldc_uring_sqpoll  = devs->sds_uring_sqpoll,
+				.sldc_ioq_threads   = devs->sds_ioq_threads,
+				.sldc_ioq_ring_size = devs->sds_ioq_ring_size,
+			});
+		if (cfg_init == NULL) {
+			m0_free(location);
+			return M0_ERR(-ENOMEM);
+		}
 		break;
 	case M0_STORAGE_DEV_TYPE_AD:
 		len = snprintf(NULL, 0, "adstob:%llu", cid);
@@ -440,10 +526,17 @@ static int stob_domain_create_or_init(struct m0_storage_dev  *dev,
 	if (force || rc != 0)
 		rc = m0_stob_domain_create(location, cfg_init, cid, cfg,
 					   &dev->isd_domain);
+	if (rc == 0 && type == M0_STORAGE_DEV_TYPE_LINUX &&
+	    devs->sds_bufs != NULL) {
+		rc = m0_stob_linux_domain_buffers_register(dev->isd_domain,
+							   devs->sds_bufs,
+							   devs->sds_bufs_nr);
+		if (rc != 0)
+			m0_stob_domain_fini(dev->isd_domain);
+	}
 out_free:
 	m0_free(location);
-	if (type == M0_STORAGE_DEV_TYPE_AD)
-		m0_free(cfg_init);
+	m0_free(cfg_init);
 	m0_free(cfg);
 
 	return M0_RC(rc);
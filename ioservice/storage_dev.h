@@ -41,6 +41,7 @@ struct m0_dtx;
 struct m0_be_seg;
 struct m0_conf_sdev;
 struct m0_reqh;
+struct iovec;
 
 /**
  * @defgroup sdev Storage devices.
@@ -138,6 +139,20 @@ struct m0_storage_devs {
 	struct m0_parallel_pool  sds_pool;
 	/** Use directio for linuxstob domains. */
 	bool                     sds_use_directio;
+	/** Use io_uring for linuxstob domains. */
+	bool                     sds_use_uring;
+	/** Poll io_uring submission queues of linuxstob domains. */
+	bool                     sds_uring_sqpoll;
+	/** Worker threads per device queue of linuxstob domains. */
+	uint32_t                 sds_ioq_threads;
+	/** Ring buffer slots per device queue of linuxstob domains. */
+	uint32_t                 sds_ioq_ring_size;
+	/**
+	 * Buffers registered by m0_storage_devs_buffers_register(). They are
+	 * registered with linuxstob devices attached later as well.
+	 */
+	struct iovec            *sds_bufs;
+	unsigned                 sds_bufs_nr;
 
 	/* Conf event callbacks provisioning. */
 
@@ -184,6 +199,43 @@ M0_INTERNAL void m0_storage_devs_unlock(struct m0_storage_devs *devs);
 M0_INTERNAL void m0_storage_devs_use_directio(struct m0_storage_devs *devs,
 					      bool                    directio);
 
+/**
+ * Makes linuxstob domains of devices use io_uring ("ioq=uring") and
+ * optionally kernel-side submission queue polling ("sqpoll=true").
+ *
+ * The backing store domain of AD devices is configured by its creator.
+ *
+ * @pre storage_dev_tlist_is_empty(&devs->sds_devices)
+ */
+M0_INTERNAL void m0_storage_devs_use_uring(struct m0_storage_devs *devs,
+					   bool                    uring,
+					   bool                    sqpoll);
+
+/**
+ * Sets the number of worker threads and ring buffer slots of each device
+ * queue of linuxstob domains ("ioq_threads=N ioq_ring=N"), 0 for defaults.
+ *
+ * @pre storage_dev_tlist_is_empty(&devs->sds_devices)
+ */
+M0_INTERNAL void m0_storage_devs_ioq_size(struct m0_storage_devs *devs,
+					  uint32_t                nr_threads,
+					  uint32_t                ring_size);
+
+/**
+ * Registers long-living I/O buffers with I/O queues of the storage: the
+ * backing store domain of AD devices or domains of linuxstob devices.
+ *
+ * @pre nr <= M0_STOB_IOQ_URING_BUFS_MAX
+ * @pre devs->sds_bufs == NULL
+ * @see m0_stob_ioq_buffers_register()
+ */
+M0_INTERNAL int m0_storage_devs_buffers_register(struct m0_storage_devs *devs,
+						 const struct iovec     *bufs,
+						 unsigned                nr);
+/** Unregisters buffers registered by m0_storage_devs_buffers_register(). */
+M0_INTERNAL void
+m0_storage_devs_buffers_unregister(struct m0_storage_devs *devs);
+
 /** Disable sdev locks. Use case: 1+0+0 configuration. */
 M0_INTERNAL void m0_storage_devs_locks_disable(struct m0_storage_devs *devs);
 
@@ -0,0 +1,231 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include "lib/avl.h"
+#include "lib/assert.h"
+#include "lib/arith.h"   /* max_check */
+#include "lib/misc.h"    /* NULL */
+
+/**
+   @addtogroup avl
+
+   @{
+ */
+
+static int avl_height(const struct m0_avl_link *link)
+{
+	return link == NULL ? 0 : link->al_height;
+}
+
+static int avl_balance(const struct m0_avl_link *link)
+{
+	return avl_height(link->al_child[0]) - avl_height(link->al_child[1]);
+}
+
+static void avl_height_update(struct m0_avl_link *link)
+{
+	link->al_height = max_check(avl_height(link->al_child[0]),
+				    avl_height(link->al_child[1])) + 1;
+}
+
+/** The last element of the subtree in direction @dir (0 - left, 1 - right). */
+static struct m0_avl_link *avl_end(struct m0_avl_link *link, int dir)
+{
+	while (link != NULL && link->al_child[dir] != NULL)
+		link = link->al_child[dir];
+	return link;
+}
+
+/** Replaces subtree @link with subtree @with in the parent of @link. */
+static void avl_transplant(struct m0_avl      *avl,
+			   struct m0_avl_link *link,
+			   struct m0_avl_link *with)
+{
+	struct m0_avl_link *parent = link->al_parent;
+
+	if (parent == NULL)
+		avl->a_root = with;
+	else
+		parent->al_child[parent->al_child[1] == link] = with;
+	if (with != NULL)
+		with->al_parent = parent;
+}
+
+/**
+ * Rotates subtree @link in direction @dir (0 - left, 1 - right).
+ *
+ * @return new root of the subtree.
+ */
+static struct m0_avl_link *avl_rotate(struct m0_avl      *avl,
+				      struct m0_avl_link *link,
+				      int                 dir)
+{
+	struct m0_avl_link *pivot = link->al_child[!dir];
+
+	link->al_child[!dir] = pivot->al_child[dir];
+	if (link->al_child[!dir] != NULL)
+		link->al_child[!dir]->al_parent = link;
+	avl_transplant(avl, link, pivot);
+	pivot->al_child[dir] = link;
+	link->al_parent      = pivot;
+	avl_height_update(link);
+	avl_height_update(pivot);
+	return pivot;
+}
+
+/** Restores the balance on the path from @link to the root. */
+static void avl_rebalance(struct m0_avl *avl, struct m0_avl_link *link)
+{
+	int balance;
+
+	for (; link != NULL; link = link->al_parent) {
+		avl_height_update(link);
+		balance = avl_balance(link);
+		if (balance > 1) {
+			if (avl_balance(link->al_child[0]) < 0)
+				avl_rotate(avl, link->al_child[0], 0);
+			link = avl_rotate(avl, link, 1);
+		} else if (balance < -1) {
+			if (avl_balance(link->al_child[1]) > 0)
+				avl_rotate(avl, link->al_child[1], 1);
+			link = avl_rotate(avl, link, 0);
+		}
+	}
+}
+
+M0_INTERNAL void m0_avl_init(struct m0_avl *avl)
+{
+	avl->a_root = NULL;
+}
+
+M0_INTERNAL bool m0_avl_is_empty(const struct m0_avl *avl)
+{
+	return avl->a_root == NULL;
+}
+
+M0_INTERNAL void m0_avl_insert(struct m0_avl      *avl,
+			       struct m0_avl_link *link,
+			       struct m0_avl_link *parent,
+			       int                 dir)
+{
+	M0_PRE(M0_IN(dir, (0, 1)));
+	M0_PRE(parent == NULL ? avl->a_root == NULL :
+				parent->al_child[dir] == NULL);
+
+	*link = (struct m0_avl_link){
+		.al_parent = parent,
+		.al_height = 1,
+	};
+	if (parent == NULL)
+		avl->a_root = link;
+	else
+		parent->al_child[dir] = link;
+	avl_rebalance(avl, parent);
+}
+
+M0_INTERNAL void m0_avl_delete(struct m0_avl *avl, struct m0_avl_link *link)
+{
+	struct m0_avl_link *next;
+	struct m0_avl_link *start;
+
+	M0_PRE(!m0_avl_is_empty(avl));
+
+	if (link->al_child[0] != NULL && link->al_child[1] != NULL) {
+		/* next is the leftmost element in the right subtree */
+		next  = avl_end(link->al_child[1], 0);
+		start = next->al_parent == link ? next : next->al_parent;
+		if (next->al_parent != link) {
+			avl_transplant(avl, next, next->al_child[1]);
+			next->al_child[1] = link->al_child[1];
+			next->al_child[1]->al_parent = next;
+		}
+		avl_transplant(avl, link, next);
+		next->al_child[0] = link->al_child[0];
+		next->al_child[0]->al_parent = next;
+	} else {
+		start = link->al_parent;
+		avl_transplant(avl, link, link->al_child[0] ?:
+					  link->al_child[1]);
+	}
+	avl_rebalance(avl, start);
+}
+
+M0_INTERNAL struct m0_avl_link *m0_avl_first(const struct m0_avl *avl)
+{
+	return avl_end(avl->a_root, 0);
+}
+
+M0_INTERNAL struct m0_avl_link *m0_avl_last(const struct m0_avl *avl)
+{
+	return avl_end(avl->a_root, 1);
+}
+
+M0_INTERNAL struct m0_avl_link *m0_avl_next(struct m0_avl_link *link)
+{
+	struct m0_avl_link *parent;
+
+	if (link->al_child[1] != NULL)
+		return avl_end(link->al_child[1], 0);
+	parent = link->al_parent;
+	while (parent != NULL && link == parent->al_child[1]) {
+		link   = parent;
+		parent = link->al_parent;
+	}
+	return parent;
+}
+
+M0_INTERNAL bool m0_avl_link_invariant(const struct m0_avl_link *link)
+{
+	const struct m0_avl_link *left  = link->al_child[0];
+	const struct m0_avl_link *right = link->al_child[1];
+
+	return _0C(ergo(left  != NULL, left->al_parent  == link)) &&
+	       _0C(ergo(right != NULL, right->al_parent == link)) &&
+	       _0C(link->al_height ==
+		   max_check(avl_height(left), avl_height(right)) + 1) &&
+	       _0C(M0_IN(avl_balance(link), (-1, 0, 1)));
+}
+
+M0_INTERNAL bool m0_avl_invariant(const struct m0_avl *avl)
+{
+	struct m0_avl_link *link;
+
+	if (!_0C(ergo(avl->a_root != NULL, avl->a_root->al_parent == NULL)))
+		return false;
+	for (link = m0_avl_first(avl); link != NULL; link = m0_avl_next(link)) {
+		if (!m0_avl_link_invariant(link))
+			return false;
+	}
+	return true;
+}
+
+/** @} end of avl group */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
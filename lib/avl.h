@@ -0,0 +1,115 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#pragma once
+
+#ifndef __MOTR_LIB_AVL_H__
+#define __MOTR_LIB_AVL_H__
+
+#include "lib/types.h"
+
+/**
+   @defgroup avl AVL tree
+
+   Intrusive AVL tree. A tree element embeds struct m0_avl_link, an element
+   that is ordered in several ways embeds one link per tree.
+
+   The tree does not know the ordering of its elements: the user finds the
+   place of a new element and does lookups by descending the tree from
+   m0_avl::a_root through m0_avl_link::al_child[], comparing the keys of the
+   elements itself, as in
+
+   @code
+   struct m0_avl_link *parent = NULL;
+   struct m0_avl_link *link;
+   int                 dir = 0;
+
+   for (link = avl->a_root; link != NULL; link = link->al_child[dir]) {
+	   parent = link;
+	   dir    = key_of(link) < key_of(new);
+   }
+   m0_avl_insert(avl, new, parent, dir);
+   @endcode
+
+   Insertion and deletion take O(log(n)) time, m0_avl_next() takes amortised
+   O(1) time. Elements are not allocated or freed by the tree. Concurrency
+   control is up to the user.
+
+   @{
+ */
+
+/** Link embedded in a tree element. */
+struct m0_avl_link {
+	struct m0_avl_link *al_parent;
+	/** Left and right children. */
+	struct m0_avl_link *al_child[2];
+	/** Height of the subtree. */
+	int                 al_height;
+};
+
+/** AVL tree. */
+struct m0_avl {
+	struct m0_avl_link *a_root;
+};
+
+M0_INTERNAL void m0_avl_init(struct m0_avl *avl);
+M0_INTERNAL bool m0_avl_is_empty(const struct m0_avl *avl);
+
+/**
+   Links @link as the child @dir (0 - left, 1 - right) of @parent, which has no
+   such child, or as the root of empty @avl if @parent is NULL, and restores
+   the balance of the tree.
+ */
+M0_INTERNAL void m0_avl_insert(struct m0_avl      *avl,
+			       struct m0_avl_link *link,
+			       struct m0_avl_link *parent,
+			       int                 dir);
+/** Removes @link from @avl and restores the balance of the tree. */
+M0_INTERNAL void m0_avl_delete(struct m0_avl *avl, struct m0_avl_link *link);
+
+/** Returns the leftmost element of @avl or NULL if @avl is empty. */
+M0_INTERNAL struct m0_avl_link *m0_avl_first(const struct m0_avl *avl);
+/** Returns the rightmost element of @avl or NULL if @avl is empty. */
+M0_INTERNAL struct m0_avl_link *m0_avl_last(const struct m0_avl *avl);
+/** Returns the in-order successor of @link or NULL. */
+M0_INTERNAL struct m0_avl_link *m0_avl_next(struct m0_avl_link *link);
+
+/**
+   Checks the parent links of the children of @link, its height and balance.
+   Checking the whole tree is O(n), see m0_avl_invariant().
+ */
+M0_INTERNAL bool m0_avl_link_invariant(const struct m0_avl_link *link);
+/** Checks the root and m0_avl_link_invariant() of every element. */
+M0_INTERNAL bool m0_avl_invariant(const struct m0_avl *avl);
+
+/** @} end of avl group */
+#endif /* __MOTR_LIB_AVL_H__ */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
@@ -0,0 +1,294 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+/**
+ * @addtogroup crc32c
+ *
+ * @{
+ */
+
+#define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_LIB
+#include "lib/trace.h"
+
+#include "lib/crc32c.h"
+#include "lib/byteorder.h"      /* m0_byteorder_le64_to_cpu */
+#include "lib/misc.h"           /* memcpy */
+#include "motr/config.h"        /* CONFIG_X86_64 */
+
+#ifdef CONFIG_X86_64
+#  include <nmmintrin.h>        /* _mm_crc32_u64 */
+#endif
+
+enum {
+	/** Reflected CRC32C polynomial. */
+	CRC32C_POLY  = 0x82f63b78,
+	/** Stream length for the large buffers. */
+	CRC32C_LONG  = 8192,
+	/** Stream length for the buffers smaller than 3 * CRC32C_LONG. */
+	CRC32C_SHORT = 256,
+};
+
+/** Slicing-by-8 tables for m0_crc32c_sw(). */
+static uint32_t crc32c_table[8][256];
+/** Operators appending CRC32C_LONG and CRC32C_SHORT zeroes to a checksum. */
+static uint32_t crc32c_long[4][256];
+static uint32_t crc32c_short[4][256];
+static bool     crc32c_hw;
+
+/*
+ * Zeroes operators. Appending n zero bytes to a message is a linear
+ * operation on the checksum, it's represented by a 32x32 matrix over GF(2),
+ * which is then unrolled into 4 byte-indexed tables.
+ */
+
+static uint32_t crc32c_gf2_times(const uint32_t *mat, uint32_t vec)
+{
+	uint32_t sum = 0;
+
+	for (; vec != 0; vec >>= 1, mat++) {
+		if (vec & 1)
+			sum ^= *mat;
+	}
+	return sum;
+}
+
+static void crc32c_gf2_square(uint32_t *square, const uint32_t *mat)
+{
+	int i;
+
+	for (i = 0; i < 32; ++i)
+		square[i] = crc32c_gf2_times(mat, mat[i]);
+}
+
+static void crc32c_gf2_mul(uint32_t *mat, const uint32_t *left)
+{
+	uint32_t prod[32];
+	int      i;
+
+	for (i = 0; i < 32; ++i)
+		prod[i] = crc32c_gf2_times(left, mat[i]);
+	memcpy(mat, prod, sizeof prod);
+}
+
+/**
+ * Builds the operator appending nr zero bytes. It is the product of the
+ * operators appending 2^k bytes for every bit k set in nr.
+ */
+static void crc32c_zeroes_op(uint32_t *op, m0_bcount_t nr)
+{
+	uint32_t pow[32];
+	uint32_t square[32];
+	int      i;
+
+	/* Operator for one zero bit. */
+	pow[0] = CRC32C_POLY;
+	for (i = 1; i < 32; ++i)
+		pow[i] = 1U << (i - 1);
+	/* Square to 2, 4 and 8 bits, i.e. one byte. */
+	for (i = 0; i < 3; ++i) {
+		crc32c_gf2_square(square, pow);
+		memcpy(pow, square, sizeof square);
+	}
+	/* Identity. */
+	for (i = 0; i < 32; ++i)
+		op[i] = 1U << i;
+	for (; nr != 0; nr >>= 1) {
+		if (nr & 1)
+			crc32c_gf2_mul(op, pow);
+		if (nr > 1) {
+			crc32c_gf2_square(square, pow);
+			memcpy(pow, square, sizeof square);
+		}
+	}
+}
+
+static void crc32c_zeroes(uint32_t zeroes[4][256], m0_bcount_t nr)
+{
+	uint32_t op[32];
+	uint32_t n;
+
+	crc32c_zeroes_op(op, nr);
+	for (n = 0; n < 256; ++n) {
+		zeroes[0][n] = crc32c_gf2_times(op, n);
+		zeroes[1][n] = crc32c_gf2_times(op, n << 8);
+		zeroes[2][n] = crc32c_gf2_times(op, n << 16);
+		zeroes[3][n] = crc32c_gf2_times(op, n << 24);
+	}
+}
+
+static uint32_t crc32c_shift(uint32_t zeroes[4][256], uint32_t crc)
+{
+	return zeroes[0][crc & 0xff] ^ zeroes[1][(crc >> 8) & 0xff] ^
+	       zeroes[2][(crc >> 16) & 0xff] ^ zeroes[3][crc >> 24];
+}
+
+M0_INTERNAL uint32_t m0_crc32c_sw(uint32_t crc, const void *buf,
+				  m0_bcount_t size)
+{
+	const uint8_t *p = buf;
+	uint64_t       w;
+
+	crc = ~crc;
+	for (; size > 0 && ((uintptr_t)p & 7) != 0; --size)
+		crc = crc32c_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+	for (; size >= 8; size -= 8, p += 8) {
+		memcpy(&w, p, sizeof w);
+		w = m0_byteorder_le64_to_cpu(w) ^ crc;
+		crc = crc32c_table[7][w & 0xff] ^
+		      crc32c_table[6][(w >> 8) & 0xff] ^
+		      crc32c_table[5][(w >> 16) & 0xff] ^
+		      crc32c_table[4][(w >> 24) & 0xff] ^
+		      crc32c_table[3][(w >> 32) & 0xff] ^
+		      crc32c_table[2][(w >> 40) & 0xff] ^
+		      crc32c_table[1][(w >> 48) & 0xff] ^
+		      crc32c_table[0][w >> 56];
+	}
+	for (; size > 0; --size)
+		crc = crc32c_table[0][(crc ^ *p++) & 0xff] ^ (crc >> 8);
+	return ~crc;
+}
+
+#ifdef CONFIG_X86_64
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_hw_streams(uint32_t crc0, const uint8_t **next,
+				  m0_bcount_t *size, m0_bcount_t len,
+				  uint32_t zeroes[4][256])
+{
+	const uint8_t *p = *next;
+	const uint8_t *end;
+	uint64_t       crc1;
+	uint64_t       crc2;
+	uint64_t       w[3];
+
+	while (*size >= 3 * len) {
+		crc1 = 0;
+		crc2 = 0;
+		for (end = p + len; p < end; p += 8) {
+			memcpy(w, p, sizeof w[0]);
+			memcpy(&w[1], p + len, sizeof w[1]);
+			memcpy(&w[2], p + 2 * len, sizeof w[2]);
+			crc0 = _mm_crc32_u64(crc0, w[0]);
+			crc1 = _mm_crc32_u64(crc1, w[1]);
+			crc2 = _mm_crc32_u64(crc2, w[2]);
+		}
+		crc0 = crc32c_shift(zeroes, crc0) ^ crc1;
+		crc0 = crc32c_shift(zeroes, crc0) ^ crc2;
+		p     += 2 * len;
+		*size -= 3 * len;
+	}
+	*next = p;
+	return crc0;
+}
+
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_hw_calc(uint32_t crc, const void *buf, m0_bcount_t size)
+{
+	const uint8_t *p    = buf;
+	uint64_t       crc0 = ~crc;
+	uint64_t       w;
+
+	for (; size > 0 && ((uintptr_t)p & 7) != 0; --size)
+		crc0 = _mm_crc32_u8(crc0, *p++);
+	crc0 = crc32c_hw_streams(crc0, &p, &size, CRC32C_LONG, crc32c_long);
+	crc0 = crc32c_hw_streams(crc0, &p, &size, CRC32C_SHORT, crc32c_short);
+	for (; size >= 8; size -= 8, p += 8) {
+		memcpy(&w, p, sizeof w);
+		crc0 = _mm_crc32_u64(crc0, w);
+	}
+	for (; size > 0; --size)
+		crc0 = _mm_crc32_u8(crc0, *p++);
+	return ~(uint32_t)crc0;
+}
+#endif
+
+M0_INTERNAL uint32_t m0_crc32c(uint32_t crc, const void *buf, m0_bcount_t size)
+{
+#ifdef CONFIG_X86_64
+	if (crc32c_hw)
+		return crc32c_hw_calc(crc, buf, size);
+#endif
+	return m0_crc32c_sw(crc, buf, size);
+}
+
+M0_INTERNAL uint32_t m0_crc32c_combine(uint32_t crc0, uint32_t crc1,
+				       m0_bcount_t size1)
+{
+	uint32_t op[32];
+
+	crc32c_zeroes_op(op, size1);
+	return crc32c_gf2_times(op, crc0) ^ crc1;
+}
+
+M0_INTERNAL bool m0_crc32c_is_hw(void)
+{
+	return crc32c_hw;
+}
+
+M0_INTERNAL int m0_crc32c_init(void)
+{
+	uint32_t crc;
+	uint32_t n;
+	int      i;
+	int      k;
+
+	for (n = 0; n < 256; ++n) {
+		crc = n;
+		for (k = 0; k < 8; ++k)
+			crc = crc & 1 ? (crc >> 1) ^ CRC32C_POLY : crc >> 1;
+		crc32c_table[0][n] = crc;
+	}
+	for (n = 0; n < 256; ++n) {
+		crc = crc32c_table[0][n];
+		for (i = 1; i < 8; ++i) {
+			crc = crc32c_table[0][crc & 0xff] ^ (crc >> 8);
+			crc32c_table[i][n] = crc;
+		}
+	}
+#ifdef CONFIG_X86_64
+	crc32c_zeroes(crc32c_long, CRC32C_LONG);
+	crc32c_zeroes(crc32c_short, CRC32C_SHORT);
+	__builtin_cpu_init();
+	crc32c_hw = __builtin_cpu_supports("sse4.2");
+#endif
+	M0_LOG(M0_DEBUG, "hw=%d", !!crc32c_hw);
+	return 0;
+}
+
+M0_INTERNAL void m0_crc32c_fini(void)
+{
+}
+
+/** @} end of crc32c group */
+#undef M0_TRACE_SUBSYSTEM
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -0,0 +1,91 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#pragma once
+
+#ifndef __MOTR_LIB_CRC32C_H__
+#define __MOTR_LIB_CRC32C_H__
+
+/**
+ * @defgroup crc32c CRC32C
+ *
+ * CRC-32C (Castagnoli) checksum of memory buffers.
+ *
+ * SSE4.2 crc32 instruction is used when the processor supports it (checked
+ * once in m0_crc32c_init()), slicing-by-8 table implementation is used
+ * otherwise. Both give the same result.
+ *
+ * Hardware implementation checksums 3 interleaved streams of a large buffer
+ * to hide latency of the crc32 instruction and then combines the stream
+ * checksums using precomputed "append zeroes" operators.
+ *
+ * Checksum can be computed incrementally:
+ * @code
+ * crc = m0_crc32c(0, buf0, size0);
+ * crc = m0_crc32c(crc, buf1, size1);
+ * @endcode
+ * gives the same result as a single call for concatenated buffers.
+ *
+ * @{
+ */
+
+#include "lib/types.h"
+
+/**
+ * Returns CRC32C of buf[0, size) continuing from checksum crc.
+ * Initial value of crc is 0.
+ */
+M0_INTERNAL uint32_t m0_crc32c(uint32_t crc, const void *buf, m0_bcount_t size);
+
+/** Table implementation of m0_crc32c(). Exported for testing. */
+M0_INTERNAL uint32_t m0_crc32c_sw(uint32_t crc, const void *buf,
+				  m0_bcount_t size);
+
+/**
+ * Returns CRC32C of the concatenation of two buffers, given crc0, the checksum
+ * of the first buffer, and crc1 and size1, the checksum and size of the
+ * second one. This allows the buffers to be checksummed independently.
+ */
+M0_INTERNAL uint32_t m0_crc32c_combine(uint32_t crc0, uint32_t crc1,
+				       m0_bcount_t size1);
+
+/** Returns true iff m0_crc32c() uses hardware implementation. */
+M0_INTERNAL bool m0_crc32c_is_hw(void);
+
+M0_INTERNAL int  m0_crc32c_init(void);
+M0_INTERNAL void m0_crc32c_fini(void);
+
+/** @} end of crc32c group */
+#endif /* __MOTR_LIB_CRC32C_H__ */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -0,0 +1,243 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+/**
+ * @addtogroup lz
+ *
+ * @{
+ */
+
+#define M0_TRACE_SUBSYSTEM M0_TRACE_SUBSYS_LIB
+#include "lib/trace.h"
+
+#include "lib/lz.h"
+#include "lib/arith.h"          /* min_check */
+#include "lib/errno.h"          /* EPROTO */
+#include "lib/misc.h"           /* memcpy, memset */
+
+enum {
+	LZ_MINMATCH     = 4,
+	/* The last LZ_LASTLITERALS bytes are always literals. */
+	LZ_LASTLITERALS = 5,
+	/* The last match starts at least LZ_MFLIMIT bytes before the end. */
+	LZ_MFLIMIT      = 12,
+	LZ_DISTANCE_MAX = 0xffff,
+	LZ_RUN_MASK     = 0xf,
+	/* Search step grows after every 2^LZ_SKIP_SHIFT misses in a row. */
+	LZ_SKIP_SHIFT   = 6,
+};
+
+static uint32_t lz_read32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof v);
+	return v;
+}
+
+static uint32_t lz_hash(uint32_t v)
+{
+	return (v * 2654435761U) >> (32 - M0_LZ_HASH_LOG);
+}
+
+/* Length of the extension bytes for a length field. */
+static m0_bcount_t lz_len_size(m0_bcount_t len)
+{
+	return len < LZ_RUN_MASK ? 0 : (len - LZ_RUN_MASK) / 0xff + 1;
+}
+
+static uint8_t *lz_len_put(uint8_t *op, m0_bcount_t len)
+{
+	if (len >= LZ_RUN_MASK) {
+		for (len -= LZ_RUN_MASK; len >= 0xff; len -= 0xff)
+			*op++ = 0xff;
+		*op++ = len;
+	}
+	return op;
+}
+
+static int lz_len_get(const uint8_t **ip, const uint8_t *iend,
+		      m0_bcount_t *len)
+{
+	uint8_t b;
+
+	if (*len == LZ_RUN_MASK) {
+		do {
+			if (*ip >= iend)
+				return M0_ERR(-EPROTO);
+			b = *(*ip)++;
+			*len += b;
+		} while (b == 0xff);
+	}
+	return 0;
+}
+
+M0_INTERNAL m0_bcount_t m0_lz_compress_bound(m0_bcount_t size)
+{
+	return size + size / 0xff + 16;
+}
+
+/* Puts a sequence. Returns NULL if it doesn't fit before oend. */
+static uint8_t *lz_sequence_put(uint8_t *op, uint8_t *oend,
+				const uint8_t *literals, m0_bcount_t lit_len,
+				m0_bcount_t offset, m0_bcount_t match_len)
+{
+	uint8_t *token = op;
+
+	if (oend - op < 1 + lz_len_size(lit_len) + lit_len +
+			(offset == 0 ? 0 : 2 + lz_len_size(match_len)))
+		return NULL;
+	*token = min_check(lit_len, (m0_bcount_t)LZ_RUN_MASK) << 4;
+	op = lz_len_put(op + 1, lit_len);
+	memcpy(op, literals, lit_len);
+	op += lit_len;
+	if (offset != 0) {
+		*op++ = offset & 0xff;
+		*op++ = offset >> 8;
+		*token |= min_check(match_len, (m0_bcount_t)LZ_RUN_MASK);
+		op = lz_len_put(op, match_len);
+	}
+	return op;
+}
+
+M0_INTERNAL m0_bcount_t m0_lz_compress(struct m0_lz_ctx *ctx,
+				       const void       *src,
+				       m0_bcount_t       size,
+				       void             *dst,
+				       m0_bcount_t       dst_size)
+{
+	const uint8_t *base    = src;
+	const uint8_t *iend    = base + size;
+	const uint8_t *mflimit = size < LZ_MFLIMIT ? base : iend - LZ_MFLIMIT;
+	const uint8_t *mlimit  = iend - min_check(size,
+						  (m0_bcount_t)LZ_LASTLITERALS);
+	const uint8_t *anchor  = base;
+	const uint8_t *ip      = base + 1;
+	const uint8_t *ref;
+	const uint8_t *m;
+	uint8_t       *op      = dst;
+	uint8_t       *oend    = op + dst_size;
+	uint32_t       h;
+	uint32_t       miss    = 0;
+
+	M0_PRE(size < UINT32_MAX);
+
+	memset(ctx->lc_table, 0, sizeof ctx->lc_table);
+	while (ip < mflimit) {
+		h   = lz_hash(lz_read32(ip));
+		ref = base + ctx->lc_table[h];
+		ctx->lc_table[h] = ip - base;
+		if (ref >= ip || ip - ref > LZ_DISTANCE_MAX ||
+		    lz_read32(ref) != lz_read32(ip)) {
+			ip += 1 + (miss++ >> LZ_SKIP_SHIFT);
+			continue;
+		}
+		miss = 0;
+		while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+			--ip;
+			--ref;
+		}
+		m = ip + LZ_MINMATCH;
+		while (m < mlimit && *m == ref[m - ip])
+			++m;
+		op = lz_sequence_put(op, oend, anchor, ip - anchor, ip - ref,
+				     m - ip - LZ_MINMATCH);
+		if (op == NULL)
+			return 0;
+		ip = anchor = m;
+	}
+	op = lz_sequence_put(op, oend, anchor, iend - anchor, 0, 0);
+	return op == NULL ? 0 : op - (uint8_t *)dst;
+}
+
+M0_INTERNAL int m0_lz_decompress(const void  *src,
+				 m0_bcount_t  size,
+				 void        *dst,
+				 m0_bcount_t  dst_size,
+				 m0_bcount_t *out)
+{
+	const uint8_t *ip   = src;
+	const uint8_t *iend = ip + size;
+	const uint8_t *ref;
+	uint8_t       *op   = dst;
+	uint8_t       *oend = op + dst_size;
+	m0_bcount_t    offset;
+	m0_bcount_t    len;
+	uint8_t        token;
+	int            rc;
+
+	while (ip < iend) {
+		token = *ip++;
+		len = token >> 4;
+		rc = lz_len_get(&ip, iend, &len);
+		if (rc != 0)
+			return M0_RC(rc);
+		if (len > iend - ip || len > oend - op)
+			return M0_ERR(-EPROTO);
+		memcpy(op, ip, len);
+		op += len;
+		ip += len;
+		/* the last sequence has literals only */
+		if (ip == iend)
+			break;
+		if (iend - ip < 2)
+			return M0_ERR(-EPROTO);
+		offset = ip[0] | ip[1] << 8;
+		ip += 2;
+		if (offset == 0 || offset > op - (uint8_t *)dst)
+			return M0_ERR(-EPROTO);
+		len = token & LZ_RUN_MASK;
+		rc = lz_len_get(&ip, iend, &len);
+		if (rc != 0)
+			return M0_RC(rc);
+		len += LZ_MINMATCH;
+		if (len > oend - op)
+			return M0_ERR(-EPROTO);
+		ref = op - offset;
+		if (offset >= len) {
+			memcpy(op, ref, len);
+			op += len;
+		} else {
+			/* overlapping match repeats the last offset bytes */
+			while (len-- > 0)
+				*op++ = *ref++;
+		}
+	}
+	*out = op - (uint8_t *)dst;
+	return 0;
+}
+
+/** @} end of lz group */
+#undef M0_TRACE_SUBSYSTEM
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
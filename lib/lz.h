@@ -0,0 +1,97 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#pragma once
+
+#ifndef __MOTR_LIB_LZ_H__
+#define __MOTR_LIB_LZ_H__
+
+/**
+ * @defgroup lz LZ compression
+ *
+ * Fast LZ77-class compression of memory buffers. Compressed data use LZ4
+ * block format: a sequence of (literals, match) pairs with 16-bit match
+ * offsets. Compression speed is favoured over compression ratio, only one
+ * match candidate is checked for every position.
+ *
+ * The decompressor checks all lengths and offsets against the source and
+ * destination buffers, so corrupted input results in an error and never in
+ * a buffer overrun.
+ *
+ * @{
+ */
+
+#include "lib/types.h"
+
+enum {
+	/** log2 of the number of entries in the match finder hash table. */
+	M0_LZ_HASH_LOG = 12,
+};
+
+/** Compressor state. It's too large to be allocated on stack. */
+struct m0_lz_ctx {
+	uint32_t lc_table[1 << M0_LZ_HASH_LOG];
+};
+
+/** Maximum compressed size of a buffer of the given size. */
+M0_INTERNAL m0_bcount_t m0_lz_compress_bound(m0_bcount_t size);
+
+/**
+ * Compresses src[0, size) into dst[0, dst_size).
+ *
+ * @pre size < UINT32_MAX
+ * @return compressed size, 0 if the result doesn't fit into dst_size bytes.
+ */
+M0_INTERNAL m0_bcount_t m0_lz_compress(struct m0_lz_ctx *ctx,
+				       const void       *src,
+				       m0_bcount_t       size,
+				       void             *dst,
+				       m0_bcount_t       dst_size);
+
+/**
+ * Decompresses src[0, size) into dst[0, dst_size).
+ *
+ * @param out decompressed size is returned here.
+ * @return -EPROTO if src is not valid compressed data or if the result
+ *         doesn't fit into dst_size bytes.
+ */
+M0_INTERNAL int m0_lz_decompress(const void  *src,
+				 m0_bcount_t  size,
+				 void        *dst,
+				 m0_bcount_t  dst_size,
+				 m0_bcount_t *out);
+
+/** @} end of lz group */
+#endif /* __MOTR_LIB_LZ_H__ */
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -0,0 +1,131 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include "ut/ut.h"
+#include "lib/avl.h"
+#include "lib/misc.h"   /* container_of */
+#include "lib/arith.h"  /* m0_rnd64 */
+
+struct at {
+	struct m0_avl_link t_link;
+	uint64_t           t_key;
+	bool               t_in;
+};
+
+enum {
+	NR = 1000
+};
+
+static struct at elems[NR];
+
+static struct at *at_of(struct m0_avl_link *link)
+{
+	return link == NULL ? NULL : container_of(link, struct at, t_link);
+}
+
+static void at_insert(struct m0_avl *avl, struct at *t)
+{
+	struct m0_avl_link *parent = NULL;
+	struct m0_avl_link *link;
+	int                 dir = 0;
+
+	for (link = avl->a_root; link != NULL; link = link->al_child[dir]) {
+		parent = link;
+		dir    = at_of(link)->t_key < t->t_key;
+	}
+	m0_avl_insert(avl, &t->t_link, parent, dir);
+	t->t_in = true;
+}
+
+/* Checks the balance and that the tree holds the inserted elements in order. */
+static void at_check(struct m0_avl *avl)
+{
+	struct m0_avl_link *link;
+	struct at          *prev = NULL;
+	int                 nr = 0;
+	int                 height;
+
+	M0_UT_ASSERT(m0_avl_invariant(avl));
+	for (link = m0_avl_first(avl); link != NULL; link = m0_avl_next(link)) {
+		M0_UT_ASSERT(at_of(link)->t_in);
+		M0_UT_ASSERT(ergo(prev != NULL,
+				  prev->t_key < at_of(link)->t_key));
+		prev = at_of(link);
+		++nr;
+	}
+	M0_UT_ASSERT(at_of(m0_avl_last(avl)) == prev);
+	M0_UT_ASSERT(nr == m0_count(i, NR, elems[i].t_in));
+	M0_UT_ASSERT(equi(nr == 0, m0_avl_is_empty(avl)));
+	/* AVL tree of n elements is not higher than 1.44 * log2(n + 2). */
+	height = avl->a_root == NULL ? 0 : avl->a_root->al_height;
+	M0_UT_ASSERT(height * 100 <= 144 * (m0_log2(nr + 2) + 1));
+}
+
+void test_avl(void)
+{
+	struct m0_avl avl;
+	uint64_t      seed = 42;
+	int           i;
+
+	m0_avl_init(&avl);
+	at_check(&avl);
+	/* Ascending keys make the worst case for an unbalanced tree. */
+	for (i = 0; i < NR / 2; ++i) {
+		elems[i].t_key = 2 * i;
+		at_insert(&avl, &elems[i]);
+	}
+	at_check(&avl);
+	for (i = NR / 2; i < NR; ++i) {
+		elems[i].t_key = 2 * (m0_rnd64(&seed) % (NR / 2)) + 1;
+		if (m0_exists(j, i, elems[j].t_in &&
+				      elems[j].t_key == elems[i].t_key))
+			continue;
+		at_insert(&avl, &elems[i]);
+	}
+	at_check(&avl);
+	/* Delete every other element, then the rest. */
+	for (i = 0; i < NR; i += 2) {
+		if (elems[i].t_in) {
+			m0_avl_delete(&avl, &elems[i].t_link);
+			elems[i].t_in = false;
+		}
+	}
+	at_check(&avl);
+	for (i = 1; i < NR; i += 2) {
+		if (elems[i].t_in) {
+			m0_avl_delete(&avl, &elems[i].t_link);
+			elems[i].t_in = false;
+		}
+	}
+	at_check(&avl);
+	M0_UT_ASSERT(m0_avl_is_empty(&avl));
+}
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
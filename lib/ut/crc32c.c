@@ -0,0 +1,111 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+
+#include "ut/ut.h"         /* M0_UT_ASSERT */
+#include "lib/crc32c.h"
+#include "lib/arith.h"     /* m0_rnd64 */
+#include "lib/memory.h"    /* m0_alloc */
+#include "lib/misc.h"      /* ARRAY_SIZE */
+
+enum {
+	CRC32C_UT_SIZE = 1 << 17,
+	CRC32C_UT_ITER = 0x200,
+	CRC32C_UT_DATA = 1000,
+};
+
+/** Padding sizes, hardware implementation uses 8192 and 256 byte streams. */
+static const m0_bcount_t pad[] = { 1, 3, 7, 255, 257, 1000, 4097, 8191,
+				   12345, 3 * 8192 + 5 };
+
+void test_crc32c(void)
+{
+	static const char  check[] = "123456789";
+	uint64_t           seed = 17;
+	m0_bcount_t        size;
+	m0_bcount_t        off;
+	m0_bcount_t        cut;
+	uint32_t           crc;
+	uint8_t           *buf;
+	int                i;
+
+	/* Well-known check values. */
+	M0_UT_ASSERT(m0_crc32c(0, check, sizeof check - 1) == 0xe3069283);
+	M0_UT_ASSERT(m0_crc32c_sw(0, check, sizeof check - 1) == 0xe3069283);
+	M0_UT_ASSERT(m0_crc32c(0, check, 0) == 0);
+
+	buf = m0_alloc(CRC32C_UT_SIZE);
+	M0_UT_ASSERT(buf != NULL);
+	for (i = 0; i < CRC32C_UT_SIZE; ++i)
+		buf[i] = m0_rnd64(&seed);
+	/*
+	 * Hardware and table implementations give the same result for any
+	 * alignment and size, and the checksum can be computed incrementally.
+	 */
+	for (i = 0; i < CRC32C_UT_ITER; ++i) {
+		off  = m0_rnd64(&seed) % 8;
+		size = m0_rnd64(&seed) % (i < CRC32C_UT_ITER / 2 ? 1024 :
+					  CRC32C_UT_SIZE - off);
+		cut  = size == 0 ? 0 : m0_rnd64(&seed) % size;
+		crc  = m0_crc32c(i, buf + off, size);
+		M0_UT_ASSERT(crc == m0_crc32c_sw(i, buf + off, size));
+		M0_UT_ASSERT(crc == m0_crc32c(m0_crc32c(i, buf + off, cut),
+					      buf + off + cut, size - cut));
+		M0_UT_ASSERT(m0_crc32c(0, buf + off, size) ==
+			     m0_crc32c_combine(m0_crc32c(0, buf + off, cut),
+					       m0_crc32c(0, buf + off + cut,
+							 size - cut),
+					       size - cut));
+	}
+	/* Zero padding whose size is not a power of two. */
+	for (i = 0; i < ARRAY_SIZE(pad); ++i) {
+		memset(buf + CRC32C_UT_DATA, 0, pad[i]);
+		crc = m0_crc32c(0, buf, CRC32C_UT_DATA + pad[i]);
+		M0_UT_ASSERT(crc == m0_crc32c_sw(0, buf, CRC32C_UT_DATA +
+						 pad[i]));
+		M0_UT_ASSERT(crc ==
+			     m0_crc32c_combine(m0_crc32c(0, buf,
+							 CRC32C_UT_DATA),
+					       m0_crc32c(0,
+							 buf + CRC32C_UT_DATA,
+							 pad[i]),
+					       pad[i]));
+	}
+	/* Single bit flip is always detected. */
+	crc = m0_crc32c(0, buf, CRC32C_UT_SIZE);
+	buf[m0_rnd64(&seed) % CRC32C_UT_SIZE] ^= 1 << (m0_rnd64(&seed) % 8);
+	M0_UT_ASSERT(crc != m0_crc32c(0, buf, CRC32C_UT_SIZE));
+	m0_free(buf);
+}
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
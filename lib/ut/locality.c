@@ -276,6 +276,145 @@ void test_locality(void)
 }
 M0_EXPORTED(test_locality);
 
+static struct m0_atomic64 moved;
+
+static int steal_tick(struct m0_fom *fom, void *null, int *__unused)
+{
+	struct m0_fom_simple *whisker = container_of(fom, struct m0_fom_simple,
+						     si_fom);
+	int       idx = whisker - s;
+	m0_time_t end = m0_time_from_now(0, 20000);
+
+	M0_UT_ASSERT(null == NULL);
+	M0_UT_ASSERT(IS_IN_ARRAY(idx, sem));
+	M0_UT_ASSERT(m0_fom_group_is_locked(fom));
+	M0_UT_ASSERT((size_t)fom->fo_loc->fl_idx == fom->fo_loc_idx);
+	if (fom->fo_loc_idx != whisker->si_locality)
+		m0_atomic64_inc(&moved);
+	/* Keep the handler busy, so that its steal queue backs up. */
+	while (!m0_time_is_in_past(end))
+		;
+	m0_semaphore_up(&sem[idx]);
+	return -1;
+}
+
+/*
+ * Runs stealable foms with stealing enabled or disabled. Without stealing the
+ * foms are executed by their home localities.
+ */
+static void fom_steal_run(bool on)
+{
+	struct m0_fom_domain *dom;
+	uint64_t              stolen = 0;
+	unsigned              i;
+
+	m0_ut__reqh_init();
+	dom = m0_fom_dom();
+	m0_fom_domain_steal_set(dom, on);
+	m0_atomic64_set(&moved, 0);
+	for (i = 0; i < dom->fd_localities_nr; ++i)
+		dom->fd_localities[i]->fl_stolen = 0;
+	for (i = 0; i < ARRAY_SIZE(sem); ++i)
+		m0_semaphore_init(&sem[i], 0);
+	memset(s, 0, sizeof s);
+	for (i = 0; i < ARRAY_SIZE(s); ++i)
+		M0_FOM_SIMPLE_POST(&s[i], &reqh, NULL, &steal_tick, NULL, NULL,
+				   M0_FOM_SIMPLE_ANY);
+	for (i = 0; i < ARRAY_SIZE(sem); ++i)
+		m0_semaphore_down(&sem[i]);
+	m0_reqh_idle_wait(&reqh);
+	for (i = 0; i < dom->fd_localities_nr; ++i) {
+		M0_UT_ASSERT(m0_atomic64_get(&dom->fd_localities[i]->
+					     fl_steal_nr) == 0);
+		stolen += dom->fd_localities[i]->fl_stolen;
+	}
+	M0_UT_ASSERT(stolen == m0_atomic64_get(&moved));
+	M0_UT_ASSERT(ergo(!on, stolen == 0));
+	m0_fom_domain_steal_set(dom, false);
+	for (i = 0; i < ARRAY_SIZE(sem); ++i)
+		m0_semaphore_fini(&sem[i]);
+	m0_ut__reqh_fini();
+}
+
+void test_fom_steal(void)
+{
+	fom_steal_run(true);
+	fom_steal_run(false);
+}
+M0_EXPORTED(test_fom_steal);
+
+enum {
+	PRIO_FG_NR = 2 * M0_FOM_PRIO_SHARE,
+	PRIO_BG_NR = 3,
+	/* Gate, foreground, background and one late background fom. */
+	PRIO_NR    = 1 + PRIO_FG_NR + PRIO_BG_NR + 1
+};
+
+static int order[PRIO_NR];
+static int order_nr;
+
+static int prio_tick(struct m0_fom *fom, void *null, int *__unused)
+{
+	struct m0_fom_simple *whisker = container_of(fom, struct m0_fom_simple,
+						     si_fom);
+	int idx = whisker - s;
+
+	M0_UT_ASSERT(IS_IN_ARRAY(idx, order));
+	if (idx == 0) {
+		/* Keep the handler busy until all foms are queued. */
+		m0_semaphore_up(&sem[0]);
+		m0_semaphore_down(&sem[1]);
+	} else {
+		M0_UT_ASSERT(IS_IN_ARRAY(order_nr, order));
+		order[order_nr++] = idx;
+	}
+	m0_semaphore_up(&sem[2]);
+	return -1;
+}
+
+void test_fom_prio(void)
+{
+	/* The expected sequence of classes, 'L' is the late fom. */
+	static const char expected[] = "LFFFFFFFFBFFFFFFFFBB";
+	unsigned          i;
+
+	M0_CASSERT(ARRAY_SIZE(expected) == PRIO_NR);
+	m0_ut__reqh_init();
+	for (i = 0; i < 3; ++i)
+		m0_semaphore_init(&sem[i], 0);
+	memset(s, 0, sizeof s);
+	order_nr = 0;
+	M0_FOM_SIMPLE_POST(&s[0], &reqh, NULL, &prio_tick, NULL, NULL, 1);
+	m0_semaphore_down(&sem[0]);
+	/*
+	 * The handler is blocked in the gate fom, queued foms are admitted
+	 * into the run-queues only after the gate opens, so their class and
+	 * deadline can still be changed.
+	 */
+	for (i = 1; i < PRIO_NR; ++i) {
+		M0_FOM_SIMPLE_POST(&s[i], &reqh, NULL, &prio_tick, NULL, NULL,
+				   1);
+		if (i > PRIO_FG_NR)
+			s[i].si_fom.fo_prio = M0_FOM_PRIO_BG;
+		if (i == PRIO_NR - 1)
+			s[i].si_fom.fo_deadline = 1;
+	}
+	m0_semaphore_up(&sem[1]);
+	for (i = 0; i < PRIO_NR; ++i)
+		m0_semaphore_down(&sem[2]);
+	m0_reqh_idle_wait(&reqh);
+	M0_UT_ASSERT(order_nr == PRIO_NR - 1);
+	for (i = 0; i < order_nr; ++i) {
+		char class = order[i] == PRIO_NR - 1 ? 'L' :
+			     order[i] > PRIO_FG_NR   ? 'B' : 'F';
+		M0_UT_ASSERT(class == expected[i]);
+	}
+	for (i = 0; i < 3; ++i)
+		m0_semaphore_fini(&sem[i]);
+	m0_ut__reqh_fini();
+}
+M0_EXPORTED(test_fom_prio);
+
 static int entered;
 static int left;
 static int ticked;
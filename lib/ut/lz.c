@@ -0,0 +1,121 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+#include "ut/ut.h"         /* M0_UT_ASSERT */
+#include "lib/lz.h"
+#include "lib/arith.h"     /* m0_rnd64 */
+#include "lib/memory.h"    /* m0_alloc */
+#include "lib/errno.h"     /* EPROTO */
+
+enum {
+	LZ_UT_SIZE = 1 << 16,
+	LZ_UT_ITER = 0x40,
+};
+
+static void lz_ut_fill(uint8_t *buf, m0_bcount_t size, int mode,
+		       uint64_t *seed)
+{
+	m0_bcount_t i;
+
+	for (i = 0; i < size; ++i) {
+		switch (mode) {
+		case 0: /* incompressible */
+			buf[i] = m0_rnd64(seed);
+			break;
+		case 1: /* zeroes */
+			buf[i] = 0;
+			break;
+		case 2: /* short period, overlapping matches */
+			buf[i] = i % 3;
+			break;
+		default: /* random bytes mixed with repeated ones */
+			buf[i] = i >= 64 && m0_rnd64(seed) % 8 != 0 ?
+				 buf[i - 64] : m0_rnd64(seed);
+		}
+	}
+}
+
+void test_lz(void)
+{
+	struct m0_lz_ctx *ctx;
+	m0_bcount_t       bound = m0_lz_compress_bound(LZ_UT_SIZE);
+	m0_bcount_t       size;
+	m0_bcount_t       zsize;
+	m0_bcount_t       out;
+	uint64_t          seed = 42;
+	uint8_t          *src;
+	uint8_t          *dst;
+	uint8_t          *z;
+	int               rc;
+	int               i;
+	int               j;
+
+	M0_ALLOC_PTR(ctx);
+	src = m0_alloc(LZ_UT_SIZE);
+	dst = m0_alloc(LZ_UT_SIZE);
+	z   = m0_alloc(bound);
+	M0_UT_ASSERT(ctx != NULL && src != NULL && dst != NULL && z != NULL);
+	for (i = 0; i < LZ_UT_ITER; ++i) {
+		size = i < 16 ? i : m0_rnd64(&seed) % LZ_UT_SIZE;
+		lz_ut_fill(src, size, i % 4, &seed);
+		zsize = m0_lz_compress(ctx, src, size, z, bound);
+		M0_UT_ASSERT(zsize > 0 && zsize <= bound);
+		if (i % 4 == 1 && size > 1024)
+			M0_UT_ASSERT(zsize < size / 64);
+		rc = m0_lz_decompress(z, zsize, dst, size, &out);
+		M0_UT_ASSERT(rc == 0);
+		M0_UT_ASSERT(out == size);
+		M0_UT_ASSERT(memcmp(src, dst, size) == 0);
+		/* too small destination */
+		if (size > 0) {
+			rc = m0_lz_decompress(z, zsize, dst, size - 1, &out);
+			M0_UT_ASSERT(rc == -EPROTO);
+		}
+		if (i % 4 == 0 && size > 1024) {
+			zsize = m0_lz_compress(ctx, src, size, z, size / 2);
+			M0_UT_ASSERT(zsize == 0);
+		}
+		/* corrupted input is either rejected or decoded in bounds */
+		for (j = 0; j < 8 && zsize > 0; ++j) {
+			z[m0_rnd64(&seed) % zsize] ^=
+				1 + m0_rnd64(&seed) % 0xff;
+			(void)m0_lz_decompress(z, zsize, dst, size, &out);
+		}
+	}
+	m0_free(z);
+	m0_free(dst);
+	m0_free(src);
+	m0_free(ctx);
+}
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
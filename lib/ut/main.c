@@ -27,15 +27,18 @@ extern void m0_test_lib_uuid(void);
 extern void m0_ut_lib_buf_test(void);
 extern void test_0C(void);
 extern void test_atomic(void);
+extern void test_avl(void);
 extern void test_bitmap(void);
 extern void test_bitmap_onwire(void);
 extern void test_bob(void);
 extern void test_chan(void);
 extern void test_cookie(void);
+extern void test_crc32c(void);
 extern void test_finject(void);
 extern void test_getopts(void);
 extern void test_list(void);
 extern void test_lockers(void);
+extern void test_lz(void);
 extern void test_memory(void);
 extern void m0_test_misc(void);
 extern void test_mutex(void);
@@ -53,6 +56,8 @@ extern void test_vec(void);
 extern void test_zerovec(void);
 extern void test_locality(void);
 extern void test_locality_chore(void);
+extern void test_fom_steal(void);
+extern void test_fom_prio(void);
 extern void test_hashtable(void);
 extern void test_fold(void);
 extern void m0_ut_lib_thread_pool_test(void);
@@ -67,19 +72,24 @@ struct m0_ut_suite libm0_ut = {
 	.ts_tests = {
 		{ "0C",               test_0C            },
 		{ "atomic",           test_atomic        },
+		{ "avl",              test_avl           },
 		{ "bitmap",           test_bitmap        },
 		{ "onwire-bitmap",    test_bitmap_onwire },
 		{ "bob",              test_bob           },
 		{ "buf",              m0_ut_lib_buf_test },
 		{ "chan",             test_chan          },
 		{ "cookie",           test_cookie        },
+		{ "crc32c",           test_crc32c        },
 		{ "finject",          test_finject,      "Dima" },
 		{ "getopts",          test_getopts       },
 		{ "hash",	      test_hashtable     },
 		{ "list",             test_list          },
 		{ "locality",         test_locality,     "Nikita" },
 		{ "locality-chore",   test_locality_chore, "Nikita" },
+		{ "fom-steal",        test_fom_steal     },
+		{ "fom-prio",         test_fom_prio      },
 		{ "lockers",          test_lockers       },
+		{ "lz",               test_lz            },
 		{ "memory",           test_memory        },
 		{ "misc",             m0_test_misc       },
 		{ "mutex",            test_mutex         },
@@ -565,7 +565,9 @@ enum m0_idx_opcode {
 	 *       argument of m0_idx_op().
 	 */
 	M0_IC_LIST,                /* 20 */
-	M0_IC_NR                   /* 21 */
+	/** Delete all records with keys in the given range. */
+	M0_IC_DEL_RANGE,           /* 21 */
+	M0_IC_NR                   /* 22 */
 } M0_XCA_ENUM;
 
 /**
@@ -1542,6 +1544,17 @@ void m0_idx_fini(struct m0_idx *idx);
  *   values are stored in 'vals' buffer vector. If some value retrieval has
  *   failed, then corresponding element in 'rcs' array != 0.
  *
+ * For M0_IC_DEL_RANGE operation arguments should be as follows:
+ * - 'keys' buffer vector should contain two elements: the lower (inclusive)
+ *   and the upper (exclusive) bounds of the range. NULL lower bound stands for
+ *   the smallest key of the index, NULL upper bound stands for no upper bound.
+ * - 'vals' should be NULL.
+ * - After operation completion rcs[0] holds either a negative error code or
+ *   the number of records removed from the index component catalogues (capped
+ *   by INT32_MAX), rcs[1] is 0. Every operation removes a part of the range of
+ *   a bounded size, so the operation should be repeated until rcs[0] is 0,
+ *   which means that the range is empty.
+ *
  * 'rcs' holds array of per-item return codes for the operation. It should be
  * allocated by user with a size of at least 'keys->ov_vec.v_nr' elements. For
  * example, 6 records with keys k0...k5 were requested through GET request with
@@ -1571,13 +1584,16 @@ void m0_idx_fini(struct m0_idx *idx);
  * @pre idx != NULL
  * @pre M0_IN(opcode, (M0_IC_LOOKUP, M0_IC_LIST,
  *                     M0_IC_GET, M0_IC_PUT,
- *                     M0_IC_DEL, M0_IC_NEXT))
+ *                     M0_IC_DEL, M0_IC_NEXT,
+ *                     M0_IC_DEL_RANGE))
  * @pre ergo(*op != NULL, *op->op_size >= sizeof **op)
  * @pre ergo(opcode == M0_IC_LOOKUP, rcs != NULL)
  * @pre ergo(opcode != M0_IC_LOOKUP, keys != NULL)
  * @pre M0_IN(opcode, (M0_IC_DEL,
  *                     M0_IC_LOOKUP,
- *                     M0_IC_LIST)) == (vals == NULL)
+ *                     M0_IC_LIST,
+ *                     M0_IC_DEL_RANGE)) == (vals == NULL)
+ * @pre ergo(opcode == M0_IC_DEL_RANGE, keys->ov_vec.v_nr == 2)
  * @pre ergo(opcode == M0_IC_LIST,
  *           m0_forall(i, keys->ov_vec.v_nr,
  *                     keys->ov_vec.v_count[i] == sizeof(struct m0_uint128)))
@@ -1585,7 +1601,7 @@ void m0_idx_fini(struct m0_idx *idx);
  * @pre ergo(opcode == M0_IC_GET,
  *           m0_forall(i, keys->ov_vec.v_nr, keys->ov_buf[i] != NULL))
  * @pre ergo(flags == M0_OIF_SYNC_WAIT,
- *           M0_IN(opcode, (M0_IC_PUT, M0_IC_DEL)))
+ *           M0_IN(opcode, (M0_IC_PUT, M0_IC_DEL, M0_IC_DEL_RANGE)))
  * @pre ergo(vals != NULL, keys->ov_vec.v_nr == vals->ov_vec.v_nr)
  * @post ergo(result == 0, *op != NULL && *op->op_code == opcode &&
  *                         *op->op_sm.sm_state == M0_OS_INITIALISED)
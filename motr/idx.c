@@ -86,7 +86,8 @@ M0_INTERNAL bool m0__idx_op_invariant(struct m0_op_idx *oi)
 				       M0_IC_DEL,
 				       M0_IC_NEXT,
 				       M0_IC_LOOKUP,
-				       M0_IC_LIST))) &&
+				       M0_IC_LIST,
+				       M0_IC_DEL_RANGE))) &&
 	      _0C(m0_op_idx_bob_check(oi)) &&
 	      _0C(oi->oi_oc.oc_op.op_size >= sizeof *oi &&
 		  m0_ast_rc_bob_check(&oi->oi_ar) &&
@@ -527,10 +528,13 @@ static void idx_op_cb_launch(struct m0_op_common *oc)
 	case M0_IC_LIST:
 		query = query_ops->iqo_namei_list;
 		break;
+	case M0_IC_DEL_RANGE:
+		query = query_ops->iqo_del_range;
+		break;
 	default:
 		M0_IMPOSSIBLE("Management operation not implemented");
 	}
-	M0_ASSERT(query != NULL);
+	M0_ASSERT(query != NULL || op->op_code == M0_IC_DEL_RANGE);
 
 	m0_sm_group_unlock(&op->op_entity->en_sm_group);
 	/*
@@ -539,7 +543,7 @@ static void idx_op_cb_launch(struct m0_op_common *oc)
 	 *  < 0: the query fails.
 	 *  = 1: the driver successes in launching the query asynchronously.
 	*/
-	rc = query(oi);
+	rc = query != NULL ? query(oi) : M0_ERR(-ENOSYS);
 	oi->oi_ar.ar_rc = rc;
 	if (rc < 0) {
 		oi->oi_ar.ar_ast.sa_cb = &idx_op_ast_fail;
@@ -567,11 +571,14 @@ int m0_idx_op(struct m0_idx       *idx,
 	M0_PRE(idx != NULL);
 	M0_PRE(M0_IN(opcode, (M0_IC_LOOKUP, M0_IC_LIST,
 			      M0_IC_GET, M0_IC_PUT,
-			      M0_IC_DEL, M0_IC_NEXT)));
+			      M0_IC_DEL, M0_IC_NEXT,
+			      M0_IC_DEL_RANGE)));
 	M0_PRE(M0_IN(opcode, (M0_IC_DEL,
 			      M0_IC_LOOKUP,
-			      M0_IC_LIST)) == (vals == NULL));
+			      M0_IC_LIST,
+			      M0_IC_DEL_RANGE)) == (vals == NULL));
 	M0_PRE(ergo(opcode != M0_IC_LOOKUP, keys != NULL));
+	M0_PRE(ergo(opcode == M0_IC_DEL_RANGE, keys->ov_vec.v_nr == 2));
 	M0_PRE(ergo(vals != NULL,
 		    keys->ov_vec.v_nr == vals->ov_vec.v_nr));
 	M0_PRE(ergo(opcode == M0_IC_LIST,
@@ -580,7 +587,7 @@ int m0_idx_op(struct m0_idx       *idx,
 			      sizeof(struct m0_uint128))));
 	M0_PRE(op != NULL);
 	M0_PRE(ergo(flags == M0_OIF_SYNC_WAIT,
-		    M0_IN(opcode, (M0_IC_PUT, M0_IC_DEL))));
+		    M0_IN(opcode, (M0_IC_PUT, M0_IC_DEL, M0_IC_DEL_RANGE))));
 
 	rc = m0_op_get(op, sizeof(struct m0_op_idx));
 	if (rc == 0) {
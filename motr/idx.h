@@ -112,8 +112,8 @@ enum m0_op_idx_flags {
  * Query operations for an index service. The operations in this data
  * structure can be divided into 2 groups:
  * (a) Operations over indices: iqo_namei_create/delete/lookup/list.
- * (b) Queries on a specific index: get/put/del/next, see the comments above for
- *     details.
+ * (b) Queries on a specific index: get/put/del/next/del_range, see the comments
+ *     above for details.
  *
  * Returned value of query operations:
  *     = 0: the query is executed synchronously and returns successfully.
@@ -136,6 +136,11 @@ struct m0_idx_query_ops {
 	int  (*iqo_put)(struct m0_op_idx *oi);
 	int  (*iqo_del)(struct m0_op_idx *oi);
 	int  (*iqo_next)(struct m0_op_idx *oi);
+	/**
+	 * Optional, back-ends not supporting range deletion leave it NULL and
+	 * M0_IC_DEL_RANGE fails with -ENOSYS.
+	 */
+	int  (*iqo_del_range)(struct m0_op_idx *oi);
 };
 
 /** Initialisation and finalisation functions for an index service. */
@@ -26,6 +26,7 @@
 #include "lib/assert.h"
 #include "lib/tlist.h"         /* m0_tl */
 #include "lib/memory.h"
+#include "lib/arith.h"         /* min64u */
 #include "fid/fid.h"           /* m0_fid */
 #include "pool/pool.h"         /* pools_common_svc_ctx */
 #include "conf/helpers.h"      /* m0_confc_root_open */
@@ -80,8 +81,8 @@ struct dix_req {
 	struct m0_clink          idr_dtx_clink;
 
 	/**
-	 * Starting key for NEXT operation.
-	 * It's allocated internally and key value is copied from user.
+	 * Starting key for NEXT operation or range bounds for DEL_RANGE
+	 * operation. It's allocated internally and keys are copied from user.
 	 */
 	struct m0_bufvec         idr_start_key;
 	/** DIX request to invoke operations against distributed indices. */
@@ -124,7 +125,7 @@ static void  idx_sync_record_update(struct m0_op   *op,
 	oc = bob_of(op, struct m0_op_common, oc_op, &oc_bobtype);
 
 	if (M0_IN(op->op_code,
-		  (M0_IC_PUT, M0_IC_DEL,
+		  (M0_IC_PUT, M0_IC_DEL, M0_IC_DEL_RANGE,
 		   M0_EO_CREATE, M0_EO_DELETE))) {
 		/* Check and ensure oi is valid here. */
 		oi = bob_of(oc, struct m0_op_idx, oi_oc, &oi_bobtype);
@@ -149,7 +150,7 @@ static void cas_sync_record_update(struct m0_cas_req *creq,
 	dix_req = M0_AMB(dix_req, creq, idr_creq);
 	if (M0_IN(dix_req->idr_oi->oi_oc.oc_op.op_code,
 		  (M0_EO_CREATE, M0_EO_DELETE,
-		   M0_IC_PUT, M0_IC_DEL)))
+		   M0_IC_PUT, M0_IC_DEL, M0_IC_DEL_RANGE)))
 		idx_sync_record_update(&dix_req->idr_oi->oi_oc.oc_op,
 				        rpc_session, remid);
 }
@@ -359,6 +360,11 @@ static bool casreq_clink_cb(struct m0_clink *cl)
 			cas_next_reply_copy(creq, oi->oi_rcs, oi->oi_keys,
 					    oi->oi_vals);
 			break;
+		case M0_IC_DEL_RANGE:
+			m0_cas_del_range_rep(creq, &rep);
+			oi->oi_rcs[0] = rep.crr_rc;
+			oi->oi_rcs[1] = 0;
+			break;
 		default:
 			M0_IMPOSSIBLE("Invalid op code");
 		}
@@ -516,6 +522,65 @@ static void cas_del_ast(struct m0_sm_group *grp, struct m0_sm_ast *ast)
 	M0_LEAVE();
 }
 
+/**
+ * Copies range bounds given to M0_IC_DEL_RANGE operation. NULL lower bound is
+ * replaced with the smallest key (1-byte zero key), like for M0_IC_NEXT.
+ */
+static int idx_range_bounds_copy(const struct m0_bufvec *keys,
+				 struct m0_bufvec       *bounds)
+{
+	m0_bcount_t lo_nob = keys->ov_vec.v_count[0];
+	m0_bcount_t hi_nob = keys->ov_vec.v_count[1];
+	int         rc;
+
+	M0_PRE(keys->ov_vec.v_nr == 2);
+	rc = m0_bufvec_empty_alloc(bounds, 2);
+	if (rc != 0)
+		return M0_ERR(rc);
+	bounds->ov_vec.v_count[0] = lo_nob ?: sizeof(uint8_t);
+	bounds->ov_vec.v_count[1] = hi_nob;
+	bounds->ov_buf[0] = m0_alloc(bounds->ov_vec.v_count[0]);
+	if (hi_nob != 0)
+		bounds->ov_buf[1] = m0_alloc(hi_nob);
+	if (bounds->ov_buf[0] == NULL ||
+	    (hi_nob != 0 && bounds->ov_buf[1] == NULL)) {
+		m0_bufvec_free(bounds);
+		return M0_ERR(-ENOMEM);
+	}
+	if (lo_nob != 0)
+		memcpy(bounds->ov_buf[0], keys->ov_buf[0], lo_nob);
+	if (hi_nob != 0)
+		memcpy(bounds->ov_buf[1], keys->ov_buf[1], hi_nob);
+	return M0_RC(0);
+}
+
+static void cas_del_range_ast(struct m0_sm_group *grp, struct m0_sm_ast *ast)
+{
+	struct dix_req          *dix_req = ast->sa_datum;
+	struct m0_op_idx        *oi = dix_req->idr_oi;
+	struct m0_cas_id         idx;
+	struct m0_cas_req       *creq = &dix_req->idr_creq;
+	struct m0_bufvec        *bounds = &dix_req->idr_start_key;
+	struct m0_buf            lo;
+	struct m0_buf            hi;
+	uint32_t                 flags = 0;
+	int                      rc;
+
+	M0_ENTRY();
+	cas_req_prepare(dix_req, &idx, oi);
+	if (oi->oi_flags & M0_OIF_SYNC_WAIT)
+		flags |= COF_SYNC_WAIT;
+	rc = idx_range_bounds_copy(oi->oi_keys, bounds);
+	if (rc == 0) {
+		lo = M0_BUF_INIT(bounds->ov_vec.v_count[0], bounds->ov_buf[0]);
+		hi = M0_BUF_INIT(bounds->ov_vec.v_count[1], bounds->ov_buf[1]);
+		rc = m0_cas_del_range(creq, &idx, &lo, &hi, NULL, flags);
+	}
+	if (rc != 0)
+		dix_req_immed_failure(dix_req, M0_ERR(rc));
+	M0_LEAVE();
+}
+
 static void cas_next_ast(struct m0_sm_group *grp, struct m0_sm_ast *ast)
 {
 	struct dix_req          *dix_req = ast->sa_datum;
@@ -568,7 +633,8 @@ static void dix_build(const struct m0_op_idx *oi,
 	M0_SET0(out);
 	out->dd_fid = *OI_IFID(oi);
 	/* Pool version and layout type which are passed by consumers like S3 */
-	if (M0_IN(opcode, (M0_IC_GET, M0_IC_PUT, M0_IC_DEL, M0_IC_NEXT))) {
+	if (M0_IN(opcode, (M0_IC_GET, M0_IC_PUT, M0_IC_DEL, M0_IC_NEXT,
+			   M0_IC_DEL_RANGE))) {
 		if ((idx->in_attr.idx_layout_type == DIX_LTYPE_DESCR) 
 		    && (m0_fid_is_set(&idx->in_attr.idx_pver))
 		    && (m0_fid_is_valid(&idx->in_attr.idx_pver))) {
@@ -671,7 +737,7 @@ static int dix_req_create(struct m0_op_idx  *oi,
 			/* Store oi for dix callbacks to update SYNC records. */
 			if (M0_IN(oi->oi_oc.oc_op.op_code,
 				  (M0_EO_CREATE, M0_EO_DELETE,
-				   M0_IC_PUT, M0_IC_DEL)))
+				   M0_IC_PUT, M0_IC_DEL, M0_IC_DEL_RANGE)))
 				req->idr_dreq.dr_sync_datum =
 						(void *)&oi->oi_oc.oc_op;
 		} else {
@@ -918,6 +984,12 @@ static bool dixreq_clink_cb(struct m0_clink *cl)
 			dix_next_reply_copy(dreq, oi->oi_rcs, oi->oi_keys,
 					    oi->oi_vals);
 			break;
+		case M0_IC_DEL_RANGE:
+			oi->oi_rcs[0] = m0_dix_item_rc(dreq, 0) ?:
+				min64u(m0_dix_del_range_rep_nr(dreq),
+				       INT32_MAX);
+			oi->oi_rcs[1] = 0;
+			break;
 		case M0_IC_LOOKUP:
 			if (oi->oi_flags & M0_OIF_SKIP_LAYOUT) {
 				M0_ASSERT(m0_dix_req_nr(dreq) == 1);
@@ -1169,6 +1241,26 @@ static void dix_next_ast(struct m0_sm_group *grp, struct m0_sm_ast *ast)
 	M0_LEAVE();
 }
 
+static void dix_del_range_ast(struct m0_sm_group *grp, struct m0_sm_ast *ast)
+{
+	struct dix_req          *dix_req = ast->sa_datum;
+	struct m0_op_idx        *oi = dix_req->idr_oi;
+	struct m0_dix            dix;
+	struct m0_dix_req       *dreq = &dix_req->idr_dreq;
+	uint32_t                 flags = 0;
+	int                      rc;
+
+	M0_ENTRY();
+	dix_dreq_prepare(dix_req, &dix, oi);
+	if (oi->oi_flags & M0_OIF_SYNC_WAIT)
+		flags |= COF_SYNC_WAIT;
+	rc = idx_range_bounds_copy(oi->oi_keys, &dix_req->idr_start_key) ?:
+	     m0_dix_del_range(dreq, &dix, &dix_req->idr_start_key, flags);
+	if (rc != 0)
+		dix_req_immed_failure(dix_req, M0_ERR(rc));
+	M0_LEAVE();
+}
+
 /* Cancels launched index operation by cancelling rpc items. */
 static void idx_op_cancel_ast(struct m0_sm_group *grp, struct m0_sm_ast *ast)
 {
@@ -1375,6 +1467,19 @@ static int dix_next(struct m0_op_idx *oi)
 	return 1;
 }
 
+static int dix_del_range(struct m0_op_idx *oi)
+{
+	struct dix_req *req;
+	int             rc;
+
+	rc = dix_req_create(oi, &req);
+	if (rc != 0)
+		return M0_ERR(rc);
+	dix_req_exec(req, idx_is_distributed(oi) ?
+			dix_del_range_ast : cas_del_range_ast);
+	return 1;
+}
+
 static struct m0_idx_query_ops dix_query_ops = {
 	.iqo_namei_create = dix_index_create,
 	.iqo_namei_delete = dix_index_delete,
@@ -1385,6 +1490,7 @@ static struct m0_idx_query_ops dix_query_ops = {
 	.iqo_put          = dix_put,
 	.iqo_del          = dix_del,
 	.iqo_next         = dix_next,
+	.iqo_del_range    = dix_del_range,
 };
 
 /*--------------------------------------------------------------------------*
@@ -56,6 +56,7 @@
 #include "graph/graph.h"
 #include "motr/init.h"
 #include "lib/cookie.h"
+#include "be/btree.h"           /* m0_be_btree_mod_init */
 #include "conf/fop.h"           /* m0_conf_fops_init, m0_confx_types_init */
 #include "conf/obj.h"           /* m0_conf_obj_init */
 #include "pool/policy.h"        /* m0_pver_policies_init */
@@ -66,6 +67,8 @@
 #else
 #  include "be/tx_service.h"    /* m0_be_txs_register */
 #  include "be/be.h"            /* m0_backend_init */
+#  include "lib/crc32c.h"       /* m0_crc32c_init */
+#  include "sns/parity_ops.h"   /* m0_parity_ops_init */
 #  include "conf/confd.h"       /* m0_confd_register */
 #  include "mdstore/mdstore.h"  /* m0_mdstore_mod_init */
 #endif
@@ -160,6 +163,7 @@ struct init_fini_call subsystem[] = {
 	{ &m0_fid_init,         &m0_fid_fini,         "fid" },
 	{ &m0_file_mod_init,    &m0_file_mod_fini,     "file" },
 	{ &m0_cookie_global_init, &m0_cookie_global_fini, "cookie" },
+	{ &m0_be_btree_mod_init, &m0_be_btree_mod_fini, "be-btree" },
 	{ &m0_timers_init,      &m0_timers_fini,      "timer" },
 	{ &m0_processors_init,  &m0_processors_fini,  "processors" },
 	/* localities must be initialised after lib/processor.h */
@@ -211,6 +215,8 @@ struct init_fini_call subsystem[] = {
 #ifdef __KERNEL__
 	{ &m0t1fs_init,         &m0t1fs_fini,         "m0t1fs" },
 #else
+	{ &m0_crc32c_init,      &m0_crc32c_fini,      "crc32c" },
+	{ &m0_parity_ops_init,  &m0_parity_ops_fini,  "parity-ops" },
 	{ &m0_backend_init,     &m0_backend_fini,     "be" },
 	{ &m0_be_txs_register,  &m0_be_txs_unregister, "be-tx-service" },
 	{ &m0_confd_register,   &m0_confd_unregister, "confd" },
@@ -1162,6 +1162,69 @@ static int pargrp_iomap_readrest(struct pargrp_iomap *map)
 	return M0_RC(0);
 }
 
+/**
+ * Calculates parity of the whole parity group in a single pass. Every column
+ * of pi_databufs[] and pi_paritybufs[] is described by a bufvec of its pages,
+ * missing data pages are read as zpage.
+ *
+ * @param map The parity group to calculate the parity for.
+ * @param zpage Zeroed page.
+ * @param pagesize Size of the pages.
+ */
+static int pargrp_iomap_parity_calc_full(struct pargrp_iomap *map,
+					 void *zpage, uint64_t pagesize)
+{
+	struct m0_op_io          *ioo = map->pi_ioo;
+	struct m0_pdclust_layout *play = pdlayout_get(ioo);
+	uint32_t                  n = layout_n(play);
+	uint32_t                  units = n + layout_k(play);
+	uint32_t                  rows = rows_nr(play, ioo->ioo_obj);
+	struct m0_bufvec         *vecs;
+	void                    **addrs;
+	m0_bcount_t              *counts;
+	struct m0_buf            *buf;
+	uint32_t                  row;
+	uint32_t                  col;
+	uint32_t                  i;
+	int                       rc;
+
+	M0_ENTRY("map = %p", map);
+
+	M0_ALLOC_ARR(vecs, units);
+	M0_ALLOC_ARR(addrs, units * rows);
+	M0_ALLOC_ARR(counts, units * rows);
+	if (vecs == NULL || addrs == NULL || counts == NULL) {
+		rc = M0_ERR(-ENOMEM);
+		goto out;
+	}
+
+	for (col = 0; col < units; ++col) {
+		vecs[col].ov_vec.v_nr    = rows;
+		vecs[col].ov_vec.v_count = &counts[col * rows];
+		vecs[col].ov_buf         = &addrs[col * rows];
+		for (row = 0; row < rows; ++row) {
+			i = col * rows + row;
+			if (col >= n) {
+				buf = &map->pi_paritybufs[row][col - n]->db_buf;
+			} else if (map->pi_databufs[row][col] != NULL) {
+				buf = &map->pi_databufs[row][col]->db_buf;
+			} else {
+				addrs[i]  = zpage;
+				counts[i] = pagesize;
+				continue;
+			}
+			addrs[i]  = buf->b_addr;
+			counts[i] = buf->b_nob;
+		}
+	}
+	rc = m0_parity_math_calculate_bufvec(parity_math(ioo), vecs, vecs + n);
+out:
+	m0_free(counts);
+	m0_free(addrs);
+	m0_free(vecs);
+	return M0_RC(rc);
+}
+
 /**
  * Calculates parity of data buffers.
  * This is heavily based on
@@ -1218,26 +1281,11 @@ static int pargrp_iomap_parity_recalc(struct pargrp_iomap *map)
 			goto last;
 		}
 
-		for (row = 0; row < rows_nr(play, ioo->ioo_obj); ++row) {
-			for (col = 0; col < layout_n(play); ++col)
-				if (map->pi_databufs[row][col] != NULL) {
-					dbufs[col] =
-					    map->pi_databufs[row][col]->db_buf;
-				} else {
-					dbufs[col].b_addr = (void *)zpage;
-					dbufs[col].b_nob  = pagesize;
-				}
-
-			for (col = 0; col < layout_k(play); ++col)
-				pbufs[col] = map->pi_paritybufs[row][col]->
-					     db_buf;
-
-			m0_parity_math_calculate(parity_math(map->pi_ioo),
-						 dbufs, pbufs);
-		}
-
+		rc = pargrp_iomap_parity_calc_full(map, zpage, pagesize);
 		m0_free_aligned(zpage, 1ULL<<obj->ob_attr.oa_bshift,
 				M0_NETBUF_SHIFT);
+		if (rc != 0)
+			goto last;
 		M0_LOG(M0_DEBUG, "Parity recalculated for %s",
 		       map->pi_rtype == PIR_READREST ? "read-rest" :
 		       "aligned write");
@@ -179,6 +179,9 @@ enum m0_magic_satchel {
 	/* m0_be_queue::bq_op_put*, m0_be_queue::bq_op_get* (coccoid slide) */
 	M0_BE_QUEUE_OP_HEAD_MAGIC = 0x33c0cc01d511de77,
 
+	/* m0_be_fmt_cblock::gcb_magic of a compressed group (be scalable log) */
+	M0_BE_GROUP_FORMAT_LZ_MAGIC = 0x33be5ca1ab1e1077,
+
 /* m0t1fs */
 	/* m0t1fs_sb::s_magic (cozie filesis) */
 	M0_T1FS_SUPER_MAGIC = 0x33c021ef11e51577,
@@ -962,6 +965,12 @@ enum m0_magic_satchel {
 	/* stob/cache.c:stob_cache_tl::td_head_magic (cache billed) */
 	M0_STOB_CACHE_HEAD_MAGIC    = 0x33cac4eb111ed77,
 
+	/* m0_stob::so_cache_hmagic (cache base) */
+	M0_STOB_CACHE_HASH_MAGIC    = 0x33cac4eba5e77,
+
+	/* stob/cache.c:stob_hash_tl::td_head_magic (cache bead) */
+	M0_STOB_CACHE_HASH_HEAD_MAGIC = 0x33cac4ebead77,
+
 	/* m0_stob_type::st_magic (disc class) */
 	M0_STOB_TYPES_MAGIC         = 0x33d15cc1a5577,
 
@@ -43,6 +43,7 @@
 #include "stob/ad.h"
 #include "net/net.h"
 #include "net/lnet/lnet.h"
+#include "net/sock/sock.h"     /* m0_net_sock_pollers_set */
 #include "rpc/rpc.h"
 #include "reqh/reqh.h"
 #include "cob/cob.h"
@@ -855,6 +856,9 @@ static int cs_storage_devs_init(struct cs_stobs          *stob,
 	if (rc != 0)
 		return M0_ERR(rc);
 	m0_storage_devs_use_directio(devs, !disable_direct_io);
+	m0_storage_devs_use_uring(devs, rctx->rc_ioq_uring, rctx->rc_ioq_sqpoll);
+	m0_storage_devs_ioq_size(devs, rctx->rc_ioq_threads,
+				 rctx->rc_ioq_ring_size);
 
 	if (stob->s_sfile.sf_is_initialised) {
 		M0_LOG(M0_DEBUG, "yaml config");
@@ -1052,10 +1056,11 @@ static int cs_storage_init(const char *stob_type,
 			   bool mkfs, bool force,
 			   bool disable_direct_io)
 {
-	const char *ldom_cfg_init;
-	bool        linux_stob;
-	bool        fake_storage;
-	int         rc = 0;
+	struct m0_reqh_context *rctx;
+	char                   *ldom_cfg_init;
+	bool                    linux_stob;
+	bool                    fake_storage;
+	int                     rc = 0;
 
 	M0_ENTRY();
 	M0_PRE(stob_type != NULL);
@@ -1065,7 +1070,17 @@ static int cs_storage_init(const char *stob_type,
 
 	/* XXX `-F` (force) doesn't work for linuxstob storage devices. */
 
-	ldom_cfg_init = disable_direct_io ? "directio=false" : "directio=true";
+	rctx = container_of(stob, struct m0_reqh_context, rc_stob);
+	m0_stob_linux_init_cfg_make(&ldom_cfg_init,
+		&(struct m0_stob_linux_domain_cfg) {
+			.sldc_use_directio  = !disable_direct_io,
+			.sldc_use_uring     = rctx->rc_ioq_uring,
+			.sldc_uring_sqpoll  = rctx->rc_ioq_sqpoll,
+			.sldc_ioq_threads   = rctx->rc_ioq_threads,
+			.sldc_ioq_ring_size = rctx->rc_ioq_ring_size,
+		});
+	if (ldom_cfg_init == NULL)
+		return M0_ERR(-ENOMEM);
 
 	linux_stob = m0_strcaseeq(stob_type, m0_cs_stypes[M0_LINUX_STOB]);
 	m0_get()->i_reqh_uses_ad_stob = !linux_stob;
@@ -1090,6 +1105,7 @@ static int cs_storage_init(const char *stob_type,
 						seg, stob_path, false,
 						disable_direct_io);
 	}
+	m0_free(ldom_cfg_init);
 	if (rc != 0 && stob->s_sdom != NULL)
 		m0_stob_domain_fini(stob->s_sdom);
 
@@ -1290,6 +1306,8 @@ static int cs_net_domains_init(struct m0_motr *cctx)
 	M0_ENTRY();
 	M0_PRE(reqh_context_invariant(rctx));
 
+	if (rctx->rc_sock_pollers > 0)
+		m0_net_sock_pollers_set(rctx->rc_sock_pollers);
 	m0_tl_for(cs_eps, &rctx->rc_eps, ep) {
 		int rc = cs_net_domain_init(ep, cctx);
 		if (rc != 0)
@@ -1530,6 +1548,12 @@ static int cs_be_init(struct m0_reqh_context *rctx,
 		be->but_dom_cfg.bc_engine.bec_group_freeze_timeout_max =
 			rctx->rc_be_tx_group_freeze_timeout_max;
 	}
+	if (rctx->rc_be_seg_resident_max > 0) {
+		be->but_dom_cfg.bc_seg_paging.bspc_resident_max =
+			rctx->rc_be_seg_resident_max;
+	}
+	if (rctx->rc_be_log_compress)
+		be->but_dom_cfg.bc_engine.bec_group_cfg.tgc_log_compress = true;
 	rc = cs_be_dom_cfg_zone_pcnt_fill(&rctx->rc_reqh, &be->but_dom_cfg);
 	if (rc != 0)
 		goto err;
@@ -1574,7 +1598,8 @@ static int cs_reqh_start(struct m0_reqh_context *rctx)
 	rc = M0_REQH_INIT(&rctx->rc_reqh,
 			  .rhia_mdstore = &rctx->rc_mdstore,
 			  .rhia_pc = &rctx->rc_motr->cc_pools_common,
-			  .rhia_fid = &rctx->rc_fid);
+			  .rhia_fid = &rctx->rc_fid,
+			  .rhia_fom_steal = rctx->rc_fom_steal);
 	rctx->rc_state = RC_REQH_INITIALISED;
 	return M0_RC(rc);
 }
@@ -2035,6 +2060,42 @@ static int process_fid_parse(const char *str, struct m0_fid *fid)
 	       0 : M0_ERR(-EINVAL);
 }
 
+static bool cs_ioq_kind_is(const char *str, size_t len, const char *kind)
+{
+	return strlen(kind) == len && strncmp(str, kind, len) == 0;
+}
+
+/**
+ * Parses the I/O queue of data storage, see -O option: the queue kind,
+ * optionally followed by ",threads=N" and ",ring=N" sizing each device queue.
+ */
+static int cs_ioq_parse(struct m0_reqh_context *rctx, const char *str)
+{
+	const char *opt;
+	size_t      len;
+
+	M0_PRE(str != NULL);
+
+	opt = strchr(str, ',');
+	len = opt == NULL ? strlen(str) : opt - str;
+	rctx->rc_ioq_sqpoll = cs_ioq_kind_is(str, len, "uring-sqpoll");
+	rctx->rc_ioq_uring  = rctx->rc_ioq_sqpoll ||
+			      cs_ioq_kind_is(str, len, "uring");
+	if (!rctx->rc_ioq_uring && !cs_ioq_kind_is(str, len, "aio"))
+		return M0_ERR_INFO(-EINVAL, "Unknown I/O queue: %s", str);
+	for (; opt != NULL; opt = strchr(opt + 1, ',')) {
+		if (sscanf(opt, ",threads=%"SCNu32,
+			   &rctx->rc_ioq_threads) != 1 &&
+		    sscanf(opt, ",ring=%"SCNu32,
+			   &rctx->rc_ioq_ring_size) != 1)
+			return M0_ERR_INFO(-EINVAL, "Bad I/O queue option: %s",
+					   opt);
+	}
+	return rctx->rc_ioq_threads <= M0_STOB_IOQ_NR_THREADS_MAX ? 0 :
+		M0_ERR_INFO(-EINVAL, "Too many I/O queue threads: %"PRIu32,
+			    rctx->rc_ioq_threads);
+}
+
 /* With this, utilities like m0mkfs will generate process FID on the fly */
 static void process_fid_generate_conditional(struct m0_reqh_context *rctx)
 {
@@ -2249,6 +2310,17 @@ static int _args_parse(struct m0_motr *cctx, int argc, char **argv)
 				       rctx->rc_be_tx_group_freeze_timeout_max =
 						t * M0_TIME_ONE_MSEC;
 				})),
+			M0_NUMBERARG('X', "BE segment resident set limit,"
+				     " pages beyond it are paged out",
+				LAMBDA(void, (int64_t size)
+				{
+					rctx->rc_be_seg_resident_max = size;
+				})),
+			M0_VOIDARG('t', "Compress BE log records",
+				LAMBDA(void, (void)
+				{
+					rctx->rc_be_log_compress = true;
+				})),
 			M0_VOIDARG('a', "Preallocate BE segment",
 				LAMBDA(void, (void)
 				{
@@ -2318,6 +2390,29 @@ static int _args_parse(struct m0_motr *cctx, int argc, char **argv)
 				{
 					rctx->rc_disable_direct_io = true;
 				})),
+			M0_STRINGARG('O', "I/O queue of data storage: aio"
+				     " (default), uring or uring-sqpoll,"
+				     " optionally followed by ,threads=N"
+				     " and ,ring=N per device",
+				LAMBDA(void, (const char *s)
+				{
+					rc = cs_ioq_parse(rctx, s);
+				})),
+			M0_NUMBERARG('P', "Number of poller threads per"
+				     " sock transfer machine",
+				LAMBDA(void, (int64_t nr)
+				{
+					if (nr > 0)
+						rctx->rc_sock_pollers = nr;
+					else
+						rc = M0_ERR(-EINVAL);
+				})),
+			M0_VOIDARG('W', "Enable work stealing between"
+				   " fom localities",
+				LAMBDA(void, (void)
+				{
+					rctx->rc_fom_steal = true;
+				})),
 			M0_VOIDARG('j', "Enable fault injection service (FIS)",
 				LAMBDA(void, (void)
 				{
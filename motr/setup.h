@@ -288,6 +288,10 @@ struct m0_reqh_context {
 	m0_bcount_t                  rc_be_tx_payload_size_max;
 	m0_time_t                    rc_be_tx_group_freeze_timeout_min;
 	m0_time_t                    rc_be_tx_group_freeze_timeout_max;
+	/** Resident set limit of BE segments, 0 disables segment paging. */
+	m0_bcount_t                  rc_be_seg_resident_max;
+	/** Compress tx group records in BE log. */
+	bool                         rc_be_log_compress;
 
 	/**
 	 * Default path to the configuration database.
@@ -340,6 +344,27 @@ struct m0_reqh_context {
 	/** Disable direct I/O for data from clients */
 	bool                         rc_disable_direct_io;
 
+	/** Use io_uring for data storage I/O. */
+	bool                         rc_ioq_uring;
+
+	/** Poll io_uring submission queues, requires rc_ioq_uring. */
+	bool                         rc_ioq_sqpoll;
+
+	/** Worker threads per data device I/O queue, 0 for the default. */
+	uint32_t                     rc_ioq_threads;
+
+	/** Ring buffer slots per data device I/O queue, 0 for the default. */
+	uint32_t                     rc_ioq_ring_size;
+
+	/**
+	 * Number of poller threads per sock transfer machine, 0 to keep the
+	 * default. @see m0_net_sock_pollers_set().
+	 */
+	uint32_t                     rc_sock_pollers;
+
+	/** Enable work stealing between fom localities. */
+	bool                         rc_fom_steal;
+
 	/** Enable Fault Injection Service */
 	bool                         rc_fis_enabled;
 
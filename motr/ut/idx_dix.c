@@ -746,9 +746,60 @@ static void ut_dix_record_ops(bool dist, uint32_t cr_get_flags,
 	accum++;
 	M0_UT_ASSERT(accum == CNT);
 
-	/* Remove the records from the index. */
+	/*
+	 * Remove the second half of the records by range, repeating until
+	 * the range is reported empty.
+	 */
+	accum = 0;
+	cur_key = dix_key(CNT / 2);
+	do {
+		rcs = rcs_alloc(2);
+		rc = m0_bufvec_empty_alloc(&keys, 2);
+		M0_UT_ASSERT(rc == 0);
+		keys.ov_buf[0] = &cur_key;
+		keys.ov_vec.v_count[0] = sizeof(uint64_t);
+		rc = m0_idx_op(&idx, M0_IC_DEL_RANGE, &keys, NULL, rcs,
+			       put_del_flags, &op);
+		M0_UT_ASSERT(rc == 0);
+		m0_op_launch(&op, 1);
+		rc = m0_op_wait(op, M0_BITS(M0_OS_STABLE), WAIT_TIMEOUT);
+		M0_UT_ASSERT(rc == 0);
+		M0_UT_ASSERT(op->op_sm.sm_rc == 0);
+		M0_UT_ASSERT(rcs[0] >= 0 && rcs[1] == 0);
+		recs_nr = rcs[0];
+		accum += recs_nr;
+		m0_bufvec_free2(&keys);
+		m0_op_fini(op);
+		m0_free0(&op);
+		m0_free0(&rcs);
+	} while (recs_nr != 0);
+	/* Replicas are counted for distributed indices. */
+	M0_UT_ASSERT(dist ? accum >= CNT / 2 : accum == CNT / 2);
+
+	/* Check that only the first half of the records is left. */
 	rcs = rcs_alloc(CNT);
-	rc = m0_bufvec_alloc(&keys, CNT, sizeof(uint64_t));
+	rc = m0_bufvec_alloc(&keys, CNT, sizeof(uint64_t)) ?:
+	     m0_bufvec_empty_alloc(&vals, CNT);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < keys.ov_vec.v_nr; i++)
+		*(uint64_t *)keys.ov_buf[i] = dix_key(i);
+	rc = m0_idx_op(&idx, M0_IC_GET, &keys, &vals, rcs, cr_get_flags,
+		       &op);
+	M0_UT_ASSERT(rc == 0);
+	m0_op_launch(&op, 1);
+	rc = m0_op_wait(op, M0_BITS(M0_OS_STABLE), WAIT_TIMEOUT);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_forall(i, CNT,
+			       rcs[i] == (i < CNT / 2 ? 0 : -ENOENT)));
+	m0_bufvec_free(&keys);
+	m0_bufvec_free(&vals);
+	m0_op_fini(op);
+	m0_free0(&op);
+	m0_free0(&rcs);
+
+	/* Remove the rest of the records from the index. */
+	rcs = rcs_alloc(CNT / 2);
+	rc = m0_bufvec_alloc(&keys, CNT / 2, sizeof(uint64_t));
 	M0_UT_ASSERT(rc == 0);
 	for (i = 0; i < keys.ov_vec.v_nr; i++)
 		*(uint64_t *)keys.ov_buf[i] = dix_key(i);
@@ -757,7 +808,7 @@ static void ut_dix_record_ops(bool dist, uint32_t cr_get_flags,
 	m0_op_launch(&op, 1);
 	rc = m0_op_wait(op, M0_BITS(M0_OS_STABLE), WAIT_TIMEOUT);
 	M0_UT_ASSERT(rc == 0);
-	M0_UT_ASSERT(m0_forall(i, CNT, rcs[i] == 0));
+	M0_UT_ASSERT(m0_forall(i, CNT / 2, rcs[i] == 0));
 	m0_bufvec_free(&keys);
 	m0_op_fini(op);
 	m0_free0(&op);
@@ -25,6 +25,8 @@
 #ifndef __MOTR_NET_SOCK_SOCK_H__
 #define __MOTR_NET_SOCK_SOCK_H__
 
+#include "lib/types.h"        /* uint32_t */
+
 #ifndef __KERNEL__
 extern const struct m0_net_xprt m0_net_sock_xprt;
 #endif
@@ -34,6 +36,18 @@ extern const struct m0_net_xprt m0_net_sock_xprt;
  * @{
  */
 
+#ifndef __KERNEL__
+/**
+ * Sets the number of poller threads (each with its own epoll instance) used by
+ * sock transfer machines initialised after this call.
+ *
+ * Sockets, including parallel sockets to the same end-point, are distributed
+ * over the pollers. The default is 1. It can also be set through the
+ * M0_NET_SOCK_POLLERS environment variable, which is read when the module is
+ * initialised.
+ */
+M0_INTERNAL void m0_net_sock_pollers_set(uint32_t nr);
+#endif
 
 /** @} end of netsock group */
 #endif /* __MOTR_NET_SOCK_SOCK_H__ */
@@ -0,0 +1,462 @@
+/* -*- C -*- */
+/*
+ * Copyright (c) 2020 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+
+/*
+ * The transport is included, so that the tests can check internal state
+ * (pollers, sockets of an end-point).
+ */
+#include "net/sock/sock.c"
+
+#include "ut/ut.h"
+#include "lib/semaphore.h"
+#include "lib/processor.h"
+
+enum {
+	UT_POLLERS      = 4,
+	UT_UNIX_POLLERS = 2,
+	UT_SEG_SIZE     = 4096,
+	UT_BULK_SEGS    = 256,
+	UT_BULK_NR      = 4,
+	UT_MSG_NR       = 16,
+	UT_TM_NR        = 2
+};
+
+struct ut_buf {
+	struct m0_net_buffer ub_nb;
+	int                  ub_status;
+	m0_bcount_t          ub_length;
+};
+
+static const char *ut_addr[UT_TM_NR] = {
+	"inet:stream:127.0.0.1@43201",
+	"inet:stream:127.0.0.1@43202"
+};
+
+static const char *ut_unix_addr[UT_TM_NR] = {
+	"unix:stream:ut-sock0@1",
+	"unix:stream:ut-sock1@2"
+};
+
+static struct m0_net_domain      ut_dom;
+static struct m0_net_transfer_mc ut_tm[UT_TM_NR];
+static struct m0_semaphore       ut_sem;
+
+static void ut_tm_event_cb(const struct m0_net_tm_event *ev)
+{
+}
+
+static const struct m0_net_tm_callbacks ut_tm_cb = {
+	.ntc_event_cb = &ut_tm_event_cb
+};
+
+static void ut_buf_cb(const struct m0_net_buffer_event *ev)
+{
+	struct ut_buf *ub = container_of(ev->nbe_buffer, struct ut_buf, ub_nb);
+
+	ub->ub_status = ev->nbe_status;
+	ub->ub_length = ev->nbe_length;
+	m0_semaphore_up(&ut_sem);
+}
+
+static const struct m0_net_buffer_callbacks ut_buf_cbs = {
+	.nbc_cb = {
+		[M0_NET_QT_MSG_RECV]          = &ut_buf_cb,
+		[M0_NET_QT_MSG_SEND]          = &ut_buf_cb,
+		[M0_NET_QT_PASSIVE_BULK_RECV] = &ut_buf_cb,
+		[M0_NET_QT_PASSIVE_BULK_SEND] = &ut_buf_cb,
+		[M0_NET_QT_ACTIVE_BULK_RECV]  = &ut_buf_cb,
+		[M0_NET_QT_ACTIVE_BULK_SEND]  = &ut_buf_cb
+	}
+};
+
+static void ut_tm_start(struct m0_net_transfer_mc *tm, const char *addr,
+			bool confine)
+{
+	struct m0_clink  wait;
+	struct m0_bitmap processors;
+	int              rc;
+
+	M0_SET0(tm);
+	tm->ntm_state     = M0_NET_TM_UNDEFINED;
+	tm->ntm_callbacks = &ut_tm_cb;
+	rc = m0_net_tm_init(tm, &ut_dom);
+	M0_UT_ASSERT(rc == 0);
+	if (confine) {
+		rc = m0_bitmap_init(&processors, m0_processor_nr_max());
+		M0_UT_ASSERT(rc == 0);
+		m0_bitmap_set(&processors, 0, true);
+		rc = m0_net_tm_confine(tm, &processors);
+		M0_UT_ASSERT(rc == 0);
+		m0_bitmap_fini(&processors);
+		M0_UT_ASSERT(m0_bitmap_get(&((struct ma *)
+				       tm->ntm_xprt_private)->t_processors, 0));
+	}
+	m0_clink_init(&wait, NULL);
+	m0_clink_add_lock(&tm->ntm_chan, &wait);
+	rc = m0_net_tm_start(tm, addr);
+	M0_UT_ASSERT(rc == 0);
+	while (tm->ntm_state != M0_NET_TM_STARTED)
+		m0_chan_wait(&wait);
+	m0_clink_del_lock(&wait);
+	m0_clink_fini(&wait);
+	M0_UT_ASSERT(((struct ma *)tm->ntm_xprt_private)->t_poller_nr ==
+		     sock_pollers_nr);
+}
+
+static void ut_tm_stop(struct m0_net_transfer_mc *tm)
+{
+	struct m0_clink wait;
+	int             rc;
+
+	m0_clink_init(&wait, NULL);
+	m0_clink_add_lock(&tm->ntm_chan, &wait);
+	rc = m0_net_tm_stop(tm, true);
+	M0_UT_ASSERT(rc == 0);
+	while (tm->ntm_state != M0_NET_TM_STOPPED)
+		m0_chan_wait(&wait);
+	m0_clink_del_lock(&wait);
+	m0_clink_fini(&wait);
+	m0_net_tm_fini(tm);
+}
+
+static void ut_buf_init(struct ut_buf *ub, uint32_t nr, char pattern)
+{
+	uint32_t i;
+	int      rc;
+
+	M0_SET0(ub);
+	rc = m0_bufvec_alloc(&ub->ub_nb.nb_buffer, nr, UT_SEG_SIZE);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < nr; ++i)
+		memset(ub->ub_nb.nb_buffer.ov_buf[i], pattern + i, UT_SEG_SIZE);
+	ub->ub_nb.nb_callbacks = &ut_buf_cbs;
+	ub->ub_nb.nb_timeout   = M0_TIME_NEVER;
+	ub->ub_status          = 1;
+	rc = m0_net_buffer_register(&ub->ub_nb, &ut_dom);
+	M0_UT_ASSERT(rc == 0);
+}
+
+static void ut_buf_fini(struct ut_buf *ub)
+{
+	m0_net_buffer_deregister(&ub->ub_nb, &ut_dom);
+	m0_bufvec_free(&ub->ub_nb.nb_buffer);
+}
+
+static bool ut_buf_eq(const struct ut_buf *ub0, const struct ut_buf *ub1)
+{
+	const struct m0_bufvec *v0 = &ub0->ub_nb.nb_buffer;
+	const struct m0_bufvec *v1 = &ub1->ub_nb.nb_buffer;
+
+	return v0->ov_vec.v_nr == v1->ov_vec.v_nr &&
+		m0_forall(i, v0->ov_vec.v_nr,
+			  memcmp(v0->ov_buf[i], v1->ov_buf[i],
+				 UT_SEG_SIZE) == 0);
+}
+
+static void ut_wait(uint32_t nr)
+{
+	while (nr-- > 0)
+		M0_UT_ASSERT(m0_semaphore_timeddown(&ut_sem,
+						   m0_time_from_now(30, 0)));
+}
+
+/**
+ * Moves "nr" bulk buffers from "src" to "dst" concurrently, using passive
+ * receive on "dst" and active send on "src". Returns with the buffers
+ * verified and finalised.
+ */
+static void ut_bulk(struct m0_net_transfer_mc *src,
+		    struct m0_net_transfer_mc *dst, uint32_t nr)
+{
+	struct ut_buf *recv;
+	struct ut_buf *send;
+	uint32_t       i;
+	int            rc;
+
+	M0_ALLOC_ARR(recv, nr);
+	M0_ALLOC_ARR(send, nr);
+	M0_UT_ASSERT(recv != NULL && send != NULL);
+	for (i = 0; i < nr; ++i) {
+		ut_buf_init(&recv[i], UT_BULK_SEGS, 0);
+		ut_buf_init(&send[i], UT_BULK_SEGS, 'a' + i);
+		recv[i].ub_nb.nb_qtype = M0_NET_QT_PASSIVE_BULK_RECV;
+		recv[i].ub_nb.nb_length = UT_BULK_SEGS * UT_SEG_SIZE;
+		rc = m0_net_buffer_add(&recv[i].ub_nb, dst);
+		M0_UT_ASSERT(rc == 0);
+		rc = m0_net_desc_copy(&recv[i].ub_nb.nb_desc,
+				      &send[i].ub_nb.nb_desc);
+		M0_UT_ASSERT(rc == 0);
+		send[i].ub_nb.nb_qtype = M0_NET_QT_ACTIVE_BULK_SEND;
+		send[i].ub_nb.nb_length = UT_BULK_SEGS * UT_SEG_SIZE;
+	}
+	for (i = 0; i < nr; ++i) {
+		rc = m0_net_buffer_add(&send[i].ub_nb, src);
+		M0_UT_ASSERT(rc == 0);
+	}
+	ut_wait(2 * nr);
+	for (i = 0; i < nr; ++i) {
+		M0_UT_ASSERT(send[i].ub_status == 0);
+		M0_UT_ASSERT(recv[i].ub_status == 0);
+		M0_UT_ASSERT(recv[i].ub_length == UT_BULK_SEGS * UT_SEG_SIZE);
+		M0_UT_ASSERT(ut_buf_eq(&recv[i], &send[i]));
+		m0_net_desc_free(&send[i].ub_nb.nb_desc);
+		m0_net_desc_free(&recv[i].ub_nb.nb_desc);
+		ut_buf_fini(&send[i]);
+		ut_buf_fini(&recv[i]);
+	}
+	m0_free(send);
+	m0_free(recv);
+}
+
+/**
+ * Checks that "src" talks to "dst" through a socket on each of its pollers.
+ */
+static void ut_ep_check(struct m0_net_transfer_mc *src, const char *dst)
+{
+	struct m0_net_end_point *net;
+	struct ma               *ma = src->ntm_xprt_private;
+	struct ep               *ep;
+	int                      rc;
+
+	rc = m0_net_end_point_create(&net, src, dst);
+	M0_UT_ASSERT(rc == 0);
+	ep = ep_net(net);
+	ma_lock(ma);
+	M0_UT_ASSERT(s_tlist_length(&ep->e_sock) == sock_pollers_nr);
+	M0_UT_ASSERT(m0_tl_forall(s, s0, &ep->e_sock,
+				  m0_tl_forall(s, s1, &ep->e_sock,
+					       s0 == s1 ||
+					       s0->s_poller != s1->s_poller)));
+	ma_unlock(ma);
+	m0_net_end_point_put(net);
+}
+
+static void ut_msg(struct m0_net_transfer_mc *src,
+		   struct m0_net_transfer_mc *dst)
+{
+	struct m0_net_end_point *ep;
+	struct ut_buf           *recv;
+	struct ut_buf           *send;
+	bool                     seen[UT_MSG_NR] = {};
+	uint32_t                 i;
+	int                      rc;
+
+	M0_ALLOC_ARR(recv, UT_MSG_NR);
+	M0_ALLOC_ARR(send, UT_MSG_NR);
+	M0_UT_ASSERT(recv != NULL && send != NULL);
+	rc = m0_net_end_point_create(&ep, src, dst->ntm_ep->nep_addr);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < UT_MSG_NR; ++i) {
+		ut_buf_init(&recv[i], 1, 0);
+		recv[i].ub_nb.nb_qtype = M0_NET_QT_MSG_RECV;
+		recv[i].ub_nb.nb_min_receive_size = UT_SEG_SIZE;
+		recv[i].ub_nb.nb_max_receive_msgs = 1;
+		rc = m0_net_buffer_add(&recv[i].ub_nb, dst);
+		M0_UT_ASSERT(rc == 0);
+	}
+	for (i = 0; i < UT_MSG_NR; ++i) {
+		ut_buf_init(&send[i], 1, i);
+		send[i].ub_nb.nb_qtype  = M0_NET_QT_MSG_SEND;
+		send[i].ub_nb.nb_length = UT_SEG_SIZE;
+		send[i].ub_nb.nb_ep     = ep;
+		rc = m0_net_buffer_add(&send[i].ub_nb, src);
+		M0_UT_ASSERT(rc == 0);
+	}
+	ut_wait(2 * UT_MSG_NR);
+	for (i = 0; i < UT_MSG_NR; ++i) {
+		char idx = *(char *)recv[i].ub_nb.nb_buffer.ov_buf[0];
+
+		M0_UT_ASSERT(send[i].ub_status == 0);
+		M0_UT_ASSERT(recv[i].ub_status == 0);
+		M0_UT_ASSERT(recv[i].ub_length == UT_SEG_SIZE);
+		M0_UT_ASSERT(idx >= 0 && idx < UT_MSG_NR && !seen[(int)idx]);
+		M0_UT_ASSERT(ut_buf_eq(&recv[i], &send[(int)idx]));
+		seen[(int)idx] = true;
+	}
+	for (i = 0; i < UT_MSG_NR; ++i) {
+		ut_buf_fini(&send[i]);
+		ut_buf_fini(&recv[i]);
+	}
+	m0_net_end_point_put(ep);
+	m0_free(send);
+	m0_free(recv);
+}
+
+/**
+ * Runs bulk and message traffic between two transfer machines with multiple
+ * pollers each, one of them confined to a processor.
+ */
+static void pollers_traffic(void)
+{
+	int rc;
+	int i;
+
+	m0_net_sock_pollers_set(UT_POLLERS);
+	m0_semaphore_init(&ut_sem, 0);
+	rc = m0_net_domain_init(&ut_dom, &m0_net_sock_xprt);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < UT_TM_NR; ++i)
+		ut_tm_start(&ut_tm[i], ut_addr[i], i == 0);
+	/* A single large buffer is striped over a socket per poller. */
+	ut_bulk(&ut_tm[1], &ut_tm[0], 1);
+	ut_ep_check(&ut_tm[1], ut_addr[0]);
+	/* Concurrent buffers in both directions. */
+	ut_bulk(&ut_tm[0], &ut_tm[1], UT_BULK_NR);
+	ut_bulk(&ut_tm[1], &ut_tm[0], UT_BULK_NR);
+	ut_msg(&ut_tm[1], &ut_tm[0]);
+	ut_msg(&ut_tm[0], &ut_tm[1]);
+	for (i = 0; i < UT_TM_NR; ++i)
+		ut_tm_stop(&ut_tm[i]);
+	m0_net_domain_fini(&ut_dom);
+	m0_semaphore_fini(&ut_sem);
+	m0_net_sock_pollers_set(1);
+}
+
+static void addr_unix(void)
+{
+	struct addr             addr;
+	struct addr             copy;
+	struct sockaddr_storage sa = {};
+	char                   *name;
+	int                     rc;
+	static const struct {
+		const char *name;
+		int         rc;
+	} bad[] = {
+		{ "unix:dgram:m0d@1",                -EPROTONOSUPPORT },
+		{ "unix:stream:@1",                  -EINVAL },
+		{ "unix:stream:m0d",                 -EINVAL },
+		{ "unix:stream:m0d@1x",              -EINVAL },
+		{ "unix:stream:m0d@65536",           -ERANGE },
+		{ "unix:stream:0123456789abcdef@1",  -ENAMETOOLONG },
+		{ "unixx:stream:m0d@1",              -EINVAL }
+	};
+	int i;
+
+	rc = addr_parse(&addr, "unix:stream:m0d-ios1@3000");
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(addr.a_family == AF_UNIX);
+	M0_UT_ASSERT(addr.a_socktype == SOCK_STREAM);
+	M0_UT_ASSERT(addr.a_protocol == 0);
+	M0_UT_ASSERT(addr.a_port == 3000);
+	M0_UT_ASSERT(strcmp(addr.a_data.v_data, "m0d-ios1") == 0);
+	name = addr_print(&addr);
+	M0_UT_ASSERT(name != NULL);
+	M0_UT_ASSERT(strcmp(name, "unix:stream:m0d-ios1@3000") == 0);
+	m0_free(name);
+	/* The longest name still fits. */
+	rc = addr_parse(&addr, "unix:stream:0123456789abcde@65535");
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(addr.a_port == 65535);
+	/* Encoding is in the abstract name-space and is reversible. */
+	addr_encode(&addr, (void *)&sa);
+	M0_UT_ASSERT(sa.ss_family == AF_UNIX);
+	M0_UT_ASSERT(((struct sockaddr_un *)&sa)->sun_path[0] == 0);
+	copy = addr;
+	M0_SET0(&copy.a_data);
+	copy.a_port = 0;
+	addr_decode(&copy, (void *)&sa);
+	M0_UT_ASSERT(addr_eq(&addr, &copy) && copy.a_port == addr.a_port);
+	for (i = 0; i < ARRAY_SIZE(bad); ++i)
+		M0_UT_ASSERT(addr_parse(&addr, bad[i].name) == bad[i].rc);
+}
+
+/**
+ * Checks that every connection accepted by "tm" from a unix domain socket has
+ * its own end-point with the auto-bound address of the peer socket.
+ */
+static void ut_autobind_check(struct m0_net_transfer_mc *tm)
+{
+	struct ma               *ma = tm->ntm_xprt_private;
+	struct m0_net_end_point *net;
+	struct ep               *ep;
+	int                      nr = 0;
+
+	ma_lock(ma);
+	m0_tl_for(m0_nep, &tm->ntm_end_points, net) {
+		ep = ep_net(net);
+		M0_UT_ASSERT(ep->e_a.a_family == AF_UNIX);
+		if (ep->e_a.a_port != 0)
+			continue;
+		/* Auto-bound name assigned by the kernel. */
+		M0_UT_ASSERT(ep->e_a.a_data.v_data[0] != 0);
+		M0_UT_ASSERT(!s_tlist_is_empty(&ep->e_sock));
+		M0_UT_ASSERT(m0_tl_forall(m0_nep, other, &tm->ntm_end_points,
+				  other == net ||
+				  !ep_eq(ep_net(other), &ep->e_a)));
+		++nr;
+	} m0_tl_endfor;
+	ma_unlock(ma);
+	M0_UT_ASSERT(nr >= 1);
+}
+
+/**
+ * Runs bulk and message traffic between two transfer machines over unix domain
+ * sockets, then checks the accepted connections.
+ */
+static void unix_traffic(void)
+{
+	int rc;
+	int i;
+
+	m0_net_sock_pollers_set(UT_UNIX_POLLERS);
+	m0_semaphore_init(&ut_sem, 0);
+	rc = m0_net_domain_init(&ut_dom, &m0_net_sock_xprt);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < UT_TM_NR; ++i)
+		ut_tm_start(&ut_tm[i], ut_unix_addr[i], false);
+	ut_bulk(&ut_tm[1], &ut_tm[0], 1);
+	ut_ep_check(&ut_tm[1], ut_unix_addr[0]);
+	ut_bulk(&ut_tm[0], &ut_tm[1], UT_BULK_NR);
+	ut_msg(&ut_tm[1], &ut_tm[0]);
+	ut_msg(&ut_tm[0], &ut_tm[1]);
+	for (i = 0; i < UT_TM_NR; ++i)
+		ut_autobind_check(&ut_tm[i]);
+	for (i = 0; i < UT_TM_NR; ++i)
+		ut_tm_stop(&ut_tm[i]);
+	m0_net_domain_fini(&ut_dom);
+	m0_semaphore_fini(&ut_sem);
+	m0_net_sock_pollers_set(1);
+}
+
+struct m0_ut_suite m0_net_sock_ut = {
+	.ts_name = "net-sock-ut",
+	.ts_tests = {
+		{ "pollers-traffic", &pollers_traffic },
+		{ "addr-unix",       &addr_unix       },
+		{ "unix-traffic",    &unix_traffic    },
+		{ NULL, NULL }
+	}
+};
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
+/*
+ * vim: tabstop=8 shiftwidth=8 noexpandtab textwidth=80 nowrap
+ */
@@ -64,7 +64,12 @@ enum {
 
 M0_BASSERT(sizeof(struct in_addr) <= sizeof(struct in6_addr));
 
-/** Protocol-family specific part of addr. */
+/**
+ * Protocol-family specific part of addr.
+ *
+ * For ipv4 and ipv6 this is the ip address in network byte order, for the
+ * unix family this is a NUL-padded abstract socket name.
+ */
 struct addrdata {
 	char v_data[WADDR_LEN];
 } M0_XCA_ARRAY M0_XCA_DOMAIN(rpc);
@@ -239,6 +239,7 @@ m0_reqh_init(struct m0_reqh *reqh, const struct m0_reqh_init_args *reqh_args)
 	reqh->rh_pools   = reqh_args->rhia_pc;
 	reqh->rh_oostore = false;
 	reqh->rh_fid     = *reqh_args->rhia_fid;
+	reqh->rh_fom_steal = reqh_args->rhia_fom_steal;
 
 	m0_fol_init(&reqh->rh_fol);
 	m0_ha_domain_init(&reqh->rh_hadom, M0_HA_EPOCH_NONE);
@@ -257,6 +258,8 @@ m0_reqh_init(struct m0_reqh *reqh, const struct m0_reqh_init_args *reqh_args)
 	m0_chan_init(&reqh->rh_conf_cache_ready, &reqh->rh_guard);
 	m0_chan_init(&reqh->rh_conf_cache_ready_async, &reqh->rh_guard_async);
 
+	if (reqh->rh_fom_steal)
+		m0_fom_domain_steal_set(m0_fom_dom(), true);
 	if (reqh->rh_beseg != NULL) {
 		rc = m0_reqh_be_init(reqh, reqh->rh_beseg);
 		if (rc != 0)
@@ -307,6 +310,8 @@ static void __reqh_fini(struct m0_reqh *reqh)
 	m0_rwlock_fini(&reqh->rh_rwlock);
 	m0_ha_domain_fini(&reqh->rh_hadom);
 	m0_fol_fini(&reqh->rh_fol);
+	if (reqh->rh_fom_steal)
+		m0_fom_domain_steal_set(m0_fom_dom(), false);
 
 	m0_mutex_lock(&reqh->rh_guard);
 	m0_chan_fini(&reqh->rh_conf_cache_exp);
@@ -170,6 +170,9 @@ struct m0_reqh {
 	 */
 	bool                          rh_oostore;
 
+	/** Work stealing was enabled by this request handler. */
+	bool                          rh_fom_steal;
+
 	/** HA service context. */
 	struct m0_reqh_service_ctx   *rh_ha_rsctx;
 
@@ -240,6 +243,11 @@ struct m0_reqh_init_args {
 	struct m0_mdstore       *rhia_mdstore;
 	struct m0_pools_common  *rhia_pc;
 	const struct m0_fid     *rhia_fid; /* fid of m0_conf_process */
+	/**
+	 * Enables work stealing between fom localities while the request
+	 * handler exists, see m0_fom_domain_steal_set().
+	 */
+	bool                     rhia_fom_steal;
 };
 
 /**
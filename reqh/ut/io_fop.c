@@ -228,6 +228,8 @@ static int stob_io_fop_fom_create_helper(struct m0_fop *fop,
 
 	m0_fom_init(&fom_obj->sif_fom, &fop->f_type->ft_fom_type, fom_ops, fop,
 		    fom_obj->sif_rep_fop, reqh);
+	/* As ioservice io foms, these can run in any locality. */
+	fom_obj->sif_fom.fo_stealable = true;
 
 	*out = &fom_obj->sif_fom;
 	return 0;
@@ -197,8 +197,10 @@ static int server_init(const char             *stob_path,
 			  .rhia_db        = NULL,
 			  .rhia_mdstore   = &srv_mdstore,
 			  .rhia_fid       = &g_process_fid,
+			  .rhia_fom_steal = true,
 		);
 	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(m0_fom_dom()->fd_steal);
 
 	m0_be_ut_backend_init(&ut_be);
 	m0_be_ut_seg_init(&ut_seg, &ut_be, 1 << 20 /* 1 MB */);
@@ -462,6 +464,7 @@ void test_reqh(void)
 	M0_UT_ASSERT(result == 0);
 
 	server_fini(bdom, back_key);
+	M0_UT_ASSERT(!m0_fom_dom()->fd_steal);
 
 	m0_net_domain_fini(&net_dom);
 	m0_net_domain_fini(&srv_net_dom);
@@ -286,6 +286,7 @@ enum M0_RPC_OPCODES {
 	M0_CAS_REP_FOP_OPCODE               = 234,
 	M0_CAS_GCW_FOP_OPCODE               = 235,
 	M0_CAS_GCF_FOP_OPCODE               = 236,
+	M0_CAS_DELR_FOP_OPCODE              = 241,
 
 	/** Fault Injection command fops. */
 	M0_FI_COMMAND_OPCODE                = 260,
@@ -315,7 +315,9 @@ static void (*fidx_recover[M0_PARITY_CAL_ALGO_NR])(struct m0_parity_math *math,
 
 enum {
 	SNS_PARITY_MATH_DATA_BLOCKS_MAX = 1 << (M0_PARITY_GALOIS_W - 1),
-	BAD_FAIL_INDEX = -1,
+	/** Bytes of all the units of a group covered by a parity tile. */
+	PARITY_TILE_WORKSET = 256 * 1024,
+	PARITY_TILE_MIN = 4096,
 	IR_INVALID_COL = UINT8_MAX,
 	MIN_TABLE_LEN = 32,
 };
@@ -415,11 +417,170 @@ M0_INTERNAL void m0_parity_math_refine(struct m0_parity_math *math,
 M0_INTERNAL void m0_parity_math_buffer_xor(struct m0_buf *dest,
 					   const struct m0_buf *src)
 {
-        uint32_t ei; /* block element index. */
+	const uint8_t *xor_src[2] = { dest[0].b_addr, src[0].b_addr };
 
-        for (ei = 0; ei < src[0].b_nob; ++ei)
-		((uint8_t*)dest[0].b_addr)[ei] ^=
-			(m0_parity_elem_t)((uint8_t*)src[0].b_addr)[ei];
+	m0_parity_xor(dest[0].b_addr, xor_src, ARRAY_SIZE(xor_src),
+		      src[0].b_nob);
+}
+
+/**
+ * Walks units of a parity group stored in bufvecs in tiles: pieces of the same
+ * length, contiguous in every unit. Units can be segmented differently, tiles
+ * end at every segment boundary. Tile length is limited so that the tiles of
+ * all the units stay in the processor cache while parity math runs over them.
+ */
+struct parity_tiles {
+	uint32_t                 pt_nr;
+	/** Number of the slots with a unit. */
+	uint32_t                 pt_used;
+	/** Length of the current tile. */
+	m0_bcount_t              pt_len;
+	/** Unit cursors, vec is NULL in the unused slots. */
+	struct m0_bufvec_cursor *pt_cur;
+	/** Current tile of every unit, empty in the unused slots. */
+	struct m0_buf           *pt_buf;
+};
+
+static int parity_tiles_init(struct parity_tiles *tiles, uint32_t nr)
+{
+	M0_SET0(tiles);
+	M0_ALLOC_ARR(tiles->pt_cur, nr);
+	M0_ALLOC_ARR(tiles->pt_buf, nr);
+	if (tiles->pt_cur == NULL || tiles->pt_buf == NULL) {
+		m0_free(tiles->pt_cur);
+		m0_free(tiles->pt_buf);
+		return BUF_ALLOC_ERR_INFO(-ENOMEM, "parity tiles", nr);
+	}
+	tiles->pt_nr = nr;
+	return 0;
+}
+
+static void parity_tiles_fini(struct parity_tiles *tiles)
+{
+	m0_free(tiles->pt_cur);
+	m0_free(tiles->pt_buf);
+}
+
+static void parity_tiles_add(struct parity_tiles *tiles, uint32_t slot,
+			     const struct m0_bufvec *unit)
+{
+	M0_PRE(slot < tiles->pt_nr);
+	M0_PRE(tiles->pt_cur[slot].bc_vc.vc_vec == NULL);
+
+	m0_bufvec_cursor_init(&tiles->pt_cur[slot], unit);
+	++tiles->pt_used;
+}
+
+/**
+ * Moves to the next tile and makes tiles->pt_buf[] point to it.
+ * Returns false when the end of the units is reached.
+ */
+static bool parity_tiles_next(struct parity_tiles *tiles)
+{
+	struct m0_bufvec_cursor *cur;
+	m0_bcount_t              len;
+	uint32_t                 i;
+	bool                     end = false;
+
+	M0_PRE(tiles->pt_used > 0);
+
+	len = max_check((m0_bcount_t)PARITY_TILE_MIN,
+			(m0_bcount_t)PARITY_TILE_WORKSET / tiles->pt_used);
+	for (i = 0; i < tiles->pt_nr; ++i) {
+		cur = &tiles->pt_cur[i];
+		if (cur->bc_vc.vc_vec == NULL)
+			continue;
+		end |= m0_bufvec_cursor_move(cur, tiles->pt_len);
+		if (!end)
+			len = min_check(len, m0_bufvec_cursor_step(cur));
+	}
+	if (end)
+		return false;
+	for (i = 0; i < tiles->pt_nr; ++i) {
+		cur = &tiles->pt_cur[i];
+		tiles->pt_buf[i] = cur->bc_vc.vc_vec == NULL ? M0_BUF_INIT0 :
+			M0_BUF_INIT(len, m0_bufvec_cursor_addr(cur));
+	}
+	tiles->pt_len = len;
+	return true;
+}
+
+M0_INTERNAL int m0_parity_math_calculate_bufvec(struct m0_parity_math *math,
+						struct m0_bufvec *data,
+						struct m0_bufvec *parity)
+{
+	struct parity_tiles tiles;
+	uint32_t            n = math->pmi_data_count;
+	uint32_t            i;
+	int                 rc;
+
+	M0_ENTRY();
+	rc = parity_tiles_init(&tiles, n + math->pmi_parity_count);
+	if (rc != 0)
+		return M0_ERR(rc);
+	for (i = 0; i < tiles.pt_nr; ++i)
+		parity_tiles_add(&tiles, i, i < n ? &data[i] : &parity[i - n]);
+	while (parity_tiles_next(&tiles))
+		(*calculate[math->pmi_parity_algo])(math, tiles.pt_buf,
+						    tiles.pt_buf + n);
+	parity_tiles_fini(&tiles);
+	return M0_RC(0);
+}
+
+M0_INTERNAL int m0_parity_math_diff_bufvec(struct m0_parity_math *math,
+					   struct m0_bufvec *old,
+					   struct m0_bufvec *new,
+					   struct m0_bufvec *parity,
+					   uint32_t index)
+{
+	struct parity_tiles tiles;
+	uint32_t            n = math->pmi_data_count;
+	uint32_t            i;
+	int                 rc;
+
+	M0_ENTRY("index=%u", index);
+	M0_PRE(index < n);
+
+	/* Slots: old versions, new versions, parity; one data unit is used. */
+	rc = parity_tiles_init(&tiles, 2 * n + math->pmi_parity_count);
+	if (rc != 0)
+		return M0_ERR(rc);
+	parity_tiles_add(&tiles, index, &old[index]);
+	parity_tiles_add(&tiles, n + index, &new[index]);
+	for (i = 2 * n; i < tiles.pt_nr; ++i)
+		parity_tiles_add(&tiles, i, &parity[i - 2 * n]);
+	while (rc == 0 && parity_tiles_next(&tiles))
+		rc = (*diff[math->pmi_parity_algo])(math, tiles.pt_buf,
+						    tiles.pt_buf + n,
+						    tiles.pt_buf + 2 * n,
+						    index);
+	parity_tiles_fini(&tiles);
+	return rc == 0 ? M0_RC(rc) : M0_ERR(rc);
+}
+
+M0_INTERNAL int m0_parity_math_recover_bufvec(struct m0_parity_math *math,
+					      struct m0_bufvec *data,
+					      struct m0_bufvec *parity,
+					      struct m0_buf *fails,
+					      enum m0_parity_linsys_algo algo)
+{
+	struct parity_tiles tiles;
+	uint32_t            n = math->pmi_data_count;
+	uint32_t            i;
+	int                 rc;
+
+	M0_ENTRY();
+	rc = parity_tiles_init(&tiles, n + math->pmi_parity_count);
+	if (rc != 0)
+		return M0_ERR(rc);
+	for (i = 0; i < tiles.pt_nr; ++i)
+		parity_tiles_add(&tiles, i, i < n ? &data[i] : &parity[i - n]);
+	while (rc == 0 && parity_tiles_next(&tiles))
+		rc = (*recover[math->pmi_parity_algo])(math, tiles.pt_buf,
+						       tiles.pt_buf + n,
+						       fails, algo);
+	parity_tiles_fini(&tiles);
+	return rc == 0 ? M0_RC(rc) : M0_ERR(rc);
 }
 
 M0_INTERNAL int m0_sns_ir_init(const struct m0_parity_math *math,
@@ -564,15 +725,32 @@ M0_INTERNAL int m0_sns_ir_recover(struct m0_sns_ir *ir,
 
 /* Parity Math Helper Functions */
 
-/* Functions m0_parity_* are too much eclectic. Just more simple names. */
-static int gadd(int x, int y)
+/**
+ * Sets dst to the XOR of data[0, nr) except data[skip] and of the optional
+ * extra block. Sources are fed to m0_parity_xor() in batches, every batch
+ * after the first one also takes the partial result from dst.
+ */
+static void xor_blocks(struct m0_buf *dst, const struct m0_buf *data,
+		       uint32_t nr, uint32_t skip, const struct m0_buf *extra)
 {
-	return m0_parity_add(x, y);
-}
+	const uint8_t *src[M0_PARITY_XOR_SRC_MAX];
+	uint32_t       src_nr = 0;
+	uint32_t       ui;
 
-static int gmul(int x, int y)
-{
-	return m0_parity_mul(x, y);
+	for (ui = 0; ui <= nr; ++ui) {
+		if (ui == skip || (ui == nr && extra == NULL))
+			continue;
+		src[src_nr++] = ui < nr ? data[ui].b_addr : extra->b_addr;
+		if (src_nr == ARRAY_SIZE(src)) {
+			m0_parity_xor(dst->b_addr, src, src_nr, dst->b_nob);
+			src[0] = dst->b_addr;
+			src_nr = 1;
+		}
+	}
+	if (src_nr == 0)
+		memset(dst->b_addr, 0, dst->b_nob);
+	else if (src_nr > 1 || src[0] != dst->b_addr)
+		m0_parity_xor(dst->b_addr, src, src_nr, dst->b_nob);
 }
 
 static uint32_t fails_count(uint8_t *fail, uint32_t unit_count)
@@ -598,23 +776,16 @@ static void xor_calculate(struct m0_parity_math *math,
 			  const struct m0_buf *data,
 			  struct m0_buf *parity)
 {
-	uint32_t          ei; /* block element index. */
 	uint32_t          ui; /* unit index. */
 	uint32_t          block_size = data[0].b_nob;
-	m0_parity_elem_t  pe;
 
 	M0_ENTRY();
 	M0_PRE(block_size == parity[0].b_nob);
 	for (ui = 1; ui < math->pmi_data_count; ++ui)
 		M0_PRE(block_size == data[ui].b_nob);
 
-	for (ei = 0; ei < block_size; ++ei) {
-		pe = 0;
-		for (ui = 0; ui < math->pmi_data_count; ++ui)
-			pe ^= (m0_parity_elem_t)((uint8_t*)data[ui].b_addr)[ei];
-
-		((uint8_t*)parity[0].b_addr)[ei] = pe;
-	}
+	xor_blocks(&parity[0], data, math->pmi_data_count,
+		   math->pmi_data_count, NULL);
 	M0_LEAVE();
 }
 
@@ -624,7 +795,7 @@ static int xor_diff(struct m0_parity_math *math,
 		    struct m0_buf         *parity,
 		    uint32_t               index)
 {
-	uint32_t ei;
+	const uint8_t *src[3];
 
 	M0_PRE(math   != NULL);
 	M0_PRE(old    != NULL);
@@ -634,11 +805,11 @@ static int xor_diff(struct m0_parity_math *math,
 	M0_PRE(old[index].b_nob == new[index].b_nob);
 	M0_PRE(new[index].b_nob == parity[0].b_nob);
 
-	for (ei = 0; ei < new[index].b_nob; ++ei) {
-		((uint8_t*)parity[0].b_addr)[ei] ^=
-			((uint8_t *)old[index].b_addr)[ei] ^
-			((uint8_t *)new[index].b_addr)[ei];
-	}
+	src[0] = parity[0].b_addr;
+	src[1] = old[index].b_addr;
+	src[2] = new[index].b_addr;
+	m0_parity_xor(parity[0].b_addr, src, ARRAY_SIZE(src),
+		      parity[0].b_nob);
 
 	return M0_RC(0);
 }
@@ -649,14 +820,11 @@ static int xor_recover(struct m0_parity_math *math,
 		       struct m0_buf *fails,
 		       enum m0_parity_linsys_algo algo)
 {
-	uint32_t          ei; /* block element index. */
 	uint32_t          ui; /* unit index. */
 	uint8_t          *fail;
 	uint32_t          fail_count;
 	uint32_t          unit_count;
 	uint32_t          block_size = data[0].b_nob;
-	m0_parity_elem_t  pe;
-	int               fail_index = BAD_FAIL_INDEX;
 
 	unit_count = math->pmi_data_count + math->pmi_parity_count;
 	fail = (uint8_t*) fails->b_addr;
@@ -669,23 +837,13 @@ static int xor_recover(struct m0_parity_math *math,
 	for (ui = 1; ui < math->pmi_data_count; ++ui)
 		M0_PRE(block_size == data[ui].b_nob);
 
-	for (ei = 0; ei < block_size; ++ei) {
-		pe = 0;
-		for (ui = 0; ui < math->pmi_data_count; ++ui) {
-			if (fail[ui] != 1)
-				pe ^= (m0_parity_elem_t)((uint8_t*)
-				       data[ui].b_addr)[ei];
-			else
-				fail_index = ui;
-		}
-		/* Now ui points to parity block, test if it was failed. */
-		if (fail[ui] != 1) {
-			M0_ASSERT(fail_index != BAD_FAIL_INDEX);
-			((uint8_t*)data[fail_index].b_addr)[ei] = pe ^
-				((uint8_t*)parity[0].b_addr)[ei];
-		} else /* Parity was lost, so recover it. */
-			((uint8_t*)parity[0].b_addr)[ei] = pe;
-	}
+	for (ui = 0; ui < math->pmi_data_count && fail[ui] != 1; ++ui)
+		;
+	if (ui < math->pmi_data_count)
+		xor_blocks(&data[ui], data, math->pmi_data_count, ui,
+			   &parity[0]);
+	else /* Parity was lost, so recover it. */
+		xor_blocks(&parity[0], data, math->pmi_data_count, ui, NULL);
 	return M0_RC(0);
 }
 
@@ -694,11 +852,9 @@ static void fail_idx_xor_recover(struct m0_parity_math *math,
 				 struct m0_buf *parity,
 				 const uint32_t failure_index)
 {
-	uint32_t          ei; /* block element index. */
 	uint32_t          ui; /* unit index. */
 	uint32_t          unit_count;
 	uint32_t          block_size = data[0].b_nob;
-	m0_parity_elem_t  pe;
 
 	M0_PRE(block_size == parity[0].b_nob);
 
@@ -708,19 +864,12 @@ static void fail_idx_xor_recover(struct m0_parity_math *math,
 	for (ui = 1; ui < math->pmi_data_count; ++ui)
 		M0_ASSERT(block_size == data[ui].b_nob);
 
-	for (ei = 0; ei < block_size; ++ei) {
-		pe = 0;
-		for (ui = 0; ui < math->pmi_data_count; ++ui)
-			if (ui != failure_index)
-				pe ^= (m0_parity_elem_t)((uint8_t*)
-				       data[ui].b_addr)[ei];
-
-		if (ui != failure_index)
-			((uint8_t*)data[failure_index].b_addr)[ei] = pe ^
-				((uint8_t*)parity[0].b_addr)[ei];
-		else /* Parity was lost, so recover it. */
-			((uint8_t*)parity[0].b_addr)[ei] = pe;
-	}
+	if (failure_index < math->pmi_data_count)
+		xor_blocks(&data[failure_index], data, math->pmi_data_count,
+			   failure_index, &parity[0]);
+	else /* Parity was lost, so recover it. */
+		xor_blocks(&parity[0], data, math->pmi_data_count,
+			   failure_index, NULL);
 }
 
 /** @todo Iterative reed-solomon decode to be implemented. */
@@ -765,7 +914,6 @@ static inline uint32_t ir_blocks_count(const struct m0_sns_ir *ir)
 static void gfaxpy(struct m0_bufvec *y, struct m0_bufvec *x,
 		   m0_parity_elem_t alpha)
 {
-	uint32_t                i;
 	uint32_t                seg_size;
 	uint8_t                *y_addr;
 	uint8_t                *x_addr;
@@ -789,19 +937,7 @@ static void gfaxpy(struct m0_bufvec *y, struct m0_bufvec *x,
 		x_addr  = m0_bufvec_cursor_addr(&x_cursor);
 		y_addr  = m0_bufvec_cursor_addr(&y_cursor);
 
-		switch (alpha) {
-		/* This is a special case of the 'default' case that follows.
-		 * Here we avoid unnecessary call to gmul.*/
-		case 1:
-			for (i = 0; i <seg_size; ++i)
-				y_addr[i] = gadd(y_addr[i], x_addr[i]);
-			break;
-		default:
-			for (i = 0; i < seg_size; ++i)
-				y_addr[i] = gadd(y_addr[i], gmul(x_addr[i],
-							         alpha));
-			break;
-		}
+		m0_parity_mul_add(y_addr, x_addr, alpha, seg_size);
 		step = m0_bufvec_cursor_step(&y_cursor);
 	} while (!m0_bufvec_cursor_move(&x_cursor, step) &&
 		 !m0_bufvec_cursor_move(&y_cursor, step));
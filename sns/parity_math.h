@@ -183,6 +183,33 @@ M0_INTERNAL int m0_parity_math_diff(struct m0_parity_math *math,
 				    struct m0_buf *new_ver,
 				    struct m0_buf *parity, uint32_t index);
 
+/**
+ * Scatter-gather variants of m0_parity_math_calculate(), m0_parity_math_diff()
+ * and m0_parity_math_recover().
+ *
+ * Every unit is a bufvec, data and parity are arrays of pmi_data_count and
+ * pmi_parity_count units, old and new are arrays of pmi_data_count units of
+ * which only the index-th one is accessed. Units have the same total length,
+ * but can be segmented differently, e.g., be page vectors of a client parity
+ * group. Units are processed in place, in cache-sized tiles, so that every
+ * byte is read or written once.
+ *
+ * @retval -ENOMEM failed to allocate tile cursors, units are not changed.
+ */
+M0_INTERNAL int m0_parity_math_calculate_bufvec(struct m0_parity_math *math,
+						struct m0_bufvec *data,
+						struct m0_bufvec *parity);
+M0_INTERNAL int m0_parity_math_diff_bufvec(struct m0_parity_math *math,
+					   struct m0_bufvec *old,
+					   struct m0_bufvec *new,
+					   struct m0_bufvec *parity,
+					   uint32_t index);
+M0_INTERNAL int m0_parity_math_recover_bufvec(struct m0_parity_math *math,
+					      struct m0_bufvec *data,
+					      struct m0_bufvec *parity,
+					      struct m0_buf *fails,
+					      enum m0_parity_linsys_algo algo);
+
 /**
  * Parity block refinement iff one data word of one data unit had changed.
  * @param[in]  data             - data block, treated as uint8_t block with
@@ -25,8 +25,34 @@
 #include "lib/misc.h"
 #include "lib/memory.h"
 #include "lib/assert.h"
+#include "motr/config.h"        /* CONFIG_X86_64 */
 #include "sns/parity_ops.h"
 
+#if defined(CONFIG_X86_64) && !defined(__KERNEL__)
+#  define PARITY_OPS_X86_64
+#  include <immintrin.h>
+#endif
+
+/** Products of a constant and all values of the low and the high nibble. */
+struct parity_mul_tbl {
+	uint8_t pmt_lo[16];
+	uint8_t pmt_hi[16];
+};
+
+struct parity_kernel {
+	const char *pk_name;
+	void      (*pk_xor)(uint8_t *dst, const uint8_t **src, uint32_t nr,
+			    m0_bcount_t len);
+	void      (*pk_mul_add)(uint8_t *dst, const uint8_t *src,
+				const struct parity_mul_tbl *tbl,
+				m0_bcount_t len);
+};
+
+static enum m0_parity_kernel parity_kernel = M0_PARITY_KERNEL_SCALAR;
+static bool parity_kernel_supported[M0_PARITY_KERNEL_NR] = {
+	[M0_PARITY_KERNEL_SCALAR] = true
+};
+
 M0_INTERNAL m0_parity_elem_t m0_parity_pow(m0_parity_elem_t x,
 					   m0_parity_elem_t p)
 {
@@ -42,6 +68,287 @@ M0_INTERNAL m0_parity_elem_t m0_parity_pow(m0_parity_elem_t x,
 	return ret;
 }
 
+static void xor_bytes(uint8_t *dst, const uint8_t **src, uint32_t nr,
+		      m0_bcount_t off, m0_bcount_t len)
+{
+	uint8_t  acc;
+	uint32_t i;
+
+	for (; off < len; ++off) {
+		for (acc = src[0][off], i = 1; i < nr; ++i)
+			acc ^= src[i][off];
+		dst[off] = acc;
+	}
+}
+
+static void mul_add_bytes(uint8_t *dst, const uint8_t *src,
+			  const struct parity_mul_tbl *tbl,
+			  m0_bcount_t off, m0_bcount_t len)
+{
+	for (; off < len; ++off)
+		dst[off] ^= tbl->pmt_lo[src[off] & 0xf] ^
+			    tbl->pmt_hi[src[off] >> 4];
+}
+
+static void xor_scalar(uint8_t *dst, const uint8_t **src, uint32_t nr,
+		       m0_bcount_t len)
+{
+	uint64_t    acc;
+	uint64_t    w;
+	m0_bcount_t off;
+	uint32_t    i;
+
+	for (off = 0; off + sizeof acc <= len; off += sizeof acc) {
+		memcpy(&acc, src[0] + off, sizeof acc);
+		for (i = 1; i < nr; ++i) {
+			memcpy(&w, src[i] + off, sizeof w);
+			acc ^= w;
+		}
+		memcpy(dst + off, &acc, sizeof acc);
+	}
+	xor_bytes(dst, src, nr, off, len);
+}
+
+static void mul_add_scalar(uint8_t *dst, const uint8_t *src,
+			   const struct parity_mul_tbl *tbl, m0_bcount_t len)
+{
+	mul_add_bytes(dst, src, tbl, 0, len);
+}
+
+#ifdef PARITY_OPS_X86_64
+__attribute__((target("sse2")))
+static void xor_sse2(uint8_t *dst, const uint8_t **src, uint32_t nr,
+		     m0_bcount_t len)
+{
+	__m128i     acc;
+	m0_bcount_t off;
+	uint32_t    i;
+
+	for (off = 0; off + sizeof acc <= len; off += sizeof acc) {
+		acc = _mm_loadu_si128((const __m128i *)(src[0] + off));
+		for (i = 1; i < nr; ++i)
+			acc = _mm_xor_si128(acc, _mm_loadu_si128(
+					    (const __m128i *)(src[i] + off)));
+		_mm_storeu_si128((__m128i *)(dst + off), acc);
+	}
+	xor_bytes(dst, src, nr, off, len);
+}
+
+__attribute__((target("ssse3")))
+static void mul_add_ssse3(uint8_t *dst, const uint8_t *src,
+			  const struct parity_mul_tbl *tbl, m0_bcount_t len)
+{
+	__m128i     lo   = _mm_loadu_si128((const __m128i *)tbl->pmt_lo);
+	__m128i     hi   = _mm_loadu_si128((const __m128i *)tbl->pmt_hi);
+	__m128i     mask = _mm_set1_epi8(0x0f);
+	__m128i     x;
+	__m128i     p;
+	m0_bcount_t off;
+
+	for (off = 0; off + sizeof x <= len; off += sizeof x) {
+		x = _mm_loadu_si128((const __m128i *)(src + off));
+		p = _mm_xor_si128(
+			_mm_shuffle_epi8(lo, _mm_and_si128(x, mask)),
+			_mm_shuffle_epi8(hi, _mm_and_si128(
+					 _mm_srli_epi64(x, 4), mask)));
+		p = _mm_xor_si128(p, _mm_loadu_si128((__m128i *)(dst + off)));
+		_mm_storeu_si128((__m128i *)(dst + off), p);
+	}
+	mul_add_bytes(dst, src, tbl, off, len);
+}
+
+__attribute__((target("avx2")))
+static void xor_avx2(uint8_t *dst, const uint8_t **src, uint32_t nr,
+		     m0_bcount_t len)
+{
+	__m256i     acc;
+	m0_bcount_t off;
+	uint32_t    i;
+
+	for (off = 0; off + sizeof acc <= len; off += sizeof acc) {
+		acc = _mm256_loadu_si256((const __m256i *)(src[0] + off));
+		for (i = 1; i < nr; ++i)
+			acc = _mm256_xor_si256(acc, _mm256_loadu_si256(
+					       (const __m256i *)(src[i] + off)));
+		_mm256_storeu_si256((__m256i *)(dst + off), acc);
+	}
+	xor_bytes(dst, src, nr, off, len);
+}
+
+__attribute__((target("avx2")))
+static void mul_add_avx2(uint8_t *dst, const uint8_t *src,
+			 const struct parity_mul_tbl *tbl, m0_bcount_t len)
+{
+	__m256i     lo   = _mm256_broadcastsi128_si256(
+				_mm_loadu_si128((const __m128i *)tbl->pmt_lo));
+	__m256i     hi   = _mm256_broadcastsi128_si256(
+				_mm_loadu_si128((const __m128i *)tbl->pmt_hi));
+	__m256i     mask = _mm256_set1_epi8(0x0f);
+	__m256i     x;
+	__m256i     p;
+	m0_bcount_t off;
+
+	for (off = 0; off + sizeof x <= len; off += sizeof x) {
+		x = _mm256_loadu_si256((const __m256i *)(src + off));
+		p = _mm256_xor_si256(
+			_mm256_shuffle_epi8(lo, _mm256_and_si256(x, mask)),
+			_mm256_shuffle_epi8(hi, _mm256_and_si256(
+					    _mm256_srli_epi64(x, 4), mask)));
+		p = _mm256_xor_si256(p, _mm256_loadu_si256(
+					     (__m256i *)(dst + off)));
+		_mm256_storeu_si256((__m256i *)(dst + off), p);
+	}
+	mul_add_bytes(dst, src, tbl, off, len);
+}
+
+__attribute__((target("avx512f")))
+static void xor_avx512(uint8_t *dst, const uint8_t **src, uint32_t nr,
+		       m0_bcount_t len)
+{
+	__m512i     acc;
+	m0_bcount_t off;
+	uint32_t    i;
+
+	for (off = 0; off + sizeof acc <= len; off += sizeof acc) {
+		acc = _mm512_loadu_si512(src[0] + off);
+		for (i = 1; i < nr; ++i)
+			acc = _mm512_xor_si512(acc,
+					       _mm512_loadu_si512(src[i] + off));
+		_mm512_storeu_si512(dst + off, acc);
+	}
+	xor_bytes(dst, src, nr, off, len);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void mul_add_avx512(uint8_t *dst, const uint8_t *src,
+			   const struct parity_mul_tbl *tbl, m0_bcount_t len)
+{
+	__m512i     lo   = _mm512_broadcast_i32x4(
+				_mm_loadu_si128((const __m128i *)tbl->pmt_lo));
+	__m512i     hi   = _mm512_broadcast_i32x4(
+				_mm_loadu_si128((const __m128i *)tbl->pmt_hi));
+	__m512i     mask = _mm512_set1_epi8(0x0f);
+	__m512i     x;
+	__m512i     p;
+	m0_bcount_t off;
+
+	for (off = 0; off + sizeof x <= len; off += sizeof x) {
+		x = _mm512_loadu_si512(src + off);
+		p = _mm512_xor_si512(
+			_mm512_shuffle_epi8(lo, _mm512_and_si512(x, mask)),
+			_mm512_shuffle_epi8(hi, _mm512_and_si512(
+					    _mm512_srli_epi64(x, 4), mask)));
+		p = _mm512_xor_si512(p, _mm512_loadu_si512(dst + off));
+		_mm512_storeu_si512(dst + off, p);
+	}
+	mul_add_bytes(dst, src, tbl, off, len);
+}
+#endif
+
+static const struct parity_kernel parity_kernels[M0_PARITY_KERNEL_NR] = {
+	[M0_PARITY_KERNEL_SCALAR] = {
+		.pk_name    = "scalar",
+		.pk_xor     = xor_scalar,
+		.pk_mul_add = mul_add_scalar,
+	},
+#ifdef PARITY_OPS_X86_64
+	[M0_PARITY_KERNEL_SSSE3] = {
+		.pk_name    = "ssse3",
+		.pk_xor     = xor_sse2,
+		.pk_mul_add = mul_add_ssse3,
+	},
+	[M0_PARITY_KERNEL_AVX2] = {
+		.pk_name    = "avx2",
+		.pk_xor     = xor_avx2,
+		.pk_mul_add = mul_add_avx2,
+	},
+	[M0_PARITY_KERNEL_AVX512] = {
+		.pk_name    = "avx512",
+		.pk_xor     = xor_avx512,
+		.pk_mul_add = mul_add_avx512,
+	},
+#endif
+};
+
+M0_INTERNAL void m0_parity_xor(uint8_t *dst, const uint8_t **src, uint32_t nr,
+			       m0_bcount_t len)
+{
+	M0_PRE(nr > 0 && nr <= M0_PARITY_XOR_SRC_MAX);
+	parity_kernels[parity_kernel].pk_xor(dst, src, nr, len);
+}
+
+M0_INTERNAL void m0_parity_mul_add(uint8_t *dst, const uint8_t *src,
+				   m0_parity_elem_t alpha, m0_bcount_t len)
+{
+	struct parity_mul_tbl tbl;
+	const uint8_t        *xor_src[2] = { dst, src };
+	uint32_t              i;
+
+	switch (alpha) {
+	case M0_PARITY_ZERO:
+		break;
+	case 1:
+		m0_parity_xor(dst, xor_src, ARRAY_SIZE(xor_src), len);
+		break;
+	default:
+		for (i = 0; i < ARRAY_SIZE(tbl.pmt_lo); ++i) {
+			tbl.pmt_lo[i] = m0_parity_mul(alpha, i);
+			tbl.pmt_hi[i] = m0_parity_mul(alpha, i << 4);
+		}
+		parity_kernels[parity_kernel].pk_mul_add(dst, src, &tbl, len);
+		break;
+	}
+}
+
+M0_INTERNAL enum m0_parity_kernel m0_parity_kernel_get(void)
+{
+	return parity_kernel;
+}
+
+M0_INTERNAL void m0_parity_kernel_set(enum m0_parity_kernel kernel)
+{
+	M0_PRE(m0_parity_kernel_is_supported(kernel));
+	parity_kernel = kernel;
+}
+
+M0_INTERNAL bool m0_parity_kernel_is_supported(enum m0_parity_kernel kernel)
+{
+	return kernel < M0_PARITY_KERNEL_NR && parity_kernel_supported[kernel];
+}
+
+M0_INTERNAL const char *m0_parity_kernel_name(enum m0_parity_kernel kernel)
+{
+	return kernel < M0_PARITY_KERNEL_NR ?
+		parity_kernels[kernel].pk_name : NULL;
+}
+
+M0_INTERNAL int m0_parity_ops_init(void)
+{
+	enum m0_parity_kernel kernel;
+
+#ifdef PARITY_OPS_X86_64
+	__builtin_cpu_init();
+	parity_kernel_supported[M0_PARITY_KERNEL_SSSE3] =
+		__builtin_cpu_supports("ssse3");
+	parity_kernel_supported[M0_PARITY_KERNEL_AVX2] =
+		__builtin_cpu_supports("avx2");
+	parity_kernel_supported[M0_PARITY_KERNEL_AVX512] =
+		__builtin_cpu_supports("avx512f") &&
+		__builtin_cpu_supports("avx512bw");
+#endif
+	for (kernel = M0_PARITY_KERNEL_NR - 1;
+	     !m0_parity_kernel_is_supported(kernel); --kernel)
+		;
+	parity_kernel = kernel;
+	M0_LOG(M0_DEBUG, "kernel=%s", m0_parity_kernel_name(kernel));
+	return 0;
+}
+
+M0_INTERNAL void m0_parity_ops_fini(void)
+{
+	parity_kernel = M0_PARITY_KERNEL_SCALAR;
+}
+
 #undef M0_TRACE_SUBSYSTEM
 
 /*
@@ -29,12 +29,70 @@
 #include <isa-l.h>
 #endif /* __KERNEL__ */
 #include "lib/assert.h"
+#include "lib/types.h"
 
 #define M0_PARITY_ZERO		(0)
 #define M0_PARITY_GALOIS_W	(8)
 
 typedef int m0_parity_elem_t;
 
+/**
+ * Implementations of the bulk parity kernels m0_parity_xor() and
+ * m0_parity_mul_add().
+ *
+ * Vector kernels multiply by a constant with two 16-entry tables of products
+ * (one per nibble) looked up by a byte shuffle instruction. The best kernel
+ * supported by the processor is selected once in m0_parity_ops_init(), the
+ * scalar kernel is used until then and in the kernel build.
+ */
+enum m0_parity_kernel {
+	M0_PARITY_KERNEL_SCALAR,
+	/** SSE2 xor, SSSE3 pshufb multiplication. */
+	M0_PARITY_KERNEL_SSSE3,
+	M0_PARITY_KERNEL_AVX2,
+	/** AVX512F xor, AVX512BW vpshufb multiplication. */
+	M0_PARITY_KERNEL_AVX512,
+	M0_PARITY_KERNEL_NR
+};
+
+enum {
+	/** Maximal number of sources of a single m0_parity_xor() call. */
+	M0_PARITY_XOR_SRC_MAX = 16,
+};
+
+/**
+ * Sets dst[0, len) to the XOR of src[i][0, len) for i in [0, nr).
+ *
+ * dst may be one of the sources.
+ *
+ * @pre nr > 0 && nr <= M0_PARITY_XOR_SRC_MAX
+ */
+M0_INTERNAL void m0_parity_xor(uint8_t *dst, const uint8_t **src, uint32_t nr,
+			       m0_bcount_t len);
+
+/** Adds alpha * src[0, len) to dst[0, len) in GF(2^8). */
+M0_INTERNAL void m0_parity_mul_add(uint8_t *dst, const uint8_t *src,
+				   m0_parity_elem_t alpha, m0_bcount_t len);
+
+/** Returns the kernel used by m0_parity_xor() and m0_parity_mul_add(). */
+M0_INTERNAL enum m0_parity_kernel m0_parity_kernel_get(void);
+
+/**
+ * Makes m0_parity_xor() and m0_parity_mul_add() use the given kernel.
+ *
+ * For benchmarks and tests only: callers must not run parity math
+ * concurrently.
+ *
+ * @pre m0_parity_kernel_is_supported(kernel)
+ */
+M0_INTERNAL void m0_parity_kernel_set(enum m0_parity_kernel kernel);
+
+M0_INTERNAL bool m0_parity_kernel_is_supported(enum m0_parity_kernel kernel);
+M0_INTERNAL const char *m0_parity_kernel_name(enum m0_parity_kernel kernel);
+
+M0_INTERNAL int  m0_parity_ops_init(void);
+M0_INTERNAL void m0_parity_ops_fini(void);
+
 M0_INTERNAL m0_parity_elem_t m0_parity_pow(m0_parity_elem_t x,
 					   m0_parity_elem_t p);
 
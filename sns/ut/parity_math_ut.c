@@ -28,6 +28,7 @@
 #include "lib/ub.h"
 #include "ut/ut.h"
 #include "sns/parity_math.h"
+#include "sns/parity_ops.h"
 
 #define KB(x)	((x) * 1024)
 #define MB(x)	(KB(x) * 1024)
@@ -1426,6 +1427,151 @@ static void test_init(void)
 	seed = 42;
 }
 
+/* Every supported parity kernel gives the same result as the scalar one. */
+static void test_kernels(void)
+{
+	enum m0_parity_kernel saved = m0_parity_kernel_get();
+	enum m0_parity_kernel kernel;
+	const uint8_t        *src[M0_PARITY_XOR_SRC_MAX];
+	uint64_t              len;
+	uint32_t              alpha;
+	uint32_t              i;
+
+	test_init();
+	for (i = 0; i < DATA_UNIT_COUNT_MAX; ++i)
+		for (len = 0; len < UNIT_BUFF_SIZE; ++len)
+			data[i][len] = m0_rnd64(&seed);
+	for (i = 0; i < ARRAY_SIZE(src); ++i)
+		src[i] = data[i] + i % 3; /* unaligned sources */
+	for (kernel = 0; kernel < M0_PARITY_KERNEL_NR; ++kernel) {
+		if (!m0_parity_kernel_is_supported(kernel))
+			continue;
+		for (len = 0; len < UNIT_BUFF_SIZE; len += 7) {
+			m0_parity_kernel_set(M0_PARITY_KERNEL_SCALAR);
+			m0_parity_xor(expected[0], src, ARRAY_SIZE(src), len);
+			m0_parity_kernel_set(kernel);
+			m0_parity_xor(parity[0] + 1, src, ARRAY_SIZE(src), len);
+			M0_UT_ASSERT(memcmp(expected[0], parity[0] + 1,
+					    len) == 0);
+			for (alpha = 0; alpha < 256; alpha += 51) {
+				memcpy(expected[1], data[20], len);
+				memcpy(parity[1], data[20], len);
+				m0_parity_kernel_set(M0_PARITY_KERNEL_SCALAR);
+				m0_parity_mul_add(expected[1], src[1], alpha,
+						  len);
+				m0_parity_kernel_set(kernel);
+				m0_parity_mul_add(parity[1], src[1], alpha,
+						  len);
+				M0_UT_ASSERT(memcmp(expected[1], parity[1],
+						    len) == 0);
+			}
+		}
+	}
+	m0_parity_kernel_set(saved);
+}
+
+/*
+ * Bufvec entry points over differently segmented units give the same result
+ * as the contiguous ones.
+ */
+static void bufvec_test(uint32_t n, uint32_t k)
+{
+	enum { LEN = 4 * 4096, UNITS_MAX = 6 };
+	struct m0_parity_math   math;
+	struct m0_buf           dbufs[UNITS_MAX];
+	struct m0_buf           nbufs[UNITS_MAX];
+	struct m0_buf           pbufs[UNITS_MAX];
+	struct m0_buf           fail_buf;
+	struct m0_bufvec        vecs[UNITS_MAX];
+	struct m0_bufvec        nvecs[UNITS_MAX];
+	struct m0_bufvec        nvec;
+	struct m0_bufvec_cursor cur;
+	uint8_t                 fails[UNITS_MAX] = {};
+	uint8_t                *ndata = expected[UNITS_MAX];
+	uint32_t                idx = n - 1;
+	uint32_t                i;
+	uint32_t                j;
+	int                     rc;
+
+	M0_PRE(n + k <= UNITS_MAX);
+
+	test_init();
+	rc = m0_parity_math_init(&math, n, k);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < n + k; ++i) {
+		rc = m0_bufvec_alloc(&vecs[i], 1 << i, LEN >> i);
+		M0_UT_ASSERT(rc == 0);
+	}
+	for (i = 0; i < n; ++i) {
+		for (j = 0; j < LEN; ++j)
+			data[i][j] = m0_rnd64(&seed);
+		dbufs[i] = M0_BUF_INIT(LEN, data[i]);
+		m0_bufvec_cursor_init(&cur, &vecs[i]);
+		m0_bufvec_cursor_copyto(&cur, data[i], LEN);
+	}
+	for (i = 0; i < k; ++i)
+		pbufs[i] = M0_BUF_INIT(LEN, parity[i]);
+
+	m0_parity_math_calculate(&math, dbufs, pbufs);
+	rc = m0_parity_math_calculate_bufvec(&math, vecs, vecs + n);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < k; ++i) {
+		m0_bufvec_cursor_init(&cur, &vecs[n + i]);
+		m0_bufvec_cursor_copyfrom(&cur, expected[i], LEN);
+		M0_UT_ASSERT(memcmp(expected[i], parity[i], LEN) == 0);
+	}
+
+	/* Lose the first data unit and recover it. */
+	memset(expected[0], 0xff, LEN);
+	m0_bufvec_cursor_init(&cur, &vecs[0]);
+	m0_bufvec_cursor_copyto(&cur, expected[0], LEN);
+	fails[0] = 1;
+	fail_buf = M0_BUF_INIT(n + k, fails);
+	rc = m0_parity_math_recover_bufvec(&math, vecs, vecs + n, &fail_buf,
+					   M0_LA_GAUSSIAN);
+	M0_UT_ASSERT(rc == 0);
+	m0_bufvec_cursor_init(&cur, &vecs[0]);
+	m0_bufvec_cursor_copyfrom(&cur, expected[0], LEN);
+	M0_UT_ASSERT(memcmp(expected[0], data[0], LEN) == 0);
+
+	/*
+	 * Replace the last data unit with a unit segmented differently and
+	 * update the parity both ways.
+	 */
+	rc = m0_bufvec_alloc(&nvec, 8, LEN / 8);
+	M0_UT_ASSERT(rc == 0);
+	for (j = 0; j < LEN; ++j)
+		ndata[j] = m0_rnd64(&seed);
+	m0_bufvec_cursor_init(&cur, &nvec);
+	m0_bufvec_cursor_copyto(&cur, ndata, LEN);
+	for (i = 0; i < n; ++i) {
+		nbufs[i] = dbufs[i];
+		nvecs[i] = vecs[i];
+	}
+	nbufs[idx] = M0_BUF_INIT(LEN, ndata);
+	nvecs[idx] = nvec;
+	rc = m0_parity_math_diff(&math, dbufs, nbufs, pbufs, idx);
+	M0_UT_ASSERT(rc == 0);
+	rc = m0_parity_math_diff_bufvec(&math, vecs, nvecs, vecs + n, idx);
+	M0_UT_ASSERT(rc == 0);
+	for (i = 0; i < k; ++i) {
+		m0_bufvec_cursor_init(&cur, &vecs[n + i]);
+		m0_bufvec_cursor_copyfrom(&cur, expected[i], LEN);
+		M0_UT_ASSERT(memcmp(expected[i], parity[i], LEN) == 0);
+	}
+	m0_bufvec_free(&nvec);
+
+	for (i = 0; i < n + k; ++i)
+		m0_bufvec_free(&vecs[i]);
+	m0_parity_math_fini(&math);
+}
+
+static void test_bufvec(void)
+{
+	bufvec_test(3, 1);
+	bufvec_test(4, 2);
+}
+
 #define _TESTS									\
 	{ "reed_solomon_recover_with_fail_vec", test_rs_fv_recover },		\
 	{ "reed_solomon_recover_with_fail_vec_rand", test_rs_fv_rand_recover },	\
@@ -1435,6 +1581,8 @@ static void test_init(void)
 	{ "parity_math_diff_xor", test_parity_math_diff_xor },			\
 	{ "parity_math_diff_rs", test_parity_math_diff_rs },			\
 	{ "incr_recov_rs", test_incr_recov_rs },				\
+	{ "kernels", test_kernels },						\
+	{ "bufvec", test_bufvec },						\
 	{ NULL, NULL }
 
 struct m0_ut_suite parity_math_ut = {
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2021 Seagate Technology LLC and/or its Affiliates
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ * For any questions about this software or licensing,
+ * please email opensource@seagate.com or cortx-questions@seagate.com.
+ *
+ */
+
+#include <stdio.h>              /* printf */
+#include <string.h>             /* strlen */
+
+#include "lib/types.h"
+#include "lib/assert.h"
+#include "lib/memory.h"
+
+#include "lib/ub.h"
+#include "ut/ut.h"
+
+#include "sns/parity_ops.h"
+
+/*
+ * Bandwidth of every parity kernel for typical N+K layouts:
+ *
+ * - "x": XOR parity of N data units;
+ * - "g": GF(2^8) encoding of K parity units from N data units with
+ *   m0_parity_mul_add(), as done by incremental recovery.
+ *
+ * Bandwidth is computed over data and parity units, like in parity-math-ub.
+ * Benchmarks of the kernels not supported by the processor are removed from
+ * the set when it is initialised, and reported as skipped.
+ */
+
+enum {
+	UB_ITER      = 100,
+	UB_UNIT_SIZE = 1024 * 1024,
+	UB_UNIT_NR   = 20,
+};
+
+static uint8_t              *ub_units[UB_UNIT_NR];
+static enum m0_parity_kernel ub_kernel_saved;
+
+extern struct m0_ub_set m0_parity_ops_ub;
+
+/* Returns the kernel of a benchmark named "<kernel name> <layout>". */
+static enum m0_parity_kernel ub_bench_kernel(const struct m0_ub_bench *bench)
+{
+	enum m0_parity_kernel kernel;
+	const char           *name;
+	size_t                len;
+
+	for (kernel = 0; kernel < M0_PARITY_KERNEL_NR; ++kernel) {
+		name = m0_parity_kernel_name(kernel);
+		len  = strlen(name);
+		if (strncmp(bench->ub_name, name, len) == 0 &&
+		    bench->ub_name[len] == ' ')
+			break;
+	}
+	M0_ASSERT(kernel < M0_PARITY_KERNEL_NR);
+	return kernel;
+}
+
+/* Removes benchmarks of the kernels not supported by the processor. */
+static void ub_unsupported_skip(struct m0_ub_set *set)
+{
+	struct m0_ub_bench    *src;
+	struct m0_ub_bench    *dst = &set->us_run[0];
+	enum m0_parity_kernel  kernel;
+
+	for (src = &set->us_run[0]; src->ub_name != NULL; ++src) {
+		kernel = ub_bench_kernel(src);
+		if (m0_parity_kernel_is_supported(kernel))
+			*dst++ = *src;
+		else
+			printf("%s: skipped, %s is not supported by the "
+			       "processor\n", src->ub_name,
+			       m0_parity_kernel_name(kernel));
+	}
+	*dst = (struct m0_ub_bench){ .ub_name = NULL };
+}
+
+static int ub_init(const char *opts M0_UNUSED)
+{
+	uint32_t i;
+	uint32_t j;
+
+	ub_unsupported_skip(&m0_parity_ops_ub);
+
+	for (i = 0; i < UB_UNIT_NR; ++i) {
+		M0_ALLOC_ARR(ub_units[i], UB_UNIT_SIZE);
+		M0_UB_ASSERT(ub_units[i] != NULL);
+		for (j = 0; j < UB_UNIT_SIZE; ++j)
+			ub_units[i][j] = i * 31 + j * 7;
+	}
+	ub_kernel_saved = m0_parity_kernel_get();
+	return 0;
+}
+
+static void ub_fini(void)
+{
+	uint32_t i;
+
+	m0_parity_kernel_set(ub_kernel_saved);
+	for (i = 0; i < UB_UNIT_NR; ++i)
+		m0_free(ub_units[i]);
+}
+
+static void ub_xor(enum m0_parity_kernel kernel, uint32_t n)
+{
+	const uint8_t *src[M0_PARITY_XOR_SRC_MAX];
+	uint32_t       i;
+
+	M0_PRE(n < UB_UNIT_NR && n <= ARRAY_SIZE(src));
+
+	m0_parity_kernel_set(kernel);
+	for (i = 0; i < n; ++i)
+		src[i] = ub_units[i];
+	m0_parity_xor(ub_units[n], src, n, UB_UNIT_SIZE);
+}
+
+static void ub_gf(enum m0_parity_kernel kernel, uint32_t n, uint32_t k)
+{
+	uint32_t i;
+	uint32_t j;
+
+	M0_PRE(n + k <= UB_UNIT_NR);
+
+	m0_parity_kernel_set(kernel);
+	for (j = 0; j < k; ++j) {
+		for (i = 0; i < n; ++i)
+			m0_parity_mul_add(ub_units[n + j], ub_units[i],
+					  2 + i + j * n, UB_UNIT_SIZE);
+	}
+}
+
+#define UB_ROUNDS(name, kernel)						\
+static void ub_ ## name ## _x_4_2(int iter)  { ub_xor(kernel, 4); }	\
+static void ub_ ## name ## _x_8_2(int iter)  { ub_xor(kernel, 8); }	\
+static void ub_ ## name ## _x_16_4(int iter) { ub_xor(kernel, 16); }	\
+static void ub_ ## name ## _g_4_2(int iter)  { ub_gf(kernel, 4, 2); }	\
+static void ub_ ## name ## _g_8_2(int iter)  { ub_gf(kernel, 8, 2); }	\
+static void ub_ ## name ## _g_16_4(int iter) { ub_gf(kernel, 16, 4); }
+
+UB_ROUNDS(scalar, M0_PARITY_KERNEL_SCALAR)
+UB_ROUNDS(ssse3,  M0_PARITY_KERNEL_SSSE3)
+UB_ROUNDS(avx2,   M0_PARITY_KERNEL_AVX2)
+UB_ROUNDS(avx512, M0_PARITY_KERNEL_AVX512)
+
+#undef UB_ROUNDS
+
+#define UB_BENCH(name, op, n, k, units)				\
+	{ .ub_name          = #name " " #op #n "+" #k,		\
+	  .ub_iter          = UB_ITER,				\
+	  .ub_round         = ub_ ## name ## _ ## op ## _ ## n ## _ ## k, \
+	  .ub_block_size    = UB_UNIT_SIZE,			\
+	  .ub_blocks_per_op = units }
+
+#define UB_BENCHES(name)					\
+	UB_BENCH(name, x, 4, 2, 5),				\
+	UB_BENCH(name, x, 8, 2, 9),				\
+	UB_BENCH(name, x, 16, 4, 17),				\
+	UB_BENCH(name, g, 4, 2, 6),				\
+	UB_BENCH(name, g, 8, 2, 10),				\
+	UB_BENCH(name, g, 16, 4, 20)
+
+struct m0_ub_set m0_parity_ops_ub = {
+	.us_name = "parity-ops-ub",
+	.us_init = ub_init,
+	.us_fini = ub_fini,
+	.us_run  = {
+		UB_BENCHES(scalar),
+		UB_BENCHES(ssse3),
+		UB_BENCHES(avx2),
+		UB_BENCHES(avx512),
+		{ .ub_name = NULL }
+	}
+};
+
+#undef UB_BENCHES
+#undef UB_BENCH
+
+/*
+ *  Local variables:
+ *  c-indentation-style: "K&R"
+ *  c-basic-offset: 8
+ *  tab-width: 8
+ *  fill-column: 80
+ *  scroll-step: 1
+ *  End:
+ */
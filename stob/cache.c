@@ -26,6 +26,8 @@
 
 #include "motr/magic.h"
 
+#include "lib/misc.h"	/* m0_forall */
+#include "lib/arith.h"	/* max64u */
 #include "stob/stob.h"	/* m0_stob */
 
 /**
@@ -39,204 +41,303 @@ M0_TL_DESCR_DEFINE(stob_cache, "cached stobs", static, struct m0_stob,
 		   M0_STOB_CACHE_MAGIC, M0_STOB_CACHE_HEAD_MAGIC);
 M0_TL_DEFINE(stob_cache, static, struct m0_stob);
 
+static uint64_t stob_hash_func(const struct m0_htable *htable, const void *k)
+{
+	/* low bits of the hash select the shard */
+	return m0_fid_hash(k) / M0_STOB_CACHE_SHARD_NR % htable->h_bucket_nr;
+}
+
+static bool stob_hash_key_eq(const void *key1, const void *key2)
+{
+	return m0_fid_eq(key1, key2);
+}
+
+M0_HT_DESCR_DEFINE(stob_hash, "stob cache hash", static, struct m0_stob,
+		   so_cache_hlink, so_cache_hmagic, M0_STOB_CACHE_HASH_MAGIC,
+		   M0_STOB_CACHE_HASH_HEAD_MAGIC, so_id.si_fid,
+		   stob_hash_func, stob_hash_key_eq);
+M0_HT_DEFINE(stob_hash, static, struct m0_stob, struct m0_fid);
+
+static struct m0_stob_cache_shard *
+stob_cache_shard(const struct m0_stob_cache *cache,
+		 const struct m0_fid *stob_fid)
+{
+	return (struct m0_stob_cache_shard *)
+		&cache->sc_shards[m0_fid_hash(stob_fid) %
+				  M0_STOB_CACHE_SHARD_NR];
+}
+
 M0_INTERNAL int m0_stob_cache_init(struct m0_stob_cache *cache,
 				   uint64_t idle_size,
 				   m0_stob_cache_eviction_cb_t eviction_cb)
 {
+	struct m0_stob_cache_shard *shard;
+	uint64_t                    shard_idle_size;
+	int                         rc = 0;
+	int                         i;
+
+	shard_idle_size = idle_size == 0 ? 0 :
+		max64u(M0_STOB_CACHE_SHARD_IDLE_MIN,
+		       (idle_size + M0_STOB_CACHE_SHARD_NR - 1) /
+		       M0_STOB_CACHE_SHARD_NR);
 	*cache = (struct m0_stob_cache){
-		.sc_idle_size	= idle_size,
-		.sc_idle_used	= 0,
+		.sc_idle_size	= shard_idle_size * M0_STOB_CACHE_SHARD_NR,
 		.sc_eviction_cb = eviction_cb,
-		.sc_busy_hits	= 0,
-		.sc_idle_hits	= 0,
-		.sc_misses	= 0,
-		.sc_evictions	= 0,
 	};
-	m0_mutex_init(&cache->sc_lock);
-	stob_cache_tlist_init(&cache->sc_busy);
-	stob_cache_tlist_init(&cache->sc_idle);
-	return 0;
+	for (i = 0; i < M0_STOB_CACHE_SHARD_NR && rc == 0; ++i) {
+		shard = &cache->sc_shards[i];
+		rc = stob_hash_htable_init(&shard->scs_hash,
+					   M0_STOB_CACHE_BUCKET_NR);
+		if (rc != 0)
+			break;
+		shard->scs_idle_size = shard_idle_size;
+		m0_mutex_init(&shard->scs_lock);
+		stob_cache_tlist_init(&shard->scs_idle);
+	}
+	while (rc != 0 && --i >= 0) {
+		shard = &cache->sc_shards[i];
+		stob_cache_tlist_fini(&shard->scs_idle);
+		m0_mutex_fini(&shard->scs_lock);
+		stob_hash_htable_fini(&shard->scs_hash);
+	}
+	return M0_RC(rc);
 }
 
 M0_INTERNAL void m0_stob_cache_fini(struct m0_stob_cache *cache)
 {
-	struct m0_stob *zombie;
+	struct m0_stob_cache_shard *shard;
+	struct m0_stob             *zombie;
+	int                         i;
 
 	m0_stob_cache_purge(cache, cache->sc_idle_size);
 	m0_stob_cache__print(cache);
-	m0_tl_for(stob_cache, &cache->sc_busy, zombie) {
-		M0_LOG(M0_FATAL, "Still busy "FID_F,
-		       FID_P(m0_stob_fid_get(zombie)));
-	} m0_tl_endfor;
-	m0_tl_for(stob_cache, &cache->sc_idle, zombie) {
-		M0_LOG(M0_FATAL, "Still idle "FID_F,
-		       FID_P(m0_stob_fid_get(zombie)));
-	} m0_tl_endfor;
-	stob_cache_tlist_fini(&cache->sc_idle);
-	stob_cache_tlist_fini(&cache->sc_busy);
-	m0_mutex_fini(&cache->sc_lock);
+	for (i = 0; i < M0_STOB_CACHE_SHARD_NR; ++i) {
+		shard = &cache->sc_shards[i];
+		m0_htable_for(stob_hash, zombie, &shard->scs_hash) {
+			M0_LOG(M0_FATAL, "Still %s "FID_F,
+			       stob_cache_tlink_is_in(zombie) ? "idle" : "busy",
+			       FID_P(m0_stob_fid_get(zombie)));
+		} m0_htable_endfor;
+		stob_cache_tlist_fini(&shard->scs_idle);
+		m0_mutex_fini(&shard->scs_lock);
+		stob_hash_htable_fini(&shard->scs_hash);
+	}
 }
 
-
-M0_INTERNAL bool m0_stob_cache__invariant(const struct m0_stob_cache *cache)
+static bool stob_cache_shard_invariant(const struct m0_stob_cache_shard *shard)
 {
-	return _0C(m0_stob_cache_is_locked(cache)) &&
-	       _0C(cache->sc_idle_size >= cache->sc_idle_used) &&
-	       M0_CHECK_EX(_0C(stob_cache_tlist_length(&cache->sc_idle) ==
-			       cache->sc_idle_used));
+	return _0C(m0_mutex_is_locked(&shard->scs_lock)) &&
+	       _0C(shard->scs_idle_size >= shard->scs_idle_used) &&
+	       M0_CHECK_EX(_0C(stob_cache_tlist_length(&shard->scs_idle) ==
+			       shard->scs_idle_used));
+}
 
+M0_INTERNAL bool m0_stob_cache__invariant(const struct m0_stob_cache *cache,
+					  const struct m0_fid *stob_fid)
+{
+	return stob_cache_shard_invariant(stob_cache_shard(cache, stob_fid));
 }
 
 static void stob_cache_evict(struct m0_stob_cache *cache,
+			     struct m0_stob_cache_shard *shard,
 			     struct m0_stob *stob)
 {
+	stob_hash_htable_del(&shard->scs_hash, stob);
 	cache->sc_eviction_cb(cache, stob);
-	++cache->sc_evictions;
+	++shard->scs_evictions;
 }
 
-static void stob_cache_idle_del(struct m0_stob_cache *cache,
+static void stob_cache_idle_del(struct m0_stob_cache_shard *shard,
 				struct m0_stob *stob)
 {
 	M0_ENTRY("stob %p, stob_fid "FID_F, stob,
 	       FID_P(m0_stob_fid_get(stob)));
 	stob_cache_tlink_del_fini(stob);
-	--cache->sc_idle_used;
+	--shard->scs_idle_used;
+}
+
+/**
+ * Returns the idle stob to be evicted. Referenced stobs met on the way from
+ * the tail of the idle list lose their bit and get a second chance.
+ */
+static struct m0_stob *stob_cache_victim(struct m0_stob_cache_shard *shard)
+{
+	struct m0_stob *stob;
+
+	while ((stob = stob_cache_tlist_tail(&shard->scs_idle)) != NULL &&
+	       stob->so_cache_referenced) {
+		stob->so_cache_referenced = false;
+		stob_cache_tlist_move(&shard->scs_idle, stob);
+	}
+	return stob;
 }
 
 static void stob_cache_idle_moveto(struct m0_stob_cache *cache,
+				   struct m0_stob_cache_shard *shard,
 				   struct m0_stob *stob)
 {
 	struct m0_stob *evicted;
 
-	stob_cache_tlist_move(&cache->sc_idle, stob);
-	++cache->sc_idle_used;
-	if (cache->sc_idle_used > cache->sc_idle_size) {
-		evicted = stob_cache_tlist_tail(&cache->sc_idle);
-		stob_cache_idle_del(cache, evicted);
-		stob_cache_evict(cache, evicted);
+	stob_cache_tlist_add(&shard->scs_idle, stob);
+	++shard->scs_idle_used;
+	if (shard->scs_idle_used > shard->scs_idle_size) {
+		evicted = stob_cache_victim(shard);
+		stob_cache_idle_del(shard, evicted);
+		stob_cache_evict(cache, shard, evicted);
 	}
 }
 
 M0_INTERNAL void m0_stob_cache_add(struct m0_stob_cache *cache,
 				   struct m0_stob *stob)
 {
-	M0_PRE(m0_stob_cache__invariant(cache));
-	M0_PRE_EX(m0_stob_cache_lookup(cache, m0_stob_fid_get(stob)) == NULL);
+	struct m0_stob_cache_shard *shard;
+
+	shard = stob_cache_shard(cache, m0_stob_fid_get(stob));
+	M0_PRE(stob_cache_shard_invariant(shard));
+	M0_PRE_EX(stob_hash_htable_lookup(&shard->scs_hash,
+					  m0_stob_fid_get(stob)) == NULL);
 
-	stob_cache_tlink_init_at(stob, &cache->sc_busy);
+	stob->so_cache_referenced = true;
+	stob_cache_tlink_init(stob);
+	stob_hash_htable_add(&shard->scs_hash, stob);
 }
 
 M0_INTERNAL void m0_stob_cache_idle(struct m0_stob_cache *cache,
 				   struct m0_stob *stob)
 {
-	M0_PRE(m0_stob_cache__invariant(cache));
+	struct m0_stob_cache_shard *shard;
 
-	stob_cache_idle_moveto(cache, stob);
+	shard = stob_cache_shard(cache, m0_stob_fid_get(stob));
+	M0_PRE(stob_cache_shard_invariant(shard));
+	M0_PRE(!stob_cache_tlink_is_in(stob));
+
+	stob_cache_idle_moveto(cache, shard, stob);
 }
 
 M0_INTERNAL struct m0_stob *m0_stob_cache_lookup(struct m0_stob_cache *cache,
 						 const struct m0_fid *stob_fid)
 {
-	struct m0_stob *stob;
-
-	M0_PRE(m0_stob_cache__invariant(cache));
-
-	m0_tl_for(stob_cache, &cache->sc_busy, stob) {
-		if (m0_fid_cmp(stob_fid, m0_stob_fid_get(stob)) == 0) {
-			++cache->sc_busy_hits;
-			return stob;
-		}
-	} m0_tl_endfor;
-
-	m0_tl_for(stob_cache, &cache->sc_idle, stob) {
-		if (m0_fid_cmp(stob_fid, m0_stob_fid_get(stob)) == 0) {
-			++cache->sc_idle_hits;
-			stob_cache_idle_del(cache, stob);
-			stob_cache_tlink_init_at(stob, &cache->sc_busy);
-			return stob;
-		}
-	} m0_tl_endfor;
-
-	++cache->sc_misses;
-	return NULL;
+	struct m0_stob_cache_shard *shard = stob_cache_shard(cache, stob_fid);
+	struct m0_stob             *stob;
+
+	M0_PRE(stob_cache_shard_invariant(shard));
+
+	stob = stob_hash_htable_lookup(&shard->scs_hash, stob_fid);
+	if (stob == NULL) {
+		++shard->scs_misses;
+	} else if (stob_cache_tlink_is_in(stob)) {
+		++shard->scs_idle_hits;
+		stob_cache_idle_del(shard, stob);
+		stob_cache_tlink_init(stob);
+		stob->so_cache_referenced = true;
+	} else {
+		++shard->scs_busy_hits;
+		stob->so_cache_referenced = true;
+	}
+	return stob;
 }
 
-
 M0_INTERNAL void m0_stob_cache_purge(struct m0_stob_cache *cache, int nr)
 {
-	struct m0_stob *stob;
-	struct m0_stob *prev;
-
-	m0_stob_cache_lock(cache);
-	M0_PRE(m0_stob_cache__invariant(cache));
-
-	stob = stob_cache_tlist_tail(&cache->sc_idle);
-	for (; stob != NULL && nr > 0; --nr) {
-		prev = stob_cache_tlist_prev(&cache->sc_idle, stob);
-		stob_cache_idle_del(cache, stob);
-		stob_cache_evict(cache, stob);
-		stob = prev;
+	struct m0_stob_cache_shard *shard;
+	struct m0_stob             *stob;
+	int                         i;
+
+	M0_PRE(m0_stob_cache_is_not_locked(cache));
+
+	for (i = 0; i < M0_STOB_CACHE_SHARD_NR && nr > 0; ++i) {
+		shard = &cache->sc_shards[i];
+		m0_mutex_lock(&shard->scs_lock);
+		M0_PRE(stob_cache_shard_invariant(shard));
+		for (; nr > 0; --nr) {
+			stob = stob_cache_tlist_tail(&shard->scs_idle);
+			if (stob == NULL)
+				break;
+			stob_cache_idle_del(shard, stob);
+			stob_cache_evict(cache, shard, stob);
+		}
+		M0_POST(stob_cache_shard_invariant(shard));
+		m0_mutex_unlock(&shard->scs_lock);
 	}
-
-	M0_POST(m0_stob_cache__invariant(cache));
-	m0_stob_cache_unlock(cache);
 }
 
-M0_INTERNAL void m0_stob_cache_lock(struct m0_stob_cache *cache)
+M0_INTERNAL void m0_stob_cache_lock(struct m0_stob_cache *cache,
+				    const struct m0_fid *stob_fid)
 {
-	m0_mutex_lock(&cache->sc_lock);
+	struct m0_stob_cache_shard *shard = stob_cache_shard(cache, stob_fid);
+	bool                        contended;
+
+	contended = !m0_mutex_trylock(&shard->scs_lock);
+	if (contended)
+		m0_mutex_lock(&shard->scs_lock);
+	++shard->scs_locks;
+	shard->scs_contended += contended;
 }
 
-M0_INTERNAL void m0_stob_cache_unlock(struct m0_stob_cache *cache)
+M0_INTERNAL void m0_stob_cache_unlock(struct m0_stob_cache *cache,
+				      const struct m0_fid *stob_fid)
 {
-	m0_mutex_unlock(&cache->sc_lock);
+	m0_mutex_unlock(&stob_cache_shard(cache, stob_fid)->scs_lock);
 }
 
-M0_INTERNAL bool m0_stob_cache_is_locked(const struct m0_stob_cache *cache)
+M0_INTERNAL bool m0_stob_cache_is_locked(const struct m0_stob_cache *cache,
+					 const struct m0_fid *stob_fid)
 {
-	return m0_mutex_is_locked(&cache->sc_lock);
+	return m0_mutex_is_locked(&stob_cache_shard(cache, stob_fid)->scs_lock);
 }
 
 M0_INTERNAL bool m0_stob_cache_is_not_locked(const struct m0_stob_cache *cache)
 {
-	return m0_mutex_is_not_locked(&cache->sc_lock);
+	return m0_forall(i, M0_STOB_CACHE_SHARD_NR,
+		m0_mutex_is_not_locked(&cache->sc_shards[i].scs_lock));
 }
 
 M0_INTERNAL void m0_stob_cache__print(struct m0_stob_cache *cache)
 {
 #define LEVEL M0_DEBUG
-	struct m0_stob *stob;
-	int		i;
-
+	struct m0_stob_cache_shard *shard;
+	struct m0_stob             *stob;
+	uint64_t                    busy_hits = 0;
+	uint64_t                    idle_hits = 0;
+	uint64_t                    misses = 0;
+	uint64_t                    evictions = 0;
+	uint64_t                    idle_used = 0;
+	int                         i;
+	int                         j;
+
+	for (i = 0; i < M0_STOB_CACHE_SHARD_NR; ++i) {
+		shard = &cache->sc_shards[i];
+		busy_hits += shard->scs_busy_hits;
+		idle_hits += shard->scs_idle_hits;
+		misses    += shard->scs_misses;
+		evictions += shard->scs_evictions;
+		idle_used += shard->scs_idle_used;
+	}
 	M0_LOG(LEVEL, "m0_stob_cache %p: "
 	       "sc_busy_hits = %" PRIu64 ", sc_idle_hits = %" PRIu64 ", "
 	       "sc_misses = %" PRIu64 ", sc_evictions = %"PRIu64, cache,
-	       cache->sc_busy_hits, cache->sc_idle_hits,
-	       cache->sc_misses, cache->sc_evictions);
+	       busy_hits, idle_hits, misses, evictions);
 	M0_LOG(LEVEL, "m0_stob_cache %p: "
 	       "sc_idle_size = %" PRIu64 ", sc_idle_used = %" PRIu64 ", ",
-	       cache, cache->sc_idle_size, cache->sc_idle_used);
-	M0_LOG(LEVEL, "m0_stob_cache %p: "
-	       "sc_busy length = %zu, sc_idle length = %zu", cache,
-	       stob_cache_tlist_length(&cache->sc_busy),
-	       stob_cache_tlist_length(&cache->sc_idle));
-
-
-	M0_LOG(LEVEL, "m0_stob_cache %p: sc_busy list", cache);
-	i = 0;
-	m0_tl_for(stob_cache, &cache->sc_busy, stob) {
-		M0_LOG(LEVEL, "%d: %p, stob_fid =" FID_F,
-		       i, stob, FID_P(m0_stob_fid_get(stob)));
-		++i;
-	} m0_tl_endfor;
-
-	M0_LOG(LEVEL, "m0_stob_cache %p: sc_idle list", cache);
-	i = 0;
-	m0_tl_for(stob_cache, &cache->sc_idle, stob) {
-		M0_LOG(LEVEL, "%d: %p, stob_key =" FID_F,
-		       i, stob, FID_P(m0_stob_fid_get(stob)));
-		++i;
-	} m0_tl_endfor;
+	       cache, cache->sc_idle_size, idle_used);
+
+	for (i = 0; i < M0_STOB_CACHE_SHARD_NR; ++i) {
+		shard = &cache->sc_shards[i];
+		M0_LOG(LEVEL, "m0_stob_cache %p: shard %d: "
+		       "size = %" PRIu64 ", idle = %" PRIu64 ", "
+		       "locks = %" PRIu64 ", contended = %" PRIu64,
+		       cache, i, m0_htable_size(&shard->scs_hash),
+		       shard->scs_idle_used, shard->scs_locks,
+		       shard->scs_contended);
+		j = 0;
+		m0_htable_for(stob_hash, stob, &shard->scs_hash) {
+			M0_LOG(LEVEL, "%d: %p, %s, stob_fid =" FID_F,
+			       j, stob,
+			       stob_cache_tlink_is_in(stob) ? "idle" : "busy",
+			       FID_P(m0_stob_fid_get(stob)));
+			++j;
+		} m0_htable_endfor;
+	}
 	M0_LOG(LEVEL, "m0_stob_cache %p: end.", cache);
 #undef LEVEL
 }
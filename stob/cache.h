@@ -27,13 +27,26 @@
 
 #include "lib/mutex.h"	/* m0_mutex */
 #include "lib/tlist.h"	/* m0_tl */
+#include "lib/hash.h"	/* m0_htable */
 #include "lib/types.h"	/* uint64_t */
 #include "fid/fid.h"    /* m0_fid */
 
 /**
  * @defgroup stob Storage object
  *
- * @todo more scalable object index instead of a list.
+ * Stob cache keeps stobs found by m0_stob_find() and friends.
+ *
+ * A stob is either busy (it has references) or idle (it has no references but
+ * is kept in the cache to be found again cheaply). Stobs are spread among
+ * M0_STOB_CACHE_SHARD_NR shards by the hash of their fid. Every shard has its
+ * own lock, a hash table of all its stobs and a list of idle stobs, so lookup
+ * takes O(1) and stob finds for different fids rarely contend.
+ *
+ * Idle stobs are evicted with the CLOCK (second chance) policy: a stob which
+ * was added or found in the cache since it had been given its last chance is
+ * moved to the head of the idle list instead of being evicted. Hence the stob
+ * which has just become idle is evicted only when it is the only idle stob of
+ * its shard.
  *
  * @{
  */
@@ -43,28 +56,56 @@ struct m0_stob_cache;
 
 typedef void (*m0_stob_cache_eviction_cb_t)(struct m0_stob_cache *cache,
 					    struct m0_stob *stob);
-/**
- * @todo document
- */
+
+enum {
+	/** Number of shards in a stob cache. */
+	M0_STOB_CACHE_SHARD_NR       = 32,
+	/** Number of hash buckets in a shard. */
+	M0_STOB_CACHE_BUCKET_NR      = 16,
+	/**
+	 * Minimal number of idle stobs a shard keeps, unless the cache is
+	 * created with zero idle size.
+	 */
+	M0_STOB_CACHE_SHARD_IDLE_MIN = 8,
+};
+
+/** Part of stob cache protected by a single lock. */
+struct m0_stob_cache_shard {
+	struct m0_mutex             scs_lock;
+	/** All stobs of the shard: busy and idle. */
+	struct m0_htable            scs_hash;
+	/** Idle stobs, the most recently idle first. */
+	struct m0_tl                scs_idle;
+	uint64_t                    scs_idle_size;
+	uint64_t                    scs_idle_used;
+
+	uint64_t                    scs_busy_hits;
+	uint64_t                    scs_idle_hits;
+	uint64_t                    scs_misses;
+	uint64_t                    scs_evictions;
+	/** Number of times scs_lock was taken. */
+	uint64_t                    scs_locks;
+	/** Number of times scs_lock was taken after waiting for it. */
+	uint64_t                    scs_contended;
+};
+
 struct m0_stob_cache {
-	struct m0_mutex             sc_lock;
-	struct m0_tl		    sc_busy;
-	struct m0_tl		    sc_idle;
-	uint64_t		    sc_idle_size;
-	uint64_t		    sc_idle_used;
+	struct m0_stob_cache_shard  sc_shards[M0_STOB_CACHE_SHARD_NR];
+	/** Maximum number of idle stobs in all shards together. */
+	uint64_t                    sc_idle_size;
 	m0_stob_cache_eviction_cb_t sc_eviction_cb;
-
-	uint64_t		    sc_busy_hits;
-	uint64_t		    sc_idle_hits;
-	uint64_t		    sc_misses;
-	uint64_t		    sc_evictions;
 };
 
 /**
  * Initialises stob cache.
  *
+ * Every shard keeps up to idle_size / M0_STOB_CACHE_SHARD_NR (rounded up) idle
+ * stobs, but no less than M0_STOB_CACHE_SHARD_IDLE_MIN, so that a shard with a
+ * few idle stobs doesn't evict them on every m0_stob_put(). Hence the total
+ * number of idle stobs can exceed idle_size.
+ *
  * @param cache stob cache
- * @param idle_size idle list maximum size
+ * @param idle_size idle list maximum size, 0 disables idle caching
  */
 M0_INTERNAL int m0_stob_cache_init(struct m0_stob_cache *cache,
 				   uint64_t idle_size,
@@ -72,19 +113,20 @@ M0_INTERNAL int m0_stob_cache_init(struct m0_stob_cache *cache,
 M0_INTERNAL void m0_stob_cache_fini(struct m0_stob_cache *cache);
 
 /**
- * Stob cache invariant.
+ * Invariant of the stob cache shard stob_fid belongs to.
  *
- * @pre m0_stob_cache_is_locked(cache)
- * @post m0_stob_cache_is_locked(cache)
+ * @pre m0_stob_cache_is_locked(cache, stob_fid)
+ * @post m0_stob_cache_is_locked(cache, stob_fid)
  */
-M0_INTERNAL bool m0_stob_cache__invariant(const struct m0_stob_cache *cache);
+M0_INTERNAL bool m0_stob_cache__invariant(const struct m0_stob_cache *cache,
+					  const struct m0_fid *stob_fid);
 
 /**
  * Adds stob to the stob cache. Stob should be deleted from the stob cache using
  * m0_stob_cache_idle().
  *
- * @pre m0_stob_cache_is_locked(cache)
- * @post m0_stob_cache_is_locked(cache)
+ * @pre m0_stob_cache_is_locked(cache, m0_stob_fid_get(stob))
+ * @post m0_stob_cache_is_locked(cache, m0_stob_fid_get(stob))
  */
 M0_INTERNAL void m0_stob_cache_add(struct m0_stob_cache *cache,
 				   struct m0_stob *stob);
@@ -92,8 +134,8 @@ M0_INTERNAL void m0_stob_cache_add(struct m0_stob_cache *cache,
 /**
  * Deletes item from the stob cache.
  *
- * @pre m0_stob_cache_is_locked(cache)
- * @post m0_stob_cache_is_locked(cache)
+ * @pre m0_stob_cache_is_locked(cache, m0_stob_fid_get(stob))
+ * @post m0_stob_cache_is_locked(cache, m0_stob_fid_get(stob))
  */
 M0_INTERNAL void m0_stob_cache_idle(struct m0_stob_cache *cache,
 				   struct m0_stob *stob);
@@ -102,8 +144,8 @@ M0_INTERNAL void m0_stob_cache_idle(struct m0_stob_cache *cache,
  * Finds item in the stob cache. Stob found should be deleted from the stob
  * cache using m0_stob_cache_idle().
  *
- * @pre m0_stob_cache_is_locked(cache)
- * @post m0_stob_cache_is_locked(cache)
+ * @pre m0_stob_cache_is_locked(cache, stob_fid)
+ * @post m0_stob_cache_is_locked(cache, stob_fid)
  */
 M0_INTERNAL struct m0_stob *m0_stob_cache_lookup(struct m0_stob_cache *cache,
 						 const struct m0_fid *stob_fid);
@@ -116,13 +158,19 @@ M0_INTERNAL struct m0_stob *m0_stob_cache_lookup(struct m0_stob_cache *cache,
  */
 M0_INTERNAL void m0_stob_cache_purge(struct m0_stob_cache *cache, int nr);
 
-M0_INTERNAL void m0_stob_cache_lock(struct m0_stob_cache *cache);
-M0_INTERNAL void m0_stob_cache_unlock(struct m0_stob_cache *cache);
-M0_INTERNAL bool m0_stob_cache_is_locked(const struct m0_stob_cache *cache);
+/** Locks the shard of the stob cache stob_fid belongs to. */
+M0_INTERNAL void m0_stob_cache_lock(struct m0_stob_cache *cache,
+				    const struct m0_fid *stob_fid);
+M0_INTERNAL void m0_stob_cache_unlock(struct m0_stob_cache *cache,
+				      const struct m0_fid *stob_fid);
+M0_INTERNAL bool m0_stob_cache_is_locked(const struct m0_stob_cache *cache,
+					 const struct m0_fid *stob_fid);
+/** Checks that no shard of the stob cache is locked by the current thread. */
 M0_INTERNAL bool m0_stob_cache_is_not_locked(const struct m0_stob_cache *cache);
 
 M0_INTERNAL void m0_stob_cache__print(struct m0_stob_cache *cache);
 
+/** @} end group stob */
 
 #endif /* __MOTR_STOB_CACHE_H__ */
 
@@ -26,6 +26,7 @@
 
 #include <limits.h>			/* IOV_MAX */
 #include <sys/uio.h>			/* iovec */
+#include <stdlib.h>			/* qsort */
 #include <libaio.h>                     /* io_getevents */
 
 #include "ha/ha.h"                      /* m0_ha_send */
@@ -56,19 +57,24 @@
    IO interfaces: io_{setup,destroy,submit,cancel,getevents}().
 
    IO admission control and queueing in Linux stob adieu are implemented on a
-   storage object domain level, that is, each domain has its own set of queues,
-   threads and thresholds.
+   device level, that is, each device backing stobs of a storage object domain
+   has its own set of queues, threads and thresholds (m0_stob_ioq_dev). Device
+   queues are created on demand, when the first stob on the device is opened.
+   Devices are told apart by st_rdev of a block device or st_dev of a regular
+   file. A slow device thus only exhausts its own ring buffer and keeps its own
+   threads busy, completions of other devices are not delayed.
 
    On a high level, adieu IO request is first split into fragments. A fragment
-   is initially placed into a per-domain queue (admission queue,
-   linux_domain::ioq_queue) where it is held until there is enough space in the
-   AIO ring buffer (linux_domain::ioq_ctx). Placing a fragment into the ring
-   buffer (ioq_queue_submit()) means that kernel AIO is launched for it. When IO
-   completes, the kernel delivers an IO completion event via the ring buffer.
+   is initially placed into a per-device queue (admission queue,
+   m0_stob_ioq_dev::iqd_queue) where it is held until there is enough space in
+   the AIO ring buffer (m0_stob_ioq_dev::iqd_ctx). Placing a fragment into the
+   ring buffer (ioq_queue_submit()) means that kernel AIO is launched for it.
+   When IO completes, the kernel delivers an IO completion event via the ring
+   buffer.
 
-   A number (M0_STOB_IOQ_NR_THREADS by default) of worker adieu threads is
-   created for each storage object domain. These threads are implementing
-   admission control and completion notification, they
+   A number (M0_STOB_IOQ_NR_THREADS by default, see m0_stob_ioq_init()) of
+   worker adieu threads is created for each device queue. These threads are
+   implementing admission control and completion notification, they
 
        - listen for the AIO completion events in the ring buffer. When an AIO is
          completed, worker thread signals completion event to AIO users;
@@ -81,13 +87,30 @@
 
        - be able to handle more pending fragments than a kernel can support and
 
-       - potentially do some pre-processing on the pending fragments (like
-         elevator does).
+       - do some pre-processing on the pending fragments, like elevator does.
+
+   <b>Batching and merging</b>
+
+   Fragments are moved to the ring buffer and completion events are extracted
+   from it in batches. Batch sizes adapt to the queue depth: with few pending
+   fragments (or few fragments in flight) small batches keep latency low, a
+   deep queue is drained in batches of up to M0_STOB_IOQ_BATCH_IN_MAX
+   (M0_STOB_IOQ_BATCH_OUT_MAX), see ioq_batch().
+
+   Before a batch is submitted, it is sorted by file, opcode and offset, and
+   fragments adjacent on the stob are merged into a single request, even if
+   they belong to different adieu requests (ioq_merge()). The head fragment of
+   a merged group owns the combined iocb (ioq_merge), other fragments are
+   linked to it through ioq_qev::iq_merged. When the merged request completes,
+   its result is split among the fragments of the group, which are then
+   completed as usual. Sequential streams of small requests thus reach the
+   device as large requests.
 
    <b>Concurrency control</b>
 
-   Per-domain data structures (queue, thresholds, etc.) are protected by
-   linux_domain::ioq_mutex.
+   Per-device data structures (queue, thresholds, etc.) are protected by
+   m0_stob_ioq_dev::iqd_lock. The array of device queues is protected by
+   m0_stob_ioq::ioq_lock.
 
    Concurrency control for an individual adieu fragment is very simple: user is
    not allowed to touch it in SIS_BUSY state and io_getevents() exactly-once
@@ -96,6 +119,30 @@
    implemented, because it requires synchronization between user actions
    (cancellation) and ongoing IO in SIS_BUSY state.
 
+   <b>io_uring backend</b>
+
+   When the queue is initialised with M0_STOB_IOQ_URING (and motr is built
+   with --enable-io-uring), the ring buffer of each device queue is an io_uring
+   instance (m0_stob_ioq_dev::iqd_uring) instead of an AIO context. Fragments
+   are prepared, batched and merged exactly as for libaio (an iocb keeps the
+   iovec, offset and opcode), the admission queue and iqd_avail accounting are
+   shared. The differences are:
+
+       - ioq_queue_submit() fills submission queue entries under
+         m0_stob_ioq_dev::iqd_lock and submits them with a single
+         io_uring_submit() call. With M0_STOB_IOQ_SQPOLL the kernel polls the
+         submission queue and no system call is made while it is busy;
+
+       - worker threads take turns waiting on the completion queue under
+         m0_stob_ioq_dev::iqd_cq_lock, extract a batch of completions and
+         process them with ioq_complete() outside of the lock;
+
+       - file descriptors of linux stobs are registered as fixed files
+         (m0_stob_ioq_file_register()) and buffers registered with
+         m0_stob_ioq_buffers_register() are used by fixed-buffer operations.
+
+   If io_uring cannot be set up, the queue falls back to libaio.
+
    @todo use explicit state machine instead of ioq threads
 
    @see http://www.kernel.org/doc/man-pages/online/pages/man2/io_setup.2.html
@@ -115,10 +162,24 @@ struct ioq_qev {
 	struct iocb           iq_iocb;
 	m0_bcount_t           iq_nbytes;
 	m0_bindex_t           iq_offset;
-	/** Linkage to a per-domain admission queue
-	    (linux_domain::ioq_queue). */
+	/** io_uring fixed file slot of the stob, m0_stob_linux::sl_fd_slot. */
+	int                   iq_fd_slot;
+	/** Linkage to a per-device admission queue
+	    (m0_stob_ioq_dev::iqd_queue). */
 	struct m0_queue_link  iq_linkage;
 	struct m0_stob_io    *iq_io;
+	/** Combined request, when this is the head of a merged group. */
+	struct ioq_merge     *iq_merge;
+	/** Next fragment of a merged group. */
+	struct ioq_qev       *iq_merged;
+};
+
+/**
+   Request submitted for a group of fragments merged by ioq_merge().
+ */
+struct ioq_merge {
+	struct iocb           im_iocb;
+	struct iovec          im_iov[];
 };
 
 /**
@@ -126,23 +187,25 @@ struct ioq_qev {
  */
 struct stob_linux_io {
 	/** Number of fragments in this adieu request. */
-	uint32_t           si_nr;
+	uint32_t                si_nr;
 	/** Number of completed fragments. */
-	struct m0_atomic64 si_done;
+	struct m0_atomic64      si_done;
 	/** Number of completed bytes. */
-	struct m0_atomic64 si_bdone;
+	struct m0_atomic64      si_bdone;
 	/** Array of fragments. */
-	struct ioq_qev    *si_qev;
+	struct ioq_qev         *si_qev;
 	/** Main ioq struct */
-	struct m0_stob_ioq *si_ioq;
+	struct m0_stob_ioq     *si_ioq;
+	/** Queue of the device the stob is on. */
+	struct m0_stob_ioq_dev *si_dev;
 };
 
-static struct ioq_qev *ioq_queue_get   (struct m0_stob_ioq *ioq);
-static void            ioq_queue_put   (struct m0_stob_ioq *ioq,
+static struct ioq_qev *ioq_queue_get   (struct m0_stob_ioq_dev *dev);
+static void            ioq_queue_put   (struct m0_stob_ioq_dev *dev,
 					struct ioq_qev *qev);
-static void            ioq_queue_submit(struct m0_stob_ioq *ioq);
-static void            ioq_queue_lock  (struct m0_stob_ioq *ioq);
-static void            ioq_queue_unlock(struct m0_stob_ioq *ioq);
+static void            ioq_queue_submit(struct m0_stob_ioq_dev *dev);
+static void            ioq_queue_lock  (struct m0_stob_ioq_dev *dev);
+static void            ioq_queue_unlock(struct m0_stob_ioq_dev *dev);
 
 static const struct m0_stob_io_op stob_linux_io_op;
 
@@ -172,6 +235,7 @@ M0_INTERNAL int m0_stob_linux_io_init(struct m0_stob *stob,
 		io->si_stob_private = lio;
 		io->si_op = &stob_linux_io_op;
 		lio->si_ioq = &lstob->sl_dom->sld_ioq;
+		lio->si_dev = lstob->sl_ioq_dev;
 		result = 0;
 	} else
 		result = M0_ERR(-ENOMEM);
@@ -204,21 +268,22 @@ static void stob_linux_io_fini(struct m0_stob_io *io)
  */
 static int stob_linux_io_launch(struct m0_stob_io *io)
 {
-	struct m0_stob_linux *lstob = m0_stob_linux_container(io->si_obj);
-	struct stob_linux_io *lio   = io->si_stob_private;
-	struct m0_stob_ioq   *ioq   = lio->si_ioq;
-	struct ioq_qev       *qev;
-	struct iovec         *iov;
-	struct m0_vec_cursor  src;
-	struct m0_vec_cursor  dst;
-	uint32_t              frags = 0;
-	uint32_t              chunks; /* contiguous stob chunks */
-	m0_bcount_t           frag_size;
-	int                   result = 0;
-	int                   i;
-	bool                  eosrc;
-	bool                  eodst;
-	int                   opcode;
+	struct m0_stob_linux   *lstob = m0_stob_linux_container(io->si_obj);
+	struct stob_linux_io   *lio   = io->si_stob_private;
+	struct m0_stob_ioq     *ioq   = lio->si_ioq;
+	struct m0_stob_ioq_dev *dev   = lio->si_dev;
+	struct ioq_qev         *qev;
+	struct iovec           *iov;
+	struct m0_vec_cursor    src;
+	struct m0_vec_cursor    dst;
+	uint32_t                frags = 0;
+	uint32_t                chunks; /* contiguous stob chunks */
+	m0_bcount_t             frag_size;
+	int                     result = 0;
+	int                     i;
+	bool                    eosrc;
+	bool                    eodst;
+	int                     opcode;
 
 	M0_PRE(M0_IN(io->si_opcode, (SIO_READ, SIO_WRITE)));
 	/* prefix fragments execution mode is not yet supported */
@@ -259,7 +324,7 @@ static int stob_linux_io_launch(struct m0_stob_io *io)
 	}
 	opcode = io->si_opcode == SIO_READ ? IO_CMD_PREADV : IO_CMD_PWRITEV;
 
-	ioq_queue_lock(ioq);
+	ioq_queue_lock(dev);
 	while (result == 0) {
 		struct iocb *iocb = &qev->iq_iocb;
 		m0_bindex_t  off = io->si_stob.iv_index[dst.vc_seg] +
@@ -268,8 +333,10 @@ static int stob_linux_io_launch(struct m0_stob_io *io)
 		m0_bcount_t  chunk_size = 0;
 
 		qev->iq_io = io;
+		qev->iq_fd_slot = lstob->sl_fd_slot;
 		m0_queue_link_init(&qev->iq_linkage);
 
+		iocb->data = qev;
 		iocb->u.v.vec = iov;
 		iocb->aio_fildes = lstob->sl_fd;
 		iocb->u.v.nr = min32u(frags, IOV_MAX);
@@ -313,7 +380,7 @@ static int stob_linux_io_launch(struct m0_stob_io *io)
 			qev->iq_nbytes = chunk_size << m0_stob_ioq_bshift(ioq);
 			qev->iq_offset = off << m0_stob_ioq_bshift(ioq);
 
-			ioq_queue_put(ioq, qev);
+			ioq_queue_put(dev, qev);
 
 			frags -= i;
 			if (frags == 0)
@@ -328,14 +395,14 @@ static int stob_linux_io_launch(struct m0_stob_io *io)
 	 * the lio->si_nr is correctly updated. When this lock is released,
 	 * these 'qev's may be submitted.
 	 */
-	ioq_queue_unlock(ioq);
+	ioq_queue_unlock(dev);
 out:
 	if (result != 0) {
 		M0_LOG(M0_ERROR, "Launch op=%d io=%p failed: rc=%d",
 				 io->si_opcode, io, result);
 		stob_linux_io_release(lio);
 	} else
-		ioq_queue_submit(ioq);
+		ioq_queue_submit(dev);
 
 	return result;
 }
@@ -348,82 +415,343 @@ static const struct m0_stob_io_op stob_linux_io_op = {
 /**
    Removes an element from the (non-empty) admission queue and returns it.
  */
-static struct ioq_qev *ioq_queue_get(struct m0_stob_ioq *ioq)
+static struct ioq_qev *ioq_queue_get(struct m0_stob_ioq_dev *dev)
 {
 	struct m0_queue_link *head;
 
-	M0_ASSERT(!m0_queue_is_empty(&ioq->ioq_queue));
-	M0_ASSERT(m0_mutex_is_locked(&ioq->ioq_lock));
+	M0_ASSERT(!m0_queue_is_empty(&dev->iqd_queue));
+	M0_ASSERT(m0_mutex_is_locked(&dev->iqd_lock));
 
-	head = m0_queue_get(&ioq->ioq_queue);
-	ioq->ioq_queued--;
-	M0_ASSERT_EX(ioq->ioq_queued == m0_queue_length(&ioq->ioq_queue));
+	head = m0_queue_get(&dev->iqd_queue);
+	dev->iqd_queued--;
+	M0_ASSERT_EX(dev->iqd_queued == m0_queue_length(&dev->iqd_queue));
 	return container_of(head, struct ioq_qev, iq_linkage);
 }
 
 /**
    Adds an element to the admission queue.
  */
-static void ioq_queue_put(struct m0_stob_ioq *ioq,
+static void ioq_queue_put(struct m0_stob_ioq_dev *dev,
 			  struct ioq_qev *qev)
 {
 	M0_ASSERT(!m0_queue_link_is_in(&qev->iq_linkage));
-	M0_ASSERT(m0_mutex_is_locked(&ioq->ioq_lock));
-	// M0_ASSERT(qev->iq_io->si_obj->so_domain == &ioq->sdl_base);
+	M0_ASSERT(m0_mutex_is_locked(&dev->iqd_lock));
 
-	m0_queue_put(&ioq->ioq_queue, &qev->iq_linkage);
-	ioq->ioq_queued++;
-	M0_ASSERT_EX(ioq->ioq_queued == m0_queue_length(&ioq->ioq_queue));
+	m0_queue_put(&dev->iqd_queue, &qev->iq_linkage);
+	dev->iqd_queued++;
+	M0_ASSERT_EX(dev->iqd_queued == m0_queue_length(&dev->iqd_queue));
 }
 
-static void ioq_queue_lock(struct m0_stob_ioq *ioq)
+static void ioq_queue_lock(struct m0_stob_ioq_dev *dev)
 {
-	m0_mutex_lock(&ioq->ioq_lock);
+	m0_mutex_lock(&dev->iqd_lock);
 }
 
-static void ioq_queue_unlock(struct m0_stob_ioq *ioq)
+static void ioq_queue_unlock(struct m0_stob_ioq_dev *dev)
 {
-	m0_mutex_unlock(&ioq->ioq_lock);
+	m0_mutex_unlock(&dev->iqd_lock);
+}
+
+/**
+   Returns the size of a batch for a queue with "depth" pending items.
+
+   The items are shared by the worker threads of the queue, each thread takes
+   its share in one batch, but no less than "min" and no more than "max" items.
+ */
+static int ioq_batch(const struct m0_stob_ioq_dev *dev,
+		     int depth, int min, int max)
+{
+	return min32(max32(depth / dev->iqd_ioq->ioq_nr_threads, min), max);
+}
+
+/**
+   Moves a batch of at most "nr" fragments from the admission queue to "qev",
+   reserving ring buffer slots for them.
+ */
+static int ioq_queue_batch(struct m0_stob_ioq_dev *dev,
+			   struct ioq_qev **qev, int nr)
+{
+	int got;
+	int i;
+
+	M0_PRE(m0_mutex_is_locked(&dev->iqd_lock));
+
+	got = min32(dev->iqd_queued,
+		    min32(m0_atomic64_get(&dev->iqd_avail),
+			  min32(nr, ioq_batch(dev, dev->iqd_queued,
+					      M0_STOB_IOQ_BATCH_IN_SIZE,
+					      M0_STOB_IOQ_BATCH_IN_MAX))));
+	m0_atomic64_sub(&dev->iqd_avail, got);
+	for (i = 0; i < got; ++i)
+		qev[i] = ioq_queue_get(dev);
+	return got;
+}
+
+/** Order of fragments in which adjacent ones are next to each other. */
+static bool ioq_qev_lt(const struct ioq_qev *a, const struct ioq_qev *b)
+{
+	const struct iocb *x = &a->iq_iocb;
+	const struct iocb *y = &b->iq_iocb;
+
+	if (x->aio_fildes != y->aio_fildes)
+		return x->aio_fildes < y->aio_fildes;
+	if (x->aio_lio_opcode != y->aio_lio_opcode)
+		return x->aio_lio_opcode < y->aio_lio_opcode;
+	return x->u.v.offset < y->u.v.offset;
+}
+
+static bool ioq_qev_adjacent(const struct ioq_qev *a, const struct ioq_qev *b)
+{
+	return a->iq_iocb.aio_fildes == b->iq_iocb.aio_fildes &&
+	       a->iq_iocb.aio_lio_opcode == b->iq_iocb.aio_lio_opcode &&
+	       a->iq_offset + a->iq_nbytes == b->iq_offset;
+}
+
+/**
+   Builds the combined request for fragments qev[0 .. nr - 1], which are
+   adjacent and sorted by offset. Returns false if memory is short, the
+   fragments are then submitted separately.
+ */
+static bool ioq_merge_group(struct ioq_qev **qev, int nr, int iov_nr)
+{
+	struct ioq_merge *m;
+	struct iocb      *iocb;
+	int               i;
+	int               j = 0;
+
+	m = m0_alloc(sizeof *m + iov_nr * sizeof m->im_iov[0]);
+	if (m == NULL)
+		return false;
+	iocb = &m->im_iocb;
+	*iocb = qev[0]->iq_iocb;
+	iocb->u.v.vec = m->im_iov;
+	iocb->u.v.nr  = iov_nr;
+	for (i = 0; i < nr; ++i) {
+		memcpy(&m->im_iov[j], qev[i]->iq_iocb.u.v.vec,
+		       qev[i]->iq_iocb.u.v.nr * sizeof m->im_iov[0]);
+		j += qev[i]->iq_iocb.u.v.nr;
+		qev[i]->iq_merged = i + 1 < nr ? qev[i + 1] : NULL;
+	}
+	M0_ASSERT(j == iov_nr);
+	qev[0]->iq_merge = m;
+	return true;
+}
+
+/**
+   Sorts a batch of fragments and merges adjacent ones. Stores requests to be
+   submitted in "evin" and returns their number.
+ */
+static int ioq_merge(struct ioq_qev **qev, int nr, struct iocb **evin)
+{
+	struct ioq_qev *q;
+	m0_bcount_t     nbytes;
+	int             iov_nr;
+	int             out = 0;
+	int             i;
+	int             j;
+
+	/* Insertion sort, batches are small. */
+	for (i = 1; i < nr; ++i) {
+		q = qev[i];
+		for (j = i; j > 0 && ioq_qev_lt(q, qev[j - 1]); --j)
+			qev[j] = qev[j - 1];
+		qev[j] = q;
+	}
+	for (i = 0; i < nr; i = j) {
+		nbytes = qev[i]->iq_nbytes;
+		iov_nr = qev[i]->iq_iocb.u.v.nr;
+		for (j = i + 1; j < nr; ++j) {
+			if (!ioq_qev_adjacent(qev[j - 1], qev[j]) ||
+			    nbytes + qev[j]->iq_nbytes > M0_STOB_IOQ_MERGE_MAX ||
+			    iov_nr + qev[j]->iq_iocb.u.v.nr > IOV_MAX)
+				break;
+			nbytes += qev[j]->iq_nbytes;
+			iov_nr += qev[j]->iq_iocb.u.v.nr;
+		}
+		if (j - i > 1 && !ioq_merge_group(&qev[i], j - i, iov_nr))
+			j = i + 1;
+		evin[out++] = qev[i]->iq_merge != NULL ?
+			&qev[i]->iq_merge->im_iocb : &qev[i]->iq_iocb;
+	}
+	return out;
 }
 
+/**
+   Returns fragments of a request that was not submitted to the admission
+   queue, splitting a merged group.
+ */
+static void ioq_unmerge(struct m0_stob_ioq_dev *dev, struct iocb *iocb)
+{
+	struct ioq_qev *qev = iocb->data;
+	struct ioq_qev *next;
+
+	M0_PRE(m0_mutex_is_locked(&dev->iqd_lock));
+
+	m0_free0(&qev->iq_merge);
+	for (; qev != NULL; qev = next) {
+		next = qev->iq_merged;
+		qev->iq_merged = NULL;
+		ioq_queue_put(dev, qev);
+	}
+}
+
+#ifdef ENABLE_IO_URING
+/**
+   Returns the index of the registered buffer containing [base, base + len) or
+   -1 if there is none. Registered buffers are sorted by address and do not
+   overlap.
+ */
+static int ioq_uring_buf_find(const struct m0_stob_ioq *ioq,
+			      const void *base, size_t len)
+{
+	const struct iovec *buf;
+	unsigned            lo = 0;
+	unsigned            hi = ioq->ioq_bufs_nr;
+	unsigned            mid;
+
+	/* Find the last buffer starting at or below base. */
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (ioq->ioq_bufs[mid].iov_base <= base)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo == 0)
+		return -1;
+	buf = &ioq->ioq_bufs[lo - 1];
+	return base + len <= buf->iov_base + buf->iov_len ? lo - 1 : -1;
+}
+
+static int ioq_uring_buf_cmp(const void *a, const void *b)
+{
+	const struct iovec *v0 = a;
+	const struct iovec *v1 = b;
+
+	return M0_3WAY(v0->iov_base, v1->iov_base);
+}
+
+/**
+   Fills a submission queue entry from the iocb of a fragment or a merged
+   group.
+ */
+static void ioq_uring_prep(struct m0_stob_ioq_dev *dev,
+			   struct io_uring_sqe *sqe, struct iocb *iocb)
+{
+	struct ioq_qev     *qev  = iocb->data;
+	const struct iovec *iov  = iocb->u.v.vec;
+	bool                read = iocb->aio_lio_opcode == IO_CMD_PREADV;
+	int                 fd   = iocb->aio_fildes;
+	int                 buf  = -1;
+
+	if (qev->iq_fd_slot >= 0)
+		fd = qev->iq_fd_slot;
+	if (iocb->u.v.nr == 1)
+		buf = ioq_uring_buf_find(dev->iqd_ioq,
+					 iov->iov_base, iov->iov_len);
+	if (buf >= 0 && read)
+		io_uring_prep_read_fixed(sqe, fd, iov->iov_base, iov->iov_len,
+					 iocb->u.v.offset, buf);
+	else if (buf >= 0)
+		io_uring_prep_write_fixed(sqe, fd, iov->iov_base, iov->iov_len,
+					  iocb->u.v.offset, buf);
+	else if (read)
+		io_uring_prep_readv(sqe, fd, iov, iocb->u.v.nr,
+				    iocb->u.v.offset);
+	else
+		io_uring_prep_writev(sqe, fd, iov, iocb->u.v.nr,
+				     iocb->u.v.offset);
+	if (qev->iq_fd_slot >= 0)
+		io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+	io_uring_sqe_set_data(sqe, qev);
+}
+
+/**
+   io_uring counterpart of the ioq_queue_submit() loop: moves as many
+   fragments as fit from the admission queue to the submission queue and
+   submits them at once.
+ */
+static void ioq_uring_submit(struct m0_stob_ioq_dev *dev)
+{
+	struct ioq_qev *qev[M0_STOB_IOQ_BATCH_IN_MAX];
+	struct iocb    *evin[M0_STOB_IOQ_BATCH_IN_MAX];
+	int             got;
+	int             put;
+	int             i;
+	int             rc = 0;
+
+	ioq_queue_lock(dev);
+	do {
+		got = ioq_queue_batch(dev, qev,
+			min32(ARRAY_SIZE(qev),
+			      io_uring_sq_space_left(&dev->iqd_uring)));
+		put = ioq_merge(qev, got, evin);
+		if (got > put) {
+			m0_atomic64_add(&dev->iqd_avail, got - put);
+			m0_atomic64_add(&dev->iqd_merged, got - put);
+		}
+		for (i = 0; i < put; ++i)
+			ioq_uring_prep(dev, io_uring_get_sqe(&dev->iqd_uring),
+				       evin[i]);
+	} while (got > 0);
+	/*
+	 * Entries the kernel did not take because of an error stay in the
+	 * submission queue and go with the next call.
+	 */
+	if (io_uring_sq_ready(&dev->iqd_uring) > 0)
+		rc = io_uring_submit(&dev->iqd_uring);
+	ioq_queue_unlock(dev);
+	if (rc < 0)
+		M0_LOG(M0_ERROR, "rc=%d", rc);
+}
+#endif
+
 /**
    Transfers fragments from the admission queue to the ring buffer in batches
    until the ring buffer is full.
  */
-static void ioq_queue_submit(struct m0_stob_ioq *ioq)
+static void ioq_queue_submit(struct m0_stob_ioq_dev *dev)
 {
 	int got;
+	int nr;
 	int put;
-	int avail;
 	int i;
 
-	struct ioq_qev  *qev[M0_STOB_IOQ_BATCH_IN_SIZE];
-	struct iocb    *evin[M0_STOB_IOQ_BATCH_IN_SIZE];
+	struct ioq_qev  *qev[M0_STOB_IOQ_BATCH_IN_MAX];
+	struct iocb    *evin[M0_STOB_IOQ_BATCH_IN_MAX];
 
+	/* Leaves fragments in the admission queue, letting them pile up. */
+	if (M0_FI_ENABLED("hold"))
+		return;
+#ifdef ENABLE_IO_URING
+	if (dev->iqd_use_uring) {
+		ioq_uring_submit(dev);
+		return;
+	}
+#endif
 	do {
-		ioq_queue_lock(ioq);
-		avail = m0_atomic64_get(&ioq->ioq_avail);
-		got = min32(ioq->ioq_queued, min32(avail, ARRAY_SIZE(evin)));
-		m0_atomic64_sub(&ioq->ioq_avail, got);
-		for (i = 0; i < got; ++i) {
-			qev[i] = ioq_queue_get(ioq);
-			evin[i] = &qev[i]->iq_iocb;
-		}
-		ioq_queue_unlock(ioq);
+		ioq_queue_lock(dev);
+		got = ioq_queue_batch(dev, qev, ARRAY_SIZE(qev));
+		ioq_queue_unlock(dev);
 
 		if (got > 0) {
-			put = io_submit(ioq->ioq_ctx, got, evin);
+			nr = ioq_merge(qev, got, evin);
+			if (got > nr) {
+				m0_atomic64_add(&dev->iqd_avail, got - nr);
+				m0_atomic64_add(&dev->iqd_merged, got - nr);
+			}
+			put = io_submit(dev->iqd_ctx, nr, evin);
 			if (put < 0)
-				M0_LOG(M0_ERROR, "got=%d put=%d", got, put);
+				M0_LOG(M0_ERROR, "nr=%d put=%d", nr, put);
 			if (put < 0)
 				put = 0;
-			ioq_queue_lock(ioq);
-			for (i = put; i < got; ++i)
-				ioq_queue_put(ioq, qev[i]);
-			ioq_queue_unlock(ioq);
+			ioq_queue_lock(dev);
+			for (i = put; i < nr; ++i)
+				ioq_unmerge(dev, evin[i]);
+			ioq_queue_unlock(dev);
 
-			if (got > put)
-				m0_atomic64_add(&ioq->ioq_avail, got - put);
+			if (nr > put)
+				m0_atomic64_add(&dev->iqd_avail, nr - put);
 		}
 	} while (got > 0);
 }
@@ -588,6 +916,28 @@ static void ioq_complete(struct m0_stob_ioq *ioq, struct ioq_qev *qev,
 	}
 }
 
+/**
+   Completes a fragment or, for the head of a merged group, all fragments of
+   the group. The result of a merged request is split among its fragments in
+   offset order.
+ */
+static void ioq_event_complete(struct m0_stob_ioq *ioq, struct ioq_qev *qev,
+			       long res, long res2)
+{
+	struct ioq_qev *next;
+	long            part;
+
+	m0_free0(&qev->iq_merge);
+	for (; qev != NULL; qev = next) {
+		next = qev->iq_merged;
+		qev->iq_merged = NULL;
+		part = res < 0 ? res : min_check(res, (long)qev->iq_nbytes);
+		if (res > 0)
+			res -= part;
+		ioq_complete(ioq, qev, part, res2);
+	}
+}
+
 static const struct timespec ioq_timeout_default = {
 	.tv_sec  = 1,
 	.tv_nsec = 0
@@ -601,29 +951,104 @@ static unsigned long stob_ioq_timer_cb(unsigned long data)
 	return 0;
 }
 
-static int stob_ioq_thread_init(struct m0_stob_ioq *ioq)
+/**
+   Completion event extracted from the ring buffer.
+ */
+struct ioq_cev {
+	struct ioq_qev *ce_qev;
+	long            ce_res;
+	long            ce_res2;
+};
+
+#ifdef ENABLE_IO_URING
+static int ioq_uring_events_get(struct m0_stob_ioq_dev *dev,
+				struct ioq_cev *cev, int nr)
 {
-	struct m0_timer_locality *timer_loc;
-	int                       thread_index;
+	struct io_uring_cqe     *cqe[M0_STOB_IOQ_BATCH_OUT_MAX];
+	struct __kernel_timespec timeout = {
+		.tv_sec  = ioq_timeout_default.tv_sec,
+		.tv_nsec = ioq_timeout_default.tv_nsec
+	};
+	int                      got = 0;
+	int                      i;
+
+	M0_PRE(nr <= ARRAY_SIZE(cqe));
+	/*
+	 * One thread at a time waits on the completion queue. Completions are
+	 * processed by the caller after the lock is released, concurrently
+	 * with the next waiter.
+	 */
+	m0_mutex_lock(&dev->iqd_cq_lock);
+	if (io_uring_wait_cqe_timeout(&dev->iqd_uring,
+				      &cqe[0], &timeout) == 0) {
+		got = io_uring_peek_batch_cqe(&dev->iqd_uring, cqe, nr);
+		for (i = 0; i < got; ++i)
+			cev[i] = (struct ioq_cev) {
+				.ce_qev = io_uring_cqe_get_data(cqe[i]),
+				.ce_res = cqe[i]->res
+			};
+		io_uring_cq_advance(&dev->iqd_uring, got);
+	}
+	m0_mutex_unlock(&dev->iqd_cq_lock);
+	return got;
+}
+#endif
+
+/**
+   Waits (for at most ioq_timeout_default) for completion events and extracts
+   up to "nr" of them. Returns the number of events or a negative error code.
+ */
+static int ioq_events_get(struct m0_stob_ioq_dev *dev,
+			  struct ioq_cev *cev, int nr)
+{
+	struct io_event evout[M0_STOB_IOQ_BATCH_OUT_MAX];
+	struct timespec timeout = ioq_timeout_default;
+	int             got;
+	int             i;
+
+	M0_PRE(nr <= ARRAY_SIZE(evout));
+#ifdef ENABLE_IO_URING
+	if (dev->iqd_use_uring)
+		return ioq_uring_events_get(dev, cev, nr);
+#endif
+	got = io_getevents(dev->iqd_ctx, 1, nr, evout, &timeout);
+	for (i = 0; i < got; ++i)
+		cev[i] = (struct ioq_cev) {
+			.ce_qev  = evout[i].data,
+			.ce_res  = evout[i].res,
+			.ce_res2 = evout[i].res2
+		};
+	return got;
+}
+
+static struct m0_stob_ioq_thread *ioq_thread_self(void)
+{
+	return container_of(m0_thread_self(), struct m0_stob_ioq_thread,
+			    iqt_thread);
+}
+
+static int stob_ioq_thread_init(struct m0_stob_ioq_dev *dev)
+{
+	struct m0_stob_ioq_thread *t = ioq_thread_self();
+	struct m0_timer_locality  *timer_loc;
 	int rc;
 
-	thread_index = m0_thread_self() - ioq->ioq_thread;
-	timer_loc = &ioq->ioq_stop_timer_loc[thread_index];
+	timer_loc = &t->iqt_stop_timer_loc;
 	m0_timer_locality_init(timer_loc);
 	rc = m0_timer_thread_attach(timer_loc);
 	if (rc != 0) {
 		m0_timer_locality_fini(timer_loc);
 		return M0_ERR(rc);
 	}
-	rc = m0_timer_init(&ioq->ioq_stop_timer[thread_index], M0_TIMER_HARD,
+	rc = m0_timer_init(&t->iqt_stop_timer, M0_TIMER_HARD,
 	                   timer_loc, &stob_ioq_timer_cb,
-	                   (unsigned long)&ioq->ioq_stop_sem[thread_index]);
+	                   (unsigned long)&t->iqt_stop_sem);
 	if (rc != 0) {
 		m0_timer_thread_detach(timer_loc);
 		m0_timer_locality_fini(timer_loc);
 		return M0_ERR(rc);
 	}
-	m0_semaphore_init(&ioq->ioq_stop_sem[thread_index], 0);
+	m0_semaphore_init(&t->iqt_stop_sem, 0);
 	return M0_RC(rc);
 }
 
@@ -634,101 +1059,385 @@ static int stob_ioq_thread_init(struct m0_stob_ioq *ioq)
    events to the users. Moves fragments from the admission queue to the ring
    buffer.
  */
-static void stob_ioq_thread(struct m0_stob_ioq *ioq)
+static void stob_ioq_thread(struct m0_stob_ioq_dev *dev)
 {
 	int got;
 	int avail;
+	int batch;
 	int i;
-	struct io_event      evout[M0_STOB_IOQ_BATCH_OUT_SIZE];
-	struct timespec      timeout;
+	struct ioq_cev       cev[M0_STOB_IOQ_BATCH_OUT_MAX];
 	struct m0_addb2_hist inflight = {};
 	struct m0_addb2_hist queued   = {};
 	struct m0_addb2_hist gotten   = {};
-	int                  thread_index;
+	struct m0_stob_ioq_thread *t = ioq_thread_self();
+	int                  ring_size = dev->iqd_ioq->ioq_ring_size;
 
-	thread_index = m0_thread_self() - ioq->ioq_thread;
-	M0_ADDB2_PUSH(M0_AVI_STOB_IOQ, thread_index);
+	M0_ADDB2_PUSH(M0_AVI_STOB_IOQ,
+		      dev->iqd_idx * M0_STOB_IOQ_NR_THREADS_MAX +
+		      (t - dev->iqd_thread));
 	m0_addb2_hist_add_auto(&inflight, 1000, M0_AVI_STOB_IOQ_INFLIGHT, -1);
 	m0_addb2_hist_add_auto(&queued,   1000, M0_AVI_STOB_IOQ_QUEUED, -1);
 	m0_addb2_hist_add_auto(&gotten,   1000, M0_AVI_STOB_IOQ_GOT, -1);
-	while (!m0_semaphore_trydown(&ioq->ioq_stop_sem[thread_index])) {
-		timeout = ioq_timeout_default;
-		got = io_getevents(ioq->ioq_ctx, 1, ARRAY_SIZE(evout),
-				   evout, &timeout);
+	while (!m0_semaphore_trydown(&t->iqt_stop_sem)) {
+		batch = ioq_batch(dev, ring_size -
+				  m0_atomic64_get(&dev->iqd_avail),
+				  M0_STOB_IOQ_BATCH_OUT_SIZE,
+				  M0_STOB_IOQ_BATCH_OUT_MAX);
+		got = ioq_events_get(dev, cev, batch);
 		if (got > 0) {
-			avail = m0_atomic64_add_return(&ioq->ioq_avail, got);
-			M0_ASSERT(avail <= M0_STOB_IOQ_RING_SIZE);
+			avail = m0_atomic64_add_return(&dev->iqd_avail, got);
+			M0_ASSERT(avail <= ring_size);
 		}
 		for (i = 0; i < got; ++i) {
-			struct ioq_qev  *qev;
-			struct io_event *iev;
+			struct ioq_qev *qev = cev[i].ce_qev;
 
-			iev = &evout[i];
-			qev = container_of(iev->obj, struct ioq_qev, iq_iocb);
 			M0_ASSERT(!m0_queue_link_is_in(&qev->iq_linkage));
-			ioq_complete(ioq, qev, iev->res, iev->res2);
+			ioq_event_complete(dev->iqd_ioq, qev,
+					   cev[i].ce_res, cev[i].ce_res2);
 		}
-		ioq_queue_submit(ioq);
+		ioq_queue_submit(dev);
 		m0_addb2_hist_mod(&gotten, got);
-		m0_addb2_hist_mod(&queued, ioq->ioq_queued);
-		m0_addb2_hist_mod(&inflight, M0_STOB_IOQ_RING_SIZE -
-				     m0_atomic64_get(&ioq->ioq_avail));
+		m0_addb2_hist_mod(&queued, dev->iqd_queued);
+		m0_addb2_hist_mod(&inflight, ring_size -
+				     m0_atomic64_get(&dev->iqd_avail));
 		m0_addb2_force(M0_MKTIME(5, 0));
 	}
 	m0_addb2_pop(M0_AVI_STOB_IOQ);
-	m0_semaphore_fini(&ioq->ioq_stop_sem[thread_index]);
-	m0_timer_stop(&ioq->ioq_stop_timer[thread_index]);
-	m0_timer_fini(&ioq->ioq_stop_timer[thread_index]);
-	m0_timer_thread_detach(&ioq->ioq_stop_timer_loc[thread_index]);
-	m0_timer_locality_fini(&ioq->ioq_stop_timer_loc[thread_index]);
+	m0_semaphore_fini(&t->iqt_stop_sem);
+	m0_timer_stop(&t->iqt_stop_timer);
+	m0_timer_fini(&t->iqt_stop_timer);
+	m0_timer_thread_detach(&t->iqt_stop_timer_loc);
+	m0_timer_locality_fini(&t->iqt_stop_timer_loc);
 }
 
-M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq)
+#ifdef ENABLE_IO_URING
+static int ioq_uring_init(struct m0_stob_ioq_dev *dev, uint32_t flags)
 {
-	int result;
+	struct m0_stob_ioq     *ioq = dev->iqd_ioq;
+	struct io_uring_params  params = {};
+	int                     result;
+	int                     i;
+
+	if (flags & M0_STOB_IOQ_SQPOLL) {
+		params.flags |= IORING_SETUP_SQPOLL;
+		params.sq_thread_idle = M0_STOB_IOQ_SQPOLL_IDLE_MS;
+	}
+	result = io_uring_queue_init_params(ioq->ioq_ring_size,
+					    &dev->iqd_uring, &params);
+	if (result != 0)
+		return M0_ERR(result);
+	/* Needed by io_uring_wait_cqe_timeout() to leave the SQ alone. */
+	if (!(params.features & IORING_FEAT_EXT_ARG)) {
+		io_uring_queue_exit(&dev->iqd_uring);
+		return M0_ERR_INFO(-ENOSYS, "No IORING_FEAT_EXT_ARG.");
+	}
+	for (i = 0; i < ARRAY_SIZE(dev->iqd_files); ++i)
+		dev->iqd_files[i] = -1;
+	result = io_uring_register_files(&dev->iqd_uring, dev->iqd_files,
+					 ARRAY_SIZE(dev->iqd_files));
+	if (result == 0 && ioq->ioq_bufs != NULL)
+		result = io_uring_register_buffers(&dev->iqd_uring,
+						   ioq->ioq_bufs,
+						   ioq->ioq_bufs_nr);
+	if (result != 0) {
+		io_uring_queue_exit(&dev->iqd_uring);
+		return M0_ERR(result);
+	}
+	m0_mutex_init(&dev->iqd_cq_lock);
+	return M0_RC(0);
+}
+
+static void ioq_uring_fini(struct m0_stob_ioq_dev *dev)
+{
+	io_uring_queue_exit(&dev->iqd_uring);
+	m0_mutex_fini(&dev->iqd_cq_lock);
+}
+#endif
+
+static void ioq_dev_fini(struct m0_stob_ioq_dev *dev)
+{
+	int nr = dev->iqd_thread == NULL ? 0 : dev->iqd_ioq->ioq_nr_threads;
 	int i;
 
-	ioq->ioq_ctx      = NULL;
-	m0_atomic64_set(&ioq->ioq_avail, M0_STOB_IOQ_RING_SIZE);
-	ioq->ioq_queued   = 0;
+	for (i = 0; i < nr; ++i) {
+		if (dev->iqd_thread[i].iqt_thread.t_func != NULL)
+			m0_timer_start(&dev->iqd_thread[i].iqt_stop_timer,
+				       M0_TIME_IMMEDIATELY);
+	}
+	for (i = 0; i < nr; ++i) {
+		if (dev->iqd_thread[i].iqt_thread.t_func != NULL)
+			m0_thread_join(&dev->iqd_thread[i].iqt_thread);
+	}
+	m0_free0(&dev->iqd_thread);
+#ifdef ENABLE_IO_URING
+	if (dev->iqd_use_uring)
+		ioq_uring_fini(dev);
+#endif
+	if (dev->iqd_ctx != NULL)
+		io_destroy(dev->iqd_ctx);
+	m0_queue_fini(&dev->iqd_queue);
+	m0_mutex_fini(&dev->iqd_lock);
+}
 
-	m0_queue_init(&ioq->ioq_queue);
-	m0_mutex_init(&ioq->ioq_lock);
+static int ioq_dev_init(struct m0_stob_ioq *ioq, struct m0_stob_ioq_dev *dev,
+			uint64_t devno, int idx)
+{
+	int result;
+	int i;
 
-	result = io_setup(M0_STOB_IOQ_RING_SIZE, &ioq->ioq_ctx);
+	dev->iqd_ioq       = ioq;
+	dev->iqd_dev       = devno;
+	dev->iqd_idx       = idx;
+	dev->iqd_ctx       = NULL;
+	dev->iqd_use_uring = false;
+	m0_atomic64_set(&dev->iqd_avail, ioq->ioq_ring_size);
+	m0_atomic64_set(&dev->iqd_merged, 0);
+	dev->iqd_queued    = 0;
+
+	m0_queue_init(&dev->iqd_queue);
+	m0_mutex_init(&dev->iqd_lock);
+
+	if (ioq->ioq_flags & M0_STOB_IOQ_URING) {
+#ifdef ENABLE_IO_URING
+		result = ioq_uring_init(dev, ioq->ioq_flags);
+		dev->iqd_use_uring = result == 0;
+		if (result != 0)
+			M0_LOG(M0_WARN, "io_uring setup failed: rc=%d, "
+			       "falling back to libaio.", result);
+#else
+		M0_LOG(M0_WARN, "Built without io_uring, using libaio.");
+#endif
+	}
+	result = dev->iqd_use_uring ? 0 :
+		 io_setup(ioq->ioq_ring_size, &dev->iqd_ctx);
+	if (result == 0) {
+		M0_ALLOC_ARR(dev->iqd_thread, ioq->ioq_nr_threads);
+		if (dev->iqd_thread == NULL)
+			result = M0_ERR(-ENOMEM);
+	}
 	if (result == 0) {
-		for (i = 0; i < ARRAY_SIZE(ioq->ioq_thread); ++i) {
-			result = M0_THREAD_INIT(&ioq->ioq_thread[i],
-			                        struct m0_stob_ioq *,
+		/* The low bits of the device number fit M0_THREAD_NAME_LEN. */
+		for (i = 0; i < ioq->ioq_nr_threads; ++i) {
+			result = M0_THREAD_INIT(&dev->iqd_thread[i].iqt_thread,
+			                        struct m0_stob_ioq_dev *,
 			                        &stob_ioq_thread_init,
-						&stob_ioq_thread, ioq,
-						"ioq_thread%d", i);
+						&stob_ioq_thread, dev,
+						"ioq%x.%d",
+						(uint32_t)devno, i);
 			if (result != 0)
 				break;
-			m0_stob_ioq_directio_setup(ioq, false);
 		}
 	}
 	if (result != 0)
-		m0_stob_ioq_fini(ioq);
+		ioq_dev_fini(dev);
 	return result;
 }
 
+M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq, uint32_t flags,
+				 uint32_t nr_threads, uint32_t ring_size)
+{
+	M0_PRE(nr_threads <= M0_STOB_IOQ_NR_THREADS_MAX);
+
+	ioq->ioq_flags      = flags;
+	ioq->ioq_nr_threads = nr_threads ?: M0_STOB_IOQ_NR_THREADS;
+	ioq->ioq_ring_size  = ring_size ?: M0_STOB_IOQ_RING_SIZE;
+	ioq->ioq_dev_nr     = 0;
+#ifdef ENABLE_IO_URING
+	ioq->ioq_bufs    = NULL;
+	ioq->ioq_bufs_nr = 0;
+#endif
+	m0_stob_ioq_directio_setup(ioq, false);
+	m0_mutex_init(&ioq->ioq_lock);
+	return 0;
+}
+
 M0_INTERNAL void m0_stob_ioq_fini(struct m0_stob_ioq *ioq)
 {
 	int i;
 
-	for (i = 0; i < ARRAY_SIZE(ioq->ioq_stop_timer); ++i)
-		m0_timer_start(&ioq->ioq_stop_timer[i], M0_TIME_IMMEDIATELY);
-	for (i = 0; i < ARRAY_SIZE(ioq->ioq_thread); ++i) {
-		if (ioq->ioq_thread[i].t_func != NULL)
-			m0_thread_join(&ioq->ioq_thread[i]);
+	for (i = 0; i < ioq->ioq_dev_nr; ++i) {
+		ioq_dev_fini(ioq->ioq_dev[i]);
+		m0_free(ioq->ioq_dev[i]);
 	}
-	if (ioq->ioq_ctx != NULL)
-		io_destroy(ioq->ioq_ctx);
-	m0_queue_fini(&ioq->ioq_queue);
+	ioq->ioq_dev_nr = 0;
+#ifdef ENABLE_IO_URING
+	m0_free0(&ioq->ioq_bufs);
+#endif
 	m0_mutex_fini(&ioq->ioq_lock);
 }
 
+M0_INTERNAL int m0_stob_ioq_dev_get(struct m0_stob_ioq      *ioq,
+				    uint64_t                 devno,
+				    struct m0_stob_ioq_dev **out)
+{
+	struct m0_stob_ioq_dev *dev = NULL;
+	int                     result = 0;
+	int                     i;
+
+	m0_mutex_lock(&ioq->ioq_lock);
+	for (i = 0; i < ioq->ioq_dev_nr && dev == NULL; ++i) {
+		if (ioq->ioq_dev[i]->iqd_dev == devno)
+			dev = ioq->ioq_dev[i];
+	}
+	if (dev == NULL && ioq->ioq_dev_nr == ARRAY_SIZE(ioq->ioq_dev)) {
+		dev = ioq->ioq_dev[devno % ARRAY_SIZE(ioq->ioq_dev)];
+		M0_LOG(M0_DEBUG, "dev=%"PRIx64" shares queue with dev=%"PRIx64,
+		       devno, dev->iqd_dev);
+	}
+	if (dev == NULL) {
+		M0_ALLOC_PTR(dev);
+		result = dev == NULL ? M0_ERR(-ENOMEM) :
+			 ioq_dev_init(ioq, dev, devno, ioq->ioq_dev_nr);
+		if (result == 0)
+			ioq->ioq_dev[ioq->ioq_dev_nr++] = dev;
+		else
+			m0_free0(&dev);
+	}
+	m0_mutex_unlock(&ioq->ioq_lock);
+	*out = dev;
+	return M0_RC(result);
+}
+
+M0_INTERNAL int m0_stob_ioq_file_register(struct m0_stob_ioq_dev *dev,
+					  int fd)
+{
+	int slot = -1;
+#ifdef ENABLE_IO_URING
+	int rc;
+	int i;
+
+	if (!dev->iqd_use_uring)
+		return -1;
+	ioq_queue_lock(dev);
+	for (i = 0; i < ARRAY_SIZE(dev->iqd_files); ++i) {
+		if (dev->iqd_files[i] != -1)
+			continue;
+		rc = io_uring_register_files_update(&dev->iqd_uring, i, &fd, 1);
+		if (rc == 1) {
+			dev->iqd_files[i] = fd;
+			slot = i;
+		} else
+			M0_LOG(M0_WARN, "fd=%d slot=%d rc=%d", fd, i, rc);
+		break;
+	}
+	ioq_queue_unlock(dev);
+#endif
+	return slot;
+}
+
+M0_INTERNAL void m0_stob_ioq_file_unregister(struct m0_stob_ioq_dev *dev,
+					     int slot)
+{
+#ifdef ENABLE_IO_URING
+	int fd = -1;
+	int rc;
+
+	M0_PRE(dev->iqd_use_uring);
+	M0_PRE(slot >= 0 && slot < ARRAY_SIZE(dev->iqd_files));
+
+	ioq_queue_lock(dev);
+	M0_ASSERT(dev->iqd_files[slot] != -1);
+	rc = io_uring_register_files_update(&dev->iqd_uring, slot, &fd, 1);
+	if (rc != 1)
+		M0_LOG(M0_WARN, "slot=%d rc=%d", slot, rc);
+	dev->iqd_files[slot] = -1;
+	ioq_queue_unlock(dev);
+#else
+	M0_IMPOSSIBLE("No fixed files without io_uring.");
+#endif
+}
+
+#ifdef ENABLE_IO_URING
+/**
+   Locks submission of all device queues: fragments are matched against
+   m0_stob_ioq::ioq_bufs under the lock of their device queue only.
+ */
+static void ioq_devs_lock(struct m0_stob_ioq *ioq)
+{
+	int i;
+
+	M0_PRE(m0_mutex_is_locked(&ioq->ioq_lock));
+	for (i = 0; i < ioq->ioq_dev_nr; ++i)
+		ioq_queue_lock(ioq->ioq_dev[i]);
+}
+
+static void ioq_devs_unlock(struct m0_stob_ioq *ioq)
+{
+	int i;
+
+	for (i = ioq->ioq_dev_nr - 1; i >= 0; --i)
+		ioq_queue_unlock(ioq->ioq_dev[i]);
+}
+#endif
+
+M0_INTERNAL int m0_stob_ioq_buffers_register(struct m0_stob_ioq  *ioq,
+					     const struct iovec  *bufs,
+					     unsigned             nr)
+{
+	int rc = 0;
+#ifdef ENABLE_IO_URING
+	struct m0_stob_ioq_dev *dev;
+	struct iovec           *copy;
+	int                     i;
+
+	if (!(ioq->ioq_flags & M0_STOB_IOQ_URING) || nr == 0)
+		return 0;
+	M0_PRE(nr <= M0_STOB_IOQ_URING_BUFS_MAX);
+	M0_PRE(ioq->ioq_bufs == NULL);
+	M0_ALLOC_ARR(copy, nr);
+	if (copy == NULL)
+		return M0_ERR(-ENOMEM);
+	memcpy(copy, bufs, nr * sizeof bufs[0]);
+	/* Sorted for ioq_uring_buf_find(), indices are the sorted ones. */
+	qsort(copy, nr, sizeof copy[0], &ioq_uring_buf_cmp);
+	M0_PRE(m0_forall(j, nr - 1, copy[j].iov_base + copy[j].iov_len <=
+			 copy[j + 1].iov_base));
+	m0_mutex_lock(&ioq->ioq_lock);
+	ioq_devs_lock(ioq);
+	for (i = 0; i < ioq->ioq_dev_nr; ++i) {
+		dev = ioq->ioq_dev[i];
+		rc = dev->iqd_use_uring ?
+			io_uring_register_buffers(&dev->iqd_uring, copy, nr) : 0;
+		if (rc != 0)
+			break;
+	}
+	if (rc == 0) {
+		ioq->ioq_bufs    = copy;
+		ioq->ioq_bufs_nr = nr;
+	} else {
+		while (--i >= 0) {
+			dev = ioq->ioq_dev[i];
+			if (dev->iqd_use_uring)
+				io_uring_unregister_buffers(&dev->iqd_uring);
+		}
+		m0_free(copy);
+	}
+	ioq_devs_unlock(ioq);
+	m0_mutex_unlock(&ioq->ioq_lock);
+#endif
+	return M0_RC(rc);
+}
+
+M0_INTERNAL void m0_stob_ioq_buffers_unregister(struct m0_stob_ioq *ioq)
+{
+#ifdef ENABLE_IO_URING
+	struct m0_stob_ioq_dev *dev;
+	int                     i;
+
+	m0_mutex_lock(&ioq->ioq_lock);
+	ioq_devs_lock(ioq);
+	for (i = 0; i < ioq->ioq_dev_nr && ioq->ioq_bufs != NULL; ++i) {
+		dev = ioq->ioq_dev[i];
+		if (dev->iqd_use_uring)
+			io_uring_unregister_buffers(&dev->iqd_uring);
+	}
+	m0_free0(&ioq->ioq_bufs);
+	ioq->ioq_bufs_nr = 0;
+	ioq_devs_unlock(ioq);
+	m0_mutex_unlock(&ioq->ioq_lock);
+#endif
+}
+
 M0_INTERNAL uint32_t m0_stob_ioq_bshift(struct m0_stob_ioq *ioq)
 {
 	return ioq->ioq_use_directio ? STOB_IOQ_BSHIFT : 0;
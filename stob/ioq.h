@@ -26,6 +26,9 @@
 #define __MOTR_STOB_IOQ_H__
 
 #include <libaio.h>        /* io_context_t */
+#ifdef ENABLE_IO_URING
+#include <liburing.h>      /* io_uring */
+#endif
 
 #include "lib/types.h"     /* bool */
 #include "lib/atomic.h"    /* m0_atomic64 */
@@ -43,56 +46,201 @@
 
 struct m0_stob;
 struct m0_stob_io;
+struct iovec;
 
 enum {
-	/** Default number of threads to create in a storage object domain. */
+	/** Default number of threads serving a device queue. */
 	M0_STOB_IOQ_NR_THREADS     = 8,
+	/** Maximal number of threads serving a device queue. */
+	M0_STOB_IOQ_NR_THREADS_MAX = 64,
 	/** Default size of a ring buffer shared by adieu and the kernel. */
 	M0_STOB_IOQ_RING_SIZE      = 1024,
-	/** Size of a batch in which requests are moved from the admission queue
-	    to the ring buffer. */
+	/** Minimal size of a batch in which requests are moved from the
+	    admission queue to the ring buffer. */
 	M0_STOB_IOQ_BATCH_IN_SIZE  = 8,
-	/** Size of a batch in which completion events are extracted from the
-	    ring buffer. */
+	/** Maximal size of a batch in which requests are moved from the
+	    admission queue to the ring buffer. */
+	M0_STOB_IOQ_BATCH_IN_MAX   = 64,
+	/** Minimal size of a batch in which completion events are extracted
+	    from the ring buffer. */
 	M0_STOB_IOQ_BATCH_OUT_SIZE = 8,
+	/** Maximal size of a batch in which completion events are extracted
+	    from the ring buffer. */
+	M0_STOB_IOQ_BATCH_OUT_MAX  = 64,
+	/** Maximal size in bytes of a request merged from adjacent fragments
+	    of different adieu requests. */
+	M0_STOB_IOQ_MERGE_MAX      = 1 << 20,
+	/** Maximal number of device queues in a domain. Devices beyond this
+	    number share queues with other devices. */
+	M0_STOB_IOQ_DEV_MAX        = 64,
+	/** Number of fixed file slots registered with io_uring. */
+	M0_STOB_IOQ_URING_FILES_NR = 256,
+	/** Idle time of the io_uring kernel submission thread, ms. */
+	M0_STOB_IOQ_SQPOLL_IDLE_MS = 100,
+	/** Maximal number of buffers registered with io_uring. */
+	M0_STOB_IOQ_URING_BUFS_MAX = 1024,
 };
 
-struct m0_stob_ioq {
+/** Flags for m0_stob_ioq_init(). */
+enum m0_stob_ioq_flags {
 	/**
-	 *  Controls whether to use O_DIRECT flag for open(2).
-	 *  Can be set with m0_stob_ioq_directio_setup().
-	 *  Initial value is set to 'false'.
+	 * Use io_uring instead of libaio. Ignored, with a warning, when motr
+	 * is built without --enable-io-uring or when the kernel lacks the
+	 * needed io_uring features.
 	 */
-	bool                     ioq_use_directio;
-	/** Set up when domain is being shut down. adieu worker threads
-	    (ioq_thread()) check this field on each iteration. */
+	M0_STOB_IOQ_URING  = 1 << 0,
+	/** Let a kernel thread poll the io_uring submission queue. */
+	M0_STOB_IOQ_SQPOLL = 1 << 1,
+};
+
+struct m0_stob_ioq;
+
+/** Worker thread of a device queue. */
+struct m0_stob_ioq_thread {
+	struct m0_thread         iqt_thread;
+	struct m0_semaphore      iqt_stop_sem;
+	struct m0_timer          iqt_stop_timer;
+	struct m0_timer_locality iqt_stop_timer_loc;
+};
+
+/**
+ * Queue of a single device.
+ *
+ * Each device backing stobs of a domain has its own admission queue, ring
+ * buffer and worker threads, so that a slow device does not hold ring
+ * buffer slots and completion threads needed by the others.
+ */
+struct m0_stob_ioq_dev {
+	struct m0_stob_ioq      *iqd_ioq;
+	/** Device number: st_rdev of a block device, st_dev otherwise. */
+	uint64_t                 iqd_dev;
+	/** Index in m0_stob_ioq::ioq_dev[]. */
+	int                      iqd_idx;
 	/**
 	    Ring buffer shared between adieu and the kernel.
 
 	    It contains adieu request fragments currently being executed by the
 	    kernel. The kernel delivers AIO completion events through this
 	    buffer. */
-	io_context_t             ioq_ctx;
+	io_context_t             iqd_ctx;
+	/** True iff the queue uses io_uring rather than ->iqd_ctx. */
+	bool                     iqd_use_uring;
+#ifdef ENABLE_IO_URING
+	/**
+	 * io_uring instance used instead of ->iqd_ctx. Its submission queue is
+	 * filled under ->iqd_lock, its completion queue is consumed under
+	 * ->iqd_cq_lock.
+	 */
+	struct io_uring          iqd_uring;
+	struct m0_mutex          iqd_cq_lock;
+	/**
+	 * Descriptors in the fixed file slots of ->iqd_uring, -1 for a free
+	 * slot. Protected by ->iqd_lock.
+	 */
+	int                      iqd_files[M0_STOB_IOQ_URING_FILES_NR];
+#endif
 	/** Free slots in the ring buffer. */
-	struct m0_atomic64       ioq_avail;
+	struct m0_atomic64       iqd_avail;
 	/** Used slots in the ring buffer. */
-	int                      ioq_queued;
-	/** Worker threads. */
-	struct m0_thread         ioq_thread[M0_STOB_IOQ_NR_THREADS];
+	int                      iqd_queued;
+	/** Fragments submitted as parts of merged requests. */
+	struct m0_atomic64       iqd_merged;
+	/** Worker threads, m0_stob_ioq::ioq_nr_threads of them. */
+	struct m0_stob_ioq_thread *iqd_thread;
 
-	/** Mutex protecting all ioq_ fields (except for the ring buffer that is
-	    updated by the kernel asynchronously). */
-	struct m0_mutex          ioq_lock;
+	/** Mutex protecting all iqd_ fields (except for the ring buffer that
+	    is updated by the kernel asynchronously). */
+	struct m0_mutex          iqd_lock;
 	/** Admission queue where adieu request fragments are kept until there
 	    is free space in the ring buffer.  */
-	struct m0_queue          ioq_queue;
-	struct m0_semaphore      ioq_stop_sem[M0_STOB_IOQ_NR_THREADS];
-	struct m0_timer          ioq_stop_timer[M0_STOB_IOQ_NR_THREADS];
-	struct m0_timer_locality ioq_stop_timer_loc[M0_STOB_IOQ_NR_THREADS];
+	struct m0_queue          iqd_queue;
 };
 
-M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq);
+struct m0_stob_ioq {
+	/**
+	 *  Controls whether to use O_DIRECT flag for open(2).
+	 *  Can be set with m0_stob_ioq_directio_setup().
+	 *  Initial value is set to 'false'.
+	 */
+	bool                     ioq_use_directio;
+	/** Flags passed to m0_stob_ioq_init(). */
+	uint32_t                 ioq_flags;
+	/** Number of worker threads of each device queue. */
+	int                      ioq_nr_threads;
+	/** Size of the ring buffer of each device queue. */
+	int                      ioq_ring_size;
+	/** Device queues, created on demand by m0_stob_ioq_dev_get(). */
+	struct m0_stob_ioq_dev  *ioq_dev[M0_STOB_IOQ_DEV_MAX];
+	int                      ioq_dev_nr;
+#ifdef ENABLE_IO_URING
+	/**
+	 * Buffers registered with io_uring instances of device queues, sorted
+	 * by address.
+	 */
+	struct iovec            *ioq_bufs;
+	unsigned                 ioq_bufs_nr;
+#endif
+	/** Mutex protecting ->ioq_dev[] and ->ioq_bufs. */
+	struct m0_mutex          ioq_lock;
+};
+
+/**
+ * Initialises the queue. Device queues and their worker threads are created
+ * later, by m0_stob_ioq_dev_get().
+ *
+ * Every device queue gets "nr_threads" worker threads and a ring buffer of
+ * "ring_size" slots, so a domain spanning many devices should use smaller
+ * values than a single-device one.
+ *
+ * @param flags a bitmask of enum m0_stob_ioq_flags values
+ * @param nr_threads worker threads per device, 0 for M0_STOB_IOQ_NR_THREADS
+ * @param ring_size ring buffer slots per device, 0 for M0_STOB_IOQ_RING_SIZE
+ *
+ * @pre nr_threads <= M0_STOB_IOQ_NR_THREADS_MAX
+ */
+M0_INTERNAL int m0_stob_ioq_init(struct m0_stob_ioq *ioq, uint32_t flags,
+				 uint32_t nr_threads, uint32_t ring_size);
 M0_INTERNAL void m0_stob_ioq_fini(struct m0_stob_ioq *ioq);
+
+/**
+ * Returns the queue of device "dev", creating it and starting its worker
+ * threads on the first call for the device.
+ */
+M0_INTERNAL int m0_stob_ioq_dev_get(struct m0_stob_ioq      *ioq,
+				    uint64_t                 dev,
+				    struct m0_stob_ioq_dev **out);
+
+/**
+ * Registers a file descriptor as an io_uring fixed file.
+ *
+ * Returns the slot to be stored in m0_stob_linux::sl_fd_slot or -1 when the
+ * queue does not use io_uring or all slots are taken. I/O on a file without
+ * a slot goes through the normal descriptor lookup.
+ */
+M0_INTERNAL int m0_stob_ioq_file_register(struct m0_stob_ioq_dev *dev,
+					  int fd);
+M0_INTERNAL void m0_stob_ioq_file_unregister(struct m0_stob_ioq_dev *dev,
+					     int slot);
+
+/**
+ * Registers long-living I/O buffers with io_uring.
+ *
+ * A fragment that fits in a single registered buffer is submitted with
+ * IORING_OP_{READ,WRITE}_FIXED, skipping page pinning on each request.
+ * Buffers have to stay allocated until m0_stob_ioq_buffers_unregister().
+ * A no-op returning 0 when the queue does not use io_uring.
+ *
+ * @pre nr <= M0_STOB_IOQ_URING_BUFS_MAX
+ * @pre no buffers are registered with the queue
+ */
+M0_INTERNAL int m0_stob_ioq_buffers_register(struct m0_stob_ioq  *ioq,
+					     const struct iovec  *bufs,
+					     unsigned             nr);
+/**
+ * Unregisters the buffers registered by m0_stob_ioq_buffers_register().
+ * No I/O on the buffers can be in flight.
+ */
+M0_INTERNAL void m0_stob_ioq_buffers_unregister(struct m0_stob_ioq *ioq);
 M0_INTERNAL void m0_stob_ioq_directio_setup(struct m0_stob_ioq *ioq,
 					    bool use_directio);
 
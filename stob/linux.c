@@ -25,6 +25,7 @@
 #include "stob/linux.h"
 
 #include <stdio.h>       /* fopen */
+#include <stdlib.h>      /* strtoul */
 #include <stdarg.h>      /* va_list */
 #include <string.h>      /* strncpy */
 
@@ -68,8 +69,24 @@
    <b>Direct I/O</b>
 
    To enable directio for a stob domain you should specify "directio=true"
-   somewhere in str_cfg_init for m0_stob_domain_init() or
-   m0_stob_domain_create().
+   in str_cfg_init for m0_stob_domain_init() or m0_stob_domain_create().
+   str_cfg_init is a list of "name=value" tokens separated by spaces or commas,
+   unknown tokens are rejected. m0_stob_linux_init_cfg_make() builds it.
+
+   <b>I/O queue sizing</b>
+
+   Each device backing stobs of the domain gets its own I/O queue with
+   "ioq_threads=N" worker threads and a ring buffer of "ioq_ring=N" slots (see
+   m0_stob_ioq_init()). Zero or missing values select the defaults.
+
+   <b>io_uring</b>
+
+   "ioq=uring" in str_cfg_init makes the domain I/O queue use io_uring instead
+   of libaio, "sqpoll=true" additionally enables kernel-side submission queue
+   polling. Stob file descriptors are then registered as io_uring fixed files.
+   ioservice registers its network buffer pools as io_uring fixed buffers
+   with m0_stob_linux_domain_buffers_register(). See the "io_uring backend"
+   section in stob/ioq.c.
 
    <b>Symlinks</b>
 
@@ -183,23 +200,95 @@ static int stob_linux_domain_key_get_set(const char *path,
 	       M0_ERR_INFO(rc, "path=%s", path);
 }
 
+/**
+ * Applies one "name=value" token of the domain init configuration string.
+ */
+static int stob_linux_cfg_token(struct m0_stob_linux_domain_cfg *cfg,
+				const char *token, size_t len)
+{
+	static const struct {
+		const char *t_token;
+		size_t      t_offset;
+		bool        t_value;
+	} tokens[] = {
+#define _T(token, field, value) \
+	{ token, offsetof(struct m0_stob_linux_domain_cfg, field), value }
+		_T("directio=true",  sldc_use_directio, true),
+		_T("directio=false", sldc_use_directio, false),
+		_T("ioq=uring",      sldc_use_uring,    true),
+		_T("ioq=aio",        sldc_use_uring,    false),
+		_T("sqpoll=true",    sldc_uring_sqpoll, true),
+		_T("sqpoll=false",   sldc_uring_sqpoll, false),
+#undef _T
+	};
+	static const struct {
+		const char *n_prefix;
+		size_t      n_offset;
+		uint32_t    n_max;
+	} numbers[] = {
+#define _N(prefix, field, max) \
+	{ prefix, offsetof(struct m0_stob_linux_domain_cfg, field), max }
+		_N("ioq_threads=", sldc_ioq_threads, M0_STOB_IOQ_NR_THREADS_MAX),
+		_N("ioq_ring=",    sldc_ioq_ring_size, INT32_MAX),
+#undef _N
+	};
+	unsigned long  value;
+	char          *end;
+	size_t         plen;
+	int            i;
+
+	for (i = 0; i < ARRAY_SIZE(numbers); ++i) {
+		plen = strlen(numbers[i].n_prefix);
+		if (len <= plen ||
+		    strncmp(numbers[i].n_prefix, token, plen) != 0)
+			continue;
+		value = strtoul(token + plen, &end, 0);
+		if (end != token + len || value > numbers[i].n_max)
+			return M0_ERR_INFO(-EINVAL, "Bad value: %.*s",
+					   (int)len, token);
+		*(uint32_t *)((char *)cfg + numbers[i].n_offset) = value;
+		return 0;
+	}
+	for (i = 0; i < ARRAY_SIZE(tokens); ++i) {
+		if (strlen(tokens[i].t_token) == len &&
+		    strncmp(tokens[i].t_token, token, len) == 0) {
+			*(bool *)((char *)cfg + tokens[i].t_offset) =
+				tokens[i].t_value;
+			return 0;
+		}
+	}
+	return M0_ERR_INFO(-EINVAL, "Unknown token: %.*s", (int)len, token);
+}
+
+/**
+ * Parses the domain init configuration string: "name=value" tokens separated
+ * by spaces or commas, e.g. "directio=true ioq=uring sqpoll=true".
+ */
 static int stob_linux_domain_cfg_init_parse(const char *str_cfg_init,
 					    void **cfg_init)
 {
 	struct m0_stob_linux_domain_cfg *cfg;
+	const char                      *s = str_cfg_init;
+	size_t                           len;
 	int                              rc;
 
 	M0_ALLOC_PTR(cfg);
 	rc = cfg == NULL ? -ENOMEM : 0;
 	if (rc == 0) {
 		*cfg = (struct m0_stob_linux_domain_cfg) {
-			.sldc_file_mode	   = 0700,
-			.sldc_file_flags   = 0,
-			.sldc_use_directio = false,
+			.sldc_file_mode	    = 0700,
+			.sldc_file_flags    = 0,
+			.sldc_use_directio  = false,
+			.sldc_use_uring     = false,
+			.sldc_uring_sqpoll  = false,
+			.sldc_ioq_threads   = 0,
+			.sldc_ioq_ring_size = 0,
 		};
-		if (str_cfg_init != NULL) {
-			cfg->sldc_use_directio = strstr(str_cfg_init,
-						"directio=true") != NULL;
+		while (s != NULL && *s != 0 && rc == 0) {
+			s += strspn(s, " ,");
+			len = strcspn(s, " ,");
+			rc = len == 0 ? 0 : stob_linux_cfg_token(cfg, s, len);
+			s += len;
 		}
 	}
 	if (rc == 0)
@@ -246,7 +335,12 @@ static int stob_linux_domain_init(struct m0_stob_type *type,
 
 	rc = rc ?: stob_linux_domain_key_get_set(path, &dom_key, true);
 	rc = rc ?: m0_stob_domain__dom_key_is_valid(dom_key) ? 0 : -EINVAL;
-	rc = rc ?: m0_stob_ioq_init(&ldom->sld_ioq);
+	rc = rc ?: m0_stob_ioq_init(&ldom->sld_ioq,
+			(ldom->sld_cfg.sldc_use_uring ? M0_STOB_IOQ_URING : 0) |
+			(ldom->sld_cfg.sldc_uring_sqpoll ?
+			 M0_STOB_IOQ_SQPOLL : 0),
+			ldom->sld_cfg.sldc_ioq_threads,
+			ldom->sld_cfg.sldc_ioq_ring_size);
 	if (rc == 0) {
 		m0_stob_ioq_directio_setup(&ldom->sld_ioq,
 					   ldom->sld_cfg.sldc_use_directio);
@@ -370,6 +464,8 @@ static int stob_linux_stat(struct m0_stob_linux *lstob)
 	if (rc == -1)
 		return M0_ERR(-errno);
 	lstob->sl_mode = statbuf.st_mode;
+	lstob->sl_dev  = S_ISBLK(statbuf.st_mode) ? statbuf.st_rdev :
+						    statbuf.st_dev;
 	return M0_RC(0);
 }
 
@@ -387,6 +483,7 @@ static int stob_linux_open(struct m0_stob *stob,
 
 	stob->so_ops = &stob_linux_ops;
 	lstob->sl_dom = ldom;
+	lstob->sl_fd_slot = -1;
 
 	file_stob = stob_linux_file_stob(ldom->sld_path, stob_fid);
 	if (file_stob == NULL)
@@ -399,6 +496,11 @@ static int stob_linux_open(struct m0_stob *stob,
 	lstob->sl_fd = rc ?: open(file_stob, flags,
 				  ldom->sld_cfg.sldc_file_mode);
 	rc = lstob->sl_fd == -1 ? -errno : stob_linux_stat(lstob);
+	rc = rc ?: m0_stob_ioq_dev_get(&ldom->sld_ioq, lstob->sl_dev,
+				       &lstob->sl_ioq_dev);
+	if (rc == 0)
+		lstob->sl_fd_slot = m0_stob_ioq_file_register(lstob->sl_ioq_dev,
+							      lstob->sl_fd);
 
 	m0_free(file_stob);
 
@@ -416,6 +518,11 @@ static void stob_linux_close(struct m0_stob_linux *lstob)
 {
 	int rc;
 
+	if (lstob->sl_fd_slot != -1) {
+		m0_stob_ioq_file_unregister(lstob->sl_ioq_dev,
+					    lstob->sl_fd_slot);
+		lstob->sl_fd_slot = -1;
+	}
 	if (lstob->sl_fd != -1) {
 		rc = close(lstob->sl_fd);
 		M0_ASSERT(rc == 0);
@@ -634,6 +741,41 @@ M0_INTERNAL bool m0_stob_linux_domain_directio(struct m0_stob_domain *dom)
 	return ldom->sld_cfg.sldc_use_directio;
 }
 
+M0_INTERNAL void
+m0_stob_linux_init_cfg_make(char **str,
+			    const struct m0_stob_linux_domain_cfg *cfg)
+{
+	char buf[0x80];
+
+	snprintf(buf, ARRAY_SIZE(buf), "directio=%s ioq=%s sqpoll=%s "
+		 "ioq_threads=%"PRIu32" ioq_ring=%"PRIu32,
+		 cfg->sldc_use_directio ? "true" : "false",
+		 cfg->sldc_use_uring ? "uring" : "aio",
+		 cfg->sldc_uring_sqpoll ? "true" : "false",
+		 cfg->sldc_ioq_threads, cfg->sldc_ioq_ring_size);
+	*str = m0_strdup(buf);
+}
+
+M0_INTERNAL int
+m0_stob_linux_domain_buffers_register(struct m0_stob_domain *dom,
+				      const struct iovec    *bufs,
+				      unsigned               nr)
+{
+	M0_PRE(m0_stob_domain_is_of_type(dom, &m0_stob_linux_type));
+
+	return m0_stob_ioq_buffers_register(
+		&m0_stob_linux_domain_container(dom)->sld_ioq, bufs, nr);
+}
+
+M0_INTERNAL void
+m0_stob_linux_domain_buffers_unregister(struct m0_stob_domain *dom)
+{
+	M0_PRE(m0_stob_domain_is_of_type(dom, &m0_stob_linux_type));
+
+	m0_stob_ioq_buffers_unregister(
+		&m0_stob_linux_domain_container(dom)->sld_ioq);
+}
+
 static struct m0_stob_type_ops stob_linux_type_ops = {
 	.sto_register                = &stob_linux_type_register,
 	.sto_deregister              = &stob_linux_type_deregister,
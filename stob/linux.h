@@ -39,9 +39,20 @@
  */
 
 struct m0_stob_linux_domain_cfg {
-	mode_t sldc_file_mode;
-	int    sldc_file_flags;
-	bool   sldc_use_directio;
+	mode_t   sldc_file_mode;
+	int      sldc_file_flags;
+	bool     sldc_use_directio;
+	/** Use io_uring for I/O, "ioq=uring" in the configuration string. */
+	bool     sldc_use_uring;
+	/** Poll io_uring submission queue, "sqpoll=true". */
+	bool     sldc_uring_sqpoll;
+	/**
+	 * Worker threads per device queue, "ioq_threads=N", 0 for the
+	 * default. @see m0_stob_ioq_init()
+	 */
+	uint32_t sldc_ioq_threads;
+	/** Ring buffer slots per device queue, "ioq_ring=N", 0 for default. */
+	uint32_t sldc_ioq_ring_size;
 };
 
 struct m0_stob_linux_domain {
@@ -58,8 +69,14 @@ struct m0_stob_linux {
 	struct m0_stob_linux_domain *sl_dom;
 	/** fd from returned open(2) */
 	int			     sl_fd;
+	/** io_uring fixed file slot of ->sl_fd or -1. */
+	int			     sl_fd_slot;
 	/** file mode as returned by stat(2) */
 	mode_t			     sl_mode;
+	/** device the file is on: st_rdev for a block device, else st_dev */
+	dev_t			     sl_dev;
+	/** I/O queue of ->sl_dev */
+	struct m0_stob_ioq_dev	    *sl_ioq_dev;
 	/** fid of the corresponding m0_conf_sdev object */
 	struct m0_fid                sl_conf_sdev;
 };
@@ -97,6 +114,26 @@ M0_INTERNAL int m0_stob_linux_domain_fd_put(struct m0_stob_domain *dom, int fd);
 
 M0_INTERNAL bool m0_stob_linux_domain_directio(struct m0_stob_domain *dom);
 
+/**
+ * Makes the domain init configuration string for @cfg, to be freed with
+ * m0_free(). Sets *str to NULL if there is no memory.
+ */
+M0_INTERNAL void
+m0_stob_linux_init_cfg_make(char **str,
+			    const struct m0_stob_linux_domain_cfg *cfg);
+
+/**
+ * Registers long-living I/O buffers with the I/O queue of the domain.
+ *
+ * @see m0_stob_ioq_buffers_register()
+ */
+M0_INTERNAL int
+m0_stob_linux_domain_buffers_register(struct m0_stob_domain *dom,
+				      const struct iovec    *bufs,
+				      unsigned               nr);
+M0_INTERNAL void
+m0_stob_linux_domain_buffers_unregister(struct m0_stob_domain *dom);
+
 extern const struct m0_stob_type m0_stob_linux_type;
 
 /** @} end group stoblinux */
@@ -69,7 +69,7 @@ M0_INTERNAL int m0_stob_find_by_key(struct m0_stob_domain *dom,
 	struct m0_stob_cache *cache = m0_stob_domain__cache(dom);
 	struct m0_stob	     *stob;
 
-	m0_stob_cache_lock(cache);
+	m0_stob_cache_lock(cache, stob_fid);
 	stob = m0_stob_cache_lookup(cache, stob_fid);
 	if (stob != NULL) {
 		M0_CNT_INC(stob->so_ref);
@@ -83,7 +83,7 @@ M0_INTERNAL int m0_stob_find_by_key(struct m0_stob_domain *dom,
 			m0_stob_cache_add(cache, stob);
 		}
 	}
-	m0_stob_cache_unlock(cache);
+	m0_stob_cache_unlock(cache, stob_fid);
 
 	*out = stob;
 	return stob == NULL ? M0_ERR(-ENOMEM) : M0_RC(0);
@@ -106,11 +106,11 @@ M0_INTERNAL int m0_stob_lookup_by_key(struct m0_stob_domain *dom,
 	struct m0_stob_cache *cache = m0_stob_domain__cache(dom);
 	struct m0_stob	     *stob;
 
-	m0_stob_cache_lock(cache);
+	m0_stob_cache_lock(cache, stob_fid);
 	stob = m0_stob_cache_lookup(cache, stob_fid);
 	if (stob != NULL)
 		M0_CNT_INC(stob->so_ref);
-	m0_stob_cache_unlock(cache);
+	m0_stob_cache_unlock(cache, stob_fid);
 
 	*out = stob;
 	return stob == NULL ? -ENOENT : 0;
@@ -278,29 +278,31 @@ M0_INTERNAL void m0_stob_get(struct m0_stob *stob)
 
 	cache = m0_stob_domain__cache(m0_stob_dom_get(stob));
 
-	m0_stob_cache_lock(cache);
+	m0_stob_cache_lock(cache, m0_stob_fid_get(stob));
 	M0_ENTRY("stob=%p so_id="STOB_ID_F" so_ref=%"PRIu64,
 		 stob, STOB_ID_P(m0_stob_id_get(stob)), stob->so_ref);
 	M0_ASSERT(stob->so_ref > 0);
 	M0_CNT_INC(stob->so_ref);
 	M0_LEAVE("stob=%p so_id="STOB_ID_F" so_ref=%"PRIu64,
 		 stob, STOB_ID_P(m0_stob_id_get(stob)), stob->so_ref);
-	m0_stob_cache_unlock(cache);
+	m0_stob_cache_unlock(cache, m0_stob_fid_get(stob));
 }
 
 M0_INTERNAL void m0_stob_put(struct m0_stob *stob)
 {
 	struct m0_stob_cache *cache;
+	/* m0_stob_cache_idle() can evict and free the stob. */
+	struct m0_fid         fid = *m0_stob_fid_get(stob);
 
 	cache = m0_stob_domain__cache(m0_stob_dom_get(stob));
 
-	m0_stob_cache_lock(cache);
+	m0_stob_cache_lock(cache, &fid);
 	M0_ENTRY("stob=%p so_id="STOB_ID_F" so_ref=%"PRIu64,
 		 stob, STOB_ID_P(m0_stob_id_get(stob)), stob->so_ref);
 	M0_CNT_DEC(stob->so_ref);
 	if (stob->so_ref == 0)
 		m0_stob_cache_idle(cache, stob);
-	m0_stob_cache_unlock(cache);
+	m0_stob_cache_unlock(cache, &fid);
 
 	M0_LOG(M0_DEBUG, "stob %p, fid="FID_F" so_ref %" PRIu64 ", released ref, "
 	       "chan_waiters %"PRIu32, stob, FID_P(&stob->so_id.si_fid),
@@ -170,8 +170,14 @@ struct m0_stob {
 	struct m0_chan            so_ref_chan;
 	/* so_ref_chan protection. */
 	struct m0_mutex           so_ref_mutex;
+	/** Linkage to m0_stob_cache_shard::scs_idle. */
 	struct m0_tlink		  so_cache_linkage;
 	uint64_t		  so_cache_magic;
+	/** Linkage to m0_stob_cache_shard::scs_hash. */
+	struct m0_hlink		  so_cache_hlink;
+	uint64_t		  so_cache_hmagic;
+	/** CLOCK reference bit, see m0_stob_cache. */
+	bool			  so_cache_referenced;
 	void			 *so_private;
 };
 
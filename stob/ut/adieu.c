@@ -24,6 +24,7 @@
 #include <unistd.h>    /* unlink */
 #include <sys/stat.h>  /* mkdir */
 #include <sys/types.h> /* mkdir */
+#include <sys/uio.h>   /* iovec */
 
 #include "lib/misc.h"    /* M0_SET0 */
 #include "lib/memory.h"  /* m0_alloc_align */
@@ -34,9 +35,11 @@
 #include "ut/ut.h"
 #include "lib/assert.h"
 #include "lib/arith.h"
+#include "lib/trace.h"     /* m0_console_printf */
 #include "stob/domain.h"
 #include "stob/io.h"
 #include "stob/stob.h"
+#include "stob/linux.h"    /* m0_stob_linux_container */
 #include "fol/fol.h"
 #include "balloc/balloc.h" /* M0_BALLOC_NON_SPARE_ZONE */
 
@@ -82,6 +85,7 @@ static uint32_t block_shift;
 static uint32_t buf_size;
 
 static int test_adieu_init(const char *location,
+			   const char *dom_init_cfg,
 			   const char *dom_cfg,
 			   const char *stob_cfg)
 {
@@ -90,8 +94,8 @@ static int test_adieu_init(const char *location,
 	struct m0_stob_id stob_id;
 	char   cs_char = 'a';
 
-	rc = m0_stob_domain_create(location,
-				   NULL, M0_STOB_UT_DOMAIN_KEY, dom_cfg, &dom);
+	rc = m0_stob_domain_create(location, dom_init_cfg,
+				   M0_STOB_UT_DOMAIN_KEY, dom_cfg, &dom);
 	M0_ASSERT(rc == 0);
 	M0_ASSERT(dom != NULL);
 
@@ -296,17 +300,183 @@ void m0_stob_ut_adieu_linux(void)
 {
 	int rc;
 
-	rc = test_adieu_init(linux_location, NULL, NULL);
+	rc = test_adieu_init(linux_location, NULL, NULL, NULL);
 	M0_ASSERT(rc == 0);
 	test_adieu(linux_path);
 	test_adieu_fini();
 }
 
+/**
+   Adieu on an io_uring queue, first with the test buffers registered as
+   io_uring fixed buffers, then with ordinary buffers. Skipped when motr is
+   built without io_uring or the kernel cannot set up a ring.
+ */
+void m0_stob_ut_adieu_linux_uring(void)
+{
+#ifdef ENABLE_IO_URING
+	struct m0_stob_linux *lstob;
+	struct m0_stob_ioq   *ioq;
+	struct iovec          bufs[2 * NR];
+	int                   rc;
+	int                   i;
+
+	rc = test_adieu_init(linux_location, "ioq=uring", NULL, NULL);
+	M0_UT_ASSERT(rc == 0);
+	lstob = m0_stob_linux_container(obj);
+	if (!lstob->sl_ioq_dev->iqd_use_uring) {
+		m0_console_printf("io_uring is not available, skipped\n");
+		test_adieu_fini();
+		return;
+	}
+	M0_UT_ASSERT(lstob->sl_fd_slot != -1);
+	ioq = &lstob->sl_dom->sld_ioq;
+	for (i = 0; i < NR; ++i) {
+		bufs[2 * i]     = (struct iovec) { user_buf[i], buf_size };
+		bufs[2 * i + 1] = (struct iovec) { read_buf[i], buf_size };
+	}
+	rc = m0_stob_ioq_buffers_register(ioq, bufs, ARRAY_SIZE(bufs));
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(ioq->ioq_bufs_nr == ARRAY_SIZE(bufs));
+	test_adieu(linux_path);
+	m0_stob_ioq_buffers_unregister(ioq);
+	M0_UT_ASSERT(ioq->ioq_bufs == NULL);
+	test_adieu(linux_path);
+	test_adieu_fini();
+#else
+	m0_console_printf("Built without io_uring, skipped\n");
+#endif
+}
+
+enum { NR_MERGE = 32 };
+
+static void merge_io_init(struct m0_stob_io *sio, enum m0_stob_io_opcode op,
+			  m0_bcount_t *count, void **buf, m0_bindex_t *index)
+{
+	m0_stob_io_init(sio);
+	sio->si_opcode = op;
+	sio->si_user.ov_vec.v_nr = 1;
+	sio->si_user.ov_vec.v_count = count;
+	sio->si_user.ov_buf = buf;
+	sio->si_stob.iv_vec.v_nr = 1;
+	sio->si_stob.iv_vec.v_count = count;
+	sio->si_stob.iv_index = index;
+}
+
+/**
+   Launches writes of adjacent stob extents by separate requests, holding them
+   in the admission queue until all are launched, so that the queue merges
+   them, and reads the data back in one request.
+ */
+static void test_adieu_merge(void)
+{
+	struct m0_stob_ioq_dev  *dev = m0_stob_linux_container(obj)->sl_ioq_dev;
+	int64_t                  merged = m0_atomic64_get(&dev->iqd_merged);
+	static struct m0_stob_io sio[NR_MERGE];
+	static struct m0_clink   link[NR_MERGE];
+	static m0_bcount_t       count[NR_MERGE];
+	static m0_bindex_t       index[NR_MERGE];
+	static void             *buf[NR_MERGE];
+	m0_bcount_t              rcount;
+	m0_bindex_t              rindex = 0;
+	void                    *rbuf;
+	char                    *wdata;
+	char                    *rdata;
+	int                      rc;
+	int                      i;
+
+	wdata = m0_alloc_aligned(buf_size * NR_MERGE, block_shift);
+	rdata = m0_alloc_aligned(buf_size * NR_MERGE, block_shift);
+	M0_UT_ASSERT(wdata != NULL && rdata != NULL);
+	for (i = 0; i < NR_MERGE; ++i) {
+		memset(wdata + i * buf_size, 'A' + i, buf_size);
+		count[i] = buf_size >> block_shift;
+		index[i] = count[i] * i;
+		buf[i]   = m0_stob_addr_pack(wdata + i * buf_size, block_shift);
+		merge_io_init(&sio[i], SIO_WRITE, &count[i], &buf[i], &index[i]);
+		m0_clink_init(&link[i], NULL);
+		m0_clink_add_lock(&sio[i].si_wait, &link[i]);
+	}
+	m0_fi_enable("ioq_queue_submit", "hold");
+	for (i = 0; i < NR_MERGE; ++i) {
+		rc = m0_stob_io_prepare_and_launch(&sio[i], obj, NULL, NULL);
+		M0_UT_ASSERT(rc == 0);
+	}
+	M0_UT_ASSERT(dev->iqd_queued >= NR_MERGE);
+	/* Worker threads submit the queue once they time out waiting. */
+	m0_fi_disable("ioq_queue_submit", "hold");
+	for (i = 0; i < NR_MERGE; ++i) {
+		m0_chan_wait(&link[i]);
+		M0_UT_ASSERT(sio[i].si_rc == 0);
+		M0_UT_ASSERT(sio[i].si_count == count[i]);
+		m0_clink_del_lock(&link[i]);
+		m0_clink_fini(&link[i]);
+		m0_stob_io_fini(&sio[i]);
+	}
+	M0_UT_ASSERT(m0_atomic64_get(&dev->iqd_merged) > merged);
+
+	rcount = (buf_size * NR_MERGE) >> block_shift;
+	rbuf   = m0_stob_addr_pack(rdata, block_shift);
+	merge_io_init(&sio[0], SIO_READ, &rcount, &rbuf, &rindex);
+	m0_clink_init(&link[0], NULL);
+	m0_clink_add_lock(&sio[0].si_wait, &link[0]);
+	rc = m0_stob_io_prepare_and_launch(&sio[0], obj, NULL, NULL);
+	M0_UT_ASSERT(rc == 0);
+	m0_chan_wait(&link[0]);
+	M0_UT_ASSERT(sio[0].si_rc == 0);
+	M0_UT_ASSERT(sio[0].si_count == rcount);
+	m0_clink_del_lock(&link[0]);
+	m0_clink_fini(&link[0]);
+	m0_stob_io_fini(&sio[0]);
+	M0_UT_ASSERT(memcmp(wdata, rdata, buf_size * NR_MERGE) == 0);
+
+	m0_free_aligned(wdata, buf_size * NR_MERGE, block_shift);
+	m0_free_aligned(rdata, buf_size * NR_MERGE, block_shift);
+}
+
+/**
+   Checks that the domain queue is sized from the configuration string, that
+   the stob is served by the queue of its own device and that another device
+   gets a separate queue, then runs test_adieu_merge().
+ */
+void m0_stob_ut_adieu_linux_merge(void)
+{
+	struct m0_stob_linux   *lstob;
+	struct m0_stob_ioq     *ioq;
+	struct m0_stob_ioq_dev *other;
+	int                     rc;
+
+	rc = test_adieu_init(linux_location, "ioq_threads=2 ioq_ring=64",
+			     NULL, NULL);
+	M0_ASSERT(rc == 0);
+	lstob = m0_stob_linux_container(obj);
+	ioq = &lstob->sl_dom->sld_ioq;
+	M0_UT_ASSERT(ioq->ioq_nr_threads == 2);
+	M0_UT_ASSERT(ioq->ioq_ring_size == 64);
+	M0_UT_ASSERT(ioq->ioq_dev_nr == 1);
+	M0_UT_ASSERT(ioq->ioq_dev[0] == lstob->sl_ioq_dev);
+	M0_UT_ASSERT(lstob->sl_ioq_dev->iqd_dev == lstob->sl_dev);
+	M0_UT_ASSERT(m0_atomic64_get(&lstob->sl_ioq_dev->iqd_avail) == 64);
+
+	rc = m0_stob_ioq_dev_get(ioq, lstob->sl_dev + 1, &other);
+	M0_UT_ASSERT(rc == 0);
+	M0_UT_ASSERT(other != lstob->sl_ioq_dev);
+	M0_UT_ASSERT(other->iqd_dev == lstob->sl_dev + 1);
+	M0_UT_ASSERT(ioq->ioq_dev_nr == 2);
+	M0_UT_ASSERT(other->iqd_thread != lstob->sl_ioq_dev->iqd_thread);
+
+	test_adieu_merge();
+	/* The other device queue saw no I/O. */
+	M0_UT_ASSERT(other->iqd_queued == 0);
+	M0_UT_ASSERT(m0_atomic64_get(&other->iqd_merged) == 0);
+	M0_UT_ASSERT(m0_atomic64_get(&other->iqd_avail) == 64);
+	test_adieu_fini();
+}
+
 void m0_stob_ut_adieu_perf(void)
 {
 	int rc;
 
-	rc = test_adieu_init(perf_location, NULL, NULL);
+	rc = test_adieu_init(perf_location, NULL, NULL, NULL);
 	M0_ASSERT(rc == 0);
 	test_adieu(perf_path);
 	test_adieu_fini();
@@ -383,7 +553,7 @@ static void ub_iovec_sort_invert()
 
 static int ub_init(const char *opts M0_UNUSED)
 {
-	return test_adieu_init(linux_location, NULL, NULL);
+	return test_adieu_init(linux_location, NULL, NULL, NULL);
 }
 
 static void ub_fini(void)
@@ -64,7 +64,7 @@ static void stob_ut_cache_thread(struct stob_ut_cache_ctx *ctx)
 		stob = &stob_ut_cache_stobs[j];
 		/* add to cache if it hasn't been added yet */
 		/* delete if it has already been added */
-		m0_stob_cache_lock(cache);
+		m0_stob_cache_lock(cache, m0_stob_fid_get(stob));
 		found = m0_stob_cache_lookup(cache, m0_stob_fid_get(stob));
 		if (found == NULL) {
 			m0_stob_cache_add(cache, stob);
@@ -80,7 +80,7 @@ static void stob_ut_cache_thread(struct stob_ut_cache_ctx *ctx)
 		 */
 		if (found != NULL && found2 != NULL)
 			m0_stob_cache_idle(cache, stob);
-		m0_stob_cache_unlock(cache);
+		m0_stob_cache_unlock(cache, m0_stob_fid_get(stob));
 		M0_UT_ASSERT(ergo(found == NULL, found2 != NULL));
 		M0_UT_ASSERT(M0_IN(stob, (found, found2)));
 	}
@@ -129,14 +129,15 @@ static void stob_ut_cache_test(size_t thread_nr,
 	M0_UT_THREADS_STOP(stob_cache);
 
 	/* clear stob cache */
-	m0_stob_cache_lock(&stob_ut_cache);
 	for (i = 0; i < ARRAY_SIZE(stob_ut_cache_stobs); ++i) {
 		stob_fid = m0_stob_fid_get(&stob_ut_cache_stobs[i]);
+		m0_stob_cache_lock(&stob_ut_cache, stob_fid);
 		stob = m0_stob_cache_lookup(&stob_ut_cache, stob_fid);
 		if (stob != NULL)
 			m0_stob_cache_idle(&stob_ut_cache, stob);
+		m0_stob_cache_unlock(&stob_ut_cache, stob_fid);
 	}
-	m0_stob_cache_unlock(&stob_ut_cache);
+	M0_UT_ASSERT(m0_stob_cache_is_not_locked(&stob_ut_cache));
 
 	m0_stob_cache_fini(&stob_ut_cache);
 	m0_free(ctxs);
@@ -153,6 +154,98 @@ void m0_stob_ut_cache_idle_size0(void)
 	stob_ut_cache_test(STOB_UT_CACHE_THREAD_NR, STOB_UT_CACHE_ITER_NR, 0);
 }
 
+static struct m0_stob *stob_ut_cache_evicted;
+static int             stob_ut_cache_evicted_nr;
+
+static void stob_ut_cache_clock_evict_cb(struct m0_stob_cache *cache,
+					 struct m0_stob *stob)
+{
+	stob_ut_cache_evicted = stob;
+	++stob_ut_cache_evicted_nr;
+}
+
+/* Makes stob busy in the cache, then idle. */
+static void stob_ut_cache_touch(struct m0_stob_cache *cache,
+				struct m0_stob *stob)
+{
+	const struct m0_fid *fid = m0_stob_fid_get(stob);
+
+	m0_stob_cache_lock(cache, fid);
+	if (m0_stob_cache_lookup(cache, fid) == NULL)
+		m0_stob_cache_add(cache, stob);
+	m0_stob_cache_idle(cache, stob);
+	M0_UT_ASSERT(m0_stob_cache__invariant(cache, fid));
+	m0_stob_cache_unlock(cache, fid);
+}
+
+/*
+ * Fills a shard past its idle limit and checks that CLOCK evicts the least
+ * recently idle stobs, except for the stob that has just become idle and the
+ * stob that was found in the cache, which get a second chance.
+ */
+void m0_stob_ut_cache_clock(void)
+{
+	struct m0_stob_cache        *cache = &stob_ut_cache;
+	struct m0_stob_cache_shard  *shard = &cache->sc_shards[0];
+	struct m0_stob              *stobs = stob_ut_cache_stobs;
+	uint64_t                     key;
+	int                          size;
+	int                          rc;
+	int                          i;
+
+	M0_SET0(cache);
+	M0_SET_ARR0(stob_ut_cache_stobs);
+	stob_ut_cache_evicted    = NULL;
+	stob_ut_cache_evicted_nr = 0;
+	rc = m0_stob_cache_init(cache, 1, &stob_ut_cache_clock_evict_cb);
+	M0_UT_ASSERT(rc == 0);
+	/* Every shard gets at least the minimal idle size. */
+	M0_UT_ASSERT(m0_forall(j, M0_STOB_CACHE_SHARD_NR,
+			       cache->sc_shards[j].scs_idle_size ==
+			       M0_STOB_CACHE_SHARD_IDLE_MIN));
+	size = shard->scs_idle_size;
+	M0_UT_ASSERT(2 * size <= ARRAY_SIZE(stob_ut_cache_stobs));
+	/* All stobs go to the first shard. */
+	for (i = 0, key = 0; i < 2 * size; ++i) {
+		do {
+			stobs[i].so_id.si_fid.f_key = ++key;
+		} while (m0_fid_hash(m0_stob_fid_get(&stobs[i])) %
+			 M0_STOB_CACHE_SHARD_NR != 0);
+	}
+	/* Fill the idle list: nothing is evicted. */
+	for (i = 0; i < size; ++i)
+		stob_ut_cache_touch(cache, &stobs[i]);
+	M0_UT_ASSERT(stob_ut_cache_evicted_nr == 0);
+	M0_UT_ASSERT(shard->scs_idle_used == size);
+	M0_UT_ASSERT(shard->scs_misses == size);
+	/*
+	 * All idle stobs are referenced when added: the first eviction takes
+	 * their bits and evicts the least recently idle stob, not the new one.
+	 */
+	stob_ut_cache_touch(cache, &stobs[size]);
+	M0_UT_ASSERT(stob_ut_cache_evicted == &stobs[0]);
+	M0_UT_ASSERT(stob_ut_cache_evicted_nr == 1);
+	/* stobs[1] is at the tail now, it is found in the cache. */
+	stob_ut_cache_touch(cache, &stobs[1]);
+	M0_UT_ASSERT(shard->scs_idle_hits == 1);
+	M0_UT_ASSERT(stob_ut_cache_evicted_nr == 1);
+	/* stobs[1] gets the second chance and the next stob is evicted. */
+	stob_ut_cache_touch(cache, &stobs[size + 1]);
+	M0_UT_ASSERT(stob_ut_cache_evicted == &stobs[2]);
+	M0_UT_ASSERT(stob_ut_cache_evicted_nr == 2);
+	M0_UT_ASSERT(shard->scs_evictions == 2);
+	M0_UT_ASSERT(shard->scs_idle_used == size);
+	stob_ut_cache_touch(cache, &stobs[1]);
+	M0_UT_ASSERT(shard->scs_idle_hits == 2);
+	M0_UT_ASSERT(stob_ut_cache_evicted_nr == 2);
+	/* Other shards are not touched. */
+	M0_UT_ASSERT(m0_forall(j, M0_STOB_CACHE_SHARD_NR, j == 0 ||
+			       (cache->sc_shards[j].scs_misses == 0 &&
+				cache->sc_shards[j].scs_evictions == 0)));
+	m0_stob_cache_fini(cache);
+	M0_UT_ASSERT(stob_ut_cache_evicted_nr == size + 2);
+}
+
 /*
  *  Local variables:
  *  c-indentation-style: "K&R"
@@ -28,11 +28,14 @@
 
 extern void m0_stob_ut_cache(void);
 extern void m0_stob_ut_cache_idle_size0(void);
+extern void m0_stob_ut_cache_clock(void);
 extern void m0_stob_ut_stob_domain_null(void);
 extern void m0_stob_ut_stob_null(void);
 extern void m0_stob_ut_stob_domain_linux(void);
 extern void m0_stob_ut_stob_linux(void);
 extern void m0_stob_ut_adieu_linux(void);
+extern void m0_stob_ut_adieu_linux_merge(void);
+extern void m0_stob_ut_adieu_linux_uring(void);
 extern void m0_stob_ut_stobio_linux(void);
 extern void m0_stob_ut_stob_domain_perf(void);
 extern void m0_stob_ut_stob_domain_perf_null(void);
@@ -51,12 +54,15 @@ struct m0_ut_suite stob_ut = {
 	.ts_tests = {
 		{ "cache",		m0_stob_ut_cache		},
 		{ "cache-idle-size0",	m0_stob_ut_cache_idle_size0	},
+		{ "cache-clock",	m0_stob_ut_cache_clock		},
 #ifndef __KERNEL__
 		{ "null-stob-domain",	m0_stob_ut_stob_domain_null	},
 		{ "null-stob",		m0_stob_ut_stob_null		},
 		{ "linux-stob-domain",	m0_stob_ut_stob_domain_linux	},
 		{ "linux-stob",		m0_stob_ut_stob_linux		},
 		{ "linux-adieu",	m0_stob_ut_adieu_linux		},
+		{ "linux-adieu-merge",	m0_stob_ut_adieu_linux_merge	},
+		{ "linux-adieu-uring",	m0_stob_ut_adieu_linux_uring	},
 		{ "linux-stobio",	m0_stob_ut_stobio_linux		},
 		{ "perf-stob-domain",	m0_stob_ut_stob_domain_perf	},
 		{ "perf-stob-domain-null", m0_stob_ut_stob_domain_perf_null },
@@ -32,6 +32,8 @@
 extern struct m0_ub_set m0_ad_ub;
 extern struct m0_ub_set m0_adieu_ub;
 extern struct m0_ub_set m0_atomic_ub;
+extern struct m0_ub_set m0_be_btree_ub;
+extern struct m0_ub_set m0_be_reg_area_ub;
 extern struct m0_ub_set m0_bitmap_ub;
 extern struct m0_ub_set m0_fol_ub;
 extern struct m0_ub_set m0_fom_ub;
@@ -39,6 +41,7 @@ extern struct m0_ub_set m0_list_ub;
 extern struct m0_ub_set m0_memory_ub;
 extern struct m0_ub_set m0_parity_math_ub;
 extern struct m0_ub_set m0_parity_math_mt_ub;
+extern struct m0_ub_set m0_parity_ops_ub;
 //extern struct m0_ub_set m0_rpc_ub;
 extern struct m0_ub_set m0_thread_ub;
 extern struct m0_ub_set m0_time_ub;
@@ -106,6 +109,7 @@ static void ub_add(const struct ub_args *args)
 	m0_ub_set_add(&m0_time_ub);
 	m0_ub_set_add(&m0_thread_ub);
 //	m0_ub_set_add(&m0_rpc_ub);
+	m0_ub_set_add(&m0_parity_ops_ub);
 	m0_ub_set_add(&m0_parity_math_mt_ub);
 	m0_ub_set_add(&m0_parity_math_ub);
 	m0_ub_set_add(&m0_memory_ub);
@@ -113,6 +117,8 @@ static void ub_add(const struct ub_args *args)
 	m0_ub_set_add(&m0_fom_ub);
 	m0_ub_set_add(&m0_fol_ub);
 //XXX_BE_DB 	m0_ub_set_add(&m0_bitmap_ub);
+	m0_ub_set_add(&m0_be_reg_area_ub);
+	m0_ub_set_add(&m0_be_btree_ub);
 //XXX_BE_DB 	m0_ub_set_add(&m0_atomic_ub);
 	m0_ub_set_add(&m0_adieu_ub);
 	m0_ub_set_add(&m0_ad_ub);
@@ -135,6 +135,7 @@ extern struct m0_ut_suite m0_net_lnet_ut;
 extern struct m0_ut_suite m0_net_libfab_ut;
 extern struct m0_ut_suite m0_net_misc_ut;
 extern struct m0_ut_suite m0_net_module_ut;
+extern struct m0_ut_suite m0_net_sock_ut;
 extern struct m0_ut_suite m0_net_test_ut;
 extern struct m0_ut_suite m0_net_tm_prov_ut;
 extern struct m0_ut_suite m0d_ut;
@@ -288,6 +289,7 @@ static void tests_add(struct m0_ut_module *m)
 	m0_ut_add(m, &m0_net_libfab_ut, LIBFAB_ENABLED);
 	m0_ut_add(m, &m0_net_misc_ut, true);
 	m0_ut_add(m, &m0_net_module_ut, true);
+	m0_ut_add(m, &m0_net_sock_ut, true);
 	m0_ut_add(m, &m0_net_test_ut, true);
 	m0_ut_add(m, &m0_net_tm_prov_ut, true);
 	m0_ut_add(m, &m0d_ut, true);